@@ -0,0 +1,147 @@
+#pragma once
+
+// ============================================================================
+// acc_predictive.h - Predictive ACC core (closing-speed estimator + MPC gains)
+// ============================================================================
+// Pure computation, no Arduino/FreeRTOS dependencies: the same code runs in
+// the 100 Hz ControlTask and in host-side simulations of following scenarios.
+//
+// - Estimator: alpha-beta-gamma tracker over the TOFSense distance history
+//   (~15 Hz). Produces gap, relative velocity and relative acceleration and
+//   extrapolates them between sensor frames.
+// - Controller: gain-scheduled state feedback. Gains are the first-step
+//   solution of a finite-horizon LQ/MPC problem (gap error, relative velocity
+//   and first-order motor lag, horizon 150 x 10 ms) precomputed offline for
+//   three operating bands. Output is a speed factor with bounded rate and
+//   bounded jerk.
+// ============================================================================
+
+#include <cstdint>
+
+namespace AccPredictive {
+
+// Estimator tuning (sensor runs at ~15 Hz, dt ~66 ms)
+constexpr float EST_ALPHA = 0.4f;
+constexpr float EST_BETA = 0.1f;
+constexpr float EST_GAMMA = 0.005f;
+constexpr float EST_MAX_VEL_MM_S = 5000.0f;    // Physical clamp
+constexpr float EST_MAX_ACCEL_MM_S2 = 5000.0f; // Physical clamp
+constexpr float EST_REINIT_RESIDUAL_MM = 800.0f; // Target switch detection
+constexpr uint32_t EST_MAX_SAMPLE_GAP_MS = 500;  // Older history is discarded
+constexpr uint32_t EST_MAX_EXTRAPOLATION_MS = 150;
+
+// Controller timing and per-cycle compute budget inside ControlTask
+constexpr float CONTROL_DT_S = 0.01f;          // 100 Hz
+constexpr float MOTOR_LAG_S = 0.3f;            // Ego speed response (model)
+constexpr uint32_t COMPUTE_BUDGET_US = 40;     // Estimator + controller
+
+// Predictive brake: hold the car when the gap projected over the stopping
+// horizon (motor lag + one sensor period) falls below the emergency distance
+constexpr float BRAKE_HORIZON_S = 0.4f;
+constexpr float BRAKE_RELEASE_MARGIN_MM = 100.0f;
+constexpr float BRAKE_RELEASE_MAX_CLOSING_MM_S = 50.0f;
+
+struct EstimatorState {
+  float distanceMm;     // Filtered gap
+  float relVelMmS;      // d(gap)/dt, negative = closing
+  float relAccelMmS2;   // d2(gap)/dt2
+  uint32_t lastSampleMs; // Timestamp of last fused sensor frame
+  uint8_t samples;      // Frames fused since reset (saturates at 255)
+  bool initialized;
+
+  EstimatorState()
+      : distanceMm(0.0f), relVelMmS(0.0f), relAccelMmS2(0.0f),
+        lastSampleMs(0), samples(0), initialized(false) {}
+};
+
+// Precomputed MPC gain set for one operating band
+struct GainSet {
+  float kGap;       // (m/s^2) per m of gap error
+  float kVel;       // (m/s^2) per m/s of relative velocity
+  float kLag;       // (m/s^2) per m/s of commanded-but-not-yet-reached speed
+  float lookaheadS; // Relative velocity is predicted this far ahead
+};
+
+enum GainBand : uint8_t { BAND_CRUISE = 0, BAND_CLOSING = 1, BAND_CLOSE = 2 };
+
+struct Limits {
+  float minFactor;         // Lowest factor in normal regulation
+  float maxFactor;         // Usually 1.0 or the pedal limit
+  float maxRiseRate;       // factor/s when releasing (speeding up)
+  float maxFallRate;       // factor/s when slowing down
+  float maxJerk;           // factor/s^2 (rate of change of the rate)
+  float referenceSpeedMmS; // Ego speed at factor 1.0
+
+  Limits()
+      : minFactor(0.5f), maxFactor(1.0f), maxRiseRate(0.5f),
+        maxFallRate(2.0f), maxJerk(8.0f), referenceSpeedMmS(2000.0f) {}
+};
+
+struct ControllerState {
+  float factor;     // Current speed factor output
+  float factorRate; // Current factor slope (factor/s), jerk-limited
+  float lagMmS;     // Modelled command - ego speed (internal MPC state)
+  GainBand band;    // Band used on the last step
+  bool brakeHold;   // Predictive brake engaged (output forced to 0)
+
+  ControllerState()
+      : factor(1.0f), factorRate(0.0f), lagMmS(0.0f), band(BAND_CRUISE),
+        brakeHold(false) {}
+};
+
+/**
+ * Reset estimator (target lost or re-acquired)
+ */
+void resetEstimator(EstimatorState &est);
+
+/**
+ * Fuse a new sensor frame. Frames with the same timestamp as the last fused
+ * one are ignored, so it is safe to call every control cycle.
+ * @return true if the frame was fused
+ */
+bool fuseSample(EstimatorState &est, float measuredMm, uint32_t sampleMs);
+
+/**
+ * Extrapolate gap and relative velocity to nowMs (bounded horizon)
+ */
+void predict(const EstimatorState &est, uint32_t nowMs, float &distanceMm,
+             float &relVelMmS);
+
+/**
+ * Select the gain band for the current gap error and relative velocity
+ */
+GainBand selectBand(float gapErrorMm, float relVelMmS);
+
+/**
+ * Access the precomputed gain table
+ */
+const GainSet &gains(GainBand band);
+
+/**
+ * Reset controller output to a given factor with zero slope
+ */
+void resetController(ControllerState &ctl, float factor);
+
+/**
+ * Force the brake hold (raw emergency distance reached). Regulation resumes
+ * from resumeFactor once the projected gap clears the release margin.
+ */
+void engageBrake(ControllerState &ctl, float resumeFactor);
+
+/**
+ * One controller step
+ * @param ctl Controller state (updated in place)
+ * @param distanceMm Predicted gap at this cycle
+ * @param relVelMmS Predicted relative velocity
+ * @param relAccelMmS2 Estimated relative acceleration
+ * @param targetMm Desired gap
+ * @param emergencyMm Distance the projected gap must never cross
+ * @param lim Output limits
+ * @param dtS Step duration in seconds
+ * @return New speed factor (0 while ctl.brakeHold is set)
+ */
+float step(ControllerState &ctl, float distanceMm, float relVelMmS,
+           float relAccelMmS2, float targetMm, float emergencyMm,
+           const Limits &lim, float dtS);
+
+} // namespace AccPredictive
@@ -0,0 +1,70 @@
+#pragma once
+
+// ============================================================================
+// acc_scenario_tests.h - Adaptive cruise following-scenario simulation
+// ============================================================================
+// Closed-loop simulation of person/vehicle following at the ControlTask rate
+// (100 Hz) with the TOFSense sampled at ~15 Hz (+ noise and quantization).
+// Compares the legacy 10 Hz PID law against the predictive controller in
+// acc_predictive.h:
+// - Speed factor direction reversals (oscillation)
+// - Gap RMS error after settling and minimum gap
+// - Peak speed factor jerk
+// - Per-cycle compute time of the predictive path vs COMPUTE_BUDGET_US
+// On-car run through TestRunner; the host version of the same scenarios is
+// test/test_acc_predictive.
+// ============================================================================
+
+#include <Arduino.h>
+
+namespace AccScenarioTests {
+
+/**
+ * @brief Initialize ACC scenario testing
+ */
+void init();
+
+/**
+ * @brief Run all following scenarios
+ * @return true if all tests passed
+ */
+bool runAllTests();
+
+/**
+ * @brief Lead moving at constant speed: predictive law must settle with
+ * fewer reversals than the PID law
+ */
+bool testSteadyFollowing();
+
+/**
+ * @brief Lead braking to a stop: predictive law must keep a larger minimum
+ * gap than the PID law
+ */
+bool testLeadBraking();
+
+/**
+ * @brief Lead with oscillating speed (stop-and-go walking)
+ */
+bool testStopAndGo();
+
+/**
+ * @brief Predictive estimator + controller must fit the per-cycle budget
+ */
+bool testComputeBudget();
+
+/**
+ * @brief Print test summary
+ */
+void printSummary();
+
+/**
+ * @brief Get the number of passed tests
+ */
+uint32_t getPassedCount();
+
+/**
+ * @brief Get the number of failed tests
+ */
+uint32_t getFailedCount();
+
+} // namespace AccScenarioTests
@@ -19,6 +19,12 @@ enum ACCState : uint8_t {
   ACC_ERROR = 255
 };
 
+// ACC control law
+enum ACCMode : uint8_t {
+  ACC_MODE_PID = 0,       // Legacy PID on raw distance (10Hz)
+  ACC_MODE_PREDICTIVE = 1 // Closing-speed estimator + MPC gains (100Hz)
+};
+
 // ACC Configuration
 struct ACCConfig {
   bool enabled;
@@ -28,10 +34,14 @@ struct ACCConfig {
   float pidKp;               // PID proportional gain
   float pidKi;               // PID integral gain
   float pidKd;               // PID derivative gain
+  ACCMode mode;              // Control law (default predictive)
+  uint16_t referenceSpeedMmS; // Ego speed at factor 1.0 (predictive model)
+  float maxJerk;              // Speed factor jerk bound (1/s^2)
 
   ACCConfig()
       : enabled(false), targetDistanceMm(1500), minDistanceMm(500),
-        maxSpeedReduction(50), pidKp(0.5f), pidKi(0.1f), pidKd(0.05f) {}
+        maxSpeedReduction(50), pidKp(0.5f), pidKi(0.1f), pidKd(0.05f),
+        mode(ACC_MODE_PREDICTIVE), referenceSpeedMmS(2000), maxJerk(8.0f) {}
 };
 
 // ACC Status
@@ -41,10 +51,17 @@ struct ACCStatus {
   float speedAdjustment; // Speed adjustment factor (0.0-1.0)
   bool vehicleDetected;
   uint32_t lastUpdateMs;
+  float relVelocityMmS;  // Estimated d(gap)/dt (negative = closing)
+  float relAccelMmS2;    // Estimated d2(gap)/dt2
+  uint16_t lastComputeUs; // Predictive path cost of the last cycle
+  uint16_t maxComputeUs;  // Worst cycle since init/reset
+  uint32_t budgetOverruns; // Cycles above AccPredictive::COMPUTE_BUDGET_US
 
   ACCStatus()
       : state(ACC_DISABLED), currentDistance(0xFFFF), speedAdjustment(1.0f),
-        vehicleDetected(false), lastUpdateMs(0) {}
+        vehicleDetected(false), lastUpdateMs(0), relVelocityMmS(0.0f),
+        relAccelMmS2(0.0f), lastComputeUs(0), maxComputeUs(0),
+        budgetOverruns(0) {}
 };
 
 /**
@@ -53,7 +70,8 @@ struct ACCStatus {
 void init();
 
 /**
- * Update ACC (call in main loop at ~10Hz)
+ * Update ACC (call from ControlTask at 100Hz; the PID mode self-throttles to
+ * 10Hz, the predictive mode runs every call)
  */
 void update();
 
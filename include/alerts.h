@@ -143,8 +143,14 @@ class Alerts {
 public:
   static void init();
   static void play(const Audio::Item &item);
+  // Con la prioridad de defaultPriority(t)
   static void play(Audio::Track t);
 
+  // Alertas de seguridad (obstáculo, emergencia, temperatura, batería
+  // crítica, sobrecorriente) son CRITICAL y cortan lo que esté sonando;
+  // errores de sensores HIGH; el resto NORMAL
+  static Audio::Priority defaultPriority(Audio::Track t);
+
   // 🔎 Declaración añadida para que coincida con alerts.cpp
   static bool initOK();
 };
\ No newline at end of file
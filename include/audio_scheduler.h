@@ -0,0 +1,107 @@
+// audio_scheduler.h - Priority audio scheduler for the DFPlayer
+// AudioQueue was an 8-slot FIFO: it stored a priority but ignored it,
+// dispatched one item per update() whether or not the player was still
+// playing, and when full it dropped the newest track even if it was
+// critical. The Scheduler keeps the same 8 slots but:
+// - plays the highest priority first (oldest first within a priority),
+// - lets a CRITICAL track preempt anything below CRITICAL that is playing,
+// - coalesces a track that is already pending or playing into that entry,
+// - rate-limits repeats of the same track (CRITICAL is never limited),
+// - when full, evicts the oldest lowest-priority entry for a higher one,
+// - waits for the player's "finished" feedback (or a timeout when the
+//   module never reports) before starting the next track,
+// - records per-priority latency from push() to play.
+// Pure C++ (native tests); the DFPlayer glue is in queue.cpp/dfplayer.cpp.
+#pragma once
+
+#include "queue.h"
+#include <cstdint>
+
+namespace Audio {
+
+constexpr uint8_t SCHED_CAPACITY = 8;
+constexpr uint16_t MAX_TRACK = 68;
+constexpr uint8_t PRIORITY_COUNT = 4;
+
+constexpr uint32_t REPEAT_MIN_MS = 3000;   // Same track again (below CRITICAL)
+constexpr uint32_t MAX_PLAY_MS = 8000;     // No finish feedback: assume done
+constexpr uint32_t COMMAND_GAP_MS = 120;   // DFPlayer drops closer commands
+
+enum class PushResult : uint8_t {
+  QUEUED,       // New entry
+  COALESCED,    // Same track already pending or playing
+  REPLACED,     // Queue full: a lower-priority entry was evicted
+  RATE_LIMITED, // Same track started less than REPEAT_MIN_MS ago
+  DROPPED,      // Queue full of equal or higher priority
+  INVALID,      // Track outside 1..MAX_TRACK
+};
+
+struct Pending {
+  uint16_t track;
+  Priority prio;
+  uint32_t pushedMs;
+};
+
+// A play command for the player
+struct Dispatch {
+  uint16_t track;
+  Priority prio;
+  bool preempt;       // Cuts the track that was playing
+  uint32_t latencyMs; // push() to now
+};
+
+struct PriorityStats {
+  uint32_t pushed;
+  uint32_t played;
+  uint32_t coalesced;
+  uint32_t rateLimited;
+  uint32_t dropped;   // Rejected (queue full)
+  uint32_t evicted;   // Removed to make room for a higher priority
+  uint32_t preempted; // Cut while playing
+  uint32_t latencySumMs;
+  uint32_t latencyMaxMs;
+};
+
+class Scheduler {
+public:
+  void reset();
+
+  PushResult push(uint16_t track, Priority prio, uint32_t nowMs);
+
+  // Next play command, if one is due at nowMs (marks it playing)
+  bool poll(uint32_t nowMs, Dispatch &out);
+
+  // Player feedback: `track` finished (0 = whatever is playing)
+  void onFinished(uint16_t track);
+  // Player reported an error: nothing is playing any more
+  void onPlayerError();
+
+  // Removes the next entry without playing it
+  bool pop(Pending &out);
+
+  bool isPlaying() const { return playing_.track != 0; }
+  uint16_t playingTrack() const { return playing_.track; }
+  uint8_t pendingCount() const { return count_; }
+  const Pending &pending(uint8_t i) const { return pending_[i]; }
+  const PriorityStats &stats(Priority p) const { return stats_[p]; }
+  uint32_t timeouts() const { return timeouts_; }
+
+private:
+  int8_t findPending(uint16_t track) const;
+  int8_t best() const;  // Highest priority, oldest
+  int8_t victim() const; // Lowest priority, oldest
+  void remove(uint8_t i);
+
+  Pending pending_[SCHED_CAPACITY] = {};
+  uint8_t count_ = 0;
+  Pending playing_ = {};
+  uint32_t playStartMs_ = 0;
+  uint32_t lastCommandMs_ = 0;
+  bool commandSent_ = false;
+  uint32_t lastStartMs_[MAX_TRACK + 1] = {};
+  bool started_[MAX_TRACK + 1] = {};
+  PriorityStats stats_[PRIORITY_COUNT] = {};
+  uint32_t timeouts_ = 0;
+};
+
+} // namespace Audio
@@ -0,0 +1,159 @@
+// black_box.h - Control-loop black box recorder with pre-trigger window
+// The control job appends one compact Sample per tick (100 Hz) to a RAM
+// ring (PSRAM on the device) holding the last ~20 s. A trigger (LimpMode
+// entering LIMP, ABS activation, emergency stop) marks the current tick;
+// POST_SAMPLES later the window [trigger - PRE_SAMPLES, trigger +
+// POST_SAMPLES) is frozen, copied out of the ring and written to a slot of
+// the "blackbox" flash partition by service() from the journal job, one
+// sector per call. record() is a fixed-cost copy into the ring: no flash,
+// no lock, no allocation.
+// Flash layout: the partition is split into slots of SLOT_SECTORS sectors;
+// each slot holds [DumpHeader][Sample x sampleCount]. Samples are written
+// first and the CRC'd header last, so a dump cut by a power loss is simply
+// not there at the next boot. New dumps go to the slot after the highest
+// sequence number, which service() erases ahead while idle: the newest
+// slots - 1 dumps are kept. tools/black_box_decode.py turns a partition
+// image into CSV.
+// Pure C++ over FlashJournal::FlashDevice so the native tests can run it
+// on simulated flash.
+#pragma once
+
+#include "flash_journal.h"
+#include <cstdint>
+
+namespace BlackBox {
+
+constexpr uint16_t RATE_HZ = 100;
+constexpr uint16_t RING_SAMPLES = 2048; // ~20 s at 100 Hz (2^n)
+constexpr uint16_t PRE_SAMPLES = 1000;  // 10 s before the trigger
+constexpr uint16_t POST_SAMPLES = 500;  // 5 s after the trigger
+constexpr uint16_t WINDOW_SAMPLES = PRE_SAMPLES + POST_SAMPLES;
+constexpr uint8_t SLOT_SECTORS = 15;    // Header + WINDOW_SAMPLES samples
+constexpr uint32_t DUMP_MAGIC = 0x31584242; // "BBX1"
+constexpr uint16_t FORMAT_VERSION = 1;
+
+// Trigger reasons (stable on flash: never renumber, only append)
+enum Trigger : uint8_t {
+  TRIGGER_NONE = 0,
+  TRIGGER_LIMP = 1,           // LimpMode entered LIMP or CRITICAL
+  TRIGGER_ABS = 2,            // ABS became active
+  TRIGGER_EMERGENCY_STOP = 3, // ObstacleSafety emergency brake
+  TRIGGER_MANUAL = 4,
+};
+
+// Sample::flags
+enum Flag : uint8_t {
+  FLAG_PEDAL_VALID = 1 << 0,
+  FLAG_STEERING_VALID = 1 << 1,
+  FLAG_ABS_ACTIVE = 1 << 2,
+  FLAG_TCS_ACTIVE = 1 << 3,
+  FLAG_EMERGENCY_BRAKE = 1 << 4,
+  FLAG_4X4 = 1 << 5,
+  FLAG_REVERSE = 1 << 6,
+};
+
+// One control tick, fixed-point. Wheel order FL, FR, RL, RR.
+struct Sample {
+  uint32_t tickMs;
+  uint16_t pedalPermille;      // 0..1000
+  int16_t steeringDeciDeg;     // 0.1 deg
+  uint16_t wheelCentiKmh[4];   // 0.01 km/h
+  int16_t motorDeciA[4];       // Traction motor current, 0.1 A
+  int16_t batteryDeciA;        // 0.1 A
+  int16_t steeringDeciA;       // Steering motor current, 0.1 A
+  uint8_t motorPwm[4];         // Traction PWM 0..255
+  int16_t steeringPwm;         // Steering motor PWM (signed)
+  uint8_t limpState;           // LimpMode::LimpState
+  uint8_t wheelMask;           // Bits 0-3 ABS active, bits 4-7 TCS active
+  uint8_t flags;               // Flag
+  uint8_t event;               // Trigger raised at this tick (or NONE)
+  uint16_t reserved;
+};
+static_assert(sizeof(Sample) == 40, "Sample is part of the dump format");
+
+struct DumpHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t sampleSize;
+  uint32_t seq;         // Increases with every dump
+  uint32_t triggerMs;   // tickMs of the trigger sample
+  uint8_t trigger;      // Trigger
+  uint8_t reserved[3];
+  uint16_t preSamples;  // Samples before the trigger sample
+  uint16_t sampleCount; // Samples in the dump
+  uint32_t dataCrc;     // crc32 of the samples
+  uint32_t crc;         // crc32 of the header up to here
+};
+
+enum class State : uint8_t {
+  RECORDING, // Waiting for a trigger
+  CAPTURING, // Trigger seen, collecting post-trigger samples
+  FROZEN,    // Window complete, waiting for service() to copy it out
+  WRITING,   // Window copied, service() writing it to flash
+};
+
+struct DumpInfo {
+  uint8_t slot;
+  uint32_t seq;
+  uint32_t triggerMs;
+  uint8_t trigger;
+  uint16_t preSamples;
+  uint16_t sampleCount;
+};
+
+struct Stats {
+  bool mounted;
+  State state;
+  uint8_t slots;
+  uint8_t nextSlot;
+  uint32_t samples;    // record() calls
+  uint32_t triggers;   // Triggers that opened a window
+  uint32_t coalesced;  // Triggers while a window was open (marked only)
+  uint32_t dumps;      // Windows written to flash
+  uint32_t overruns;   // Window overwritten before service() copied it
+  uint32_t writeErrors;
+};
+
+/**
+ * Mount on device with the caller's buffers (PSRAM on the device): ring of
+ * RING_SAMPLES and stage of WINDOW_SAMPLES entries. Scans the slots for the
+ * latest dump.
+ * @return false if the device holds no slot or a buffer is null
+ */
+bool begin(FlashJournal::FlashDevice &device, Sample *ring, Sample *stage);
+
+void end();
+
+bool isMounted();
+
+// Producer (control job only): store one tick. Fixed cost.
+void record(const Sample &sample);
+
+// Any task: request a window at the next record(). Further triggers before
+// that record() are coalesced. Lock-free.
+void trigger(Trigger reason);
+
+/**
+ * Consumer (journal job): copies a frozen window out of the ring, then
+ * erases / writes at most one sector per call.
+ * @return true if flash was touched
+ */
+bool service();
+
+State getState();
+
+// Dumps on flash, newest first; returns how many
+uint8_t listDumps(DumpInfo *out, uint8_t max);
+
+// One sample of a dump listed by listDumps()
+bool readSample(const DumpInfo &dump, uint16_t index, Sample &out);
+
+void getStats(Stats &out);
+
+// Device glue (black_box_device.cpp)
+// Allocates the ring in PSRAM and mounts the "blackbox" partition
+bool initDevice();
+// Snapshot of pedal, steering, wheels, currents, PWM, limp and ABS/TCS state
+void capture();
+
+} // namespace BlackBox
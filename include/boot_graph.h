@@ -0,0 +1,110 @@
+// boot_graph.h - Dependency-graph boot orchestrator
+// Every boot step declares the steps it depends on and the buses it drives.
+// run() executes the graph with one worker per core: a step starts as soon as
+// its dependencies have succeeded and none of its buses is held by a running
+// step, so independent chains (display reset + HUD + logo on SPI, I2C devices,
+// UART sensors, NVS) overlap instead of queueing behind the slowest one.
+// Each step is timestamped and printTimeline() dumps the boot profile.
+// The planner (validate/next/complete) is pure C++ so the native tests can
+// run it against a virtual clock; the FreeRTOS runner is in
+// boot_graph_rtos.cpp.
+#pragma once
+
+#include <cstdint>
+
+namespace BootGraph {
+
+constexpr uint8_t MAX_STEPS = 32;
+constexpr uint8_t ANY_CORE = 0xFF;
+
+// Shared buses: two steps holding the same bus never run at the same time
+enum Bus : uint8_t {
+  BUS_NONE = 0,
+  BUS_I2C = 1 << 0,
+  BUS_SPI = 1 << 1,
+  BUS_ONEWIRE = 1 << 2,
+  BUS_UART = 1 << 3,
+  BUS_FLASH = 1 << 4, // NVS and the journal partition
+};
+
+// Dependency bitmask for step index `id`
+constexpr uint32_t dep(uint8_t id) { return 1u << id; }
+
+struct Step {
+  const char *name;
+  bool (*fn)();   // false = step failed
+  uint8_t buses;  // Bus bitmask held while fn() runs
+  uint32_t deps;  // Steps that must have succeeded first (dep(id) | ...)
+  uint8_t core;   // Core the step must run on, or ANY_CORE
+};
+
+// Per-run policy, as step bitmasks
+struct Options {
+  uint32_t skip = 0;     // Not run at all (mode / safe mode)
+  uint32_t critical = 0; // A failure stops scheduling further steps
+};
+
+enum class StepState : uint8_t { PENDING, RUNNING, DONE, FAILED, SKIPPED };
+
+struct StepRecord {
+  StepState state;
+  uint8_t core;
+  uint32_t startUs;
+  uint32_t endUs;
+};
+
+// Scheduling state of one run
+struct Plan {
+  const Step *steps;
+  uint8_t count;
+  uint32_t critical;
+  uint8_t busyBuses;
+  uint8_t running;
+  bool aborted;
+  StepRecord rec[MAX_STEPS];
+};
+
+constexpr int8_t NO_FAILURE = -1;
+constexpr int8_t INVALID_GRAPH = -2;
+
+// --- Planner ---
+
+// Rejects unknown dependencies, self-dependencies and cycles
+bool validate(const Step *steps, uint8_t count);
+
+// Resets `plan`, marks skipped steps and their dependents as SKIPPED
+void reset(Plan &plan, const Step *steps, uint8_t count, const Options &opt);
+
+// Claims the first runnable step (table order) for `core` (ANY_CORE accepts
+// pinned steps too) and marks it RUNNING. -1 if nothing is runnable now.
+int8_t next(Plan &plan, uint8_t core, uint32_t nowUs);
+
+// Releases the step's buses; a failure skips its dependents and, for a
+// critical step, aborts the run
+void complete(Plan &plan, uint8_t idx, bool ok, uint32_t nowUs);
+
+// Nothing running and nothing left that can start
+bool finished(const Plan &plan);
+
+// Index of the first critical step that failed, or NO_FAILURE
+int8_t failedCritical(const Plan &plan);
+
+// Sum of step durations (what a strictly sequential boot would take)
+uint32_t serialUs(const Plan &plan);
+
+// Span from the first step start to the last step end
+uint32_t makespanUs(const Plan &plan);
+
+// --- Runner (FreeRTOS) ---
+
+// Runs the graph on both cores and blocks until it finishes.
+// @return index of the failed critical step, NO_FAILURE or INVALID_GRAPH
+int8_t run(const Step *steps, uint8_t count, const Options &opt);
+
+// Plan of the last run()
+const Plan &lastRun();
+
+// Per-step timeline of the last run over serial
+void printTimeline();
+
+} // namespace BootGraph
@@ -0,0 +1,242 @@
+// config_store.h - Unified typed configuration store
+// Replaces the four overlapping config systems (Storage "vehicle" blob,
+// ConfigStorage "car_config", ConfigManager "coche" and EEPROMPersistence's
+// five namespaces) with one schema-described store in the "cfg" namespace:
+// - One NVS key per field (NVS CRCs every entry), described by a schema
+//   table with type and valid range
+// - One namespace scan at boot; sections are read lazily on first access
+// - commit() writes only fields whose value changed since the last
+//   load/commit, so saving one LED setting touches one key
+// - SCHEMA_VERSION plus a migration table; version 0 imports the legacy
+//   layouts (legacy namespaces are left untouched for rollback)
+// The engine is pure C++ over a Backend so the native tests can run the
+// migrations on a fake NVS.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ConfigStore {
+
+constexpr uint16_t SCHEMA_VERSION = 1;
+constexpr const char *NAMESPACE = "cfg";
+
+// ============================================================================
+// Sections
+// ============================================================================
+
+enum Section : uint8_t {
+  SECTION_VEHICLE,
+  SECTION_HUD,
+  SECTION_SENSORS,
+  SECTION_ENCODER,
+  SECTION_POWER,
+  SECTION_LEDS,
+  SECTION_GENERAL,
+  SECTION_OBSTACLE,
+  SECTION_MAINTENANCE,
+  SECTION_ERRORS,
+  SECTION_COUNT
+};
+
+struct Vehicle {
+  int32_t pedalMin;
+  int32_t pedalMax;
+  uint8_t pedalCurve;
+  uint8_t regenPercent; // 0-100
+  float shuntCoeff[6];  // INA226: batería, FL, FR, RL, RR, dirección
+  int32_t steerZeroOffset;
+  float maxBatteryCurrentA;
+  float maxMotorCurrentA;
+  bool tractionEnabled;
+  bool steeringEnabled;
+};
+
+struct Hud {
+  bool showTemps;
+  bool showEffort;
+  uint8_t displayBrightness;
+  bool touchEnabled;
+  uint16_t touchCalibration[5]; // [min_x, max_x, min_y, max_y, rotation]
+  bool touchCalibrated;
+  bool shadowHudEnabled;
+};
+
+struct Sensors {
+  bool wheelSensorsEnabled; // Módulos completos
+  bool tempSensorsEnabled;
+  bool currentSensorsEnabled;
+  bool wheel[4];         // FL, FR, RL, RR
+  bool ina226Enabled;    // Interruptor global del menú de sensores
+  bool ina226Channel[6]; // FL, FR, RL, RR, batería, dirección
+  bool encoderEnabled;
+};
+
+struct Encoder {
+  int16_t center;
+  int16_t leftLimit;
+  int16_t rightLimit;
+  bool calibrated;
+};
+
+struct Power {
+  uint16_t holdDelayMs;
+  uint16_t auxDelayMs;
+  uint16_t tractionDelayMs;
+  uint16_t shutdownDelayMs;
+  bool autoShutdown;
+};
+
+struct Leds {
+  uint8_t pattern;
+  uint8_t brightness;
+  uint8_t speed;
+  uint32_t color; // 0xRRGGBB
+  bool enabled;
+};
+
+struct General {
+  bool audioEnabled;
+  uint8_t volume;
+  bool absEnabled;
+  bool tcsEnabled;
+  bool regenEnabled;
+  bool wifiEnabled;
+  uint8_t driveMode;
+  bool menuPinEnabled;
+  uint16_t menuPin;
+  uint16_t menuTimeoutSec;
+  uint8_t absSlipThreshold; // % slip
+  uint8_t tcsSlipThreshold; // % slip
+  char btMacAddress[18];    // XX:XX:XX:XX:XX:XX
+  bool btAutoReconnect;
+};
+
+struct Obstacle {
+  uint16_t criticalMm;
+  uint16_t warningMm;
+  uint16_t cautionMm;
+  bool sensorEnabled; // Sensor frontal (índice 0)
+  bool audioAlerts;
+  bool visualAlerts;
+};
+
+// Same layout as the legacy Storage structs (Storage:: aliases these)
+struct Odometer {
+  float totalKm;
+  float tripKm;
+  float lastServiceKm;
+  uint32_t lastServiceDate;
+  uint32_t engineHours;
+};
+
+struct ErrorEntry {
+  uint16_t code;
+  uint32_t timestamp;
+};
+
+struct Maintenance {
+  Odometer odometer; // Backup copy: the live odometer is in FlashJournal
+  uint16_t intervalKm;
+  uint16_t intervalDays;
+};
+
+constexpr int MAX_ERRORS = 16;
+
+struct Errors {
+  ErrorEntry entries[MAX_ERRORS];
+  int32_t count;
+};
+
+struct Settings {
+  Vehicle vehicle;
+  Hud hud;
+  Sensors sensors;
+  Encoder encoder;
+  Power power;
+  Leds leds;
+  General general;
+  Obstacle obstacle;
+  Maintenance maintenance;
+  Errors errors;
+};
+
+// ============================================================================
+// Storage backend (NVS on the device, a map in the native tests)
+// ============================================================================
+
+// Entry types as stored by NVS / Preferences (bool is U8, float is a blob)
+enum class ValueType : uint8_t { U8, I8, U16, I16, U32, I32, BLOB };
+
+class Backend {
+public:
+  typedef void (*ScanFn)(const char *key, ValueType type, void *ctx);
+
+  virtual ~Backend() {}
+  // Calls fn once per entry in the namespace; false if it does not exist
+  virtual bool scan(const char *ns, ScanFn fn, void *ctx) = 0;
+  // Typed read; false if missing or stored with another type/size
+  virtual bool read(const char *ns, const char *key, ValueType type,
+                    void *out, size_t len) = 0;
+  virtual bool write(const char *ns, const char *key, ValueType type,
+                     const void *in, size_t len) = 0;
+  virtual bool eraseNamespace(const char *ns) = 0;
+  // Make previous writes durable (nvs_commit)
+  virtual bool sync(const char *ns) = 0;
+};
+
+// ============================================================================
+// API
+// ============================================================================
+
+struct Stats {
+  bool mounted;
+  uint16_t version;       // Version found at mount (0 = legacy/empty)
+  uint8_t keysFound;      // Schema keys present in the namespace
+  uint8_t sectionsLoaded; // Sections read so far (lazy loading)
+  uint32_t fieldReads;
+  uint32_t fieldWrites;
+  uint32_t skippedWrites;  // Sections committed with nothing changed
+  uint32_t rangeResets;    // Stored values out of range, default used
+  uint32_t writeErrors;
+  uint8_t migrationsRun;
+  uint8_t legacyLayouts; // Legacy layouts imported by the v0 migration
+};
+
+/**
+ * Mount: one scan of the namespace, then migrations up to SCHEMA_VERSION.
+ * Sections are read later, on first access.
+ */
+bool begin(Backend &backend);
+void end();
+bool isMounted();
+
+// Section accessors (load the section on first use). Mutate the returned
+// struct, then commit() to persist the fields that changed.
+Vehicle &vehicle();
+Hud &hud();
+Sensors &sensors();
+Encoder &encoder();
+Power &power();
+Leds &leds();
+General &general();
+Obstacle &obstacle();
+Maintenance &maintenance();
+Errors &errors();
+
+bool isLoaded(Section section);
+
+// Write back changed fields of one section / of every loaded section
+bool commit(Section section);
+bool commit();
+
+// Factory reset: erase the namespace and persist defaults
+bool resetToDefaults();
+
+const Settings &defaults();
+void getStats(Stats &out);
+
+// Device glue (config_store_nvs.cpp): mounts the store on the NVS partition
+bool init();
+
+} // namespace ConfigStore
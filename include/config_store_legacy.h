@@ -0,0 +1,73 @@
+// config_store_legacy.h - Pre-ConfigStore persistence layouts (migration v0)
+// Namespaces, keys and the raw Storage::Config v8 blob written by the four
+// config systems that ConfigStore replaced. Only the v0 -> v1 migration and
+// its native test use this; nothing writes these layouts any more.
+#pragma once
+
+#include "config_store.h"
+
+namespace ConfigStore {
+namespace Legacy {
+
+// Storage (namespace "vehicle"): magic + raw struct blob
+constexpr const char *VEHICLE_NS = "vehicle";
+constexpr const char *VEHICLE_KEY_MAGIC = "magic";
+constexpr const char *VEHICLE_KEY_BLOB = "config";
+constexpr uint32_t VEHICLE_MAGIC = 0xDEADBEEF;
+constexpr uint16_t VEHICLE_VERSION = 8;
+
+// Storage::Config as of kConfigVersion 8 (int is 32-bit on the ESP32)
+struct VehicleV8 {
+  int32_t pedalMin;
+  int32_t pedalMax;
+  uint8_t pedalCurve;
+  uint8_t regenPercent;
+  float shuntCoeff[6];
+  int32_t steerZeroOffset;
+  bool showTemps;
+  bool showEffort;
+  uint8_t displayBrightness;
+  float maxBatteryCurrentA;
+  float maxMotorCurrentA;
+  bool audioEnabled;
+  bool tractionEnabled;
+  bool wheelSensorsEnabled;
+  bool tempSensorsEnabled;
+  bool currentSensorsEnabled;
+  bool steeringEnabled;
+  bool touchEnabled;
+  uint16_t touchCalibration[5];
+  bool touchCalibrated;
+  bool shadowHudEnabled;
+  Odometer odometer;
+  uint16_t maintenanceIntervalKm;
+  uint16_t maintenanceIntervalDays;
+  ErrorEntry errors[MAX_ERRORS];
+  int32_t errorCount;
+  uint16_t version;
+  uint32_t checksum;
+};
+
+// FNV-1a over the same fields Storage::computeChecksum() mixed
+uint32_t vehicleChecksum(const VehicleV8 &v);
+
+// ConfigStorage (namespace "car_config"): per-field keys + "checksum"
+constexpr const char *CAR_CONFIG_NS = "car_config";
+
+// ConfigManager (namespace "coche"): per-field keys + "crc"
+constexpr const char *COCHE_NS = "coche";
+
+// EEPROMPersistence: one namespace per module
+constexpr const char *EEPROM_ENCODER_NS = "ENCODER";
+constexpr const char *EEPROM_SENSORS_NS = "SENSORS";
+constexpr const char *EEPROM_POWER_NS = "POWER";
+constexpr const char *EEPROM_LEDS_NS = "LEDS";
+constexpr const char *EEPROM_GENERAL_NS = "GENERAL";
+
+// Import every legacy layout found, lowest precedence first:
+// ConfigManager, EEPROMPersistence, ConfigStorage, Storage blob
+// @return number of layouts found
+uint8_t importAll(Backend &backend, Settings &out);
+
+} // namespace Legacy
+} // namespace ConfigStore
@@ -0,0 +1,101 @@
+// error_journal.h - Lock-free in-RAM error journal with deferred flush
+// System::logError() records here instead of writing NVS. record() is a
+// handful of atomic operations on a fixed open-addressed table keyed by
+// error code: no lock, no allocation, no flash, callable from any task on
+// either core. Each code keeps its occurrence count, first/last timestamps
+// and the latest context word.
+// A single consumer (the journal job) calls flush() to acknowledge what
+// changed and hand codes seen for the first time to the persistent log,
+// so a burst of faults costs one NVS write per flush, not one per code.
+// Pure C++ (std::atomic) so the native tests can hammer it from threads.
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+namespace ErrorJournal {
+
+constexpr uint8_t CAPACITY = 64; // Distinct codes held in RAM
+
+struct Entry {
+  uint16_t code;
+  uint32_t count;   // Occurrences since boot (or clear())
+  uint32_t firstMs; // First occurrence
+  uint32_t lastMs;  // Latest occurrence
+  uint32_t context; // Context word of the latest occurrence
+};
+
+struct Stats {
+  uint32_t recorded; // record() calls accepted
+  uint32_t dropped;  // Table full: new code not stored
+  uint8_t codes;     // Distinct codes in the table
+  uint32_t flushes;  // flush() calls that found changes
+  uint32_t newCodes; // Codes handed to the persistent log
+};
+
+/**
+ * Record one occurrence. Lock-free; safe from any task on either core.
+ * Code 0 is reserved (free slot) and ignored.
+ * @param isNew set true when this call claimed the code's slot (first
+ *        occurrence since boot or clear()), so the caller can react now
+ *        instead of at the next flush()
+ * @return false if the code is new and the table is full
+ */
+bool record(uint16_t code, uint32_t nowMs, uint32_t context = 0,
+            bool *isNew = nullptr);
+
+// Anything recorded since the last flush()
+bool pending();
+
+/**
+ * Consumer side (one task): acknowledge all changes and call onNew once for
+ * each code seen for the first time, oldest first.
+ * @return number of new codes
+ */
+uint8_t flush(void (*onNew)(const Entry &entry));
+
+// Codes recorded but not yet handed to the persistent log by flush().
+// Copies up to max codes; callable from any task.
+uint8_t unlogged(uint16_t *out, uint8_t max);
+
+/**
+ * Distinct codes once the next flush() lands: the persistent log (any
+ * struct with a `code` field) plus every unlogged code not already in it,
+ * capped at max like the log itself. What LimpMode counts between flushes.
+ */
+template <typename LogEntry>
+int distinctCount(const LogEntry *log, int logCount, int max) {
+  uint16_t codes[CAPACITY];
+  uint8_t n = unlogged(codes, CAPACITY);
+  int count = logCount;
+  for (uint8_t i = 0; i < n && count < max; i++) {
+    bool known = false;
+    for (int j = 0; j < logCount && !known; j++) {
+      known = log[j].code == codes[i];
+    }
+    if (!known) count++;
+  }
+  return count;
+}
+
+// Latest values for one code (false if never recorded)
+bool get(uint16_t code, Entry &out);
+
+// Copies up to max entries, table order; returns how many
+uint8_t snapshot(Entry *out, uint8_t max);
+
+void getStats(Stats &out);
+
+// Forget everything. Not concurrent with record(): an occurrence racing
+// with clear() may be lost.
+void clear();
+
+// Context word for a float reading: the raw IEEE-754 bits, so NaN and
+// infinities survive (a cast to an integer would not)
+inline uint32_t contextOf(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+} // namespace ErrorJournal
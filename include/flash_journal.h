@@ -0,0 +1,99 @@
+// flash_journal.h - Wear-leveled append-only key/value journal
+// Small CRC'd records are appended to a dedicated flash partition used as a
+// ring of 4 KB sectors; the latest value of each key is cached in RAM and
+// rebuilt by replaying the ring at boot. Sector erases happen in service()
+// (background job): before the oldest sector is erased its still-live
+// records are re-appended at the head (compaction). A torn record from a
+// power cut fails its CRC and is ignored at replay.
+// The engine is pure C++ over a FlashDevice so the native tests can run it
+// on a simulated NOR flash with power-cut injection.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace FlashJournal {
+
+// Geometry / limits
+constexpr uint32_t SECTOR_SIZE = 4096;
+constexpr uint8_t MAX_SECTORS = 32;
+constexpr uint8_t MIN_SECTORS = 3;
+constexpr uint8_t MAX_KEYS = 16;    // Keys 1..MAX_KEYS-1 (0 is invalid)
+constexpr uint8_t MAX_PAYLOAD = 64; // Bytes per record
+constexpr uint8_t RESERVE_SECTORS = 2; // Erased sectors service() keeps ahead
+
+// Record keys (stable on flash: never renumber, only append)
+enum Key : uint8_t {
+  KEY_INVALID = 0,
+  KEY_ODOMETER = 1,  // Storage::OdometerData
+  KEY_TELEMETRY = 2, // Telemetry persistent counters
+};
+
+// Raw NOR flash access (erased = 0xFF, writes only clear bits)
+class FlashDevice {
+public:
+  virtual ~FlashDevice() {}
+  virtual uint32_t sectorCount() const = 0;
+  virtual bool read(uint32_t addr, void *dst, uint32_t len) = 0;
+  virtual bool write(uint32_t addr, const void *src, uint32_t len) = 0;
+  virtual bool eraseSector(uint32_t sector) = 0;
+};
+
+struct Stats {
+  bool mounted;
+  uint8_t sectors;
+  uint8_t headSector;
+  uint8_t erasedAhead;     // Erased sectors after the head
+  uint16_t headOffset;     // Write position inside the head sector
+  uint8_t liveKeys;
+  uint32_t replayedRecords;
+  uint32_t corruptRecords; // Torn / bad-CRC records found at replay
+  uint32_t appends;
+  uint32_t skippedAppends; // Identical to cached value, not written
+  uint32_t relocations;    // Records copied forward by compaction
+  uint32_t erases;
+  uint32_t inlineCompactions; // Append had to compact (service() starved)
+  uint32_t writeErrors;
+};
+
+/**
+ * Mount the journal and replay it (all state from a previous mount is
+ * discarded). Unformatted or garbage sectors are treated as free.
+ * @return false if the device is too small / unreadable
+ */
+bool begin(FlashDevice &device);
+
+// Unmount (RAM state only; flash is always consistent)
+void end();
+
+bool isMounted();
+
+/**
+ * Append a new value for key (1..MAX_KEYS-1, len <= MAX_PAYLOAD).
+ * Only writes flash (no erase) unless the reserve is exhausted.
+ * @return true once the record is on flash (or identical to the cache)
+ */
+bool append(uint8_t key, const void *data, uint8_t len);
+
+/**
+ * Latest value of key from the RAM cache
+ * @return false if the key was never written or len differs
+ */
+bool read(uint8_t key, void *out, uint8_t len);
+
+bool has(uint8_t key);
+
+// Background maintenance: erases/compacts at most one sector per call
+// until RESERVE_SECTORS erased sectors are available ahead of the head.
+// @return true if a sector was erased
+bool service();
+
+void getStats(Stats &out);
+
+// CRC-32 (IEEE 802.3, reflected) used for sector headers and records
+uint32_t crc32(uint32_t crc, const void *data, size_t len);
+
+// Device glue (journal_partition.cpp): mounts the "journal" data partition
+bool initPartition();
+
+} // namespace FlashJournal
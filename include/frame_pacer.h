@@ -0,0 +1,100 @@
+// frame_pacer.h - Adaptive HUD frame pacing
+// The HUD job used to run every 33 ms and HUDManager::update() applied its
+// own 33 ms millis() gate on top. That meant 30 render passes per second on
+// a static screen, and a frame was dropped whenever the job released a
+// millisecond early against the gate.
+// Now the job ticks every TICK_MS, and a Pacer decides on each tick whether
+// to render:
+// - IDLE: nothing changed lately, refresh every IDLE_INTERVAL_MS
+// - ACTIVE: content changed in the last ACTIVE_HOLD_MS (the dashboard
+//   input probe, a frame that pushed pixels, a live menu), 30 FPS
+// - BURST: content changed on consecutive frames (needle sweep, menu
+//   animation) or requestBurst() (touch), up to 60 FPS
+// Under load the interval is floored by a ladder (60/30/20/15/10 FPS). It
+// steps down one level per STEP_MS when core 1 is busy or the average
+// render no longer fits the interval. It steps back up after RECOVER_MS
+// of headroom. Frames are phase-locked to their slots, half a tick early
+// counting as on time, so tick jitter never drops a frame. A slot missed
+// by a late tick or an overrun counts as a skipped frame.
+// Pure C++ (times passed in) so the native tests can drive it.
+#pragma once
+
+#include <cstdint>
+
+namespace FramePacer {
+
+// Intervals are whole ticks so the slots never drift against the ticks
+constexpr uint32_t TICK_MS = 16;                     // HUD job period
+constexpr uint32_t ACTIVE_INTERVAL_MS = 2 * TICK_MS; // ~30 FPS
+constexpr uint32_t IDLE_INTERVAL_MS = 12 * TICK_MS;  // Minimum refresh, ~5 FPS
+constexpr uint32_t ACTIVE_HOLD_MS = 500; // Stay ACTIVE after a change
+constexpr uint32_t BURST_HOLD_MS = 250;  // Stay in BURST after motion
+
+// Load ladder: minimum frame interval per level (level 0 allows bursts)
+constexpr uint32_t LADDER_MS[] = {TICK_MS, 2 * TICK_MS, 3 * TICK_MS,
+                                  4 * TICK_MS, 6 * TICK_MS};
+constexpr uint8_t LADDER_LEVELS = sizeof(LADDER_MS) / sizeof(LADDER_MS[0]);
+constexpr uint8_t START_LEVEL = 1; // 30 FPS until headroom is proven
+constexpr float LOAD_HIGH_PCT = 85.0f; // Core 1 busy: step down
+constexpr float LOAD_LOW_PCT = 65.0f;  // Headroom: may step up
+constexpr uint32_t STEP_MS = 250;      // At most one step down per period
+constexpr uint32_t RECOVER_MS = 1000;  // Headroom needed to step up
+
+enum class Mode : uint8_t { IDLE, ACTIVE, BURST };
+
+struct Stats {
+  uint32_t targetFps;     // 1000 / current interval
+  uint32_t actualFps;     // Frames rendered over the last full second
+  uint32_t framesRendered;
+  uint32_t skippedFrames; // Slots missed (late tick, overrun)
+  uint32_t avgRenderUs;   // Smoothed render time
+  Mode mode;
+  uint8_t loadLevel;      // Index into LADDER_MS
+};
+
+class Pacer {
+public:
+  Pacer();
+
+  // Content is pending (e.g. the dashboard inputs moved): ACTIVE rate
+  void notifyChange(uint32_t nowMs);
+
+  // Animation or touch drag: BURST rate if the load level allows it
+  void requestBurst(uint32_t nowMs);
+
+  // Render on the next tick whatever the rate (menu switch, error screen)
+  void requestFrame();
+
+  // Called on every tick; true if a frame should be rendered now
+  // @param coreLoadPct Utilization of the HUD core over the last window
+  bool shouldRender(uint32_t nowMs, float coreLoadPct);
+
+  // Called after each rendered frame
+  // @param changed The frame changed pixels on screen
+  void frameDone(uint32_t nowMs, uint32_t renderUs, bool changed);
+
+  Mode mode(uint32_t nowMs) const;
+  uint32_t intervalMs(uint32_t nowMs) const;
+  Stats stats(uint32_t nowMs) const;
+
+private:
+  void adapt(uint32_t nowMs, float coreLoadPct);
+
+  bool started;
+  bool framePending;
+  bool lastChanged;
+  uint8_t level;
+  uint32_t slotMs;      // Phase reference of the last rendered slot
+  uint32_t activeUntilMs;
+  uint32_t burstUntilMs;
+  uint32_t lastStepMs;
+  uint32_t calmSinceMs;
+  uint32_t avgRenderUs;
+  uint32_t frames;
+  uint32_t skipped;
+  uint32_t windowStartMs;
+  uint32_t windowFrames;
+  uint32_t lastWindowFps;
+};
+
+} // namespace FramePacer
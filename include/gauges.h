@@ -4,6 +4,8 @@
 
 namespace Gauges {
 void init(TFT_eSPI *display);
+// Next draw repaints both gauges entirely (screen was cleared)
+void invalidate();
 // Phase 6: Added sprite parameter for compositor mode (nullptr = use TFT)
 void drawSpeed(int cx, int cy, float kmh, int maxKmh, float pedalPct,
                TFT_eSprite *sprite = nullptr);
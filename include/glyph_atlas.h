@@ -0,0 +1,175 @@
+// glyph_atlas.h - Pre-rasterized glyphs and cached text runs for HUD numbers
+// The gauges redrew their value every frame with drawString(): clear the box,
+// walk the font tables, push every glyph - also when the number had not
+// changed. Instead, the characters we actually draw are rasterized once at
+// boot into 1 bpp masks (Atlas), and each on-screen number owns a TextRun
+// that remembers what it last drew. Redrawing the same text with the same
+// colours is skipped entirely; otherwise only the glyph cells that changed
+// (plus the strip a shorter text leaves behind) are blitted.
+// Atlas, TextRun planning and the RGB565 expansion are pure C++ (native
+// tests); baking from TFT_eSPI fonts and pushing cells is in
+// glyph_atlas_tft.cpp.
+#pragma once
+
+#include "static_string.h"
+#include <cstdint>
+
+class TFT_eSPI;
+namespace HudLayer {
+struct RenderContext;
+}
+
+namespace GlyphAtlas {
+
+constexpr uint8_t MAX_GLYPHS = 48;     // All fonts together
+constexpr uint16_t ATLAS_BYTES = 2048; // 1 bpp mask storage
+constexpr uint8_t MAX_GLYPH_W = 32;    // Widest cell a mask can hold
+constexpr uint8_t MAX_GLYPH_H = 32;
+constexpr uint8_t MAX_FONT = 8;        // TFT_eSPI font numbers 1..8
+constexpr uint8_t RUN_CAPACITY = 12;   // Characters per run incl. NUL
+
+// One baked character: w x h mask, rows of (w + 7) / 8 bytes, MSB first
+struct Glyph {
+  char ch;
+  uint8_t font;
+  uint8_t w, h;
+  uint16_t offset; // Into the atlas storage
+};
+
+// Source of glyph pixels for bake(): TFT_eSPI fonts on the target, a
+// synthetic font in the native tests
+class Rasterizer {
+public:
+  virtual ~Rasterizer() = default;
+  virtual uint8_t height(uint8_t font) = 0;
+  virtual uint8_t width(uint8_t font, char ch) = 0;
+  // Renders ch at (0, 0); pixel() is valid until the next render()
+  virtual void render(uint8_t font, char ch) = 0;
+  virtual bool pixel(int16_t x, int16_t y) = 0;
+};
+
+class Atlas {
+public:
+  // Adds every character of charset for font (already present ones are
+  // skipped). @return false when storage or glyph slots ran out; the
+  // characters baked before that stay usable
+  bool bake(Rasterizer &r, uint8_t font, const char *charset);
+  void clear();
+
+  const Glyph *find(uint8_t font, char ch) const;
+  // True if every character of text is baked for font
+  bool covers(uint8_t font, const char *text) const;
+  int16_t textWidth(uint8_t font, const char *text) const;
+  uint8_t height(uint8_t font) const;
+
+  bool bit(const Glyph &g, uint8_t x, uint8_t y) const;
+  // Expands g into RGB565 at dst (row stride in pixels). swapBytes = store
+  // big-endian, as TFT_eSPI pushImage() expects when getSwapBytes() is false
+  void blit(const Glyph &g, uint16_t fg, uint16_t bg, uint16_t *dst,
+            uint16_t stride, bool swapBytes = false) const;
+
+  uint8_t glyphCount() const { return count_; }
+  uint16_t bytesUsed() const { return used_; }
+
+private:
+  Glyph glyphs_[MAX_GLYPHS] = {};
+  uint8_t count_ = 0;
+  uint8_t bits_[ATLAS_BYTES] = {};
+  uint16_t used_ = 0;
+  uint8_t heights_[MAX_FONT + 1] = {};
+};
+
+enum class Align : uint8_t { LEFT, CENTER, RIGHT };
+
+// A glyph cell to blit (screen coordinates)
+struct Cell {
+  const Glyph *glyph;
+  int16_t x, y;
+};
+
+// Background strip to clear (text got shorter or moved)
+struct Span {
+  int16_t x, y, w, h;
+};
+
+// What one TextRun::plan() asks the renderer to push
+struct Plan {
+  Cell cells[RUN_CAPACITY];
+  uint8_t cellCount;
+  Span erase[2]; // Left and right of the new text
+  uint8_t eraseCount;
+  uint16_t fg, bg;
+  int16_t left, width; // Extent of the new text
+  uint32_t pixels;     // Cells + erase
+  bool skip;           // Same text, same colours, nothing overdrawn
+};
+
+// One number/label at a fixed anchor. Vertical anchor is the middle of the
+// font height (MC/ML/MR_DATUM), as the HUD draws its values
+class TextRun {
+public:
+  TextRun(uint8_t font, Align align, int16_t x, int16_t y)
+      : font_(font), align_(align), x_(x), y_(y) {}
+
+  // Cells that differ from what is on screen. Needs atlas.covers(text)
+  Plan plan(const Atlas &atlas, const char *text, uint16_t fg,
+            uint16_t bg) const;
+  // The plan was pushed: it is now what is on screen
+  void commit(const char *text, const Plan &p);
+  // Something else drew over the run: next plan redraws every cell
+  void invalidate() { valid_ = false; }
+
+  void moveTo(int16_t x, int16_t y) {
+    if (x == x_ && y == y_) return;
+    x_ = x;
+    y_ = y;
+    valid_ = false;
+  }
+
+  uint8_t font() const { return font_; }
+  Align align() const { return align_; }
+  int16_t x() const { return x_; }
+  int16_t y() const { return y_; }
+  const char *text() const { return text_.c_str(); }
+
+private:
+  int16_t originX(int16_t width) const;
+
+  uint8_t font_;
+  Align align_;
+  int16_t x_, y_;
+  StaticString<RUN_CAPACITY> text_;
+  uint16_t fg_ = 0, bg_ = 0;
+  int16_t left_ = 0, width_ = 0; // Extent on screen
+  bool valid_ = false;
+};
+
+// Counters since boot (glyph_atlas_tft.cpp)
+struct Stats {
+  uint32_t runs;        // drawRun() calls
+  uint32_t skipped;     // Unchanged: nothing pushed
+  uint32_t cellsDrawn;  // Glyph cells blitted
+  uint32_t cellsKept;   // Glyph cells left on screen
+  uint32_t fallbacks;   // Text not in the atlas: drawString()
+  uint32_t pixels;      // Pixels pushed (cells + erase)
+  uint32_t renderUs;    // Time inside drawRun()
+};
+
+// --- Target side (glyph_atlas_tft.cpp) ---
+
+// Bakes the HUD character sets from the TFT_eSPI fonts (idempotent)
+bool bakeHudFonts(TFT_eSPI *display);
+Atlas &atlas();
+
+// Draws text through run into ctx.sprite or, without sprite, display.
+// Mirrors to the shadow sprite in RENDER_SHADOW_MODE. Falls back to
+// drawString() for characters the atlas does not hold. @return pixels pushed
+uint32_t drawRun(TextRun &run, const HudLayer::RenderContext &ctx,
+                 TFT_eSPI *display, const char *text, uint16_t fg,
+                 uint16_t bg);
+
+const Stats &stats();
+void resetStats();
+void logStats();
+
+} // namespace GlyphAtlas
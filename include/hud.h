@@ -1,5 +1,6 @@
 #pragma once
-#include "hud_layer.h" // Phase 10: RenderContext support
+#include "hud_layer.h"   // Phase 10: RenderContext support
+#include "touch_input.h" // Touch gesture events
 #include <TFT_eSPI.h>
 
 namespace HUD {
@@ -12,6 +13,11 @@ void showError();
 void update(TFT_eSprite *sprite = nullptr);
 void update(HudLayer::RenderContext &ctx);
 
+// true si algún widget del BASE cambiaría en el próximo frame (entradas
+// cuantizadas o zonas invalidadas); el pacer de frames lo consulta en cada
+// tick para no renderizar una pantalla estática
+bool hasPendingChanges();
+
 void drawPedalBar(
     float pedalPercent,
     TFT_eSprite *sprite = nullptr); // Barra de pedal en parte inferior
@@ -19,6 +25,10 @@ void drawPedalBar(
     float pedalPercent,
     HudLayer::RenderContext &ctx); // Phase 10: RenderContext version
 
+// Toques del dashboard (batería, 4x4, giro, botón demo); HUDManager entrega
+// los eventos de TouchInput antes de dibujar el frame
+void handleTouch(const TouchInput::Event &event);
+
 // Control de giro sobre eje (axis rotation)
 void toggleAxisRotation();
 bool isAxisRotationEnabled();
@@ -0,0 +1,128 @@
+// hud_base_model.h - Per-widget change model for the BASE HUD layer
+// HUD::update(RenderContext&) used to call every dashboard widget each
+// frame and leave change detection to each widget's own cache, with its
+// own threshold (0.1 V here, 0.5 °C there, none for the mode text, which
+// was marked dirty every frame). Here the frame's inputs are snapshotted
+// into one Inputs struct and a declarative field table quantizes each of
+// them to the resolution its widget displays (0.1 km/h, 1 °C, 0.1 V...).
+// A widget is redrawn and dirty-marked only when one of its keys changes,
+// or when the compositor cleared pixels under it (invalidateUnder). Keys
+// have hysteresis: one moves only once its value is a full step away from
+// the drawn key, so sensor noise sitting on a rounding boundary does not
+// flip it every frame and a steady cruise pushes (almost) no pixels.
+// Pure C++ so the native tests can drive it with recorded traces.
+#pragma once
+
+#include <cstdint>
+
+namespace HudBaseModel {
+
+enum Widget : uint8_t {
+  SPEED = 0,
+  RPM,
+  WHEEL_FL,
+  WHEEL_FR,
+  WHEEL_RL,
+  WHEEL_RR,
+  STEERING, // Over the car body, redrawn with it
+  SYSTEM_STATE,
+  GEAR,
+  FEATURES,
+  BATTERY,
+  AMBIENT_TEMP,
+  ERRORS,
+  SENSOR_STATUS,
+  TEMP_WARNING,
+  MODE,
+  PEDAL,
+  WIDGET_COUNT
+};
+
+constexpr uint32_t bit(Widget w) { return 1u << w; }
+constexpr uint32_t ALL_WIDGETS = (1u << WIDGET_COUNT) - 1u;
+constexpr uint32_t GAUGE_WIDGETS = bit(SPEED) | bit(RPM);
+constexpr uint32_t WHEEL_WIDGETS =
+    bit(WHEEL_FL) | bit(WHEEL_FR) | bit(WHEEL_RL) | bit(WHEEL_RR);
+constexpr uint32_t ICON_WIDGETS = bit(SYSTEM_STATE) | bit(GEAR) |
+                                  bit(FEATURES) | bit(BATTERY) |
+                                  bit(AMBIENT_TEMP) | bit(ERRORS) |
+                                  bit(SENSOR_STATUS) | bit(TEMP_WARNING);
+
+// Steps past the rounding boundary of the drawn key a value must move
+// before the key changes (0.5: a full step from the drawn value)
+constexpr float HYSTERESIS = 0.5f;
+
+// Screen rectangle (same fields as HudLayer::DirtyRect), empty if w/h <= 0
+struct Rect {
+  int16_t x, y, w, h;
+};
+
+// Everything the BASE widgets display, gathered once per frame
+struct Inputs {
+  float speedKmh;
+  float rpm;
+  float pedalPercent;  // -1 if the pedal is invalid
+  float steerFL;       // Degrees
+  float steerFR;
+  float steerAngle;    // Steering wheel: average of FL/FR
+  float wheelTemp[4];  // FL, FR, RL, RR; -999 if temperature sensors are off
+  float wheelEffort[4]; // -1 if current sensors are off
+  float batteryVolts;
+  float ambientTemp;
+  float maxTemp;
+  uint16_t errorCount;
+  uint8_t systemState;
+  uint8_t gear;
+  uint8_t mode;        // OperationMode
+  uint8_t sensorCurrentOK;
+  uint8_t sensorTempOK;
+  uint8_t sensorWheelOK;
+  bool mode4x4;
+  bool eco;
+  bool tempWarning;
+};
+
+constexpr int FIELD_COUNT = 27; // Rows of the field table
+
+class Model {
+public:
+  // @param bounds WIDGET_COUNT rects, the area each widget clears and
+  //               marks dirty in the BASE layer (empty if not in BASE)
+  explicit Model(const Rect *bounds);
+
+  // Redraw these widgets on the next update() whatever their inputs
+  void invalidate(uint32_t widgets = ALL_WIDGETS);
+
+  // The compositor cleared these rects: the widgets under them redraw
+  // @return widgets invalidated
+  uint32_t invalidateUnder(const Rect *cleared, int count);
+
+  // Quantizes the inputs and returns the widgets to redraw this frame
+  // (changed keys and invalidated widgets). The caller must redraw all of
+  // them: the keys are taken as drawn.
+  uint32_t update(const Inputs &in);
+
+  // Widgets update(in) would redraw, without taking the keys as drawn
+  // (lets the frame pacer probe for changes between frames)
+  uint32_t pending(const Inputs &in) const;
+
+  // Pixels the given widgets mark dirty (overlaps counted twice, as in
+  // the compositor's dirty rect list)
+  uint32_t dirtyPixels(uint32_t widgets) const;
+
+  // Widgets whose own keys changed in the last update() (the rest of its
+  // result was invalidated)
+  uint32_t changedKeys() const { return keyChanges; }
+
+  // Widget redraws requested since construction
+  uint32_t redraws() const { return redrawCount; }
+
+private:
+  Rect bounds[WIDGET_COUNT];
+  int32_t keys[FIELD_COUNT];
+  uint32_t forced;
+  uint32_t keyChanges;
+  uint32_t redrawCount;
+};
+
+} // namespace HudBaseModel
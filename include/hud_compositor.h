@@ -1,6 +1,8 @@
 #pragma once
 
 #include "hud_layer.h"
+#include "pooled_sprite.h"
+#include "tear_sync.h"
 #include <TFT_eSPI.h>
 
 /**
@@ -14,6 +16,9 @@
  *
  * ARCHITECTURE:
  * - Owns one sprite per layer (BASE, STATUS, DIAGNOSTICS, OVERLAY, FULLSCREEN)
+ *   plus the shadow sprite: the HUD's whole sprite budget (SPRITE_BUDGET),
+ *   reserved in the sprite pool at init. The car body and the steering
+ *   wheel are BASE widgets; there is no second sprite engine.
  * - Manages layer renderer registration
  * - Composites layers in deterministic order
  * - Pushes only the final composite to TFT
@@ -31,6 +36,9 @@
  */
 class HudCompositor {
 public:
+  static constexpr int LAYER_COUNT = 5;
+  static constexpr uint8_t SPRITE_BUDGET = LAYER_COUNT + 1; // + shadow
+
   /**
    * @brief Initialize the compositor
    * @param tftDisplay Pointer to TFT_eSPI display instance
@@ -101,6 +109,14 @@ public:
    */
   static TFT_eSprite *getLayerSprite(HudLayer::Layer layer);
 
+  /**
+   * @brief Get the shadow validation sprite (PHASE 7)
+   * @return Pointer to sprite, or nullptr while shadow mode is off
+   *
+   * Target of the RENDER_SHADOW_MODE mirror macros (shadow_render.h).
+   */
+  static TFT_eSprite *getShadowSprite();
+
   /**
    * @brief Enable or disable shadow mode validation (PHASE 7)
    * @param enabled true to enable shadow mode, false to disable
@@ -150,13 +166,26 @@ public:
     uint32_t lastFrameTimeMs;      // Last frame render time in ms
     uint32_t avgFrameTimeMs;       // Average frame time in ms (smoothed)
     uint32_t fps;                  // Frames per second (1000 / avgFrameTimeMs)
+    uint32_t targetFps;            // Frame pacer target rate
+    uint32_t actualFps;            // Frames rendered over the last second
+    uint32_t skippedFrames;        // Pacer slots missed (late tick, overrun)
     uint32_t dirtyRectCount;       // Number of dirty rectangles this frame
     uint32_t dirtyPixels;          // Total pixels marked dirty this frame
     uint32_t bytesPushed;          // Bytes pushed to TFT (dirtyPixels * 2)
     bool shadowEnabled;            // Shadow mode active flag
-    uint32_t shadowBlocksCompared; // Blocks compared in shadow mode
+    uint32_t shadowBlocksCompared; // Blocks compared in the last frame
+    uint32_t shadowCompareUs;      // Time spent comparing the last frame
     uint32_t shadowMismatches;     // Frames with shadow mismatches
     uint32_t psramUsedBytes;       // PSRAM used by sprites
+    uint32_t psramBudgetBytes;     // Reserved for all of them (SPRITE_BUDGET)
+    uint32_t clampedRects;         // Dirty rects clipped to the screen
+    uint32_t rejectedRects;        // Dirty rects empty or off screen
+    uint32_t rectOverflows;        // Rect lists collapsed to full screen
+    uint32_t nullSprites;          // Layer sprite requests with no sprite
+    TearSync::Mode tearSyncMode;   // Push ordering against the panel scan
+    uint32_t tearRiskRects;        // Pushes the scan crossed this frame
+    uint32_t tearRiskFrames;       // Frames with at least one such push
+    uint32_t tearWaitUs;           // Waited for the scan this frame
   };
 
   /**
@@ -165,29 +194,38 @@ public:
    */
   static const RenderStats &getRenderStats();
 
+  /**
+   * @brief Publish the frame pacer's rates into the render stats
+   * @param targetFps Rate the pacer is currently aiming for
+   * @param actualFps Frames rendered over the last second
+   * @param skippedFrames Total pacer slots missed
+   *
+   * Called by HUDManager after each paced frame; the compositor only
+   * renders, the rate is decided by HUDManager's FramePacer.
+   */
+  static void setPacingStats(uint32_t targetFps, uint32_t actualFps,
+                             uint32_t skippedFrames);
+
 private:
-  static constexpr int LAYER_COUNT = 5;
   static constexpr int SCREEN_WIDTH = 480;
   static constexpr int SCREEN_HEIGHT = 320;
 
   // PHASE 7: Shadow mode block comparison configuration
+  // (block hashing in shadow_compare.h)
   static constexpr int SHADOW_BLOCK_SIZE = 16; // 16x16 pixel blocks
-  static constexpr int SHADOW_BLOCKS_X = SCREEN_WIDTH / SHADOW_BLOCK_SIZE; // 30
-  static constexpr int SHADOW_BLOCKS_Y =
-      SCREEN_HEIGHT / SHADOW_BLOCK_SIZE; // 20
 
   // PHASE 8: Dirty rectangle tracking
   static constexpr int MAX_DIRTY_RECTS =
       16; // Maximum dirty rectangles per frame
 
   static TFT_eSPI *tft;
-  static TFT_eSprite *layerSprites[LAYER_COUNT];
+  static PooledSprite *layerSprites[LAYER_COUNT];
   static HudLayer::LayerRenderer *layerRenderers[LAYER_COUNT];
   static bool layerDirty[LAYER_COUNT];
   static bool initialized;
 
   // PHASE 7: Shadow mode validation
-  static TFT_eSprite *shadowSprite;         // Shadow validation sprite
+  static PooledSprite *shadowSprite;        // Shadow validation sprite
   static bool shadowEnabled;                // Shadow mode active flag
   static uint32_t shadowFrameCount;         // Total frames compared
   static uint32_t shadowMismatchCount;      // Frames with mismatches
@@ -210,8 +248,6 @@ private:
   // PHASE 7: Shadow mode helpers
   static bool createShadowSprite();
   static void compareShadowSprites();
-  static uint16_t computeBlockChecksum(TFT_eSprite *sprite, int blockX,
-                                       int blockY);
 
   // PHASE 8: Dirty rectangle helpers
   static void mergeDirtyRects();
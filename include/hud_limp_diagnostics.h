@@ -18,7 +18,7 @@
  * The HUD must be a mirror of the safety engine, not parallel logic.
  *
  * DESIGN PRINCIPLES:
- * - Data source: ONLY LimpMode::getDiagnostics()
+ * - Data source: ONLY LimpMode::readDiagnostics() (versioned snapshot)
  * - No sensor reading, no config reading, no inference
  * - Efficient: Only redraws when diagnostics change (not every frame)
  * - Read-only: Does not modify limp mode logic
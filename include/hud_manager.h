@@ -4,6 +4,7 @@
 #include "display_types.h"
 #include "render_event.h" // Thread-safe render event system
 #include "sensors.h"      // For Sensors::InputDeviceStatus type
+#include "touch_input.h"  // Touch gesture events
 #include <TFT_eSPI.h>
 
 /**
@@ -31,8 +32,10 @@ public:
   static bool init();
 
   /**
-   * @brief Actualiza la visualización (llamar en loop principal)
-   * Frame rate: 30 FPS (33ms por frame)
+   * @brief Actualiza la visualización (llamar en cada tick del job HUD)
+   * Frame rate: lo decide FramePacer (frame_pacer.h): 5 FPS con pantalla
+   * estática, 30 FPS con cambios y hasta 60 FPS en movimiento si el core 1
+   * tiene margen
    */
   static void update();
 
@@ -89,12 +92,25 @@ public:
   static bool queueRenderEvent(const RenderEvent::Event &event);
 
   /**
-   * @brief Procesa evento táctil
-   * @param x Coordenada X
-   * @param y Coordenada Y
-   * @param pressed Estado (presionado/liberado)
+   * @brief Procesa un evento táctil de TouchInput
+   * @param event Gesto (tap, pulsación larga, arrastre) con su posición
+   *
+   * Llamado desde update() al vaciar la cola de TouchInput. El menú oculto
+   * recibe los toques mientras está activo; el dashboard los recibe siempre.
+   */
+  static void handleTouch(const TouchInput::Event &event);
+
+  /**
+   * @brief Acceso exclusivo al bus SPI de la pantalla
+   * @param timeoutMs Espera máxima
+   * @return true si se obtuvo (liberar con unlockDisplayBus())
+   *
+   * Concesión DISPLAY de SpiBus (spi_bus.h): update() la retiene durante el
+   * frame y el compositor la cede entre capas y rects cuando la tarea de
+   * TouchInput espera el bus.
    */
-  static void handleTouch(int16_t x, int16_t y, bool pressed);
+  static bool lockDisplayBus(uint32_t timeoutMs);
+  static void unlockDisplayBus();
 
   /**
    * @brief Establece brillo del backlight
@@ -143,7 +159,6 @@ public:
 private:
   static MenuType currentMenu;
   static CarData carData;
-  static uint32_t lastUpdateMs;
   static bool needsRedraw;
   static uint8_t brightness;
 
@@ -160,6 +175,7 @@ private:
   // Helper methods
   static void clearScreenIfNeeded();
   static void processRenderEvents(); // 🔒 NEW: Process queued render events
+  static void renderFrame();         // Frame body, display bus held
 
   // Color calculation helpers for status display
   static uint16_t getSensorStatusColor(uint8_t okCount, uint8_t totalCount);
@@ -0,0 +1,318 @@
+// hud_widgets.h - Retained-mode widgets for HUD menus
+// Menus build a Screen of widgets once (label, value field, slider, toggle,
+// button, list, ...) and then only change widget state. Each setter compares
+// against the value that was last rendered and marks the widget dirty only
+// when it differs; render() redraws just the dirty widgets (list: just the
+// dirty rows) and reports their own rects to the RenderContext, instead of
+// the fillScreen + full redraw each menu did on every touch.
+// Screen::hitTest() replaces the hand-written coordinate checks.
+// Widget state, invalidation, hit-testing and pixel accounting are pure C++
+// (native tests); drawing is in hud_widgets_tft.cpp.
+#pragma once
+
+#include "static_string.h"
+#include <cstdint>
+
+class TFT_eSPI;
+namespace HudLayer {
+struct RenderContext;
+}
+
+namespace HudWidgets {
+
+constexpr uint8_t MAX_WIDGETS = 40;   // Per screen
+constexpr uint8_t TEXT_CAPACITY = 40; // Label/button text incl. NUL
+constexpr uint8_t LIST_MAX_ROWS = 32; // One dirty bit per row
+
+struct Rect {
+  int16_t x, y, w, h;
+
+  bool contains(int16_t px, int16_t py) const {
+    return px >= x && px < x + w && py >= y && py < y + h;
+  }
+  uint32_t area() const {
+    return (w > 0 && h > 0) ? static_cast<uint32_t>(w) * h : 0;
+  }
+};
+
+enum class Align : uint8_t { LEFT, CENTER, RIGHT };
+
+enum class Kind : uint8_t {
+  LABEL,     // Static or changing text
+  VALUE,     // Number through a printf format ("%ld ms")
+  SLIDER,    // Horizontal bar between min and max
+  TOGGLE,    // ON/OFF switch
+  BUTTON,    // Text on a filled face
+  LIST,      // Vertical list of rows with one selected
+  INDICATOR, // Filled status dot
+  FRAME,     // 1 px outline (h = 1: horizontal rule)
+  CUSTOM,    // Menu-specific drawing callback
+};
+
+// Colours are RGB565 (TFT_* constants)
+struct Style {
+  uint16_t fg = 0xFFFF;     // Text
+  uint16_t bg = 0x0000;     // Behind the widget (screen background)
+  uint16_t accent = 0x07E0; // Slider fill, toggle ON, button face, selection
+  uint16_t border = 0xFFFF; // Outline (slider, toggle, button, frame)
+  uint8_t font = 2;         // TFT_eSPI font number
+  uint8_t radius = 0;       // Corner radius of filled shapes
+  uint8_t padding = 0;      // Text inset for LEFT/RIGHT alignment
+  Align align = Align::LEFT;
+  bool outlined = true;     // Draw the border
+
+  bool operator==(const Style &o) const {
+    return fg == o.fg && bg == o.bg && accent == o.accent &&
+           border == o.border && font == o.font && radius == o.radius &&
+           padding == o.padding && align == o.align && outlined == o.outlined;
+  }
+  bool operator!=(const Style &o) const { return !(*this == o); }
+};
+
+class Widget {
+public:
+  Widget(Kind kind, Rect rect, bool interactive)
+      : kind_(kind), interactive_(interactive), rect_(rect) {}
+  virtual ~Widget() = default;
+
+  Kind kind() const { return kind_; }
+  const Rect &rect() const { return rect_; }
+  const Style &style() const { return style_; }
+
+  // All setters mark the widget dirty only when the value changes
+  void setStyle(const Style &s);
+  void setFg(uint16_t c);
+  void setAccent(uint16_t c);
+  void setBorder(uint16_t c);
+  void setEnabled(bool enabled);
+  bool isEnabled() const { return enabled_; }
+
+  // Touchable and enabled, and (x, y) inside the rect
+  bool hit(int16_t x, int16_t y) const {
+    return interactive_ && enabled_ && rect_.contains(x, y);
+  }
+
+  void invalidate() { dirty_ = true; }
+  bool isDirty() const { return dirty_ || partMask_ != 0; }
+  // Pixels the next render of this widget pushes
+  virtual uint32_t dirtyPixels() const { return dirty_ ? rect_.area() : 0; }
+  // Called by render() once the widget is on screen
+  void clean() {
+    dirty_ = false;
+    partMask_ = 0;
+  }
+
+protected:
+  // Generic "assign and invalidate if different"
+  template <typename T> bool update(T &field, const T &value) {
+    if (field == value) return false;
+    field = value;
+    dirty_ = true;
+    return true;
+  }
+
+  bool dirty_ = true;     // Whole widget
+  uint32_t partMask_ = 0; // Sub-parts (list rows) when not whole
+
+private:
+  Kind kind_;
+  bool interactive_;
+  bool enabled_ = true;
+  Rect rect_;
+  Style style_;
+};
+
+class Label : public Widget {
+public:
+  explicit Label(Rect rect, const char *text = "")
+      : Widget(Kind::LABEL, rect, false), text_(text) {}
+  bool setText(const char *text);
+  const char *text() const { return text_.c_str(); }
+
+private:
+  StaticString<TEXT_CAPACITY> text_;
+};
+
+class ValueField : public Widget {
+public:
+  // fmt takes one long: "%ld ms", "%ldmm", "%04ld"
+  ValueField(Rect rect, const char *fmt)
+      : Widget(Kind::VALUE, rect, false), fmt_(fmt) {}
+  bool setValue(int32_t v) { return update(value_, v); }
+  int32_t value() const { return value_; }
+  void format(char *out, size_t size) const;
+
+private:
+  const char *fmt_;
+  int32_t value_ = 0;
+};
+
+class Slider : public Widget {
+public:
+  Slider(Rect rect, int32_t min, int32_t max, int32_t step = 1);
+  // Clamped to [min, max]; @return true if the value changed
+  bool setValue(int32_t v);
+  int32_t value() const { return value_; }
+  int32_t min() const { return min_; }
+  int32_t max() const { return max_; }
+  // Value under a touch at screen x, rounded to step
+  int32_t valueAt(int16_t x) const;
+  // Moves to the touch when it hits; @return true if the value changed
+  bool touch(int16_t x, int16_t y);
+  // Filled width in pixels for the current value
+  int16_t fillWidth() const;
+  // Unfilled part of the bar (default TFT_DARKGREY)
+  void setTrack(uint16_t c) { update(track_, c); }
+  uint16_t track() const { return track_; }
+
+private:
+  int32_t min_, max_, step_;
+  int32_t value_;
+  uint16_t track_ = 0x7BEF;
+};
+
+class Toggle : public Widget {
+public:
+  Toggle(Rect rect, uint16_t offColor, const char *onText = "ON",
+         const char *offText = "OFF")
+      : Widget(Kind::TOGGLE, rect, true), offColor_(offColor),
+        onText_(onText), offText_(offText) {}
+  bool setOn(bool on) { return update(on_, on); }
+  bool isOn() const { return on_; }
+  bool toggle() { return setOn(!on_); }
+  uint16_t faceColor() const { return on_ ? style().accent : offColor_; }
+  const char *text() const { return on_ ? onText_ : offText_; }
+
+private:
+  uint16_t offColor_;
+  const char *onText_;
+  const char *offText_;
+  bool on_ = false;
+};
+
+class Button : public Widget {
+public:
+  Button(Rect rect, const char *label)
+      : Widget(Kind::BUTTON, rect, true), label_(label) {}
+  bool setLabel(const char *label);
+  const char *label() const { return label_.c_str(); }
+
+private:
+  StaticString<TEXT_CAPACITY> label_;
+};
+
+class List : public Widget {
+public:
+  List(Rect rect, int16_t rowHeight, const char *const *items, uint8_t count);
+  // -1 = no selection; only the old and new rows are redrawn
+  bool setSelected(int8_t row);
+  int8_t selected() const { return selected_; }
+  uint8_t count() const { return count_; }
+  const char *item(uint8_t row) const { return items_[row]; }
+  Rect rowRect(uint8_t row) const;
+  // Row under (x, y) or -1
+  int8_t rowAt(int16_t x, int16_t y) const;
+  bool isRowDirty(uint8_t row) const {
+    return dirty_ || ((partMask_ >> row) & 1);
+  }
+  uint32_t dirtyPixels() const override;
+
+private:
+  void invalidateRow(int8_t row);
+
+  int16_t rowHeight_;
+  const char *const *items_;
+  uint8_t count_;
+  int8_t selected_ = -1;
+};
+
+class Indicator : public Widget {
+public:
+  explicit Indicator(Rect rect) : Widget(Kind::INDICATOR, rect, false) {}
+};
+
+class Frame : public Widget {
+public:
+  explicit Frame(Rect rect) : Widget(Kind::FRAME, rect, false) {}
+  // Outline only: the inside belongs to other widgets
+  uint32_t dirtyPixels() const override;
+};
+
+class Custom;
+// Draws at local (x, y) = top-left of the widget rect in the render target
+using DrawFn = void (*)(TFT_eSPI &gfx, const Custom &w, int16_t x, int16_t y);
+
+class Custom : public Widget {
+public:
+  Custom(Rect rect, DrawFn draw, bool interactive = false)
+      : Widget(Kind::CUSTOM, rect, interactive), draw_(draw) {}
+  DrawFn drawFn() const { return draw_; }
+  // State the callback draws from (hue, pattern, ...)
+  bool setValue(int32_t v) { return update(value_, v); }
+  int32_t value() const { return value_; }
+
+private:
+  DrawFn draw_;
+  int32_t value_ = 0;
+};
+
+// Widgets of one menu page in draw order (later = on top for hit-testing)
+class Screen {
+public:
+  struct Stats {
+    uint32_t renders;       // render() calls that pushed pixels
+    uint32_t widgetsDrawn;  // Widget (or list row) redraws
+    uint32_t pixelsPushed;  // Total pixels written
+    uint32_t lastPixels;    // Pixels of the last non-empty render
+    uint32_t maxPixels;     // Largest single render
+  };
+
+  explicit Screen(uint16_t background = 0x0000) : background_(background) {}
+
+  // @return false when MAX_WIDGETS is reached
+  bool add(Widget &w);
+  void clear();
+  uint8_t count() const { return count_; }
+  Widget &at(uint8_t i) const { return *widgets_[i]; }
+
+  // Topmost enabled interactive widget under (x, y), or nullptr
+  Widget *hitTest(int16_t x, int16_t y) const;
+
+  // Next render clears the whole target first and redraws every widget
+  // (first show, or after another screen drew over this one)
+  void invalidateAll();
+  bool needsClear() const { return clearPending_; }
+  bool isDirty() const;
+  // Pixels the next render pushes (clear included)
+  uint32_t dirtyPixels(int16_t width, int16_t height) const;
+
+  uint16_t background() const { return background_; }
+
+  // render() bookkeeping
+  void markCleared() { clearPending_ = false; }
+  void record(uint32_t pixels, uint32_t widgets);
+  const Stats &stats() const { return stats_; }
+  void resetStats() { stats_ = {}; }
+
+private:
+  Widget *widgets_[MAX_WIDGETS] = {};
+  uint8_t count_ = 0;
+  uint16_t background_;
+  bool clearPending_ = true;
+  Stats stats_ = {};
+};
+
+// --- Drawing (hud_widgets_tft.cpp) ---
+
+// Redraws the dirty widgets of the screen into ctx.sprite (compositor
+// layers) or straight to display when ctx has no sprite, and reports each
+// redrawn rect with ctx.markDirty(). @return pixels pushed
+uint32_t render(Screen &screen, TFT_eSPI *display,
+                HudLayer::RenderContext &ctx);
+// Direct-to-display render for menus that own the whole screen
+uint32_t render(Screen &screen, TFT_eSPI *display);
+
+// One log line with the screen's pixel statistics
+void logStats(const char *name, const Screen &screen);
+
+} // namespace HudWidgets
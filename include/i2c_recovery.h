@@ -11,15 +11,17 @@
  * I²C
  * 3. Timeout Aplicación: Límite de tiempo para transacciones I²C a nivel de
  * código
- * 4. Retry exponencial: 1, 2, 4, 8s (máx 30s)
+ * 4. Backoff exponencial: 50, 100, 200 ms... (máx 2 s)
  * 5. Skip sensor: Marca dispositivo como "offline" si falla repetidamente
  * 6. Re-init progresivo: Sensor → Canal multiplexor → Bus completo
  *
  * CONFIGURACIÓN DE TIMEOUT:
  * - I2CCMDTIMEOUT_MS: Timeout del driver I²C (hardware level)
  *   Configurado con Wire.setTimeOut() para prevenir colgado del hardware I²C
- * - Timeout de aplicación: 100ms para operaciones individuales de
- * lectura/escritura
+ * - Un timeout es un bloqueo del bus, no un NACK: no se reintenta, se hace
+ *   un único recoverBus() y el bus queda en pausa (BUS_QUIET_MS, o backoff
+ *   si sigue atascado). Peor caso por barrido del powerJob: un timeout del
+ *   driver + recovery (~5.5 ms), medido en test_scenarios (i2c_faults.cpp)
  *
  * USO CON TCA9548A:
  * - Llamar I2CRecovery::init() una vez
@@ -32,11 +34,17 @@ namespace I2CRecovery {
 // Configuración de timeout a nivel de driver I²C
 // ⚠️ CRÍTICO: Timeout del driver I²C (Wire.setTimeOut()) para prevenir colgado
 // del hardware I²C, no solo timeout a nivel de aplicación
-constexpr uint16_t I2CCMDTIMEOUT_MS = 100; // Timeout driver I²C en milisegundos
+// La transacción más larga del coche (PCA9685, 5 bytes a 100 kHz) dura
+// ~0.5 ms; ningún dispositivo del bus hace clock stretching. 5 ms mantiene
+// un bloqueo por debajo de un periodo de control (10 ms).
+constexpr uint16_t I2CCMDTIMEOUT_MS = 5; // Timeout driver I²C en milisegundos
 
 // Configuración de retry
-constexpr uint8_t MAX_RETRIES = 3;         // Número máximo de reintentos
-constexpr uint32_t MAX_BACKOFF_MS = 30000; // Backoff máximo: 30 segundos
+constexpr uint8_t MAX_RETRIES = 3;         // Reintentos tras NACK
+constexpr uint32_t RETRY_DELAY_US = 100;   // Pausa entre reintentos
+constexpr uint32_t BACKOFF_BASE_MS = 50;   // Medio periodo del powerJob
+constexpr uint32_t MAX_BACKOFF_MS = 2000;  // Backoff máximo: 2 segundos
+constexpr uint32_t BUS_QUIET_MS = 20;      // Pausa del bus tras un recovery
 constexpr uint32_t SKIP_SENSOR_AFTER_MS = 60000; // Marcar offline tras 1 min
 
 // Estados de dispositivos I²C
@@ -9,6 +9,9 @@
 namespace Icons {
 void init(TFT_eSPI *display);
 
+// Olvida lo dibujado: la próxima llamada de cada icono redibuja
+void invalidate();
+
 // Phase 6.2: All drawing functions accept optional sprite for compositor mode
 void drawSystemState(System::State st, TFT_eSprite *sprite = nullptr);
 void drawGear(Shifter::Gear g, TFT_eSprite *sprite = nullptr);
@@ -1,7 +1,7 @@
 #pragma once
 
 #include "pins.h"
-#include <FastLED.h>
+#include <cstdint>
 
 // LED Strip Configuration - Use centralized pin definitions from pins.h
 // ⚠️ IMPORTANTE: Los pines de LEDs se definen en pins.h como PIN_LED_FRONT y
@@ -75,8 +75,8 @@ void init();
 // Check if LED system initialized successfully
 bool initOK();
 
-// Update LED animations (call in main loop)
-void update();
+// Frames are rendered by the LedEngine task every Config::updateRateMs
+// (led_engine.h); the setters below only change what the next frame shows.
 
 // Set front LED mode based on throttle/pedal
 void setFrontMode(FrontMode mode);
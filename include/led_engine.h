@@ -0,0 +1,263 @@
+// led_engine.h - Layered LED animation engine with non-blocking RMT output
+// LEDController used to compute its patterns and then call FastLED.show(),
+// which blocks the caller for the whole transmission with interrupts held
+// off (the watchdog was fed right before it). Now a timer-paced task renders
+// each strip as a stack of layers (scanner, chase, rainbow, flash, turn
+// signals, ...) blended by priority into a back buffer, encodes it into RMT
+// items and starts the transmit without waiting. Each output has two item
+// buffers: one in flight, one being filled. A frame that finds the
+// transmitter still busy is skipped; a frame equal to what the strip shows
+// is not sent at all. The RMT peripheral clocks the bits out by itself, so
+// the wheel-speed and encoder ISRs are never masked.
+// Layers, compositing and the WS2812 encoder are pure C++ (native tests);
+// the RMT channels and the task are in led_engine_rmt.cpp.
+#pragma once
+
+#include <cstdint>
+
+namespace LedEngine {
+
+constexpr uint8_t MAX_PIXELS = 32; // Per strip (front strip: 28)
+constexpr uint8_t MAX_LAYERS = 8;  // Per strip
+constexpr uint8_t MAX_OUTPUTS = 2; // Front + rear
+constexpr uint8_t BITS_PER_PIXEL = 24;
+
+// WS2812B bit timing in RMT ticks (80 MHz APB / CLK_DIV = 25 ns per tick)
+constexpr uint8_t RMT_CLK_DIV = 2;
+constexpr uint16_t T0H_TICKS = 16; // 0.40 us
+constexpr uint16_t T0L_TICKS = 34; // 0.85 us
+constexpr uint16_t T1H_TICKS = 32; // 0.80 us
+constexpr uint16_t T1L_TICKS = 18; // 0.45 us
+
+struct Rgb {
+  uint8_t r, g, b;
+
+  bool operator==(const Rgb &o) const {
+    return r == o.r && g == o.g && b == o.b;
+  }
+  bool operator!=(const Rgb &o) const { return !(*this == o); }
+};
+
+// Same values as the FastLED CRGB names the patterns used
+constexpr Rgb BLACK = {0, 0, 0};
+constexpr Rgb RED = {255, 0, 0};
+constexpr Rgb ORANGE = {255, 165, 0};
+constexpr Rgb YELLOW = {255, 255, 0};
+constexpr Rgb GREEN = {0, 128, 0};
+constexpr Rgb BLUE = {0, 0, 255};
+constexpr Rgb WHITE = {255, 255, 255};
+constexpr Rgb AMBER = {255, 100, 0};
+
+// --- Colour helpers (FastLED semantics) ---
+
+// v * (scale + 1) / 256, per channel
+Rgb scale(Rgb c, uint8_t scale);
+// fadeToBlackBy(): scale by 255 - amount
+inline Rgb fade(Rgb c, uint8_t amount) {
+  return scale(c, static_cast<uint8_t>(255 - amount));
+}
+// amount 0 = a, 255 = b
+Rgb blend(Rgb a, Rgb b, uint8_t amount);
+// Full-saturation, full-value hue wheel (0..255)
+Rgb hue(uint8_t h);
+
+// What one layer drew this frame. Pixels start transparent (alpha 0).
+struct Canvas {
+  Rgb px[MAX_PIXELS];
+  uint8_t alpha[MAX_PIXELS]; // 0 = shows the layers below, 255 = opaque
+  uint8_t count;
+
+  void reset(uint8_t n);
+  void set(uint8_t i, Rgb c, uint8_t a = 255) {
+    if (i >= count) return;
+    px[i] = c;
+    alpha[i] = a;
+  }
+  void fill(uint8_t from, uint8_t n, Rgb c, uint8_t a = 255);
+};
+
+// Per-frame timing shared by every layer of a frame
+struct Tick {
+  uint32_t nowMs;
+  uint16_t step; // Frame counter (animation position)
+  bool blink;    // Turn-signal phase
+};
+
+// One animation. Higher priority draws over lower; opacity scales the
+// whole layer. Disabled layers are skipped (transparent).
+class Layer {
+public:
+  explicit Layer(uint8_t priority) : priority_(priority) {}
+  virtual ~Layer() = default;
+
+  virtual void render(Canvas &c, const Tick &t) = 0;
+  // Restart the animation (mode change)
+  virtual void restart() {}
+
+  uint8_t priority() const { return priority_; }
+  void setEnabled(bool en) { enabled_ = en; }
+  bool isEnabled() const { return enabled_; }
+  void setOpacity(uint8_t a) { opacity_ = a; }
+  uint8_t opacity() const { return opacity_; }
+
+private:
+  uint8_t priority_;
+  uint8_t opacity_ = 255;
+  bool enabled_ = false;
+};
+
+// Every pixel of [from, from + n) in one colour at a brightness level
+class SolidLayer : public Layer {
+public:
+  SolidLayer(uint8_t priority, uint8_t from, uint8_t n)
+      : Layer(priority), from_(from), n_(n) {}
+  void set(Rgb c, uint8_t level = 255) {
+    color_ = c;
+    level_ = level;
+  }
+  void render(Canvas &c, const Tick &t) override;
+
+private:
+  uint8_t from_, n_;
+  Rgb color_ = BLACK;
+  uint8_t level_ = 255;
+};
+
+// KITT scanner: bright head bouncing end to end with a fading tail
+class ScannerLayer : public Layer {
+public:
+  ScannerLayer(uint8_t priority, uint8_t tail, uint8_t fadeRate)
+      : Layer(priority), tail_(tail), fadeRate_(fadeRate) {}
+  void setColor(Rgb c) { color_ = c; }
+  void render(Canvas &c, const Tick &t) override;
+  void restart() override;
+  int8_t position() const { return pos_; }
+
+private:
+  uint8_t tail_, fadeRate_;
+  Rgb color_ = RED;
+  Rgb trail_[MAX_PIXELS] = {};
+  int8_t pos_ = 0;
+  int8_t dir_ = 1;
+};
+
+// Five-pixel comet running from the start, one step every `speed` frames
+class ChaseLayer : public Layer {
+public:
+  ChaseLayer(uint8_t priority, uint8_t fadeRate)
+      : Layer(priority), fadeRate_(fadeRate) {}
+  void set(Rgb c, uint8_t speed) {
+    color_ = c;
+    speed_ = speed;
+  }
+  void render(Canvas &c, const Tick &t) override;
+  void restart() override;
+
+private:
+  uint8_t fadeRate_;
+  Rgb color_ = RED;
+  uint8_t speed_ = 1;
+  Rgb trail_[MAX_PIXELS] = {};
+};
+
+// Hue wheel spread over the strip, rotating `speed` hue steps per frame
+class RainbowLayer : public Layer {
+public:
+  explicit RainbowLayer(uint8_t priority) : Layer(priority) {}
+  void setSpeed(uint8_t speed) { speed_ = speed; }
+  void render(Canvas &c, const Tick &t) override;
+
+private:
+  uint8_t speed_ = 3;
+};
+
+// Whole strip alternating between two colours on the blink phase
+class FlashLayer : public Layer {
+public:
+  explicit FlashLayer(uint8_t priority) : Layer(priority) {}
+  void set(Rgb on, Rgb off) {
+    on_ = on;
+    off_ = off;
+  }
+  void render(Canvas &c, const Tick &t) override;
+
+private:
+  Rgb on_ = RED, off_ = BLACK;
+};
+
+// Turn signal on [from, from + n): blinks, or walks one pixel per 10 frames
+// during the on phase when sequential
+class BlinkerLayer : public Layer {
+public:
+  BlinkerLayer(uint8_t priority, uint8_t from, uint8_t n, Rgb color)
+      : Layer(priority), from_(from), n_(n), color_(color) {}
+  void setSequential(bool seq) { sequential_ = seq; }
+  void render(Canvas &c, const Tick &t) override;
+
+private:
+  uint8_t from_, n_;
+  Rgb color_;
+  bool sequential_ = false;
+};
+
+// Layers of one strip, composited in priority order
+class Strip {
+public:
+  explicit Strip(uint8_t count) : count_(count > MAX_PIXELS ? MAX_PIXELS
+                                                            : count) {}
+  // Kept sorted by priority. @return false when MAX_LAYERS is reached
+  bool add(Layer &layer);
+  // Renders every enabled layer and blends it over black into out[count]
+  void compose(Rgb *out, const Tick &t);
+  uint8_t count() const { return count_; }
+  uint8_t layerCount() const { return layerCount_; }
+
+private:
+  uint8_t count_;
+  Layer *layers_[MAX_LAYERS] = {};
+  uint8_t layerCount_ = 0;
+  Canvas canvas_ = {};
+};
+
+// GRB, MSB first, one RMT item (rmt_item32_t layout) per bit, with the
+// global brightness applied. @return items written (n * 24)
+uint16_t encodeWs2812(const Rgb *px, uint8_t n, uint8_t brightness,
+                      uint32_t *items);
+
+struct Stats {
+  uint32_t frames;      // Rendered by the task
+  uint32_t sent;        // Transmits started (per strip)
+  uint32_t unchanged;   // Strip already showing the frame: not sent
+  uint32_t busySkipped; // Transmitter still busy: frame dropped
+  uint32_t lastTxUs;    // Start to end-of-transmit of the last frame
+  uint32_t maxTxUs;
+  uint32_t txUsTotal;   // Sum over `sent` (average = txUsTotal / sent)
+  uint32_t maxRenderUs; // Layer compositing of both strips
+};
+
+// --- Target side (led_engine_rmt.cpp) ---
+
+struct Output {
+  int8_t pin;
+  uint8_t count;
+};
+
+// Fills the back buffers (backBuffer(i)) for the frame at nowMs
+using RenderFn = void (*)(uint32_t nowMs);
+
+// Configures one RMT TX channel per output. Call once before start()
+bool begin(const Output *outputs, uint8_t n);
+bool isReady();
+Rgb *backBuffer(uint8_t output);
+// Starts the render task on the HUD core every periodMs
+bool start(uint32_t periodMs, RenderFn render);
+void setPeriod(uint32_t periodMs);
+void setBrightness(uint8_t brightness);
+// Sends the back buffers now and waits up to timeoutMs for the end of the
+// transmit (boot self-test, before start())
+bool show(uint32_t timeoutMs);
+
+const Stats &stats();
+void logStats();
+
+} // namespace LedEngine
@@ -1,4 +1,5 @@
 #pragma once
+#include "limp_rules.h"
 #include <Arduino.h>
 
 /**
@@ -17,16 +18,21 @@
 
 namespace LimpMode {
 
+// LimpState, Thresholds and the rules themselves live in limp_rules.h
+
 /**
- * @brief System degradation states
+ * @brief Inputs that changed since the last update()
  *
- * Represents how badly the system is degraded and what safety limits apply.
+ * Producers call notify() when a value LimpMode reads changes, so update()
+ * re-reads and re-evaluates only the affected rule groups.
  */
-enum class LimpState {
-  NORMAL,   // All systems operational, no limits
-  DEGRADED, // Minor sensor issues, apply soft limits
-  LIMP,     // Significant failures, severe limits (drive-home mode)
-  CRITICAL  // Critical failures, minimal operation only
+enum Source : uint8_t {
+  SOURCE_PEDAL = 1 << 0,       // Pedal::State::valid flipped
+  SOURCE_STEERING = 1 << 1,    // Steering::State valid / centered flipped
+  SOURCE_BATTERY = 1 << 2,     // New battery voltage sample
+  SOURCE_TEMPERATURE = 1 << 3, // New motor temperature conversion
+  SOURCE_ERRORS = 1 << 4,      // System error count changed
+  SOURCE_ALL = 0x1F,
 };
 
 /**
@@ -64,11 +70,20 @@ struct Diagnostics {
  */
 void init();
 
+/**
+ * @brief Flag inputs as changed (lock-free, callable from any task)
+ *
+ * @param sources Mask of Source bits
+ */
+void notify(uint8_t sources);
+
 /**
  * @brief Update limp mode state machine
  *
- * Reads sensor validity, error counts, battery voltage, temperature warnings.
- * Determines current degradation level and applies appropriate limits.
+ * Re-reads only the inputs flagged through notify() (sensor validity, error
+ * count, battery voltage, temperature warnings) and re-evaluates their rule
+ * groups. Every input is re-read once per second regardless, so a missed
+ * notification cannot hold a stale state for longer than that.
  *
  * Call this every frame in main loop, before control outputs are calculated.
  */
@@ -88,6 +103,18 @@ LimpState getState();
  */
 Diagnostics getDiagnostics();
 
+/**
+ * @brief Copy diagnostics only if they changed since the caller last looked
+ *
+ * The snapshot is republished (and its version bumped) only when a field
+ * other than timeInStateMs changes. Pass 0 to force a copy.
+ *
+ * @param seenVersion In: last version copied. Out: version now held.
+ * @param out Filled (timeInStateMs included) only when returning true
+ * @return true if the snapshot changed and was copied
+ */
+bool readDiagnostics(uint32_t &seenVersion, Diagnostics &out);
+
 /**
  * @brief Apply power limit to pedal percentage
  *
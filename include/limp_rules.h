@@ -0,0 +1,87 @@
+// limp_rules.h - LimpMode degradation rules, full and incremental
+// The rules are grouped by the inputs they read: driver inputs (pedal and
+// steering validity, steering centered), battery voltage, motor
+// temperature and the system error count. Each group yields the most
+// severe state its own rules call for; the required state is the most
+// severe over all groups. That is the same answer as walking the CRITICAL,
+// LIMP and DEGRADED rules in order, which evaluateAll() keeps as the
+// reference implementation.
+// RuleSet caches the per-group result so LimpMode::update() re-evaluates
+// only the groups whose inputs were flagged as changed.
+// Pure C++ so the native tests can check both evaluators agree.
+#pragma once
+
+#include <cstdint>
+
+namespace LimpMode {
+
+/**
+ * @brief System degradation states
+ *
+ * Represents how badly the system is degraded and what safety limits apply.
+ */
+enum class LimpState {
+  NORMAL,   // All systems operational, no limits
+  DEGRADED, // Minor sensor issues, apply soft limits
+  LIMP,     // Significant failures, severe limits (drive-home mode)
+  CRITICAL  // Critical failures, minimal operation only
+};
+
+// ==========================================
+// Safety thresholds
+// ==========================================
+namespace Thresholds {
+constexpr float BATTERY_UNDERVOLTAGE = 20.0f; // 24V system, critical at 20V
+constexpr float BATTERY_CRITICAL = 18.0f;     // Below this = CRITICAL
+constexpr float TEMP_WARNING = 80.0f;         // Motor temp warning (°C)
+constexpr float TEMP_CRITICAL = 90.0f;        // Motor temp critical (°C)
+constexpr uint8_t ERROR_COUNT_DEGRADED = 1;   // 1+ errors = DEGRADED
+constexpr uint8_t ERROR_COUNT_LIMP = 3;       // 3+ errors = LIMP
+constexpr uint8_t ERROR_COUNT_CRITICAL = 5;   // 5+ errors = CRITICAL
+} // namespace Thresholds
+
+// Everything the rules read
+struct RuleInputs {
+  bool pedalValid;
+  bool steeringValid;
+  bool steeringCentered;
+  float batteryVoltage; // <= 0 or NaN: no reading, battery rules ignored
+  bool temperatureWarning;
+  bool temperatureCritical;
+  uint8_t systemErrorCount;
+};
+
+// Rule groups (bit mask of groups to re-evaluate)
+enum RuleGroup : uint8_t {
+  GROUP_INPUTS = 1 << 0,      // pedalValid, steeringValid, steeringCentered
+  GROUP_BATTERY = 1 << 1,     // batteryVoltage
+  GROUP_TEMPERATURE = 1 << 2, // temperatureWarning, temperatureCritical
+  GROUP_ERRORS = 1 << 3,      // systemErrorCount
+  GROUP_ALL = 0x0F,
+};
+
+// Reference evaluator: every rule, most severe first
+LimpState evaluateAll(const RuleInputs &in);
+
+// Incremental evaluator: per-group results, most severe wins
+class RuleSet {
+public:
+  RuleSet();
+
+  // Re-evaluate the groups in `changed` from `in`
+  // @return required state over all groups
+  LimpState update(const RuleInputs &in, uint8_t changed);
+
+  LimpState required() const { return required_; }
+
+  // Group evaluations performed (for tests / profiling)
+  uint32_t evaluations() const { return evaluations_; }
+
+private:
+  static constexpr uint8_t GROUP_COUNT = 4;
+  LimpState group_[GROUP_COUNT];
+  LimpState required_;
+  uint32_t evaluations_;
+};
+
+} // namespace LimpMode
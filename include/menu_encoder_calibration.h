@@ -1,7 +1,6 @@
 #ifndef MENU_ENCODER_CALIBRATION_H
 #define MENU_ENCODER_CALIBRATION_H
 
-#include "config_storage.h"
 #include "steering.h"
 #include <Arduino.h>
 #include <TFT_eSPI.h>
@@ -17,7 +16,7 @@
  * - Live encoder value display
  * - 3-step calibration process (Center → Left Max → Right Max)
  * - Visual feedback with current/target positions
- * - Save to EEPROM with ConfigStorage
+ * - Save to NVS with ConfigStore
  * - Reset to defaults option
  *
  * Calibration Process:
@@ -1,7 +1,8 @@
 #pragma once
+#include "touch_input.h"
 #include <TFT_eSPI.h>
 // 🔒 v2.8.8: Eliminada dependencia de XPT2046_Touchscreen
-// Ahora usamos el touch integrado de TFT_eSPI
+// Los toques llegan como gestos de TouchInput vía HUDManager
 
 namespace MenuHidden {
 
@@ -21,6 +22,11 @@ void init(TFT_eSPI *display);
 //   * Ejecución de opciones (calibraciones, ajustes, ver/borrar errores, etc.)
 void update(bool batteryIconPressed);
 
+// --- Toques ---
+// HUDManager entrega aquí los eventos de TouchInput mientras el menú está
+// activo; se guarda el último TAP y update() lo procesa en el siguiente frame.
+void handleTouch(const TouchInput::Event &event);
+
 // --- Estado del menú ---
 // Devuelve true si el menú oculto está activo.
 bool isActive();
@@ -48,6 +54,9 @@ void startTouchCalibrationDirectly();
 //   2. Pisar pedal al máximo → captura valor MAX
 //   3. Guarda en Storage con checksum
 // * La calibración de encoder centra el volante y guarda el offset.
+// * "Perfil CPU/memoria" muestra en vivo carga por núcleo, tareas (CPU y pila
+//   libre), heap/PSRAM y alarmas de RuntimeProfiler; permite activar el
+//   stream [PROF] por puerto serie y el muestreo de PC (PcSampler, 1/2/5 kHz).
 // * Se apoya en Storage (guardar/restaurar), Audio (confirmaciones sonoras) y
 // System (errores).
 } // namespace MenuHidden
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include <Arduino.h>
 
 // LED Control Menu for Hidden Menu
+// Retained widgets (hud_widgets.h): a touch redraws only the pattern buttons,
+// slider or color bar it changed; the preview strip animates on its own.
 class MenuLEDControl {
 public:
   static void init();
@@ -16,31 +18,12 @@ public:
 
 private:
   static bool visible;
-  static bool needsRedraw;
   static uint8_t selectedPattern;
-  static bool draggingBrightness;
-  static bool draggingSpeed;
-  static bool pickingColor;
   static uint8_t colorPickerH;
   static uint8_t colorPickerS;
 
-  // UI element bounds
-  struct Button {
-    int16_t x, y, w, h;
-    const char *label;
-  };
-
-  static void drawPatternSelector();
-  static void drawBrightnessSlider();
-  static void drawSpeedSlider();
-  static void drawColorPicker();
-  static void drawPreview();
-  static void drawControls();
-
-  static void handlePatternSelect(int16_t x, int16_t y);
-  static void handleBrightnessSlider(int16_t x, int16_t y);
-  static void handleSpeedSlider(int16_t x, int16_t y);
-  static void handleColorPicker(int16_t x, int16_t y);
+  static void buildScreen();
+  static void syncWidgets();
 
   static void saveSettings();
   static void loadSettings();
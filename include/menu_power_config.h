@@ -1,7 +1,6 @@
 #ifndef MENU_POWER_CONFIG_H
 #define MENU_POWER_CONFIG_H
 
-#include "config_storage.h"
 #include <Arduino.h>
 
 /**
@@ -19,6 +18,9 @@
  * - 4 test buttons (Power Hold, 12V Aux, 24V Traction, All Off)
  * - Current values display
  * - Save/Reset/Back buttons
+ *
+ * Retained widgets: a touch redraws only the slider/button it changed
+ * (plus its value field), not the whole screen.
  */
 
 class MenuPowerConfig {
@@ -30,32 +32,19 @@ public:
 
 private:
   // UI State
-  static bool needsRedraw;
   static uint16_t powerHoldDelay;
   static uint16_t aux12VDelay;
   static uint16_t traction24VDelay;
   static uint8_t activeTest; // 0=none, 1=hold, 2=aux, 3=traction
   static unsigned long testStartTime;
 
-  // UI Elements
-  static constexpr uint16_t SLIDER_X = 40;
-  static constexpr uint16_t SLIDER_WIDTH = 240;
-  static constexpr uint16_t SLIDER_HEIGHT = 20;
-  static constexpr uint16_t LABEL_X = 10;
-
-  static constexpr uint16_t BUTTON_WIDTH = 70;
-  static constexpr uint16_t BUTTON_HEIGHT = 40;
-
-  // Draw functions
-  static void drawSlider(uint16_t x, uint16_t y, const char *label,
-                         uint16_t value, uint16_t min, uint16_t max);
-  static void drawTestButtons();
-  static void drawActionButtons();
-  static void drawCurrentValues();
+  // Widget tree (hud_widgets.h): built once, then only state changes
+  static void buildScreen();
+  static void syncSliders();
+  static void syncTestButtons();
+  static void syncRelayStatus();
 
   // Input handlers
-  static bool handleSliderTouch(uint16_t x, uint16_t y, uint16_t sliderY,
-                                uint16_t &value, uint16_t min, uint16_t max);
   static void handleTestButton(uint8_t testId);
   static void stopAllTests();
 
@@ -63,9 +52,6 @@ private:
   static void saveConfiguration();
   static void resetToDefaults();
   static void testRelay(uint8_t relayId);
-
-  // Helper functions
-  static uint16_t mapTouchToValue(uint16_t touchX, uint16_t min, uint16_t max);
 };
 
 #endif // MENU_POWER_CONFIG_H
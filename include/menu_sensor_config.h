@@ -1,7 +1,6 @@
 #ifndef MENU_SENSOR_CONFIG_H
 #define MENU_SENSOR_CONFIG_H
 
-#include "config_storage.h"
 #include <Arduino.h>
 
 /**
@@ -15,7 +14,8 @@
  * - Visual status indicators (green=enabled, red=disabled)
  * - Emergency mode: continue operation with disabled sensors
  * - Save/Reset/Back buttons with visual feedback
- * - EEPROM persistence via ConfigStorage
+ * - NVS persistence via ConfigStore
+ * - Retained widgets: a toggle redraws its row and the status line only
  *
  * UI Layout:
  * ┌─────────────────────────────────────┐
@@ -44,7 +44,7 @@ public:
   static void handleTouch(int16_t x, int16_t y);
 
 private:
-  // Sensor toggle states (loaded from ConfigStorage)
+  // Sensor toggle states (loaded from ConfigStore)
   static bool sensorFL;
   static bool sensorFR;
   static bool sensorRL;
@@ -52,37 +52,17 @@ private:
   static bool sensorINA226;
 
   // UI state
-  static bool needsRedraw;
   static uint32_t lastSaveTime;
   static uint32_t lastResetTime;
 
-  // Button definitions
-  struct Button {
-    int16_t x, y, w, h;
-    const char *label;
-  };
-
-  static const Button btnSensorFL;
-  static const Button btnSensorFR;
-  static const Button btnSensorRL;
-  static const Button btnSensorRR;
-  static const Button btnINA226;
-  static const Button btnSave;
-  static const Button btnReset;
-  static const Button btnBack;
-
   // Helper functions
   static void loadConfig();
   static void saveConfig();
   static void resetToDefaults();
-  static void drawToggleButton(int16_t x, int16_t y, int16_t w, int16_t h,
-                               const char *label, bool enabled);
-  static void drawToggleWithLabel(const Button &btn, const char *fullLabel,
-                                  bool enabled);
-  static void drawStatusBar();
-  static void drawActionButtons();
+  // Widget tree (hud_widgets.h): built once, then synced from the state
+  static void buildScreen();
+  static void syncWidgets();
   static int getEnabledCount();
-  static bool isTouchInButton(int16_t tx, int16_t ty, const Button &btn);
 };
 
 #endif // MENU_SENSOR_CONFIG_H
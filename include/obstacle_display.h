@@ -1,5 +1,6 @@
 #ifndef OBSTACLE_DISPLAY_H
 #define OBSTACLE_DISPLAY_H
+#include "hud_layer.h"
 #include "obstacle_detection.h"
 #include <Arduino.h>
 
@@ -14,10 +15,10 @@ struct DisplayConfig {
 };
 
 void init();
-void update();
+void update(HudLayer::RenderContext &ctx);
 void setEnabled(bool enable);
-void drawProximityIndicators();
-void drawDistanceBars();
+void drawProximityIndicators(HudLayer::RenderContext &ctx);
+void drawDistanceBars(HudLayer::RenderContext &ctx);
 const DisplayConfig &getConfig();
 void setConfig(const DisplayConfig &config);
 } // namespace ObstacleDisplay
@@ -2,6 +2,7 @@
 #define OBSTACLE_LOGGER_H
 
 #include "obstacle_detection.h"
+#include "static_string.h"
 #include <Arduino.h>
 
 // ============================================================================
@@ -11,6 +12,9 @@
 
 namespace ObstacleLogger {
 
+// Log file path, e.g. "/obstacle_log_003.csv" (fixed capacity, no heap)
+typedef StaticString<32> LogFilename;
+
 // Single log entry
 struct LogEntry {
   uint32_t timestamp;
@@ -46,7 +50,7 @@ struct LoggerStatus {
   uint32_t entriesLogged;
   uint32_t currentFileSize;
   uint8_t filesCreated;
-  String currentFilename;
+  LogFilename currentFilename;
   uint32_t lastLogMs;
 
   LoggerStatus()
@@ -95,7 +99,7 @@ void setConfig(const LoggerConfig &config);
  * @param filename Output filename
  * @return True if export successful
  */
-bool exportCSV(const String &filename);
+bool exportCSV(StringView filename);
 
 /**
  * Clear all log files
@@ -109,7 +113,7 @@ bool clearLogs();
  * @param maxFiles Maximum files to return
  * @return Number of files found
  */
-uint8_t getLogFiles(String *files, uint8_t maxFiles);
+uint8_t getLogFiles(LogFilename *files, uint8_t maxFiles);
 } // namespace ObstacleLogger
 
 #endif // OBSTACLE_LOGGER_H
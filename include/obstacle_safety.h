@@ -62,6 +62,7 @@ void getConfig(SafetyConfig &cfg);
 void getState(SafetyState &st);
 bool isParkingAssistActive();
 bool isCollisionImminent();
+bool isEmergencyBrakeApplied();
 bool isBlindSpotActive();
 float getSpeedReductionFactor();
 
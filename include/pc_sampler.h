@@ -0,0 +1,84 @@
+// pc_sampler.h - Statistical PC sampling profiler (both cores)
+// A hardware timer per core interrupts at 1-5 kHz and records the
+// interrupted PC, its caller and the running task into a per-core ring.
+// The profiler job drains the rings as binary frames on Serial; the host
+// tool tools/pc_sampler_decode.py symbolizes them against firmware.elf
+// (addr2line) into flame-graph collapsed stacks.
+// Off by default: no timers, interrupts or ring memory exist until start().
+#pragma once
+
+#include <Arduino.h>
+
+namespace PcSampler {
+
+// Sampling rate limits
+constexpr uint16_t MIN_RATE_HZ = 1000;
+constexpr uint16_t MAX_RATE_HZ = 5000;
+constexpr uint16_t DEFAULT_RATE_HZ = 1000;
+
+// Ring size per core (12 bytes/entry, allocated only while running)
+constexpr uint16_t RING_ENTRIES = 512;
+
+// Serial TX ring buffer set in setup(). At 115200 baud the link carries
+// ~1250 samples/s; faster rates (or both cores at 1 kHz) are absorbed by the
+// rings in bursts and otherwise dropped and counted per frame.
+constexpr size_t SERIAL_TX_BUFFER_BYTES = 2048;
+
+// Hardware timers used (0/1 left free for the application)
+constexpr uint8_t TIMER_CORE0 = 2;
+constexpr uint8_t TIMER_CORE1 = 3;
+
+// Core mask bits
+constexpr uint8_t CORE_MASK_0 = 1 << 0;
+constexpr uint8_t CORE_MASK_1 = 1 << 1;
+constexpr uint8_t CORE_MASK_BOTH = CORE_MASK_0 | CORE_MASK_1;
+
+// ----------------------------------------------------------------------------
+// Serial frame format (little-endian), interleaved with normal text logs:
+//   SYNC0 SYNC1 type len payload[len] checksum
+//   checksum = (type + len + sum(payload)) & 0xFF
+// FRAME_INFO    : rateHz u16, coreMask u8
+// FRAME_TASK    : taskId u8, name (len - 1 bytes, no terminator)
+// FRAME_SAMPLES : core u8, dropped u16, then n x {pc u32, caller u32,
+//                 taskId u8}
+// ----------------------------------------------------------------------------
+constexpr uint8_t SYNC0 = 0xA5;
+constexpr uint8_t SYNC1 = 0x5A;
+constexpr uint8_t FRAME_INFO = 'I';
+constexpr uint8_t FRAME_TASK = 'T';
+constexpr uint8_t FRAME_SAMPLES = 'S';
+constexpr uint8_t SAMPLE_BYTES = 9;
+constexpr uint8_t MAX_SAMPLES_PER_FRAME = 24;
+
+// Counters since start()
+struct Stats {
+  bool running;
+  uint16_t rateHz;
+  uint8_t coreMask;
+  uint32_t samples[2];    // Recorded by each core's ISR
+  uint32_t dropped[2];    // Ring full (serial link saturated)
+  uint32_t streamed;      // Samples written to Serial
+  uint32_t bytesStreamed;
+};
+
+/**
+ * Arm one sampling timer per core in coreMask.
+ * rateHz is clamped to [MIN_RATE_HZ, MAX_RATE_HZ].
+ * @return false if memory or a timer could not be allocated
+ */
+bool start(uint16_t rateHz = DEFAULT_RATE_HZ,
+           uint8_t coreMask = CORE_MASK_BOTH);
+
+// Disarm timers and release ring memory
+void stop();
+
+bool isRunning();
+uint16_t getRateHz();
+
+// Stream pending samples (profiler job); no-op when stopped. Writes only
+// what fits in the Serial TX buffer so the job never blocks.
+void drain();
+
+void getStats(Stats &out);
+
+} // namespace PcSampler
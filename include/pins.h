@@ -99,6 +99,11 @@
 #define PIN_TFT_RST 17  // GPIO 17 - Reset (moved from GPIO 14)
 #define PIN_TFT_CS 15   // GPIO 15 - Chip Select TFT (moved from GPIO 16)
 #define PIN_TFT_BL 42   // GPIO 42 - Backlight PWM (LEDC)
+// Salida TE (tearing effect) del ST7796S: TearSync ordena los volcados según
+// el barrido del panel si se cablea a un GPIO libre (-1 = barrido estimado)
+#ifndef PIN_TFT_TE
+#define PIN_TFT_TE -1
+#endif
 
 // -----------------------
 // Táctil (XPT2046 SPI) - ✅ OPTIMIZADO v2.3.0
@@ -108,6 +113,10 @@
 // -----------------------
 #define PIN_TOUCH_CS 21 // GPIO 21 - Chip Select Touch
 // PIN_TOUCH_IRQ removed - touchscreen will use polling mode instead
+// TouchInput usa PENIRQ si se cablea a un GPIO libre (-1 = sondeo en reposo)
+#ifndef PIN_TOUCH_IRQ
+#define PIN_TOUCH_IRQ -1
+#endif
 
 // ============================================================================
 // COMUNICACIONES UART
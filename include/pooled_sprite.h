@@ -0,0 +1,30 @@
+// pooled_sprite.h - TFT_eSprite whose buffer comes from the SpritePool arena
+// create() binds an arena buffer in place of the sprite's own allocation;
+// when the arena is not ready or has no room it falls back to createSprite()
+// (PSRAM if present), so callers do not care which one they got.
+// Release the buffer with destroy() (or deleteSprite() on a PooledSprite*):
+// TFT_eSprite::deleteSprite() called through a base pointer would free()
+// arena memory.
+#pragma once
+
+#include "sprite_pool.h"
+#include <TFT_eSPI.h>
+
+class PooledSprite : public TFT_eSprite {
+public:
+  // `tag` names the sprite in the arena dump
+  explicit PooledSprite(TFT_eSPI *tft, uint8_t tag = 0);
+  ~PooledSprite();
+
+  // 16 bpp, single frame; nullptr if neither the arena nor the fallback
+  // allocation has room
+  void *create(int16_t width, int16_t height);
+  void destroy();
+  void deleteSprite() { destroy(); }
+
+  bool isPooled() const { return handle != SpritePool::INVALID; }
+
+private:
+  SpritePool::Handle handle;
+  uint8_t tag;
+};
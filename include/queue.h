@@ -19,29 +19,33 @@ struct Item {
   Priority prio;
 };
 
-// Clase estática de cola de audio
+// Clase estática de cola de audio: fachada thread-safe del Scheduler
+// (audio_scheduler.h) con millis() como reloj
 class AudioQueue {
 public:
   static void init() noexcept;
 
-  // Ahora devuelve bool → true si se encoló, false si la cola estaba llena
+  // true si se encoló, se fusionó con una pista igual o se limitó por
+  // repetición; false si el track es inválido o la cola está llena de
+  // prioridad igual o mayor
   static bool push(uint16_t track, Priority prio) noexcept;
 
-  // Extrae un elemento de la cola, devuelve true si había algo
+  // Extrae la siguiente entrada (mayor prioridad) sin reproducirla
   static bool pop(Item &out) noexcept;
 
   // Devuelve true si la cola está vacía
   static bool empty() noexcept;
 
-  // Actualización periódica (si la necesitas para procesar la cola)
+  // Job de audio: envía al DFPlayer la siguiente pista cuando el reproductor
+  // está libre, o ya mismo si es CRITICAL y lo que suena no lo es
   static void update() noexcept;
 
-private:
-  static constexpr size_t MAX_QUEUE = 8; // capacidad máxima de la cola
-  static Item queue_[MAX_QUEUE];
-  static size_t head_;
-  static size_t tail_;
-  static size_t count_;
+  // Realimentación del DFPlayer (dfplayer.cpp)
+  static void onFinished(uint16_t track) noexcept;
+  static void onPlayerError() noexcept;
+
+  // Latencia push→play y contadores por prioridad
+  static void logStats() noexcept;
 };
 
 } // namespace Audio
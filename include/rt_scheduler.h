@@ -0,0 +1,84 @@
+// rt_scheduler.h - Table-driven rate-monotonic executive (one task per core)
+// Periodic jobs register (period, phase, core, budget, callback). A single
+// dispatcher task per core releases them in phase-offset slots, shortest
+// period first, and keeps per-job timing and CPU utilization statistics.
+#pragma once
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+namespace RTScheduler {
+
+// Limits
+constexpr uint8_t MAX_JOBS = 16;
+constexpr uint8_t NUM_CORES = 2;
+
+// Job callback: runs to completion, must not block for longer than its budget
+typedef void (*JobFn)();
+
+// Static job description (registered before start())
+struct JobConfig {
+  const char *name;  // Short name for logs / hidden menu
+  JobFn fn;          // Callback
+  uint16_t periodMs; // Release period
+  uint16_t phaseMs;  // Offset of first release inside the period
+  uint8_t core;      // 0 = critical, 1 = general
+  uint32_t budgetUs; // Expected worst-case execution time
+};
+
+// Runtime statistics for one job
+struct JobStats {
+  const char *name;
+  uint16_t periodMs;
+  uint16_t phaseMs;
+  uint8_t core;
+  uint32_t budgetUs;
+  uint32_t runs;           // Completed releases
+  uint32_t budgetOverruns; // Runs longer than budgetUs
+  uint32_t deadlineMisses; // Releases skipped because the job ran late
+  uint32_t lastUs;         // Duration of last run
+  uint32_t maxUs;          // Worst run since start / resetStats()
+  float utilizationPct;    // Share of its core over the last window
+};
+
+// Per-core dispatcher configuration
+struct CoreConfig {
+  const char *taskName;
+  uint32_t stackSize;
+  UBaseType_t priority;
+};
+
+/**
+ * Register a periodic job. Must be called before start().
+ * @return Job index, or -1 if the table is full / config invalid
+ */
+int8_t registerJob(const JobConfig &job);
+
+/**
+ * Create one dispatcher task per core that has at least one job
+ * @return true if all dispatchers were created
+ */
+bool start(const CoreConfig cores[NUM_CORES]);
+
+/**
+ * Stall watchdog: if a job on watchedCore runs longer than limitMs, the other
+ * core's dispatcher calls handler once per stall (from its own context).
+ */
+void setStallHandler(uint8_t watchedCore, uint32_t limitMs, JobFn handler);
+
+// Statistics
+uint8_t getJobCount();
+bool getJobStats(uint8_t index, JobStats &out);
+float getCoreUtilization(uint8_t core); // % busy over last window
+void resetStats();
+void logStats(); // One line per job via Logger
+
+// Dispatcher handles (nullptr if not started)
+TaskHandle_t getDispatcherHandle(uint8_t core);
+
+// Suspend/resume a whole core's executive (HUD/telemetry during OTA etc.)
+void suspendCore(uint8_t core);
+void resumeCore(uint8_t core);
+
+} // namespace RTScheduler
@@ -1,6 +1,8 @@
-// rtos_tasks.h - FreeRTOS task management for dual-core ESP32-S3
-// Core 0: Safety-critical tasks (SafetyManager, ControlManager, PowerManager)
-// Core 1: HUD and telemetry tasks
+// rtos_tasks.h - FreeRTOS job table for dual-core ESP32-S3
+// Core 0: Safety-critical jobs (SafetyManager, ControlManager, PowerManager)
+// Core 1: HUD, telemetry and runtime profiler jobs
+// Jobs are dispatched by RTScheduler (one executive task per core) instead of
+// five dedicated tasks; adding a periodic job is one table entry.
 #pragma once
 
 #include <Arduino.h>
@@ -10,43 +12,66 @@
 
 namespace RTOSTasks {
 
-// Task priorities (higher number = higher priority)
-// Core 0 priorities - safety critical
-constexpr UBaseType_t PRIORITY_SAFETY_MANAGER = 5;
-constexpr UBaseType_t PRIORITY_CONTROL_MANAGER = 4;
-constexpr UBaseType_t PRIORITY_POWER_MANAGER = 3;
+// Executive priorities (higher number = higher priority): each runs at the
+// priority of the former top task on its core (SafetyTask, HUDTask)
+constexpr UBaseType_t PRIORITY_CRITICAL_EXEC = 5;
+constexpr UBaseType_t PRIORITY_GENERAL_EXEC = 2;
 
-// Core 1 priorities
-constexpr UBaseType_t PRIORITY_HUD_MANAGER = 2;
-constexpr UBaseType_t PRIORITY_TELEMETRY_MANAGER = 1;
-
-// Stack sizes (in bytes)
-constexpr uint32_t STACK_SIZE_SAFETY = 4096;
-constexpr uint32_t STACK_SIZE_CONTROL = 4096;
-constexpr uint32_t STACK_SIZE_POWER = 3072;
-constexpr uint32_t STACK_SIZE_HUD = 8192; // Larger for display operations
-constexpr uint32_t STACK_SIZE_TELEMETRY = 3072;
+// Executive stack sizes (in bytes). Jobs on a core run one after another, so
+// each executive needs the deepest job's stack, not the sum
+// (was 4096 + 4096 + 3072 on core 0 and 8192 + 3072 on core 1).
+constexpr uint32_t STACK_SIZE_CRITICAL_EXEC = 5120;
+constexpr uint32_t STACK_SIZE_GENERAL_EXEC = 8192; // Display operations
 
 // Core assignments
 constexpr BaseType_t CORE_CRITICAL = 0; // Core 0 for motor control
 constexpr BaseType_t CORE_GENERAL = 1;  // Core 1 for HUD/telemetry
 
-// Task handles
-extern TaskHandle_t safetyTaskHandle;
-extern TaskHandle_t controlTaskHandle;
-extern TaskHandle_t powerTaskHandle;
-extern TaskHandle_t hudTaskHandle;
-extern TaskHandle_t telemetryTaskHandle;
+// Job periods / phases (ms). Power+sensor I2C traffic is offset by half a
+// control slot so it never shares a slot with the 100 Hz control writes.
+constexpr uint16_t PERIOD_SAFETY_MS = 10;    // 100 Hz
+constexpr uint16_t PERIOD_CONTROL_MS = 10;   // 100 Hz
+constexpr uint16_t PERIOD_POWER_MS = 100;    // 10 Hz
+constexpr uint16_t PHASE_POWER_MS = 5;
+constexpr uint16_t PERIOD_HUD_MS = 16;       // FramePacer::TICK_MS
+constexpr uint16_t PERIOD_TELEMETRY_MS = 100; // 10 Hz
+constexpr uint16_t PHASE_TELEMETRY_MS = 8;   // Between HUD ticks
+constexpr uint16_t PERIOD_PROFILER_MS = 100;  // Sampling rate set by config
+constexpr uint16_t PHASE_PROFILER_MS = 50;   // Off the telemetry slot
+constexpr uint16_t PERIOD_JOURNAL_MS = 1000;  // Flash journal maintenance
+constexpr uint16_t PHASE_JOURNAL_MS = 60;    // Off telemetry/profiler/audio,
+                                             // 4 or 12 ms past a HUD tick
+constexpr uint16_t PERIOD_AUDIO_MS = 50;     // DFPlayer feedback + dispatch
+constexpr uint16_t PHASE_AUDIO_MS = 25;      // Off the HUD and telemetry slots
+
+// Execution budgets (us) used for overrun accounting
+constexpr uint32_t BUDGET_SAFETY_US = 1500;
+constexpr uint32_t BUDGET_CONTROL_US = 3000;
+constexpr uint32_t BUDGET_POWER_US = 4000;
+// Per 16 ms HUD tick: FramePacer steps the rate down once the average
+// render passes 3/4 of a 60 FPS slot, so a tick past 12 ms is an overrun
+constexpr uint32_t BUDGET_HUD_US = 12000;
+constexpr uint32_t BUDGET_TELEMETRY_US = 5000;
+constexpr uint32_t BUDGET_PROFILER_US = 2000;
+constexpr uint32_t BUDGET_JOURNAL_US = 60000; // One 4 KB sector erase
+constexpr uint32_t BUDGET_AUDIO_US = 2000;    // 10-byte command into UART FIFO
+
+// Control job stall limit before the general core forces a motor stop
+// (same 200 ms as the SafetyManager heartbeat timeout)
+constexpr uint32_t CRITICAL_STALL_LIMIT_MS = 200;
 
-// Initialization
+// Initialization: registers the job table and starts both executives
 bool init();
 
-// Task functions
-void safetyTask(void *parameter);
-void controlTask(void *parameter);
-void powerTask(void *parameter);
-void hudTask(void *parameter);
-void telemetryTask(void *parameter);
+// Job functions
+void safetyJob();
+void controlJob();
+void powerJob();
+void hudJob();
+void telemetryJob();
+void profilerJob();
+void journalJob();
+void audioJob();
 
 // Suspend/resume for critical operations
 void suspendNonCriticalTasks();
@@ -0,0 +1,96 @@
+// runtime_profiler.h - Per-task CPU, stack and heap telemetry
+// Samples FreeRTOS run-time counters (uxTaskGetSystemState), per-task stack
+// high-water marks and internal/PSRAM heap figures at a configurable rate.
+// Samples go to a compact ring (last HISTORY_LEN snapshots), the hidden menu
+// profiler page and, optionally, a "[PROF]" serial stream. Threshold alarms
+// are logged once on each rising edge.
+#pragma once
+
+#include <Arduino.h>
+
+namespace RuntimeProfiler {
+
+// Limits
+constexpr uint8_t MAX_TASKS = 24;   // Task table size (system has ~15 tasks)
+constexpr uint8_t HISTORY_LEN = 60; // 60 samples = 1 min at default rate
+constexpr uint8_t TASK_NAME_LEN = 16;
+
+// Sampling / alarm configuration
+struct Config {
+  uint16_t sampleIntervalMs = 1000; // 0 = sampling paused
+  bool serialStream = false;        // Print every sample as [PROF] lines
+  uint8_t cpuAlarmPct = 90;         // Per-core load
+  uint16_t stackAlarmBytes = 512;   // Any task stack high-water mark
+  uint32_t heapAlarmBytes = 32768;  // Internal heap free
+  uint32_t largestBlockAlarmBytes = 16384; // Internal largest free block
+  uint32_t psramAlarmBytes = 262144;       // PSRAM free
+};
+
+// Alarm bits (Snapshot::alarms)
+enum AlarmFlags : uint8_t {
+  ALARM_NONE = 0,
+  ALARM_CPU = 1 << 0,
+  ALARM_STACK = 1 << 1,
+  ALARM_HEAP = 1 << 2,
+  ALARM_FRAGMENTATION = 1 << 3,
+  ALARM_PSRAM = 1 << 4,
+};
+
+// One history entry (24 bytes)
+struct Snapshot {
+  uint32_t timestampMs;
+  uint8_t cpuPct[2];       // Per-core load (100 - idle task share)
+  uint16_t heapFreeKb;     // Internal RAM
+  uint16_t heapMinKb;      // Internal RAM low-water mark since boot
+  uint16_t heapLargestKb;  // Internal RAM largest allocatable block
+  uint16_t psramFreeKb;
+  uint16_t psramMinKb;
+  uint16_t psramLargestKb;
+  uint16_t minStackBytes;  // Lowest task high-water mark in this sample
+  uint8_t taskCount;
+  uint8_t alarms;          // AlarmFlags
+};
+
+// Latest per-task figures (table is sorted by CPU share, highest first)
+struct TaskSample {
+  char name[TASK_NAME_LEN];
+  uint8_t core;          // 0, 1 or NO_CORE when not pinned
+  uint8_t priority;
+  uint16_t cpuPermille;  // Share of one core over the last interval
+  uint32_t stackFreeBytes; // High-water mark (bytes never used)
+};
+constexpr uint8_t NO_CORE = 0xFF;
+
+// Initialization (safe to call again to apply a new config)
+void init();
+void setConfig(const Config &cfg);
+const Config &getConfig();
+
+// Periodic entry point (profiler job); samples when the interval elapsed
+void update();
+
+// Take a sample now, regardless of the interval
+void sample();
+
+// True if per-task run-time counters are available in this build
+bool hasRunTimeStats();
+
+// History: age 0 = newest
+uint8_t getHistoryCount();
+bool getSnapshot(uint8_t age, Snapshot &out);
+
+// Per-task table from the latest sample
+uint8_t getTaskCount();
+bool getTask(uint8_t index, TaskSample &out);
+
+// Alarm bits currently active
+uint8_t getActiveAlarms();
+
+// Serial stream control (hidden menu toggle)
+void setSerialStream(bool enabled);
+bool isSerialStream();
+
+// One-shot report of the latest sample via Logger
+void logReport();
+
+} // namespace RuntimeProfiler
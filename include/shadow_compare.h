@@ -0,0 +1,50 @@
+// shadow_compare.h - Shadow-mode validation of the BASE layer by block hash
+// Shadow mode renders the BASE layer twice (layer sprite and shadow sprite)
+// and compares the two. The comparison used to call readPixel() 256 times
+// per 16x16 block on each sprite, for every block tested against every
+// dirty rect, folding pixels into a 16-bit XOR that cannot see two pixels
+// trading places. Here the dirty rects are first turned into a block
+// bitmap (each covered block once), then every marked block is hashed row
+// by row straight from the RGB565 buffers, two pixels per 32-bit word.
+// The hash runs four independent multiply-xor lanes (words i % 4) that the
+// LX7 pipelines and the host compiler vectorizes. Every step is a bijection
+// of the lane state, so a block differing in any single word always hashes
+// differently; reordered pixels do too.
+// Pure C++ so the native tests can check it and time it per frame.
+#pragma once
+
+#include <cstdint>
+
+namespace ShadowCompare {
+
+constexpr int BLOCK_SIZE = 16;   // Pixels per block side
+constexpr int MAX_BLOCKS_X = 32; // One bit per block column (480 / 16 = 30)
+constexpr int MAX_BLOCKS_Y = 32; // Block rows (320 / 16 = 20)
+
+// Dirty rectangle in pixels (same fields as HudLayer::DirtyRect)
+struct Rect {
+  int16_t x, y, w, h;
+};
+
+struct Result {
+  uint16_t blocksCompared;
+  uint16_t mismatches;
+  int16_t firstX; // First differing block (block units), -1 if none
+  int16_t firstY;
+};
+
+// Hash of one block of a width x height RGB565 buffer (edge blocks clipped)
+uint32_t hashBlock(const uint16_t *buf, int width, int height, int bx,
+                   int by);
+
+// Marks the blocks touched by the dirty rects (clipped to the buffer)
+// @param rows One bit mask of block columns per block row, MAX_BLOCKS_Y
+// @return number of blocks marked
+uint16_t markBlocks(const Rect *dirty, int dirtyCount, int width, int height,
+                    uint32_t *rows);
+
+// Compares the blocks covered by the dirty set between two buffers
+Result compare(const uint16_t *a, const uint16_t *b, int width, int height,
+               const Rect *dirty, int dirtyCount);
+
+} // namespace ShadowCompare
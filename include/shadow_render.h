@@ -5,7 +5,8 @@
  * @brief Shadow Rendering Helpers (Phase 3: Mirror Validation)
  *
  * This header provides helper macros and functions for mirroring TFT drawing
- * operations to the STEERING_SHADOW sprite for validation purposes.
+ * operations to the compositor's shadow sprite for validation purposes
+ * (no-ops while shadow mode is off).
  *
  * CRITICAL: All code in this file is ONLY active when RENDER_SHADOW_MODE is
  * defined. Production builds (without the flag) have ZERO overhead.
@@ -25,12 +26,12 @@
 
 #ifdef RENDER_SHADOW_MODE
 
-#include "render_engine.h"
+#include "hud_compositor.h"
 #include <TFT_eSPI.h>
 
 // Get the shadow sprite for drawing
 inline TFT_eSprite *getShadowSprite() {
-  return RenderEngine::getSprite(RenderEngine::STEERING_SHADOW);
+  return HudCompositor::getShadowSprite();
 }
 
 // ============================================================================
@@ -0,0 +1,136 @@
+// spi_bus.h - Arbitration of the shared display SPI bus
+// The ST7796S display and the XPT2046 touch controller (TOUCH_CS=21,
+// SPI_TOUCH_FREQUENCY=2.5 MHz) share one SPI host. Until now a plain mutex
+// was held by HUDManager::update() for the whole frame, sprite composition
+// included, so a touch sample waited up to a frame (BUS_WAIT_MS timeouts).
+// Every primitive the frame pushed also reopened its own TFT_eSPI
+// transaction, reprogramming the clock and toggling CS each time.
+// The bus is now granted per device:
+// - Requests queue by device priority (FIFO within a priority). Touch
+//   conversions are short and latency bound, so they rank above display
+//   pushes.
+// - Each grant runs the device's select/deselect hooks once. For the display,
+//   that opens a single TFT_eSPI transaction (clock and CS set once for every
+//   push of the grant). Touch switches to its own clock in the driver.
+// - The display holder calls yieldIfContended() at safe points: between
+//   compositor layers and between dirty-rect pushes. It hands the bus over
+//   only if someone is waiting. A touch sample waits at most one layer or
+//   rect, and a frame waits at most one touch sample.
+// - Per device: transactions, busy time, utilization over the last window,
+//   waits, timeouts and yields. Bus reconfigurations (grants that change
+//   device) are counted.
+// The Arbiter is pure C++ (times passed in, native tests). The FreeRTOS
+// service is in spi_bus_esp32.cpp.
+#pragma once
+
+#include <cstdint>
+
+namespace SpiBus {
+
+enum class Device : uint8_t {
+  DISPLAY = 0, // ST7796S (TFT_eSPI writes, sprite pushes)
+  TOUCH,       // XPT2046 conversions
+  COUNT
+};
+
+constexpr uint8_t MAX_DEVICES = 4; // Registry slots (room for SD, ...)
+constexpr uint8_t NONE = 0xFF;
+constexpr uint32_t WINDOW_US = 1000000; // Utilization window
+
+constexpr uint8_t PRIORITY_DISPLAY = 1;
+constexpr uint8_t PRIORITY_TOUCH = 2;
+
+struct DeviceConfig {
+  const char *name;
+  uint8_t priority;  // Higher is granted first
+  uint32_t clockHz;  // For the stats log; the select hook applies it
+  int8_t csPin;      // -1 if CS is driven by the driver
+  void (*select)();  // Called by the granted task before its transfers
+  void (*deselect)(); // Called by the same task before releasing
+};
+
+struct DeviceStats {
+  uint32_t transactions;     // Grants
+  uint32_t busyUs;           // Total time holding the bus
+  uint32_t maxHoldUs;        // Longest single grant
+  uint32_t waits;            // Grants that had to queue
+  uint32_t maxWaitUs;        // Longest queue wait
+  uint32_t timeouts;         // Requests withdrawn unserved
+  uint32_t yields;           // Grants handed over at a yield point
+  uint16_t utilizationPermille; // Busy share of the last full window
+};
+
+class Arbiter {
+public:
+  Arbiter();
+
+  void configure(uint8_t dev, const DeviceConfig &cfg);
+
+  // Asks for the bus; true if granted now, otherwise queued until
+  // release() hands it over (one pending request per device)
+  bool request(uint8_t dev, uint32_t nowUs);
+
+  // Withdraws a queued request (timeout); false if it was granted meanwhile
+  bool cancel(uint8_t dev, uint32_t nowUs);
+
+  // Releases the bus; returns the device granted next, or NONE
+  uint8_t release(uint8_t dev, uint32_t nowUs);
+
+  // A request is queued behind the owner (the owner should yield)
+  bool contended() const { return waitingMask != 0; }
+
+  // Marks the owner's next release as a yield (stats)
+  void noteYield(uint8_t dev);
+
+  uint8_t owner() const { return ownerDev; }
+  bool isWaiting(uint8_t dev) const { return (waitingMask >> dev) & 1u; }
+
+  // Grants to a device other than the previous one (clock/CS switches)
+  uint32_t reconfigurations() const { return reconfigs; }
+
+  const DeviceConfig &config(uint8_t dev) const { return cfg[dev]; }
+  const DeviceStats &stats(uint8_t dev) const { return st[dev]; }
+
+private:
+  void grant(uint8_t dev, uint32_t nowUs);
+  void rollWindow(uint32_t nowUs);
+
+  DeviceConfig cfg[MAX_DEVICES];
+  DeviceStats st[MAX_DEVICES];
+  uint32_t requestUs[MAX_DEVICES];
+  uint32_t requestSeq[MAX_DEVICES];
+  uint32_t windowBusyUs[MAX_DEVICES];
+  uint32_t seq;
+  uint32_t grantUs;
+  uint32_t windowStartUs;
+  uint32_t reconfigs;
+  uint8_t waitingMask;
+  uint8_t ownerDev;
+  uint8_t lastDev;
+  bool yieldPending;
+};
+
+// --- Service (FreeRTOS, display SPI host) ---
+
+// Registers the display and touch devices; call before the touch task
+bool init();
+
+// Blocks until the bus is granted (priority order); portMAX_DELAY waits
+// forever. Runs the device's select hook.
+bool acquire(Device dev, uint32_t timeoutMs);
+
+// Runs the deselect hook and hands the bus to the next waiter
+void release(Device dev);
+
+// Holder only, at a point with no transfer in progress: if another device
+// is waiting, release and reacquire after it. Returns true if it yielded.
+bool yieldIfContended(Device dev);
+
+bool isHeldBy(Device dev);
+
+void getStats(Device dev, DeviceStats &out);
+uint32_t getReconfigurations();
+
+void logStats();
+
+} // namespace SpiBus
@@ -0,0 +1,115 @@
+// sprite_pool.h - Slab arena for sprite buffers
+// Every full-screen sprite (480x320x16 bpp = 300 KB) used to be a separate
+// PSRAM allocation: five compositor layers, the shadow sprite and the
+// RenderEngine sprites. Toggling shadow mode or rebuilding a layer freed and
+// reallocated 300 KB blocks between the smaller allocations of the rest of
+// the firmware, fragmenting PSRAM until one of them failed.
+// The arena is reserved once at boot and cut into fixed-size slabs:
+// - A buffer is a run of contiguous slabs, placed best fit. Large buffers
+//   (full-screen sprites) live in the bottom region, small ones (panels,
+//   popups) in a top region with its own budget. Small buffers never split
+//   the runs a sprite needs: sprites cannot fail while they fit the bottom
+//   region, whatever the small ones do.
+// - Buffers are referred to by handle (slot + generation): a stale handle
+//   (released, or released twice) resolves to nothing instead of to memory
+//   someone else now owns.
+// - Stats report free bytes, the largest free run and the fragmentation
+//   (share of free bytes outside the largest run), plus peaks and failures.
+// Contents of an acquired buffer are undefined (sprites are filled anyway).
+// Pure C++ over a caller-provided block (native tests); the PSRAM
+// reservation and the TFT_eSprite binding are in sprite_pool_esp32.cpp.
+#pragma once
+
+#include <cstdint>
+
+namespace SpritePool {
+
+constexpr uint32_t SLAB_BYTES = 4096;
+constexpr uint16_t MAX_SLABS = 1024; // 4 MB arena at most
+constexpr uint8_t MAX_BUFFERS = 16;  // Live handles
+constexpr uint32_t LARGE_BYTES = 128 * 1024; // Bottom region from here
+
+// One full-screen 16 bpp sprite: exactly 75 slabs
+constexpr uint32_t SCREEN_SPRITE_BYTES = 480 * 320 * 2;
+
+typedef uint16_t Handle; // Generation (high byte), slot + 1 (low byte)
+constexpr Handle INVALID = 0;
+
+struct Stats {
+  uint32_t totalBytes;
+  uint32_t usedBytes;
+  uint32_t peakUsedBytes;
+  uint32_t largestFreeBytes; // Biggest buffer that can be acquired now
+  uint8_t fragmentationPct;  // Free bytes outside the largest free run
+  uint8_t liveBuffers;
+  uint32_t acquires;
+  uint32_t releases;
+  uint32_t failures;      // Acquires refused (no run in their region)
+  uint32_t staleReleases; // Releases of unknown or already released handles
+};
+
+class Arena {
+public:
+  Arena();
+
+  // Takes over `bytes` at `base` (rounded down to whole slabs); the top
+  // `smallBytes` are kept for buffers under LARGE_BYTES
+  bool init(uint8_t *base, uint32_t bytes, uint32_t smallBytes = 0);
+  bool isReady() const { return base != nullptr; }
+
+  // Buffer of at least `bytes`; INVALID if no free run holds it.
+  // `tag` names the owner in dumps (sprite id, layer).
+  Handle acquire(uint32_t bytes, uint8_t tag);
+
+  // Returns the slabs; false for a stale handle
+  bool release(Handle h);
+
+  bool valid(Handle h) const;
+  void *pointer(Handle h) const; // nullptr for a stale handle
+  uint32_t size(Handle h) const; // Bytes reserved (whole slabs)
+
+  uint32_t largestFreeBytes() const;
+  Stats stats() const;
+
+  // Slab map for dumps: '.' free, otherwise 'A' + tag
+  void describe(char *out, uint16_t len) const;
+
+private:
+  struct Slot {
+    uint16_t first;
+    uint16_t count;
+    uint8_t generation;
+    uint8_t tag;
+    bool used;
+  };
+
+  bool slabUsed(uint16_t s) const { return (map[s >> 5] >> (s & 31)) & 1u; }
+  void markSlabs(uint16_t first, uint16_t count, bool used);
+  int8_t slotOf(Handle h) const; // -1 for a stale handle
+
+  uint8_t *base;
+  uint16_t slabs;
+  uint16_t largeSlabs; // Bottom region; small buffers above it
+  uint16_t usedSlabs;
+  uint16_t peakSlabs;
+  uint32_t map[MAX_SLABS / 32];
+  Slot slots[MAX_BUFFERS];
+  uint32_t acquires;
+  uint32_t releases;
+  uint32_t failures;
+  uint32_t staleReleases;
+};
+
+// --- Service (PSRAM arena for the compositor sprites) ---
+
+// Reserves `screenSprites` full-screen buffers plus `smallBytes` for small
+// ones in PSRAM. Without PSRAM (or if the reservation fails) sprites fall
+// back to their own allocations.
+bool init(uint8_t screenSprites, uint32_t smallBytes);
+bool isReady();
+
+Arena &arena(); // HUD task only
+
+void logStats();
+
+} // namespace SpritePool
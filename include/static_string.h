@@ -0,0 +1,158 @@
+// static_string.h - Fixed-capacity strings without heap allocation
+// StaticString<N> replaces Arduino String in HUD, telemetry and logging code:
+// storage lives inline (stack, static or inside the owning struct), appends
+// truncate instead of reallocating, and the truncated() flag reports it.
+// StringView is a non-owning (pointer, length) pair for read-only arguments.
+// Pure C++ so it also builds in the native (host) test environment.
+#pragma once
+
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+// Non-owning view of a character range (not necessarily NUL-terminated)
+struct StringView {
+  const char *data;
+  size_t length;
+
+  StringView() : data(""), length(0) {}
+  StringView(const char *s) : data(s ? s : ""), length(s ? strlen(s) : 0) {}
+  StringView(const char *s, size_t len) : data(s ? s : ""), length(len) {}
+
+  bool empty() const { return length == 0; }
+  bool equals(StringView other) const {
+    return length == other.length && memcmp(data, other.data, length) == 0;
+  }
+  bool startsWith(StringView prefix) const {
+    return length >= prefix.length &&
+           memcmp(data, prefix.data, prefix.length) == 0;
+  }
+  bool endsWith(StringView suffix) const {
+    return length >= suffix.length &&
+           memcmp(data + length - suffix.length, suffix.data, suffix.length) ==
+               0;
+  }
+};
+
+// N = total buffer size including the terminating NUL
+template <size_t N> class StaticString {
+  static_assert(N > 1, "StaticString needs room for one char plus NUL");
+
+public:
+  StaticString() { clear(); }
+  StaticString(const char *s) {
+    clear();
+    append(s);
+  }
+  StaticString(StringView s) {
+    clear();
+    append(s);
+  }
+
+  // printf-style construction: StaticString<32>::format("log_%03u.csv", n)
+  static StaticString format(const char *fmt, ...)
+      __attribute__((format(printf, 1, 2))) {
+    StaticString out;
+    va_list ap;
+    va_start(ap, fmt);
+    out.vappendf(fmt, ap);
+    va_end(ap);
+    return out;
+  }
+
+  void clear() {
+    buf_[0] = '\0';
+    len_ = 0;
+    truncated_ = false;
+  }
+
+  StaticString &append(StringView s) {
+    size_t room = N - 1 - len_;
+    size_t n = s.length;
+    if (n > room) {
+      n = room;
+      truncated_ = true;
+    }
+    memcpy(buf_ + len_, s.data, n);
+    len_ += n;
+    buf_[len_] = '\0';
+    return *this;
+  }
+
+  StaticString &append(const char *s) { return append(StringView(s)); }
+
+  StaticString &append(char c) {
+    if (len_ + 1 < N) {
+      buf_[len_++] = c;
+      buf_[len_] = '\0';
+    } else {
+      truncated_ = true;
+    }
+    return *this;
+  }
+
+  StaticString &appendf(const char *fmt, ...)
+      __attribute__((format(printf, 2, 3))) {
+    va_list ap;
+    va_start(ap, fmt);
+    vappendf(fmt, ap);
+    va_end(ap);
+    return *this;
+  }
+
+  StaticString &vappendf(const char *fmt, va_list ap) {
+    size_t room = N - len_;
+    int written = vsnprintf(buf_ + len_, room, fmt, ap);
+    if (written < 0) {
+      buf_[len_] = '\0';
+      return *this;
+    }
+    if ((size_t)written >= room) {
+      len_ = N - 1;
+      truncated_ = true;
+    } else {
+      len_ += (size_t)written;
+    }
+    return *this;
+  }
+
+  // Number helpers (same text as Arduino String(value, decimals))
+  StaticString &appendInt(long value) { return appendf("%ld", value); }
+  StaticString &appendUInt(unsigned long value) {
+    return appendf("%lu", value);
+  }
+  StaticString &appendFixed(double value, uint8_t decimals) {
+    return appendf("%.*f", (int)decimals, value);
+  }
+
+  StaticString &operator+=(StringView s) { return append(s); }
+  StaticString &operator+=(const char *s) { return append(s); }
+  StaticString &operator+=(char c) { return append(c); }
+  StaticString &operator=(StringView s) {
+    clear();
+    return append(s);
+  }
+  StaticString &operator=(const char *s) {
+    clear();
+    return append(s);
+  }
+
+  bool operator==(StringView other) const { return view().equals(other); }
+  bool operator!=(StringView other) const { return !view().equals(other); }
+
+  const char *c_str() const { return buf_; }
+  StringView view() const { return StringView(buf_, len_); }
+  operator StringView() const { return view(); }
+
+  size_t length() const { return len_; }
+  static constexpr size_t capacity() { return N - 1; }
+  bool empty() const { return len_ == 0; }
+  bool truncated() const { return truncated_; }
+
+private:
+  char buf_[N];
+  size_t len_;
+  bool truncated_;
+};
@@ -1,4 +1,5 @@
 #pragma once
+#include "config_store.h"
 #include <Arduino.h>
 
 namespace Storage {
@@ -7,19 +8,10 @@ namespace Storage {
 const uint16_t kConfigVersion =
     8; // ⚠️ v8: added maxBatteryCurrentA and maxMotorCurrentA fields (v2.10.2)
 
-struct ErrorLog {
-  uint16_t code;      // código de error
-  uint32_t timestamp; // marca de tiempo (millis o RTC)
-};
-
+// Registro de error y odómetro: mismos tipos que las secciones de ConfigStore
+typedef ConfigStore::ErrorEntry ErrorLog;
 // 🔒 v2.4.2: Estructura para odómetro y mantenimiento
-struct OdometerData {
-  float totalKm;            // Odómetro total (km)
-  float tripKm;             // Odómetro parcial (km)
-  float lastServiceKm;      // Km del último mantenimiento
-  uint32_t lastServiceDate; // Fecha último mantenimiento (timestamp)
-  uint32_t engineHours;     // Horas de motor acumuladas (segundos)
-};
+typedef ConfigStore::Odometer OdometerData;
 
 struct Config {
   // Calibración pedal
@@ -73,7 +65,7 @@ struct Config {
       maintenanceIntervalDays; // Intervalo mantenimiento (días) - default 180
 
   // Log persistente de errores
-  static constexpr int MAX_ERRORS = 16;
+  static constexpr int MAX_ERRORS = ConfigStore::MAX_ERRORS;
   ErrorLog errors[MAX_ERRORS];
   int errorCount;
 
@@ -82,6 +74,7 @@ struct Config {
   uint32_t checksum;
 };
 
+// Monta ConfigStore (migrando formatos antiguos) y carga cfg
 void init();
 void load(Config &cfg);
 bool save(const Config &cfg);
@@ -91,7 +84,7 @@ void defaults(Config &cfg);
 // Helpers
 uint32_t computeChecksum(const Config &cfg);
 
-// 🔒 v2.4.2: Función para verificar corrupción de EEPROM
+// 🔒 v2.4.2: true si ConfigStore no está montado
 bool isCorrupted();
 
 // 🔒 v2.4.2: Funciones de odómetro y mantenimiento
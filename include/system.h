@@ -29,8 +29,14 @@ void update();     // Avanza máquina de estados
 State getState();  // Devuelve estado actual
 
 // --- API de diagnóstico persistente ---
-// Registra un error persistente (FIFO, evita duplicados)
-void logError(uint16_t code);
+// Registra un error (lock-free, sin flash: apto para el bucle de control).
+// context: dato del fallo (canal, lectura, ErrorJournal::contextOf(float)).
+// Los códigos nuevos pasan al log persistente en flushErrors().
+void logError(uint16_t code, uint32_t context = 0);
+
+// Vuelca los códigos nuevos del ErrorJournal al log persistente (FIFO, sin
+// duplicados) con un único Storage::save(). Solo desde el job Journal.
+void flushErrors();
 
 // Devuelve puntero al buffer de errores
 const Storage::ErrorLog *getErrors();
@@ -38,6 +44,10 @@ const Storage::ErrorLog *getErrors();
 // Número de errores almacenados
 int getErrorCount();
 
+// Códigos distintos incluyendo los del journal aún sin volcar (LimpMode:
+// reacciona en el mismo tick, no al flush). No indexa getErrors().
+int getDistinctErrorCount();
+
 // Limpia todos los errores persistentes
 void clearErrors();
 
@@ -0,0 +1,179 @@
+// tear_sync.h - Tearing-effect aware ordering of display pushes
+// The ST7796S refreshes its glass line by line (~60 Hz) whatever the SPI host
+// is doing. A dirty rect written while the panel scan crosses it shows half
+// old, half new content for one refresh: the torn gauge needle. In rotation 3
+// the gate scan runs along screen X, so every row a pushSprite() writes spans
+// the whole scan band of the rect; any overlap between the write and the scan
+// is a tear.
+// - ScanModel estimates the scan line. With the TE output wired (PIN_TFT_TE)
+//   each rising edge (start of vertical blanking) re-phases it and measures
+//   the real refresh period. Without it the model free-runs on the nominal
+//   period from an anchor. MISO is not wired, so the RDSCANLINE readback
+//   cannot correct the drift: the phase is an estimate and so are the risks.
+// - PushOrder picks the next dirty rect at the current time: among the rects
+//   that finish before the scan reaches them, the one it reaches soonest
+//   (chasing the scan). If none fits, it waits (bounded) for the scan to
+//   leave the nearest band, or pushes the rect with the most headroom.
+// - Each push is checked against the scan afterwards: tear-risk rects per
+//   frame, with the wait spent and whether the order changed.
+// Pure C++ (times passed in, native tests); TE pin and panel setup in
+// tear_sync_esp32.cpp.
+#pragma once
+
+#include <cstdint>
+
+class TFT_eSPI;
+
+namespace TearSync {
+
+enum class Source : uint8_t {
+  NONE,      // No anchor yet: no ordering, no risk reports
+  ESTIMATED, // Nominal period from an anchor (no TE wire)
+  TE_PIN     // Phase and period from the TE output
+};
+
+enum class Mode : uint8_t {
+  OFF,    // Natural order, no checks
+  REPORT, // Natural order, tear risk reported against the model
+  CHASE   // Reordered to chase the scan, bounded waits, risk reported
+};
+
+struct Geometry {
+  uint16_t activeLines; // Gate lines driven per refresh
+  uint16_t blankLines;  // Porch lines (TE high)
+  uint32_t periodUs;    // Nominal refresh period
+  bool scanAlongX;      // Scan advances along screen X (landscape)
+  bool scanReversed;    // Line 0 at the far end of the screen axis
+};
+
+// 320x480 panel in rotation 3 (MV|MX|MY): gate line 0 is the right edge of
+// the 480 px landscape screen. Default FRMCTR1 refresh (~60 Hz).
+constexpr Geometry ST7796_ROTATION3 = {480, 8, 16667, true, true};
+
+struct Rect {
+  int16_t x, y, w, h;
+};
+
+class ScanModel {
+public:
+  explicit ScanModel(const Geometry &g = ST7796_ROTATION3);
+
+  // TE rising edge: the scan is at the first blank line
+  void onTe(uint32_t nowUs);
+
+  // Estimated phase: the scan is assumed at `line` at nowUs
+  void anchor(uint32_t nowUs, uint16_t line);
+
+  Source source() const { return src; }
+  bool valid() const { return src != Source::NONE; }
+
+  // A TE edge seen within the last two periods
+  bool locked(uint32_t nowUs) const;
+
+  uint32_t periodUs() const { return period; }
+  uint16_t totalLines() const { return total; }
+
+  // Line being scanned (blank lines follow the active ones)
+  uint16_t lineAt(uint32_t nowUs) const;
+
+  // Time until the scan reaches `line`; 0 if it is on it
+  uint32_t usUntil(uint32_t nowUs, uint16_t line) const;
+
+  // Panel lines covered by a screen rect
+  void band(const Rect &r, uint16_t &first, uint16_t &last) const;
+
+  // The scan is on lines [first, last] at some point in [startUs, endUs]
+  bool crosses(uint16_t first, uint16_t last, uint32_t startUs,
+               uint32_t endUs) const;
+
+private:
+  // Scan position in line*period units, [0, total*period)
+  uint64_t phaseAt(uint32_t nowUs) const;
+
+  Geometry geo;
+  uint32_t period;
+  uint32_t refUs;   // Time of the reference position
+  uint16_t refLine; // Line at refUs
+  uint16_t total;
+  uint32_t lastTeUs;
+  Source src;
+};
+
+struct FrameReport {
+  uint8_t rects;     // Rects pushed
+  uint8_t riskRects; // Pushes the scan crossed (torn for one refresh)
+  bool reordered;    // Order differs from the dirty-rect order
+  uint32_t waitUs;   // Spent waiting for the scan to pass
+};
+
+struct Stats {
+  uint32_t frames;     // Frames checked against the model
+  uint32_t riskFrames; // Frames with at least one risk rect
+  uint32_t riskRects;
+  uint32_t reorderedFrames;
+  uint32_t waitUs; // Total wait
+  uint32_t maxFrameWaitUs;
+  uint32_t nsPerPixel; // Learned push cost per pixel and layer
+};
+
+class PushOrder {
+public:
+  static constexpr uint8_t MAX_RECTS = 16;              // Dirty rects
+  static constexpr uint32_t MAX_WAIT_US = 2000;         // Per rect
+  static constexpr uint32_t GUARD_US = 100;             // Model error margin
+  static constexpr uint32_t PUSH_OVERHEAD_US = 30;      // Window setup
+  static constexpr uint32_t DEFAULT_NS_PER_PIXEL = 400; // 16 bpp, 40 MHz
+
+  PushOrder();
+
+  // Starts a frame: `layers` sprites are pushed per rect
+  void begin(const ScanModel &model, Mode mode, const Rect *rects,
+             uint8_t count, uint8_t layers);
+
+  // Next rect to push and the wait before it; -1 when all are pushed
+  int8_t next(uint32_t nowUs, uint32_t &waitUs);
+
+  // Push of rect `idx` ran over [startUs, endUs]; true if the scan crossed it
+  bool pushed(uint8_t idx, uint32_t startUs, uint32_t endUs);
+
+  // Closes the frame into the stats
+  const FrameReport &end();
+
+  // Estimated push time of rect `idx` (all layers)
+  uint32_t costUs(uint8_t idx) const;
+
+  const FrameReport &lastFrame() const { return report; }
+  const Stats &stats() const { return st; }
+
+private:
+  ScanModel scan;
+  Mode mode;
+  Rect rects[MAX_RECTS];
+  uint16_t first[MAX_RECTS];
+  uint16_t last[MAX_RECTS];
+  uint8_t count;
+  uint8_t layers;
+  uint16_t pendingMask;
+  FrameReport report;
+  Stats st;
+};
+
+// --- Service (TE interrupt, panel setup) ---
+
+// Enables the panel TE output and its interrupt when PIN_TFT_TE is wired,
+// otherwise anchors an estimated phase. Default mode: CHASE with TE,
+// REPORT without.
+void init(TFT_eSPI *tftDisplay);
+
+void setMode(Mode m);
+Mode getMode();
+
+// Copy of the scan model for one frame
+ScanModel snapshot();
+
+// Push order of the HUD frame (HUD task only)
+PushOrder &pushOrder();
+
+void logStats();
+
+} // namespace TearSync
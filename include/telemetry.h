@@ -1,5 +1,6 @@
 #pragma once
-#include <Arduino.h>
+#include "static_string.h"
+#include <cstdint>
 
 // ============================================================================
 // telemetry.h - Sistema de Telemetría Avanzada v2.8.0
@@ -66,7 +67,7 @@ struct Config {
   bool enabled = true;
   uint16_t updateIntervalMs = 1000; // Intervalo de actualización
   bool persistToStorage = true;
-  uint16_t persistIntervalSec = 60;  // Guardado cada 60s
+  uint16_t persistIntervalSec = 5;   // Guardado cada 5s (FlashJournal)
   float batteryCapacityKwh = 0.576f; // 24V * 24Ah = 576Wh
 };
 
@@ -93,7 +94,15 @@ float getEstimatedRangeKm();
 float getAvgConsumptionWhKm();
 
 // Exportación JSON (para SD, WiFi, app móvil)
-String exportToJson();
+// Sin heap: el JSON completo (~260 caracteres) cabe en JsonString
+constexpr size_t JSON_CAPACITY = 384;
+typedef StaticString<JSON_CAPACITY> JsonString;
+JsonString exportToJson();
+
+// Serializa unos datos concretos (telemetry_json.cpp, sin dependencias de
+// Arduino para el entorno de test nativo)
+void writeJson(const VehicleData &d, float consumptionWhKm, float rangeKm,
+               JsonString &out);
 
 // -----------------------
 // Funciones para actualizar métricas desde sensores
@@ -26,7 +26,7 @@ enum class CalibrationState {
 // Calibration result structure
 struct CalibrationResult {
   bool success;
-  uint16_t calibData[5]; // [min_x, max_x, min_y, max_y, rotation]
+  uint16_t calibData[5]; // [x_left, x_right, y_top, y_bottom, rotation]
   char message[64];
 };
 
@@ -0,0 +1,156 @@
+// touch_input.h - XPT2046 touch input service
+// A dedicated task samples the touch controller, driven by the PENIRQ line
+// when it is wired (PIN_TOUCH_IRQ) or by a slow idle poll otherwise. While
+// the panel is pressed it samples at SAMPLE_PERIOD_MS: each sample is the
+// median of MEDIAN_TAPS conversions, smoothed by a fixed-point IIR and
+// mapped to screen pixels with a fixed-point calibration. Gestures (tap,
+// long press, drag) are posted with timestamps to a queue that the HUD task
+// drains in HUDManager::update(), so touch latency no longer depends on the
+// frame rate and frames never wait on touch reads.
+// Filter, Calibration and GestureTracker are pure C++ (native tests); the
+// XPT2046 task is in touch_input_xpt2046.cpp.
+#pragma once
+
+#include <cstdint>
+
+namespace TouchInput {
+
+// --- Sampling ---
+constexpr uint32_t SAMPLE_PERIOD_MS = 10;    // 100 Hz while pressed
+constexpr uint32_t IDLE_POLL_MS = 25;        // Pen-down check without PENIRQ
+constexpr uint8_t MEDIAN_TAPS = 5;           // Conversions per sample
+constexpr uint16_t PRESSURE_MIN = 350;       // Z below this = not pressed
+constexpr uint8_t IIR_ALPHA_Q8 = 128;        // New-sample weight (/256)
+constexpr uint16_t RAW_MAX = 4095;           // 12-bit ADC
+
+// --- Gestures ---
+constexpr uint32_t LONG_PRESS_MS = 800;
+constexpr int16_t DRAG_SLOP_PX = 12;   // Movement that turns a press into drag
+constexpr uint8_t RELEASE_SAMPLES = 2; // Consecutive pen-up samples = release
+
+// --- Queue / task ---
+constexpr uint8_t QUEUE_DEPTH = 16;
+constexpr uint32_t TASK_STACK = 3072;
+constexpr uint32_t BUS_WAIT_MS = 50; // Max wait for the display to free SPI
+
+struct RawSample {
+  uint16_t x;
+  uint16_t y;
+  uint16_t z; // Pressure
+};
+
+struct Point {
+  int16_t x;
+  int16_t y;
+};
+
+enum class EventType : uint8_t {
+  DOWN,       // Pen down (first valid sample)
+  TAP,        // Released before LONG_PRESS_MS without dragging
+  LONG_PRESS, // Held LONG_PRESS_MS without dragging (once per press)
+  DRAG_START, // Moved more than DRAG_SLOP_PX from the press point
+  DRAG,       // Position update while dragging
+  DRAG_END,   // Released after a drag
+  UP,         // Pen up (always last event of a press)
+};
+
+struct Event {
+  EventType type;
+  int16_t x, y;        // Screen position (release point for TAP/UP)
+  int16_t dx, dy;      // Offset from the press point
+  uint32_t timeMs;     // When the gesture was recognised
+  uint32_t durationMs; // Time since pen down
+};
+
+// Median of the pressed conversions, then a Q8 IIR. The IIR restarts on
+// every new press so the first sample is not dragged from the last one.
+class Filter {
+public:
+  void reset() { primed_ = false; }
+  // @return false when fewer than half the conversions were pressed
+  bool update(const RawSample *samples, uint8_t n, RawSample &out);
+
+private:
+  bool primed_ = false;
+  int32_t xq8_ = 0, yq8_ = 0;
+};
+
+// Linear raw -> pixel mapping stored as [x_left, x_right, y_top, y_bottom,
+// rotation]: the raw ADC values at the screen edges. x_left > x_right means
+// an inverted axis. Scale factors are Q16 so map() is integer only.
+class Calibration {
+public:
+  // @return false (and keeps the previous mapping) if cal[] is degenerate
+  bool set(const uint16_t cal[5], int16_t width, int16_t height);
+  Point map(uint16_t rawX, uint16_t rawY) const;
+  bool isValid() const { return valid_; }
+
+private:
+  bool valid_ = false;
+  int32_t x0_ = 0, y0_ = 0;
+  int32_t kx_ = 0, ky_ = 0; // Q16 pixels per raw count (signed)
+  int16_t w_ = 0, h_ = 0;
+};
+
+// Two-point calibration: p1/p2 are the raw readings at (margin, margin) and
+// (width - margin, height - margin); extrapolates to the screen edges and
+// keeps axis direction (no min/max reordering)
+void calibrationFromPoints(RawSample p1, RawSample p2, int16_t margin,
+                           int16_t width, int16_t height, uint8_t rotation,
+                           uint16_t cal[5]);
+
+// Turns pen state into gesture events
+class GestureTracker {
+public:
+  void reset();
+  // @param pressed pen state of this sample, (x, y) valid when pressed
+  // @return number of events written to out (at most 2)
+  uint8_t update(bool pressed, int16_t x, int16_t y, uint32_t nowMs,
+                 Event out[2]);
+  bool isDown() const { return down_; }
+
+private:
+  Event make(EventType type, int16_t x, int16_t y, uint32_t nowMs) const;
+
+  bool down_ = false;
+  bool dragging_ = false;
+  bool longFired_ = false;
+  uint8_t upCount_ = 0;
+  int16_t startX_ = 0, startY_ = 0;
+  int16_t lastX_ = 0, lastY_ = 0;
+  uint32_t startMs_ = 0;
+};
+
+struct Stats {
+  uint32_t samples;       // Filtered samples taken
+  uint32_t events;        // Events posted
+  uint32_t dropped;       // Events lost to a full queue (DRAG first)
+  uint32_t irqs;          // PENIRQ edges
+  uint32_t busTimeouts;   // Samples skipped: display held SPI too long
+  uint32_t maxBusWaitUs;  // Longest wait for the display bus
+  uint32_t maxPenToEventUs; // PENIRQ/poll detection -> DOWN posted
+  uint32_t maxQueueLagMs;   // Event posted -> taken by the HUD task
+};
+
+// --- Service (XPT2046 on the display SPI bus) ---
+
+// Applies the calibration and starts the sampling task on the HUD core
+bool init(const uint16_t cal[5]);
+bool isRunning();
+bool isIrqDriven();
+
+// Replaces the calibration (TouchCalibration, after saving it)
+void setCalibration(const uint16_t cal[5]);
+
+// Takes the next event (HUD task)
+bool poll(Event &out);
+
+// Latest filtered position; false when the pen is up
+bool read(int16_t &x, int16_t &y);
+// Same, in raw ADC units (for calibration)
+bool readRaw(uint16_t &x, uint16_t &y);
+
+void getStats(Stats &out);
+void logStats();
+
+} // namespace TouchInput
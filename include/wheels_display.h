@@ -8,6 +8,9 @@ namespace WheelsDisplay {
 // Inicializa el módulo con el puntero a la pantalla
 void init(TFT_eSPI *display);
 
+// Olvida lo dibujado: la próxima llamada de cada rueda redibuja
+void invalidate();
+
 // Dibuja una rueda en (cx, cy) con:
 // - angleDeg: ángulo de dirección en grados
 // - tempC: temperatura en °C
@@ -56,7 +56,7 @@ void Alerts::play(Audio::Track t) {
     return;
   }
 
-  Audio::Item it{trackId, Priority::PRIO_NORMAL};
+  Audio::Item it{trackId, defaultPriority(t)};
   if (!AudioQueue::push(it.track, it.prio)) {
     Logger::errorf("Alerts: cola de audio llena"); // ← corregido
     System::logError(722);
@@ -67,4 +67,25 @@ void Alerts::play(Audio::Track t) {
                 (unsigned)it.track, (unsigned)it.prio);
 }
 
+Priority Alerts::defaultPriority(Audio::Track t) {
+  switch (t) {
+  case AUDIO_EMERGENCIA:
+  case AUDIO_OBSTACULO:
+  case AUDIO_TEMP_ALTA:
+  case AUDIO_BATERIA_CRITICA:
+  case AUDIO_SOBRECORRIENTE:
+    return Priority::PRIO_CRITICAL;
+  case AUDIO_ERROR_GENERAL:
+  case AUDIO_PEDAL_ERROR:
+  case AUDIO_INA_ERROR:
+  case AUDIO_ENCODER_ERROR:
+  case AUDIO_SENSOR_TEMP_ERROR:
+  case AUDIO_SENSOR_CORRIENTE_ERROR:
+  case AUDIO_SENSOR_VELOCIDAD_ERROR:
+    return Priority::PRIO_HIGH;
+  default:
+    return Priority::PRIO_NORMAL;
+  }
+}
+
 bool Alerts::initOK() { return initialized; }
\ No newline at end of file
@@ -0,0 +1,138 @@
+// audio_scheduler.cpp - Priority audio scheduler (pure, host-testable)
+#include "audio_scheduler.h"
+
+namespace Audio {
+
+void Scheduler::reset() { *this = Scheduler(); }
+
+int8_t Scheduler::findPending(uint16_t track) const {
+  for (uint8_t i = 0; i < count_; i++) {
+    if (pending_[i].track == track) return static_cast<int8_t>(i);
+  }
+  return -1;
+}
+
+// Entries stay in arrival order, so the first match wins ties
+int8_t Scheduler::best() const {
+  int8_t b = -1;
+  for (uint8_t i = 0; i < count_; i++) {
+    if (b < 0 || pending_[i].prio > pending_[b].prio) {
+      b = static_cast<int8_t>(i);
+    }
+  }
+  return b;
+}
+
+int8_t Scheduler::victim() const {
+  int8_t v = -1;
+  for (uint8_t i = 0; i < count_; i++) {
+    if (v < 0 || pending_[i].prio < pending_[v].prio) {
+      v = static_cast<int8_t>(i);
+    }
+  }
+  return v;
+}
+
+void Scheduler::remove(uint8_t i) {
+  for (uint8_t j = i; j + 1 < count_; j++) pending_[j] = pending_[j + 1];
+  count_--;
+}
+
+PushResult Scheduler::push(uint16_t track, Priority prio, uint32_t nowMs) {
+  if (track == 0 || track > MAX_TRACK || prio >= PRIORITY_COUNT) {
+    return PushResult::INVALID;
+  }
+  PriorityStats &st = stats_[prio];
+  st.pushed++;
+
+  // Already waiting: keep its place (and push time), take the higher prio
+  int8_t dup = findPending(track);
+  if (dup >= 0) {
+    if (prio > pending_[dup].prio) pending_[dup].prio = prio;
+    st.coalesced++;
+    return PushResult::COALESCED;
+  }
+
+  if (prio < PRIO_CRITICAL) {
+    // Being heard right now
+    if (playing_.track == track) {
+      st.coalesced++;
+      return PushResult::COALESCED;
+    }
+    if (started_[track] && nowMs - lastStartMs_[track] < REPEAT_MIN_MS) {
+      st.rateLimited++;
+      return PushResult::RATE_LIMITED;
+    }
+  }
+
+  PushResult result = PushResult::QUEUED;
+  if (count_ >= SCHED_CAPACITY) {
+    int8_t v = victim();
+    if (pending_[v].prio >= prio) {
+      st.dropped++;
+      return PushResult::DROPPED;
+    }
+    stats_[pending_[v].prio].evicted++;
+    remove(static_cast<uint8_t>(v));
+    result = PushResult::REPLACED;
+  }
+
+  pending_[count_++] = {track, prio, nowMs};
+  return result;
+}
+
+bool Scheduler::poll(uint32_t nowMs, Dispatch &out) {
+  // Modules that never report completion: give up after MAX_PLAY_MS
+  if (isPlaying() && nowMs - playStartMs_ >= MAX_PLAY_MS) {
+    timeouts_++;
+    playing_ = {};
+  }
+
+  int8_t b = best();
+  if (b < 0) return false;
+  if (commandSent_ && nowMs - lastCommandMs_ < COMMAND_GAP_MS) return false;
+
+  const Pending next = pending_[b];
+  bool preempt = false;
+  if (isPlaying()) {
+    if (next.prio < PRIO_CRITICAL || playing_.prio >= PRIO_CRITICAL) {
+      return false;
+    }
+    preempt = true;
+    stats_[playing_.prio].preempted++;
+  }
+
+  remove(static_cast<uint8_t>(b));
+  playing_ = next;
+  playStartMs_ = nowMs;
+  lastCommandMs_ = nowMs;
+  commandSent_ = true;
+  lastStartMs_[next.track] = nowMs;
+  started_[next.track] = true;
+
+  uint32_t latency = nowMs - next.pushedMs;
+  PriorityStats &st = stats_[next.prio];
+  st.played++;
+  st.latencySumMs += latency;
+  if (latency > st.latencyMaxMs) st.latencyMaxMs = latency;
+
+  out = {next.track, next.prio, preempt, latency};
+  return true;
+}
+
+void Scheduler::onFinished(uint16_t track) {
+  // A late report for a track that was already cut is ignored
+  if (track == 0 || track == playing_.track) playing_ = {};
+}
+
+void Scheduler::onPlayerError() { playing_ = {}; }
+
+bool Scheduler::pop(Pending &out) {
+  int8_t b = best();
+  if (b < 0) return false;
+  out = pending_[b];
+  remove(static_cast<uint8_t>(b));
+  return true;
+}
+
+} // namespace Audio
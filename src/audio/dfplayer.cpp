@@ -8,13 +8,6 @@
 
 using namespace Audio;
 
-// DFPlayer message type constants (from DFRobotDFPlayerMini library)
-constexpr uint8_t DFPLAYER_MSG_NONE = 0x00;
-constexpr uint8_t DFPLAYER_MSG_ERROR = 0x01;
-constexpr uint8_t DFPLAYER_MSG_STATUS = 0x02;
-constexpr uint8_t DFPLAYER_MSG_PLAY_FINISHED = 0x3D;
-constexpr uint8_t DFPLAYER_MSG_FEEDBACK = 0x3F;
-
 #ifndef DISABLE_SENSORS
 // 🔒 v2.17.4: CRITICAL BOOTLOOP FIX - Pointer-based lazy initialization
 // Global constructors DFRobotDFPlayerMini() and HardwareSerial(1) were causing
@@ -67,8 +60,10 @@ void Audio::DFPlayer::init() {
   // - GPIO 17 = RX (recibe respuestas del DFPlayer)
   DFSerial->begin(9600, SERIAL_8N1, PIN_DFPLAYER_RX, PIN_DFPLAYER_TX);
 
-  // Initialize DFPlayer with actual hardware check
-  bool ok = dfPlayer->begin(*DFSerial); // Actual initialization result
+  // Initialize DFPlayer with actual hardware check. Sin ACK: con ACK cada
+  // play() espera la respuesta del módulo (hasta 500 ms) dentro del job de
+  // audio; el fin de pista llega igualmente por update()
+  bool ok = dfPlayer->begin(*DFSerial, false); // Actual initialization result
   if (!ok) {
     Logger::errorf("DFPlayer init failed on UART1");
     System::logError(700); // código reservado: fallo init
@@ -99,14 +94,9 @@ void Audio::DFPlayer::play(uint16_t track) {
     return;
   }
 
-  bool ready = dfPlayer->available(); // Check actual status
-  if (!ready) {
-    Logger::warnf("DFPlayer not ready, cannot play track %u", (unsigned)track);
-    System::logError(701);
-    return;
-  }
-
-  // Play track using DFPlayer library
+  // Play track using DFPlayer library (cuts the current track, if any).
+  // AudioQueue decides when: available() here would consume the feedback
+  // messages update() needs
   dfPlayer->play(track);
   Logger::infof("DFPlayer play track %u", (unsigned)track);
 #endif
@@ -119,28 +109,29 @@ void Audio::DFPlayer::update() {
 #else
   if (!initialized) return;
 
-  // Check for messages from DFPlayer
-  if (dfPlayer->available()) {
+  // Check for messages from DFPlayer (readType() values from
+  // DFRobotDFPlayerMini.h)
+  while (dfPlayer->available()) {
     uint8_t type = dfPlayer->readType(); // Read message type
     int value = dfPlayer->read();        // Read message value
 
-    // Log errors (types >= 0x01 are typically errors/notifications)
-    // Ignore normal playback feedback messages
-    if (type != DFPLAYER_MSG_NONE && type != DFPLAYER_MSG_PLAY_FINISHED &&
-        type != DFPLAYER_MSG_FEEDBACK) {
+    switch (type) {
+    case DFPlayerPlayFinished:
+      // value = pista terminada: el planificador puede enviar la siguiente
+      AudioQueue::onFinished(static_cast<uint16_t>(value));
+      break;
+    case DFPlayerError:
+      Logger::errorf("DFPlayer error - Type: 0x%02X, Value: %d", type, value);
+      System::logError(702 + type);
+      AudioQueue::onPlayerError();
+      break;
+    case DFPlayerFeedBack:
+      break; // ACK de comandos
+    default:
       Logger::infof("DFPlayer message - Type: 0x%02X, Value: %d", type, value);
-
-      // Log specific error codes if they indicate problems
-      if (type == DFPLAYER_MSG_ERROR || type == DFPLAYER_MSG_STATUS) {
-        Logger::errorf("DFPlayer error - Type: 0x%02X, Value: %d", type, value);
-        System::logError(702 + type);
-      }
+      break;
     }
   }
-
-  // Despachar desde la cola si quieres:
-  // Item it;
-  // if (AudioQueue::pop(it)) play(it.track);
 #endif
 }
 
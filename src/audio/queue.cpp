@@ -1,65 +1,143 @@
 #include "queue.h"
+#include "audio_scheduler.h"
 #include "dfplayer.h"
 #include "logger.h"
 #include "system.h" // para logError()
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
 
 using namespace Audio;
 
-Item AudioQueue::queue_[AudioQueue::MAX_QUEUE];
-size_t AudioQueue::head_ = 0;
-size_t AudioQueue::tail_ = 0;
-size_t AudioQueue::count_ = 0;
+// push() llega desde ambos núcleos (safety, HUD, menús); update() desde el
+// job de audio
+static portMUX_TYPE schedMux = portMUX_INITIALIZER_UNLOCKED;
+static Scheduler scheduler;
+
+static const char *const PRIO_NAMES[PRIORITY_COUNT] = {"LOW", "NORMAL",
+                                                       "HIGH", "CRITICAL"};
+static constexpr uint32_t STATS_LOG_MS = 60000;
 
 void AudioQueue::init() noexcept {
-  head_ = tail_ = count_ = 0;
+  portENTER_CRITICAL(&schedMux);
+  scheduler.reset();
+  portEXIT_CRITICAL(&schedMux);
   Logger::info("AudioQueue init OK");
 }
 
 bool AudioQueue::push(uint16_t track, Priority prio) noexcept {
-  // Validar rango de tracks (1-68)
-  if (track == 0 || track > 68) {
+  portENTER_CRITICAL(&schedMux);
+  PushResult r = scheduler.push(track, prio, millis());
+  portEXIT_CRITICAL(&schedMux);
+
+  switch (r) {
+  case PushResult::INVALID:
+    // Validar rango de tracks (1-68)
     Logger::warnf("AudioQueue: track inválido (%u). Rango válido: 1-68",
                   (unsigned)track);
     System::logError(730); // código reservado: track inválido
     return false;
-  }
-
-  if (count_ >= MAX_QUEUE) {
-    Logger::errorf("AudioQueue FULL, dropping track %u", (unsigned)track);
+  case PushResult::DROPPED:
+    Logger::errorf("AudioQueue FULL, dropping track %u prio %u",
+                   (unsigned)track, (unsigned)prio);
     System::logError(731); // código reservado: cola llena
     return false;
+  case PushResult::REPLACED:
+    Logger::warnf("AudioQueue full: track %u prio %u evicted a lower one",
+                  (unsigned)track, (unsigned)prio);
+    return true;
+  case PushResult::COALESCED:
+  case PushResult::RATE_LIMITED:
+    return true; // Ya suena o acaba de sonar
+  default:
+    Logger::infof("AudioQueue push track %u prio %u", (unsigned)track,
+                  (unsigned)prio);
+    return true;
   }
-
-  queue_[tail_] = {track, prio};
-  tail_ = (tail_ + 1) % MAX_QUEUE;
-  ++count_;
-  Logger::infof("AudioQueue push track %u prio %u", (unsigned)track,
-                (unsigned)prio);
-  return true;
 }
 
 bool AudioQueue::pop(Item &out) noexcept {
-  if (count_ == 0) return false;
-  out = queue_[head_];
-  head_ = (head_ + 1) % MAX_QUEUE;
-  --count_;
-  return true;
+  Pending p;
+  portENTER_CRITICAL(&schedMux);
+  bool ok = scheduler.pop(p);
+  portEXIT_CRITICAL(&schedMux);
+  if (ok) out = {p.track, p.prio};
+  return ok;
 }
 
-bool AudioQueue::empty() noexcept { return (count_ == 0); }
+bool AudioQueue::empty() noexcept {
+  portENTER_CRITICAL(&schedMux);
+  bool e = scheduler.pendingCount() == 0;
+  portEXIT_CRITICAL(&schedMux);
+  return e;
+}
 
 void AudioQueue::update() noexcept {
-  // Punto de extensión: despachar a DFPlayer si procede.
-  Item it;
-  if (pop(it)) {
-    Logger::infof("AudioQueue dispatch track %u", (unsigned)it.track);
-    // 🔎 Si DFPlayer está inicializado, reproducir
-    if (Audio::DFPlayer::initOK()) {
-      Audio::DFPlayer::play(it.track);
-    } else {
+  static uint32_t lastStatsMs = 0;
+  uint32_t now = millis();
+  if (now - lastStatsMs >= STATS_LOG_MS) {
+    lastStatsMs = now;
+    logStats();
+  }
+
+  if (!Audio::DFPlayer::initOK()) {
+    Item it;
+    if (pop(it)) {
       Logger::warn(
           "AudioQueue: DFPlayer no inicializado, no se puede reproducir");
       System::logError(732); // código reservado: DFPlayer no listo
     }
+    return;
   }
-}
\ No newline at end of file
+
+  Dispatch d;
+  portENTER_CRITICAL(&schedMux);
+  bool due = scheduler.poll(now, d);
+  portEXIT_CRITICAL(&schedMux);
+  if (!due) return;
+
+  // Un play nuevo corta lo que esté sonando (preempción)
+  Logger::infof("AudioQueue dispatch track %u prio %u%s, %lu ms en cola",
+                (unsigned)d.track, (unsigned)d.prio,
+                d.preempt ? " (preempt)" : "", (unsigned long)d.latencyMs);
+  Audio::DFPlayer::play(d.track);
+}
+
+void AudioQueue::onFinished(uint16_t track) noexcept {
+  portENTER_CRITICAL(&schedMux);
+  scheduler.onFinished(track);
+  portEXIT_CRITICAL(&schedMux);
+}
+
+void AudioQueue::onPlayerError() noexcept {
+  portENTER_CRITICAL(&schedMux);
+  scheduler.onPlayerError();
+  portEXIT_CRITICAL(&schedMux);
+}
+
+void AudioQueue::logStats() noexcept {
+  PriorityStats st[PRIORITY_COUNT];
+  portENTER_CRITICAL(&schedMux);
+  for (uint8_t p = 0; p < PRIORITY_COUNT; p++) {
+    st[p] = scheduler.stats(static_cast<Priority>(p));
+  }
+  uint32_t timeouts = scheduler.timeouts();
+  portEXIT_CRITICAL(&schedMux);
+
+  for (uint8_t p = 0; p < PRIORITY_COUNT; p++) {
+    const PriorityStats &s = st[p];
+    if (s.pushed == 0) continue;
+    Logger::infof("AudioQueue %s: %lu push, %lu play, latencia %lu ms media "
+                  "/ %lu máx, %lu fusionadas, %lu limitadas, %lu descartadas, "
+                  "%lu desalojadas, %lu cortadas",
+                  PRIO_NAMES[p], (unsigned long)s.pushed,
+                  (unsigned long)s.played,
+                  (unsigned long)(s.played ? s.latencySumMs / s.played : 0),
+                  (unsigned long)s.latencyMaxMs, (unsigned long)s.coalesced,
+                  (unsigned long)s.rateLimited, (unsigned long)s.dropped,
+                  (unsigned long)s.evicted, (unsigned long)s.preempted);
+  }
+  if (timeouts) {
+    Logger::infof("AudioQueue: %lu pistas sin aviso de fin (timeout)",
+                  (unsigned long)timeouts);
+  }
+}
@@ -0,0 +1,186 @@
+// acc_predictive.cpp - Predictive ACC core
+// Alpha-beta-gamma closing-speed estimator + gain-scheduled MPC controller.
+// No Arduino dependencies: compiled unchanged by host-side simulations.
+
+#include "acc_predictive.h"
+
+namespace AccPredictive {
+
+// ----------------------------------------------------------------------------
+// Precomputed MPC gains
+// ----------------------------------------------------------------------------
+// Model: x = [gap error (m), relative velocity (m/s), lag (m/s)],
+//   u = change of commanded ego speed per step, dt = 10 ms, tau = 0.3 s
+//   e'   = e + dt * vr
+//   vr'  = vr - (dt / tau) * lag
+//   lag' = (1 - dt / tau) * lag + u
+// Finite-horizon LQ (N = 150 steps = 1.5 s), first-step gain K scaled by 1/dt
+// so the output is a commanded acceleration in m/s^2.
+//   CRUISE : Q = diag(1, 1, 0), R = 2000 -> K = [1.53, 3.09, 2.27]
+//   CLOSING: Q = diag(1, 2, 0), R = 1000 -> K = [1.98, 5.21, 3.46]
+//   CLOSE  : Q = diag(2, 2, 0), R = 500  -> K = [5.07, 7.92, 4.71]
+// Lookahead compensates the ~66 ms sensor period + filter lag.
+static const GainSet GAIN_TABLE[3] = {
+    {1.53f, 3.09f, 2.27f, 0.00f}, // BAND_CRUISE
+    {1.98f, 5.21f, 3.46f, 0.05f}, // BAND_CLOSING
+    {5.07f, 7.92f, 4.71f, 0.10f}  // BAND_CLOSE
+};
+
+// Band thresholds
+constexpr float BAND_CLOSING_VEL_MM_S = -300.0f; // Closing faster than this
+constexpr float BAND_CLOSE_ERROR_MM = -150.0f;   // Inside target gap
+
+static inline float clampf(float v, float lo, float hi) {
+  return v < lo ? lo : (v > hi ? hi : v);
+}
+
+// ----------------------------------------------------------------------------
+// Estimator
+// ----------------------------------------------------------------------------
+
+void resetEstimator(EstimatorState &est) { est = EstimatorState(); }
+
+bool fuseSample(EstimatorState &est, float measuredMm, uint32_t sampleMs) {
+  if (est.initialized && sampleMs == est.lastSampleMs) return false;
+
+  uint32_t gapMs = sampleMs - est.lastSampleMs;
+  if (!est.initialized || gapMs == 0 || gapMs > EST_MAX_SAMPLE_GAP_MS) {
+    est.distanceMm = measuredMm;
+    est.relVelMmS = 0.0f;
+    est.relAccelMmS2 = 0.0f;
+    est.lastSampleMs = sampleMs;
+    est.samples = 1;
+    est.initialized = true;
+    return true;
+  }
+
+  float dt = gapMs * 0.001f;
+
+  // Predict
+  float xp = est.distanceMm + est.relVelMmS * dt +
+             0.5f * est.relAccelMmS2 * dt * dt;
+  float vp = est.relVelMmS + est.relAccelMmS2 * dt;
+  float residual = measuredMm - xp;
+
+  // Large residual means a different object entered the beam: restart
+  if (residual > EST_REINIT_RESIDUAL_MM || residual < -EST_REINIT_RESIDUAL_MM) {
+    est.distanceMm = measuredMm;
+    est.relVelMmS = 0.0f;
+    est.relAccelMmS2 = 0.0f;
+    est.lastSampleMs = sampleMs;
+    est.samples = 1;
+    return true;
+  }
+
+  // Correct
+  est.distanceMm = xp + EST_ALPHA * residual;
+  est.relVelMmS = clampf(vp + (EST_BETA / dt) * residual, -EST_MAX_VEL_MM_S,
+                         EST_MAX_VEL_MM_S);
+  est.relAccelMmS2 =
+      clampf(est.relAccelMmS2 + (2.0f * EST_GAMMA / (dt * dt)) * residual,
+             -EST_MAX_ACCEL_MM_S2, EST_MAX_ACCEL_MM_S2);
+  est.lastSampleMs = sampleMs;
+  if (est.samples < 255) est.samples++;
+  return true;
+}
+
+void predict(const EstimatorState &est, uint32_t nowMs, float &distanceMm,
+             float &relVelMmS) {
+  uint32_t ageMs = nowMs - est.lastSampleMs;
+  if (!est.initialized || ageMs > 0x80000000UL) ageMs = 0; // now < sample
+  if (ageMs > EST_MAX_EXTRAPOLATION_MS) ageMs = EST_MAX_EXTRAPOLATION_MS;
+  float t = ageMs * 0.001f;
+
+  distanceMm = est.distanceMm + est.relVelMmS * t;
+  relVelMmS = est.relVelMmS;
+  // Acceleration is only trusted once velocity has settled
+  if (est.samples >= 4) {
+    distanceMm += 0.5f * est.relAccelMmS2 * t * t;
+    relVelMmS += est.relAccelMmS2 * t;
+  }
+  if (distanceMm < 0.0f) distanceMm = 0.0f;
+}
+
+// ----------------------------------------------------------------------------
+// Controller
+// ----------------------------------------------------------------------------
+
+GainBand selectBand(float gapErrorMm, float relVelMmS) {
+  if (gapErrorMm < BAND_CLOSE_ERROR_MM) return BAND_CLOSE;
+  if (relVelMmS < BAND_CLOSING_VEL_MM_S) return BAND_CLOSING;
+  return BAND_CRUISE;
+}
+
+const GainSet &gains(GainBand band) {
+  if (band > BAND_CLOSE) band = BAND_CLOSE;
+  return GAIN_TABLE[band];
+}
+
+void resetController(ControllerState &ctl, float factor) {
+  ctl.factor = factor;
+  ctl.factorRate = 0.0f;
+  ctl.lagMmS = 0.0f;
+  ctl.band = BAND_CRUISE;
+  ctl.brakeHold = false;
+}
+
+void engageBrake(ControllerState &ctl, float resumeFactor) {
+  resetController(ctl, resumeFactor);
+  ctl.brakeHold = true;
+}
+
+float step(ControllerState &ctl, float distanceMm, float relVelMmS,
+           float relAccelMmS2, float targetMm, float emergencyMm,
+           const Limits &lim, float dtS) {
+  if (dtS <= 0.0f) return ctl.brakeHold ? 0.0f : ctl.factor;
+
+  // Predictive brake with release hysteresis
+  float closingMmS = relVelMmS < 0.0f ? relVelMmS : 0.0f;
+  float projectedMm = distanceMm + closingMmS * BRAKE_HORIZON_S;
+  if (!ctl.brakeHold && projectedMm < emergencyMm) {
+    engageBrake(ctl, lim.minFactor);
+  } else if (ctl.brakeHold &&
+             projectedMm >= emergencyMm + BRAKE_RELEASE_MARGIN_MM &&
+             relVelMmS >= -BRAKE_RELEASE_MAX_CLOSING_MM_S) {
+    resetController(ctl, lim.minFactor);
+  }
+  if (ctl.brakeHold) return 0.0f;
+
+  float gapErrorMm = distanceMm - targetMm;
+  ctl.band = selectBand(gapErrorMm, relVelMmS);
+  const GainSet &g = GAIN_TABLE[ctl.band];
+
+  // Short-horizon prediction of relative velocity
+  float velAheadMmS = relVelMmS + relAccelMmS2 * g.lookaheadS;
+
+  // Ego acceleration command (mm/s^2) -> factor slope (1/s)
+  float accelCmdMmS2 =
+      g.kGap * gapErrorMm + g.kVel * velAheadMmS - g.kLag * ctl.lagMmS;
+  float refSpeed =
+      lim.referenceSpeedMmS > 1.0f ? lim.referenceSpeedMmS : 1.0f;
+  float rateCmd = clampf(accelCmdMmS2 / refSpeed, -lim.maxFallRate,
+                         lim.maxRiseRate);
+
+  // Jerk bound: the slope itself may only change by maxJerk * dt
+  float maxSlopeStep = lim.maxJerk * dtS;
+  ctl.factorRate += clampf(rateCmd - ctl.factorRate, -maxSlopeStep,
+                           maxSlopeStep);
+
+  float next = ctl.factor + ctl.factorRate * dtS;
+  float hi = lim.maxFactor < lim.minFactor ? lim.minFactor : lim.maxFactor;
+  if (next > hi) {
+    next = hi;
+    if (ctl.factorRate > 0.0f) ctl.factorRate = 0.0f; // anti-windup
+  } else if (next < lim.minFactor) {
+    next = lim.minFactor;
+    if (ctl.factorRate < 0.0f) ctl.factorRate = 0.0f;
+  }
+
+  // Propagate the motor lag model with the speed change actually commanded
+  ctl.lagMmS +=
+      (next - ctl.factor) * refSpeed - (dtS / MOTOR_LAG_S) * ctl.lagMmS;
+  ctl.factor = next;
+  return next;
+}
+
+} // namespace AccPredictive
@@ -1,9 +1,12 @@
 // Adaptive Cruise Control Implementation v2.12.0
 // PID-based speed regulation with person-following mode
+// Predictive mode: closing-speed estimator + gain-scheduled MPC (see
+// acc_predictive.h), evaluated every ControlTask cycle
 // Author: Copilot AI Assistant
 // Date: 2025-12-23
 
 #include "adaptive_cruise.h"
+#include "acc_predictive.h"
 #include "logger.h"
 #include "obstacle_detection.h"
 #include "pedal.h"
@@ -19,8 +22,12 @@ static uint32_t lastUpdateMs = 0;
 static uint32_t targetLostMs = 0;      // v2.12.0: Target lost timeout
 static float childPedalLimit = 100.0f; // v2.12.0: Child pedal safety limit
 static uint32_t lastDebugLogMs = 0;    // v2.12.0: Throttle debug logging
+static bool emergencyBrake = false;    // Previous update was an emergency brake
+static AccPredictive::EstimatorState estimator;
+static AccPredictive::ControllerState controller;
 
-constexpr uint32_t UPDATE_INTERVAL_MS = 100;          // 10Hz
+constexpr uint32_t UPDATE_INTERVAL_MS = 100;          // 10Hz (PID mode)
+constexpr uint32_t PREDICTIVE_INTERVAL_MS = 10;       // 100Hz (ControlTask)
 constexpr uint32_t TARGET_LOST_TIMEOUT_MS = 2000;     // 2 seconds
 constexpr uint16_t EMERGENCY_BRAKE_DISTANCE_MM = 300; // 30cm
 
@@ -37,15 +44,90 @@ void init() {
   status.state = config.enabled ? ACC_STANDBY : ACC_DISABLED;
   pidIntegral = 0.0f;
   pidLastError = 0.0f;
+  AccPredictive::resetEstimator(estimator);
+  AccPredictive::resetController(controller, 1.0f);
   lastUpdateMs = millis();
   targetLostMs = 0;
   childPedalLimit = 100.0f;
 }
 
+// Legacy PID on the raw distance (fixed 100ms step)
+static float updatePID(uint16_t frontDist) {
+  float error = (float)(frontDist - config.targetDistanceMm);
+  float dt = UPDATE_INTERVAL_MS / 1000.0f;
+  pidIntegral += error * dt;
+  float pidDerivative = (error - pidLastError) / dt;
+  pidLastError = error;
+
+  // Anti-windup: limit integral term
+  pidIntegral = constrain(pidIntegral, -500.0f, 500.0f);
+
+  // Calculate PID output
+  float pidOutput = (config.pidKp * error) + (config.pidKi * pidIntegral) +
+                    (config.pidKd * pidDerivative);
+
+  // Convert to speed adjustment (0.0 = stop, 1.0 = full speed)
+  float adjustment = 1.0f + (pidOutput / 1000.0f);
+
+  // Normal regulation - clamp adjustment
+  float minAdjust = 1.0f - (config.maxSpeedReduction / 100.0f);
+  return constrain(adjustment, minAdjust, 1.0f);
+}
+
+// Predictive path: fuse the latest TOFSense frame (only when a new one
+// arrived), extrapolate to now and run one jerk-limited MPC step.
+static float updatePredictive(uint16_t frontDist, uint32_t now, float dtS) {
+  uint32_t t0 = micros();
+
+  const ObstacleDetection::ObstacleSensor &sensor =
+      ObstacleDetection::getSensor(ObstacleDetection::SENSOR_FRONT);
+  AccPredictive::fuseSample(estimator, (float)frontDist, sensor.lastUpdateMs);
+
+  float gapMm, relVelMmS;
+  AccPredictive::predict(estimator, now, gapMm, relVelMmS);
+
+  AccPredictive::Limits lim;
+  lim.minFactor = 1.0f - (config.maxSpeedReduction / 100.0f);
+  lim.maxFactor = 1.0f;
+  lim.maxJerk = config.maxJerk;
+  lim.referenceSpeedMmS = (float)config.referenceSpeedMmS;
+
+  float adjustment = AccPredictive::step(
+      controller, gapMm, relVelMmS, estimator.relAccelMmS2,
+      (float)config.targetDistanceMm, (float)EMERGENCY_BRAKE_DISTANCE_MM, lim,
+      dtS);
+
+  status.relVelocityMmS = estimator.relVelMmS;
+  status.relAccelMmS2 = estimator.relAccelMmS2;
+
+  uint32_t elapsed = micros() - t0;
+  status.lastComputeUs = elapsed > 0xFFFF ? 0xFFFF : (uint16_t)elapsed;
+  if (status.lastComputeUs > status.maxComputeUs) {
+    status.maxComputeUs = status.lastComputeUs;
+  }
+  if (elapsed > AccPredictive::COMPUTE_BUDGET_US) status.budgetOverruns++;
+
+  return adjustment;
+}
+
+static void resetControlState(float factor) {
+  pidIntegral = 0.0f;
+  pidLastError = 0.0f;
+  AccPredictive::resetEstimator(estimator);
+  AccPredictive::resetController(controller, factor);
+  status.relVelocityMmS = 0.0f;
+  status.relAccelMmS2 = 0.0f;
+}
+
 void update() {
   uint32_t now = millis();
-  if (now - lastUpdateMs < UPDATE_INTERVAL_MS) return;
+  bool predictive = (config.mode == ACC_MODE_PREDICTIVE);
+  uint32_t elapsedMs = now - lastUpdateMs;
+  if (elapsedMs < (predictive ? PREDICTIVE_INTERVAL_MS : UPDATE_INTERVAL_MS))
+    return;
   lastUpdateMs = now;
+  bool wasEmergencyBrake = emergencyBrake;
+  emergencyBrake = false;
 
   if (!config.enabled) {
     status.state = ACC_DISABLED;
@@ -66,11 +148,11 @@ void update() {
   if (frontDist == ObstacleConfig::DISTANCE_INVALID || frontDist > 4000) {
     // No target detected
     if (status.vehicleDetected) {
-      // Target just lost - reset PID state immediately
+      // Target just lost - reset PID/estimator state immediately, keep the
+      // current output during the grace period
       if (targetLostMs == 0) {
         targetLostMs = now;
-        pidIntegral = 0.0f;
-        pidLastError = 0.0f;
+        resetControlState(status.speedAdjustment);
         Logger::debug("ACC: Target lost, PID reset, starting timeout");
       } else if (now - targetLostMs >= TARGET_LOST_TIMEOUT_MS) {
         // Timeout exceeded - full speed
@@ -95,35 +177,30 @@ void update() {
   if (frontDist < EMERGENCY_BRAKE_DISTANCE_MM) {
     status.state = ACC_BRAKING;
     status.speedAdjustment = 0.0f;
-    // Reset PID state to avoid stale control when ACC re-engages
-    pidIntegral = 0.0f;
-    pidLastError = 0.0f;
-    Logger::warnf("ACC: Emergency brake! Distance=%dmm", frontDist);
+    // Reset PID state to avoid stale control when ACC re-engages; the
+    // predictive controller keeps braking until the projected gap clears
+    resetControlState(1.0f - (config.maxSpeedReduction / 100.0f));
+    AccPredictive::engageBrake(controller,
+                               1.0f - (config.maxSpeedReduction / 100.0f));
+    // Warn on entry only: predictive mode runs this at 100 Hz
+    emergencyBrake = true;
+    if (!wasEmergencyBrake) {
+      Logger::warnf("ACC: Emergency brake! Distance=%dmm", frontDist);
+    }
     return;
   }
 
   status.state = ACC_ACTIVE;
 
-  // PID controller for person-following mode
-  float error = (float)(frontDist - config.targetDistanceMm);
-  float dt = UPDATE_INTERVAL_MS / 1000.0f;
-  pidIntegral += error * dt;
-  float pidDerivative = (error - pidLastError) / dt;
-  pidLastError = error;
-
-  // Anti-windup: limit integral term
-  pidIntegral = constrain(pidIntegral, -500.0f, 500.0f);
-
-  // Calculate PID output
-  float pidOutput = (config.pidKp * error) + (config.pidKi * pidIntegral) +
-                    (config.pidKd * pidDerivative);
-
-  // Convert to speed adjustment (0.0 = stop, 1.0 = full speed)
-  float adjustment = 1.0f + (pidOutput / 1000.0f);
-
-  // Normal regulation - clamp adjustment
-  float minAdjust = 1.0f - (config.maxSpeedReduction / 100.0f);
-  adjustment = constrain(adjustment, minAdjust, 1.0f);
+  float adjustment;
+  if (predictive) {
+    float dtS = constrain(elapsedMs / 1000.0f, 0.005f, 0.05f);
+    adjustment = updatePredictive(frontDist, now, dtS);
+    // Projected gap over the stopping horizon crosses the emergency distance
+    if (controller.brakeHold) status.state = ACC_BRAKING;
+  } else {
+    adjustment = updatePID(frontDist);
+  }
 
   // v2.12.0: Respect child pedal input as safety limit
   // Never exceed what the child is demanding
@@ -135,9 +212,11 @@ void update() {
 
   // v2.12.0: Debug logging at 10Hz (throttled to once per second)
   if (now - lastDebugLogMs >= 1000) {
-    Logger::debugf("ACC: dist=%dmm, target=%dmm, adj=%.2f, pedal=%.1f%%",
+    Logger::debugf("ACC: dist=%dmm, target=%dmm, adj=%.2f, pedal=%.1f%%, "
+                   "vrel=%.0fmm/s, cpu=%u/%uus",
                    frontDist, config.targetDistanceMm, adjustment,
-                   childPedalLimit);
+                   childPedalLimit, status.relVelocityMmS,
+                   status.lastComputeUs, status.maxComputeUs);
     lastDebugLogMs = now;
   }
 }
@@ -147,8 +226,7 @@ void setEnabled(bool enable) {
   if (!enable) {
     status.state = ACC_DISABLED;
     status.speedAdjustment = 1.0f;
-    pidIntegral = 0.0f;
-    pidLastError = 0.0f;
+    resetControlState(1.0f);
   } else {
     status.state = ACC_STANDBY;
     Logger::info("ACC: Enabled");
@@ -168,8 +246,9 @@ void setConfig(const ACCConfig &newConfig) {
 float getSpeedAdjustment() { return status.speedAdjustment; }
 
 void reset() {
-  pidIntegral = 0.0f;
-  pidLastError = 0.0f;
+  resetControlState(1.0f);
+  status.maxComputeUs = 0;
+  status.budgetOverruns = 0;
   status.state = config.enabled ? ACC_STANDBY : ACC_DISABLED;
   status.speedAdjustment = 1.0f;
 }
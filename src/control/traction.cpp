@@ -2,6 +2,7 @@
 #include "adaptive_cruise.h"
 #include "boot_guard.h"
 #include "current.h"
+#include "error_journal.h"
 #include "i2c_recovery.h"
 #include "logger.h"
 #include "mcp23017_manager.h"
@@ -440,7 +441,8 @@ void Traction::update() {
       if (cfg.currentSensorsEnabled) {
         float currentA = Sensors::getCurrent(i);
         if (!isCurrentValid(currentA)) {
-          System::logError(810 + i); // códigos 810-813 para motores FL-RR
+          System::logError(810 + i, // códigos 810-813 para motores FL-RR
+                           ErrorJournal::contextOf(currentA));
           Logger::warnf("Axis rotation: invalid current wheel %d: %.2fA", i,
                         currentA);
           currentA = 0.0f;
@@ -454,7 +456,8 @@ void Traction::update() {
       if (cfg.tempSensorsEnabled) {
         float tempC = Sensors::getTemperature(i);
         if (!isTempValid(tempC)) {
-          System::logError(820 + i); // códigos 820-823 para motores FL-RR
+          System::logError(820 + i, // códigos 820-823 para motores FL-RR
+                           ErrorJournal::contextOf(tempC));
           Logger::warnf("Axis rotation: invalid temp wheel %d: %.1f°C", i,
                         tempC);
           tempC = 0.0f;
@@ -465,8 +468,8 @@ void Traction::update() {
             Logger::errorf(
                 "EMERGENCY: Motor %d temp %.1f°C - IMMEDIATE SHUTDOWN!", i,
                 tempC);
-            System::logError(825 +
-                             i); // códigos 825-828 para emergency shutdown
+            System::logError(825 + i, // códigos 825-828: emergency shutdown
+                             ErrorJournal::contextOf(tempC));
 
             // Detener motor inmediatamente con hardware cutoff
             s.w[i].demandPct = 0.0f;
@@ -625,7 +628,8 @@ void Traction::update() {
 
       // 🔒 MEJORA: Validación robusta con verificación de rango
       if (!isCurrentValid(currentA)) {
-        System::logError(810 + i); // códigos 810-813 para motores FL-RR
+        System::logError(810 + i, // códigos 810-813 para motores FL-RR
+                         ErrorJournal::contextOf(currentA));
         Logger::errorf(
             "Traction: corriente inválida rueda %d: %.2fA (límite ±%.0fA)", i,
             currentA, CURRENT_MAX_REASONABLE);
@@ -652,7 +656,8 @@ void Traction::update() {
 
       // 🔒 MEJORA: Validación robusta con verificación de rango
       if (!isTempValid(t)) {
-        System::logError(820 + i); // códigos 820-823 para motores FL-RR
+        System::logError(820 + i, // códigos 820-823 para motores FL-RR
+                         ErrorJournal::contextOf(t));
         Logger::errorf("Traction: temperatura inválida rueda %d: %.1f°C (rango "
                        "%.0f-%.0f°C)",
                        i, t, TEMP_MIN_VALID, TEMP_MAX_VALID);
@@ -663,7 +668,8 @@ void Traction::update() {
         if (t > TEMP_EMERGENCY_SHUTDOWN) {
           Logger::errorf(
               "EMERGENCY: Motor %d temp %.1f°C - IMMEDIATE SHUTDOWN!", i, t);
-          System::logError(825 + i); // Códigos 825-828 para emergency shutdown
+          System::logError(825 + i, // Códigos 825-828 para emergency shutdown
+                           ErrorJournal::contextOf(t));
 
           // Detener motor inmediatamente con hardware cutoff
           s.w[i].demandPct = 0.0f;
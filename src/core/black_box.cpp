@@ -0,0 +1,328 @@
+// black_box.cpp - Control-loop black box recorder with pre-trigger window
+#include "black_box.h"
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+
+namespace BlackBox {
+
+using FlashJournal::SECTOR_SIZE;
+
+static_assert((RING_SAMPLES & (RING_SAMPLES - 1)) == 0, "RING_SAMPLES: 2^n");
+static_assert(WINDOW_SAMPLES < RING_SAMPLES, "window must fit the ring");
+static_assert(sizeof(DumpHeader) + WINDOW_SAMPLES * sizeof(Sample) <=
+                  SLOT_SECTORS * SECTOR_SIZE,
+              "window must fit a slot");
+
+constexpr uint32_t RING_MASK = RING_SAMPLES - 1;
+constexpr uint8_t MAX_SLOTS = 16;
+
+static FlashJournal::FlashDevice *dev = nullptr;
+static Sample *ring = nullptr;
+static Sample *stage = nullptr; // Frozen window being written
+static bool mounted = false;
+static uint8_t slots = 0;
+
+// ============================================================================
+// Producer state (record(), control job)
+// ============================================================================
+
+static std::atomic<uint32_t> head{0}; // Samples written so far
+static std::atomic<uint8_t> pendingTrigger{TRIGGER_NONE};
+static std::atomic<State> state{State::RECORDING};
+static uint32_t triggerIndex = 0;
+static uint8_t triggerReason = TRIGGER_NONE;
+// Window published with state FROZEN
+static uint32_t windowStart = 0;
+static uint16_t windowPre = 0;
+
+static uint32_t samples = 0;
+static uint32_t triggers = 0;
+static std::atomic<uint32_t> coalesced{0};
+
+// ============================================================================
+// Consumer state (service(), journal job)
+// ============================================================================
+
+static uint8_t nextSlot = 0;
+static uint32_t nextSeq = 1;
+static uint8_t erasedSectors = 0; // Of nextSlot, erased ahead of a dump
+static uint32_t writeOffset = 0;  // Sample bytes of stage already written
+static DumpHeader pendingHeader;
+static uint32_t dumps = 0;
+static uint32_t overruns = 0;
+static uint32_t writeErrors = 0;
+
+static uint32_t slotAddr(uint8_t slot) {
+  return uint32_t(slot) * SLOT_SECTORS * SECTOR_SIZE;
+}
+
+static uint32_t headerCrc(const DumpHeader &h) {
+  return FlashJournal::crc32(0, &h, offsetof(DumpHeader, crc));
+}
+
+static bool readHeader(uint8_t slot, DumpHeader &h) {
+  if (!dev->read(slotAddr(slot), &h, sizeof(h))) return false;
+  return h.magic == DUMP_MAGIC && h.version == FORMAT_VERSION &&
+         h.sampleSize == sizeof(Sample) && h.sampleCount <= WINDOW_SAMPLES &&
+         h.preSamples < h.sampleCount && h.crc == headerCrc(h);
+}
+
+bool begin(FlashJournal::FlashDevice &device, Sample *ringBuffer,
+           Sample *stageBuffer) {
+  end();
+  uint32_t n = device.sectorCount() / SLOT_SECTORS;
+  if (n == 0 || ringBuffer == nullptr || stageBuffer == nullptr) return false;
+
+  dev = &device;
+  ring = ringBuffer;
+  stage = stageBuffer;
+  slots = n > MAX_SLOTS ? MAX_SLOTS : uint8_t(n);
+
+  // Continue after the newest dump
+  uint32_t maxSeq = 0;
+  for (uint8_t s = 0; s < slots; s++) {
+    DumpHeader h;
+    if (readHeader(s, h) && h.seq >= maxSeq) {
+      maxSeq = h.seq;
+      nextSlot = (s + 1) % slots;
+    }
+  }
+  nextSeq = maxSeq + 1;
+  mounted = true;
+  return true;
+}
+
+void end() {
+  mounted = false;
+  dev = nullptr;
+  ring = nullptr;
+  stage = nullptr;
+  slots = 0;
+  head.store(0, std::memory_order_relaxed);
+  pendingTrigger.store(TRIGGER_NONE, std::memory_order_relaxed);
+  state.store(State::RECORDING, std::memory_order_relaxed);
+  triggerIndex = windowStart = 0;
+  triggerReason = TRIGGER_NONE;
+  windowPre = 0;
+  samples = triggers = 0;
+  coalesced.store(0, std::memory_order_relaxed);
+  nextSlot = 0;
+  nextSeq = 1;
+  erasedSectors = 0;
+  writeOffset = 0;
+  dumps = overruns = writeErrors = 0;
+}
+
+bool isMounted() { return mounted; }
+
+// ============================================================================
+// Producer
+// ============================================================================
+
+void record(const Sample &sample) {
+  if (!mounted) return;
+  uint32_t n = head.load(std::memory_order_relaxed);
+  Sample &slot = ring[n & RING_MASK];
+  slot = sample;
+
+  uint8_t reason =
+      pendingTrigger.exchange(TRIGGER_NONE, std::memory_order_acquire);
+  slot.event = reason;
+  State st = state.load(std::memory_order_relaxed);
+  if (reason != TRIGGER_NONE) {
+    if (st == State::RECORDING) {
+      triggerIndex = n;
+      triggerReason = reason;
+      st = State::CAPTURING;
+      state.store(st, std::memory_order_relaxed);
+      triggers++;
+    } else {
+      coalesced.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+  head.store(n + 1, std::memory_order_release);
+  samples++;
+
+  if (st == State::CAPTURING && n - triggerIndex == POST_SAMPLES - 1u) {
+    // Right after boot fewer than PRE_SAMPLES precede the trigger
+    windowPre = triggerIndex < PRE_SAMPLES ? uint16_t(triggerIndex)
+                                           : PRE_SAMPLES;
+    windowStart = triggerIndex - windowPre;
+    state.store(State::FROZEN, std::memory_order_release);
+  }
+}
+
+void trigger(Trigger reason) {
+  if (reason == TRIGGER_NONE) return;
+  uint8_t expected = TRIGGER_NONE;
+  if (!pendingTrigger.compare_exchange_strong(expected, reason,
+                                              std::memory_order_release,
+                                              std::memory_order_relaxed)) {
+    coalesced.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+// ============================================================================
+// Consumer
+// ============================================================================
+
+// Copy the frozen window out of the ring. The producer keeps recording, so
+// the copy is valid only if the oldest sample was not overwritten meanwhile
+// (seqlock-style check on head after the copy).
+static bool stageWindow() {
+  uint16_t count = windowPre + POST_SAMPLES;
+  for (uint16_t i = 0; i < count; i++) {
+    stage[i] = ring[(windowStart + i) & RING_MASK];
+  }
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (head.load(std::memory_order_relaxed) - windowStart >= RING_SAMPLES) {
+    overruns++;
+    return false;
+  }
+
+  DumpHeader &h = pendingHeader;
+  memset(&h, 0, sizeof(h));
+  h.magic = DUMP_MAGIC;
+  h.version = FORMAT_VERSION;
+  h.sampleSize = sizeof(Sample);
+  h.seq = nextSeq;
+  h.triggerMs = stage[windowPre].tickMs;
+  h.trigger = triggerReason;
+  h.preSamples = windowPre;
+  h.sampleCount = count;
+  h.dataCrc = FlashJournal::crc32(0, stage, count * sizeof(Sample));
+  h.crc = headerCrc(h);
+  writeOffset = 0;
+  return true;
+}
+
+static bool sectorBlank(uint32_t sector) {
+  uint32_t words[64];
+  for (uint32_t off = 0; off < SECTOR_SIZE; off += sizeof(words)) {
+    if (!dev->read(sector * SECTOR_SIZE + off, words, sizeof(words))) {
+      return false;
+    }
+    for (uint32_t w : words) {
+      if (w != 0xFFFFFFFFu) return false;
+    }
+  }
+  return true;
+}
+
+static void abandonDump() {
+  writeErrors++;
+  erasedSectors = 0; // Slot content unknown: erase again
+  state.store(State::RECORDING, std::memory_order_release);
+}
+
+bool service() {
+  if (!mounted) return false;
+
+  State st = state.load(std::memory_order_acquire);
+  if (st == State::FROZEN) {
+    if (!stageWindow()) {
+      state.store(State::RECORDING, std::memory_order_release);
+      return false;
+    }
+    st = State::WRITING;
+    state.store(st, std::memory_order_release);
+  }
+
+  // Erase ahead: the next slot is kept erased while idle, so a dump is
+  // mostly sector writes. Sectors already blank (e.g. after a reboot) are
+  // not erased again.
+  uint32_t base = slotAddr(nextSlot);
+  uint32_t first = uint32_t(nextSlot) * SLOT_SECTORS;
+  while (erasedSectors < SLOT_SECTORS && sectorBlank(first + erasedSectors)) {
+    erasedSectors++;
+  }
+  if (erasedSectors < SLOT_SECTORS) {
+    if (!dev->eraseSector(first + erasedSectors)) {
+      if (st == State::WRITING) {
+        abandonDump();
+      } else {
+        writeErrors++;
+      }
+      return true;
+    }
+    erasedSectors++;
+    return true;
+  }
+  if (st != State::WRITING) return false;
+
+  uint32_t total = uint32_t(pendingHeader.sampleCount) * sizeof(Sample);
+  if (writeOffset < total) {
+    uint32_t len = total - writeOffset;
+    if (len > SECTOR_SIZE) len = SECTOR_SIZE;
+    const uint8_t *src = reinterpret_cast<const uint8_t *>(stage);
+    if (!dev->write(base + sizeof(DumpHeader) + writeOffset,
+                    src + writeOffset, len)) {
+      abandonDump();
+      return true;
+    }
+    writeOffset += len;
+    return true;
+  }
+
+  // Header last: the dump exists only once it is complete
+  if (!dev->write(base, &pendingHeader, sizeof(pendingHeader))) {
+    abandonDump();
+    return true;
+  }
+  dumps++;
+  nextSeq++;
+  nextSlot = (nextSlot + 1) % slots;
+  erasedSectors = 0;
+  state.store(State::RECORDING, std::memory_order_release);
+  return true;
+}
+
+State getState() { return state.load(std::memory_order_acquire); }
+
+// ============================================================================
+// Readback
+// ============================================================================
+
+uint8_t listDumps(DumpInfo *out, uint8_t max) {
+  if (!mounted) return 0;
+  uint8_t n = 0;
+  for (uint8_t s = 0; s < slots; s++) {
+    DumpHeader h;
+    if (!readHeader(s, h)) continue;
+    DumpInfo d = {s, h.seq, h.triggerMs, h.trigger, h.preSamples,
+                  h.sampleCount};
+    // Insertion by descending seq, keeping the newest max entries
+    uint8_t at = n < max ? n++ : max;
+    while (at > 0 && out[at - 1].seq < d.seq) {
+      if (at < max) out[at] = out[at - 1];
+      at--;
+    }
+    if (at < max) out[at] = d;
+  }
+  return n;
+}
+
+bool readSample(const DumpInfo &dump, uint16_t index, Sample &out) {
+  if (!mounted || dump.slot >= slots || index >= dump.sampleCount) {
+    return false;
+  }
+  return dev->read(slotAddr(dump.slot) + sizeof(DumpHeader) +
+                       uint32_t(index) * sizeof(Sample),
+                   &out, sizeof(out));
+}
+
+void getStats(Stats &out) {
+  out.mounted = mounted;
+  out.state = state.load(std::memory_order_relaxed);
+  out.slots = slots;
+  out.nextSlot = nextSlot;
+  out.samples = samples;
+  out.triggers = triggers;
+  out.coalesced = coalesced.load(std::memory_order_relaxed);
+  out.dumps = dumps;
+  out.overruns = overruns;
+  out.writeErrors = writeErrors;
+}
+
+} // namespace BlackBox
@@ -0,0 +1,164 @@
+// black_box_device.cpp - BlackBox on PSRAM and the "blackbox" partition
+#include "abs_system.h"
+#include "black_box.h"
+#include "current.h"
+#include "limp_mode.h"
+#include "logger.h"
+#include "obstacle_safety.h"
+#include "pedal.h"
+#include "steering.h"
+#include "steering_motor.h"
+#include "tcs_system.h"
+#include "traction.h"
+#include "wheels.h"
+#include <Arduino.h>
+#include <cmath>
+#include <esp_heap_caps.h>
+#include <esp_partition.h>
+
+namespace BlackBox {
+
+// Custom data subtype, next to the journal's 0x40
+static const esp_partition_subtype_t PARTITION_SUBTYPE =
+    static_cast<esp_partition_subtype_t>(0x41);
+static const char *PARTITION_LABEL = "blackbox";
+
+class PartitionFlash : public FlashJournal::FlashDevice {
+public:
+  explicit PartitionFlash(const esp_partition_t *p) : part(p) {}
+
+  uint32_t sectorCount() const override {
+    return part->size / FlashJournal::SECTOR_SIZE;
+  }
+
+  bool read(uint32_t addr, void *dst, uint32_t len) override {
+    return esp_partition_read(part, addr, dst, len) == ESP_OK;
+  }
+
+  bool write(uint32_t addr, const void *src, uint32_t len) override {
+    return esp_partition_write(part, addr, src, len) == ESP_OK;
+  }
+
+  bool eraseSector(uint32_t sector) override {
+    return esp_partition_erase_range(part, sector * FlashJournal::SECTOR_SIZE,
+                                     FlashJournal::SECTOR_SIZE) == ESP_OK;
+  }
+
+private:
+  const esp_partition_t *part;
+};
+
+bool initDevice() {
+  const esp_partition_t *part = esp_partition_find_first(
+      ESP_PARTITION_TYPE_DATA, PARTITION_SUBTYPE, PARTITION_LABEL);
+  if (part == nullptr) {
+    Logger::warn("BlackBox: partición 'blackbox' no encontrada");
+    return false;
+  }
+  if (!psramFound()) {
+    Logger::warn("BlackBox: sin PSRAM, grabador desactivado");
+    return false;
+  }
+
+  // ~80 KB ring + ~60 KB stage: PSRAM only, never internal RAM
+  Sample *ringBuf = (Sample *)heap_caps_malloc(
+      RING_SAMPLES * sizeof(Sample), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  Sample *stageBuf = (Sample *)heap_caps_malloc(
+      WINDOW_SAMPLES * sizeof(Sample), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (ringBuf == nullptr || stageBuf == nullptr) {
+    Logger::error("BlackBox: sin memoria PSRAM para el buffer");
+    heap_caps_free(ringBuf);
+    heap_caps_free(stageBuf);
+    return false;
+  }
+
+  static PartitionFlash device(part);
+  if (!begin(device, ringBuf, stageBuf)) {
+    Logger::error("BlackBox: partición demasiado pequeña");
+    heap_caps_free(ringBuf);
+    heap_caps_free(stageBuf);
+    return false;
+  }
+
+  DumpInfo latest;
+  Stats st;
+  getStats(st);
+  if (listDumps(&latest, 1) == 1) {
+    Logger::infof("BlackBox: %u slots, último volcado #%lu (disparo %u)",
+                  st.slots, (unsigned long)latest.seq, latest.trigger);
+  } else {
+    Logger::infof("BlackBox: %u slots, sin volcados", st.slots);
+  }
+  return true;
+}
+
+// ============================================================================
+// Snapshot (control job, 100 Hz): cached values only, no bus access
+// ============================================================================
+
+// Fixed-point with saturation; NaN maps to the minimum so it stands out
+static int16_t toI16(float v, float scale) {
+  if (std::isnan(v)) return INT16_MIN;
+  float s = v * scale;
+  if (s >= 32767.0f) return INT16_MAX;
+  if (s <= -32767.0f) return -INT16_MAX;
+  return static_cast<int16_t>(lroundf(s));
+}
+
+static uint16_t toU16(float v, float scale) {
+  if (std::isnan(v)) return UINT16_MAX;
+  float s = v * scale;
+  if (s >= 65534.0f) return 65534;
+  if (s <= 0.0f) return 0;
+  return static_cast<uint16_t>(lroundf(s));
+}
+
+void capture() {
+  if (!isMounted()) return;
+
+  const Pedal::State &pedal = Pedal::get();
+  const Steering::State &steering = Steering::get();
+  const Traction::State &traction = Traction::get();
+  const SteeringMotor::State &steerMotor = SteeringMotor::get();
+  const ABSSystem::State &abs = ABSSystem::getState();
+  const TCSSystem::State &tcs = TCSSystem::getState();
+
+  Sample s;
+  s.tickMs = millis();
+  s.pedalPermille = toU16(pedal.percent, 10.0f);
+  s.steeringDeciDeg = toI16(steering.angleDeg, 10.0f);
+  s.batteryDeciA = toI16(Sensors::getCurrent(0), 10.0f);
+  s.steeringDeciA = toI16(steerMotor.currentA, 10.0f);
+  s.steeringPwm = toI16(steerMotor.pwmOut, 1.0f);
+  s.limpState = static_cast<uint8_t>(LimpMode::getState());
+  s.wheelMask = 0;
+  s.flags = 0;
+  s.event = TRIGGER_NONE;
+  s.reserved = 0;
+
+  bool reverse = false;
+  for (uint8_t i = 0; i < 4; i++) {
+    const Traction::WheelState &w = traction.w[i];
+    s.wheelCentiKmh[i] = toU16(Sensors::getWheelSpeed(i), 100.0f);
+    s.motorDeciA[i] = toI16(w.currentA, 10.0f);
+    uint16_t pwm = toU16(w.outPWM, 1.0f);
+    s.motorPwm[i] = pwm > 255 ? 255 : static_cast<uint8_t>(pwm);
+    if (abs.wheels[i].active) s.wheelMask |= 1 << i;
+    if (tcs.wheels[i].active) s.wheelMask |= 1 << (i + 4);
+    reverse |= w.reverse;
+  }
+
+  if (pedal.valid) s.flags |= FLAG_PEDAL_VALID;
+  if (steering.valid) s.flags |= FLAG_STEERING_VALID;
+  if (abs.systemActive) s.flags |= FLAG_ABS_ACTIVE;
+  if (tcs.systemActive) s.flags |= FLAG_TCS_ACTIVE;
+  if (ObstacleSafety::isEmergencyBrakeApplied()) {
+    s.flags |= FLAG_EMERGENCY_BRAKE;
+  }
+  if (traction.enabled4x4) s.flags |= FLAG_4X4;
+  if (reverse) s.flags |= FLAG_REVERSE;
+
+  record(s);
+}
+
+} // namespace BlackBox
@@ -0,0 +1,159 @@
+// boot_graph.cpp - Boot dependency-graph planner (pure, host-testable)
+#include "boot_graph.h"
+
+namespace BootGraph {
+
+static uint32_t stepMask(uint8_t count) {
+  return count >= 32 ? 0xFFFFFFFFu : (1u << count) - 1;
+}
+
+bool validate(const Step *steps, uint8_t count) {
+  if (steps == nullptr || count == 0 || count > MAX_STEPS) return false;
+
+  uint32_t all = stepMask(count);
+  for (uint8_t i = 0; i < count; i++) {
+    if (steps[i].fn == nullptr) return false;
+    if (steps[i].deps & ~all) return false; // Unknown step
+    if (steps[i].deps & dep(i)) return false;
+  }
+
+  // Kahn: peel off steps whose deps are all resolved; a cycle stalls
+  uint32_t resolved = 0;
+  while (resolved != all) {
+    uint32_t layer = 0;
+    for (uint8_t i = 0; i < count; i++) {
+      if (!(resolved & dep(i)) && (steps[i].deps & ~resolved) == 0) {
+        layer |= dep(i);
+      }
+    }
+    if (layer == 0) return false;
+    resolved |= layer;
+  }
+  return true;
+}
+
+// Steps whose dependencies can no longer succeed are skipped
+static void propagateSkips(Plan &plan) {
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    uint32_t dead = 0;
+    for (uint8_t i = 0; i < plan.count; i++) {
+      StepState s = plan.rec[i].state;
+      if (s == StepState::FAILED || s == StepState::SKIPPED) dead |= dep(i);
+    }
+    for (uint8_t i = 0; i < plan.count; i++) {
+      if (plan.rec[i].state == StepState::PENDING &&
+          (plan.steps[i].deps & dead)) {
+        plan.rec[i].state = StepState::SKIPPED;
+        changed = true;
+      }
+    }
+  }
+}
+
+void reset(Plan &plan, const Step *steps, uint8_t count, const Options &opt) {
+  plan.steps = steps;
+  plan.count = count > MAX_STEPS ? MAX_STEPS : count;
+  plan.critical = opt.critical;
+  plan.busyBuses = 0;
+  plan.running = 0;
+  plan.aborted = false;
+  for (uint8_t i = 0; i < MAX_STEPS; i++) {
+    plan.rec[i] = {StepState::PENDING, ANY_CORE, 0, 0};
+    if (i < plan.count && (opt.skip & dep(i))) {
+      plan.rec[i].state = StepState::SKIPPED;
+    }
+  }
+  propagateSkips(plan);
+}
+
+int8_t next(Plan &plan, uint8_t core, uint32_t nowUs) {
+  if (plan.aborted) return -1;
+
+  uint32_t done = 0;
+  for (uint8_t i = 0; i < plan.count; i++) {
+    if (plan.rec[i].state == StepState::DONE) done |= dep(i);
+  }
+
+  for (uint8_t i = 0; i < plan.count; i++) {
+    const Step &s = plan.steps[i];
+    if (plan.rec[i].state != StepState::PENDING) continue;
+    if ((s.deps & ~done) != 0) continue;
+    if (s.buses & plan.busyBuses) continue;
+    if (core != ANY_CORE && s.core != ANY_CORE && s.core != core) continue;
+
+    plan.rec[i].state = StepState::RUNNING;
+    plan.rec[i].core = core;
+    plan.rec[i].startUs = nowUs;
+    plan.busyBuses |= s.buses;
+    plan.running++;
+    return static_cast<int8_t>(i);
+  }
+  return -1;
+}
+
+void complete(Plan &plan, uint8_t idx, bool ok, uint32_t nowUs) {
+  if (idx >= plan.count || plan.rec[idx].state != StepState::RUNNING) return;
+
+  plan.rec[idx].state = ok ? StepState::DONE : StepState::FAILED;
+  plan.rec[idx].endUs = nowUs;
+  plan.busyBuses &= ~plan.steps[idx].buses;
+  plan.running--;
+
+  if (!ok) {
+    if (plan.critical & dep(idx)) plan.aborted = true;
+    propagateSkips(plan);
+  }
+}
+
+bool finished(const Plan &plan) {
+  if (plan.running > 0) return false;
+  if (plan.aborted) return true;
+  for (uint8_t i = 0; i < plan.count; i++) {
+    if (plan.rec[i].state == StepState::PENDING) return false;
+  }
+  return true;
+}
+
+int8_t failedCritical(const Plan &plan) {
+  for (uint8_t i = 0; i < plan.count; i++) {
+    if (plan.rec[i].state == StepState::FAILED && (plan.critical & dep(i))) {
+      return static_cast<int8_t>(i);
+    }
+  }
+  return NO_FAILURE;
+}
+
+static bool ran(const StepRecord &r) {
+  return r.state == StepState::DONE || r.state == StepState::FAILED;
+}
+
+uint32_t serialUs(const Plan &plan) {
+  uint32_t total = 0;
+  for (uint8_t i = 0; i < plan.count; i++) {
+    if (ran(plan.rec[i])) total += plan.rec[i].endUs - plan.rec[i].startUs;
+  }
+  return total;
+}
+
+uint32_t makespanUs(const Plan &plan) {
+  bool any = false;
+  uint32_t first = 0, last = 0;
+  for (uint8_t i = 0; i < plan.count; i++) {
+    const StepRecord &r = plan.rec[i];
+    if (!ran(r)) continue;
+    if (!any) {
+      first = r.startUs;
+      last = r.endUs;
+      any = true;
+      continue;
+    }
+    // Wrap-safe comparisons on micros()
+    if (static_cast<int32_t>(r.startUs - first) < 0) first = r.startUs;
+    if (static_cast<int32_t>(r.endUs - last) > 0) last = r.endUs;
+  }
+  return last - first;
+}
+
+} // namespace BootGraph
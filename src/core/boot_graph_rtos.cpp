@@ -0,0 +1,162 @@
+// boot_graph_rtos.cpp - BootGraph runner: one worker per core + timeline
+#include "boot_graph.h"
+#include "logger.h"
+#include "watchdog.h"
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+namespace BootGraph {
+
+// The helper runs manager init code (HUD sprites, I2C drivers); same stack
+// as the Arduino loop task that runs the other worker
+constexpr uint32_t HELPER_STACK = 8192;
+// Upper bound on a worker sleep; wake-ups normally come from notifications
+constexpr uint32_t IDLE_WAIT_MS = 10;
+
+static Plan plan;
+static portMUX_TYPE planMux = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t workers[2] = {nullptr, nullptr};
+static volatile bool helperDone = false;
+static uint32_t runStartUs = 0;
+
+static void wakeWorkers() {
+  for (TaskHandle_t w : workers) {
+    if (w != nullptr) xTaskNotifyGive(w);
+  }
+}
+
+// Pulls runnable steps until the graph finishes. `core` is ANY_CORE when a
+// single worker has to run everything (helper could not be created).
+static void work(uint8_t core) {
+  for (;;) {
+    portENTER_CRITICAL(&planMux);
+    int8_t idx = next(plan, core, micros());
+    if (idx >= 0) plan.rec[idx].core = (uint8_t)xPortGetCoreID();
+    bool done = idx < 0 && finished(plan);
+    portEXIT_CRITICAL(&planMux);
+
+    if (done) break;
+    if (idx < 0) {
+      ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(IDLE_WAIT_MS));
+      continue;
+    }
+
+    bool ok = plan.steps[idx].fn();
+    Watchdog::feed();
+
+    portENTER_CRITICAL(&planMux);
+    complete(plan, idx, ok, micros());
+    portEXIT_CRITICAL(&planMux);
+    wakeWorkers();
+  }
+}
+
+static void helperTask(void *arg) {
+  work(static_cast<uint8_t>(reinterpret_cast<uintptr_t>(arg)));
+  helperDone = true;
+  wakeWorkers();
+  vTaskDelete(nullptr);
+}
+
+int8_t run(const Step *steps, uint8_t count, const Options &opt) {
+  if (!validate(steps, count)) {
+    Logger::error("BootGraph: grafo inválido (dependencia o ciclo)");
+    return INVALID_GRAPH;
+  }
+
+  reset(plan, steps, count, opt);
+  runStartUs = micros();
+  helperDone = false;
+
+  uint8_t self = static_cast<uint8_t>(xPortGetCoreID());
+  uint8_t other = self == 0 ? 1 : 0;
+  workers[self] = xTaskGetCurrentTaskHandle();
+  workers[other] = nullptr;
+
+  TaskHandle_t helper = nullptr;
+  BaseType_t created = xTaskCreatePinnedToCore(
+      helperTask, "BootGraph", HELPER_STACK,
+      reinterpret_cast<void *>(static_cast<uintptr_t>(other)),
+      uxTaskPriorityGet(nullptr), &helper, other);
+
+  if (created == pdPASS) {
+    portENTER_CRITICAL(&planMux);
+    workers[other] = helper;
+    portEXIT_CRITICAL(&planMux);
+    work(self);
+    while (!helperDone) {
+      ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(IDLE_WAIT_MS));
+    }
+  } else {
+    Logger::warn("BootGraph: sin tarea auxiliar, arranque secuencial");
+    work(ANY_CORE);
+  }
+  workers[self] = nullptr;
+  workers[other] = nullptr;
+
+  return failedCritical(plan);
+}
+
+const Plan &lastRun() { return plan; }
+
+static const char *stateName(StepState s) {
+  switch (s) {
+  case StepState::DONE:
+    return "OK";
+  case StepState::FAILED:
+    return "FALLO";
+  case StepState::SKIPPED:
+    return "omitido";
+  case StepState::RUNNING:
+    return "en curso";
+  default:
+    return "pendiente";
+  }
+}
+
+static void busNames(uint8_t buses, char *out, size_t len) {
+  static const char *const NAMES[] = {"I2C", "SPI", "1W", "UART", "FLASH"};
+  size_t pos = 0;
+  out[0] = '\0';
+  for (uint8_t b = 0; b < 5; b++) {
+    if (!(buses & (1u << b))) continue;
+    int n = snprintf(out + pos, len - pos, "%s%s", pos ? "+" : "", NAMES[b]);
+    if (n < 0 || static_cast<size_t>(n) >= len - pos) break;
+    pos += n;
+  }
+  if (pos == 0) snprintf(out, len, "-");
+}
+
+void printTimeline() {
+  uint32_t span = makespanUs(plan);
+  uint32_t serial = serialUs(plan);
+  Logger::infof("Boot: %u pasos, %lu.%lu ms en paralelo (secuencial %lu.%lu "
+                "ms), listo a %lu ms del encendido",
+                plan.count, (unsigned long)(span / 1000),
+                (unsigned long)(span % 1000 / 100),
+                (unsigned long)(serial / 1000),
+                (unsigned long)(serial % 1000 / 100),
+                (unsigned long)millis());
+
+  for (uint8_t i = 0; i < plan.count; i++) {
+    const StepRecord &r = plan.rec[i];
+    char buses[24];
+    busNames(plan.steps[i].buses, buses, sizeof(buses));
+    if (r.state != StepState::DONE && r.state != StepState::FAILED) {
+      Logger::infof("Boot:  %-12s  --  %-9s %s", plan.steps[i].name, buses,
+                    stateName(r.state));
+      continue;
+    }
+    uint32_t start = r.startUs - runStartUs;
+    uint32_t dur = r.endUs - r.startUs;
+    Logger::infof("Boot:  %-12s C%c %-9s +%5lu.%lu ms %6lu.%lu ms %s",
+                  plan.steps[i].name, r.core == ANY_CORE ? '?' : '0' + r.core,
+                  buses, (unsigned long)(start / 1000),
+                  (unsigned long)(start % 1000 / 100),
+                  (unsigned long)(dur / 1000),
+                  (unsigned long)(dur % 1000 / 100), stateName(r.state));
+  }
+}
+
+} // namespace BootGraph
@@ -0,0 +1,455 @@
+// config_store.cpp - Unified typed configuration store (engine)
+#include "config_store.h"
+#include "config_store_legacy.h"
+#include "settings.h"
+#include <cstring>
+
+namespace ConfigStore {
+
+// ============================================================================
+// Defaults (values of the legacy systems that were actually used)
+// ============================================================================
+
+static const Settings DEFAULTS = {
+    // vehicle
+    {200, 3800, 0, REGEN_DEFAULT, {0.0010f, 0.0020f, 0.0020f, 0.0020f, 0.0020f,
+                                   0.0020f},
+     0, 100.0f, 50.0f, true, false},
+    // hud
+    {true, true, DISPLAY_BRIGHTNESS_DEFAULT, true, {200, 3900, 200, 3900, 3},
+     false, false},
+    // sensors (módulos deshabilitados hasta confirmar hardware)
+    {false, false, false, {true, true, true, true}, true,
+     {true, true, true, true, true, true}, true},
+    // encoder
+    {600, 0, 1200, false},
+    // power
+    {5000, 100, 500, 3000, true},
+    // leds (off: the strips never lit before LEDController::init was wired
+    // into boot)
+    {0, 128, 128, 0xFF0000, false},
+    // general (ABS/TCS/regen off: the boot path the cars actually took,
+    // since the legacy GeneralSettings namespace was never written)
+    {true, 15, false, false, false, true, 1, true, 8989, 30, 15, 20, "", true},
+    // obstacle
+    {200, 500, 1000, true, true, true},
+    // maintenance
+    {{0.0f, 0.0f, 0.0f, 0, 0}, 500, 180},
+    // errors
+    {{}, 0},
+};
+
+// ============================================================================
+// Schema: one NVS key per field
+// ============================================================================
+
+struct Field {
+  Section section;
+  const char *key; // <= 15 chars (NVS limit)
+  ValueType type;
+  uint16_t offset; // In Settings
+  uint16_t size;
+  int32_t min; // Valid range for integer fields (min > max: unchecked)
+  int32_t max;
+};
+
+#define RANGED(sec, member, key, type, lo, hi)                                 \
+  {SECTION_##sec,         key,                                                 \
+   ValueType::type,       (uint16_t)offsetof(Settings, member),                \
+   (uint16_t)sizeof(((Settings *)nullptr)->member), lo, hi}
+#define FIELD(sec, member, key, type) RANGED(sec, member, key, type, 1, 0)
+#define FLAG(sec, member, key) RANGED(sec, member, key, U8, 0, 1)
+
+static const Field SCHEMA[] = {
+    FIELD(VEHICLE, vehicle.pedalMin, "pedal_min", I32),
+    FIELD(VEHICLE, vehicle.pedalMax, "pedal_max", I32),
+    FIELD(VEHICLE, vehicle.pedalCurve, "pedal_curve", U8),
+    RANGED(VEHICLE, vehicle.regenPercent, "regen_pct", U8, 0, 100),
+    FIELD(VEHICLE, vehicle.shuntCoeff, "shunt_coeff", BLOB),
+    FIELD(VEHICLE, vehicle.steerZeroOffset, "steer_zero", I32),
+    FIELD(VEHICLE, vehicle.maxBatteryCurrentA, "max_bat_a", BLOB),
+    FIELD(VEHICLE, vehicle.maxMotorCurrentA, "max_motor_a", BLOB),
+    FLAG(VEHICLE, vehicle.tractionEnabled, "traction_en"),
+    FLAG(VEHICLE, vehicle.steeringEnabled, "steering_en"),
+
+    FLAG(HUD, hud.showTemps, "show_temps"),
+    FLAG(HUD, hud.showEffort, "show_effort"),
+    FIELD(HUD, hud.displayBrightness, "brightness", U8),
+    FLAG(HUD, hud.touchEnabled, "touch_en"),
+    FIELD(HUD, hud.touchCalibration, "touch_cal", BLOB),
+    FLAG(HUD, hud.touchCalibrated, "touch_cal_ok"),
+    FLAG(HUD, hud.shadowHudEnabled, "shadow_hud"),
+
+    FLAG(SENSORS, sensors.wheelSensorsEnabled, "wheel_mod_en"),
+    FLAG(SENSORS, sensors.tempSensorsEnabled, "temp_mod_en"),
+    FLAG(SENSORS, sensors.currentSensorsEnabled, "curr_mod_en"),
+    FIELD(SENSORS, sensors.wheel, "wheel_en", BLOB),
+    FLAG(SENSORS, sensors.ina226Enabled, "ina_en"),
+    FIELD(SENSORS, sensors.ina226Channel, "ina_ch_en", BLOB),
+    FLAG(SENSORS, sensors.encoderEnabled, "encoder_en"),
+
+    FIELD(ENCODER, encoder.center, "enc_center", I16),
+    FIELD(ENCODER, encoder.leftLimit, "enc_left", I16),
+    FIELD(ENCODER, encoder.rightLimit, "enc_right", I16),
+    FLAG(ENCODER, encoder.calibrated, "enc_cal"),
+
+    RANGED(POWER, power.holdDelayMs, "pwr_hold", U16, 100, 10000),
+    RANGED(POWER, power.auxDelayMs, "pwr_aux", U16, 10, 10000),
+    RANGED(POWER, power.tractionDelayMs, "pwr_traction", U16, 10, 10000),
+    RANGED(POWER, power.shutdownDelayMs, "pwr_shutdown", U16, 10, 15000),
+    FLAG(POWER, power.autoShutdown, "pwr_auto_off"),
+
+    RANGED(LEDS, leds.pattern, "led_pattern", U8, 0, 10),
+    FIELD(LEDS, leds.brightness, "led_bright", U8),
+    FIELD(LEDS, leds.speed, "led_speed", U8),
+    FIELD(LEDS, leds.color, "led_color", U32),
+    FLAG(LEDS, leds.enabled, "led_en"),
+
+    FLAG(GENERAL, general.audioEnabled, "audio_en"),
+    RANGED(GENERAL, general.volume, "volume", U8, 0, 100),
+    FLAG(GENERAL, general.absEnabled, "abs_en"),
+    FLAG(GENERAL, general.tcsEnabled, "tcs_en"),
+    FLAG(GENERAL, general.regenEnabled, "regen_en"),
+    FLAG(GENERAL, general.wifiEnabled, "wifi_en"),
+    RANGED(GENERAL, general.driveMode, "drive_mode", U8, 0, 3),
+    FLAG(GENERAL, general.menuPinEnabled, "pin_en"),
+    FIELD(GENERAL, general.menuPin, "menu_pin", U16),
+    RANGED(GENERAL, general.menuTimeoutSec, "menu_timeout", U16, 5, 600),
+    RANGED(GENERAL, general.absSlipThreshold, "abs_slip", U8, 0, 100),
+    RANGED(GENERAL, general.tcsSlipThreshold, "tcs_slip", U8, 0, 100),
+    FIELD(GENERAL, general.btMacAddress, "bt_mac", BLOB),
+    FLAG(GENERAL, general.btAutoReconnect, "bt_reconnect"),
+
+    FIELD(OBSTACLE, obstacle.criticalMm, "obs_crit", U16),
+    FIELD(OBSTACLE, obstacle.warningMm, "obs_warn", U16),
+    FIELD(OBSTACLE, obstacle.cautionMm, "obs_caut", U16),
+    FLAG(OBSTACLE, obstacle.sensorEnabled, "obs_sensor"),
+    FLAG(OBSTACLE, obstacle.audioAlerts, "obs_audio"),
+    FLAG(OBSTACLE, obstacle.visualAlerts, "obs_visual"),
+
+    FIELD(MAINTENANCE, maintenance.odometer, "odometer", BLOB),
+    FIELD(MAINTENANCE, maintenance.intervalKm, "svc_km", U16),
+    FIELD(MAINTENANCE, maintenance.intervalDays, "svc_days", U16),
+
+    FIELD(ERRORS, errors.entries, "errors", BLOB),
+    RANGED(ERRORS, errors.count, "error_count", I32, 0, MAX_ERRORS),
+};
+
+#undef FLAG
+#undef FIELD
+#undef RANGED
+
+constexpr size_t FIELD_COUNT = sizeof(SCHEMA) / sizeof(SCHEMA[0]);
+static const char *const KEY_VERSION = "version";
+
+// Section extents inside Settings (for the persisted-copy snapshot)
+struct SectionExtent {
+  uint16_t offset;
+  uint16_t size;
+};
+static const SectionExtent EXTENTS[SECTION_COUNT] = {
+    {offsetof(Settings, vehicle), sizeof(Vehicle)},
+    {offsetof(Settings, hud), sizeof(Hud)},
+    {offsetof(Settings, sensors), sizeof(Sensors)},
+    {offsetof(Settings, encoder), sizeof(Encoder)},
+    {offsetof(Settings, power), sizeof(Power)},
+    {offsetof(Settings, leds), sizeof(Leds)},
+    {offsetof(Settings, general), sizeof(General)},
+    {offsetof(Settings, obstacle), sizeof(Obstacle)},
+    {offsetof(Settings, maintenance), sizeof(Maintenance)},
+    {offsetof(Settings, errors), sizeof(Errors)},
+};
+
+// ============================================================================
+// Migrations: each upgrades the in-RAM Settings from one version to the next.
+// The runner loads every section first and rewrites every field afterwards.
+// ============================================================================
+
+struct Migration {
+  uint16_t fromVersion;
+  bool (*apply)(Backend &backend, Settings &settings);
+};
+
+static uint8_t legacyLayouts = 0;
+
+static bool migrateLegacyLayouts(Backend &backend, Settings &settings) {
+  legacyLayouts = Legacy::importAll(backend, settings);
+  return true;
+}
+
+static const Migration MIGRATIONS[] = {
+    {0, migrateLegacyLayouts},
+};
+
+// ============================================================================
+// State
+// ============================================================================
+
+static Backend *backend = nullptr;
+static bool mounted = false;
+static Settings current;
+static Settings persisted; // Last value read from / written to NVS
+static bool loaded[SECTION_COUNT];
+static bool present[FIELD_COUNT];
+static bool forceWrite[FIELD_COUNT]; // Stored value rejected: rewrite it
+static Stats stats;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+static uint8_t *fieldPtr(Settings &s, const Field &f) {
+  return reinterpret_cast<uint8_t *>(&s) + f.offset;
+}
+
+static const uint8_t *fieldPtr(const Settings &s, const Field &f) {
+  return reinterpret_cast<const uint8_t *>(&s) + f.offset;
+}
+
+static bool inRange(const Field &f, const uint8_t *p) {
+  if (f.min > f.max) return true;
+  int64_t v = 0;
+  switch (f.type) {
+  case ValueType::U8:
+    v = *p;
+    break;
+  case ValueType::I8:
+    v = (int8_t)*p;
+    break;
+  case ValueType::U16: {
+    uint16_t x;
+    memcpy(&x, p, sizeof(x));
+    v = x;
+    break;
+  }
+  case ValueType::I16: {
+    int16_t x;
+    memcpy(&x, p, sizeof(x));
+    v = x;
+    break;
+  }
+  case ValueType::U32: {
+    uint32_t x;
+    memcpy(&x, p, sizeof(x));
+    v = x;
+    break;
+  }
+  case ValueType::I32: {
+    int32_t x;
+    memcpy(&x, p, sizeof(x));
+    v = x;
+    break;
+  }
+  case ValueType::BLOB:
+    return true;
+  }
+  return v >= f.min && v <= f.max;
+}
+
+// Replace out-of-range values with the default and schedule a rewrite
+static void validate(const Field &f, size_t index) {
+  if (inRange(f, fieldPtr(current, f))) return;
+  memcpy(fieldPtr(current, f), fieldPtr(DEFAULTS, f), f.size);
+  forceWrite[index] = true;
+  stats.rangeResets++;
+}
+
+static void onScanEntry(const char *key, ValueType, void *) {
+  for (size_t i = 0; i < FIELD_COUNT; i++) {
+    if (strcmp(SCHEMA[i].key, key) == 0) {
+      present[i] = true;
+      stats.keysFound++;
+      return;
+    }
+  }
+}
+
+static void loadSection(Section section) {
+  if (loaded[section]) return;
+  for (size_t i = 0; i < FIELD_COUNT; i++) {
+    const Field &f = SCHEMA[i];
+    if (f.section != section || !present[i]) continue;
+    // Read into a scratch copy so a failed read keeps the default
+    uint8_t buf[sizeof(Errors)];
+    stats.fieldReads++;
+    if (f.size > sizeof(buf) ||
+        !backend->read(NAMESPACE, f.key, f.type, buf, f.size)) {
+      // Wrong type/size: keep the default and rewrite the key
+      forceWrite[i] = true;
+      stats.rangeResets++;
+      continue;
+    }
+    memcpy(fieldPtr(current, f), buf, f.size);
+    validate(f, i);
+  }
+  const SectionExtent &e = EXTENTS[section];
+  memcpy(reinterpret_cast<uint8_t *>(&persisted) + e.offset,
+         reinterpret_cast<const uint8_t *>(&current) + e.offset, e.size);
+  loaded[section] = true;
+  stats.sectionsLoaded++;
+}
+
+// Write changed fields of a section; sets wrote if any key was written
+static bool writeDirty(Section section, bool &wrote) {
+  if (!loaded[section]) return true;
+  bool ok = true;
+  bool any = false;
+  for (size_t i = 0; i < FIELD_COUNT; i++) {
+    const Field &f = SCHEMA[i];
+    if (f.section != section) continue;
+    uint8_t *cur = fieldPtr(current, f);
+    uint8_t *old = fieldPtr(persisted, f);
+    if (!forceWrite[i] && present[i] && memcmp(cur, old, f.size) == 0) {
+      continue;
+    }
+    if (!backend->write(NAMESPACE, f.key, f.type, cur, f.size)) {
+      stats.writeErrors++;
+      ok = false;
+      continue;
+    }
+    memcpy(old, cur, f.size);
+    present[i] = true;
+    forceWrite[i] = false;
+    stats.fieldWrites++;
+    any = true;
+  }
+  if (!any) stats.skippedWrites++;
+  wrote = wrote || any;
+  return ok;
+}
+
+static bool writeVersion(uint16_t version) {
+  return backend->write(NAMESPACE, KEY_VERSION, ValueType::U16, &version,
+                        sizeof(version));
+}
+
+// Load everything, upgrade in RAM, then rewrite every field
+static bool runMigrations(uint16_t version) {
+  for (uint8_t s = 0; s < SECTION_COUNT; s++) loadSection((Section)s);
+
+  for (const Migration &m : MIGRATIONS) {
+    if (m.fromVersion < version) continue;
+    if (!m.apply(*backend, current)) return false;
+    stats.migrationsRun++;
+  }
+  for (size_t i = 0; i < FIELD_COUNT; i++) {
+    validate(SCHEMA[i], i);
+    forceWrite[i] = true;
+  }
+
+  bool wrote = false;
+  bool ok = true;
+  for (uint8_t s = 0; s < SECTION_COUNT; s++) {
+    ok &= writeDirty((Section)s, wrote);
+  }
+  // Version last: an interrupted migration simply runs again
+  ok = ok && writeVersion(SCHEMA_VERSION) && backend->sync(NAMESPACE);
+  if (!ok) stats.writeErrors++;
+  return ok;
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+bool begin(Backend &b) {
+  end();
+  backend = &b;
+
+  // The only namespace scan at boot: which schema keys exist
+  bool versionFound = false;
+  uint16_t version = 0;
+  backend->scan(NAMESPACE, onScanEntry, nullptr);
+  if (backend->read(NAMESPACE, KEY_VERSION, ValueType::U16, &version,
+                    sizeof(version))) {
+    versionFound = true;
+  }
+  stats.version = versionFound ? version : 0;
+  mounted = true;
+
+  if (stats.version < SCHEMA_VERSION) return runMigrations(stats.version);
+  return true;
+}
+
+void end() {
+  backend = nullptr;
+  mounted = false;
+  current = DEFAULTS;
+  persisted = DEFAULTS;
+  legacyLayouts = 0;
+  memset(loaded, 0, sizeof(loaded));
+  memset(present, 0, sizeof(present));
+  memset(forceWrite, 0, sizeof(forceWrite));
+  memset(&stats, 0, sizeof(stats));
+}
+
+bool isMounted() { return mounted; }
+
+bool isLoaded(Section section) {
+  return section < SECTION_COUNT && loaded[section];
+}
+
+// Unmounted store: accessors expose the defaults
+#define ACCESSOR(type, name, section)                                          \
+  type &name() {                                                               \
+    if (mounted) loadSection(section);                                         \
+    return current.name;                                                       \
+  }
+ACCESSOR(Vehicle, vehicle, SECTION_VEHICLE)
+ACCESSOR(Hud, hud, SECTION_HUD)
+ACCESSOR(Sensors, sensors, SECTION_SENSORS)
+ACCESSOR(Encoder, encoder, SECTION_ENCODER)
+ACCESSOR(Power, power, SECTION_POWER)
+ACCESSOR(Leds, leds, SECTION_LEDS)
+ACCESSOR(General, general, SECTION_GENERAL)
+ACCESSOR(Obstacle, obstacle, SECTION_OBSTACLE)
+ACCESSOR(Maintenance, maintenance, SECTION_MAINTENANCE)
+ACCESSOR(Errors, errors, SECTION_ERRORS)
+#undef ACCESSOR
+
+bool commit(Section section) {
+  if (!mounted || section >= SECTION_COUNT) return false;
+  bool wrote = false;
+  bool ok = writeDirty(section, wrote);
+  if (wrote) ok &= backend->sync(NAMESPACE);
+  return ok;
+}
+
+bool commit() {
+  if (!mounted) return false;
+  bool wrote = false;
+  bool ok = true;
+  for (uint8_t s = 0; s < SECTION_COUNT; s++) {
+    ok &= writeDirty((Section)s, wrote);
+  }
+  if (wrote) ok &= backend->sync(NAMESPACE);
+  return ok;
+}
+
+bool resetToDefaults() {
+  if (!mounted) return false;
+  backend->eraseNamespace(NAMESPACE);
+  current = DEFAULTS;
+  persisted = DEFAULTS;
+  for (uint8_t s = 0; s < SECTION_COUNT; s++) loaded[s] = true;
+  for (size_t i = 0; i < FIELD_COUNT; i++) {
+    present[i] = false;
+    forceWrite[i] = true;
+  }
+  bool wrote = false;
+  bool ok = true;
+  for (uint8_t s = 0; s < SECTION_COUNT; s++) {
+    ok &= writeDirty((Section)s, wrote);
+  }
+  return ok && writeVersion(SCHEMA_VERSION) && backend->sync(NAMESPACE);
+}
+
+const Settings &defaults() { return DEFAULTS; }
+
+void getStats(Stats &out) {
+  out = stats;
+  out.mounted = mounted;
+  out.legacyLayouts = legacyLayouts;
+}
+
+} // namespace ConfigStore
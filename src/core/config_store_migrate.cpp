@@ -0,0 +1,289 @@
+// config_store_migrate.cpp - Migration v0: import the legacy config layouts
+// Each importer copies only the keys it finds, so a later (higher
+// precedence) layout overrides an earlier one field by field. Key names,
+// types and unit conversions mirror the removed load() implementations.
+#include "config_store_legacy.h"
+#include <cstring>
+
+namespace ConfigStore {
+namespace Legacy {
+
+// ============================================================================
+// Typed readers (Preferences stores bool as U8)
+// ============================================================================
+
+static bool getBool(Backend &b, const char *ns, const char *key, bool &out) {
+  uint8_t v;
+  if (!b.read(ns, key, ValueType::U8, &v, sizeof(v))) return false;
+  out = v != 0;
+  return true;
+}
+
+static bool getU8(Backend &b, const char *ns, const char *key, uint8_t &out) {
+  return b.read(ns, key, ValueType::U8, &out, sizeof(out));
+}
+
+static bool getU16(Backend &b, const char *ns, const char *key,
+                   uint16_t &out) {
+  return b.read(ns, key, ValueType::U16, &out, sizeof(out));
+}
+
+static bool getI16(Backend &b, const char *ns, const char *key, int16_t &out) {
+  return b.read(ns, key, ValueType::I16, &out, sizeof(out));
+}
+
+static bool getU32(Backend &b, const char *ns, const char *key,
+                   uint32_t &out) {
+  return b.read(ns, key, ValueType::U32, &out, sizeof(out));
+}
+
+static bool hasKey(Backend &b, const char *ns, const char *key,
+                   ValueType type) {
+  uint32_t scratch;
+  return b.read(ns, key, type, &scratch,
+                type == ValueType::U8 ? 1 : (type == ValueType::U16 ? 2 : 4));
+}
+
+// ============================================================================
+// ConfigManager ("coche") - never called, but may exist on old units
+// ============================================================================
+
+static bool importConfigManager(Backend &b, Settings &s) {
+  const char *ns = COCHE_NS;
+  if (!hasKey(b, ns, "crc", ValueType::U32)) return false;
+
+  getU16(b, ns, "pwr_hold", s.power.holdDelayMs);
+  getU16(b, ns, "shutdown", s.power.shutdownDelayMs);
+  getU8(b, ns, "regen_lvl", s.vehicle.regenPercent);
+  getU8(b, ns, "led_brght", s.leds.brightness);
+  getU8(b, ns, "led_ptrn", s.leds.pattern);
+
+  uint8_t speed;
+  if (getU8(b, ns, "led_spd", speed)) {
+    // Escala 1-10 -> 0-255
+    s.leds.speed = speed >= 10 ? 255 : (uint8_t)(speed * 255 / 10);
+  }
+
+  uint8_t r, g, bl;
+  if (getU8(b, ns, "led_r", r) && getU8(b, ns, "led_g", g) &&
+      getU8(b, ns, "led_b", bl)) {
+    s.leds.color = ((uint32_t)r << 16) | ((uint32_t)g << 8) | bl;
+  }
+
+  getI16(b, ns, "enc_cntr", s.encoder.center);
+  getI16(b, ns, "enc_min", s.encoder.leftLimit);
+  getI16(b, ns, "enc_max", s.encoder.rightLimit);
+  getBool(b, ns, "sns_whls", s.sensors.wheelSensorsEnabled);
+  getBool(b, ns, "sns_curr", s.sensors.currentSensorsEnabled);
+  getBool(b, ns, "sns_enc", s.sensors.encoderEnabled);
+
+  uint16_t timeoutMs;
+  if (getU16(b, ns, "mnu_tout", timeoutMs)) {
+    s.general.menuTimeoutSec = timeoutMs / 1000;
+  }
+  getU16(b, ns, "mnu_pin", s.general.menuPin);
+  getU8(b, ns, "abs_thrs", s.general.absSlipThreshold);
+  getU8(b, ns, "tcs_thrs", s.general.tcsSlipThreshold);
+  return true;
+}
+
+// ============================================================================
+// EEPROMPersistence (one namespace per module)
+// ============================================================================
+
+static bool importEepromPersistence(Backend &b, Settings &s) {
+  bool found = false;
+
+  const char *ns = EEPROM_ENCODER_NS;
+  found |= getI16(b, ns, "center", s.encoder.center);
+  found |= getI16(b, ns, "left", s.encoder.leftLimit);
+  found |= getI16(b, ns, "right", s.encoder.rightLimit);
+  found |= getBool(b, ns, "calibrated", s.encoder.calibrated);
+
+  ns = EEPROM_SENSORS_NS;
+  static const char *const WHEEL_KEYS[4] = {"wFL", "wFR", "wRL", "wRR"};
+  for (int i = 0; i < 4; i++) {
+    found |= getBool(b, ns, WHEEL_KEYS[i], s.sensors.wheel[i]);
+  }
+  found |= getBool(b, ns, "enc", s.sensors.encoderEnabled);
+  static const char *const INA_KEYS[6] = {"inaFL", "inaFR",  "inaRL",
+                                          "inaRR", "inaBat", "inaStr"};
+  for (int i = 0; i < 6; i++) {
+    found |= getBool(b, ns, INA_KEYS[i], s.sensors.ina226Channel[i]);
+  }
+
+  ns = EEPROM_POWER_NS;
+  found |= getU16(b, ns, "hold", s.power.holdDelayMs);
+  found |= getU16(b, ns, "aux", s.power.auxDelayMs);
+  found |= getU16(b, ns, "motor", s.power.tractionDelayMs);
+  found |= getU16(b, ns, "shut", s.power.shutdownDelayMs);
+  found |= getBool(b, ns, "auto", s.power.autoShutdown);
+
+  ns = EEPROM_LEDS_NS;
+  found |= getU8(b, ns, "pattern", s.leds.pattern);
+  found |= getU8(b, ns, "bright", s.leds.brightness);
+  found |= getU8(b, ns, "speed", s.leds.speed);
+  found |= getU32(b, ns, "color", s.leds.color);
+  found |= getBool(b, ns, "enabled", s.leds.enabled);
+
+  ns = EEPROM_GENERAL_NS;
+  found |= getBool(b, ns, "pinEnabled", s.general.menuPinEnabled);
+  found |= getU16(b, ns, "timeout", s.general.menuTimeoutSec);
+  found |= getBool(b, ns, "audio", s.general.audioEnabled);
+  found |= getU8(b, ns, "volume", s.general.volume);
+  found |= getBool(b, ns, "abs", s.general.absEnabled);
+  found |= getBool(b, ns, "tcs", s.general.tcsEnabled);
+  found |= getBool(b, ns, "regen", s.general.regenEnabled);
+  found |= getU8(b, ns, "drive", s.general.driveMode);
+  return found;
+}
+
+// ============================================================================
+// ConfigStorage ("car_config") - used by the sensor/LED/power/encoder menus
+// ============================================================================
+
+static bool importConfigStorage(Backend &b, Settings &s) {
+  const char *ns = CAR_CONFIG_NS;
+  // The legacy XOR checksum covered struct padding and unsaved fields, so
+  // it cannot be recomputed from the keys: presence marks a saved config
+  if (!hasKey(b, ns, "checksum", ValueType::U32)) return false;
+
+  static const char *const WHEEL_KEYS[4] = {"sFL", "sFR", "sRL", "sRR"};
+  for (int i = 0; i < 4; i++) {
+    getBool(b, ns, WHEEL_KEYS[i], s.sensors.wheel[i]);
+  }
+  getBool(b, ns, "sINA", s.sensors.ina226Enabled);
+
+  getI16(b, ns, "enc_c", s.encoder.center);
+  getI16(b, ns, "enc_l", s.encoder.leftLimit);
+  getI16(b, ns, "enc_r", s.encoder.rightLimit);
+
+  getU8(b, ns, "led_pat", s.leds.pattern);
+  getU8(b, ns, "led_bri", s.leds.brightness);
+  getU8(b, ns, "led_spd", s.leds.speed);
+  getU32(b, ns, "led_col", s.leds.color);
+
+  getU16(b, ns, "pwr_hold", s.power.holdDelayMs);
+  getU16(b, ns, "pwr_aux", s.power.auxDelayMs);
+  getU16(b, ns, "pwr_trac", s.power.tractionDelayMs);
+
+  // "abs"/"tcs"/"regen" are not imported: System::init never applied
+  // them, only the EEPROMPersistence GeneralSettings ones
+  getBool(b, ns, "wifi", s.general.wifiEnabled);
+
+  getU16(b, ns, "obs_crit", s.obstacle.criticalMm);
+  getU16(b, ns, "obs_warn", s.obstacle.warningMm);
+  getU16(b, ns, "obs_caut", s.obstacle.cautionMm);
+  getBool(b, ns, "obs_sen", s.obstacle.sensorEnabled);
+  getBool(b, ns, "obs_aud", s.obstacle.audioAlerts);
+  getBool(b, ns, "obs_vis", s.obstacle.visualAlerts);
+  return true;
+}
+
+// ============================================================================
+// Storage ("vehicle"): magic + Config v8 blob
+// ============================================================================
+
+uint32_t vehicleChecksum(const VehicleV8 &v) {
+  const uint32_t FNV_OFFSET = 2166136261u;
+  const uint32_t FNV_PRIME = 16777619u;
+  uint32_t h = FNV_OFFSET;
+
+  auto mix = [&](const void *data, size_t len) {
+    const uint8_t *p = static_cast<const uint8_t *>(data);
+    for (size_t i = 0; i < len; ++i) {
+      h ^= p[i];
+      h *= FNV_PRIME;
+    }
+  };
+
+  mix(&v.pedalMin, sizeof(v.pedalMin));
+  mix(&v.pedalMax, sizeof(v.pedalMax));
+  mix(&v.pedalCurve, sizeof(v.pedalCurve));
+  mix(&v.regenPercent, sizeof(v.regenPercent));
+  mix(v.shuntCoeff, sizeof(v.shuntCoeff));
+  mix(&v.steerZeroOffset, sizeof(v.steerZeroOffset));
+  mix(&v.showTemps, sizeof(v.showTemps));
+  mix(&v.showEffort, sizeof(v.showEffort));
+  mix(&v.displayBrightness, sizeof(v.displayBrightness));
+  mix(&v.audioEnabled, sizeof(v.audioEnabled));
+  mix(&v.tractionEnabled, sizeof(v.tractionEnabled));
+  mix(&v.wheelSensorsEnabled, sizeof(v.wheelSensorsEnabled));
+  mix(&v.tempSensorsEnabled, sizeof(v.tempSensorsEnabled));
+  mix(&v.currentSensorsEnabled, sizeof(v.currentSensorsEnabled));
+  mix(&v.steeringEnabled, sizeof(v.steeringEnabled));
+  mix(&v.touchEnabled, sizeof(v.touchEnabled));
+  mix(v.touchCalibration, sizeof(v.touchCalibration));
+  mix(&v.touchCalibrated, sizeof(v.touchCalibrated));
+  mix(&v.odometer, sizeof(v.odometer));
+  mix(&v.maintenanceIntervalKm, sizeof(v.maintenanceIntervalKm));
+  mix(&v.maintenanceIntervalDays, sizeof(v.maintenanceIntervalDays));
+  mix(&v.errorCount, sizeof(v.errorCount));
+  mix(v.errors, sizeof(v.errors));
+  mix(&v.version, sizeof(v.version));
+  return h;
+}
+
+static bool importVehicleBlob(Backend &b, Settings &s) {
+  uint32_t magic = 0;
+  if (!getU32(b, VEHICLE_NS, VEHICLE_KEY_MAGIC, magic) ||
+      magic != VEHICLE_MAGIC) {
+    return false;
+  }
+  VehicleV8 v;
+  if (!b.read(VEHICLE_NS, VEHICLE_KEY_BLOB, ValueType::BLOB, &v, sizeof(v)) ||
+      v.version != VEHICLE_VERSION || v.checksum != vehicleChecksum(v)) {
+    return false; // Storage::load() would have restored defaults too
+  }
+
+  s.vehicle.pedalMin = v.pedalMin;
+  s.vehicle.pedalMax = v.pedalMax;
+  s.vehicle.pedalCurve = v.pedalCurve;
+  s.vehicle.regenPercent = v.regenPercent;
+  memcpy(s.vehicle.shuntCoeff, v.shuntCoeff, sizeof(v.shuntCoeff));
+  s.vehicle.steerZeroOffset = v.steerZeroOffset;
+  s.vehicle.maxBatteryCurrentA = v.maxBatteryCurrentA;
+  s.vehicle.maxMotorCurrentA = v.maxMotorCurrentA;
+  s.vehicle.tractionEnabled = v.tractionEnabled;
+  s.vehicle.steeringEnabled = v.steeringEnabled;
+
+  s.hud.showTemps = v.showTemps;
+  s.hud.showEffort = v.showEffort;
+  s.hud.displayBrightness = v.displayBrightness;
+  // Storage::load() forced touch back on (can't reach the menu without it)
+  s.hud.touchEnabled = true;
+  memcpy(s.hud.touchCalibration, v.touchCalibration,
+         sizeof(v.touchCalibration));
+  s.hud.touchCalibrated = v.touchCalibrated;
+  s.hud.shadowHudEnabled = v.shadowHudEnabled;
+
+  s.sensors.wheelSensorsEnabled = v.wheelSensorsEnabled;
+  s.sensors.tempSensorsEnabled = v.tempSensorsEnabled;
+  s.sensors.currentSensorsEnabled = v.currentSensorsEnabled;
+
+  s.general.audioEnabled = v.audioEnabled;
+
+  s.maintenance.odometer = v.odometer;
+  s.maintenance.intervalKm = v.maintenanceIntervalKm;
+  s.maintenance.intervalDays = v.maintenanceIntervalDays;
+
+  memcpy(s.errors.entries, v.errors, sizeof(v.errors));
+  s.errors.count = v.errorCount;
+  return true;
+}
+
+// ============================================================================
+// Entry point
+// ============================================================================
+
+uint8_t importAll(Backend &backend, Settings &out) {
+  uint8_t found = 0;
+  if (importConfigManager(backend, out)) found++;
+  if (importEepromPersistence(backend, out)) found++;
+  if (importConfigStorage(backend, out)) found++;
+  if (importVehicleBlob(backend, out)) found++;
+  return found;
+}
+
+} // namespace Legacy
+} // namespace ConfigStore
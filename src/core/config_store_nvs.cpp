@@ -0,0 +1,171 @@
+// config_store_nvs.cpp - ConfigStore backend on the default NVS partition
+#include "config_store.h"
+#include "logger.h"
+#include <Arduino.h>
+#include <nvs.h>
+#include <nvs_flash.h>
+
+namespace ConfigStore {
+
+class NvsBackend : public Backend {
+public:
+  bool scan(const char *ns, ScanFn fn, void *ctx) override {
+    nvs_iterator_t it = nvs_entry_find(NVS_DEFAULT_PART_NAME, ns, NVS_TYPE_ANY);
+    if (it == nullptr) return false;
+    while (it != nullptr) {
+      nvs_entry_info_t info;
+      nvs_entry_info(it, &info);
+      ValueType type;
+      if (fromNvsType(info.type, type)) fn(info.key, type, ctx);
+      it = nvs_entry_next(it); // Releases the iterator at the end
+    }
+    return true;
+  }
+
+  bool read(const char *ns, const char *key, ValueType type, void *out,
+            size_t len) override {
+    nvs_handle_t h;
+    // Legacy namespaces are only ever opened read-only
+    if (!open(ns, NVS_READONLY, h)) return false;
+    esp_err_t err = ESP_FAIL;
+    switch (type) {
+    case ValueType::U8:
+      err = nvs_get_u8(h, key, static_cast<uint8_t *>(out));
+      break;
+    case ValueType::I8:
+      err = nvs_get_i8(h, key, static_cast<int8_t *>(out));
+      break;
+    case ValueType::U16:
+      err = nvs_get_u16(h, key, static_cast<uint16_t *>(out));
+      break;
+    case ValueType::I16:
+      err = nvs_get_i16(h, key, static_cast<int16_t *>(out));
+      break;
+    case ValueType::U32:
+      err = nvs_get_u32(h, key, static_cast<uint32_t *>(out));
+      break;
+    case ValueType::I32:
+      err = nvs_get_i32(h, key, static_cast<int32_t *>(out));
+      break;
+    case ValueType::BLOB: {
+      size_t stored = 0;
+      err = nvs_get_blob(h, key, nullptr, &stored);
+      if (err == ESP_OK && stored != len) err = ESP_ERR_NVS_INVALID_LENGTH;
+      if (err == ESP_OK) err = nvs_get_blob(h, key, out, &stored);
+      break;
+    }
+    }
+    nvs_close(h);
+    return err == ESP_OK;
+  }
+
+  bool write(const char *ns, const char *key, ValueType type, const void *in,
+             size_t len) override {
+    nvs_handle_t h;
+    if (!open(ns, NVS_READWRITE, h)) return false;
+    esp_err_t err = ESP_FAIL;
+    switch (type) {
+    case ValueType::U8:
+      err = nvs_set_u8(h, key, *static_cast<const uint8_t *>(in));
+      break;
+    case ValueType::I8:
+      err = nvs_set_i8(h, key, *static_cast<const int8_t *>(in));
+      break;
+    case ValueType::U16:
+      err = nvs_set_u16(h, key, *static_cast<const uint16_t *>(in));
+      break;
+    case ValueType::I16:
+      err = nvs_set_i16(h, key, *static_cast<const int16_t *>(in));
+      break;
+    case ValueType::U32:
+      err = nvs_set_u32(h, key, *static_cast<const uint32_t *>(in));
+      break;
+    case ValueType::I32:
+      err = nvs_set_i32(h, key, *static_cast<const int32_t *>(in));
+      break;
+    case ValueType::BLOB:
+      err = nvs_set_blob(h, key, in, len);
+      break;
+    }
+    nvs_close(h);
+    return err == ESP_OK;
+  }
+
+  bool eraseNamespace(const char *ns) override {
+    nvs_handle_t h;
+    if (!open(ns, NVS_READWRITE, h)) return false;
+    esp_err_t err = nvs_erase_all(h);
+    if (err == ESP_OK) err = nvs_commit(h);
+    nvs_close(h);
+    return err == ESP_OK;
+  }
+
+  bool sync(const char *ns) override {
+    nvs_handle_t h;
+    if (!open(ns, NVS_READWRITE, h)) return false;
+    esp_err_t err = nvs_commit(h);
+    nvs_close(h);
+    return err == ESP_OK;
+  }
+
+private:
+  static bool open(const char *ns, nvs_open_mode_t mode, nvs_handle_t &h) {
+    return nvs_open(ns, mode, &h) == ESP_OK;
+  }
+
+  static bool fromNvsType(nvs_type_t t, ValueType &out) {
+    switch (t) {
+    case NVS_TYPE_U8:
+      out = ValueType::U8;
+      return true;
+    case NVS_TYPE_I8:
+      out = ValueType::I8;
+      return true;
+    case NVS_TYPE_U16:
+      out = ValueType::U16;
+      return true;
+    case NVS_TYPE_I16:
+      out = ValueType::I16;
+      return true;
+    case NVS_TYPE_U32:
+      out = ValueType::U32;
+      return true;
+    case NVS_TYPE_I32:
+      out = ValueType::I32;
+      return true;
+    case NVS_TYPE_BLOB:
+      out = ValueType::BLOB;
+      return true;
+    default:
+      return false;
+    }
+  }
+};
+
+bool init() {
+  // Arduino inicializa NVS al arrancar; repetirlo es inocuo
+  esp_err_t err = nvs_flash_init();
+  if (err != ESP_OK && err != ESP_ERR_NVS_NO_FREE_PAGES) {
+    Logger::errorf("ConfigStore: nvs_flash_init falló (%d)", (int)err);
+  }
+
+  static NvsBackend backend;
+  uint32_t start = micros();
+  bool ok = begin(backend);
+
+  Stats st;
+  getStats(st);
+  if (!ok) {
+    Logger::error("ConfigStore: fallo al montar/migrar la configuración");
+  }
+  if (st.migrationsRun > 0) {
+    Logger::infof("ConfigStore: migrado v%u -> v%u (%u formatos antiguos)",
+                  st.version, SCHEMA_VERSION, st.legacyLayouts);
+  }
+  Logger::infof("ConfigStore: %u claves, %lu escrituras en %lu us",
+                st.keysFound, (unsigned long)st.fieldWrites,
+                (unsigned long)(micros() - start));
+  return ok;
+}
+
+} // namespace ConfigStore
@@ -0,0 +1,190 @@
+// error_journal.cpp - Lock-free in-RAM error journal with deferred flush
+#include "error_journal.h"
+#include <atomic>
+
+namespace ErrorJournal {
+
+// ============================================================================
+// Table
+// Open addressing with linear probing. A slot is claimed once by CAS on its
+// code (0 = free) and never released until clear(), so a code always
+// resolves to the same slot and producers only ever add to it.
+// ============================================================================
+
+static_assert((CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY must be 2^n");
+constexpr uint32_t MASK = CAPACITY - 1;
+
+struct Slot {
+  std::atomic<uint32_t> code;
+  std::atomic<uint32_t> count;
+  std::atomic<uint32_t> firstMs;
+  std::atomic<uint32_t> lastMs;
+  std::atomic<uint32_t> context;
+  std::atomic<bool> logged; // Handed to onNew by flush()
+  uint32_t flushedCount; // Consumer only: count at the last flush()
+};
+
+static Slot table[CAPACITY];
+static std::atomic<uint32_t> recorded{0};
+static std::atomic<uint32_t> dropped{0};
+
+// Consumer state
+static uint32_t recordedAtFlush = 0;
+static uint32_t flushes = 0;
+static uint32_t newCodes = 0;
+
+static uint32_t home(uint16_t code) {
+  // Fibonacci hashing: codes come in runs (310..315, 810..813)
+  return ((uint32_t(code) * 2654435761u) >> 26) & MASK;
+}
+
+static void bump(Slot &s, uint32_t nowMs, uint32_t context) {
+  s.lastMs.store(nowMs, std::memory_order_relaxed);
+  s.context.store(context, std::memory_order_relaxed);
+  s.count.fetch_add(1, std::memory_order_release);
+  recorded.fetch_add(1, std::memory_order_release);
+}
+
+bool record(uint16_t code, uint32_t nowMs, uint32_t context, bool *isNew) {
+  if (isNew) *isNew = false;
+  if (code == 0) return false;
+
+  uint32_t i = home(code);
+  for (uint8_t probe = 0; probe < CAPACITY; probe++, i = (i + 1) & MASK) {
+    Slot &s = table[i];
+    uint32_t owner = s.code.load(std::memory_order_acquire);
+    if (owner == 0) {
+      if (s.code.compare_exchange_strong(owner, code,
+                                         std::memory_order_acq_rel)) {
+        s.firstMs.store(nowMs, std::memory_order_relaxed);
+        bump(s, nowMs, context);
+        if (isNew) *isNew = true;
+        return true;
+      }
+      // Lost the race: owner now holds the winner's code
+    }
+    if (owner == code) {
+      bump(s, nowMs, context);
+      return true;
+    }
+  }
+
+  dropped.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+bool pending() {
+  return recorded.load(std::memory_order_acquire) != recordedAtFlush;
+}
+
+static void load(const Slot &s, Entry &e) {
+  e.code = static_cast<uint16_t>(s.code.load(std::memory_order_acquire));
+  e.count = s.count.load(std::memory_order_acquire);
+  e.lastMs = s.lastMs.load(std::memory_order_relaxed);
+  e.firstMs = s.firstMs.load(std::memory_order_relaxed);
+  e.context = s.context.load(std::memory_order_relaxed);
+}
+
+uint8_t flush(void (*onNew)(const Entry &entry)) {
+  uint32_t seen = recorded.load(std::memory_order_acquire);
+  if (seen == recordedAtFlush) return 0;
+  recordedAtFlush = seen;
+  flushes++;
+
+  Entry fresh[CAPACITY];
+  Slot *freshSlot[CAPACITY];
+  uint8_t n = 0;
+  for (Slot &s : table) {
+    Entry e;
+    load(s, e);
+    if (e.code == 0 || e.count == 0) continue; // Free, or claim in flight
+    if (s.flushedCount == 0) {
+      // Another producer may bump a just-claimed slot before the claimer
+      // stores firstMs; its lastMs is then the best first timestamp
+      if (e.firstMs == 0) e.firstMs = e.lastMs;
+      // Insertion sort by first occurrence: the log stays chronological
+      uint8_t at = n++;
+      while (at > 0 && fresh[at - 1].firstMs > e.firstMs) {
+        fresh[at] = fresh[at - 1];
+        freshSlot[at] = freshSlot[at - 1];
+        at--;
+      }
+      fresh[at] = e;
+      freshSlot[at] = &s;
+    }
+    s.flushedCount = e.count;
+  }
+
+  for (uint8_t i = 0; i < n; i++) {
+    if (onNew) onNew(fresh[i]);
+    freshSlot[i]->logged.store(true, std::memory_order_release);
+  }
+  newCodes += n;
+  return n;
+}
+
+uint8_t unlogged(uint16_t *out, uint8_t max) {
+  uint8_t n = 0;
+  for (const Slot &s : table) {
+    if (n >= max) break;
+    uint32_t code = s.code.load(std::memory_order_acquire);
+    if (code == 0 || s.logged.load(std::memory_order_acquire)) continue;
+    out[n++] = static_cast<uint16_t>(code);
+  }
+  return n;
+}
+
+bool get(uint16_t code, Entry &out) {
+  if (code == 0) return false;
+  uint32_t i = home(code);
+  for (uint8_t probe = 0; probe < CAPACITY; probe++, i = (i + 1) & MASK) {
+    uint32_t owner = table[i].code.load(std::memory_order_acquire);
+    if (owner == 0) return false;
+    if (owner == code) {
+      load(table[i], out);
+      return out.count > 0;
+    }
+  }
+  return false;
+}
+
+uint8_t snapshot(Entry *out, uint8_t max) {
+  uint8_t n = 0;
+  for (const Slot &s : table) {
+    if (n >= max) break;
+    Entry e;
+    load(s, e);
+    if (e.code != 0 && e.count > 0) out[n++] = e;
+  }
+  return n;
+}
+
+void getStats(Stats &out) {
+  out.recorded = recorded.load(std::memory_order_relaxed);
+  out.dropped = dropped.load(std::memory_order_relaxed);
+  out.codes = 0;
+  for (const Slot &s : table) {
+    if (s.code.load(std::memory_order_relaxed) != 0) out.codes++;
+  }
+  out.flushes = flushes;
+  out.newCodes = newCodes;
+}
+
+void clear() {
+  for (Slot &s : table) {
+    s.count.store(0, std::memory_order_relaxed);
+    s.firstMs.store(0, std::memory_order_relaxed);
+    s.lastMs.store(0, std::memory_order_relaxed);
+    s.context.store(0, std::memory_order_relaxed);
+    s.flushedCount = 0;
+    s.logged.store(false, std::memory_order_relaxed);
+    s.code.store(0, std::memory_order_release);
+  }
+  recorded.store(0, std::memory_order_relaxed);
+  dropped.store(0, std::memory_order_relaxed);
+  recordedAtFlush = 0;
+  flushes = 0;
+  newCodes = 0;
+}
+
+} // namespace ErrorJournal
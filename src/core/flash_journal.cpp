@@ -0,0 +1,394 @@
+// flash_journal.cpp - Wear-leveled append-only key/value journal
+#include "flash_journal.h"
+#include <cstring>
+
+namespace FlashJournal {
+
+// ============================================================================
+// On-flash layout (little-endian)
+//   Sector: [SectorHeader 16 B][records...][0xFF free space]
+//   Record: [RecordHeader 8 B][payload padded to 4 B][crc32 4 B]
+//           crc32 covers header + unpadded payload
+// ============================================================================
+
+constexpr uint32_t SECTOR_MAGIC = 0x4C4E524A; // "JRNL"
+constexpr uint8_t RECORD_MAGIC = 0xA7;
+
+struct SectorHeader {
+  uint32_t magic;
+  uint32_t seq; // Monotonic, orders sectors for replay
+  uint32_t crc; // crc32 of magic + seq
+  uint32_t reserved;
+};
+static_assert(sizeof(SectorHeader) == 16, "SectorHeader layout");
+
+struct RecordHeader {
+  uint8_t magic;
+  uint8_t key;
+  uint8_t len;
+  uint8_t reserved;
+  uint32_t seq;
+};
+static_assert(sizeof(RecordHeader) == 8, "RecordHeader layout");
+
+constexpr uint32_t DATA_START = sizeof(SectorHeader);
+constexpr uint32_t MAX_RECORD_SIZE =
+    sizeof(RecordHeader) + ((MAX_PAYLOAD + 3) & ~3u) + 4;
+
+enum SectorState : uint8_t { SECTOR_ERASED, SECTOR_VALID, SECTOR_GARBAGE };
+
+struct Slot {
+  bool valid;
+  uint8_t len;
+  uint8_t sector; // Where the latest copy lives
+  uint8_t data[MAX_PAYLOAD];
+};
+
+// ============================================================================
+// State
+// ============================================================================
+
+static FlashDevice *dev = nullptr;
+static bool mounted = false;
+static uint8_t sectorCount = 0;
+static SectorState sectorState[MAX_SECTORS];
+static uint32_t sectorSeq[MAX_SECTORS];
+static uint8_t head = 0;
+static uint32_t headOffset = 0;
+static uint32_t nextSectorSeq = 1;
+static uint32_t nextRecordSeq = 1;
+static Slot slots[MAX_KEYS];
+static Stats stats;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+uint32_t crc32(uint32_t crc, const void *data, size_t len) {
+  const uint8_t *p = static_cast<const uint8_t *>(data);
+  crc = ~crc;
+  while (len--) {
+    crc ^= *p++;
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+    }
+  }
+  return ~crc;
+}
+
+static uint32_t recordSize(uint8_t len) {
+  return sizeof(RecordHeader) + ((len + 3u) & ~3u) + 4;
+}
+
+static uint32_t sectorAddr(uint8_t sector) { return sector * SECTOR_SIZE; }
+
+static bool isBlank(const uint8_t *p, uint32_t len) {
+  for (uint32_t i = 0; i < len; i++) {
+    if (p[i] != 0xFF) return false;
+  }
+  return true;
+}
+
+static bool sectorIsBlank(uint8_t sector) {
+  uint8_t chunk[256];
+  for (uint32_t off = 0; off < SECTOR_SIZE; off += sizeof(chunk)) {
+    if (!dev->read(sectorAddr(sector) + off, chunk, sizeof(chunk))) {
+      return false;
+    }
+    if (!isBlank(chunk, sizeof(chunk))) return false;
+  }
+  return true;
+}
+
+static uint32_t sectorHeaderCrc(const SectorHeader &h) {
+  return crc32(0, &h, offsetof(SectorHeader, crc));
+}
+
+static uint8_t nextSector(uint8_t sector) {
+  return (uint8_t)((sector + 1) % sectorCount);
+}
+
+static uint8_t erasedAhead() {
+  uint8_t count = 0;
+  for (uint8_t s = nextSector(head); s != head; s = nextSector(s)) {
+    if (sectorState[s] != SECTOR_ERASED) break;
+    count++;
+  }
+  return count;
+}
+
+static bool eraseSector(uint8_t sector) {
+  if (!dev->eraseSector(sector)) {
+    sectorState[sector] = SECTOR_GARBAGE;
+    stats.writeErrors++;
+    return false;
+  }
+  sectorState[sector] = SECTOR_ERASED;
+  stats.erases++;
+  return true;
+}
+
+// Start writing into the (erased) sector after the head
+static bool advanceHead() {
+  uint8_t s = nextSector(head);
+  if (s == head || sectorState[s] != SECTOR_ERASED) return false;
+
+  SectorHeader h;
+  h.magic = SECTOR_MAGIC;
+  h.seq = nextSectorSeq;
+  h.crc = sectorHeaderCrc(h);
+  h.reserved = 0xFFFFFFFF;
+  if (!dev->write(sectorAddr(s), &h, sizeof(h))) {
+    sectorState[s] = SECTOR_GARBAGE;
+    stats.writeErrors++;
+    return false;
+  }
+  sectorState[s] = SECTOR_VALID;
+  sectorSeq[s] = nextSectorSeq++;
+  head = s;
+  headOffset = DATA_START;
+  return true;
+}
+
+static bool compactOne();
+
+static bool writeRecord(uint8_t key, const uint8_t *data, uint8_t len,
+                        bool relocation) {
+  uint32_t size = recordSize(len);
+  if (headOffset + size > SECTOR_SIZE) {
+    // Keep one erased sector for relocation: user appends compact first
+    // when the background service fell behind
+    if (!relocation) {
+      while (erasedAhead() < 2 && compactOne()) stats.inlineCompactions++;
+    }
+    if (headOffset + size > SECTOR_SIZE) {
+      if (erasedAhead() < 1 || !advanceHead()) {
+        stats.writeErrors++;
+        return false;
+      }
+    }
+  }
+
+  uint8_t buf[MAX_RECORD_SIZE];
+  memset(buf, 0xFF, sizeof(buf));
+  RecordHeader h;
+  h.magic = RECORD_MAGIC;
+  h.key = key;
+  h.len = len;
+  h.reserved = 0xFF;
+  h.seq = nextRecordSeq++;
+  memcpy(buf, &h, sizeof(h));
+  memcpy(buf + sizeof(h), data, len);
+  uint32_t crc = crc32(0, buf, sizeof(h) + len);
+  memcpy(buf + size - 4, &crc, 4);
+
+  if (!dev->write(sectorAddr(head) + headOffset, buf, size)) {
+    // Unknown flash content from here on: close the sector
+    headOffset = SECTOR_SIZE;
+    stats.writeErrors++;
+    return false;
+  }
+  headOffset += size;
+
+  Slot &slot = slots[key];
+  if (slot.data != data) memcpy(slot.data, data, len);
+  slot.len = len;
+  slot.valid = true;
+  slot.sector = head;
+  return true;
+}
+
+// Erase the oldest non-erased sector after the erased run, relocating its
+// live records first. Returns true if a sector was erased.
+static bool compactOne() {
+  uint8_t target = head;
+  for (uint8_t s = nextSector(head); s != head; s = nextSector(s)) {
+    if (sectorState[s] != SECTOR_ERASED) {
+      target = s;
+      break;
+    }
+  }
+  if (target == head) return false;
+
+  if (sectorState[target] == SECTOR_VALID) {
+    for (uint8_t key = 1; key < MAX_KEYS; key++) {
+      Slot &slot = slots[key];
+      if (!slot.valid || slot.sector != target) continue;
+      if (!writeRecord(key, slot.data, slot.len, true)) return false;
+      stats.relocations++;
+    }
+  }
+  return eraseSector(target);
+}
+
+// Replay one sector; returns the offset where valid data ends
+static uint32_t replaySector(uint8_t sector, bool &corrupt) {
+  corrupt = false;
+  uint32_t offset = DATA_START;
+  uint8_t buf[MAX_RECORD_SIZE];
+
+  while (offset + sizeof(RecordHeader) + 4 <= SECTOR_SIZE) {
+    RecordHeader h;
+    if (!dev->read(sectorAddr(sector) + offset, &h, sizeof(h))) {
+      corrupt = true;
+      break;
+    }
+    if (isBlank(reinterpret_cast<const uint8_t *>(&h), sizeof(h))) break;
+
+    uint32_t size = recordSize(h.len);
+    if (h.magic != RECORD_MAGIC || h.key == KEY_INVALID ||
+        h.key >= MAX_KEYS || h.len > MAX_PAYLOAD ||
+        offset + size > SECTOR_SIZE ||
+        !dev->read(sectorAddr(sector) + offset, buf, size)) {
+      corrupt = true;
+      break;
+    }
+    uint32_t stored;
+    memcpy(&stored, buf + size - 4, 4);
+    if (crc32(0, buf, sizeof(h) + h.len) != stored) {
+      corrupt = true;
+      break;
+    }
+
+    Slot &slot = slots[h.key];
+    memcpy(slot.data, buf + sizeof(h), h.len);
+    slot.len = h.len;
+    slot.valid = true;
+    slot.sector = sector;
+    if (h.seq >= nextRecordSeq) nextRecordSeq = h.seq + 1;
+    stats.replayedRecords++;
+    offset += size;
+  }
+
+  if (corrupt) stats.corruptRecords++;
+  return offset;
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+bool begin(FlashDevice &device) {
+  end();
+  dev = &device;
+  uint32_t count = device.sectorCount();
+  if (count < MIN_SECTORS) return false;
+  sectorCount = count > MAX_SECTORS ? MAX_SECTORS : (uint8_t)count;
+
+  // Classify sectors
+  uint8_t order[MAX_SECTORS];
+  uint8_t validCount = 0;
+  for (uint8_t s = 0; s < sectorCount; s++) {
+    SectorHeader h;
+    sectorSeq[s] = 0;
+    if (!dev->read(sectorAddr(s), &h, sizeof(h))) {
+      sectorState[s] = SECTOR_GARBAGE;
+    } else if (isBlank(reinterpret_cast<const uint8_t *>(&h), sizeof(h))) {
+      // Interrupted erase can leave a blank header over old data
+      sectorState[s] = sectorIsBlank(s) ? SECTOR_ERASED : SECTOR_GARBAGE;
+    } else if (h.magic == SECTOR_MAGIC && h.crc == sectorHeaderCrc(h)) {
+      sectorState[s] = SECTOR_VALID;
+      sectorSeq[s] = h.seq;
+      // Insertion sort by sequence (oldest first)
+      uint8_t pos = validCount++;
+      while (pos > 0 && sectorSeq[order[pos - 1]] > h.seq) {
+        order[pos] = order[pos - 1];
+        pos--;
+      }
+      order[pos] = s;
+    } else {
+      sectorState[s] = SECTOR_GARBAGE;
+    }
+  }
+
+  // Replay oldest to newest: later copies of a key win
+  bool headCorrupt = false;
+  for (uint8_t i = 0; i < validCount; i++) {
+    uint8_t s = order[i];
+    bool corrupt;
+    uint32_t end = replaySector(s, corrupt);
+    if (i == validCount - 1) {
+      head = s;
+      headOffset = end;
+      headCorrupt = corrupt;
+    }
+    nextSectorSeq = sectorSeq[s] + 1;
+  }
+
+  mounted = true;
+  if (validCount == 0) {
+    // Fresh or fully garbage partition: start at sector 0
+    head = (uint8_t)(sectorCount - 1);
+    if (sectorState[0] != SECTOR_ERASED && !eraseSector(0)) return false;
+    if (!advanceHead()) return false;
+  } else if (headCorrupt) {
+    // Never append after a torn record: continue in a fresh sector
+    headOffset = SECTOR_SIZE;
+  }
+
+  // A power cut during compaction can leave no erased sector
+  if (erasedAhead() == 0) compactOne();
+  return true;
+}
+
+void end() {
+  dev = nullptr;
+  mounted = false;
+  head = 0;
+  headOffset = 0;
+  nextSectorSeq = 1;
+  nextRecordSeq = 1;
+  memset(slots, 0, sizeof(slots));
+  memset(&stats, 0, sizeof(stats));
+}
+
+bool isMounted() { return mounted; }
+
+bool append(uint8_t key, const void *data, uint8_t len) {
+  if (!mounted || key == KEY_INVALID || key >= MAX_KEYS ||
+      len > MAX_PAYLOAD || data == nullptr) {
+    return false;
+  }
+  const Slot &slot = slots[key];
+  if (slot.valid && slot.len == len && memcmp(slot.data, data, len) == 0) {
+    stats.skippedAppends++;
+    return true;
+  }
+  if (!writeRecord(key, static_cast<const uint8_t *>(data), len, false)) {
+    return false;
+  }
+  stats.appends++;
+  return true;
+}
+
+bool read(uint8_t key, void *out, uint8_t len) {
+  if (!mounted || key == KEY_INVALID || key >= MAX_KEYS) return false;
+  const Slot &slot = slots[key];
+  if (!slot.valid || slot.len != len) return false;
+  memcpy(out, slot.data, len);
+  return true;
+}
+
+bool has(uint8_t key) {
+  return mounted && key != KEY_INVALID && key < MAX_KEYS && slots[key].valid;
+}
+
+bool service() {
+  if (!mounted || erasedAhead() >= RESERVE_SECTORS) return false;
+  return compactOne();
+}
+
+void getStats(Stats &out) {
+  out = stats;
+  out.mounted = mounted;
+  out.sectors = sectorCount;
+  out.headSector = head;
+  out.headOffset = (uint16_t)headOffset;
+  out.erasedAhead = mounted ? erasedAhead() : 0;
+  out.liveKeys = 0;
+  for (uint8_t key = 1; key < MAX_KEYS; key++) {
+    if (slots[key].valid) out.liveKeys++;
+  }
+}
+
+} // namespace FlashJournal
@@ -22,6 +22,54 @@ static uint8_t pinSCL = PIN_I2C_SCL;
 static constexpr uint32_t RECOVERY_FREQUENCY =
     100000; // 100 kHz (modo estándar)
 
+// Códigos de Wire.endTransmission() (Arduino-ESP32 2.x)
+static constexpr uint8_t WIRE_ERR_OTHER = 4;   // Bus ocupado / arbitraje
+static constexpr uint8_t WIRE_ERR_TIMEOUT = 5; // Timeout del driver
+
+// Estado del bus: tras un bloqueo (timeout del driver) nadie vuelve a tocar
+// el bus hasta busHoldoffUntilMs. Así cada barrido del powerJob paga como
+// mucho un timeout, no uno por sensor.
+static uint8_t busFailures = 0;
+static uint32_t busHoldoffUntilMs = 0;
+
+static uint32_t backoffMs(uint8_t failures) {
+  // BACKOFF_BASE_MS, x2 por fallo consecutivo, hasta MAX_BACKOFF_MS
+  uint8_t exponent = failures > 6 ? 6 : (failures > 0 ? failures - 1 : 0);
+  uint32_t backoff = BACKOFF_BASE_MS << exponent;
+  return backoff > MAX_BACKOFF_MS ? MAX_BACKOFF_MS : backoff;
+}
+
+static void scheduleBackoff(DeviceState &dev, uint32_t now) {
+  if (dev.consecutiveFailures < UINT8_MAX) dev.consecutiveFailures++;
+  dev.nextRetryMs = now + backoffMs(dev.consecutiveFailures);
+}
+
+// Fallo de bus (no un NACK): el driver agotó I2CCMDTIMEOUT_MS o perdió el
+// bus. Distinguir por tiempo cubre requestFrom(), que solo devuelve 0.
+static bool isBusStall(uint8_t result, uint32_t elapsedUs) {
+  return result == WIRE_ERR_OTHER || result == WIRE_ERR_TIMEOUT ||
+         elapsedUs >= uint32_t(I2CCMDTIMEOUT_MS) * 1000u;
+}
+
+static bool busOnHold() {
+  return static_cast<int32_t>(millis() - busHoldoffUntilMs) < 0;
+}
+
+// Un solo recoverBus() por bloqueo. Bus liberado: pausa corta para que el
+// resto del barrido actual no repita el timeout. Sigue atascado: backoff
+// exponencial, como un dispositivo.
+static void onBusStall() {
+  if (recoverBus()) {
+    busFailures = 0;
+    busHoldoffUntilMs = millis() + BUS_QUIET_MS;
+    return;
+  }
+  if (busFailures < UINT8_MAX) busFailures++;
+  busHoldoffUntilMs = millis() + backoffMs(busFailures);
+  Logger::errorf("I2CRecovery: bus bloqueado (fallos:%d, pausa:%lums)",
+                 busFailures, backoffMs(busFailures));
+}
+
 void init() {
   Wire.begin(pinSDA, pinSCL);
   Wire.setClock(I2C_FREQUENCY);
@@ -35,6 +83,8 @@ void init() {
   Serial.printf("[I2CRecovery] Driver timeout set to %u ms\n",
                 I2CCMDTIMEOUT_MS);
   initialized = true;
+  busFailures = 0;
+  busHoldoffUntilMs = millis();
 
   // Inicializar estados
   for (uint8_t i = 0; i < MAX_DEVICES; i++) {
@@ -137,42 +187,33 @@ bool tcaSelectSafe(uint8_t channel, uint8_t tcaAddr) {
     return false;
   }
 
-  // Timeout para beginTransmission + write + endTransmission
-  constexpr uint32_t TIMEOUT_MS = 100;
-  uint32_t startMs = millis();
+  if (busOnHold()) return false;
+
+  uint32_t startUs = micros();
 
   Wire.beginTransmission(tcaAddr);
   Wire.write(1 << channel);
   uint8_t result = Wire.endTransmission();
 
-  uint32_t elapsed = millis() - startMs;
-
   // Feed watchdog tras operación I²C
   Watchdog::feed();
 
   if (result != 0) {
     Serial.printf("[I2CRecovery] ERROR: TCA select ch%d falló (error %d)\n",
                   channel, result);
-
-    // Intentar bus recovery
-    if (recoverBus()) {
-      // Retry tras recovery
-      Wire.beginTransmission(tcaAddr);
-      Wire.write(1 << channel);
-      result = Wire.endTransmission();
-
-      if (result == 0) {
-        Serial.printf("[I2CRecovery] TCA select ch%d OK tras recovery\n",
-                      channel);
-        return true;
-      }
-    }
+    if (isBusStall(result, micros() - startUs)) onBusStall();
     return false;
   }
 
-  if (elapsed > 50) {
-    Serial.printf("[I2CRecovery] TCA select ch%d lento (%lums)\n", channel,
-                  elapsed);
+  // El TCA9548A devuelve su registro de control al leerlo: confirma que el
+  // canal conmutó. Un ACK sin conmutar dejaría leer el INA226 de otro canal
+  // (todos en 0x40) como si fuera este.
+  uint8_t mask = static_cast<uint8_t>(1u << channel);
+  if (Wire.requestFrom(tcaAddr, static_cast<uint8_t>(1)) != 1 ||
+      Wire.read() != mask) {
+    Serial.printf("[I2CRecovery] ERROR: TCA ch%d no conmutó\n", channel);
+    if (isBusStall(0, micros() - startUs)) onBusStall();
+    return false;
   }
 
   return true;
@@ -208,20 +249,21 @@ bool readBytesWithRetry(uint8_t deviceAddr, uint8_t regAddr, uint8_t *buffer,
     // Aún intentar (backoff permitirá retry esporádico)
   }
 
-  dev.lastAttemptMs = now;
+  if (busOnHold()) return false;
 
-  // Intentar lectura con timeout
-  constexpr uint32_t TIMEOUT_MS = 100;
+  dev.lastAttemptMs = now;
 
-  for (uint8_t retry = 0; retry <= MAX_RETRIES; retry++) {
+  // Reintentos solo para NACK / lectura corta: un bloqueo del bus no se
+  // arregla reintentando y cada intento costaría otro I2CCMDTIMEOUT_MS
+  bool stalled = false;
+  for (uint8_t retry = 0; retry <= MAX_RETRIES && !stalled; retry++) {
     if (retry > 0) {
       Logger::infof("I2C retry %d/%d (dev 0x%02X)", retry, MAX_RETRIES,
                     deviceAddr);
-      // Non-blocking: use delayMicroseconds for minimal settling time
-      delayMicroseconds(500); // 0.5ms instead of 50ms
+      delayMicroseconds(RETRY_DELAY_US);
     }
 
-    uint32_t startMs = millis();
+    uint32_t startUs = micros();
 
     // Escribir dirección de registro
     Wire.beginTransmission(deviceAddr);
@@ -229,24 +271,16 @@ bool readBytesWithRetry(uint8_t deviceAddr, uint8_t regAddr, uint8_t *buffer,
     uint8_t result = Wire.endTransmission(false); // Repeated start
 
     if (result != 0) {
-      if ((millis() - startMs) > TIMEOUT_MS) {
-        Serial.printf(
-            "[I2CRecovery] ERROR: I2C timeout escribiendo reg (dev 0x%02X)\n",
-            deviceAddr);
-        continue; // Retry
-      }
+      stalled = isBusStall(result, micros() - startUs);
       continue;
     }
 
     // Leer datos
-    startMs = millis();
+    startUs = micros();
     uint8_t received = Wire.requestFrom(deviceAddr, length);
 
     if (received != length) {
-      if ((millis() - startMs) > TIMEOUT_MS) {
-        Serial.printf("[I2CRecovery] ERROR: I2C timeout leyendo (dev 0x%02X)\n",
-                      deviceAddr);
-      }
+      stalled = isBusStall(0, micros() - startUs);
       continue; // Retry
     }
 
@@ -267,23 +301,15 @@ bool readBytesWithRetry(uint8_t deviceAddr, uint8_t regAddr, uint8_t *buffer,
     return true;
   }
 
-  // FALLO tras MAX_RETRIES
-  dev.consecutiveFailures++;
-
-  // Calcular backoff exponencial: 1s, 2s, 4s, 8s, ... (máx 30s)
-  uint8_t exponent =
-      (dev.consecutiveFailures - 1 > 5) ? 5 : (dev.consecutiveFailures - 1);
-  uint32_t backoff = 1000 * (1 << exponent);
-  if (backoff > MAX_BACKOFF_MS) backoff = MAX_BACKOFF_MS;
-  dev.nextRetryMs = now + backoff;
+  // FALLO: backoff del dispositivo; recovery del bus si el bus se bloqueó
+  scheduleBackoff(dev, now);
 
-  Logger::errorf("I2C fallo dev 0x%02X (fallos:%d, backoff:%lus)", deviceAddr,
-                 dev.consecutiveFailures, backoff / 1000);
+  Logger::errorf("I2C fallo dev 0x%02X (fallos:%d, backoff:%lums)",
+                 deviceAddr, dev.consecutiveFailures, dev.nextRetryMs - now);
 
-  // Intentar bus recovery si fallos >= 3
-  if (dev.consecutiveFailures >= 3) {
+  if (stalled) {
     Logger::warn("I2CRecovery: Intentando bus recovery...");
-    recoverBus();
+    onBusStall();
   }
 
   return false;
@@ -306,16 +332,16 @@ bool writeBytesWithRetry(uint8_t deviceAddr, uint8_t regAddr,
 
   // Verificar backoff
   if (now < dev.nextRetryMs) { return false; }
+  if (busOnHold()) return false;
 
   dev.lastAttemptMs = now;
 
-  // Intentar escritura con retry
-  for (uint8_t retry = 0; retry <= MAX_RETRIES; retry++) {
-    if (retry > 0) {
-      // Non-blocking: use delayMicroseconds for minimal settling time
-      delayMicroseconds(500); // 0.5ms instead of 50ms
-    }
+  // Intentar escritura con retry (solo NACK, ver readBytesWithRetry)
+  bool stalled = false;
+  for (uint8_t retry = 0; retry <= MAX_RETRIES && !stalled; retry++) {
+    if (retry > 0) { delayMicroseconds(RETRY_DELAY_US); }
 
+    uint32_t startUs = micros();
     Wire.beginTransmission(deviceAddr);
     Wire.write(regAddr);
     Wire.write(data, length);
@@ -331,20 +357,16 @@ bool writeBytesWithRetry(uint8_t deviceAddr, uint8_t regAddr,
       dev.nextRetryMs = 0;
       return true;
     }
+    stalled = isBusStall(result, micros() - startUs);
   }
 
   // FALLO
-  dev.consecutiveFailures++;
-  uint8_t exponent =
-      (dev.consecutiveFailures - 1 > 5) ? 5 : (dev.consecutiveFailures - 1);
-  uint32_t backoff = 1000 * (1 << exponent);
-  if (backoff > MAX_BACKOFF_MS) backoff = MAX_BACKOFF_MS;
-  dev.nextRetryMs = now + backoff;
+  scheduleBackoff(dev, now);
 
-  Logger::errorf("I2C write fallo dev 0x%02X (backoff:%lus)", deviceAddr,
-                 backoff / 1000);
+  Logger::errorf("I2C write fallo dev 0x%02X (backoff:%lums)", deviceAddr,
+                 dev.nextRetryMs - now);
 
-  if (dev.consecutiveFailures >= 3) { recoverBus(); }
+  if (stalled) { onBusStall(); }
 
   return false;
 }
@@ -427,18 +449,13 @@ void markDeviceOffline(uint8_t deviceId) {
   if (deviceId >= MAX_DEVICES) return;
 
   devices[deviceId].online = false;
-  devices[deviceId].consecutiveFailures++;
-
-  // Calcular backoff exponencial para evitar reintentos frecuentes
-  uint8_t exponent = (devices[deviceId].consecutiveFailures - 1 > 5)
-                         ? 5
-                         : (devices[deviceId].consecutiveFailures - 1);
-  uint32_t backoff = 1000 * (1 << exponent);
-  if (backoff > MAX_BACKOFF_MS) backoff = MAX_BACKOFF_MS;
-  devices[deviceId].nextRetryMs = millis() + backoff;
-
-  Serial.printf("[DEBUG] Device %d marcado OFFLINE (backoff:%lus)\n", deviceId,
-                backoff / 1000);
+
+  // Backoff exponencial para evitar reintentos frecuentes
+  scheduleBackoff(devices[deviceId], millis());
+  uint32_t backoff = devices[deviceId].nextRetryMs - millis();
+
+  Serial.printf("[DEBUG] Device %d marcado OFFLINE (backoff:%lums)\n",
+                deviceId, backoff);
 }
 
 } // namespace I2CRecovery
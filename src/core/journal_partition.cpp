@@ -0,0 +1,62 @@
+// journal_partition.cpp - FlashJournal on the "journal" data partition
+#include "flash_journal.h"
+#include "logger.h"
+#include <Arduino.h>
+#include <esp_partition.h>
+
+namespace FlashJournal {
+
+// Custom data subtype (0x40-0xFE are free for applications)
+static const esp_partition_subtype_t PARTITION_SUBTYPE =
+    static_cast<esp_partition_subtype_t>(0x40);
+static const char *PARTITION_LABEL = "journal";
+
+class PartitionFlash : public FlashDevice {
+public:
+  explicit PartitionFlash(const esp_partition_t *p) : part(p) {}
+
+  uint32_t sectorCount() const override { return part->size / SECTOR_SIZE; }
+
+  bool read(uint32_t addr, void *dst, uint32_t len) override {
+    return esp_partition_read(part, addr, dst, len) == ESP_OK;
+  }
+
+  bool write(uint32_t addr, const void *src, uint32_t len) override {
+    return esp_partition_write(part, addr, src, len) == ESP_OK;
+  }
+
+  bool eraseSector(uint32_t sector) override {
+    return esp_partition_erase_range(part, sector * SECTOR_SIZE,
+                                     SECTOR_SIZE) == ESP_OK;
+  }
+
+private:
+  const esp_partition_t *part;
+};
+
+bool initPartition() {
+  const esp_partition_t *part = esp_partition_find_first(
+      ESP_PARTITION_TYPE_DATA, PARTITION_SUBTYPE, PARTITION_LABEL);
+  if (part == nullptr) {
+    Logger::warn("FlashJournal: partición 'journal' no encontrada");
+    return false;
+  }
+
+  static PartitionFlash device(part);
+  uint32_t start = millis();
+  if (!begin(device)) {
+    Logger::error("FlashJournal: fallo al montar el journal");
+    return false;
+  }
+
+  Stats st;
+  getStats(st);
+  Logger::infof("FlashJournal: %u sectores, %u claves, %lu registros "
+                "(%lu corruptos) en %lu ms",
+                st.sectors, st.liveKeys, (unsigned long)st.replayedRecords,
+                (unsigned long)st.corruptRecords,
+                (unsigned long)(millis() - start));
+  return true;
+}
+
+} // namespace FlashJournal
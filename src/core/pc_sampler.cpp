@@ -0,0 +1,314 @@
+// pc_sampler.cpp - Statistical PC sampling profiler (both cores)
+#include "pc_sampler.h"
+#include "logger.h"
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+namespace PcSampler {
+
+// Interrupted context, see xtensa_context.h (XtExcFrame): on entry to the
+// outermost interrupt the port saves the task's registers on its stack and
+// stores that SP in pxCurrentTCB->pxTopOfStack (first TCB member).
+constexpr uint8_t XT_STK_PC_WORD = 1; // XT_STK_PC = 4
+constexpr uint8_t XT_STK_A0_WORD = 3; // XT_STK_A0 = 12
+
+constexpr uint8_t MAX_TASK_IDS = 32;
+constexpr uint8_t UNKNOWN_TASK_ID = 0xFF;
+constexpr uint32_t ARM_TIMEOUT_MS = 200;
+constexpr uint32_t ARM_TASK_STACK = 2048;
+
+struct Entry {
+  uint32_t pc;
+  uint32_t caller;
+  TaskHandle_t task;
+};
+
+struct Ring {
+  Entry *buf;
+  volatile uint16_t head; // Written by the ISR only
+  volatile uint16_t tail; // Written by drain() only
+  volatile uint32_t samples;
+  volatile uint32_t dropped;
+  uint32_t droppedReported;
+  hw_timer_t *timer;
+};
+
+static Ring rings[2];
+static volatile bool running = false;
+static uint16_t rateHz = DEFAULT_RATE_HZ;
+static uint8_t coreMask = 0;
+static uint32_t streamed = 0;
+static uint32_t bytesStreamed = 0;
+
+// Task handle -> compact id, announced with a FRAME_TASK on first use
+static TaskHandle_t taskIds[MAX_TASK_IDS];
+static uint8_t taskIdCount = 0;
+
+// ============================================================================
+// Sampling interrupt (IRAM, touches only DRAM state)
+// ============================================================================
+
+static void IRAM_ATTR sampleIsr() {
+  Ring &r = rings[xPortGetCoreID()];
+  TaskHandle_t task = xTaskGetCurrentTaskHandle();
+  if (task == nullptr || r.buf == nullptr) return;
+
+  uint16_t head = r.head;
+  uint16_t next = (head + 1) % RING_ENTRIES;
+  if (next == r.tail) {
+    r.dropped++;
+    return;
+  }
+
+  const uint32_t *frame = *(const uint32_t *const *)task;
+  Entry &e = r.buf[head];
+  e.pc = frame[XT_STK_PC_WORD];
+  // Windowed ABI: top two bits of a0 hold the call increment
+  e.caller = (frame[XT_STK_A0_WORD] & 0x3FFFFFFF) | 0x40000000;
+  e.task = task;
+  __sync_synchronize();
+  r.head = next;
+  r.samples++;
+}
+
+// ============================================================================
+// Per-core arm/disarm (interrupts must be allocated and freed on their core)
+// ============================================================================
+
+struct CoreJob {
+  uint8_t core;
+  bool arm;
+  bool ok;
+  TaskHandle_t waiter;
+};
+
+static void coreJobTask(void *parameter) {
+  CoreJob *job = (CoreJob *)parameter;
+  Ring &r = rings[job->core];
+  if (job->arm) {
+    uint8_t num = job->core == 0 ? TIMER_CORE0 : TIMER_CORE1;
+    r.timer = timerBegin(num, 80, true); // APB 80 MHz / 80 = 1 MHz
+    if (r.timer != nullptr) {
+      timerAttachInterrupt(r.timer, &sampleIsr, true);
+      timerAlarmWrite(r.timer, 1000000UL / rateHz, true);
+      timerAlarmEnable(r.timer);
+    }
+    job->ok = r.timer != nullptr;
+  } else {
+    if (r.timer != nullptr) {
+      timerAlarmDisable(r.timer);
+      timerDetachInterrupt(r.timer);
+      timerEnd(r.timer);
+      r.timer = nullptr;
+    }
+    job->ok = true;
+  }
+  xTaskNotifyGive(job->waiter);
+  vTaskDelete(nullptr);
+}
+
+// Static so a late-finishing core job never writes to a dead stack frame
+static CoreJob coreJob;
+
+static bool runOnCore(uint8_t core, bool arm) {
+  coreJob = {core, arm, false, xTaskGetCurrentTaskHandle()};
+  BaseType_t created = xTaskCreatePinnedToCore(
+      coreJobTask, "PcSamplerArm", ARM_TASK_STACK, &coreJob,
+      uxTaskPriorityGet(nullptr) + 1, nullptr, core);
+  if (created != pdPASS) return false;
+  if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(ARM_TIMEOUT_MS)) == 0) {
+    Logger::errorf("PcSampler: Core %u job timeout", core);
+    return false;
+  }
+  return coreJob.ok;
+}
+
+// ============================================================================
+// Serial framing
+// ============================================================================
+
+static bool writeFrame(uint8_t type, const uint8_t *payload, uint8_t len) {
+  uint8_t buf[4 + 255 + 1];
+  if (Serial.availableForWrite() < (int)(len + 5)) return false;
+  buf[0] = SYNC0;
+  buf[1] = SYNC1;
+  buf[2] = type;
+  buf[3] = len;
+  uint8_t sum = type + len;
+  for (uint8_t i = 0; i < len; i++) {
+    buf[4 + i] = payload[i];
+    sum += payload[i];
+  }
+  buf[4 + len] = sum;
+  Serial.write(buf, len + 5);
+  bytesStreamed += len + 5;
+  return true;
+}
+
+static void put16(uint8_t *p, uint16_t v) {
+  p[0] = v & 0xFF;
+  p[1] = v >> 8;
+}
+
+static void put32(uint8_t *p, uint32_t v) {
+  for (uint8_t i = 0; i < 4; i++) p[i] = (v >> (8 * i)) & 0xFF;
+}
+
+// Returns false if a new task could not be announced yet (TX full)
+static bool resolveTaskId(TaskHandle_t task, uint8_t &id) {
+  for (uint8_t i = 0; i < taskIdCount; i++) {
+    if (taskIds[i] == task) {
+      id = i;
+      return true;
+    }
+  }
+  if (taskIdCount >= MAX_TASK_IDS) {
+    id = UNKNOWN_TASK_ID;
+    return true;
+  }
+
+  uint8_t payload[1 + configMAX_TASK_NAME_LEN];
+  const char *name = pcTaskGetName(task);
+  uint8_t nameLen = name ? (uint8_t)strnlen(name, configMAX_TASK_NAME_LEN) : 0;
+  payload[0] = taskIdCount;
+  memcpy(payload + 1, name, nameLen);
+  if (!writeFrame(FRAME_TASK, payload, nameLen + 1)) return false;
+
+  id = taskIdCount;
+  taskIds[taskIdCount++] = task;
+  return true;
+}
+
+// Streams one frame for the core; false when nothing more can be sent now
+static bool drainFrame(uint8_t core) {
+  Ring &r = rings[core];
+  uint16_t tail = r.tail;
+  uint16_t head = r.head;
+  uint32_t droppedNow = r.dropped;
+  uint32_t droppedDelta = droppedNow - r.droppedReported;
+  if (tail == head && droppedDelta == 0) return false;
+
+  uint8_t payload[3 + MAX_SAMPLES_PER_FRAME * SAMPLE_BYTES];
+  uint8_t n = 0;
+  uint16_t pos = tail;
+  while (pos != head && n < MAX_SAMPLES_PER_FRAME) {
+    // Keep room for this frame's header, checksum and one more sample
+    int needed = 5 + 3 + (n + 1) * SAMPLE_BYTES;
+    if (Serial.availableForWrite() < needed) break;
+    const Entry &e = r.buf[pos];
+    uint8_t id;
+    if (!resolveTaskId(e.task, id)) break;
+    if (Serial.availableForWrite() < needed) break;
+    uint8_t *p = payload + 3 + n * SAMPLE_BYTES;
+    put32(p, e.pc);
+    put32(p + 4, e.caller);
+    p[8] = id;
+    n++;
+    pos = (pos + 1) % RING_ENTRIES;
+  }
+  if (n == 0 && droppedDelta == 0) return false;
+
+  uint16_t dropped = droppedDelta > 0xFFFF ? 0xFFFF : (uint16_t)droppedDelta;
+  payload[0] = core;
+  put16(payload + 1, dropped);
+  if (!writeFrame(FRAME_SAMPLES, payload, 3 + n * SAMPLE_BYTES)) return false;
+
+  r.tail = pos;
+  r.droppedReported += dropped;
+  streamed += n;
+  return n == MAX_SAMPLES_PER_FRAME;
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+bool start(uint16_t hz, uint8_t mask) {
+  if (running) stop();
+  mask &= CORE_MASK_BOTH;
+  if (mask == 0) return false;
+  rateHz = constrain(hz, MIN_RATE_HZ, MAX_RATE_HZ);
+  coreMask = mask;
+  streamed = 0;
+  bytesStreamed = 0;
+  taskIdCount = 0;
+
+  for (uint8_t core = 0; core < 2; core++) {
+    Ring &r = rings[core];
+    r.head = r.tail = 0;
+    r.samples = r.dropped = r.droppedReported = 0;
+    if (!(mask & (1 << core))) continue;
+    r.buf = (Entry *)heap_caps_malloc(RING_ENTRIES * sizeof(Entry),
+                                      MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (r.buf == nullptr) {
+      Logger::errorf("PcSampler: No memory for core %u ring", core);
+      stop();
+      return false;
+    }
+  }
+
+  running = true;
+  for (uint8_t core = 0; core < 2; core++) {
+    if (!(mask & (1 << core))) continue;
+    if (!runOnCore(core, true)) {
+      Logger::errorf("PcSampler: Timer %u unavailable on core %u",
+                     core == 0 ? TIMER_CORE0 : TIMER_CORE1, core);
+      stop();
+      return false;
+    }
+  }
+
+  uint8_t info[3];
+  put16(info, rateHz);
+  info[2] = coreMask;
+  writeFrame(FRAME_INFO, info, sizeof(info));
+  Logger::infof("PcSampler: Started at %u Hz (core mask 0x%X)", rateHz,
+                coreMask);
+  return true;
+}
+
+void stop() {
+  bool wasRunning = running;
+  running = false;
+  for (uint8_t core = 0; core < 2; core++) {
+    Ring &r = rings[core];
+    if (r.timer != nullptr) runOnCore(core, false);
+    if (r.buf != nullptr) {
+      heap_caps_free(r.buf);
+      r.buf = nullptr;
+    }
+  }
+  if (wasRunning) {
+    Logger::infof("PcSampler: Stopped (%lu/%lu samples, %lu/%lu dropped, "
+                  "%lu streamed)",
+                  rings[0].samples, rings[1].samples, rings[0].dropped,
+                  rings[1].dropped, streamed);
+  }
+}
+
+bool isRunning() { return running; }
+
+uint16_t getRateHz() { return rateHz; }
+
+void drain() {
+  if (!running) return;
+  for (uint8_t core = 0; core < 2; core++) {
+    if (!(coreMask & (1 << core))) continue;
+    while (drainFrame(core)) {}
+  }
+}
+
+void getStats(Stats &out) {
+  out.running = running;
+  out.rateHz = rateHz;
+  out.coreMask = coreMask;
+  for (uint8_t core = 0; core < 2; core++) {
+    out.samples[core] = rings[core].samples;
+    out.dropped[core] = rings[core].dropped;
+  }
+  out.streamed = streamed;
+  out.bytesStreamed = bytesStreamed;
+}
+
+} // namespace PcSampler
@@ -0,0 +1,279 @@
+// rt_scheduler.cpp - Table-driven rate-monotonic executive
+#include "rt_scheduler.h"
+#include "logger.h"
+
+namespace RTScheduler {
+
+// Statistics window for utilization figures
+constexpr uint32_t STATS_WINDOW_US = 1000000; // 1 s
+
+struct JobSlot {
+  JobConfig cfg;
+  TickType_t nextRelease;
+  uint32_t runs;
+  uint32_t budgetOverruns;
+  uint32_t deadlineMisses;
+  uint32_t lastUs;
+  uint32_t maxUs;
+  uint32_t windowBusyUs;
+  float utilizationPct;
+};
+
+struct CoreState {
+  TaskHandle_t handle;
+  volatile int8_t runningJob;   // Index of job in progress, -1 if idle
+  volatile uint32_t jobStartMs; // millis() when runningJob started
+  bool stallReported;
+  uint32_t stallLimitMs;
+  JobFn stallHandler;
+  uint32_t windowStartUs;
+  float utilizationPct;
+};
+
+static JobSlot jobs[MAX_JOBS];
+static uint8_t jobCount = 0;
+static bool started = false;
+
+// Rate-monotonic dispatch order per core (shortest period first, ties keep
+// registration order)
+static uint8_t dispatchOrder[NUM_CORES][MAX_JOBS];
+static uint8_t dispatchCount[NUM_CORES] = {0, 0};
+
+static CoreState cores[NUM_CORES] = {
+    {nullptr, -1, 0, false, 0, nullptr, 0, 0.0f},
+    {nullptr, -1, 0, false, 0, nullptr, 0, 0.0f}};
+
+int8_t registerJob(const JobConfig &job) {
+  if (started) {
+    Logger::errorf("RTScheduler: '%s' registered after start",
+                   job.name ? job.name : "?");
+    return -1;
+  }
+  if (jobCount >= MAX_JOBS || job.fn == nullptr || job.periodMs == 0 ||
+      job.core >= NUM_CORES || job.phaseMs >= job.periodMs) {
+    Logger::errorf("RTScheduler: Invalid job '%s'", job.name ? job.name : "?");
+    return -1;
+  }
+
+  uint8_t idx = jobCount++;
+  JobSlot &slot = jobs[idx];
+  memset(&slot, 0, sizeof(slot));
+  slot.cfg = job;
+
+  // Insert into the core's dispatch order (stable by period)
+  uint8_t core = job.core;
+  uint8_t pos = dispatchCount[core];
+  while (pos > 0 &&
+         jobs[dispatchOrder[core][pos - 1]].cfg.periodMs > job.periodMs) {
+    dispatchOrder[core][pos] = dispatchOrder[core][pos - 1];
+    pos--;
+  }
+  dispatchOrder[core][pos] = idx;
+  dispatchCount[core]++;
+
+  return (int8_t)idx;
+}
+
+void setStallHandler(uint8_t watchedCore, uint32_t limitMs, JobFn handler) {
+  if (watchedCore >= NUM_CORES) return;
+  cores[watchedCore].stallLimitMs = limitMs;
+  cores[watchedCore].stallHandler = handler;
+}
+
+// Called by each dispatcher between jobs to supervise the other core
+static void checkStall(uint8_t watchedCore) {
+  CoreState &cs = cores[watchedCore];
+  if (cs.stallHandler == nullptr || cs.stallReported) return;
+  int8_t running = cs.runningJob;
+  if (running < 0) return;
+  uint32_t runningMs = millis() - cs.jobStartMs;
+  if (runningMs <= cs.stallLimitMs) return;
+
+  cs.stallReported = true;
+  Logger::errorf("RTScheduler: Job '%s' on core %u stalled (%lu ms)",
+                 jobs[running].cfg.name, watchedCore, runningMs);
+  cs.stallHandler();
+}
+
+static void updateWindow(uint8_t core) {
+  CoreState &cs = cores[core];
+  uint32_t nowUs = micros();
+  uint32_t windowUs = nowUs - cs.windowStartUs;
+  if (windowUs < STATS_WINDOW_US) return;
+
+  float total = 0.0f;
+  for (uint8_t i = 0; i < dispatchCount[core]; i++) {
+    JobSlot &j = jobs[dispatchOrder[core][i]];
+    j.utilizationPct = (100.0f * j.windowBusyUs) / windowUs;
+    j.windowBusyUs = 0;
+    total += j.utilizationPct;
+  }
+  cs.utilizationPct = total;
+  cs.windowStartUs = nowUs;
+}
+
+static void dispatcherTask(void *parameter) {
+  uint8_t core = (uint8_t)(uintptr_t)parameter;
+  uint8_t otherCore = core == 0 ? 1 : 0;
+  CoreState &cs = cores[core];
+  const uint8_t *order = dispatchOrder[core];
+  const uint8_t count = dispatchCount[core];
+
+  TickType_t base = xTaskGetTickCount();
+  for (uint8_t i = 0; i < count; i++) {
+    JobSlot &j = jobs[order[i]];
+    j.nextRelease = base + pdMS_TO_TICKS(j.cfg.phaseMs);
+  }
+  cs.windowStartUs = micros();
+
+  Logger::infof("RTScheduler: Dispatcher started on Core %u (%u jobs)", core,
+                count);
+
+  while (true) {
+    for (uint8_t i = 0; i < count; i++) {
+      uint8_t idx = order[i];
+      JobSlot &j = jobs[idx];
+      TickType_t now = xTaskGetTickCount();
+      if ((int32_t)(now - j.nextRelease) < 0) continue;
+
+      cs.jobStartMs = millis();
+      cs.runningJob = (int8_t)idx;
+      uint32_t t0 = micros();
+      j.cfg.fn();
+      uint32_t elapsedUs = micros() - t0;
+      cs.runningJob = -1;
+      cs.stallReported = false;
+
+      j.runs++;
+      j.lastUs = elapsedUs;
+      if (elapsedUs > j.maxUs) j.maxUs = elapsedUs;
+      if (elapsedUs > j.cfg.budgetUs) j.budgetOverruns++;
+      j.windowBusyUs += elapsedUs;
+
+      // Next slot; releases that already passed are dropped, not queued
+      TickType_t period = pdMS_TO_TICKS(j.cfg.periodMs);
+      j.nextRelease += period;
+      now = xTaskGetTickCount();
+      int32_t late = (int32_t)(now - j.nextRelease);
+      if (late >= (int32_t)period) {
+        uint32_t skipped = (uint32_t)late / period;
+        j.deadlineMisses += skipped;
+        j.nextRelease += skipped * period;
+      }
+    }
+
+    checkStall(otherCore);
+    updateWindow(core);
+
+    // Sleep until the earliest next release
+    TickType_t now = xTaskGetTickCount();
+    int32_t wait = INT32_MAX;
+    for (uint8_t i = 0; i < count; i++) {
+      int32_t dt = (int32_t)(jobs[order[i]].nextRelease - now);
+      if (dt < wait) wait = dt;
+    }
+    // Overloaded core: still give IDLE one tick so the task WDT is fed
+    vTaskDelay(wait > 0 ? (TickType_t)wait : 1);
+  }
+}
+
+bool start(const CoreConfig coreCfg[NUM_CORES]) {
+  if (started) return true;
+  started = true;
+
+  for (uint8_t core = 0; core < NUM_CORES; core++) {
+    if (dispatchCount[core] == 0) continue;
+
+    BaseType_t result = xTaskCreatePinnedToCore(
+        dispatcherTask, coreCfg[core].taskName, coreCfg[core].stackSize,
+        (void *)(uintptr_t)core, coreCfg[core].priority, &cores[core].handle,
+        core);
+    if (result != pdPASS) {
+      Logger::errorf("RTScheduler: Failed to create %s",
+                     coreCfg[core].taskName);
+      return false;
+    }
+  }
+
+  // Static schedulability check (Liu & Layland bound is informative only:
+  // one dispatcher per core runs jobs to completion)
+  for (uint8_t core = 0; core < NUM_CORES; core++) {
+    float u = 0.0f;
+    for (uint8_t i = 0; i < dispatchCount[core]; i++) {
+      const JobConfig &c = jobs[dispatchOrder[core][i]].cfg;
+      u += (c.budgetUs / 10.0f) / c.periodMs; // budget/period in %
+    }
+    if (dispatchCount[core] > 0) {
+      Logger::infof("RTScheduler: Core %u budgeted utilization %.1f%%", core,
+                    u);
+    }
+    if (u > 100.0f) {
+      Logger::warnf("RTScheduler: Core %u over-subscribed by budget", core);
+    }
+  }
+  return true;
+}
+
+uint8_t getJobCount() { return jobCount; }
+
+bool getJobStats(uint8_t index, JobStats &out) {
+  if (index >= jobCount) return false;
+  const JobSlot &j = jobs[index];
+  out.name = j.cfg.name;
+  out.periodMs = j.cfg.periodMs;
+  out.phaseMs = j.cfg.phaseMs;
+  out.core = j.cfg.core;
+  out.budgetUs = j.cfg.budgetUs;
+  out.runs = j.runs;
+  out.budgetOverruns = j.budgetOverruns;
+  out.deadlineMisses = j.deadlineMisses;
+  out.lastUs = j.lastUs;
+  out.maxUs = j.maxUs;
+  out.utilizationPct = j.utilizationPct;
+  return true;
+}
+
+float getCoreUtilization(uint8_t core) {
+  if (core >= NUM_CORES) return 0.0f;
+  return cores[core].utilizationPct;
+}
+
+void resetStats() {
+  for (uint8_t i = 0; i < jobCount; i++) {
+    jobs[i].budgetOverruns = 0;
+    jobs[i].deadlineMisses = 0;
+    jobs[i].maxUs = 0;
+  }
+}
+
+void logStats() {
+  Logger::infof("RTScheduler: Core0 %.1f%%, Core1 %.1f%%",
+                cores[0].utilizationPct, cores[1].utilizationPct);
+  for (uint8_t i = 0; i < jobCount; i++) {
+    const JobSlot &j = jobs[i];
+    Logger::infof("  %-10s C%u %3ums+%-3u cpu=%.1f%% last=%luus max=%luus "
+                  "budget=%luus over=%lu miss=%lu",
+                  j.cfg.name, j.cfg.core, j.cfg.periodMs, j.cfg.phaseMs,
+                  j.utilizationPct, j.lastUs, j.maxUs, j.cfg.budgetUs,
+                  j.budgetOverruns, j.deadlineMisses);
+  }
+}
+
+TaskHandle_t getDispatcherHandle(uint8_t core) {
+  if (core >= NUM_CORES) return nullptr;
+  return cores[core].handle;
+}
+
+void suspendCore(uint8_t core) {
+  if (core < NUM_CORES && cores[core].handle != nullptr) {
+    vTaskSuspend(cores[core].handle);
+  }
+}
+
+void resumeCore(uint8_t core) {
+  if (core < NUM_CORES && cores[core].handle != nullptr) {
+    vTaskResume(cores[core].handle);
+  }
+}
+
+} // namespace RTScheduler
@@ -1,5 +1,8 @@
-// rtos_tasks.cpp - FreeRTOS task implementation for dual-core operation
+// rtos_tasks.cpp - FreeRTOS job table for dual-core operation
 #include "rtos_tasks.h"
+#include "black_box.h"
+#include "dfplayer.h"
+#include "flash_journal.h"
 #include "logger.h"
 #include "managers/ControlManager.h"
 #include "managers/HUDManager.h"
@@ -7,211 +10,180 @@
 #include "managers/SafetyManager.h"
 #include "managers/SensorManager.h"
 #include "managers/TelemetryManager.h"
+#include "pc_sampler.h"
+#include "queue.h"
+#include "rt_scheduler.h"
+#include "runtime_profiler.h"
 #include "shared_data.h"
+#include "steering_motor.h"
+#include "system.h"
+#include "traction.h"
 #include "watchdog.h"
 
 namespace RTOSTasks {
 
-// Task handles
-TaskHandle_t safetyTaskHandle = nullptr;
-TaskHandle_t controlTaskHandle = nullptr;
-TaskHandle_t powerTaskHandle = nullptr;
-TaskHandle_t hudTaskHandle = nullptr;
-TaskHandle_t telemetryTaskHandle = nullptr;
+// Job table: registration order breaks ties inside a slot (Safety runs
+// before Control in every 10 ms slot, as with the old task priorities)
+static const RTScheduler::JobConfig JOB_TABLE[] = {
+    // name, fn, period, phase, core, budget
+    {"Safety", safetyJob, PERIOD_SAFETY_MS, 0, CORE_CRITICAL,
+     BUDGET_SAFETY_US},
+    {"Control", controlJob, PERIOD_CONTROL_MS, 0, CORE_CRITICAL,
+     BUDGET_CONTROL_US},
+    {"Power", powerJob, PERIOD_POWER_MS, PHASE_POWER_MS, CORE_CRITICAL,
+     BUDGET_POWER_US},
+    {"HUD", hudJob, PERIOD_HUD_MS, 0, CORE_GENERAL, BUDGET_HUD_US},
+    {"Telemetry", telemetryJob, PERIOD_TELEMETRY_MS, PHASE_TELEMETRY_MS,
+     CORE_GENERAL, BUDGET_TELEMETRY_US},
+    {"Profiler", profilerJob, PERIOD_PROFILER_MS, PHASE_PROFILER_MS,
+     CORE_GENERAL, BUDGET_PROFILER_US},
+    {"Journal", journalJob, PERIOD_JOURNAL_MS, PHASE_JOURNAL_MS, CORE_GENERAL,
+     BUDGET_JOURNAL_US},
+    {"Audio", audioJob, PERIOD_AUDIO_MS, PHASE_AUDIO_MS, CORE_GENERAL,
+     BUDGET_AUDIO_US},
+};
+
+// Budgeted utilization per core in per mille (us per ms of period), the
+// same sum RTScheduler::start() logs: catch an over-subscribed table here
+static_assert(BUDGET_SAFETY_US / PERIOD_SAFETY_MS +
+                      BUDGET_CONTROL_US / PERIOD_CONTROL_MS +
+                      BUDGET_POWER_US / PERIOD_POWER_MS <
+                  1000,
+              "Core 0 over-subscribed by budget");
+static_assert(BUDGET_HUD_US / PERIOD_HUD_MS +
+                      BUDGET_TELEMETRY_US / PERIOD_TELEMETRY_MS +
+                      BUDGET_PROFILER_US / PERIOD_PROFILER_MS +
+                      BUDGET_JOURNAL_US / PERIOD_JOURNAL_MS +
+                      BUDGET_AUDIO_US / PERIOD_AUDIO_MS <
+                  1000,
+              "Core 1 over-subscribed by budget");
+
+// A blocked job on core 0 also blocks the Safety job behind it, so the
+// heartbeat failsafe is enforced from core 1 by the scheduler stall check
+static void onCriticalCoreStall() {
+  Logger::error("RTOSTasks: Critical core stalled - EMERGENCY MOTOR STOP");
+  Traction::setDemand(0.0f);
+  SteeringMotor::setDemandAngle(0.0f);
+}
 
 bool init() {
-  Logger::info("RTOSTasks: Creating FreeRTOS tasks for dual-core operation");
-
-  BaseType_t result;
-
-  // Core 0 tasks - Safety critical
-  result = xTaskCreatePinnedToCore(safetyTask,              // Task function
-                                   "SafetyTask",            // Name
-                                   STACK_SIZE_SAFETY,       // Stack size
-                                   nullptr,                 // Parameters
-                                   PRIORITY_SAFETY_MANAGER, // Priority
-                                   &safetyTaskHandle,       // Handle
-                                   CORE_CRITICAL            // Core 0
-  );
-  if (result != pdPASS) {
-    Logger::error("RTOSTasks: Failed to create SafetyTask");
-    return false;
-  }
+  Logger::info("RTOSTasks: Registering job table for dual-core operation");
+  RuntimeProfiler::init();
 
-  result = xTaskCreatePinnedToCore(controlTask,              // Task function
-                                   "ControlTask",            // Name
-                                   STACK_SIZE_CONTROL,       // Stack size
-                                   nullptr,                  // Parameters
-                                   PRIORITY_CONTROL_MANAGER, // Priority
-                                   &controlTaskHandle,       // Handle
-                                   CORE_CRITICAL             // Core 0
-  );
-  if (result != pdPASS) {
-    Logger::error("RTOSTasks: Failed to create ControlTask");
-    return false;
-  }
-
-  result = xTaskCreatePinnedToCore(powerTask,              // Task function
-                                   "PowerTask",            // Name
-                                   STACK_SIZE_POWER,       // Stack size
-                                   nullptr,                // Parameters
-                                   PRIORITY_POWER_MANAGER, // Priority
-                                   &powerTaskHandle,       // Handle
-                                   CORE_CRITICAL           // Core 0
-  );
-  if (result != pdPASS) {
-    Logger::error("RTOSTasks: Failed to create PowerTask");
-    return false;
+  for (const RTScheduler::JobConfig &job : JOB_TABLE) {
+    if (RTScheduler::registerJob(job) < 0) {
+      Logger::errorf("RTOSTasks: Failed to register %s", job.name);
+      return false;
+    }
   }
 
-  // Core 1 tasks - HUD and telemetry
-  result = xTaskCreatePinnedToCore(hudTask,              // Task function
-                                   "HUDTask",            // Name
-                                   STACK_SIZE_HUD,       // Stack size
-                                   nullptr,              // Parameters
-                                   PRIORITY_HUD_MANAGER, // Priority
-                                   &hudTaskHandle,       // Handle
-                                   CORE_GENERAL          // Core 1
-  );
-  if (result != pdPASS) {
-    Logger::error("RTOSTasks: Failed to create HUDTask");
-    return false;
-  }
+  RTScheduler::setStallHandler(CORE_CRITICAL, CRITICAL_STALL_LIMIT_MS,
+                               onCriticalCoreStall);
 
-  result = xTaskCreatePinnedToCore(telemetryTask,              // Task function
-                                   "TelemetryTask",            // Name
-                                   STACK_SIZE_TELEMETRY,       // Stack size
-                                   nullptr,                    // Parameters
-                                   PRIORITY_TELEMETRY_MANAGER, // Priority
-                                   &telemetryTaskHandle,       // Handle
-                                   CORE_GENERAL                // Core 1
-  );
-  if (result != pdPASS) {
-    Logger::error("RTOSTasks: Failed to create TelemetryTask");
+  const RTScheduler::CoreConfig cores[RTScheduler::NUM_CORES] = {
+      {"CriticalExec", STACK_SIZE_CRITICAL_EXEC, PRIORITY_CRITICAL_EXEC},
+      {"GeneralExec", STACK_SIZE_GENERAL_EXEC, PRIORITY_GENERAL_EXEC},
+  };
+  if (!RTScheduler::start(cores)) {
+    Logger::error("RTOSTasks: Failed to start executives");
     return false;
   }
 
-  Logger::info("RTOSTasks: All tasks created successfully");
-  Logger::infof(
-      "RTOSTasks: Core 0 (critical): Safety(%d), Control(%d), Power(%d)",
-      PRIORITY_SAFETY_MANAGER, PRIORITY_CONTROL_MANAGER,
-      PRIORITY_POWER_MANAGER);
-  Logger::infof("RTOSTasks: Core 1 (general): HUD(%d), Telemetry(%d)",
-                PRIORITY_HUD_MANAGER, PRIORITY_TELEMETRY_MANAGER);
+  Logger::info("RTOSTasks: All jobs registered successfully");
+  Logger::infof("RTOSTasks: Core 0 (critical): Safety(%ums), Control(%ums), "
+                "Power(%ums+%u)",
+                PERIOD_SAFETY_MS, PERIOD_CONTROL_MS, PERIOD_POWER_MS,
+                PHASE_POWER_MS);
+  Logger::infof("RTOSTasks: Core 1 (general): HUD(%ums), Telemetry(%ums+%u), "
+                "Profiler(%ums+%u), Journal(%ums+%u), Audio(%ums+%u)",
+                PERIOD_HUD_MS, PERIOD_TELEMETRY_MS, PHASE_TELEMETRY_MS,
+                PERIOD_PROFILER_MS, PHASE_PROFILER_MS, PERIOD_JOURNAL_MS,
+                PHASE_JOURNAL_MS, PERIOD_AUDIO_MS, PHASE_AUDIO_MS);
 
   return true;
 }
 
-void safetyTask(void *parameter) {
-  (void)parameter;
-  TickType_t lastWakeTime = xTaskGetTickCount();
-  const TickType_t frequency = pdMS_TO_TICKS(10); // 100 Hz
-
-  Logger::info("SafetyTask: Started on Core 0");
+void safetyJob() {
+  // Update safety systems with heartbeat monitoring
+  SafetyManager::updateWithHeartbeat();
 
-  while (true) {
-    // Update safety systems with heartbeat monitoring
-    SafetyManager::updateWithHeartbeat();
-
-    // Feed watchdog from safety task
-    Watchdog::feed();
-
-    // Wait for next cycle
-    vTaskDelayUntil(&lastWakeTime, frequency);
-  }
+  // Feed watchdog from safety job
+  Watchdog::feed();
 }
 
-void controlTask(void *parameter) {
-  (void)parameter;
-  TickType_t lastWakeTime = xTaskGetTickCount();
-  const TickType_t frequency = pdMS_TO_TICKS(10); // 100 Hz
+void controlJob() {
+  // Update control systems
+  ControlManager::update();
 
-  Logger::info("ControlTask: Started on Core 0");
+  // Black box snapshot of this cycle's inputs and outputs (fixed cost)
+  BlackBox::capture();
 
-  while (true) {
-    // Update control systems
-    ControlManager::update();
-
-    // Update heartbeat in shared data
-    SharedData::ControlState state;
-    if (SharedData::readControlState(state)) {
-      state.lastHeartbeat = millis();
-      SharedData::writeControlState(state);
-    }
-
-    // Wait for next cycle
-    vTaskDelayUntil(&lastWakeTime, frequency);
+  // Update heartbeat in shared data
+  SharedData::ControlState state;
+  if (SharedData::readControlState(state)) {
+    state.lastHeartbeat = millis();
+    SharedData::writeControlState(state);
   }
 }
 
-void powerTask(void *parameter) {
-  (void)parameter;
-  TickType_t lastWakeTime = xTaskGetTickCount();
-  const TickType_t frequency = pdMS_TO_TICKS(100); // 10 Hz
-
+void powerJob() {
   // NOTE: Sensor update at 10 Hz while control runs at 100 Hz creates a 10x
   // frequency mismatch. This is acceptable because:
   // 1. Physical sensors don't change faster than 10 Hz
-  // 2. Control tasks use previous sensor values (SharedData caching)
+  // 2. Control jobs use previous sensor values (SharedData caching)
   // 3. Staleness detection ensures data freshness (<200ms)
-  // If faster sensor updates are needed, increase this frequency.
+  // If faster sensor updates are needed, shorten PERIOD_POWER_MS.
 
-  Logger::info("PowerTask: Started on Core 0");
+  // Update power management
+  PowerManager::update();
 
-  while (true) {
-    // Update power management
-    PowerManager::update();
-
-    // Update sensor data with non-blocking I2C (runs at lower priority)
-    SensorManager::updateNonBlocking();
-
-    // Wait for next cycle
-    vTaskDelayUntil(&lastWakeTime, frequency);
-  }
+  // Update sensor data with non-blocking I2C
+  SensorManager::updateNonBlocking();
 }
 
-void hudTask(void *parameter) {
-  (void)parameter;
-  TickType_t lastWakeTime = xTaskGetTickCount();
-  const TickType_t frequency = pdMS_TO_TICKS(33); // ~30 FPS
+void hudJob() {
+  // Update HUD display
+  HUDManager::update();
+}
 
-  Logger::info("HUDTask: Started on Core 1");
+void telemetryJob() {
+  // Update telemetry
+  TelemetryManager::update();
+}
 
-  while (true) {
-    // Update HUD display
-    HUDManager::update();
+void profilerJob() {
+  // Samples only when the configured interval has elapsed
+  RuntimeProfiler::update();
 
-    // Wait for next cycle
-    vTaskDelayUntil(&lastWakeTime, frequency);
-  }
+  // Stream PC samples (returns immediately when the sampler is off)
+  PcSampler::drain();
 }
 
-void telemetryTask(void *parameter) {
-  (void)parameter;
-  TickType_t lastWakeTime = xTaskGetTickCount();
-  const TickType_t frequency = pdMS_TO_TICKS(100); // 10 Hz
+void journalJob() {
+  // Sector erases (tens of ms) happen here, never in the append path.
+  // The black box gets the slot only when the journal did not erase, so
+  // one run never does two erases.
+  if (!FlashJournal::service()) BlackBox::service();
 
-  Logger::info("TelemetryTask: Started on Core 1");
-
-  while (true) {
-    // Update telemetry
-    TelemetryManager::update();
+  // Errors logged since the last run: one NVS write for the whole batch
+  System::flushErrors();
+}
 
-    // Wait for next cycle
-    vTaskDelayUntil(&lastWakeTime, frequency);
-  }
+void audioJob() {
+  // Finished/error feedback first, so a track that just ended frees the
+  // player for the next one in the same run
+  Audio::DFPlayer::update();
+  Audio::AudioQueue::update();
 }
 
 void suspendNonCriticalTasks() {
-  if (hudTaskHandle != nullptr) { vTaskSuspend(hudTaskHandle); }
-  if (telemetryTaskHandle != nullptr) { vTaskSuspend(telemetryTaskHandle); }
-  Logger::info("RTOSTasks: Non-critical tasks suspended");
+  RTScheduler::suspendCore(CORE_GENERAL);
+  Logger::info("RTOSTasks: Non-critical jobs suspended");
 }
 
 void resumeNonCriticalTasks() {
-  if (hudTaskHandle != nullptr) { vTaskResume(hudTaskHandle); }
-  if (telemetryTaskHandle != nullptr) { vTaskResume(telemetryTaskHandle); }
-  Logger::info("RTOSTasks: Non-critical tasks resumed");
+  RTScheduler::resumeCore(CORE_GENERAL);
+  Logger::info("RTOSTasks: Non-critical jobs resumed");
 }
 
 } // namespace RTOSTasks
@@ -0,0 +1,358 @@
+// runtime_profiler.cpp - Per-task CPU, stack and heap telemetry
+#include "runtime_profiler.h"
+#include "logger.h"
+#include "rt_scheduler.h"
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// Task list needs configUSE_TRACE_FACILITY, per-task CPU additionally needs
+// configGENERATE_RUN_TIME_STATS (both enabled in sdkconfig/n16r8.defaults).
+// Without them the profiler falls back to the executive tasks and the
+// RTScheduler per-core utilization.
+#if defined(configUSE_TRACE_FACILITY) && (configUSE_TRACE_FACILITY == 1)
+#define PROFILER_TASK_LIST 1
+#else
+#define PROFILER_TASK_LIST 0
+#endif
+#if PROFILER_TASK_LIST && defined(configGENERATE_RUN_TIME_STATS) &&          \
+    (configGENERATE_RUN_TIME_STATS == 1)
+#define PROFILER_RUN_TIME 1
+#else
+#define PROFILER_RUN_TIME 0
+#endif
+
+namespace RuntimeProfiler {
+
+static Config config;
+static bool initialized = false;
+static uint32_t lastSampleMs = 0;
+
+// History ring
+static Snapshot history[HISTORY_LEN];
+static uint8_t historyHead = 0; // Next write position
+static uint8_t historyCount = 0;
+
+// Latest per-task table
+static TaskSample tasks[MAX_TASKS];
+static uint8_t taskCount = 0;
+
+static uint8_t activeAlarms = ALARM_NONE;
+static bool taskOverflowReported = false;
+
+// Readers (hidden menu on core 1, loop() report) copy under this lock
+static portMUX_TYPE dataMux = portMUX_INITIALIZER_UNLOCKED;
+
+#if PROFILER_TASK_LIST
+static TaskStatus_t statusBuf[MAX_TASKS];
+#endif
+#if PROFILER_RUN_TIME
+// Run-time counters of the previous sample, matched by task handle
+struct PrevCounter {
+  TaskHandle_t handle;
+  uint32_t runTime;
+};
+static PrevCounter prevCounters[MAX_TASKS];
+static uint8_t prevCount = 0;
+static uint32_t prevTotalRunTime = 0;
+
+static uint32_t previousRunTime(TaskHandle_t handle, bool &found) {
+  for (uint8_t i = 0; i < prevCount; i++) {
+    if (prevCounters[i].handle == handle) {
+      found = true;
+      return prevCounters[i].runTime;
+    }
+  }
+  found = false;
+  return 0;
+}
+#endif
+
+static uint16_t toKb(size_t bytes) {
+  size_t kb = bytes / 1024;
+  return kb > 0xFFFF ? 0xFFFF : (uint16_t)kb;
+}
+
+static void copyName(char *dst, const char *src) {
+  strncpy(dst, src ? src : "?", TASK_NAME_LEN - 1);
+  dst[TASK_NAME_LEN - 1] = '\0';
+}
+
+// Fills out[] and the per-core load; returns task count
+static uint8_t collectTasks(TaskSample out[MAX_TASKS], uint8_t cpuPct[2]) {
+  uint8_t count = 0;
+  cpuPct[0] = (uint8_t)RTScheduler::getCoreUtilization(0);
+  cpuPct[1] = (uint8_t)RTScheduler::getCoreUtilization(1);
+
+#if PROFILER_TASK_LIST
+  UBaseType_t total = uxTaskGetNumberOfTasks();
+  if (total > MAX_TASKS) {
+    // uxTaskGetSystemState() refuses arrays smaller than the task count
+    if (!taskOverflowReported) {
+      Logger::warnf("RuntimeProfiler: %u tasks exceed table (%u)",
+                    (unsigned)total, MAX_TASKS);
+      taskOverflowReported = true;
+    }
+    return 0;
+  }
+
+  uint32_t totalRunTime = 0;
+  UBaseType_t n = uxTaskGetSystemState(statusBuf, MAX_TASKS, &totalRunTime);
+
+#if PROFILER_RUN_TIME
+  uint32_t totalDelta = totalRunTime - prevTotalRunTime;
+  bool haveDelta = prevCount > 0 && totalDelta > 0;
+  TaskHandle_t idle[2] = {xTaskGetIdleTaskHandleForCPU(0),
+                          xTaskGetIdleTaskHandleForCPU(1)};
+#endif
+
+  for (UBaseType_t i = 0; i < n; i++) {
+    const TaskStatus_t &st = statusBuf[i];
+    TaskSample &t = out[count++];
+    copyName(t.name, st.pcTaskName);
+    BaseType_t affinity = xTaskGetAffinity(st.xHandle);
+    t.core = (affinity == 0 || affinity == 1) ? (uint8_t)affinity : NO_CORE;
+    t.priority = (uint8_t)st.uxCurrentPriority;
+    // ESP-IDF stacks are byte-addressed: the high-water mark is in bytes
+    t.stackFreeBytes = st.usStackHighWaterMark;
+    t.cpuPermille = 0;
+
+#if PROFILER_RUN_TIME
+    bool found = false;
+    uint32_t prev = previousRunTime(st.xHandle, found);
+    if (haveDelta && found) {
+      uint32_t delta = st.ulRunTimeCounter - prev;
+      uint32_t permille = (uint32_t)(((uint64_t)delta * 1000) / totalDelta);
+      t.cpuPermille = permille > 1000 ? 1000 : (uint16_t)permille;
+    }
+    for (uint8_t c = 0; c < 2; c++) {
+      if (haveDelta && found && st.xHandle == idle[c]) {
+        uint16_t idlePct = t.cpuPermille / 10; // <= 100
+        cpuPct[c] = (uint8_t)(100 - idlePct);
+      }
+    }
+#endif
+  }
+
+#if PROFILER_RUN_TIME
+  prevCount = 0;
+  for (UBaseType_t i = 0; i < n; i++) {
+    prevCounters[prevCount++] = {statusBuf[i].xHandle,
+                                 statusBuf[i].ulRunTimeCounter};
+  }
+  prevTotalRunTime = totalRunTime;
+#endif
+
+#else
+  // No task list: executives only
+  for (uint8_t core = 0; core < RTScheduler::NUM_CORES; core++) {
+    TaskHandle_t h = RTScheduler::getDispatcherHandle(core);
+    if (h == nullptr) continue;
+    TaskSample &t = out[count++];
+    copyName(t.name, pcTaskGetName(h));
+    t.core = core;
+    t.priority = (uint8_t)uxTaskPriorityGet(h);
+    t.cpuPermille = (uint16_t)(RTScheduler::getCoreUtilization(core) * 10.0f);
+    t.stackFreeBytes = uxTaskGetStackHighWaterMark(h);
+  }
+#endif
+
+  // Highest CPU share first (insertion sort, <= MAX_TASKS entries)
+  for (uint8_t i = 1; i < count; i++) {
+    TaskSample key = out[i];
+    int8_t j = (int8_t)i - 1;
+    while (j >= 0 && out[j].cpuPermille < key.cpuPermille) {
+      out[j + 1] = out[j];
+      j--;
+    }
+    out[j + 1] = key;
+  }
+  return count;
+}
+
+static void reportAlarmEdges(uint8_t alarms, const Snapshot &s,
+                             const char *stackTask) {
+  uint8_t rising = alarms & ~activeAlarms;
+  if (rising & ALARM_CPU) {
+    Logger::warnf("RuntimeProfiler: CPU load core0=%u%% core1=%u%% (>%u%%)",
+                  s.cpuPct[0], s.cpuPct[1], config.cpuAlarmPct);
+  }
+  if (rising & ALARM_STACK) {
+    Logger::warnf("RuntimeProfiler: Task '%s' stack headroom %u B (<%u B)",
+                  stackTask, s.minStackBytes, config.stackAlarmBytes);
+  }
+  if (rising & ALARM_HEAP) {
+    Logger::warnf("RuntimeProfiler: Heap free %u KB (<%lu KB)", s.heapFreeKb,
+                  config.heapAlarmBytes / 1024);
+  }
+  if (rising & ALARM_FRAGMENTATION) {
+    Logger::warnf("RuntimeProfiler: Largest heap block %u KB (<%lu KB)",
+                  s.heapLargestKb, config.largestBlockAlarmBytes / 1024);
+  }
+  if (rising & ALARM_PSRAM) {
+    Logger::warnf("RuntimeProfiler: PSRAM free %u KB (<%lu KB)",
+                  s.psramFreeKb, config.psramAlarmBytes / 1024);
+  }
+  uint8_t cleared = activeAlarms & ~alarms;
+  if (cleared != 0) {
+    Logger::infof("RuntimeProfiler: Alarms cleared (0x%02X)", cleared);
+  }
+}
+
+static void streamSample(const Snapshot &s, const TaskSample *list,
+                         uint8_t count) {
+  Serial.printf("[PROF] t=%lu cpu0=%u%% cpu1=%u%% heap=%u/%u/%uKB "
+                "psram=%u/%u/%uKB minStack=%u alarms=0x%02X\n",
+                (unsigned long)s.timestampMs, s.cpuPct[0], s.cpuPct[1],
+                s.heapFreeKb, s.heapMinKb, s.heapLargestKb, s.psramFreeKb,
+                s.psramMinKb, s.psramLargestKb, s.minStackBytes, s.alarms);
+  for (uint8_t i = 0; i < count; i++) {
+    const TaskSample &t = list[i];
+    char core = t.core == NO_CORE ? '*' : (char)('0' + t.core);
+    Serial.printf("[PROF]   %-15s C%c P%-2u %3u.%u%% stack=%lu\n", t.name,
+                  core, t.priority, t.cpuPermille / 10, t.cpuPermille % 10,
+                  (unsigned long)t.stackFreeBytes);
+  }
+}
+
+void init() {
+  if (!initialized) {
+    memset(history, 0, sizeof(history));
+    historyHead = 0;
+    historyCount = 0;
+    taskCount = 0;
+    activeAlarms = ALARM_NONE;
+    initialized = true;
+  }
+  lastSampleMs = millis();
+  Logger::infof("RuntimeProfiler: init (%u ms, run-time stats %s)",
+                config.sampleIntervalMs, hasRunTimeStats() ? "on" : "off");
+}
+
+void setConfig(const Config &cfg) {
+  config = cfg;
+  Logger::infof("RuntimeProfiler: interval %u ms, stream %s",
+                config.sampleIntervalMs, config.serialStream ? "on" : "off");
+}
+
+const Config &getConfig() { return config; }
+
+bool hasRunTimeStats() { return PROFILER_RUN_TIME == 1; }
+
+void update() {
+  if (!initialized || config.sampleIntervalMs == 0) return;
+  uint32_t now = millis();
+  if (now - lastSampleMs < config.sampleIntervalMs) return;
+  lastSampleMs = now;
+  sample();
+}
+
+void sample() {
+  static TaskSample scratch[MAX_TASKS];
+  Snapshot s;
+  memset(&s, 0, sizeof(s));
+  s.timestampMs = millis();
+
+  uint8_t count = collectTasks(scratch, s.cpuPct);
+  s.taskCount = count;
+
+  s.heapFreeKb = toKb(heap_caps_get_free_size(MALLOC_CAP_INTERNAL));
+  s.heapMinKb = toKb(heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL));
+  s.heapLargestKb =
+      toKb(heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL));
+  s.psramFreeKb = toKb(heap_caps_get_free_size(MALLOC_CAP_SPIRAM));
+  s.psramMinKb = toKb(heap_caps_get_minimum_free_size(MALLOC_CAP_SPIRAM));
+  s.psramLargestKb = toKb(heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM));
+
+  // Alarms
+  const char *stackTask = "?";
+  uint32_t minStack = UINT32_MAX;
+  for (uint8_t i = 0; i < count; i++) {
+    if (scratch[i].stackFreeBytes < minStack) {
+      minStack = scratch[i].stackFreeBytes;
+      stackTask = scratch[i].name;
+    }
+  }
+  s.minStackBytes = minStack > 0xFFFF ? 0xFFFF : (uint16_t)minStack;
+
+  uint8_t alarms = ALARM_NONE;
+  if (s.cpuPct[0] > config.cpuAlarmPct || s.cpuPct[1] > config.cpuAlarmPct)
+    alarms |= ALARM_CPU;
+  if (count > 0 && minStack < config.stackAlarmBytes) alarms |= ALARM_STACK;
+  if (s.heapFreeKb * 1024UL < config.heapAlarmBytes) alarms |= ALARM_HEAP;
+  if (s.heapLargestKb * 1024UL < config.largestBlockAlarmBytes)
+    alarms |= ALARM_FRAGMENTATION;
+  // PSRAM alarm only when PSRAM exists
+  if (heap_caps_get_total_size(MALLOC_CAP_SPIRAM) > 0 &&
+      s.psramFreeKb * 1024UL < config.psramAlarmBytes)
+    alarms |= ALARM_PSRAM;
+  s.alarms = alarms;
+
+  reportAlarmEdges(alarms, s, stackTask);
+
+  portENTER_CRITICAL(&dataMux);
+  history[historyHead] = s;
+  historyHead = (historyHead + 1) % HISTORY_LEN;
+  if (historyCount < HISTORY_LEN) historyCount++;
+  memcpy(tasks, scratch, count * sizeof(TaskSample));
+  taskCount = count;
+  activeAlarms = alarms;
+  portEXIT_CRITICAL(&dataMux);
+
+  if (config.serialStream) streamSample(s, scratch, count);
+}
+
+uint8_t getHistoryCount() { return historyCount; }
+
+bool getSnapshot(uint8_t age, Snapshot &out) {
+  bool ok = false;
+  portENTER_CRITICAL(&dataMux);
+  if (age < historyCount) {
+    uint8_t idx = (historyHead + HISTORY_LEN - 1 - age) % HISTORY_LEN;
+    out = history[idx];
+    ok = true;
+  }
+  portEXIT_CRITICAL(&dataMux);
+  return ok;
+}
+
+uint8_t getTaskCount() { return taskCount; }
+
+bool getTask(uint8_t index, TaskSample &out) {
+  bool ok = false;
+  portENTER_CRITICAL(&dataMux);
+  if (index < taskCount) {
+    out = tasks[index];
+    ok = true;
+  }
+  portEXIT_CRITICAL(&dataMux);
+  return ok;
+}
+
+uint8_t getActiveAlarms() { return activeAlarms; }
+
+void setSerialStream(bool enabled) {
+  config.serialStream = enabled;
+  Logger::infof("RuntimeProfiler: serial stream %s", enabled ? "on" : "off");
+}
+
+bool isSerialStream() { return config.serialStream; }
+
+void logReport() {
+  Snapshot s;
+  if (!getSnapshot(0, s)) return;
+  Logger::infof("RuntimeProfiler: cpu0=%u%% cpu1=%u%% heap=%u/%u/%uKB "
+                "psram=%u/%u/%uKB minStack=%uB alarms=0x%02X",
+                s.cpuPct[0], s.cpuPct[1], s.heapFreeKb, s.heapMinKb,
+                s.heapLargestKb, s.psramFreeKb, s.psramMinKb,
+                s.psramLargestKb, s.minStackBytes, s.alarms);
+  TaskSample t;
+  for (uint8_t i = 0; i < s.taskCount && getTask(i, t); i++) {
+    char core = t.core == NO_CORE ? '*' : (char)('0' + t.core);
+    Logger::infof("  %-15s C%c P%-2u %3u.%u%% stack=%luB", t.name, core,
+                  t.priority, t.cpuPermille / 10, t.cpuPermille % 10,
+                  (unsigned long)t.stackFreeBytes);
+  }
+}
+
+} // namespace RuntimeProfiler
@@ -0,0 +1,98 @@
+// spi_bus.cpp - Shared SPI bus arbiter (pure logic)
+#include "spi_bus.h"
+
+namespace SpiBus {
+
+Arbiter::Arbiter()
+    : seq(0), grantUs(0), windowStartUs(0), reconfigs(0), waitingMask(0),
+      ownerDev(NONE), lastDev(NONE), yieldPending(false) {
+  for (uint8_t d = 0; d < MAX_DEVICES; d++) {
+    cfg[d] = {"", 0, 0, -1, nullptr, nullptr};
+    st[d] = {};
+    requestUs[d] = 0;
+    requestSeq[d] = 0;
+    windowBusyUs[d] = 0;
+  }
+}
+
+void Arbiter::configure(uint8_t dev, const DeviceConfig &c) {
+  if (dev < MAX_DEVICES) cfg[dev] = c;
+}
+
+void Arbiter::grant(uint8_t dev, uint32_t nowUs) {
+  ownerDev = dev;
+  grantUs = nowUs;
+  st[dev].transactions++;
+  if (lastDev != NONE && lastDev != dev) reconfigs++;
+  lastDev = dev;
+}
+
+bool Arbiter::request(uint8_t dev, uint32_t nowUs) {
+  if (dev >= MAX_DEVICES || ownerDev == dev || isWaiting(dev)) return false;
+  if (ownerDev == NONE && waitingMask == 0) {
+    grant(dev, nowUs);
+    return true;
+  }
+  waitingMask |= 1u << dev;
+  requestUs[dev] = nowUs;
+  requestSeq[dev] = seq++;
+  return false;
+}
+
+bool Arbiter::cancel(uint8_t dev, uint32_t nowUs) {
+  (void)nowUs;
+  if (dev >= MAX_DEVICES || !isWaiting(dev)) return false;
+  waitingMask &= ~(1u << dev);
+  st[dev].timeouts++;
+  return true;
+}
+
+void Arbiter::noteYield(uint8_t dev) {
+  if (dev == ownerDev) yieldPending = true;
+}
+
+void Arbiter::rollWindow(uint32_t nowUs) {
+  uint32_t window = nowUs - windowStartUs;
+  if (window < WINDOW_US) return;
+  for (uint8_t d = 0; d < MAX_DEVICES; d++) {
+    uint64_t permille = static_cast<uint64_t>(windowBusyUs[d]) * 1000 / window;
+    st[d].utilizationPermille =
+        static_cast<uint16_t>(permille > 1000 ? 1000 : permille);
+    windowBusyUs[d] = 0;
+  }
+  windowStartUs = nowUs;
+}
+
+uint8_t Arbiter::release(uint8_t dev, uint32_t nowUs) {
+  if (dev >= MAX_DEVICES || ownerDev != dev) return NONE;
+
+  uint32_t held = nowUs - grantUs;
+  st[dev].busyUs += held;
+  if (held > st[dev].maxHoldUs) st[dev].maxHoldUs = held;
+  windowBusyUs[dev] += held;
+  rollWindow(nowUs);
+  if (yieldPending) st[dev].yields++;
+  yieldPending = false;
+  ownerDev = NONE;
+
+  // Highest priority first, oldest request within a priority
+  uint8_t next = NONE;
+  for (uint8_t d = 0; d < MAX_DEVICES; d++) {
+    if (!isWaiting(d)) continue;
+    if (next == NONE || cfg[d].priority > cfg[next].priority ||
+        (cfg[d].priority == cfg[next].priority &&
+         static_cast<int32_t>(requestSeq[d] - requestSeq[next]) < 0)) {
+      next = d;
+    }
+  }
+  if (next == NONE) return NONE;
+
+  waitingMask &= ~(1u << next);
+  uint32_t waited = nowUs - requestUs[next];
+  st[next].waits++;
+  if (waited > st[next].maxWaitUs) st[next].maxWaitUs = waited;
+  grant(next, nowUs);
+  return next;
+}
+
+} // namespace SpiBus
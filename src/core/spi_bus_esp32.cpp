@@ -0,0 +1,157 @@
+// spi_bus_esp32.cpp - SpiBus service on the display SPI host
+#include "logger.h"
+#include "spi_bus.h"
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+#ifndef SPI_FREQUENCY
+#define SPI_FREQUENCY 40000000
+#endif
+#ifndef SPI_TOUCH_FREQUENCY
+#define SPI_TOUCH_FREQUENCY 2500000
+#endif
+#ifndef TFT_CS
+#define TFT_CS -1
+#endif
+#ifndef TOUCH_CS
+#define TOUCH_CS -1
+#endif
+
+// Owned by HUDManager; the display grant opens one transaction on it
+extern TFT_eSPI *tft;
+
+namespace SpiBus {
+
+static Arbiter arbiter;                  // busMux
+static portMUX_TYPE busMux = portMUX_INITIALIZER_UNLOCKED;
+static SemaphoreHandle_t granted[MAX_DEVICES] = {}; // Handed over on release
+static bool ready = false;
+
+// One TFT_eSPI transaction per grant: every push of the grant reuses the
+// clock and CS set here instead of reopening its own transaction
+static void displaySelect() {
+  if (tft) tft->startWrite();
+}
+
+static void displayDeselect() {
+  if (tft) tft->endWrite();
+}
+
+static inline uint8_t idx(Device dev) { return static_cast<uint8_t>(dev); }
+
+bool init() {
+  if (ready) return true;
+
+  for (uint8_t d = 0; d < static_cast<uint8_t>(Device::COUNT); d++) {
+    granted[d] = xSemaphoreCreateBinary();
+    if (granted[d] == nullptr) {
+      Logger::error("SpiBus: grant semaphore allocation failed");
+      return false;
+    }
+  }
+
+  // Touch conversions ask for SPI_TOUCH_FREQUENCY themselves (TFT_eSPI
+  // touch driver); no hooks, and they never run inside a display grant
+  arbiter.configure(idx(Device::DISPLAY),
+                    {"display", PRIORITY_DISPLAY, SPI_FREQUENCY, TFT_CS,
+                     displaySelect, displayDeselect});
+  arbiter.configure(idx(Device::TOUCH), {"touch", PRIORITY_TOUCH,
+                                         SPI_TOUCH_FREQUENCY, TOUCH_CS,
+                                         nullptr, nullptr});
+  ready = true;
+  return true;
+}
+
+bool acquire(Device dev, uint32_t timeoutMs) {
+  if (!ready) return false;
+  uint8_t d = idx(dev);
+
+  uint32_t now = micros();
+  portENTER_CRITICAL(&busMux);
+  bool got = arbiter.request(d, now);
+  portEXIT_CRITICAL(&busMux);
+
+  if (!got) {
+    TickType_t ticks =
+        timeoutMs == portMAX_DELAY ? portMAX_DELAY : pdMS_TO_TICKS(timeoutMs);
+    got = xSemaphoreTake(granted[d], ticks) == pdTRUE;
+    if (!got) {
+      now = micros();
+      portENTER_CRITICAL(&busMux);
+      bool withdrawn = arbiter.cancel(d, now);
+      portEXIT_CRITICAL(&busMux);
+      // Granted between the timeout and the cancel: the hand-over is
+      // given right after the releaser leaves the critical section
+      if (!withdrawn) {
+        got = xSemaphoreTake(granted[d], portMAX_DELAY) == pdTRUE;
+      }
+    }
+    if (!got) return false;
+  }
+
+  const DeviceConfig &cfg = arbiter.config(d);
+  if (cfg.select) cfg.select();
+  return true;
+}
+
+void release(Device dev) {
+  if (!ready) return;
+  uint8_t d = idx(dev);
+  if (arbiter.owner() != d) return;
+
+  const DeviceConfig &cfg = arbiter.config(d);
+  if (cfg.deselect) cfg.deselect();
+
+  uint32_t now = micros();
+  portENTER_CRITICAL(&busMux);
+  uint8_t next = arbiter.release(d, now);
+  portEXIT_CRITICAL(&busMux);
+  if (next != NONE) xSemaphoreGive(granted[next]);
+}
+
+bool yieldIfContended(Device dev) {
+  if (!ready) return false;
+  uint8_t d = idx(dev);
+
+  portENTER_CRITICAL(&busMux);
+  bool handOver = arbiter.owner() == d && arbiter.contended();
+  if (handOver) arbiter.noteYield(d);
+  portEXIT_CRITICAL(&busMux);
+  if (!handOver) return false;
+
+  release(dev);
+  acquire(dev, portMAX_DELAY);
+  return true;
+}
+
+bool isHeldBy(Device dev) { return ready && arbiter.owner() == idx(dev); }
+
+void getStats(Device dev, DeviceStats &out) {
+  portENTER_CRITICAL(&busMux);
+  out = arbiter.stats(idx(dev));
+  portEXIT_CRITICAL(&busMux);
+}
+
+uint32_t getReconfigurations() { return arbiter.reconfigurations(); }
+
+void logStats() {
+  if (!ready) return;
+  for (uint8_t d = 0; d < static_cast<uint8_t>(Device::COUNT); d++) {
+    DeviceStats s;
+    getStats(static_cast<Device>(d), s);
+    const DeviceConfig &cfg = arbiter.config(d);
+    Logger::infof("SpiBus: %s @%lu kHz: %.1f%% busy, %lu grants (max %lu "
+                  "us), waits %lu (max %lu us), %lu yields, %lu timeouts",
+                  cfg.name, (unsigned long)(cfg.clockHz / 1000),
+                  s.utilizationPermille / 10.0f,
+                  (unsigned long)s.transactions, (unsigned long)s.maxHoldUs,
+                  (unsigned long)s.waits, (unsigned long)s.maxWaitUs,
+                  (unsigned long)s.yields, (unsigned long)s.timeouts);
+  }
+  Logger::infof("SpiBus: %lu device switches",
+                (unsigned long)arbiter.reconfigurations());
+}
+
+} // namespace SpiBus
@@ -1,117 +1,109 @@
 #include "storage.h"
+#include "config_store.h"
+#include "flash_journal.h"
 #include "logger.h"
-#include "settings.h"
 #include "system.h" // 🔒 v2.4.1: Para logError
-#include <Preferences.h>
-
-static Preferences prefs;
 
 // Global config variable
 Storage::Config cfg;
 
-static const char *kNamespace = "vehicle";
-static const char *kKeyBlob = "config";
+// Storage::Config es la vista plana histórica de las secciones de
+// ConfigStore que usa el resto del firmware (extern cfg). La persistencia
+// real es por campo: save() solo escribe las claves que cambiaron.
+static void fromStore(Storage::Config &c, const ConfigStore::Vehicle &v,
+                      const ConfigStore::Hud &h, const ConfigStore::Sensors &s,
+                      const ConfigStore::General &g,
+                      const ConfigStore::Maintenance &m,
+                      const ConfigStore::Errors &e) {
+  c.pedalMin = v.pedalMin;
+  c.pedalMax = v.pedalMax;
+  c.pedalCurve = v.pedalCurve;
+  c.regenPercent = v.regenPercent;
+  memcpy(c.shuntCoeff, v.shuntCoeff, sizeof(c.shuntCoeff));
+  c.steerZeroOffset = v.steerZeroOffset;
+  c.maxBatteryCurrentA = v.maxBatteryCurrentA;
+  c.maxMotorCurrentA = v.maxMotorCurrentA;
+  c.tractionEnabled = v.tractionEnabled;
+  c.steeringEnabled = v.steeringEnabled;
+
+  c.showTemps = h.showTemps;
+  c.showEffort = h.showEffort;
+  c.displayBrightness = h.displayBrightness;
+  c.touchEnabled = h.touchEnabled;
+  memcpy(c.touchCalibration, h.touchCalibration, sizeof(c.touchCalibration));
+  c.touchCalibrated = h.touchCalibrated;
+  c.shadowHudEnabled = h.shadowHudEnabled;
+
+  c.wheelSensorsEnabled = s.wheelSensorsEnabled;
+  c.tempSensorsEnabled = s.tempSensorsEnabled;
+  c.currentSensorsEnabled = s.currentSensorsEnabled;
+
+  c.audioEnabled = g.audioEnabled;
+
+  c.odometer = m.odometer;
+  c.maintenanceIntervalKm = m.intervalKm;
+  c.maintenanceIntervalDays = m.intervalDays;
+
+  memcpy(c.errors, e.entries, sizeof(c.errors));
+  c.errorCount = e.count;
+
+  c.version = Storage::kConfigVersion;
+  c.checksum = Storage::computeChecksum(c);
+}
 
-// 🔒 v2.4.1: Magic number para detección de corrupción EEPROM
-static const uint32_t MAGIC_NUMBER = 0xDEADBEEF;
-static const char *kKeyMagic = "magic";
+static void toStore(const Storage::Config &c) {
+  ConfigStore::Vehicle &v = ConfigStore::vehicle();
+  v.pedalMin = c.pedalMin;
+  v.pedalMax = c.pedalMax;
+  v.pedalCurve = c.pedalCurve;
+  v.regenPercent = c.regenPercent;
+  memcpy(v.shuntCoeff, c.shuntCoeff, sizeof(v.shuntCoeff));
+  v.steerZeroOffset = c.steerZeroOffset;
+  v.maxBatteryCurrentA = c.maxBatteryCurrentA;
+  v.maxMotorCurrentA = c.maxMotorCurrentA;
+  v.tractionEnabled = c.tractionEnabled;
+  v.steeringEnabled = c.steeringEnabled;
+
+  ConfigStore::Hud &h = ConfigStore::hud();
+  h.showTemps = c.showTemps;
+  h.showEffort = c.showEffort;
+  h.displayBrightness = c.displayBrightness;
+  h.touchEnabled = c.touchEnabled;
+  memcpy(h.touchCalibration, c.touchCalibration, sizeof(h.touchCalibration));
+  h.touchCalibrated = c.touchCalibrated;
+  h.shadowHudEnabled = c.shadowHudEnabled;
+
+  ConfigStore::Sensors &s = ConfigStore::sensors();
+  s.wheelSensorsEnabled = c.wheelSensorsEnabled;
+  s.tempSensorsEnabled = c.tempSensorsEnabled;
+  s.currentSensorsEnabled = c.currentSensorsEnabled;
+
+  ConfigStore::general().audioEnabled = c.audioEnabled;
+
+  ConfigStore::Maintenance &m = ConfigStore::maintenance();
+  m.odometer = c.odometer;
+  m.intervalKm = c.maintenanceIntervalKm;
+  m.intervalDays = c.maintenanceIntervalDays;
+
+  ConfigStore::Errors &e = ConfigStore::errors();
+  memcpy(e.entries, c.errors, sizeof(e.entries));
+  e.count = c.errorCount;
+}
 
 void Storage::init() {
-  if (!prefs.begin(kNamespace, false)) {
-    Logger::warn("Storage init: fallo al abrir namespace");
+  if (!ConfigStore::init()) {
+    Logger::warn("Storage init: fallo al montar ConfigStore");
     System::logError(970); // código: fallo apertura storage
   } else {
-    // 🔒 v2.10.8: Confirm storage initialization
-    Logger::info("Storage init: EEPROM namespace abierto correctamente");
-
-    // Verificar si hay datos guardados
-    if (prefs.isKey(kKeyMagic)) {
-      uint32_t magic = prefs.getUInt(kKeyMagic, 0);
-      if (magic == MAGIC_NUMBER) {
-        Logger::info("Storage init: Datos válidos detectados en EEPROM");
-      } else {
-        Logger::warn("Storage init: Magic number incorrecto - EEPROM puede "
-                     "estar corrupta");
-      }
-    } else {
-      Logger::info("Storage init: EEPROM vacía o primera inicialización");
-    }
+    Logger::info("Storage init: ConfigStore montado correctamente");
   }
+  load(cfg);
 }
 
 void Storage::defaults(Config &cfg) {
-  // Pedal
-  cfg.pedalMin = 200;  // ejemplo
-  cfg.pedalMax = 3800; // ejemplo
-  cfg.pedalCurve = 0;
-
-  // Freno regenerativo
-  cfg.regenPercent = REGEN_DEFAULT;
-
-  // INA226 shunts (coeficiente de conversión corriente)
-  cfg.shuntCoeff[0] = 0.0010f; // batería 100A
-  cfg.shuntCoeff[1] = 0.0020f; // rueda FL 50A
-  cfg.shuntCoeff[2] = 0.0020f; // rueda FR 50A
-  cfg.shuntCoeff[3] = 0.0020f; // rueda RL 50A
-  cfg.shuntCoeff[4] = 0.0020f; // rueda RR 50A
-  cfg.shuntCoeff[5] = 0.0020f; // dirección 50A
-
-  // Dirección
-  cfg.steerZeroOffset = 0;
-
-  // HUD
-  cfg.showTemps = true;
-  cfg.showEffort = true;
-  cfg.displayBrightness = DISPLAY_BRIGHTNESS_DEFAULT; // Default brightness
-
-  // Módulos
-  // v2.14.0: lightsEnabled and multimediaEnabled removed
-  cfg.audioEnabled = true;
-  cfg.tractionEnabled = true; // Módulo de tracción habilitado por defecto
-
-  // Nuevos flags de tolerancia a fallos
-  // ⚙️ Sensores deshabilitados por defecto hasta confirmar hardware presente
-  cfg.wheelSensorsEnabled = false;
-  cfg.tempSensorsEnabled = false;
-  cfg.currentSensorsEnabled = false;
-  cfg.steeringEnabled = false;
-
-  // 🔒 v2.8.6: Touch screen configuration
-  cfg.touchEnabled = true; // Touch habilitado por defecto
-
-  // 🔒 v2.9.0: Touch calibration defaults (from TouchCalibration namespace)
-  cfg.touchCalibration[0] = 200;  // min_x (RAW_MIN)
-  cfg.touchCalibration[1] = 3900; // max_x (RAW_MAX)
-  cfg.touchCalibration[2] = 200;  // min_y (RAW_MIN)
-  cfg.touchCalibration[3] = 3900; // max_y (RAW_MAX)
-  cfg.touchCalibration[4] = 3;    // rotation (matches tft.setRotation(3))
-  cfg.touchCalibrated = false;    // No calibration done yet (using defaults)
-
-  // PHASE 7: Shadow Mode validation
-  cfg.shadowHudEnabled = false; // Disabled by default (enable in hidden menu)
-
-  // 🔒 v2.10.2: Límites de corriente configurables
-  cfg.maxBatteryCurrentA = 100.0f; // Default: 100A para batería
-  cfg.maxMotorCurrentA = 50.0f;    // Default: 50A por motor
-
-  // 🔒 v2.4.2: Odómetro y mantenimiento
-  cfg.odometer.totalKm = 0.0f;
-  cfg.odometer.tripKm = 0.0f;
-  cfg.odometer.lastServiceKm = 0.0f;
-  cfg.odometer.lastServiceDate = 0;
-  cfg.odometer.engineHours = 0;
-  cfg.maintenanceIntervalKm = 500;   // Mantenimiento cada 500 km
-  cfg.maintenanceIntervalDays = 180; // Mantenimiento cada 6 meses (180 días)
-
-  // Errores persistentes
-  cfg.errorCount = 0;
-  for (int i = 0; i < Config::MAX_ERRORS; i++) {
-    cfg.errors[i] = {0, 0};
-  }
-
-  // versión y checksum
-  cfg.version = kConfigVersion;
-  cfg.checksum = computeChecksum(cfg);
+  const ConfigStore::Settings &d = ConfigStore::defaults();
+  fromStore(cfg, d.vehicle, d.hud, d.sensors, d.general, d.maintenance,
+            d.errors);
 }
 
 uint32_t Storage::computeChecksum(const Config &cfg) {
@@ -167,18 +159,42 @@ uint32_t Storage::computeChecksum(const Config &cfg) {
   return h;
 }
 
+// El odómetro vive en el FlashJournal (un registro por actualización, sin
+// reescribir el blob completo); la copia del blob NVS es solo respaldo
+static void loadOdometerFromJournal(Storage::Config &cfg) {
+  Storage::OdometerData odo;
+  if (FlashJournal::read(FlashJournal::KEY_ODOMETER, &odo, sizeof(odo))) {
+    cfg.odometer = odo;
+  } else if (FlashJournal::isMounted()) {
+    // Primer arranque con journal: migrar el odómetro del blob NVS
+    FlashJournal::append(FlashJournal::KEY_ODOMETER, &cfg.odometer,
+                         sizeof(cfg.odometer));
+  }
+}
+
+static bool saveOdometer() {
+  if (FlashJournal::isMounted()) {
+    return FlashJournal::append(FlashJournal::KEY_ODOMETER, &cfg.odometer,
+                                sizeof(cfg.odometer));
+  }
+  return Storage::save(cfg);
+}
+
 void Storage::load(Config &cfg) {
-  // 🔒 v2.4.2: Verificar corrupción antes de cargar
+  // 🔒 v2.4.2: Sin almacenamiento montado se usan los valores por defecto
   if (isCorrupted()) {
-    Logger::error("Storage: EEPROM corrupta. Restaurando valores por defecto.");
+    Logger::error("Storage: ConfigStore no montado. Usando valores por "
+                  "defecto.");
     System::logError(975); // código: restauración automática
     defaults(cfg);
-    save(cfg); // Guardar defaults para próximo arranque
+    loadOdometerFromJournal(cfg); // El odómetro sobrevive a la config
     return;
   }
 
-  // Datos verificados - cargar configuración
-  prefs.getBytes(kKeyBlob, &cfg, sizeof(Config));
+  fromStore(cfg, ConfigStore::vehicle(), ConfigStore::hud(),
+            ConfigStore::sensors(), ConfigStore::general(),
+            ConfigStore::maintenance(), ConfigStore::errors());
+  loadOdometerFromJournal(cfg);
 
   // 🔒 v2.9.5: MIGRATION FIX - Force enable touch if disabled
   // Older configs may have touchEnabled=false causing circular dependency issue
@@ -196,76 +212,39 @@ void Storage::load(Config &cfg) {
 }
 
 bool Storage::save(const Config &cfgIn) {
-  Config tmp = cfgIn;
-  tmp.version = kConfigVersion;
-  tmp.checksum = computeChecksum(tmp);
-
-  // 🔒 v2.4.1: Guardar magic number primero
-  if (!prefs.putUInt(kKeyMagic, MAGIC_NUMBER)) {
-    Logger::error("Storage save: fallo al escribir magic number");
-    System::logError(980); // código: fallo escritura magic
+  if (!ConfigStore::isMounted()) {
+    Logger::error("Storage save: ConfigStore no montado");
+    System::logError(980); // código: fallo escritura
     return false;
   }
 
-  size_t written = prefs.putBytes(kKeyBlob, &tmp, sizeof(Config));
-  if (written != sizeof(Config)) {
-    Logger::errorf("Storage save: fallo al escribir (%u bytes vs %u esperados)",
-                   written, sizeof(Config));
+  // Solo se escriben las claves que cambiaron desde la última carga
+  toStore(cfgIn);
+  static const ConfigStore::Section SECTIONS[] = {
+      ConfigStore::SECTION_VEHICLE, ConfigStore::SECTION_HUD,
+      ConfigStore::SECTION_SENSORS, ConfigStore::SECTION_GENERAL,
+      ConfigStore::SECTION_MAINTENANCE, ConfigStore::SECTION_ERRORS};
+  bool ok = true;
+  for (ConfigStore::Section section : SECTIONS) {
+    ok &= ConfigStore::commit(section);
+  }
+  if (!ok) {
+    Logger::error("Storage save: fallo al escribir la configuración");
     System::logError(981); // código: fallo escritura config
     return false;
   }
-
-  Logger::infof("Storage: Config guardada OK (v%u, checksum 0x%08X)",
-                tmp.version, tmp.checksum);
   return true;
 }
 
 void Storage::resetToFactory() {
-  prefs.clear();
+  ConfigStore::resetToDefaults();
   Logger::warn("Storage: reset a valores de fábrica");
   System::logError(985); // código: reset a fábrica (info)
 }
 
-// 🔒 v2.4.2: Función para verificar corrupción de EEPROM
-bool Storage::isCorrupted() {
-  // Verificar magic number
-  uint32_t magic = prefs.getUInt(kKeyMagic, 0);
-  if (magic != MAGIC_NUMBER) {
-    Logger::warnf("Storage: magic number inválido (0x%08X vs 0x%08X)", magic,
-                  MAGIC_NUMBER);
-    return true;
-  }
-
-  // Verificar tamaño de datos
-  size_t len = prefs.getBytesLength(kKeyBlob);
-  if (len != sizeof(Config)) {
-    Logger::warnf("Storage: tamaño inválido (%u vs %u)", len, sizeof(Config));
-    return true;
-  }
-
-  // Leer config temporal para verificar checksum
-  Config tempCfg;
-  prefs.getBytes(kKeyBlob, &tempCfg, sizeof(Config));
-
-  // Verificar versión
-  if (tempCfg.version != kConfigVersion) {
-    Logger::warnf("Storage: versión inválida (%u vs %u)", tempCfg.version,
-                  kConfigVersion);
-    return true;
-  }
-
-  // Calcular y comparar checksum
-  uint32_t storedChecksum = tempCfg.checksum;
-  uint32_t currentChecksum = computeChecksum(tempCfg);
-
-  if (storedChecksum != currentChecksum) {
-    Logger::warnf("Storage corrupta: checksum esperado=0x%08X, actual=0x%08X",
-                  storedChecksum, currentChecksum);
-    return true;
-  }
-
-  return false; // Datos válidos
-}
+// 🔒 v2.4.2: Sin ConfigStore montado no hay configuración válida que cargar
+// (cada clave NVS lleva su propio CRC y los rangos se validan al leer)
+bool Storage::isCorrupted() { return !ConfigStore::isMounted(); }
 
 // ============================================================================
 // 🔒 v2.4.2: Funciones de Odómetro y Mantenimiento
@@ -277,17 +256,18 @@ void Storage::updateOdometer(float distanceKm) {
   cfg.odometer.totalKm += distanceKm;
   cfg.odometer.tripKm += distanceKm;
 
-  // Guardar cada 0.1 km para evitar escrituras excesivas
+  // Guardar cada 0.01 km en el journal (0.1 km si solo hay NVS)
+  const float saveStepKm = FlashJournal::isMounted() ? 0.01f : 0.1f;
   static float lastSavedKm = 0.0f;
-  if (cfg.odometer.totalKm - lastSavedKm >= 0.1f) {
-    save(cfg);
+  if (cfg.odometer.totalKm - lastSavedKm >= saveStepKm) {
+    saveOdometer();
     lastSavedKm = cfg.odometer.totalKm;
   }
 }
 
 void Storage::resetTripOdometer() {
   cfg.odometer.tripKm = 0.0f;
-  save(cfg);
+  saveOdometer();
   Logger::info("Odómetro parcial reseteado");
 }
 
@@ -295,7 +275,7 @@ void Storage::recordMaintenance() {
   cfg.odometer.lastServiceKm = cfg.odometer.totalKm;
   cfg.odometer.lastServiceDate =
       millis() / 1000; // Segundos desde arranque (usar RTC si disponible)
-  save(cfg);
+  saveOdometer();
   Logger::infof("Mantenimiento registrado a %.1f km", cfg.odometer.totalKm);
 }
 
@@ -1,11 +1,13 @@
 #include "system.h"
 #include "abs_system.h" // 🔒 v2.11.0: Sistema ABS
 #include "boot_guard.h" // 🔒 v2.17.1: Boot counter and safe mode detection
+#include "config_store.h" // Configuración persistente unificada
 #include "current.h"
 #include "dfplayer.h"
-#include "eeprom_persistence.h" // 🔒 v2.11.0: Persistencia de configuración
-#include "error_codes.h"        // 🔒 v2.11.0: Códigos de error centralizados
-#include "led_controller.h"     // 🔒 v2.11.0: Control LEDs
+#include "error_codes.h"    // 🔒 v2.11.0: Códigos de error centralizados
+#include "error_journal.h"  // Registro lock-free, volcado diferido
+#include "led_controller.h" // 🔒 v2.11.0: Control LEDs
+#include "limp_mode.h"
 #include "logger.h"
 #include "obstacle_safety.h" // 🔒 v2.11.0: Seguridad obstáculos
 #include "operation_modes.h" // Sistema de modos de operación con tolerancia a fallos
@@ -205,79 +207,47 @@ void System::init() {
   }
   Logger::info("System init: === FIN DIAGNÓSTICO DE MEMORIA ===");
 
-  // 🔒 v2.11.2: VALIDACIÓN 3 - Cargar y validar configuración persistente
-  Logger::info("System init: Cargando configuración persistente");
-  if (!EEPROMPersistence::init()) {
-    Logger::warn("System init: EEPROM persistence init failed, using defaults");
-    // 🔒 No es crítico - continuamos con valores por defecto
+  // 🔒 v2.11.2: VALIDACIÓN 3 - Configuración persistente (ConfigStore ya
+  // montado por Storage::init; valores fuera de rango vuelven al default)
+  Logger::info("System init: Aplicando configuración persistente");
+  if (!ConfigStore::isMounted()) {
+    Logger::warn("System init: ConfigStore no montado, usando defaults");
   }
 
-  // 🔒 v2.11.2: VALIDACIÓN 4 - Cargar configuración general con validación
-  GeneralSettings settings;
+  // 🔒 v2.11.2: VALIDACIÓN 4 - Aplicar toggles de módulos
+  const ConfigStore::General &settings = ConfigStore::general();
 
-  if (EEPROMPersistence::loadGeneralSettings(settings)) {
-    Logger::info("System init: Configuración general cargada exitosamente");
+  ABSSystem::setEnabled(settings.absEnabled);
+  Logger::infof("System init: ABS %s",
+                settings.absEnabled ? "enabled" : "disabled");
 
-    // Aplicar toggles de módulos según configuración cargada
-    ABSSystem::setEnabled(settings.absEnabled);
-    Logger::infof("System init: ABS %s",
-                  settings.absEnabled ? "enabled" : "disabled");
+  TCSSystem::setEnabled(settings.tcsEnabled);
+  Logger::infof("System init: TCS %s",
+                settings.tcsEnabled ? "enabled" : "disabled");
 
-    TCSSystem::setEnabled(settings.tcsEnabled);
-    Logger::infof("System init: TCS %s",
-                  settings.tcsEnabled ? "enabled" : "disabled");
+  RegenAI::setEnabled(settings.regenEnabled);
+  Logger::infof("System init: Regen %s",
+                settings.regenEnabled ? "enabled" : "disabled");
 
-    RegenAI::setEnabled(settings.regenEnabled);
-    Logger::infof("System init: Regen %s",
-                  settings.regenEnabled ? "enabled" : "disabled");
-  } else {
-    Logger::warn("System init: No se pudo cargar configuración general, usando "
-                 "defaults");
-    // 🔒 Aplicar configuración segura por defecto
-    ABSSystem::setEnabled(false); // Deshabilitado por seguridad
-    TCSSystem::setEnabled(false); // Deshabilitado por seguridad
-    RegenAI::setEnabled(false);   // Deshabilitado por seguridad
-    Logger::info("System init: Módulos avanzados deshabilitados (modo seguro)");
-  }
-
-  // 🔒 v2.11.2: VALIDACIÓN 5 - Cargar y aplicar configuración de LEDs con
-  // validación 🔒 v2.17.1: Skip LEDs in safe mode (non-critical system)
-  LEDConfig ledConfig;
-
-  // Check if safe mode is active (bootloop detected)
+  // 🔒 v2.11.2: VALIDACIÓN 5 - Aplicar configuración de LEDs
+  // 🔒 v2.17.1: Skip LEDs in safe mode (non-critical system)
   bool safeModeActive = BootGuard::shouldEnterSafeMode();
 
   if (safeModeActive) {
     Logger::warn(
         "System init: SAFE MODE - Skipping LED initialization (non-critical)");
     LEDController::setEnabled(false);
-  } else if (EEPROMPersistence::loadLEDConfig(ledConfig)) {
-    Logger::info("System init: Configuración LED cargada exitosamente");
-
-    // 🔒 Validar configuración (brightness es uint8_t, siempre válido 0-255)
-    // Validar pattern si tiene rango limitado
+  } else {
+    const ConfigStore::Leds &ledConfig = ConfigStore::leds();
     LEDController::setEnabled(ledConfig.enabled);
     LEDController::setBrightness(ledConfig.brightness);
-
-    if (LEDController::initOK()) {
-      auto &cfgLed = LEDController::getConfig();
-      cfgLed.updateRateMs = 50; // Default update rate
-    } else {
-      Logger::warn(
-          "System init: LEDController not initialized, skipping config");
-    }
+    // LEDController::init() runs after this (boot step "LEDs") and starts
+    // the LED task with these settings
+    LEDController::getConfig().updateRateMs = 50; // Default update rate
 
     Logger::infof("System init: LEDs %s, brightness %d",
                   ledConfig.enabled ? "enabled" : "disabled",
                   ledConfig.brightness);
-  } else {
-    Logger::warn(
-        "System init: No se pudo cargar configuración LED, usando defaults");
-    // 🔒 Aplicar configuración segura por defecto
-    LEDController::setEnabled(
-        false); // Deshabilitado por defecto si no hay config
-    LEDController::setBrightness(128); // Brillo medio
-    Logger::info("System init: LEDs en modo seguro (deshabilitados)");
   }
 
   // Habilitar características de seguridad de obstáculos
@@ -507,33 +477,65 @@ void System::update() {
 System::State System::getState() { return currentState; }
 
 // --- API de diagnóstico persistente ---
-void System::logError(uint16_t code) {
+void System::logError(uint16_t code, uint32_t context) {
+  bool isNew = false;
+  ErrorJournal::record(code, millis(), context, &isNew);
+  // Código nuevo: LimpMode lo cuenta en su próximo tick, sin esperar al
+  // volcado de 1 s del job Journal
+  if (isNew) LimpMode::notify(LimpMode::SOURCE_ERRORS);
+}
+
+// Alta en cfg.errors (FIFO, sin duplicados) de un código nuevo del journal
+static bool persistentDirty = false;
+static void appendPersistent(const ErrorJournal::Entry &e) {
   for (int i = 0; i < cfg.errorCount; i++) {
-    if (cfg.errors[i].code == code) return;
+    if (cfg.errors[i].code == e.code) return;
   }
   if (cfg.errorCount < Storage::Config::MAX_ERRORS) {
-    cfg.errors[cfg.errorCount++] = {code, millis()};
+    cfg.errors[cfg.errorCount++] = {e.code, e.firstMs};
   } else {
     for (int i = 1; i < Storage::Config::MAX_ERRORS; i++)
       cfg.errors[i - 1] = cfg.errors[i];
-    cfg.errors[Storage::Config::MAX_ERRORS - 1] = {code, millis()};
+    cfg.errors[Storage::Config::MAX_ERRORS - 1] = {e.code, e.firstMs};
+  }
+  persistentDirty = true;
+}
+
+void System::flushErrors() {
+  if (!ErrorJournal::pending()) return;
+  ErrorJournal::flush(appendPersistent);
+  if (persistentDirty) {
+    persistentDirty = false;
+    Storage::save(cfg); // Una escritura NVS por lote
+    LimpMode::notify(LimpMode::SOURCE_ERRORS);
   }
-  Storage::save(cfg);
 }
 
 const Storage::ErrorLog *System::getErrors() { return cfg.errors; }
 
 int System::getErrorCount() { return cfg.errorCount; }
 
+// Los persistidos más los del journal aún sin volcar que no estén ya en
+// cfg.errors (los mismos que añadirá appendPersistent)
+int System::getDistinctErrorCount() {
+  return ErrorJournal::distinctCount(cfg.errors, cfg.errorCount,
+                                     Storage::Config::MAX_ERRORS);
+}
+
 void System::clearErrors() {
+  ErrorJournal::clear();
   cfg.errorCount = 0;
   for (int i = 0; i < Storage::Config::MAX_ERRORS; i++) {
     cfg.errors[i] = {0, 0};
   }
   Storage::save(cfg);
+  LimpMode::notify(LimpMode::SOURCE_ERRORS);
 }
 
-bool System::hasError() { return currentState == ERROR || cfg.errorCount > 0; }
+bool System::hasError() {
+  // pending(): errores aún no volcados por el job Journal
+  return currentState == ERROR || cfg.errorCount > 0 || ErrorJournal::pending();
+}
 
 // Diagnóstico de estado de inicialización (thread-safe)
 bool System::isInitialized() {
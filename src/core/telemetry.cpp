@@ -1,12 +1,18 @@
 #include "telemetry.h"
+#include "flash_journal.h"
 #include "logger.h"
 #include "storage.h"
+#include <Arduino.h>
 #include <Preferences.h>
 #include <cmath>
 
 // ============================================================================
 // telemetry.cpp - Sistema de Telemetría Avanzada v2.8.0
 // Implementación con persistencia en NVS (Preferences)
+// Los contadores acumulados (km, energía, horas) van además al FlashJournal
+// en cada guardado: un registro de 48 bytes sin borrado de sector, así que
+// el intervalo baja a 5 s sin desgastar la flash. El blob completo en NVS
+// (máximos, medias) se sigue escribiendo cada NVS_REFRESH_SAVES guardados.
 // ============================================================================
 
 namespace Telemetry {
@@ -37,6 +43,22 @@ static uint32_t tempSamples = 0;
 // Namespace para NVS
 static const char *NVS_NAMESPACE = "telemetry";
 
+// Contadores persistentes en el journal (registro <= MAX_PAYLOAD bytes)
+struct JournalCounters {
+  double totalDistanceKm;
+  double tripDistanceKm;
+  double energyConsumedKwh;
+  double regenEnergyKwh;
+  uint64_t runtimeSeconds;
+  uint32_t regenActivations;
+  uint32_t reserved;
+};
+static_assert(sizeof(JournalCounters) <= FlashJournal::MAX_PAYLOAD,
+              "JournalCounters no cabe en un registro del journal");
+
+static const uint8_t NVS_REFRESH_SAVES = 12; // 12 x 5 s = cadencia anterior
+static uint8_t savesSinceNvs = 0;
+
 // -----------------------
 // Funciones auxiliares
 // -----------------------
@@ -56,6 +78,82 @@ static bool isCorrupted(const VehicleData &d) {
   return (d.magic != 0xDEADBEEF || d.checksum != calculateChecksum(d));
 }
 
+static void saveToNvs() {
+  data.checksum = calculateChecksum(data);
+
+  if (!prefs.begin(NVS_NAMESPACE, false)) {
+    Logger::error("Telemetry: Failed to open NVS for writing");
+    return;
+  }
+
+  // Guardar datos como blob
+  size_t written = prefs.putBytes("data", &data, sizeof(VehicleData));
+  prefs.end();
+
+  if (written == sizeof(VehicleData)) {
+    Logger::debug("Telemetry: Datos guardados en storage");
+  } else {
+    Logger::errorf("Telemetry: Error guardando datos (%u/%u bytes)", written,
+                   sizeof(VehicleData));
+  }
+}
+
+static bool appendToJournal() {
+  JournalCounters c = {};
+  c.totalDistanceKm = data.totalDistanceKm;
+  c.tripDistanceKm = data.tripDistanceKm;
+  c.energyConsumedKwh = data.energyConsumedKwh;
+  c.regenEnergyKwh = data.regenEnergyKwh;
+  c.runtimeSeconds = data.runtimeSeconds;
+  c.regenActivations = data.regenActivations;
+  return FlashJournal::append(FlashJournal::KEY_TELEMETRY, &c, sizeof(c));
+}
+
+static bool loadFromJournal() {
+  JournalCounters c;
+  if (!FlashJournal::read(FlashJournal::KEY_TELEMETRY, &c, sizeof(c))) {
+    return false;
+  }
+  data.totalDistanceKm = c.totalDistanceKm;
+  data.tripDistanceKm = c.tripDistanceKm;
+  data.energyConsumedKwh = c.energyConsumedKwh;
+  data.regenEnergyKwh = c.regenEnergyKwh;
+  data.runtimeSeconds = c.runtimeSeconds;
+  data.regenActivations = c.regenActivations;
+  return true;
+}
+
+static void loadFromNvs() {
+  if (!prefs.begin(NVS_NAMESPACE, true)) {
+    Logger::warn("Telemetry: NVS no existe, usando valores por defecto");
+    data = VehicleData();
+    return;
+  }
+
+  size_t len = prefs.getBytesLength("data");
+
+  if (len != sizeof(VehicleData)) {
+    Logger::warnf("Telemetry: Tamaño datos inválido (%u vs %u)", len,
+                  sizeof(VehicleData));
+    prefs.end();
+    data = VehicleData();
+    saveToNvs();
+    return;
+  }
+
+  VehicleData temp;
+  prefs.getBytes("data", &temp, sizeof(VehicleData));
+  prefs.end();
+
+  if (isCorrupted(temp)) {
+    Logger::warn("Telemetry: Datos corruptos, restaurando valores por defecto");
+    data = VehicleData();
+    saveToNvs();
+  } else {
+    data = temp;
+  }
+}
+
 // -----------------------
 // API pública - Implementaciones
 // -----------------------
@@ -120,56 +218,33 @@ void resetTrip() {
 }
 
 void saveToStorage() {
-  data.checksum = calculateChecksum(data);
-
-  if (!prefs.begin(NVS_NAMESPACE, false)) {
-    Logger::error("Telemetry: Failed to open NVS for writing");
-    return;
-  }
-
-  // Guardar datos como blob
-  size_t written = prefs.putBytes("data", &data, sizeof(VehicleData));
-  prefs.end();
-
-  if (written == sizeof(VehicleData)) {
-    Logger::debug("Telemetry: Datos guardados en storage");
-  } else {
-    Logger::errorf("Telemetry: Error guardando datos (%u/%u bytes)", written,
-                   sizeof(VehicleData));
+  if (FlashJournal::isMounted() && !appendToJournal()) {
+    Logger::warn("Telemetry: Error escribiendo contadores en el journal");
   }
+  // Sin journal el blob NVS mantiene su cadencia de 60 s
+  if (++savesSinceNvs < NVS_REFRESH_SAVES) return;
+  savesSinceNvs = 0;
+  saveToNvs();
 }
 
 void loadFromStorage() {
-  if (!prefs.begin(NVS_NAMESPACE, true)) {
-    Logger::warn("Telemetry: NVS no existe, usando valores por defecto");
-    data = VehicleData();
-    return;
-  }
+  // Blob NVS primero (métricas completas); el journal tiene los contadores
+  // más recientes y los sobrescribe
+  loadFromNvs();
 
-  size_t len = prefs.getBytesLength("data");
-
-  if (len != sizeof(VehicleData)) {
-    Logger::warnf("Telemetry: Tamaño datos inválido (%u vs %u)", len,
-                  sizeof(VehicleData));
-    prefs.end();
-    data = VehicleData();
-    saveToStorage();
+  if (loadFromJournal()) {
+    Logger::infof("Telemetry: Cargado %.1f km, %lu horas (journal)",
+                  data.totalDistanceKm,
+                  static_cast<unsigned long>(data.runtimeSeconds / 3600));
     return;
   }
 
-  VehicleData temp;
-  prefs.getBytes("data", &temp, sizeof(VehicleData));
-  prefs.end();
-
-  if (isCorrupted(temp)) {
-    Logger::warn("Telemetry: Datos corruptos, restaurando valores por defecto");
-    data = VehicleData();
-    saveToStorage();
-  } else {
-    data = temp;
-    Logger::infof("Telemetry: Cargado %.1f km, %lu horas", data.totalDistanceKm,
-                  static_cast<unsigned long>(data.runtimeSeconds / 3600));
+  // Primer arranque con journal: migrar los contadores del blob NVS
+  if (FlashJournal::isMounted() && appendToJournal()) {
+    Logger::info("Telemetry: Contadores migrados de NVS al journal");
   }
+  Logger::infof("Telemetry: Cargado %.1f km, %lu horas", data.totalDistanceKm,
+                static_cast<unsigned long>(data.runtimeSeconds / 3600));
 }
 
 void setEnabled(bool enable) { cfg.enabled = enable; }
@@ -190,20 +265,10 @@ float getEstimatedRangeKm() {
   return (remainingKwh * 1000.0f) / consumption;
 }
 
-String exportToJson() {
-  String json = "{";
-  json += "\"distanceKm\":" + String(data.totalDistanceKm, 2) + ",";
-  json += "\"tripKm\":" + String(data.tripDistanceKm, 2) + ",";
-  json += "\"energyConsumedKwh\":" + String(data.energyConsumedKwh, 3) + ",";
-  json += "\"regenEnergyKwh\":" + String(data.regenEnergyKwh, 3) + ",";
-  json += "\"avgSpeedKmh\":" + String(data.avgSpeedKmh, 1) + ",";
-  json += "\"maxSpeedKmh\":" + String(data.maxSpeedKmh, 1) + ",";
-  json += "\"socPercent\":" + String(data.stateOfChargePercent, 1) + ",";
-  json += "\"runtimeHours\":" +
-          String(static_cast<unsigned long>(data.runtimeSeconds / 3600)) + ",";
-  json += "\"consumptionWhKm\":" + String(getAvgConsumptionWhKm(), 1) + ",";
-  json += "\"rangeKm\":" + String(getEstimatedRangeKm(), 1);
-  json += "}";
+JsonString exportToJson() {
+  JsonString json;
+  writeJson(data, getAvgConsumptionWhKm(), getEstimatedRangeKm(), json);
+  if (json.truncated()) Logger::warn("Telemetry: JSON truncado");
   return json;
 }
 
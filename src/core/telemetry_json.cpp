@@ -0,0 +1,27 @@
+#include "telemetry.h"
+
+// ============================================================================
+// telemetry_json.cpp - Serialización JSON de telemetría sin heap
+// Mismo formato que la versión anterior basada en String (decimales
+// incluidos), escrito directamente en un StaticString.
+// ============================================================================
+
+namespace Telemetry {
+
+void writeJson(const VehicleData &d, float consumptionWhKm, float rangeKm,
+               JsonString &out) {
+  out.clear();
+  out.appendf("{\"distanceKm\":%.2f,", d.totalDistanceKm);
+  out.appendf("\"tripKm\":%.2f,", d.tripDistanceKm);
+  out.appendf("\"energyConsumedKwh\":%.3f,", d.energyConsumedKwh);
+  out.appendf("\"regenEnergyKwh\":%.3f,", d.regenEnergyKwh);
+  out.appendf("\"avgSpeedKmh\":%.1f,", d.avgSpeedKmh);
+  out.appendf("\"maxSpeedKmh\":%.1f,", d.maxSpeedKmh);
+  out.appendf("\"socPercent\":%.1f,", d.stateOfChargePercent);
+  out.appendf("\"runtimeHours\":%lu,",
+              static_cast<unsigned long>(d.runtimeSeconds / 3600));
+  out.appendf("\"consumptionWhKm\":%.1f,", consumptionWhKm);
+  out.appendf("\"rangeKm\":%.1f}", rangeKm);
+}
+
+} // namespace Telemetry
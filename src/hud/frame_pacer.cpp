@@ -0,0 +1,141 @@
+// frame_pacer.cpp - Adaptive HUD frame pacing
+#include "frame_pacer.h"
+
+namespace FramePacer {
+
+// Wrap-safe "a is at or after b" for millisecond timestamps
+static inline bool reached(uint32_t a, uint32_t b) {
+  return static_cast<int32_t>(a - b) >= 0;
+}
+
+Pacer::Pacer()
+    : started(false), framePending(false), lastChanged(false),
+      level(START_LEVEL), slotMs(0), activeUntilMs(0), burstUntilMs(0),
+      lastStepMs(0), calmSinceMs(0), avgRenderUs(0), frames(0), skipped(0),
+      windowStartMs(0), windowFrames(0), lastWindowFps(0) {}
+
+void Pacer::notifyChange(uint32_t nowMs) {
+  if (!reached(activeUntilMs, nowMs + ACTIVE_HOLD_MS)) {
+    activeUntilMs = nowMs + ACTIVE_HOLD_MS;
+  }
+}
+
+void Pacer::requestBurst(uint32_t nowMs) {
+  notifyChange(nowMs);
+  burstUntilMs = nowMs + BURST_HOLD_MS;
+}
+
+void Pacer::requestFrame() { framePending = true; }
+
+Mode Pacer::mode(uint32_t nowMs) const {
+  if (!reached(nowMs, burstUntilMs)) return Mode::BURST;
+  if (!reached(nowMs, activeUntilMs)) return Mode::ACTIVE;
+  return Mode::IDLE;
+}
+
+uint32_t Pacer::intervalMs(uint32_t nowMs) const {
+  uint32_t interval = LADDER_MS[0];
+  switch (mode(nowMs)) {
+  case Mode::IDLE:
+    interval = IDLE_INTERVAL_MS;
+    break;
+  case Mode::ACTIVE:
+    interval = ACTIVE_INTERVAL_MS;
+    break;
+  case Mode::BURST:
+    break;
+  }
+  return interval > LADDER_MS[level] ? interval : LADDER_MS[level];
+}
+
+void Pacer::adapt(uint32_t nowMs, float coreLoadPct) {
+  // Overloaded: core 1 busy, or the render takes over 3/4 of its interval
+  bool overloaded = coreLoadPct > LOAD_HIGH_PCT ||
+                    avgRenderUs * 4 > LADDER_MS[level] * 1000 * 3;
+  if (overloaded) {
+    calmSinceMs = nowMs;
+    if (level + 1 < LADDER_LEVELS && reached(nowMs, lastStepMs + STEP_MS)) {
+      level++;
+      lastStepMs = nowMs;
+    }
+    return;
+  }
+
+  // Headroom: low load and the render fits in half the faster interval
+  bool calm = level > 0 && coreLoadPct < LOAD_LOW_PCT &&
+              avgRenderUs * 2 < LADDER_MS[level - 1] * 1000;
+  if (!calm) {
+    calmSinceMs = nowMs;
+  } else if (reached(nowMs, calmSinceMs + RECOVER_MS)) {
+    level--;
+    calmSinceMs = nowMs;
+    lastStepMs = nowMs;
+  }
+}
+
+bool Pacer::shouldRender(uint32_t nowMs, float coreLoadPct) {
+  if (!started) {
+    started = true;
+    calmSinceMs = nowMs;
+    lastStepMs = nowMs;
+    windowStartMs = nowMs;
+    slotMs = nowMs;
+    return true;
+  }
+
+  adapt(nowMs, coreLoadPct);
+
+  if (framePending) {
+    slotMs = nowMs; // Re-phase on the forced frame
+    return true;
+  }
+
+  uint32_t interval = intervalMs(nowMs);
+  uint32_t due = slotMs + interval;
+  if (!reached(nowMs + TICK_MS / 2, due)) return false;
+
+  // Keep the phase; if whole slots went by, count them and re-phase
+  uint32_t late = reached(nowMs, due) ? nowMs - due : 0;
+  if (late >= interval) {
+    skipped += late / interval;
+    slotMs = nowMs;
+  } else {
+    slotMs = due;
+  }
+  return true;
+}
+
+void Pacer::frameDone(uint32_t nowMs, uint32_t renderUs, bool changed) {
+  framePending = false;
+  avgRenderUs = frames == 0 ? renderUs : (avgRenderUs * 7 + renderUs) / 8;
+  frames++;
+
+  // Changes on consecutive frames are motion: burst while it lasts
+  if (changed) {
+    notifyChange(nowMs);
+    if (lastChanged) burstUntilMs = nowMs + BURST_HOLD_MS;
+  }
+  lastChanged = changed;
+
+  windowFrames++;
+  uint32_t window = nowMs - windowStartMs;
+  if (window >= 1000) {
+    lastWindowFps = (windowFrames * 1000 + window / 2) / window;
+    windowFrames = 0;
+    windowStartMs = nowMs;
+  }
+}
+
+Stats Pacer::stats(uint32_t nowMs) const {
+  Stats s;
+  s.targetFps = 1000 / intervalMs(nowMs);
+  s.actualFps = lastWindowFps;
+  s.framesRendered = frames;
+  s.skippedFrames = skipped;
+  s.avgRenderUs = avgRenderUs;
+  s.mode = mode(nowMs);
+  s.loadLevel = level;
+  return s;
+}
+
+} // namespace FramePacer
@@ -1,5 +1,6 @@
 #include "gauges.h"
-#include "hud_layer.h" // 🚨 CRITICAL FIX: For RenderContext
+#include "glyph_atlas.h" // Cifras del valor central sin drawString
+#include "hud_layer.h"   // 🚨 CRITICAL FIX: For RenderContext
 #include "safe_draw.h" // 🚨 CRITICAL FIX: For coordinate-safe drawing
 #include "settings.h"
 #include "shadow_render.h" // Phase 3: Shadow mirroring support
@@ -12,6 +13,17 @@ static TFT_eSPI *tft;
 static float lastSpeed = -1;
 static float lastRpm = -1;
 
+// Geometría de la última aguja dibujada: si no cambia no se borra/redibuja
+static uint32_t lastSpeedNeedle = 0;
+static uint32_t lastRpmNeedle = 0;
+
+// Valor central (font 4, MC_DATUM): solo se empujan las cifras que cambian
+static GlyphAtlas::TextRun speedText(4, GlyphAtlas::Align::CENTER, 0, 0);
+static GlyphAtlas::TextRun rpmText(4, GlyphAtlas::Align::CENTER, 0, 0);
+
+// Resultado de un dibujado, para marcar solo lo que cambió
+enum class Drawn : uint8_t { NOTHING, TEXT, GAUGE };
+
 // Constantes matemáticas
 static const float DEG_TO_RAD_CONST =
     0.0174533f; // π/180 para conversión grados a radianes
@@ -203,6 +215,39 @@ static void drawNeedle3D(int cx, int cy, float value, float maxValue, int r,
   }
 }
 
+// Puntos de la aguja relativos al centro, empaquetados: dos valores con la
+// misma clave dibujan exactamente los mismos píxeles
+static uint32_t needleKey(float value, float maxValue, int r) {
+  if (maxValue <= 0.0f) maxValue = 1.0f;
+  float rad = (-135.0f + (value / maxValue) * 270.0f) * DEG_TO_RAD_CONST;
+  float perpRad = rad + 1.5708f;
+  uint8_t tipX = (uint8_t)(128 + (int)(cosf(rad) * r));
+  uint8_t tipY = (uint8_t)(128 + (int)(sinf(rad) * r));
+  uint8_t baseX = (uint8_t)(128 + (int)(cosf(perpRad) * 4));
+  uint8_t baseY = (uint8_t)(128 + (int)(sinf(perpRad) * 4));
+  return ((uint32_t)tipX << 24) | ((uint32_t)tipY << 16) |
+         ((uint32_t)baseX << 8) | baseY;
+}
+
+// Valor central: la aguja y su centro pisan la caja, así que si se
+// redibujaron se limpia la caja y se empujan todas las cifras; si no, la
+// TextRun solo empuja las que cambian (o nada)
+static void drawValueText(GlyphAtlas::TextRun &run, int cx, int cy, int value,
+                          uint16_t textColor, bool needleRedrawn,
+                          const HudLayer::RenderContext &ctx) {
+  run.moveTo(cx, cy + 5);
+  if (needleRedrawn) {
+    SafeDraw::fillRect(ctx, cx - 25, cy - 5, 50, 22, COLOR_GAUGE_INNER);
+#ifdef RENDER_SHADOW_MODE
+    SHADOW_MIRROR_fillRect(cx - 25, cy - 5, 50, 22, COLOR_GAUGE_INNER);
+#endif
+    run.invalidate();
+  }
+  char buf[8];
+  snprintf(buf, sizeof(buf), "%d", value);
+  GlyphAtlas::drawRun(run, ctx, tft, buf, textColor, COLOR_GAUGE_INNER);
+}
+
 // -----------------------
 // Fondo estático mejorado con efecto 3D
 // -----------------------
@@ -272,20 +317,21 @@ void Gauges::init(TFT_eSPI *display) {
   tft = display;
   // 🚨 CRITICAL FIX: Initialize SafeDraw
   SafeDraw::init(display);
+  GlyphAtlas::bakeHudFonts(display);
+  invalidate();
+}
+
+void Gauges::invalidate() {
   lastSpeed = -1;
   lastRpm = -1;
+  speedText.invalidate();
+  rpmText.invalidate();
 }
 
-void Gauges::drawSpeed(int cx, int cy, float kmh, int maxKmh, float pedalPct,
-                       TFT_eSprite *sprite) {
-  // Phase 6: Support dual-mode rendering (sprite or TFT)
-  // Safe cast: TFT_eSprite inherits from TFT_eSPI
-  // 🚨 CRITICAL FIX: Create safe RenderContext
-  HudLayer::RenderContext ctx(sprite, true, 0, 0,
-                              sprite ? sprite->width() : TFT_WIDTH,
-                              sprite ? sprite->height() : TFT_HEIGHT);
+static Drawn renderSpeed(int cx, int cy, float kmh, int maxKmh,
+                         const HudLayer::RenderContext &ctx) {
   TFT_eSPI *drawTarget = SafeDraw::getDrawTarget(ctx);
-  if (!drawTarget) return;
+  if (!drawTarget) return Drawn::NOTHING;
 
   // 🔒 CORRECCIÓN ALTA: Clamp speed con límite superior seguro
   kmh = constrain(kmh, 0.0f,
@@ -297,21 +343,25 @@ void Gauges::drawSpeed(int cx, int cy, float kmh, int maxKmh, float pedalPct,
   // Calcular step de escala según maxKmh
   int step = (maxKmh <= 50) ? 5 : 10;
 
-  // Redibujar fondo solo si es la primera vez
-  if (lastSpeed < 0) {
+  // La aguja solo se borra/redibuja si cambia algún píxel
+  uint32_t needle = needleKey(kmh, (float)maxKmh, 50);
+  bool firstDraw = (lastSpeed < 0);
+  bool needleMoved = firstDraw || needle != lastSpeedNeedle;
+
+  if (firstDraw) {
+    // Redibujar fondo solo si es la primera vez
     drawGaugeBackground(cx, cy, maxKmh, step, "km/h", ctx);
-  } else {
+  } else if (needleMoved) {
     // Borrar aguja anterior
     drawNeedle3D(cx, cy, lastSpeed, (float)maxKmh, 50, true, ctx);
   }
 
-  // Dibujar aguja nueva con efecto 3D
-  drawNeedle3D(cx, cy, kmh, (float)maxKmh, 50, false, ctx);
-
-  // Texto central grande con valor
-  drawTarget->setTextDatum(MC_DATUM);
-  // Use SafeDraw for coordinate translation
-  SafeDraw::fillRect(ctx, cx - 25, cy - 5, 50, 22, COLOR_GAUGE_INNER);
+  if (needleMoved) {
+    // Dibujar aguja nueva con efecto 3D
+    drawNeedle3D(cx, cy, kmh, (float)maxKmh, 50, false, ctx);
+    lastSpeed = kmh;
+    lastSpeedNeedle = needle;
+  }
 
   // Color según velocidad
   uint16_t textColor;
@@ -324,31 +374,28 @@ void Gauges::drawSpeed(int cx, int cy, float kmh, int maxKmh, float pedalPct,
     textColor = TFT_RED;
   }
 
-  drawTarget->setTextColor(textColor, COLOR_GAUGE_INNER);
-  char buf[8];
-  snprintf(buf, sizeof(buf), "%d", (int)kmh);
-  SafeDraw::drawString(ctx, buf, cx, cy + 5, 4);
-#ifdef RENDER_SHADOW_MODE
-  // Phase 3: Mirror speed value text to shadow sprite
-  SHADOW_MIRROR_setTextDatum(MC_DATUM);
-  SHADOW_MIRROR_fillRect(cx - 25, cy - 5, 50, 22, COLOR_GAUGE_INNER);
-  SHADOW_MIRROR_setTextColor(textColor, COLOR_GAUGE_INNER);
-  SHADOW_MIRROR_drawString(buf, cx, cy + 5, 4);
-#endif
-
-  lastSpeed = kmh;
+  // Texto central grande con valor
+  uint32_t textPx = GlyphAtlas::stats().pixels;
+  drawValueText(speedText, cx, cy, (int)kmh, textColor, needleMoved, ctx);
+  if (needleMoved) return Drawn::GAUGE;
+  return GlyphAtlas::stats().pixels != textPx ? Drawn::TEXT : Drawn::NOTHING;
 }
 
-void Gauges::drawRPM(int cx, int cy, float rpm, int maxRpm,
-                     TFT_eSprite *sprite) {
+void Gauges::drawSpeed(int cx, int cy, float kmh, int maxKmh, float pedalPct,
+                       TFT_eSprite *sprite) {
   // Phase 6: Support dual-mode rendering (sprite or TFT)
   // Safe cast: TFT_eSprite inherits from TFT_eSPI
   // 🚨 CRITICAL FIX: Create safe RenderContext
   HudLayer::RenderContext ctx(sprite, true, 0, 0,
                               sprite ? sprite->width() : TFT_WIDTH,
                               sprite ? sprite->height() : TFT_HEIGHT);
+  renderSpeed(cx, cy, kmh, maxKmh, ctx);
+}
+
+static Drawn renderRPM(int cx, int cy, float rpm, int maxRpm,
+                       const HudLayer::RenderContext &ctx) {
   TFT_eSPI *drawTarget = SafeDraw::getDrawTarget(ctx);
-  if (!drawTarget) return;
+  if (!drawTarget) return Drawn::NOTHING;
 
   // 🔒 CORRECCIÓN ALTA: Validar maxRpm para prevenir división por cero
   if (maxRpm <= 0) maxRpm = DEFAULT_MAX_RPM;
@@ -358,20 +405,24 @@ void Gauges::drawRPM(int cx, int cy, float rpm, int maxRpm,
   // Calcular step de escala según maxRpm
   int step = (maxRpm <= 500) ? 50 : 100;
 
-  if (lastRpm < 0) {
+  // La aguja solo se borra/redibuja si cambia algún píxel
+  uint32_t needle = needleKey(rpm, (float)maxRpm, 50);
+  bool firstDraw = (lastRpm < 0);
+  bool needleMoved = firstDraw || needle != lastRpmNeedle;
+
+  if (firstDraw) {
     drawGaugeBackground(cx, cy, maxRpm, step, "RPM", ctx);
-  } else {
+  } else if (needleMoved) {
     // Borrar aguja anterior
     drawNeedle3D(cx, cy, lastRpm, (float)maxRpm, 50, true, ctx);
   }
 
-  // Dibujar aguja nueva con efecto 3D
-  drawNeedle3D(cx, cy, rpm, (float)maxRpm, 50, false, ctx);
-
-  // Texto central grande con valor
-  drawTarget->setTextDatum(MC_DATUM);
-  // Use SafeDraw for coordinate translation
-  SafeDraw::fillRect(ctx, cx - 25, cy - 5, 50, 22, COLOR_GAUGE_INNER);
+  if (needleMoved) {
+    // Dibujar aguja nueva con efecto 3D
+    drawNeedle3D(cx, cy, rpm, (float)maxRpm, 50, false, ctx);
+    lastRpm = rpm;
+    lastRpmNeedle = needle;
+  }
 
   // Color según RPM
   uint16_t textColor;
@@ -384,59 +435,52 @@ void Gauges::drawRPM(int cx, int cy, float rpm, int maxRpm,
     textColor = TFT_RED;
   }
 
-  drawTarget->setTextColor(textColor, COLOR_GAUGE_INNER);
-  char buf[8];
-  snprintf(buf, sizeof(buf), "%d", (int)rpm);
-  SafeDraw::drawString(ctx, buf, cx, cy + 5, 4);
-#ifdef RENDER_SHADOW_MODE
-  // Phase 3: Mirror RPM value text to shadow sprite
-  SHADOW_MIRROR_setTextDatum(MC_DATUM);
-  SHADOW_MIRROR_fillRect(cx - 25, cy - 5, 50, 22, COLOR_GAUGE_INNER);
-  SHADOW_MIRROR_setTextColor(textColor, COLOR_GAUGE_INNER);
-  SHADOW_MIRROR_drawString(buf, cx, cy + 5, 4);
-#endif
+  // Texto central grande con valor
+  uint32_t textPx = GlyphAtlas::stats().pixels;
+  drawValueText(rpmText, cx, cy, (int)rpm, textColor, needleMoved, ctx);
+  if (needleMoved) return Drawn::GAUGE;
+  return GlyphAtlas::stats().pixels != textPx ? Drawn::TEXT : Drawn::NOTHING;
+}
 
-  lastRpm = rpm;
+void Gauges::drawRPM(int cx, int cy, float rpm, int maxRpm,
+                     TFT_eSprite *sprite) {
+  // Phase 6: Support dual-mode rendering (sprite or TFT)
+  // Safe cast: TFT_eSprite inherits from TFT_eSPI
+  // 🚨 CRITICAL FIX: Create safe RenderContext
+  HudLayer::RenderContext ctx(sprite, true, 0, 0,
+                              sprite ? sprite->width() : TFT_WIDTH,
+                              sprite ? sprite->height() : TFT_HEIGHT);
+  renderRPM(cx, cy, rpm, maxRpm, ctx);
 }
 
 // ============================================================================
 // PHASE 10: RenderContext versions for granular dirty tracking
 // ============================================================================
 
-void Gauges::drawSpeed(int cx, int cy, float kmh, int maxKmh, float pedalPct,
-                       HudLayer::RenderContext &ctx) {
-  if (!ctx.isValid()) return;
-
-  // Check if value changed significantly (> 0.5 km/h)
-  bool changed = (lastSpeed < 0) || (fabs(kmh - lastSpeed) > 0.5f);
-
-  // Call sprite version
-  drawSpeed(cx, cy, kmh, maxKmh, pedalPct, ctx.sprite);
-
-  // Mark dirty region if changed
-  if (changed) {
+// Marca solo lo que se redibujó: la esfera entera si se movió la aguja, la
+// caja del valor si solo cambiaron cifras
+static void markDrawn(Drawn drawn, int cx, int cy,
+                      HudLayer::RenderContext &ctx) {
+  if (drawn == Drawn::GAUGE) {
     // Gauge bounding box: center ± (outerRadius + 5)
     const int gaugeRadius = 73; // outerRadius (68) + 5
     ctx.markDirty(cx - gaugeRadius, cy - gaugeRadius, gaugeRadius * 2,
                   gaugeRadius * 2);
+  } else if (drawn == Drawn::TEXT) {
+    // font 4 (26 px) centrada en cy + 5; hasta 4 cifras
+    ctx.markDirty(cx - 30, cy - 8, 60, 26);
   }
 }
 
+void Gauges::drawSpeed(int cx, int cy, float kmh, int maxKmh, float pedalPct,
+                       HudLayer::RenderContext &ctx) {
+  (void)pedalPct;
+  if (!ctx.isValid()) return;
+  markDrawn(renderSpeed(cx, cy, kmh, maxKmh, ctx), cx, cy, ctx);
+}
+
 void Gauges::drawRPM(int cx, int cy, float rpm, int maxRpm,
                      HudLayer::RenderContext &ctx) {
   if (!ctx.isValid()) return;
-
-  // Check if value changed significantly (> 5 RPM)
-  bool changed = (lastRpm < 0) || (fabs(rpm - lastRpm) > 5.0f);
-
-  // Call sprite version
-  drawRPM(cx, cy, rpm, maxRpm, ctx.sprite);
-
-  // Mark dirty region if changed
-  if (changed) {
-    // Gauge bounding box: center ± (outerRadius + 5)
-    const int gaugeRadius = 73; // outerRadius (68) + 5
-    ctx.markDirty(cx - gaugeRadius, cy - gaugeRadius, gaugeRadius * 2,
-                  gaugeRadius * 2);
-  }
-}
\ No newline at end of file
+  markDrawn(renderRPM(cx, cy, rpm, maxRpm, ctx), cx, cy, ctx);
+}
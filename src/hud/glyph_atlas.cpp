@@ -0,0 +1,197 @@
+// glyph_atlas.cpp - Glyph masks and text-run diffing (pure)
+#include "glyph_atlas.h"
+
+namespace GlyphAtlas {
+
+// ============================================================================
+// Atlas
+// ============================================================================
+
+static uint16_t maskBytes(uint8_t w, uint8_t h) {
+  return static_cast<uint16_t>((w + 7) / 8) * h;
+}
+
+void Atlas::clear() {
+  count_ = 0;
+  used_ = 0;
+  for (uint8_t &h : heights_) h = 0;
+}
+
+bool Atlas::bake(Rasterizer &r, uint8_t font, const char *charset) {
+  if (font == 0 || font > MAX_FONT || charset == nullptr) return false;
+  uint8_t h = r.height(font);
+  if (h == 0 || h > MAX_GLYPH_H) return false;
+
+  for (const char *c = charset; *c; c++) {
+    if (find(font, *c)) continue;
+    uint8_t w = r.width(font, *c);
+    if (w == 0 || w > MAX_GLYPH_W) return false;
+    uint16_t bytes = maskBytes(w, h);
+    if (count_ >= MAX_GLYPHS || used_ + bytes > ATLAS_BYTES) return false;
+
+    Glyph &g = glyphs_[count_];
+    g.ch = *c;
+    g.font = font;
+    g.w = w;
+    g.h = h;
+    g.offset = used_;
+
+    r.render(font, *c);
+    uint8_t *mask = &bits_[used_];
+    const uint8_t rowBytes = (w + 7) / 8;
+    for (uint8_t y = 0; y < h; y++) {
+      for (uint8_t x = 0; x < w; x++) {
+        uint8_t &b = mask[y * rowBytes + x / 8];
+        if (r.pixel(x, y)) {
+          b |= 0x80 >> (x % 8);
+        } else {
+          b &= ~(0x80 >> (x % 8));
+        }
+      }
+    }
+    used_ += bytes;
+    count_++;
+    heights_[font] = h;
+  }
+  return true;
+}
+
+const Glyph *Atlas::find(uint8_t font, char ch) const {
+  for (uint8_t i = 0; i < count_; i++) {
+    if (glyphs_[i].ch == ch && glyphs_[i].font == font) return &glyphs_[i];
+  }
+  return nullptr;
+}
+
+bool Atlas::covers(uint8_t font, const char *text) const {
+  for (const char *c = text; *c; c++) {
+    if (!find(font, *c)) return false;
+  }
+  return true;
+}
+
+int16_t Atlas::textWidth(uint8_t font, const char *text) const {
+  int16_t w = 0;
+  for (const char *c = text; *c; c++) {
+    const Glyph *g = find(font, *c);
+    if (g) w += g->w;
+  }
+  return w;
+}
+
+uint8_t Atlas::height(uint8_t font) const {
+  return font <= MAX_FONT ? heights_[font] : 0;
+}
+
+bool Atlas::bit(const Glyph &g, uint8_t x, uint8_t y) const {
+  const uint8_t rowBytes = (g.w + 7) / 8;
+  return bits_[g.offset + y * rowBytes + x / 8] & (0x80 >> (x % 8));
+}
+
+void Atlas::blit(const Glyph &g, uint16_t fg, uint16_t bg, uint16_t *dst,
+                 uint16_t stride, bool swapBytes) const {
+  if (swapBytes) {
+    fg = static_cast<uint16_t>((fg << 8) | (fg >> 8));
+    bg = static_cast<uint16_t>((bg << 8) | (bg >> 8));
+  }
+  const uint8_t rowBytes = (g.w + 7) / 8;
+  const uint8_t *row = &bits_[g.offset];
+  for (uint8_t y = 0; y < g.h; y++, row += rowBytes, dst += stride) {
+    for (uint8_t x = 0; x < g.w; x++) {
+      dst[x] = (row[x / 8] & (0x80 >> (x % 8))) ? fg : bg;
+    }
+  }
+}
+
+// ============================================================================
+// TextRun
+// ============================================================================
+
+int16_t TextRun::originX(int16_t width) const {
+  switch (align_) {
+  case Align::CENTER:
+    return x_ - width / 2;
+  case Align::RIGHT:
+    return x_ - width;
+  default:
+    return x_;
+  }
+}
+
+Plan TextRun::plan(const Atlas &atlas, const char *text, uint16_t fg,
+                   uint16_t bg) const {
+  Plan p = {};
+  p.fg = fg;
+  p.bg = bg;
+
+  // Compare what would be stored, so over-long text is not redrawn each call
+  StaticString<RUN_CAPACITY> next(text);
+  const uint8_t h = atlas.height(font_);
+  const int16_t top = y_ - h / 2;
+  p.width = atlas.textWidth(font_, next.c_str());
+  p.left = originX(p.width);
+
+  const bool sameColours = (fg == fg_ && bg == bg_);
+  if (valid_ && sameColours && next == text_.view()) {
+    p.skip = true;
+    return p;
+  }
+
+  // Cells already on screen: same glyph at the same x (two sorted lists)
+  const bool reuse = valid_ && sameColours;
+  const char *old = text_.c_str();
+  int16_t oldX = left_;
+  int16_t x = p.left;
+  for (const char *c = next.c_str(); *c; c++) {
+    const Glyph *g = atlas.find(font_, *c);
+    if (g == nullptr) continue;
+
+    bool kept = false;
+    if (reuse) {
+      while (*old) {
+        const Glyph *og = atlas.find(font_, *old);
+        int16_t ow = og ? og->w : 0;
+        if (oldX >= x) break;
+        oldX += ow;
+        old++;
+      }
+      kept = (*old == *c && oldX == x);
+    }
+    if (!kept) {
+      p.cells[p.cellCount++] = {g, x, top};
+      p.pixels += static_cast<uint32_t>(g->w) * g->h;
+    }
+    x += g->w;
+  }
+
+  // Background the new text no longer covers
+  if (valid_) {
+    const int16_t oldRight = left_ + width_;
+    const int16_t newRight = p.left + p.width;
+    if (left_ < p.left) {
+      int16_t w = (oldRight < p.left ? oldRight : p.left) - left_;
+      p.erase[p.eraseCount++] = {left_, top, w, h};
+    }
+    if (oldRight > newRight) {
+      int16_t from = newRight > left_ ? newRight : left_;
+      p.erase[p.eraseCount++] = {from, top,
+                                 static_cast<int16_t>(oldRight - from), h};
+    }
+    for (uint8_t i = 0; i < p.eraseCount; i++) {
+      p.pixels += static_cast<uint32_t>(p.erase[i].w) * h;
+    }
+  }
+  return p;
+}
+
+void TextRun::commit(const char *text, const Plan &p) {
+  if (p.skip) return;
+  text_ = StaticString<RUN_CAPACITY>(text).view();
+  fg_ = p.fg;
+  bg_ = p.bg;
+  left_ = p.left;
+  width_ = p.width;
+  valid_ = true;
+}
+
+} // namespace GlyphAtlas
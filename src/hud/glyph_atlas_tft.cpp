@@ -0,0 +1,189 @@
+// glyph_atlas_tft.cpp - Baking from TFT_eSPI fonts and pushing glyph cells
+#include "glyph_atlas.h"
+#include "hud_layer.h"
+#include "logger.h"
+#include "safe_draw.h"
+#include "shadow_render.h"
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+#include <cstring>
+
+namespace GlyphAtlas {
+
+// Characters the HUD draws through runs: gauge values (font 4)
+static const uint8_t GAUGE_FONT = 4;
+static const char *const GAUGE_CHARSET = "0123456789-";
+
+static const uint32_t STATS_LOG_RUNS = 1800; // ~30 s of both gauges at 30 FPS
+
+static Atlas hudAtlas;
+static bool baked = false;
+static Stats runStats = {};
+
+// One blitted cell; the largest glyph the atlas accepts
+static uint16_t cellBuf[MAX_GLYPH_W * MAX_GLYPH_H];
+
+// Renders each glyph into a small 8-bit sprite and reads it back: the masks
+// are exactly what drawString() would have produced, taken once at boot
+class SpriteRasterizer : public Rasterizer {
+public:
+  explicit SpriteRasterizer(TFT_eSPI *display)
+      : display_(display), sprite_(display) {}
+  ~SpriteRasterizer() override { sprite_.deleteSprite(); }
+
+  bool begin() {
+    sprite_.setColorDepth(8);
+    return sprite_.createSprite(MAX_GLYPH_W, MAX_GLYPH_H);
+  }
+
+  uint8_t height(uint8_t font) override {
+    return static_cast<uint8_t>(display_->fontHeight(font));
+  }
+
+  uint8_t width(uint8_t font, char ch) override {
+    char s[2] = {ch, '\0'};
+    return static_cast<uint8_t>(display_->textWidth(s, font));
+  }
+
+  void render(uint8_t font, char ch) override {
+    sprite_.fillSprite(TFT_BLACK);
+    sprite_.setTextColor(TFT_WHITE); // Transparent background
+    sprite_.drawChar(ch, 0, 0, font);
+  }
+
+  bool pixel(int16_t x, int16_t y) override {
+    return sprite_.readPixel(x, y) != TFT_BLACK;
+  }
+
+private:
+  TFT_eSPI *display_;
+  TFT_eSprite sprite_;
+};
+
+bool bakeHudFonts(TFT_eSPI *display) {
+  if (baked) return true;
+  if (display == nullptr) return false;
+
+  SpriteRasterizer raster(display);
+  if (!raster.begin()) {
+    Logger::warn("GlyphAtlas: no memory for bake sprite, using drawString");
+    return false;
+  }
+  uint32_t t0 = micros();
+  baked = hudAtlas.bake(raster, GAUGE_FONT, GAUGE_CHARSET);
+  if (!baked) {
+    Logger::warn("GlyphAtlas: atlas full, using drawString");
+    return false;
+  }
+  Logger::infof("GlyphAtlas: %u glyphs, %u bytes, baked in %lu us",
+                hudAtlas.glyphCount(), hudAtlas.bytesUsed(),
+                (unsigned long)(micros() - t0));
+  return true;
+}
+
+Atlas &atlas() { return hudAtlas; }
+
+static uint8_t datumFor(Align align) {
+  switch (align) {
+  case Align::CENTER:
+    return MC_DATUM;
+  case Align::RIGHT:
+    return MR_DATUM;
+  default:
+    return ML_DATUM;
+  }
+}
+
+static void finish(uint32_t t0) {
+  runStats.renderUs += micros() - t0;
+  if (runStats.runs % STATS_LOG_RUNS == 0) logStats();
+}
+
+uint32_t drawRun(TextRun &run, const HudLayer::RenderContext &ctx,
+                 TFT_eSPI *display, const char *text, uint16_t fg,
+                 uint16_t bg) {
+  TFT_eSPI *target = ctx.sprite ? ctx.sprite : display;
+  if (target == nullptr || text == nullptr) return 0;
+  uint32_t t0 = micros();
+  runStats.runs++;
+
+  // Not baked (or a character outside the charset): plain drawString
+  if (!baked || !hudAtlas.covers(run.font(), text)) {
+    target->setTextDatum(datumFor(run.align()));
+    target->setTextColor(fg, bg);
+    SafeDraw::drawString(ctx, text, run.x(), run.y(), run.font());
+#ifdef RENDER_SHADOW_MODE
+    SHADOW_MIRROR_setTextDatum(datumFor(run.align()));
+    SHADOW_MIRROR_setTextColor(fg, bg);
+    SHADOW_MIRROR_drawString(text, run.x(), run.y(), run.font());
+#endif
+    run.invalidate();
+    runStats.fallbacks++;
+    finish(t0);
+    return 0;
+  }
+
+  Plan p = run.plan(hudAtlas, text, fg, bg);
+  if (p.skip) {
+    runStats.skipped++;
+    runStats.cellsKept += strlen(run.text());
+    finish(t0);
+    return 0;
+  }
+
+  for (uint8_t i = 0; i < p.eraseCount; i++) {
+    const Span &e = p.erase[i];
+    SafeDraw::fillRect(ctx, e.x, e.y, e.w, e.h, bg);
+#ifdef RENDER_SHADOW_MODE
+    SHADOW_MIRROR_fillRect(e.x, e.y, e.w, e.h, bg);
+#endif
+  }
+
+  // pushImage() takes big-endian pixels unless the target swaps bytes
+  const bool swap = !target->getSwapBytes();
+  for (uint8_t i = 0; i < p.cellCount; i++) {
+    const Cell &c = p.cells[i];
+    const Glyph &g = *c.glyph;
+    if (ctx.sprite) {
+      if (ctx.intersectsBounds(c.x, c.y, g.w, g.h)) {
+        hudAtlas.blit(g, fg, bg, cellBuf, g.w, swap);
+        ctx.sprite->pushImage(ctx.toLocalX(c.x), ctx.toLocalY(c.y), g.w, g.h,
+                              cellBuf);
+      }
+    } else {
+      hudAtlas.blit(g, fg, bg, cellBuf, g.w, swap);
+      target->pushImage(c.x, c.y, g.w, g.h, cellBuf);
+    }
+#ifdef RENDER_SHADOW_MODE
+    TFT_eSprite *shadow = getShadowSprite();
+    if (shadow) {
+      hudAtlas.blit(g, fg, bg, cellBuf, g.w, !shadow->getSwapBytes());
+      shadow->pushImage(c.x, c.y, g.w, g.h, cellBuf);
+    }
+#endif
+  }
+
+  run.commit(text, p);
+  runStats.cellsDrawn += p.cellCount;
+  runStats.cellsKept += strlen(run.text()) - p.cellCount;
+  runStats.pixels += p.pixels;
+  finish(t0);
+  return p.pixels;
+}
+
+const Stats &stats() { return runStats; }
+
+void resetStats() { runStats = {}; }
+
+void logStats() {
+  const Stats &s = runStats;
+  if (s.runs == 0) return;
+  Logger::infof("GlyphAtlas: %lu runs, %lu skipped, %lu cells drawn / %lu "
+                "kept, %lu px, %lu us/run, %lu fallbacks",
+                (unsigned long)s.runs, (unsigned long)s.skipped,
+                (unsigned long)s.cellsDrawn, (unsigned long)s.cellsKept,
+                (unsigned long)s.pixels, (unsigned long)(s.renderUs / s.runs),
+                (unsigned long)s.fallbacks);
+}
+
+} // namespace GlyphAtlas
@@ -1,4 +1,5 @@
 #include "hud.h"
+#include "hud_base_model.h" // Per-widget change model (BASE layer)
 #include "hud_layer.h"     // 🚨 CRITICAL FIX: For RenderContext
 #include "safe_draw.h"     // 🚨 CRITICAL FIX: For coordinate-safe drawing
 #include "shadow_render.h" // Phase 3: Shadow mirroring support
@@ -15,7 +16,6 @@
 #include "icons.h"
 #include "menu_hidden.h"
 #include "operation_modes.h" // Sistema de modos de operación
-#include "render_engine.h"   // Sprite-based rendering engine
 #include "sensors.h"         // Para SystemStatus de sensores
 #include "touch_map.h"       // 👈 añadido
 #include "wheels_display.h"
@@ -41,18 +41,18 @@
 // ✅ Usar la instancia global de TFT_eSPI definida en hud_manager.cpp
 extern TFT_eSPI *tft;
 
-// 🔒 v2.8.8: Touch integrado de TFT_eSPI
-// Usamos tft->getTouch() en lugar de librería XPT2046_Touchscreen separada
-// Esto evita conflictos de bus SPI que causaban pantalla blanca
+// Touch XPT2046: TouchInput muestrea en su propia tarea (touch_input.h) y
+// HUDManager entrega los gestos a HUD::handleTouch() antes de cada frame
 static bool touchInitialized = false;
 
-// 🔒 v2.9.2: Touch diagnostic constants
-static const uint32_t DIAGNOSTIC_RAW_TOUCH_CHECK_INTERVAL_MS =
-    5000; // Check raw touch every 5 seconds when calibrated touch fails
+// Toque en batería pendiente para MenuHidden::update(); caduca si ningún
+// frame lo consume (p. ej. dashboard renderizado por el compositor)
+static bool batteryTapPending = false;
+static uint32_t batteryTapMs = 0;
+static const uint32_t BATTERY_TAP_LATCH_MS = 100;
+
 static const uint16_t TOUCH_ADC_MAX = 4095; // XPT2046 12-bit ADC maximum value
 static const uint16_t TOUCH_ADC_MIN = 0;    // XPT2046 12-bit ADC minimum value
-static const uint8_t DIAGNOSTIC_LOG_INTERVAL =
-    5; // Log every Nth raw touch detection to avoid spam
 
 // 🔒 v2.9.3: Touch rotation and validation constants
 static const uint8_t TOUCH_DEFAULT_ROTATION =
@@ -132,6 +132,53 @@ static bool carBodyDrawn = false;         // Track if car body needs redraw
 static float lastSteeringAngle = -999.0f; // Cache para ángulo del volante
 static float lastPedalPercent = -999.0f;  // Phase 10: Cache for pedal value
 
+// Área que cada widget del BASE limpia y marca sucia (coordenadas de
+// pantalla, mismo orden que HudBaseModel::Widget). El volante se dibuja
+// encima de la carrocería (aro r 25 + 5, texto de grados debajo).
+static const HudBaseModel::Rect BASE_WIDGET_BOUNDS[] = {
+    {X_SPEED - 73, Y_SPEED - 73, 146, 146}, // SPEED (Gauges, r 68 + 5)
+    {X_RPM - 73, Y_RPM - 73, 146, 146},     // RPM
+    {X_FL - 30, Y_FL - 40, 60, 80},         // WHEEL_FL
+    {X_FR - 30, Y_FR - 40, 60, 80},         // WHEEL_FR
+    {X_RL - 30, Y_RL - 40, 60, 80},         // WHEEL_RL
+    {X_RR - 30, Y_RR - 40, 60, 80},         // WHEEL_RR
+    {210, 145, 60, 80},                     // STEERING
+    {200, 0, 80, 50},                       // SYSTEM_STATE
+    {190, 45, 100, 60},                     // GEAR
+    {Icons::MODE4X4_X1, Icons::MODE4X4_Y1,
+     Icons::MODE4X4_X2 - Icons::MODE4X4_X1,
+     Icons::MODE4X4_Y2 - Icons::MODE4X4_Y1}, // FEATURES
+    {Icons::BATTERY_X1, Icons::BATTERY_Y1,
+     Icons::BATTERY_X2 - Icons::BATTERY_X1,
+     Icons::BATTERY_Y2 - Icons::BATTERY_Y1}, // BATTERY
+    {Icons::AMBIENT_TEMP_X, Icons::AMBIENT_TEMP_Y, Icons::AMBIENT_TEMP_W,
+     Icons::AMBIENT_TEMP_H}, // AMBIENT_TEMP
+    {Icons::WARNING_X1, Icons::WARNING_Y1,
+     Icons::WARNING_X2 - Icons::WARNING_X1,
+     Icons::WARNING_Y2 - Icons::WARNING_Y1}, // ERRORS
+    {Icons::SENSOR_STATUS_X1, Icons::SENSOR_STATUS_Y1,
+     Icons::SENSOR_STATUS_X2 - Icons::SENSOR_STATUS_X1,
+     Icons::SENSOR_STATUS_Y2 - Icons::SENSOR_STATUS_Y1}, // SENSOR_STATUS
+    {Icons::TEMP_WARNING_X, Icons::TEMP_WARNING_Y, Icons::TEMP_WARNING_W,
+     Icons::TEMP_WARNING_H},                                // TEMP_WARNING
+    {MODE_INDICATOR_X - 60, MODE_INDICATOR_Y - 10, 120, 20}, // MODE
+    {0, 300, 480, 18},                                       // PEDAL
+};
+static_assert(sizeof(BASE_WIDGET_BOUNDS) / sizeof(BASE_WIDGET_BOUNDS[0]) ==
+                  HudBaseModel::WIDGET_COUNT,
+              "Un área por widget del BASE");
+
+// Phase 10: qué widgets del BASE redibujar en cada frame
+static HudBaseModel::Model baseModel(BASE_WIDGET_BOUNDS);
+static uint32_t lastBaseRedraw = 0; // Para repetir el frame en modo sombra
+static bool lastCarBodyRedraw = false;
+
+// Carrocería: fondo de ruedas y volante. No es un widget del modelo (no
+// depende de ninguna entrada); se redibuja cuando el compositor borra
+// píxeles bajo ella, y entonces todo lo que va encima también.
+static const HudBaseModel::Rect CAR_BODY_BOUNDS = {CAR_BODY_X, CAR_BODY_Y,
+                                                   CAR_BODY_W, CAR_BODY_H};
+
 extern Storage::Config cfg; // acceso a flags
 
 // 🔒 v2.9.3: Helper function to set default touch calibration
@@ -145,8 +192,8 @@ static void setDefaultTouchCalibration(uint16_t calData[5]) {
   // Based on typical XPT2046 12-bit ADC range (0-4095)
   // For ST7796S in rotation 3 (landscape 480x320)
   // Format: [min_x, max_x, min_y, max_y, rotation]
-  // This format matches TFT_eSPI library expectations and touch_calibration.cpp
-  // output
+  // This format matches TouchInput::Calibration (raw values at the screen
+  // edges) and touch_calibration.cpp output
   const uint16_t minVal = (uint16_t)TouchConstants::RAW_MIN; // 200
   const uint16_t maxVal = (uint16_t)TouchConstants::RAW_MAX; // 3900
 
@@ -195,8 +242,8 @@ void HUD::init() {
     if (cfg.touchCalibrated) {
       // Validate calibration data before use
       // ⚠️ CRITICAL: Format is [min_x, max_x, min_y, max_y, rotation]
-      // Note: X-axis may be inverted (min_x > max_x) to correct touch mapping
-      // Y-axis is expected to be normal (min_y < max_y)
+      // Note: either axis may be inverted (min > max): TouchCalibration keeps
+      // the direction it measured
       bool xAxisValid =
           (cfg.touchCalibration[0] !=
            cfg.touchCalibration[1]) && // min_x != max_x (allows both normal and
@@ -211,8 +258,9 @@ void HUD::init() {
               TOUCH_ADC_MAX; // max_x within upper ADC bound
 
       bool yAxisValid =
-          cfg.touchCalibration[2] <
-              cfg.touchCalibration[3] && // min_y < max_y (normal orientation)
+          (cfg.touchCalibration[2] !=
+           cfg.touchCalibration[3]) && // min_y != max_y (allows both normal and
+                                       // inverted)
           cfg.touchCalibration[2] >=
               TOUCH_ADC_MIN && // min_y within lower ADC bound
           cfg.touchCalibration[2] <=
@@ -257,18 +305,15 @@ void HUD::init() {
       setDefaultTouchCalibration(calData);
     }
 
-    tft->setTouch(calData);
-    touchInitialized = true;
-    Logger::info("Touchscreen XPT2046 integrated with TFT_eSPI initialized OK");
-
-// 🔒 v2.9.3: Report Z_THRESHOLD configuration for diagnostics
-#ifdef Z_THRESHOLD
-    Logger::infof("Touch: Z_THRESHOLD set to %d (lower = more sensitive)",
-                  Z_THRESHOLD);
-#else
-    Logger::warn("Touch: Z_THRESHOLD not defined, using library default "
-                 "(typically 350)");
-#endif
+    // Muestreo por tarea (PENIRQ o sondeo en reposo), filtrado mediana +
+    // IIR y calibración en punto fijo; sustituye a tft->getTouch() por frame
+    touchInitialized = TouchInput::init(calData);
+    if (touchInitialized) {
+      Logger::infof("Touch: XPT2046 input task running (%s)",
+                    TouchInput::isIrqDriven() ? "PENIRQ" : "idle poll");
+    } else {
+      Logger::error("Touch: input task could not start - touch disabled");
+    }
 
 // 🔒 v2.9.3: Report SPI frequency configuration
 #ifdef SPI_TOUCH_FREQUENCY
@@ -279,47 +324,6 @@ void HUD::init() {
         "Touch: SPI_TOUCH_FREQUENCY not defined, using library default");
 #endif
 
-    // 🔒 v2.9.2: Test touch immediately after initialization
-    // This helps diagnose if touch controller is responding
-    uint16_t testX = 0, testY = 0;
-    Logger::info("Touch: Testing touch controller response...");
-    bool touchResponding = tft->getTouchRaw(&testX, &testY);
-    if (touchResponding) {
-      // Read Z pressure value to check sensitivity (only if touch is
-      // responding)
-      uint16_t testZ = tft->getTouchRawZ();
-      Logger::infof(
-          "Touch: Controller responding, raw values: X=%d, Y=%d, Z=%d", testX,
-          testY, testZ);
-
-      // Check if values are in expected range
-      if (testX == TOUCH_ADC_MIN && testY == TOUCH_ADC_MIN) {
-        Logger::warn("Touch: Controller returns zero X/Y - not currently "
-                     "touched or hardware issue");
-
-// Report configured Z threshold for diagnostics
-#ifdef Z_THRESHOLD
-        const uint16_t zThreshold = Z_THRESHOLD;
-#else
-        const uint16_t zThreshold = 350; // Default if not configured
-#endif
-
-        Logger::infof("Touch: Z pressure = %d (threshold is %d)", testZ,
-                      zThreshold);
-      } else if (testX > TOUCH_ADC_MAX || testY > TOUCH_ADC_MAX) {
-        Logger::error(
-            "Touch: Invalid values detected - possible hardware or SPI issue");
-      } else {
-        Logger::info("Touch: Initial test successful, values in valid range");
-      }
-    } else {
-      Logger::warn("Touch: Controller not responding to getTouchRaw() - check "
-                   "wiring and SPI configuration");
-      Logger::warn("Touch: Verify TOUCH_CS (GPIO 21) and SPI pins are correct");
-      Logger::warn(
-          "Touch: Check that display and touch share same SPI bus properly");
-    }
-
     // 🔒 v2.9.1: Informative message for touch calibration
     if (!cfg.touchCalibrated) {
       Logger::warn(
@@ -538,6 +542,73 @@ void HUD::toggleAxisRotation() {
 // Get axis rotation state
 bool HUD::isAxisRotationEnabled() { return axisRotationEnabled; }
 
+void HUD::handleTouch(const TouchInput::Event &event) {
+#ifndef DISABLE_TOUCH
+  if (!touchInitialized || !cfg.touchEnabled) return;
+  int x = event.x;
+  int y = event.y;
+
+  switch (event.type) {
+  case TouchInput::EventType::DOWN:
+#ifdef TOUCH_DEBUG
+    Logger::infof("Touch: down at (%d, %d)", x, y);
+#endif
+#ifdef STANDALONE_DISPLAY
+    // Pulsación larga del botón demo: el progreso avanza en HUD::update()
+    if (isTouchInDemoButton(x, y) && !MenuHidden::isActive()) {
+      demoButtonPressStart = millis();
+      demoButtonWasPressed = true;
+      demoButtonProgress = 0.0f;
+      Logger::info("Demo button touched - hold 1.5s for menu");
+    }
+#endif
+    break;
+
+  case TouchInput::EventType::DRAG_START:
+  case TouchInput::EventType::UP:
+#ifdef STANDALONE_DISPLAY
+    // Reset if touch moved outside button area or was released
+    demoButtonWasPressed = false;
+    demoButtonProgress = 0.0f;
+#endif
+    break;
+
+  case TouchInput::EventType::TAP: {
+    Logger::infof("Touch: tap at (%d, %d)", x, y);
+    TouchAction act = getTouchedZone(x, y);
+    if (act == TouchAction::Battery) {
+      batteryTapPending = true;
+      batteryTapMs = millis();
+      break;
+    }
+    // Con el menú oculto encima solo cuenta la batería
+    if (MenuHidden::isActive()) break;
+
+    if (isTouchInAxisButton(x, y)) {
+      toggleAxisRotation();
+      break;
+    }
+    if (act == TouchAction::Mode4x4) {
+      Logger::info("Toque en icono 4x4 - toggling traction mode");
+      // Toggle between 4x4 and 4x2 mode
+      const Traction::State &currentTraction = Traction::get();
+      bool newMode = !currentTraction.enabled4x4;
+      Traction::setMode4x4(newMode);
+      Logger::infof("Mode switched to: %s", newMode ? "4x4" : "4x2");
+    } else if (act == TouchAction::Warning) {
+      Logger::info("Toque en icono warning");
+    }
+    break;
+  }
+
+  default:
+    break;
+  }
+#else
+  (void)event;
+#endif // DISABLE_TOUCH
+}
+
 // Colores 3D para carrocería del coche
 static const uint16_t COLOR_CAR_BODY = 0x2945;        // Gris azulado oscuro
 static const uint16_t COLOR_CAR_HIGHLIGHT = 0x4A69;   // Highlight superior
@@ -558,23 +629,19 @@ static const uint16_t COLOR_REF_MARKS = 0x4208;  // Marcas de referencia
 // This creates a visual representation of the vehicle in the center
 // 🔒 v2.8.8: Diseño mejorado - Vista cenital más realista de un coche
 //
-// ⚠️ FULLSCREEN SPRITE EXCEPTION:
-// This function draws directly to CAR_BODY sprite using screen coordinates.
-// This is SAFE because CAR_BODY sprite is fullscreen (480×320), so screen
-// coordinates == sprite-local coordinates. All coordinates are validated
-// to be within screen bounds (0-479 horizontal, 0-319 vertical).
-// DO NOT use this pattern with non-fullscreen sprites!
-static void drawCarBody() {
-  // Only draw once (static background)
-  if (carBodyDrawn) return;
-
-  // Get the CAR_BODY sprite (FULLSCREEN 480×320)
-  TFT_eSprite *sprite = RenderEngine::getSprite(RenderEngine::CAR_BODY);
+// Draws into the BASE layer (or the TFT in legacy mode) with screen
+// coordinates, all inside CAR_BODY_BOUNDS. Wheels and steering wheel go on
+// top: redraw them after this.
+static void drawCarBody(HudLayer::RenderContext &ctx) {
+  TFT_eSPI *sprite = SafeDraw::getDrawTarget(ctx);
   if (sprite == nullptr) {
-    Logger::error("drawCarBody: CAR_BODY sprite not available");
+    Logger::error("drawCarBody: no draw target");
     return;
   }
 
+  // Limpiar el área (el compositor puede haberla borrado solo en parte)
+  sprite->fillRect(CAR_BODY_X, CAR_BODY_Y, CAR_BODY_W, CAR_BODY_H, TFT_BLACK);
+
   int cx = CAR_BODY_X + CAR_BODY_W / 2; // Centro X del coche (240)
   int cy = CAR_BODY_Y + CAR_BODY_H / 2; // Centro Y del coche (175)
 
@@ -755,9 +822,7 @@ static void drawCarBody() {
   sprite->drawCircle(cx, diffRearY - 5, 3, COLOR_AXLE_DARK);
 
   // Mark the car body bounding box as dirty
-  RenderEngine::markDirtyRect(CAR_BODY_X, CAR_BODY_Y, CAR_BODY_W, CAR_BODY_H);
-
-  carBodyDrawn = true;
+  ctx.markDirty(CAR_BODY_X, CAR_BODY_Y, CAR_BODY_W, CAR_BODY_H);
 }
 
 // Colores para el volante
@@ -767,7 +832,7 @@ static const uint16_t COLOR_WHEEL_CENTER = 0x4A49; // Gris para el centro
 static const uint16_t COLOR_WHEEL_HIGHLIGHT = 0xC618; // Highlight 3D
 
 // Dibujar volante gráfico con rotación y mostrar ángulo en grados
-static void drawSteeringWheel(float angleDeg) {
+static void drawSteeringWheel(float angleDeg, HudLayer::RenderContext &ctx) {
   // Posición: centro del coche
   const int cx = CAR_BODY_X + CAR_BODY_W / 2; // Centro X del coche (240)
   const int cy = CAR_BODY_Y + CAR_BODY_H / 2; // Centro Y del coche (175)
@@ -779,10 +844,9 @@ static void drawSteeringWheel(float angleDeg) {
   if (fabs(angleDeg - lastSteeringAngle) < 0.5f) return;
   lastSteeringAngle = angleDeg;
 
-  // Get the STEERING sprite
-  TFT_eSprite *sprite = RenderEngine::getSprite(RenderEngine::STEERING);
+  TFT_eSPI *sprite = SafeDraw::getDrawTarget(ctx);
   if (sprite == nullptr) {
-    Logger::error("drawSteeringWheel: STEERING sprite not available");
+    Logger::error("drawSteeringWheel: no draw target");
     return;
   }
 
@@ -864,7 +928,7 @@ static void drawSteeringWheel(float angleDeg) {
   int steerY = cy - wheelRadius - 5;
   int steerW = (wheelRadius + 5) * 2;
   int steerH = (wheelRadius + 5) * 2 + 20; // Include text area
-  RenderEngine::markDirtyRect(steerX, steerY, steerW, steerH);
+  ctx.markDirty(steerX, steerY, steerW, steerH);
 }
 
 void HUD::drawPedalBar(float pedalPercent, TFT_eSprite *sprite) {
@@ -1179,8 +1243,16 @@ void HUD::update(TFT_eSprite *sprite) {
   tft->drawPixel(2, 0, TFT_RED);
 #endif
 
+  // Contexto de dibujo: sprite si existe, TFT directo si no
+  HudLayer::RenderContext ctx(sprite, true, 0, 0,
+                              sprite ? sprite->width() : TFT_WIDTH,
+                              sprite ? sprite->height() : TFT_HEIGHT);
+
   // Draw car body outline (once, static background)
-  drawCarBody();
+  if (!carBodyDrawn) {
+    drawCarBody(ctx);
+    carBodyDrawn = true;
+  }
 
 #ifdef DEBUG_RENDER
   // 🔒 v2.8.4: Fase 3 - después de dibujar carrocería
@@ -1221,7 +1293,7 @@ void HUD::update(TFT_eSprite *sprite) {
 
   // Mostrar ángulo del volante en grados (promedio de FL/FR)
   float avgSteerAngle = (steerAngleFL + steerAngleFR) / 2.0f;
-  drawSteeringWheel(avgSteerAngle);
+  drawSteeringWheel(avgSteerAngle, ctx);
 
   // Iconos y estados
   Icons::drawSystemState(sys, sprite);
@@ -1254,10 +1326,6 @@ void HUD::update(TFT_eSprite *sprite) {
   OperationMode mode = SystemMode::getMode();
   if (mode != OperationMode::MODE_FULL) {
     // Phase 6.4: Dual-mode rendering - sprite or TFT
-    // 🚨 CRITICAL FIX: Create safe RenderContext
-    HudLayer::RenderContext ctx(sprite, true, 0, 0,
-                                sprite ? sprite->width() : TFT_WIDTH,
-                                sprite ? sprite->height() : TFT_HEIGHT);
     TFT_eSPI *drawTarget = SafeDraw::getDrawTarget(ctx);
     drawTarget->setTextDatum(MC_DATUM);
     drawTarget->setTextColor(TFT_YELLOW, TFT_BLACK);
@@ -1277,217 +1345,31 @@ void HUD::update(TFT_eSprite *sprite) {
   drawDemoButton();
 #endif
 
-  // --- Lectura táctil usando touch_map ---
-  // 🔒 v2.8.8: Solo leer touch si está habilitado e inicializado (usando
-  // TFT_eSPI integrado)
-  bool batteryTouch = false;
+  // --- Toques: HUD::handleTouch() ya procesó los gestos de este frame ---
+  bool batteryTouch = batteryTapPending &&
+                      (millis() - batteryTapMs) <= BATTERY_TAP_LATCH_MS;
+  batteryTapPending = false;
+
 #ifdef STANDALONE_DISPLAY
+  // In demo mode, activate hidden menu directly on demo button long press
+  // This bypasses the code entry mechanism for easier testing
   bool demoButtonTouched = false;
-  static bool hiddenMenuJustActivated = false;
-#endif
-
-#ifndef DISABLE_TOUCH
-  uint16_t touchX = 0, touchY = 0;
-
-  // 🔒 v2.9.2: Enhanced touch detection with diagnostics
-  // Try to get calibrated touch coordinates
-  bool touchDetected =
-      touchInitialized && cfg.touchEnabled && tft->getTouch(&touchX, &touchY);
-
-  // 🔒 v2.9.3: Additional diagnostics - check raw touch values when calibrated
-  // touch fails This helps identify if the issue is calibration vs hardware
-  static uint32_t lastRawTouchCheck = 0;
-  static bool lastTouchState = false;
-  static uint32_t diagnosticCounter = 0;
-  uint32_t now = millis();
-
-  if (!touchDetected && touchInitialized && cfg.touchEnabled) {
-    // Periodically check if raw touch is working even if calibrated touch isn't
-    if (now - lastRawTouchCheck > DIAGNOSTIC_RAW_TOUCH_CHECK_INTERVAL_MS) {
-      uint16_t rawX = 0, rawY = 0;
-      bool rawTouchActive = tft->getTouchRaw(&rawX, &rawY);
-
-      if (rawTouchActive) {
-        // Read Z pressure value to diagnose sensitivity issues
-        // Note: This is intentionally called each diagnostic interval when
-        // touch is active to monitor pressure levels and help identify
-        // Z_THRESHOLD issues
-        uint16_t rawZ = tft->getTouchRawZ();
-        diagnosticCounter++;
-
-        // Log every Nth detection (starting from 0: counts 0, 5, 10, ...)
-        // This avoids spam while still providing regular diagnostic updates
-        if (diagnosticCounter % DIAGNOSTIC_LOG_INTERVAL == 0) {
-          Logger::infof("Touch: Raw touch detected but getTouch() failed - Raw "
-                        "X=%d, Y=%d, Z=%d",
-                        rawX, rawY, rawZ);
-          Logger::warn("Touch: This indicates calibration issue - run "
-                       "calibration routine");
-          Logger::warn(
-              "Touch: Tap battery icon 4 times (8-9-8-9), select option 3");
-
-// Check if Z value is below threshold
-#ifdef Z_THRESHOLD
-          if (rawZ < Z_THRESHOLD) {
-            Logger::warnf("Touch: Z pressure (%d) is below threshold (%d) - "
-                          "touch not registered",
-                          rawZ, Z_THRESHOLD);
-            Logger::warn("Touch: Consider lowering Z_THRESHOLD in "
-                         "platformio.ini if touches are too hard to detect");
-          }
-#endif
-        }
-      }
-      lastRawTouchCheck = now;
-    }
-  }
-
-  // Log touch state changes for debugging
-  if (touchDetected != lastTouchState) {
-    if (touchDetected) {
-      Logger::info("Touch: Screen touched");
-    } else {
-      Logger::info("Touch: Screen released");
+  if (demoButtonWasPressed) {
+    // Actualizar progreso visual mientras se mantiene pulsado
+    uint32_t elapsed = millis() - demoButtonPressStart;
+    demoButtonProgress = (float)elapsed / (float)DEMO_BUTTON_LONG_PRESS_MS;
+    if (demoButtonProgress > 1.0f) demoButtonProgress = 1.0f;
+
+    if (elapsed >= DEMO_BUTTON_LONG_PRESS_MS) {
+      demoButtonTouched = true;
+      demoButtonWasPressed = false;
+      demoButtonProgress = 0.0f;
+      Logger::info("Demo button long press - activating hidden menu");
     }
-    lastTouchState = touchDetected;
   }
 
-  // 🔒 v2.8.8: Usar tft->getTouch() del touch integrado de TFT_eSPI
-  if (touchDetected) {
-    int x = (int)touchX;
-    int y = (int)touchY;
-
-    // 🔒 v2.16.0: SECURITY FIX - Bounds checking to prevent framebuffer
-    // overflow Malformed touch coordinates (bad calibration or hardware glitch)
-    // could cause:
-    // - Buffer overflow in TFT_eSPI internal framebuffer
-    // - Memory corruption if coordinates exceed display dimensions
-    // - Crash from out-of-bounds array access
-    if (x < 0 || x >= 480 || y < 0 || y >= 320) {
-      static uint32_t lastBoundsWarning = 0;
-      uint32_t now = millis();
-      // Throttle warning to once per second to avoid serial spam
-      if (now - lastBoundsWarning > 1000) {
-        Logger::warnf("Touch: coordinates out of bounds (%d, %d) - IGNORED", x,
-                      y);
-        lastBoundsWarning = now;
-      }
-      // Do NOT process this touch event - skip remaining touch processing
-    } else {
-
-      // Touch coordinates are now correct after X-axis inversion fix
-      // Visual debug indicators removed per user request
-      // Touch logging remains for diagnostics
-
-      uint32_t now = millis();
-
-      // Log touch coordinates for debugging
-#ifdef TOUCH_DEBUG
-      // Verbose logging for troubleshooting - logs every touch with raw values
-      // Only read Z if raw touch read succeeds to avoid unnecessary SPI traffic
-      static uint32_t lastTouchLogTime = 0;
-      if (now - lastTouchLogTime > 100) { // Limit to 10 times per second
-        uint16_t rawX = 0, rawY = 0;
-        if (tft->getTouchRaw(&rawX, &rawY)) {
-          uint16_t rawZ = tft->getTouchRawZ(); // Read pressure only after
-                                               // successful raw read
-          Logger::infof("Touch detected at (%d, %d) - RAW: X=%d, Y=%d, Z=%d", x,
-                        y, rawX, rawY, rawZ);
-        } else {
-          Logger::infof("Touch detected at (%d, %d)", x, y);
-        }
-        lastTouchLogTime = now;
-      }
-#else
-      // Normal logging - only once per second to avoid spam
-      static uint32_t lastTouchLogTime = 0;
-      if (now - lastTouchLogTime > 1000) { // Log every second max
-        Logger::infof("Touch detected at (%d, %d)", x, y);
-        lastTouchLogTime = now;
-      }
-#endif
-
-#ifdef STANDALONE_DISPLAY
-      // Check demo button touch with long press detection
-      // Reset long press timer if touch moves outside button area
-      bool touchInButton = isTouchInDemoButton(x, y) && !MenuHidden::isActive();
-      if (touchInButton) {
-        uint32_t now = millis();
-        if (!demoButtonWasPressed) {
-          demoButtonPressStart = now;
-          demoButtonWasPressed = true;
-          demoButtonProgress = 0.0f;
-          Logger::info("Demo button touched - hold 1.5s for menu");
-        } else {
-          // Actualizar progreso visual
-          uint32_t elapsed = now - demoButtonPressStart;
-          demoButtonProgress =
-              (float)elapsed / (float)DEMO_BUTTON_LONG_PRESS_MS;
-          if (demoButtonProgress > 1.0f) demoButtonProgress = 1.0f;
-
-          if (elapsed >= DEMO_BUTTON_LONG_PRESS_MS) {
-            // Long press detected - activate hidden menu directly
-            demoButtonTouched = true;
-            hiddenMenuJustActivated = true;
-            demoButtonWasPressed = false;
-            demoButtonProgress = 0.0f;
-            Logger::info("Demo button long press - activating hidden menu");
-          }
-        }
-      } else {
-        // Reset if touch moved outside button area
-        demoButtonWasPressed = false;
-        demoButtonProgress = 0.0f;
-      }
-#endif
-
-      // Check axis rotation button touch (simple toggle on touch)
-      static bool axisButtonWasPressed = false;
-      if (isTouchInAxisButton(x, y)) {
-        if (!axisButtonWasPressed) {
-          axisButtonWasPressed = true;
-          toggleAxisRotation();
-        }
-      } else {
-        axisButtonWasPressed = false;
-      }
-
-      TouchAction act = getTouchedZone(x, y);
-      switch (act) {
-      case TouchAction::Battery:
-        batteryTouch = true;
-        break;
-      // v2.14.0: Lights and Multimedia removed - cleaner interface
-      case TouchAction::Mode4x4: {
-        Logger::info("Toque en icono 4x4 - toggling traction mode");
-        // Toggle between 4x4 and 4x2 mode
-        const Traction::State &currentTraction = Traction::get();
-        bool newMode = !currentTraction.enabled4x4;
-        Traction::setMode4x4(newMode);
-        Logger::infof("Mode switched to: %s", newMode ? "4x4" : "4x2");
-        break;
-      }
-      case TouchAction::Warning:
-        Logger::info("Toque en icono warning");
-        break;
-      default:
-        break;
-      }
-    } // End of else block for bounds checking
-  } else {
-#ifdef STANDALONE_DISPLAY
-    demoButtonWasPressed = false;
-    demoButtonProgress = 0.0f;
-#endif
-  }
-#endif // DISABLE_TOUCH
-
-#ifdef STANDALONE_DISPLAY
-  // In demo mode, activate hidden menu directly on demo button long press
-  // This bypasses the code entry mechanism for easier testing
-  if (demoButtonTouched && hiddenMenuJustActivated) {
+  if (demoButtonTouched) {
     MenuHidden::activateDirectly();
-    hiddenMenuJustActivated = false;
   } else {
     // Normal battery touch handling
     MenuHidden::update(batteryTouch);
@@ -1496,73 +1378,14 @@ void HUD::update(TFT_eSprite *sprite) {
   // Menú oculto: botón físico o toque en batería
   MenuHidden::update(batteryTouch);
 #endif
-
-#ifdef RENDER_SHADOW_MODE
-  // Phase 4: Automatic pixel comparison (measurement only)
-  // Compare STEERING vs STEERING_SHADOW to measure sprite bypass
-  // This runs BEFORE sprite push to capture the complete frame state
-  static uint32_t comparisonFrameCount = 0;
-  comparisonFrameCount++;
-
-  // Run comparison every frame for accurate statistics
-  uint32_t mismatchPixels = RenderEngine::compareShadowSprites();
-
-  // Get detailed metrics
-  float matchPercentage = 0.0f;
-  uint32_t maxMismatch = 0;
-  float avgMismatch = 0.0f;
-  RenderEngine::getShadowMetrics(matchPercentage, maxMismatch, avgMismatch);
-
-  // Draw debug overlay every 30 frames (once per second at 30 FPS)
-  // This avoids excessive TFT drawing overhead
-  if (comparisonFrameCount % 30 == 0) {
-    // Draw small debug overlay in top-right corner (below battery icon)
-    // Using direct TFT to avoid affecting sprite comparison
-    const int overlayX = 360;
-    const int overlayY = 50;
-    const int overlayW = 115;
-    const int overlayH = 40;
-
-    // Semi-transparent background
-    tft->fillRect(overlayX, overlayY, overlayW, overlayH, 0x18E3); // Dark gray
-    tft->drawRect(overlayX, overlayY, overlayW, overlayH, TFT_CYAN);
-
-    // Display match percentage
-    tft->setTextDatum(TL_DATUM);
-    tft->setTextColor(TFT_WHITE, 0x18E3);
-    char buf[32];
-    snprintf(buf, sizeof(buf), "MATCH: %.1f%%", matchPercentage);
-    tft->drawString(buf, overlayX + 3, overlayY + 3, 1);
-
-    // Display mismatch pixel count
-    tft->setTextColor(mismatchPixels > 10000 ? TFT_RED : TFT_GREEN, 0x18E3);
-    snprintf(buf, sizeof(buf), "DIFF: %u px", mismatchPixels);
-    tft->drawString(buf, overlayX + 3, overlayY + 13, 1);
-
-    // Display max and avg
-    tft->setTextColor(TFT_YELLOW, 0x18E3);
-    snprintf(buf, sizeof(buf), "MAX: %u", maxMismatch);
-    tft->drawString(buf, overlayX + 3, overlayY + 23, 1);
-    snprintf(buf, sizeof(buf), "AVG: %.0f", avgMismatch);
-    tft->drawString(buf, overlayX + 60, overlayY + 23, 1);
-  }
-#endif
-
-  // Render all sprite layers to display
-  RenderEngine::render();
 }
 
 // ============================================================================
 // PHASE 10: RenderContext-based update for granular dirty tracking
 // ============================================================================
-void HUD::update(HudLayer::RenderContext &ctx) {
-  if (!ctx.isValid()) {
-    // Fallback to sprite-only version
-    update(ctx.sprite);
-    return;
-  }
-
-  // Same sensor data gathering as sprite version
+// Same sensor data gathering as the sprite version, snapshotted once per
+// frame (and per pacer tick by HUD::hasPendingChanges)
+static HudBaseModel::Inputs gatherInputs() {
 #ifdef STANDALONE_DISPLAY
   float speedKmh = 12.0f;
   float rpm = 850.0f;
@@ -1579,8 +1402,6 @@ void HUD::update(HudLayer::RenderContext &ctx) {
   float wheelEffortFR = 30.0f;
   float wheelEffortRL = 28.0f;
   float wheelEffortRR = 28.0f;
-  Buttons::State btns;
-  btns.lights = false;
   bool mode4x4 = true;
   bool eco = false;
   uint8_t sensorCurrentOK = 6;
@@ -1595,7 +1416,6 @@ void HUD::update(HudLayer::RenderContext &ctx) {
   auto sh = Shifter::get();
   auto sys = System::getState();
   auto tr = Traction::get();
-  auto btns = Buttons::get();
 
   float vFL = cfg.wheelSensorsEnabled ? Sensors::getWheelSpeed(0) : 0.0f;
   float vFR = cfg.wheelSensorsEnabled ? Sensors::getWheelSpeed(1) : 0.0f;
@@ -1658,58 +1478,187 @@ void HUD::update(HudLayer::RenderContext &ctx) {
   }
 #endif
 
-  // Draw car body (static, already has dirty tracking via RenderEngine)
-  drawCarBody();
+  HudBaseModel::Inputs in = {};
+  in.speedKmh = speedKmh;
+  in.rpm = rpm;
+  in.pedalPercent = pedalPercent;
+  in.steerFL = steerAngleFL;
+  in.steerFR = steerAngleFR;
+  in.steerAngle = (steerAngleFL + steerAngleFR) / 2.0f;
+  in.wheelTemp[0] = wheelTempFL;
+  in.wheelTemp[1] = wheelTempFR;
+  in.wheelTemp[2] = wheelTempRL;
+  in.wheelTemp[3] = wheelTempRR;
+  in.wheelEffort[0] = wheelEffortFL;
+  in.wheelEffort[1] = wheelEffortFR;
+  in.wheelEffort[2] = wheelEffortRL;
+  in.wheelEffort[3] = wheelEffortRR;
+#ifdef STANDALONE_DISPLAY
+  in.batteryVolts = 24.5f;
+  in.mode = static_cast<uint8_t>(OperationMode::MODE_FULL);
+#else
+  in.batteryVolts = cfg.currentSensorsEnabled ? Sensors::getVoltage(0) : 0.0f;
+  OperationMode mode = SystemMode::getMode();
+  in.mode = static_cast<uint8_t>(mode);
+#endif
+  in.ambientTemp = ambientTemp;
+  in.maxTemp = maxTemp;
+  in.errorCount = static_cast<uint16_t>(System::getErrorCount());
+  in.systemState = static_cast<uint8_t>(sys);
+  in.gear = static_cast<uint8_t>(gear);
+  in.sensorCurrentOK = sensorCurrentOK;
+  in.sensorTempOK = sensorTempOK;
+  in.sensorWheelOK = sensorWheelOK;
+  in.mode4x4 = mode4x4;
+  in.eco = eco;
+  in.tempWarning = tempWarning;
+  return in;
+}
 
-  // Phase 10: Call RenderContext versions for granular dirty tracking
-  Gauges::drawSpeed(X_SPEED, Y_SPEED, speedKmh, MAX_SPEED_KMH, pedalPercent,
-                    ctx);
-  Gauges::drawRPM(X_RPM, Y_RPM, rpm, MAX_RPM, ctx);
+bool HUD::hasPendingChanges() {
+  return baseModel.pending(gatherInputs()) != 0;
+}
 
-  WheelsDisplay::drawWheel(X_FL, Y_FL, steerAngleFL, wheelTempFL, wheelEffortFL,
-                           ctx);
-  WheelsDisplay::drawWheel(X_FR, Y_FR, steerAngleFR, wheelTempFR, wheelEffortFR,
-                           ctx);
-  WheelsDisplay::drawWheel(X_RL, Y_RL, 0.0f, wheelTempRL, wheelEffortRL, ctx);
-  WheelsDisplay::drawWheel(X_RR, Y_RR, 0.0f, wheelTempRR, wheelEffortRR, ctx);
+void HUD::update(HudLayer::RenderContext &ctx) {
+  if (!ctx.isValid()) {
+    // Fallback to sprite-only version
+    update(ctx.sprite);
+    return;
+  }
 
-  float avgSteerAngle = (steerAngleFL + steerAngleFR) / 2.0f;
-  drawSteeringWheel(
-      avgSteerAngle); // Already has dirty tracking via RenderEngine
+  const HudBaseModel::Inputs in = gatherInputs();
+
+  using HudBaseModel::bit;
+  uint32_t redraw;
+  bool carBody;
+  HudLayer::RenderContext drawCtx = ctx;
+
+  if (HudCompositor::isShadowModeEnabled() &&
+      ctx.sprite != HudCompositor::getLayerSprite(HudLayer::Layer::BASE)) {
+    // Shadow pass (BASE rendered again into the shadow sprite): replay the
+    // main pass without consuming the model or adding its rects twice. The
+    // gauges' own diff has already moved on, as it always had.
+    redraw = lastBaseRedraw;
+    carBody = lastCarBodyRedraw;
+    drawCtx.dirtyRects = nullptr;
+    drawCtx.dirtyCount = nullptr;
+  } else {
+    // Whatever the compositor cleared before this pass must be drawn again
+    carBody = ctx.dirty;
+    if (ctx.dirty) {
+      baseModel.invalidate();
+    } else if (ctx.dirtyRects && ctx.dirtyCount) {
+      for (int i = 0; i < *ctx.dirtyCount; i++) {
+        const HudLayer::DirtyRect &r = ctx.dirtyRects[i];
+        HudBaseModel::Rect cleared = {r.x, r.y, r.w, r.h};
+        baseModel.invalidateUnder(&cleared, 1);
+        carBody = carBody ||
+                  (cleared.x < CAR_BODY_BOUNDS.x + CAR_BODY_BOUNDS.w &&
+                   CAR_BODY_BOUNDS.x < cleared.x + cleared.w &&
+                   cleared.y < CAR_BODY_BOUNDS.y + CAR_BODY_BOUNDS.h &&
+                   CAR_BODY_BOUNDS.y < cleared.y + cleared.h);
+      }
+    }
+    // A redrawn car body covers the wheels, the steering wheel and the
+    // gear's lower edge: they go on top again
+    if (carBody) baseModel.invalidateUnder(&CAR_BODY_BOUNDS, 1);
+    redraw = baseModel.update(in);
+
+    // The model decides, the widgets' own caches must not veto a redraw.
+    // The gauges keep theirs for value changes (needle and digits are
+    // diffed per pixel); redrawn for any other reason their pixels are
+    // gone, and Gauges::invalidate() answers that with a full redraw of
+    // both dials.
+    if (redraw & ~baseModel.changedKeys() & HudBaseModel::GAUGE_WIDGETS) {
+      Gauges::invalidate();
+      redraw |= HudBaseModel::GAUGE_WIDGETS;
+    }
+    lastBaseRedraw = redraw;
+    lastCarBodyRedraw = carBody;
+  }
 
-  Icons::drawSystemState(sys, ctx);
-  Icons::drawGear(gear, ctx);
-  Icons::drawFeatures(mode4x4, eco, ctx);
+  if (carBody) drawCarBody(drawCtx);
 
-#ifdef STANDALONE_DISPLAY
-  Icons::drawBattery(24.5f, ctx);
-#else
-  Icons::drawBattery(cfg.currentSensorsEnabled ? Sensors::getVoltage(0) : 0.0f,
-                     ctx);
-#endif
+  if (redraw & HudBaseModel::WHEEL_WIDGETS) WheelsDisplay::invalidate();
+  if (redraw & HudBaseModel::ICON_WIDGETS) Icons::invalidate();
+  if (redraw & bit(HudBaseModel::STEERING)) lastSteeringAngle = -999.0f;
+  if (redraw & bit(HudBaseModel::PEDAL)) lastPedalPercent = -999.0f;
 
-  Icons::drawAmbientTemp(ambientTemp, ctx);
-  Icons::drawErrorWarning(ctx);
-  Icons::drawSensorStatus(sensorCurrentOK, sensorTempOK, sensorWheelOK,
-                          Sensors::NUM_CURRENTS, Sensors::NUM_TEMPS,
-                          Sensors::NUM_WHEELS, ctx);
-  Icons::drawTempWarning(tempWarning, maxTemp, ctx);
+  // Phase 10: Call RenderContext versions for granular dirty tracking
+  if (redraw & bit(HudBaseModel::SPEED)) {
+    Gauges::drawSpeed(X_SPEED, Y_SPEED, in.speedKmh, MAX_SPEED_KMH,
+                      in.pedalPercent, drawCtx);
+  }
+  if (redraw & bit(HudBaseModel::RPM)) {
+    Gauges::drawRPM(X_RPM, Y_RPM, in.rpm, MAX_RPM, drawCtx);
+  }
+
+  if (redraw & bit(HudBaseModel::WHEEL_FL)) {
+    WheelsDisplay::drawWheel(X_FL, Y_FL, in.steerFL, in.wheelTemp[0],
+                             in.wheelEffort[0], drawCtx);
+  }
+  if (redraw & bit(HudBaseModel::WHEEL_FR)) {
+    WheelsDisplay::drawWheel(X_FR, Y_FR, in.steerFR, in.wheelTemp[1],
+                             in.wheelEffort[1], drawCtx);
+  }
+  if (redraw & bit(HudBaseModel::WHEEL_RL)) {
+    WheelsDisplay::drawWheel(X_RL, Y_RL, 0.0f, in.wheelTemp[2],
+                             in.wheelEffort[2], drawCtx);
+  }
+  if (redraw & bit(HudBaseModel::WHEEL_RR)) {
+    WheelsDisplay::drawWheel(X_RR, Y_RR, 0.0f, in.wheelTemp[3],
+                             in.wheelEffort[3], drawCtx);
+  }
+
+  if (redraw & bit(HudBaseModel::STEERING)) {
+    drawSteeringWheel(in.steerAngle, drawCtx);
+  }
+
+  if (redraw & bit(HudBaseModel::SYSTEM_STATE)) {
+    Icons::drawSystemState(
+        static_cast<System::State>(in.systemState), drawCtx);
+  }
+  if (redraw & bit(HudBaseModel::GEAR)) {
+    Icons::drawGear(static_cast<Shifter::Gear>(in.gear), drawCtx);
+  }
+  if (redraw & bit(HudBaseModel::FEATURES)) {
+    Icons::drawFeatures(in.mode4x4, in.eco, drawCtx);
+  }
+  if (redraw & bit(HudBaseModel::BATTERY)) {
+    Icons::drawBattery(in.batteryVolts, drawCtx);
+  }
+  if (redraw & bit(HudBaseModel::AMBIENT_TEMP)) {
+    Icons::drawAmbientTemp(in.ambientTemp, drawCtx);
+  }
+  if (redraw & bit(HudBaseModel::ERRORS)) Icons::drawErrorWarning(drawCtx);
+  if (redraw & bit(HudBaseModel::SENSOR_STATUS)) {
+    Icons::drawSensorStatus(in.sensorCurrentOK, in.sensorTempOK,
+                            in.sensorWheelOK,
+                            Sensors::NUM_CURRENTS, Sensors::NUM_TEMPS,
+                            Sensors::NUM_WHEELS, drawCtx);
+  }
+  if (redraw & bit(HudBaseModel::TEMP_WARNING)) {
+    Icons::drawTempWarning(in.tempWarning, in.maxTemp, drawCtx);
+  }
 
 #ifndef STANDALONE_DISPLAY
-  OperationMode mode = SystemMode::getMode();
-  if (mode != OperationMode::MODE_FULL) {
-    // 🚨 CRITICAL FIX: Use getDrawTarget for safe access
-    TFT_eSPI *drawTarget = SafeDraw::getDrawTarget(ctx);
-    drawTarget->setTextDatum(MC_DATUM);
-    drawTarget->setTextColor(TFT_YELLOW, TFT_BLACK);
-    SafeDraw::drawString(ctx, SystemMode::getModeName(), MODE_INDICATOR_X,
-                         MODE_INDICATOR_Y, 2);
-    // Mark mode indicator dirty
-    ctx.markDirty(MODE_INDICATOR_X - 60, MODE_INDICATOR_Y - 10, 120, 20);
+  if (redraw & bit(HudBaseModel::MODE)) {
+    // Clear first: going back to MODE_FULL must erase the old name
+    SafeDraw::fillRect(drawCtx, MODE_INDICATOR_X - 60, MODE_INDICATOR_Y - 10,
+                       120, 20, TFT_BLACK);
+    if (in.mode != static_cast<uint8_t>(OperationMode::MODE_FULL)) {
+      // 🚨 CRITICAL FIX: Use getDrawTarget for safe access
+      TFT_eSPI *drawTarget = SafeDraw::getDrawTarget(drawCtx);
+      drawTarget->setTextDatum(MC_DATUM);
+      drawTarget->setTextColor(TFT_YELLOW, TFT_BLACK);
+      SafeDraw::drawString(drawCtx, SystemMode::getModeName(),
+                           MODE_INDICATOR_X, MODE_INDICATOR_Y, 2);
+    }
+    drawCtx.markDirty(MODE_INDICATOR_X - 60, MODE_INDICATOR_Y - 10, 120, 20);
   }
 #endif
 
-  drawPedalBar(pedalPercent, ctx);
+  if (redraw & bit(HudBaseModel::PEDAL)) drawPedalBar(in.pedalPercent, drawCtx);
 
   // Axis rotation button - uses direct TFT rendering, already has change
   // tracking
@@ -0,0 +1,178 @@
+// hud_base_model.cpp - Per-widget change model for the BASE HUD layer
+#include "hud_base_model.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+namespace HudBaseModel {
+
+// ============================================================================
+// Field table
+// ============================================================================
+
+enum class FieldType : uint8_t { F32, U16, U8, BOOL };
+
+struct Field {
+  Widget widget;
+  FieldType type;
+  uint16_t offset; // In Inputs
+  float step;      // Display resolution (F32 only)
+};
+
+#define F32(w, member, step)                                                   \
+  { w, FieldType::F32, offsetof(Inputs, member), step }
+#define EXACT(w, type, member)                                                 \
+  { w, FieldType::type, offsetof(Inputs, member), 0.0f }
+
+static const Field FIELDS[] = {
+    F32(SPEED, speedKmh, 0.1f),
+    F32(RPM, rpm, 1.0f),
+
+    F32(WHEEL_FL, steerFL, 0.5f),
+    F32(WHEEL_FL, wheelTemp[0], 1.0f),
+    F32(WHEEL_FL, wheelEffort[0], 1.0f),
+    F32(WHEEL_FR, steerFR, 0.5f),
+    F32(WHEEL_FR, wheelTemp[1], 1.0f),
+    F32(WHEEL_FR, wheelEffort[1], 1.0f),
+    F32(WHEEL_RL, wheelTemp[2], 1.0f), // Rear wheels do not steer
+    F32(WHEEL_RL, wheelEffort[2], 1.0f),
+    F32(WHEEL_RR, wheelTemp[3], 1.0f),
+    F32(WHEEL_RR, wheelEffort[3], 1.0f),
+
+    F32(STEERING, steerAngle, 0.5f),
+
+    EXACT(SYSTEM_STATE, U8, systemState),
+    EXACT(GEAR, U8, gear),
+    EXACT(FEATURES, BOOL, mode4x4),
+    EXACT(FEATURES, BOOL, eco),
+    F32(BATTERY, batteryVolts, 0.1f),
+    F32(AMBIENT_TEMP, ambientTemp, 1.0f),
+    EXACT(ERRORS, U16, errorCount),
+    EXACT(SENSOR_STATUS, U8, sensorCurrentOK),
+    EXACT(SENSOR_STATUS, U8, sensorTempOK),
+    EXACT(SENSOR_STATUS, U8, sensorWheelOK),
+    EXACT(TEMP_WARNING, BOOL, tempWarning),
+    F32(TEMP_WARNING, maxTemp, 1.0f),
+
+    EXACT(MODE, U8, mode),
+    F32(PEDAL, pedalPercent, 1.0f),
+};
+
+#undef F32
+#undef EXACT
+
+static_assert(sizeof(FIELDS) / sizeof(FIELDS[0]) == FIELD_COUNT,
+              "FIELD_COUNT out of step with the field table");
+
+// Never produced by a reading: forces the first comparison to differ
+static constexpr int32_t KEY_NONE = INT32_MIN;
+static constexpr int32_t KEY_NAN = INT32_MIN + 1;
+static constexpr float KEY_LIMIT = 1.0e9f;
+
+static int32_t quantize(float value, float step, int32_t last) {
+  if (std::isnan(value)) return KEY_NAN;
+  float q = value / step;
+  if (q > KEY_LIMIT) q = KEY_LIMIT;
+  if (q < -KEY_LIMIT) q = -KEY_LIMIT;
+  int32_t key = static_cast<int32_t>(lroundf(q));
+
+  // Stay on the drawn key until the value is a full step away from it
+  if (key != last && last != KEY_NONE && last != KEY_NAN &&
+      fabsf(q - static_cast<float>(last)) < 0.5f + HYSTERESIS) {
+    return last;
+  }
+  return key;
+}
+
+static int32_t keyOf(const Field &f, const Inputs &in, int32_t last) {
+  const uint8_t *base = reinterpret_cast<const uint8_t *>(&in) + f.offset;
+  switch (f.type) {
+  case FieldType::F32: {
+    float v;
+    memcpy(&v, base, sizeof(v));
+    return quantize(v, f.step, last);
+  }
+  case FieldType::U16: {
+    uint16_t v;
+    memcpy(&v, base, sizeof(v));
+    return v;
+  }
+  case FieldType::U8:
+    return *base;
+  case FieldType::BOOL: {
+    bool v;
+    memcpy(&v, base, sizeof(v));
+    return v ? 1 : 0;
+  }
+  }
+  return KEY_NONE;
+}
+
+// ============================================================================
+// Model
+// ============================================================================
+
+static bool intersects(const Rect &a, const Rect &b) {
+  if (a.w <= 0 || a.h <= 0 || b.w <= 0 || b.h <= 0) return false;
+  return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h &&
+         b.y < a.y + a.h;
+}
+
+Model::Model(const Rect *widgetBounds)
+    : forced(ALL_WIDGETS), keyChanges(0), redrawCount(0) {
+  for (int i = 0; i < WIDGET_COUNT; i++) bounds[i] = widgetBounds[i];
+  for (int f = 0; f < FIELD_COUNT; f++) keys[f] = KEY_NONE;
+}
+
+void Model::invalidate(uint32_t widgets) { forced |= widgets & ALL_WIDGETS; }
+
+uint32_t Model::invalidateUnder(const Rect *cleared, int count) {
+  uint32_t hit = 0;
+  for (int r = 0; r < count; r++) {
+    for (int i = 0; i < WIDGET_COUNT; i++) {
+      if (intersects(bounds[i], cleared[r])) hit |= 1u << i;
+    }
+  }
+  forced |= hit;
+  return hit;
+}
+
+uint32_t Model::update(const Inputs &in) {
+  keyChanges = 0;
+  for (int f = 0; f < FIELD_COUNT; f++) {
+    int32_t key = keyOf(FIELDS[f], in, keys[f]);
+    if (key != keys[f]) {
+      keys[f] = key;
+      keyChanges |= bit(FIELDS[f].widget);
+    }
+  }
+
+  uint32_t redraw = forced | keyChanges;
+  forced = 0;
+
+  redrawCount += __builtin_popcount(redraw);
+  return redraw;
+}
+
+uint32_t Model::pending(const Inputs &in) const {
+  uint32_t redraw = forced;
+  for (int f = 0; f < FIELD_COUNT; f++) {
+    if (keyOf(FIELDS[f], in, keys[f]) != keys[f]) {
+      redraw |= bit(FIELDS[f].widget);
+    }
+  }
+  return redraw;
+}
+
+uint32_t Model::dirtyPixels(uint32_t widgets) const {
+  uint32_t pixels = 0;
+  for (int i = 0; i < WIDGET_COUNT; i++) {
+    if (!(widgets & (1u << i))) continue;
+    if (bounds[i].w <= 0 || bounds[i].h <= 0) continue;
+    pixels += static_cast<uint32_t>(bounds[i].w) * bounds[i].h;
+  }
+  return pixels;
+}
+
+} // namespace HudBaseModel
@@ -1,6 +1,10 @@
 #include "hud_compositor.h"
 #include "boot_guard.h"
 #include "logger.h"
+#include "shadow_compare.h"
+#include "spi_bus.h"
+#include "sprite_pool.h"
+#include "tear_sync.h"
 #include <cstring>
 
 // ============================================================================
@@ -26,13 +30,13 @@ void RenderContext::markDirty(int16_t x, int16_t y, int16_t w, int16_t h) {
 
 // Static member initialization
 TFT_eSPI *HudCompositor::tft = nullptr;
-TFT_eSprite *HudCompositor::layerSprites[LAYER_COUNT] = {nullptr};
+PooledSprite *HudCompositor::layerSprites[LAYER_COUNT] = {nullptr};
 HudLayer::LayerRenderer *HudCompositor::layerRenderers[LAYER_COUNT] = {nullptr};
 bool HudCompositor::layerDirty[LAYER_COUNT] = {false};
 bool HudCompositor::initialized = false;
 
 // PHASE 7: Shadow mode static members
-TFT_eSprite *HudCompositor::shadowSprite = nullptr;
+PooledSprite *HudCompositor::shadowSprite = nullptr;
 bool HudCompositor::shadowEnabled = false;
 uint32_t HudCompositor::shadowFrameCount = 0;
 uint32_t HudCompositor::shadowMismatchCount = 0;
@@ -58,6 +62,12 @@ bool HudCompositor::init(TFT_eSPI *tftDisplay) {
 
   tft = tftDisplay;
 
+  // The HUD's whole sprite budget, reserved before any sprite exists: the
+  // layers now, the shadow sprite whenever shadow mode is switched on
+  SpritePool::init(SPRITE_BUDGET, 0);
+  renderStats.psramBudgetBytes =
+      static_cast<uint32_t>(SPRITE_BUDGET) * SCREEN_WIDTH * SCREEN_HEIGHT * 2;
+
   // Create sprites for all layers
   bool allCreated = true;
   for (int i = 0; i < LAYER_COUNT; i++) {
@@ -80,6 +90,9 @@ bool HudCompositor::init(TFT_eSPI *tftDisplay) {
     return false;
   }
 
+  // Panel scan sync for the dirty-rect pushes (TE pin or estimate)
+  TearSync::init(tft);
+
   // Mark all layers dirty for initial draw
   markAllDirty();
 
@@ -101,10 +114,13 @@ bool HudCompositor::createLayerSprite(HudLayer::Layer layer) {
 
   // 🔒 v2.18.1: Check memory availability (PSRAM or heap)
   // Each sprite needs SCREEN_WIDTH * SCREEN_HEIGHT * 2 bytes (16-bit color)
+  // (already reserved when the sprite pool is up)
   size_t spriteSize = SCREEN_WIDTH * SCREEN_HEIGHT * 2;
   bool usePsram = psramFound();
 
-  if (usePsram) {
+  if (SpritePool::isReady()) {
+    // Buffer comes from the arena
+  } else if (usePsram) {
     if (ESP.getFreePsram() < spriteSize) {
       Logger::errorf("HudCompositor: Insufficient PSRAM for layer %d (need %u "
                      "bytes, have %u bytes)",
@@ -126,7 +142,8 @@ bool HudCompositor::createLayerSprite(HudLayer::Layer layer) {
   }
 
   // Create new sprite
-  layerSprites[idx] = new (std::nothrow) TFT_eSprite(tft);
+  layerSprites[idx] =
+      new (std::nothrow) PooledSprite(tft, static_cast<uint8_t>(idx));
   if (!layerSprites[idx]) {
     BootGuard::setResetMarker(BootGuard::RESET_MARKER_NULL_POINTER);
     Logger::errorf("HudCompositor: Failed to allocate sprite for layer %d",
@@ -134,17 +151,15 @@ bool HudCompositor::createLayerSprite(HudLayer::Layer layer) {
     return false;
   }
 
-  // 🔒 CRITICAL: Force sprites to PSRAM to avoid heap pressure/bootloops
-  // 🔒 v2.18.1: Only if PSRAM available (some hardware has bootloop with OPI)
-  if (usePsram) {
-    layerSprites[idx]->setAttribute(PSRAM_ENABLE, 1);
-  } else {
+  // 🔒 CRITICAL: Sprite buffers live in the PSRAM arena (or PSRAM on their
+  // own) to avoid heap pressure/bootloops
+  // 🔒 v2.18.1: Heap only if PSRAM is missing (bootloop with OPI)
+  if (!usePsram) {
     Logger::warn("  Layer sprite will use heap - monitor memory usage");
   }
 
   // Create sprite buffer (16-bit color)
-  void *spriteBuffer =
-      layerSprites[idx]->createSprite(SCREEN_WIDTH, SCREEN_HEIGHT);
+  void *spriteBuffer = layerSprites[idx]->create(SCREEN_WIDTH, SCREEN_HEIGHT);
   if (!spriteBuffer) {
     // 🔒 N16R8 CRITICAL: PSRAM allocation failed - diagnostic output
     Serial.printf("[HudCompositor] PSRAM FAIL Layer %d - buffer is NULL\n",
@@ -162,7 +177,10 @@ bool HudCompositor::createLayerSprite(HudLayer::Layer layer) {
   // Initialize sprite to transparent/black
   layerSprites[idx]->fillSprite(TFT_BLACK);
 
-  if (usePsram) {
+  if (layerSprites[idx]->isPooled()) {
+    Logger::infof("HudCompositor: Created sprite for layer %d (sprite pool)",
+                  idx);
+  } else if (usePsram) {
     Logger::infof("HudCompositor: Created sprite for layer %d (PSRAM "
                   "remaining: %u bytes)",
                   idx, ESP.getFreePsram());
@@ -287,6 +305,9 @@ void HudCompositor::render() {
 
     // Clear dirty flag after rendering
     layerDirty[i] = false;
+
+    // Layer done, no transfer open: let a waiting touch sample through
+    SpiBus::yieldIfContended(SpiBus::Device::DISPLAY);
   }
 
   // PHASE 8: Second pass for shadow mode validation (only dirty rects)
@@ -360,7 +381,10 @@ void HudCompositor::render() {
 
   // Update shadow mode statistics
   renderStats.shadowEnabled = shadowEnabled;
-  renderStats.shadowBlocksCompared = shadowFrameCount;
+  if (!shadowEnabled) {
+    renderStats.shadowBlocksCompared = 0;
+    renderStats.shadowCompareUs = 0;
+  }
   renderStats.shadowMismatches = shadowMismatchCount;
 
   // Calculate PSRAM usage
@@ -390,66 +414,75 @@ void HudCompositor::compositeLayers() {
     return; // Nothing to update
   }
 
+  // Sprites pushed per dirty rect, bottom first:
+  // - FULLSCREEN active: only the FULLSCREEN layer
+  // - Otherwise: BASE → STATUS → DIAGNOSTICS → OVERLAY
+  //
+  // KNOWN LIMITATION: TFT_eSprite doesn't support true alpha blending.
+  // We push each layer opaque, which works because:
+  // 1. Overlay layers (STATUS, DIAGNOSTICS) clear their backgrounds to BLACK
+  // 2. BLACK pixels in overlays don't cover important BASE content
+  //
+  // For true transparency, future enhancement could:
+  // - Use pushSprite(x, y, transColor) with color key
+  // - Implement custom pixel-by-pixel compositing
+  // - Use DMA2D hardware acceleration on supported chips
+  TFT_eSprite *stack[LAYER_COUNT];
+  uint8_t layers = 0;
   if (fullscreenActive) {
-    // Only push fullscreen layer (dirty rects)
     if (layerSprites[fullscreenIdx]) {
-      for (int r = 0; r < dirtyRectCount; r++) {
-        const HudLayer::DirtyRect &rect = dirtyRects[r];
-        if (!rect.isEmpty()) {
-          // pushSprite(x, y, sx, sy, sw, sh)
-          // x, y = destination on TFT
-          // sx, sy = source position in sprite
-          // sw, sh = width/height to copy
-          layerSprites[fullscreenIdx]->pushSprite(rect.x, rect.y, rect.x,
-                                                  rect.y, rect.w, rect.h);
-        }
-      }
+      stack[layers++] = layerSprites[fullscreenIdx];
     }
   } else {
-    // PHASE 8: Composite BASE → STATUS → DIAGNOSTICS → OVERLAY (dirty rects
-    // only)
-    //
-    // For each dirty rectangle:
-    // 1. Push BASE layer first (background)
-    // 2. Push overlay layers on top
-    //
-    // KNOWN LIMITATION: TFT_eSprite doesn't support true alpha blending.
-    // We push each layer opaque, which works because:
-    // 1. Overlay layers (STATUS, DIAGNOSTICS) clear their backgrounds to BLACK
-    // 2. BLACK pixels in overlays don't cover important BASE content
-    //
-    // For true transparency, future enhancement could:
-    // - Use pushSprite(x, y, transColor) with color key
-    // - Implement custom pixel-by-pixel compositing
-    // - Use DMA2D hardware acceleration on supported chips
-
-    for (int r = 0; r < dirtyRectCount; r++) {
-      const HudLayer::DirtyRect &rect = dirtyRects[r];
-      if (rect.isEmpty()) continue;
-
-      // Push BASE layer first (it's the background)
-      int baseIdx = static_cast<int>(HudLayer::Layer::BASE);
-      if (layerSprites[baseIdx] && layerRenderers[baseIdx] &&
-          layerRenderers[baseIdx]->isActive()) {
-        layerSprites[baseIdx]->pushSprite(rect.x, rect.y, rect.x, rect.y,
-                                          rect.w, rect.h);
+    for (int i = 0; i < LAYER_COUNT; i++) {
+      if (i == fullscreenIdx) {
+        continue; // Skip fullscreen when compositing normal layers
       }
-
-      // Push overlays on top
-      for (int i = 1; i < LAYER_COUNT; i++) {
-        if (i == fullscreenIdx) {
-          continue; // Skip fullscreen when compositing normal layers
-        }
-
-        if (layerSprites[i] && layerRenderers[i] &&
-            layerRenderers[i]->isActive()) {
-          // Push sprite opaque (see KNOWN LIMITATION above)
-          layerSprites[i]->pushSprite(rect.x, rect.y, rect.x, rect.y, rect.w,
-                                      rect.h);
-        }
+      if (layerSprites[i] && layerRenderers[i] &&
+          layerRenderers[i]->isActive()) {
+        stack[layers++] = layerSprites[i];
       }
     }
   }
+  if (layers == 0) { return; }
+
+  TearSync::Rect rects[MAX_DIRTY_RECTS];
+  uint8_t rectCount = 0;
+  for (int r = 0; r < dirtyRectCount; r++) {
+    const HudLayer::DirtyRect &rect = dirtyRects[r];
+    if (rect.isEmpty()) continue;
+    rects[rectCount++] = {rect.x, rect.y, rect.w, rect.h};
+  }
+
+  // Rect order chases the panel scan (TearSync), each push checked for tear
+  TearSync::PushOrder &order = TearSync::pushOrder();
+  order.begin(TearSync::snapshot(), TearSync::getMode(), rects, rectCount,
+              layers);
+  uint32_t waitUs = 0;
+  int8_t r;
+  while ((r = order.next(micros(), waitUs)) >= 0) {
+    if (waitUs > 0) { delayMicroseconds(waitUs); }
+
+    const TearSync::Rect &rect = rects[r];
+    uint32_t pushStart = micros();
+    for (uint8_t l = 0; l < layers; l++) {
+      // pushSprite(x, y, sx, sy, sw, sh)
+      // x, y = destination on TFT
+      // sx, sy = source position in sprite
+      // sw, sh = width/height to copy
+      stack[l]->pushSprite(rect.x, rect.y, rect.x, rect.y, rect.w, rect.h);
+    }
+    order.pushed(r, pushStart, micros());
+
+    // Between rects: a touch sample waits at most one rect push
+    SpiBus::yieldIfContended(SpiBus::Device::DISPLAY);
+  }
+
+  const TearSync::FrameReport &tear = order.end();
+  renderStats.tearSyncMode = TearSync::getMode();
+  renderStats.tearRiskRects = tear.riskRects;
+  renderStats.tearWaitUs = tear.waitUs;
+  renderStats.tearRiskFrames = order.stats().riskFrames;
 }
 
 void HudCompositor::clear() {
@@ -464,9 +497,14 @@ bool HudCompositor::isInitialized() { return initialized; }
 TFT_eSprite *HudCompositor::getLayerSprite(HudLayer::Layer layer) {
   int idx = static_cast<int>(layer);
   if (idx < 0 || idx >= LAYER_COUNT) { return nullptr; }
+  if (!layerSprites[idx]) { renderStats.nullSprites++; }
   return layerSprites[idx];
 }
 
+TFT_eSprite *HudCompositor::getShadowSprite() {
+  return shadowEnabled ? shadowSprite : nullptr;
+}
+
 // ============================================================================
 // PHASE 7: Shadow Mode Implementation
 // ============================================================================
@@ -483,7 +521,9 @@ bool HudCompositor::createShadowSprite() {
   size_t spriteSize = SCREEN_WIDTH * SCREEN_HEIGHT * 2;
   bool usePsram = psramFound();
 
-  if (usePsram) {
+  if (SpritePool::isReady()) {
+    // Buffer comes from the arena
+  } else if (usePsram) {
     if (ESP.getFreePsram() < spriteSize) {
       Logger::errorf(
           "HudCompositor: Insufficient PSRAM for shadow sprite (need %u bytes, "
@@ -505,23 +545,23 @@ bool HudCompositor::createShadowSprite() {
   }
 
   // Create new shadow sprite
-  shadowSprite = new (std::nothrow) TFT_eSprite(tft);
+  shadowSprite = new (std::nothrow) PooledSprite(tft, LAYER_COUNT);
   if (!shadowSprite) {
     BootGuard::setResetMarker(BootGuard::RESET_MARKER_NULL_POINTER);
     Logger::error("HudCompositor: Failed to allocate shadow sprite");
     return false;
   }
 
-  // 🔒 CRITICAL: Force shadow sprite to PSRAM to avoid heap pressure/bootloops
-  // 🔒 v2.18.1: Only if PSRAM available
-  if (usePsram) {
-    shadowSprite->setAttribute(PSRAM_ENABLE, 1);
-  } else {
+  // 🔒 CRITICAL: Shadow buffer in the PSRAM arena (or PSRAM on its own) to
+  // avoid heap pressure/bootloops
+  // 🔒 v2.18.1: Heap only if PSRAM is missing
+  if (!usePsram) {
     Logger::warn("  Shadow sprite will use heap - monitor memory usage");
   }
 
-  // Create sprite buffer (16-bit color)
-  void *spriteBuffer = shadowSprite->createSprite(SCREEN_WIDTH, SCREEN_HEIGHT);
+  // Create sprite buffer (16-bit color); toggling shadow mode reuses the
+  // same arena slot instead of churning PSRAM
+  void *spriteBuffer = shadowSprite->create(SCREEN_WIDTH, SCREEN_HEIGHT);
   if (!spriteBuffer) {
     // 🔒 N16R8 CRITICAL: PSRAM allocation failed - diagnostic output
     Serial.printf(
@@ -539,7 +579,9 @@ bool HudCompositor::createShadowSprite() {
   // Initialize sprite to transparent/black
   shadowSprite->fillSprite(TFT_BLACK);
 
-  if (usePsram) {
+  if (shadowSprite->isPooled()) {
+    Logger::info("HudCompositor: Shadow sprite created (sprite pool)");
+  } else if (usePsram) {
     Logger::infof(
         "HudCompositor: Shadow sprite created (PSRAM remaining: %u bytes)",
         ESP.getFreePsram());
@@ -551,33 +593,6 @@ bool HudCompositor::createShadowSprite() {
   return true;
 }
 
-uint16_t HudCompositor::computeBlockChecksum(TFT_eSprite *sprite, int blockX,
-                                             int blockY) {
-  if (!sprite) return 0;
-
-  uint16_t checksum = 0;
-  int startX = blockX * SHADOW_BLOCK_SIZE;
-  int startY = blockY * SHADOW_BLOCK_SIZE;
-  int endX = startX + SHADOW_BLOCK_SIZE;
-  int endY = startY + SHADOW_BLOCK_SIZE;
-
-  // Clamp to sprite bounds
-  if (endX > SCREEN_WIDTH) endX = SCREEN_WIDTH;
-  if (endY > SCREEN_HEIGHT) endY = SCREEN_HEIGHT;
-
-  // XOR-based checksum (fast and good enough for corruption detection)
-  for (int y = startY; y < endY; y++) {
-    for (int x = startX; x < endX; x++) {
-      uint16_t pixel = sprite->readPixel(x, y);
-      checksum ^= pixel;
-      // Add position influence to detect shifted content
-      checksum ^= static_cast<uint16_t>((x + y) & 0xFFFF);
-    }
-  }
-
-  return checksum;
-}
-
 void HudCompositor::compareShadowSprites() {
   if (!shadowEnabled || !shadowSprite) return;
 
@@ -599,51 +614,27 @@ void HudCompositor::compareShadowSprites() {
     return;
   }
 
-  uint32_t mismatchBlocks = 0;
-  bool firstMismatch = true;
-  int firstMismatchX = -1;
-  int firstMismatchY = -1;
-
-  // PHASE 8: Compare only blocks that intersect with dirty rectangles
-  for (int by = 0; by < SHADOW_BLOCKS_Y; by++) {
-    for (int bx = 0; bx < SHADOW_BLOCKS_X; bx++) {
-      // Calculate block bounds in pixels
-      int blockPixelX = bx * SHADOW_BLOCK_SIZE;
-      int blockPixelY = by * SHADOW_BLOCK_SIZE;
-      int blockPixelW = SHADOW_BLOCK_SIZE;
-      int blockPixelH = SHADOW_BLOCK_SIZE;
-
-      // PHASE 8: Check if this block intersects any dirty rectangle
-      bool blockIsDirty = false;
-      for (int r = 0; r < dirtyRectCount; r++) {
-        const HudLayer::DirtyRect &rect = dirtyRects[r];
-        // Check for intersection
-        if (!(blockPixelX >= rect.x + rect.w ||
-              blockPixelX + blockPixelW <= rect.x ||
-              blockPixelY >= rect.y + rect.h ||
-              blockPixelY + blockPixelH <= rect.y)) {
-          blockIsDirty = true;
-          break;
-        }
-      }
-
-      // Only compare blocks that were rendered (dirty)
-      if (!blockIsDirty) { continue; }
+  // Both sprites are 16-bit: hash block rows straight from the buffers
+  const uint16_t *mainPixels =
+      static_cast<const uint16_t *>(mainSprite->getPointer());
+  const uint16_t *shadowPixels =
+      static_cast<const uint16_t *>(shadowSprite->getPointer());
 
-      uint16_t checksumMain = computeBlockChecksum(mainSprite, bx, by);
-      uint16_t checksumShadow = computeBlockChecksum(shadowSprite, bx, by);
-
-      if (checksumMain != checksumShadow) {
-        mismatchBlocks++;
-        if (firstMismatch) {
-          firstMismatchX = bx;
-          firstMismatchY = by;
-          firstMismatch = false;
-        }
-      }
-    }
+  ShadowCompare::Rect rects[MAX_DIRTY_RECTS];
+  for (int r = 0; r < dirtyRectCount; r++) {
+    rects[r] = {dirtyRects[r].x, dirtyRects[r].y, dirtyRects[r].w,
+                dirtyRects[r].h};
   }
 
+  // PHASE 8: Compare only blocks covered by the dirty rectangles
+  uint32_t startUs = micros();
+  ShadowCompare::Result result =
+      ShadowCompare::compare(mainPixels, shadowPixels, SCREEN_WIDTH,
+                             SCREEN_HEIGHT, rects, dirtyRectCount);
+  renderStats.shadowCompareUs = micros() - startUs;
+  renderStats.shadowBlocksCompared = result.blocksCompared;
+
+  uint32_t mismatchBlocks = result.mismatches;
   shadowLastMismatchBlocks = mismatchBlocks;
 
   // Log mismatches
@@ -651,9 +642,9 @@ void HudCompositor::compareShadowSprites() {
     shadowMismatchCount++;
     Logger::errorf("HUD SHADOW MISMATCH: Frame %u, %u blocks differ, first at "
                    "block(%d,%d) px(%d,%d)",
-                   shadowFrameCount, mismatchBlocks, firstMismatchX,
-                   firstMismatchY, firstMismatchX * SHADOW_BLOCK_SIZE,
-                   firstMismatchY * SHADOW_BLOCK_SIZE);
+                   shadowFrameCount, mismatchBlocks, result.firstX,
+                   result.firstY, result.firstX * SHADOW_BLOCK_SIZE,
+                   result.firstY * SHADOW_BLOCK_SIZE);
 
     // Note: Visual indicator removed to avoid interfering with BASE layer
     // Corruption is visible in hidden menu statistics (red color when M > 0)
@@ -704,19 +695,28 @@ void HudCompositor::addDirtyRect(int16_t x, int16_t y, int16_t w, int16_t h) {
   HudLayer::DirtyRect rect(x, y, w, h);
 
   // Skip empty rectangles
-  if (rect.isEmpty()) { return; }
+  if (rect.isEmpty()) {
+    renderStats.rejectedRects++;
+    return;
+  }
 
   // Clip to screen bounds
-  rect = clipRect(rect);
-  if (rect.isEmpty()) {
+  HudLayer::DirtyRect clipped = clipRect(rect);
+  if (clipped.isEmpty()) {
+    renderStats.rejectedRects++;
     return; // Completely outside screen
   }
+  if (clipped.w != rect.w || clipped.h != rect.h) {
+    renderStats.clampedRects++;
+  }
+  rect = clipped;
 
   // If we've reached the limit, merge all existing rects into a full-screen
   // rect
   if (dirtyRectCount >= MAX_DIRTY_RECTS) {
     dirtyRects[0] = HudLayer::DirtyRect(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
     dirtyRectCount = 1;
+    renderStats.rectOverflows++;
     return;
   }
 
@@ -791,3 +791,10 @@ void HudCompositor::clearDirtyRects() { dirtyRectCount = 0; }
 const HudCompositor::RenderStats &HudCompositor::getRenderStats() {
   return renderStats;
 }
+
+void HudCompositor::setPacingStats(uint32_t targetFps, uint32_t actualFps,
+                                   uint32_t skippedFrames) {
+  renderStats.targetFps = targetFps;
+  renderStats.actualFps = actualFps;
+  renderStats.skippedFrames = skippedFrames;
+}
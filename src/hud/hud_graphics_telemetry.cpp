@@ -11,7 +11,7 @@ namespace HudGraphicsTelemetry {
 static constexpr int16_t TELEMETRY_X = 10;       // Fixed X position
 static constexpr int16_t TELEMETRY_Y = 10;       // Fixed Y position
 static constexpr int16_t TELEMETRY_WIDTH = 220;  // Fixed width
-static constexpr int16_t TELEMETRY_HEIGHT = 120; // Fixed height
+static constexpr int16_t TELEMETRY_HEIGHT = 144; // Fixed height
 
 static constexpr int16_t LINE_HEIGHT = 12; // Height per line
 static constexpr int16_t TEXT_SIZE = 1;    // Text size (small font)
@@ -27,10 +27,10 @@ static constexpr uint16_t COLOR_LABEL = TFT_CYAN;
 static constexpr uint16_t COLOR_BORDER_NORMAL = TFT_WHITE;
 static constexpr uint16_t COLOR_BORDER_ERROR = TFT_RED;
 
-// FPS color thresholds
-static constexpr uint16_t COLOR_FPS_GOOD = TFT_GREEN;  // FPS > 25
-static constexpr uint16_t COLOR_FPS_WARN = TFT_YELLOW; // FPS 15-25
-static constexpr uint16_t COLOR_FPS_BAD = TFT_RED;     // FPS < 15
+// FPS color thresholds (actual rate against the pacer target)
+static constexpr uint16_t COLOR_FPS_GOOD = TFT_GREEN;  // >= 90% of target
+static constexpr uint16_t COLOR_FPS_WARN = TFT_YELLOW; // 50-90% of target
+static constexpr uint16_t COLOR_FPS_BAD = TFT_RED;     // < 50% of target
 
 // ========================================
 // State
@@ -45,12 +45,12 @@ static bool visible = false; // Telemetry visibility flag
 // ========================================
 
 /**
- * @brief Get FPS color based on value
+ * @brief Get FPS color from the actual rate against the pacer target
  */
-static uint16_t getFpsColor(uint32_t fps) {
-  if (fps > 25) {
+static uint16_t getFpsColor(uint32_t fps, uint32_t targetFps) {
+  if (fps * 10 >= targetFps * 9) {
     return COLOR_FPS_GOOD;
-  } else if (fps >= 15) {
+  } else if (fps * 2 >= targetFps) {
     return COLOR_FPS_WARN;
   } else {
     return COLOR_FPS_BAD;
@@ -93,11 +93,20 @@ static void drawTelemetry(const HudCompositor::RenderStats &stats,
   // Buffer for formatting (static to avoid stack allocation overhead)
   static char buf[32];
 
-  // FPS (color-coded)
+  // FPS: actual / pacer target (color-coded)
   drawTarget->setTextColor(COLOR_LABEL, COLOR_BACKGROUND);
-  SafeDraw::drawString(ctx, "FPS:", cursorX, cursorY);
-  snprintf(buf, sizeof(buf), "%u", stats.fps);
-  drawTarget->setTextColor(getFpsColor(stats.fps), COLOR_BACKGROUND);
+  SafeDraw::drawString(ctx, "FPS (act/tgt):", cursorX, cursorY);
+  snprintf(buf, sizeof(buf), "%u/%u", stats.actualFps, stats.targetFps);
+  drawTarget->setTextColor(getFpsColor(stats.actualFps, stats.targetFps),
+                           COLOR_BACKGROUND);
+  SafeDraw::drawString(ctx, buf, cursorX + 100, cursorY);
+  cursorY += LINE_HEIGHT;
+
+  // Skipped frames (pacer slots missed)
+  drawTarget->setTextColor(COLOR_LABEL, COLOR_BACKGROUND);
+  SafeDraw::drawString(ctx, "Skipped:", cursorX, cursorY);
+  snprintf(buf, sizeof(buf), "%u", stats.skippedFrames);
+  drawTarget->setTextColor(COLOR_TEXT, COLOR_BACKGROUND);
   SafeDraw::drawString(ctx, buf, cursorX + 100, cursorY);
   cursorY += LINE_HEIGHT;
 
@@ -130,17 +139,32 @@ static void drawTelemetry(const HudCompositor::RenderStats &stats,
   drawTarget->setTextColor(COLOR_LABEL, COLOR_BACKGROUND);
   SafeDraw::drawString(ctx, "Bandwidth:", cursorX, cursorY);
   uint32_t bandwidthKBps =
-      (uint32_t)(((uint64_t)stats.bytesPushed * stats.fps) / 1024);
+      (uint32_t)(((uint64_t)stats.bytesPushed * stats.actualFps) / 1024);
   snprintf(buf, sizeof(buf), "%u KB/s", bandwidthKBps);
   drawTarget->setTextColor(COLOR_TEXT, COLOR_BACKGROUND);
   SafeDraw::drawString(ctx, buf, cursorX + 100, cursorY);
   cursorY += LINE_HEIGHT;
 
-  // PSRAM usage
+  // Tear risk: pushes the panel scan crossed (frame / frames so far)
+  drawTarget->setTextColor(COLOR_LABEL, COLOR_BACKGROUND);
+  SafeDraw::drawString(ctx, "Tear risk:", cursorX, cursorY);
+  if (stats.tearSyncMode == TearSync::Mode::OFF) {
+    snprintf(buf, sizeof(buf), "off");
+  } else {
+    snprintf(buf, sizeof(buf), "%u/%u %uus", stats.tearRiskRects,
+             stats.tearRiskFrames, stats.tearWaitUs);
+  }
+  drawTarget->setTextColor(stats.tearRiskRects > 0 ? TFT_YELLOW : COLOR_TEXT,
+                           COLOR_BACKGROUND);
+  SafeDraw::drawString(ctx, buf, cursorX + 100, cursorY);
+  cursorY += LINE_HEIGHT;
+
+  // PSRAM usage against the sprite budget
   drawTarget->setTextColor(COLOR_LABEL, COLOR_BACKGROUND);
   SafeDraw::drawString(ctx, "PSRAM:", cursorX, cursorY);
   uint32_t psramKB = stats.psramUsedBytes / 1024;
-  snprintf(buf, sizeof(buf), "%u KB", psramKB);
+  snprintf(buf, sizeof(buf), "%u/%u KB", psramKB,
+           stats.psramBudgetBytes / 1024);
   drawTarget->setTextColor(COLOR_TEXT, COLOR_BACKGROUND);
   SafeDraw::drawString(ctx, buf, cursorX + 100, cursorY);
   cursorY += LINE_HEIGHT;
@@ -157,7 +181,8 @@ static void drawTelemetry(const HudCompositor::RenderStats &stats,
   if (stats.shadowEnabled) {
     drawTarget->setTextColor(COLOR_LABEL, COLOR_BACKGROUND);
     SafeDraw::drawString(ctx, "Shadow blocks:", cursorX, cursorY);
-    snprintf(buf, sizeof(buf), "%u", stats.shadowBlocksCompared);
+    snprintf(buf, sizeof(buf), "%u %uus", stats.shadowBlocksCompared,
+             stats.shadowCompareUs);
     drawTarget->setTextColor(COLOR_TEXT, COLOR_BACKGROUND);
     SafeDraw::drawString(ctx, buf, cursorX + 100, cursorY);
     cursorY += LINE_HEIGHT;
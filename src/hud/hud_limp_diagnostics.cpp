@@ -39,10 +39,24 @@ static bool initialized = false;
 static LimpMode::LimpState lastState = LimpMode::LimpState::NORMAL;
 static LimpMode::Diagnostics lastDiagnostics;
 
+// Latest LimpMode snapshot, copied only when its version changes
+static LimpMode::Diagnostics snapshot;
+static uint32_t snapshotVersion = 0;
+
 // ========================================
 // Helper Functions
 // ========================================
 
+/**
+ * @brief Latest diagnostics from LimpMode (single source of truth)
+ *
+ * Copies the published snapshot only when LimpMode bumped its version.
+ */
+static const LimpMode::Diagnostics &currentDiagnostics() {
+  LimpMode::readDiagnostics(snapshotVersion, snapshot);
+  return snapshot;
+}
+
 /**
  * @brief Compare two diagnostics structures for equality
  */
@@ -195,7 +209,7 @@ void draw() {
   if (!tft && !sprite) return;
 
   // Get current diagnostics from LimpMode (single source of truth)
-  LimpMode::Diagnostics currentDiag = LimpMode::getDiagnostics();
+  const LimpMode::Diagnostics &currentDiag = currentDiagnostics();
 
   // Use sprite if available, otherwise fall back to TFT
   // 🚨 CRITICAL FIX: Create safe RenderContext
@@ -234,7 +248,7 @@ void forceRedraw() {
   if (!tft && !sprite) return;
 
   // Get current diagnostics
-  LimpMode::Diagnostics currentDiag = LimpMode::getDiagnostics();
+  const LimpMode::Diagnostics &currentDiag = currentDiagnostics();
 
   // Use sprite if available, otherwise fall back to TFT
   // 🚨 CRITICAL FIX: Create safe RenderContext
@@ -297,7 +311,7 @@ public:
     sprite = ctx.sprite;
 
     // Get current diagnostics from LimpMode (single source of truth)
-    LimpMode::Diagnostics currentDiag = LimpMode::getDiagnostics();
+    const LimpMode::Diagnostics &currentDiag = currentDiagnostics();
 
     // Only show when NOT in NORMAL state
     if (currentDiag.state == LimpMode::LimpState::NORMAL) {
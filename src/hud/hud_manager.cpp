@@ -1,5 +1,6 @@
 #include "hud_manager.h"
-#include "gauges.h" // Speed and RPM gauges
+#include "frame_pacer.h" // Adaptive frame rate
+#include "gauges.h"      // Speed and RPM gauges
 #include "hud.h"
 #include "hud_compositor.h"         // Phase 5: Layered compositor
 #include "hud_graphics_telemetry.h" // Phase 9: Graphics telemetry
@@ -7,12 +8,15 @@
 #include "hud_limp_indicator.h"     // Phase 4.2: Limp indicator
 #include "icons.h"                  // Dashboard icons
 #include "logger.h"
-#include "menu_hidden.h" // Hidden menu
-#include "pedal.h"       // Para calibración del pedal
+#include "menu_hidden.h"      // Hidden menu
+#include "menu_led_control.h" // Vista previa animada
+#include "pedal.h"            // Para calibración del pedal
 #include "pins.h"
-#include "render_engine.h" // Sprite-based rendering engine
-#include "sensors.h"       // Para estado de sensores
-#include "settings.h"      // For DISPLAY_BRIGHTNESS_DEFAULT
+#include "rt_scheduler.h" // Carga del core 1 para el pacer
+#include "rtos_tasks.h"
+#include "sensors.h"  // Para estado de sensores
+#include "settings.h" // For DISPLAY_BRIGHTNESS_DEFAULT
+#include "spi_bus.h"  // Arbitraje pantalla/táctil
 #include "storage.h"
 #include "system.h"
 #include "wheels_display.h" // Wheel status display
@@ -27,6 +31,7 @@
 // ============================================================================
 #include <freertos/FreeRTOS.h>
 #include <freertos/queue.h>
+#include <freertos/semphr.h>
 
 // ============================================================================
 // PHASE 10: BASE HUD Layer Renderer
@@ -110,7 +115,6 @@ static CombinedDiagnosticsRenderer combinedDiagnosticsRenderer;
 // Variables estáticas
 MenuType HUDManager::currentMenu = MenuType::NONE;
 CarData HUDManager::carData = CarData{};
-uint32_t HUDManager::lastUpdateMs = 0;
 bool HUDManager::needsRedraw = true;
 uint8_t HUDManager::brightness = 200;
 bool HUDManager::hiddenMenuActive = false;
@@ -125,6 +129,10 @@ char HUDManager::errorMessage[RenderEvent::MAX_ERROR_MSG_LEN] = {0};
 // 🔒 v2.5.0: Flag de inicialización
 static bool initialized = false;
 
+// Ritmo de frames (frame_pacer.h): decide en cada tick del job HUD si toca
+// frame, en lugar del antiguo filtro fijo de 33 ms
+static FramePacer::Pacer framePacer;
+
 // ✅ ÚNICA instancia global de TFT_eSPI - compartida con HUD y otros módulos
 // 🔒 v2.17.4: CRITICAL BOOTLOOP FIX - Pointer-based lazy initialization
 // Global object constructor was causing "Stack canary watchpoint triggered
@@ -198,6 +206,11 @@ bool HUDManager::init() {
 
   yield(); // Allow queue creation to settle
 
+  // Árbitro del bus SPI: TouchInput lee el XPT2046 desde su propia tarea
+  if (!SpiBus::init()) {
+    Logger::error("HUD: SPI bus arbiter init failed - touch disabled");
+  }
+
   // 🔒 v2.8.1: Asegurar que backlight está habilitado (ya configurado en
   // main.cpp) La configuración de OUTPUT/HIGH se realiza únicamente en
   // main.cpp.
@@ -351,34 +364,9 @@ bool HUDManager::init() {
   yield();
   Serial.println("[HUD] Backlight PWM stabilized");
 
-  // Initialize RenderEngine with sprite support
-  Serial.println("[HUD] Initializing RenderEngine...");
-  RenderEngine::init(tft);
-
-  // Create full-screen sprites (480x320) for car body and steering
-  if (!RenderEngine::createSprite(RenderEngine::CAR_BODY, 480, 320)) {
-    Logger::error("HUD: Failed to create CAR_BODY sprite");
-  }
-  if (!RenderEngine::createSprite(RenderEngine::STEERING, 480, 320)) {
-    Logger::error("HUD: Failed to create STEERING sprite");
-  }
-
-#ifdef RENDER_SHADOW_MODE
-  // Create shadow sprite for validation (PHASE 2)
-  // This sprite receives the same drawing commands as STEERING for comparison
-  // It is NEVER rendered to the display
-  if (!RenderEngine::createSprite(RenderEngine::STEERING_SHADOW, 480, 320)) {
-    Logger::error(
-        "HUD: Failed to create STEERING_SHADOW sprite (validation only)");
-  } else {
-    Logger::info("HUD: Shadow rendering enabled - validation mode active");
-  }
-#endif
-
-  Serial.println("[HUD] RenderEngine initialized");
-
   // ✅ PHASE 5: Initialize HUD Compositor
-  // The compositor manages layered rendering for all HUD elements
+  // The compositor manages layered rendering for all HUD elements (the
+  // only sprite engine: it also reserves the sprite budget)
   Serial.println("[HUD] Initializing HudCompositor...");
   if (!HudCompositor::init(tft)) {
     Logger::error("HUD: Failed to initialize HudCompositor");
@@ -423,7 +411,10 @@ bool HUDManager::init() {
   // Inicializar HUD básico (will show color test and initialize components)
   // Display is now ready with rotation=3 (480x320 landscape, ST7796S)
   Serial.println("[HUD] Initializing HUD components...");
+  // HUD::init() arranca TouchInput: retener el bus hasta terminar de dibujar
+  bool busLocked = lockDisplayBus(portMAX_DELAY);
   HUD::init();
+  if (busLocked) unlockDisplayBus();
 
   // Inicializar datos
   memset(&carData, 0, sizeof(CarData));
@@ -446,19 +437,55 @@ void HUDManager::update() {
     return; // No bloquear el sistema si el display falló
   }
 
+  uint32_t now = millis();
+
+  // Gestos táctiles primero: su efecto se dibuja en este mismo frame, y
+  // un arrastre se sigue a ritmo de ráfaga
+  TouchInput::Event touchEvent;
+  while (TouchInput::poll(touchEvent)) {
+    handleTouch(touchEvent);
+    framePacer.requestBurst(now);
+  }
+
   // 🔒 THREAD SAFETY: Process render events FIRST
   // This ensures error screens are shown immediately
   processRenderEvents();
 
-  // 🔒 CORRECCIÓN: Control de frame rate con constante
-  // 🔒 v2.8.4: No saltar el primer frame para permitir el primer dibujo
-  static constexpr uint32_t FRAME_INTERVAL_MS = 33; // 30 FPS
-  uint32_t now = millis();
-  if (lastUpdateMs != 0 && (now - lastUpdateMs) < FRAME_INTERVAL_MS) {
-    return; // Saltar frame para mantener 30 FPS (excepto el primero)
+  // Qué pide frame: cambio de menú o error (needsRedraw) lo pide ya; el
+  // dashboard solo cuando sus entradas cambian. El resto de menús muestran
+  // datos en vivo sin detección de cambios y siguen a 30 FPS.
+  bool dashboard = !errorActive && (currentMenu == MenuType::NONE ||
+                                    currentMenu == MenuType::DASHBOARD);
+  if (needsRedraw) framePacer.requestFrame();
+  if (!dashboard || MenuHidden::isActive() || HUD::hasPendingChanges()) {
+    framePacer.notifyChange(now);
   }
-  lastUpdateMs = now;
+  if (MenuLEDControl::isVisible()) framePacer.requestBurst(now);
+
+  float coreLoad = RTScheduler::getCoreUtilization(
+      static_cast<uint8_t>(RTOSTasks::CORE_GENERAL));
+  if (!framePacer.shouldRender(now, coreLoad)) return;
+
+  // Sin árbitro (fallo de init) TouchInput no muestrea: dibujar igualmente.
+  // El compositor cede el bus entre capas y rects si el táctil espera.
+  bool busLocked = lockDisplayBus(portMAX_DELAY);
+  uint32_t startUs = micros();
+  renderFrame();
+  uint32_t renderUs = micros() - startUs;
+  if (busLocked) unlockDisplayBus();
+
+  // Solo el compositor sabe si el frame cambió píxeles (los menús dibujan
+  // directamente en la TFT): píxeles en frames seguidos = movimiento
+  bool changed = dashboard && HudCompositor::isInitialized() &&
+                 HudCompositor::getRenderStats().dirtyPixels > 0;
+  framePacer.frameDone(now, renderUs, changed);
+
+  FramePacer::Stats pacing = framePacer.stats(now);
+  HudCompositor::setPacingStats(pacing.targetFps, pacing.actualFps,
+                                pacing.skippedFrames);
+}
 
+void HUDManager::renderFrame() {
   // 🔒 v2.8.4: Diagnóstico visual - confirmar que el bucle de render se ejecuta
 #ifdef DEBUG_RENDER
   tft->drawPixel(0, 0, TFT_WHITE);
@@ -544,7 +571,9 @@ void HUDManager::forceRedraw() { needsRedraw = true; }
 
 void HUDManager::showLogo() {
   currentMenu = MenuType::NONE;
+  bool busLocked = lockDisplayBus(portMAX_DELAY);
   HUD::showLogo();
+  if (busLocked) unlockDisplayBus();
   // After logo, switch to dashboard and force redraw
   currentMenu = MenuType::DASHBOARD;
   needsRedraw = true; // Force screen clear before drawing dashboard
@@ -552,7 +581,9 @@ void HUDManager::showLogo() {
 
 void HUDManager::showReady() {
   currentMenu = MenuType::NONE;
+  bool busLocked = lockDisplayBus(portMAX_DELAY);
   HUD::showReady();
+  if (busLocked) unlockDisplayBus();
 }
 
 void HUDManager::showError(const char *message) {
@@ -581,18 +612,33 @@ void HUDManager::showError(const char *message) {
   }
 }
 
-void HUDManager::handleTouch([[maybe_unused]] int16_t x,
-                             [[maybe_unused]] int16_t y,
-                             [[maybe_unused]] bool pressed) {
+void HUDManager::handleTouch(const TouchInput::Event &event) {
   // 🔒 v2.11.5: FAULT TOLERANCE - Si display no inicializó, ignorar touch
   if (!initialized) {
     return; // No procesar touch si el display falló
   }
 
-  // 🔒 v2.10.3: Touch handling delegated to active menu/screen
-  // Each screen (Dashboard, MenuHidden, MenuLEDControl, etc.) handles its own
-  // touch This function serves as a placeholder for future global touch
-  // gestures (e.g., swipe to change screens, pinch to zoom, etc.)
+  // El menú oculto se dibuja sobre el dashboard y captura sus toques; el
+  // dashboard sigue recibiéndolos para el icono de batería (cancelar teclado)
+  if (MenuHidden::isActive()) { MenuHidden::handleTouch(event); }
+
+  switch (currentMenu) {
+  case MenuType::NONE:
+  case MenuType::DASHBOARD:
+    HUD::handleTouch(event);
+    break;
+  default:
+    // Menús de diagnóstico: sin controles táctiles
+    break;
+  }
+}
+
+bool HUDManager::lockDisplayBus(uint32_t timeoutMs) {
+  return SpiBus::acquire(SpiBus::Device::DISPLAY, timeoutMs);
+}
+
+void HUDManager::unlockDisplayBus() {
+  SpiBus::release(SpiBus::Device::DISPLAY);
 }
 
 void HUDManager::setBrightness(uint8_t newBrightness) {
@@ -664,6 +710,7 @@ bool HUDManager::isShadowModeEnabled() {
 void HUDManager::clearScreenIfNeeded() {
   if (needsRedraw) {
     tft->fillScreen(TFT_BLACK);
+    Gauges::invalidate(); // Las agujas/cifras ya no están en pantalla
     needsRedraw = false;
   }
 }
@@ -0,0 +1,182 @@
+// hud_widgets.cpp - Widget state, invalidation and hit-testing (pure)
+#include "hud_widgets.h"
+
+namespace HudWidgets {
+
+// ============================================================================
+// Widget
+// ============================================================================
+
+void Widget::setStyle(const Style &s) { update(style_, s); }
+
+void Widget::setFg(uint16_t c) { update(style_.fg, c); }
+
+void Widget::setAccent(uint16_t c) { update(style_.accent, c); }
+
+void Widget::setBorder(uint16_t c) { update(style_.border, c); }
+
+void Widget::setEnabled(bool enabled) { update(enabled_, enabled); }
+
+// ============================================================================
+// Label / ValueField / Button
+// ============================================================================
+
+bool Label::setText(const char *text) {
+  // Compare what would be stored, so over-long text is not dirty every call
+  StaticString<TEXT_CAPACITY> next(text);
+  if (next == text_.view()) return false;
+  text_ = next.view();
+  dirty_ = true;
+  return true;
+}
+
+void ValueField::format(char *out, size_t size) const {
+  snprintf(out, size, fmt_, static_cast<long>(value_));
+}
+
+bool Button::setLabel(const char *label) {
+  StaticString<TEXT_CAPACITY> next(label);
+  if (next == label_.view()) return false;
+  label_ = next.view();
+  dirty_ = true;
+  return true;
+}
+
+// ============================================================================
+// Slider
+// ============================================================================
+
+Slider::Slider(Rect rect, int32_t min, int32_t max, int32_t step)
+    : Widget(Kind::SLIDER, rect, true), min_(min), max_(max > min ? max : min),
+      step_(step > 0 ? step : 1), value_(min) {}
+
+bool Slider::setValue(int32_t v) {
+  if (v < min_) v = min_;
+  if (v > max_) v = max_;
+  return update(value_, v);
+}
+
+int32_t Slider::valueAt(int16_t x) const {
+  const Rect &r = rect();
+  if (max_ == min_ || r.w <= 0 || x <= r.x) return min_;
+  if (x >= r.x + r.w) return max_;
+  int32_t v = min_ + (static_cast<int64_t>(x - r.x) * (max_ - min_)) / r.w;
+  v = min_ + ((v - min_ + step_ / 2) / step_) * step_;
+  return v > max_ ? max_ : v;
+}
+
+bool Slider::touch(int16_t x, int16_t y) {
+  if (!hit(x, y)) return false;
+  return setValue(valueAt(x));
+}
+
+int16_t Slider::fillWidth() const {
+  if (max_ == min_) return 0;
+  return static_cast<int16_t>((static_cast<int64_t>(value_ - min_) *
+                               rect().w) /
+                              (max_ - min_));
+}
+
+// ============================================================================
+// List
+// ============================================================================
+
+List::List(Rect rect, int16_t rowHeight, const char *const *items,
+           uint8_t count)
+    : Widget(Kind::LIST, rect, true), rowHeight_(rowHeight > 0 ? rowHeight : 1),
+      items_(items), count_(count > LIST_MAX_ROWS ? LIST_MAX_ROWS : count) {}
+
+void List::invalidateRow(int8_t row) {
+  if (row >= 0 && row < count_) partMask_ |= 1UL << row;
+}
+
+bool List::setSelected(int8_t row) {
+  if (row >= count_) row = -1;
+  if (row == selected_) return false;
+  invalidateRow(selected_);
+  invalidateRow(row);
+  selected_ = row;
+  return true;
+}
+
+Rect List::rowRect(uint8_t row) const {
+  const Rect &r = rect();
+  return {r.x, static_cast<int16_t>(r.y + row * rowHeight_), r.w, rowHeight_};
+}
+
+int8_t List::rowAt(int16_t x, int16_t y) const {
+  if (!hit(x, y)) return -1;
+  int16_t row = (y - rect().y) / rowHeight_;
+  return row < count_ ? static_cast<int8_t>(row) : -1;
+}
+
+uint32_t List::dirtyPixels() const {
+  if (dirty_) return rect().area();
+  uint32_t rows = 0;
+  for (uint8_t i = 0; i < count_; i++) rows += (partMask_ >> i) & 1;
+  return rows * rowRect(0).area();
+}
+
+// ============================================================================
+// Frame
+// ============================================================================
+
+uint32_t Frame::dirtyPixels() const {
+  if (!dirty_) return 0;
+  const Rect &r = rect();
+  if (r.w <= 2 || r.h <= 2) return r.area();
+  return 2u * r.w + 2u * (r.h - 2);
+}
+
+// ============================================================================
+// Screen
+// ============================================================================
+
+bool Screen::add(Widget &w) {
+  if (count_ >= MAX_WIDGETS) return false;
+  widgets_[count_++] = &w;
+  w.invalidate();
+  return true;
+}
+
+void Screen::clear() {
+  count_ = 0;
+  clearPending_ = true;
+}
+
+Widget *Screen::hitTest(int16_t x, int16_t y) const {
+  for (uint8_t i = count_; i-- > 0;) {
+    if (widgets_[i]->hit(x, y)) return widgets_[i];
+  }
+  return nullptr;
+}
+
+void Screen::invalidateAll() {
+  clearPending_ = true;
+  for (uint8_t i = 0; i < count_; i++) widgets_[i]->invalidate();
+}
+
+bool Screen::isDirty() const {
+  if (clearPending_) return true;
+  for (uint8_t i = 0; i < count_; i++) {
+    if (widgets_[i]->isDirty()) return true;
+  }
+  return false;
+}
+
+uint32_t Screen::dirtyPixels(int16_t width, int16_t height) const {
+  uint32_t px = clearPending_ ? Rect{0, 0, width, height}.area() : 0;
+  for (uint8_t i = 0; i < count_; i++) px += widgets_[i]->dirtyPixels();
+  return px;
+}
+
+void Screen::record(uint32_t pixels, uint32_t widgets) {
+  if (pixels == 0) return;
+  stats_.renders++;
+  stats_.widgetsDrawn += widgets;
+  stats_.pixelsPushed += pixels;
+  stats_.lastPixels = pixels;
+  if (pixels > stats_.maxPixels) stats_.maxPixels = pixels;
+}
+
+} // namespace HudWidgets
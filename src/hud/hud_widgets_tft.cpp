@@ -0,0 +1,201 @@
+// hud_widgets_tft.cpp - Widget drawing with TFT_eSPI
+#include "hud_layer.h"
+#include "hud_widgets.h"
+#include "logger.h"
+#include <TFT_eSPI.h>
+
+namespace HudWidgets {
+
+static uint8_t datumFor(Align align) {
+  switch (align) {
+  case Align::CENTER:
+    return MC_DATUM;
+  case Align::RIGHT:
+    return MR_DATUM;
+  default:
+    return ML_DATUM;
+  }
+}
+
+// Text anchored inside (x, y, w, h) according to the style
+static void drawText(TFT_eSPI &g, const Style &s, const char *text, int16_t x,
+                     int16_t y, int16_t w, int16_t h, uint16_t fg,
+                     uint16_t bg) {
+  int16_t tx = x + s.padding;
+  if (s.align == Align::CENTER) tx = x + w / 2;
+  if (s.align == Align::RIGHT) tx = x + w - s.padding;
+  g.setTextDatum(datumFor(s.align));
+  g.setTextColor(fg, bg);
+  g.drawString(text, tx, y + h / 2, s.font);
+}
+
+static void fillFace(TFT_eSPI &g, const Style &s, int16_t x, int16_t y,
+                     int16_t w, int16_t h, uint16_t color) {
+  if (s.radius > 0) {
+    g.fillRoundRect(x, y, w, h, s.radius, color);
+  } else {
+    g.fillRect(x, y, w, h, color);
+  }
+}
+
+static void outline(TFT_eSPI &g, const Style &s, int16_t x, int16_t y,
+                    int16_t w, int16_t h) {
+  if (!s.outlined) return;
+  if (s.radius > 0) {
+    g.drawRoundRect(x, y, w, h, s.radius, s.border);
+  } else {
+    g.drawRect(x, y, w, h, s.border);
+  }
+}
+
+// Redraws one row of a list; rows are opaque so no clear is needed first
+static void drawListRow(TFT_eSPI &g, const List &list, uint8_t row, int16_t x,
+                        int16_t y) {
+  const Style &s = list.style();
+  const Rect r = list.rowRect(row);
+  g.fillRect(x, y, r.w, r.h, s.bg);
+  uint16_t fg = (row == list.selected()) ? s.accent : s.fg;
+  if (!list.isEnabled()) fg = s.border;
+  drawText(g, s, list.item(row), x, y, r.w, r.h, fg, s.bg);
+}
+
+static void drawWidget(TFT_eSPI &g, Widget &w, int16_t x, int16_t y) {
+  const Style &s = w.style();
+  const Rect &r = w.rect();
+
+  switch (w.kind()) {
+  case Kind::LABEL:
+    g.fillRect(x, y, r.w, r.h, s.bg);
+    drawText(g, s, static_cast<Label &>(w).text(), x, y, r.w, r.h, s.fg,
+             s.bg);
+    break;
+
+  case Kind::VALUE: {
+    char buf[24];
+    static_cast<ValueField &>(w).format(buf, sizeof(buf));
+    g.fillRect(x, y, r.w, r.h, s.bg);
+    drawText(g, s, buf, x, y, r.w, r.h, s.fg, s.bg);
+    break;
+  }
+
+  case Kind::SLIDER: {
+    const Slider &sl = static_cast<Slider &>(w);
+    g.fillRect(x, y, r.w, r.h, s.bg);
+    fillFace(g, s, x, y, r.w, r.h, sl.track());
+    int16_t fill = sl.fillWidth();
+    if (fill > 0) fillFace(g, s, x, y, fill, r.h, s.accent);
+    outline(g, s, x, y, r.w, r.h);
+    break;
+  }
+
+  case Kind::TOGGLE: {
+    const Toggle &t = static_cast<Toggle &>(w);
+    uint16_t face = t.faceColor();
+    g.fillRect(x, y, r.w, r.h, s.bg);
+    fillFace(g, s, x, y, r.w, r.h, face);
+    outline(g, s, x, y, r.w, r.h);
+    Style centered = s;
+    centered.align = Align::CENTER;
+    drawText(g, centered, t.text(), x, y, r.w, r.h, t.isOn() ? s.bg : s.fg,
+             face);
+    break;
+  }
+
+  case Kind::BUTTON: {
+    g.fillRect(x, y, r.w, r.h, s.bg);
+    fillFace(g, s, x, y, r.w, r.h, s.accent);
+    outline(g, s, x, y, r.w, r.h);
+    Style centered = s;
+    centered.align = Align::CENTER;
+    drawText(g, centered, static_cast<Button &>(w).label(), x, y, r.w, r.h,
+             s.fg, s.accent);
+    break;
+  }
+
+  case Kind::INDICATOR: {
+    int16_t radius = (r.w < r.h ? r.w : r.h) / 2 - 1;
+    g.fillRect(x, y, r.w, r.h, s.bg);
+    g.fillCircle(x + r.w / 2, y + r.h / 2, radius, s.accent);
+    if (s.outlined) g.drawCircle(x + r.w / 2, y + r.h / 2, radius, s.border);
+    break;
+  }
+
+  case Kind::FRAME:
+    if (r.h == 1) {
+      g.drawFastHLine(x, y, r.w, s.border);
+    } else {
+      g.drawRect(x, y, r.w, r.h, s.border);
+    }
+    break;
+
+  case Kind::CUSTOM: {
+    Custom &c = static_cast<Custom &>(w);
+    if (c.drawFn()) c.drawFn()(g, c, x, y);
+    break;
+  }
+
+  case Kind::LIST:
+    break; // Row by row in render()
+  }
+}
+
+uint32_t render(Screen &screen, TFT_eSPI *display,
+                HudLayer::RenderContext &ctx) {
+  TFT_eSPI *target = ctx.sprite ? ctx.sprite : display;
+  if (target == nullptr || !screen.isDirty()) return 0;
+  TFT_eSPI &g = *target;
+
+  uint32_t pixels = 0;
+  uint32_t drawn = 0;
+
+  if (screen.needsClear()) {
+    g.fillRect(0, 0, ctx.width, ctx.height, screen.background());
+    ctx.markDirty(ctx.originX, ctx.originY, ctx.width, ctx.height);
+    pixels += Rect{0, 0, ctx.width, ctx.height}.area();
+    screen.markCleared();
+  }
+
+  for (uint8_t i = 0; i < screen.count(); i++) {
+    Widget &w = screen.at(i);
+    if (!w.isDirty()) continue;
+    const Rect &r = w.rect();
+    pixels += w.dirtyPixels();
+
+    if (w.kind() == Kind::LIST) {
+      List &list = static_cast<List &>(w);
+      for (uint8_t row = 0; row < list.count(); row++) {
+        if (!list.isRowDirty(row)) continue;
+        Rect rr = list.rowRect(row);
+        drawListRow(g, list, row, ctx.toLocalX(rr.x), ctx.toLocalY(rr.y));
+        ctx.markDirty(rr.x, rr.y, rr.w, rr.h);
+        drawn++;
+      }
+    } else {
+      drawWidget(g, w, ctx.toLocalX(r.x), ctx.toLocalY(r.y));
+      ctx.markDirty(r.x, r.y, r.w, r.h);
+      drawn++;
+    }
+    w.clean();
+  }
+
+  screen.record(pixels, drawn);
+  return pixels;
+}
+
+uint32_t render(Screen &screen, TFT_eSPI *display) {
+  if (display == nullptr) return 0;
+  HudLayer::RenderContext ctx(nullptr, false, 0, 0, display->width(),
+                              display->height());
+  return render(screen, display, ctx);
+}
+
+void logStats(const char *name, const Screen &screen) {
+  const Screen::Stats &s = screen.stats();
+  if (s.renders == 0) return;
+  Logger::infof("Widgets %s: %lu renders, %lu px (avg %lu, max %lu, last %lu)",
+                name, (unsigned long)s.renders, (unsigned long)s.pixelsPushed,
+                (unsigned long)(s.pixelsPushed / s.renders),
+                (unsigned long)s.maxPixels, (unsigned long)s.lastPixels);
+}
+
+} // namespace HudWidgets
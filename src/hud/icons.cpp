@@ -42,6 +42,9 @@ static bool lastTempWarning = false;
 static float lastMaxTemp = -999.0f;
 static bool sensorsCacheInitialized = false;
 
+// Cache para temperatura ambiente
+static float lastAmbientTemp = -999.0f;
+
 void Icons::init(TFT_eSPI *display) {
   tft = display;
   initialized = true;
@@ -58,6 +61,19 @@ void Icons::init(TFT_eSPI *display) {
   SafeDraw::init(tft);
 }
 
+void Icons::invalidate() {
+  lastSysState = (System::State)CACHE_UNINITIALIZED;
+  lastGear = (Shifter::Gear)CACHE_UNINITIALIZED;
+  lastMode4x4 = CACHE_UNINITIALIZED;
+  lastRegen = CACHE_UNINITIALIZED;
+  lastBattery = -999.0f;
+  lastErrorCount = CACHE_UNINITIALIZED;
+  lastTempWarning = false;
+  lastMaxTemp = -999.0f;
+  sensorsCacheInitialized = false;
+  lastAmbientTemp = -999.0f;
+}
+
 // 🚨 CRITICAL FIX: Helper to convert sprite to RenderContext
 // This allows gradual migration while maintaining safety
 static inline HudLayer::RenderContext createContext(TFT_eSprite *sprite) {
@@ -700,9 +716,6 @@ void Icons::drawTempWarning(bool tempWarning, float maxTemp,
   }
 }
 
-// Cache para temperatura ambiente
-static float lastAmbientTemp = -999.0f;
-
 void Icons::drawAmbientTemp(float ambientTemp, TFT_eSprite *sprite) {
   // Phase 6.2: Support dual-mode rendering (sprite or TFT)
   // 🚨 CRITICAL FIX: Create safe RenderContext
@@ -820,12 +833,9 @@ void Icons::drawFeatures(bool mode4x4, bool regenOn,
 
   // Mark dirty if changed
   if (changed) {
-    // Mode4x4 icon area
+    // Mode4x4 icon area (v2.14.0: no regen icon next to it any more)
     ctx.markDirty(MODE4X4_X1, MODE4X4_Y1, MODE4X4_X2 - MODE4X4_X1,
                   MODE4X4_Y2 - MODE4X4_Y1);
-    // Regen icon is next to it - mark wider area
-    ctx.markDirty(MODE4X4_X1, MODE4X4_Y1, 240 - MODE4X4_X1,
-                  MODE4X4_Y2 - MODE4X4_Y1);
   }
 }
 
@@ -5,8 +5,7 @@
 
 #include "led_control_menu.h"
 #include "alerts.h"
-#include "config_storage.h"
-#include "eeprom_persistence.h"
+#include "config_store.h"
 #include "led_controller.h"
 #include "logger.h"
 #include <TFT_eSPI.h>
@@ -61,12 +60,12 @@ LEDControlMenu::LEDControlMenu()
       isDraggingColor(false) {}
 
 void LEDControlMenu::init() {
-  // Load saved settings from ConfigStorage
-  auto &config = ConfigStorage::getCurrentConfig();
-  currentPattern = config.led_pattern;
-  brightness = config.led_brightness;
-  speed = config.led_speed;
-  customColor = config.led_color;
+  // Load saved settings from ConfigStore
+  auto &config = ConfigStore::leds();
+  currentPattern = config.pattern;
+  brightness = config.brightness;
+  speed = config.speed;
+  customColor = config.color;
 
   // Apply settings to LED controller
   applySettings();
@@ -320,13 +319,13 @@ void LEDControlMenu::applySettings() {
 }
 
 void LEDControlMenu::saveSettings() {
-  auto &config = ConfigStorage::getCurrentConfig();
-  config.led_pattern = currentPattern;
-  config.led_brightness = brightness;
-  config.led_speed = speed;
-  config.led_color = customColor;
+  auto &config = ConfigStore::leds();
+  config.pattern = currentPattern;
+  config.brightness = brightness;
+  config.speed = speed;
+  config.color = customColor;
 
-  ConfigStorage::save(config);
+  ConfigStore::commit(ConfigStore::SECTION_LEDS);
   Alerts::play({Audio::AUDIO_MODULO_OK, Audio::Priority::PRIO_HIGH});
   Logger::info("LED settings saved");
 }
@@ -5,7 +5,7 @@
 
 #include "menu_encoder_calibration.h"
 #include "alerts.h"
-#include "config_storage.h"
+#include "config_store.h"
 #include "logger.h"
 #include "steering.h"
 
@@ -446,10 +446,10 @@ const char *MenuEncoderCalibration::getStepInstruction() {
 }
 
 void MenuEncoderCalibration::loadCurrentCalibration() {
-  auto &config = ConfigStorage::getCurrentConfig();
-  tempCenter = config.encoder_center;
-  tempLeftLimit = config.encoder_left_limit;
-  tempRightLimit = config.encoder_right_limit;
+  const auto &config = ConfigStore::encoder();
+  tempCenter = config.center;
+  tempLeftLimit = config.leftLimit;
+  tempRightLimit = config.rightLimit;
   liveEncoderValue = tempCenter;
   Logger::info("Loaded encoder calibration from storage");
 }
@@ -481,31 +481,16 @@ void MenuEncoderCalibration::saveCalibration() {
     return;
   }
 
-  auto &config = ConfigStorage::getCurrentConfig();
-  config.encoder_center = static_cast<int16_t>(tempCenter);
-  config.encoder_left_limit = static_cast<int16_t>(tempLeftLimit);
-  config.encoder_right_limit = static_cast<int16_t>(tempRightLimit);
+  auto &config = ConfigStore::encoder();
+  config.center = static_cast<int16_t>(tempCenter);
+  config.leftLimit = static_cast<int16_t>(tempLeftLimit);
+  config.rightLimit = static_cast<int16_t>(tempRightLimit);
+  config.calibrated = true;
 
-  // Save to EEPROM with error handling
-  bool saveSuccess = ConfigStorage::save(config);
-
-  if (!saveSuccess) {
-    Logger::error("Failed to save encoder calibration to EEPROM");
-    Alerts::play(Audio::AUDIO_ERROR_GENERAL);
-    return;
-  }
-
-  // Verify the save by reading back from EEPROM
-  ConfigStorage::Config verifyConfig;
-  if (!ConfigStorage::load(verifyConfig)) {
-    Logger::error("EEPROM verification failed - could not read back values");
-    Alerts::play(Audio::AUDIO_ERROR_GENERAL);
-    return;
-  }
-  if (verifyConfig.encoder_center != tempCenter ||
-      verifyConfig.encoder_left_limit != tempLeftLimit ||
-      verifyConfig.encoder_right_limit != tempRightLimit) {
-    Logger::error("EEPROM verification failed - saved values don't match");
+  // Save with error handling. NVS CRCs every entry and commit() fails if
+  // any key write or nvs_commit fails, so no read-back pass is needed.
+  if (!ConfigStore::commit(ConfigStore::SECTION_ENCODER)) {
+    Logger::error("Failed to save encoder calibration to NVS");
     Alerts::play(Audio::AUDIO_ERROR_GENERAL);
     return;
   }
@@ -513,14 +498,15 @@ void MenuEncoderCalibration::saveCalibration() {
   // Apply to steering module
   Steering::setZeroOffset(tempCenter);
 
-  Logger::infof("Encoder calibration saved and verified: C=%ld, L=%ld, R=%ld",
+  Logger::infof("Encoder calibration saved: C=%ld, L=%ld, R=%ld",
                 tempCenter, tempLeftLimit, tempRightLimit);
 }
 
 void MenuEncoderCalibration::resetCalibration() {
-  tempCenter = ConfigStorage::DEFAULT_CONFIG.encoder_center;
-  tempLeftLimit = ConfigStorage::DEFAULT_CONFIG.encoder_left_limit;
-  tempRightLimit = ConfigStorage::DEFAULT_CONFIG.encoder_right_limit;
+  const auto &defaults = ConfigStore::defaults().encoder;
+  tempCenter = defaults.center;
+  tempLeftLimit = defaults.leftLimit;
+  tempRightLimit = defaults.rightLimit;
   currentStep = STEP_CENTER;
   Logger::info("Encoder calibration reset to defaults");
 }
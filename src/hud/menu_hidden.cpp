@@ -2,8 +2,11 @@
 #include "alerts.h"
 #include "buttons.h"
 #include "error_codes.h" // 🆕 v2.9.5: Descripciones de códigos de error
+#include "hud_widgets.h"
 #include "logger.h"
+#include "pc_sampler.h"
 #include "pedal.h"
+#include "runtime_profiler.h"
 #include "settings.h"
 #include "steering.h"
 #include "storage.h"
@@ -13,6 +16,7 @@
 // Ahora usamos el touch integrado de TFT_eSPI
 #include "pins.h"
 #include "touch_calibration.h" // 🔒 v2.9.0: Touch calibration routine
+#include "touch_input.h"       // Gestos táctiles (tap)
 #include "touch_map.h" // 🔒 v2.8.3: Constantes centralizadas de calibración táctil
 
 static TFT_eSPI *tft = nullptr;
@@ -53,12 +57,7 @@ static bool regenAdjustFirstCall =
 static bool calibrationFirstCall =
     true; // 🔒 v2.10.0: Track first draw for pedal/encoder calibration
 
-static int selectedOption = 1; // opción seleccionada (1..8)
-
-// Cache para evitar redibujos innecesarios
-static int lastSelectedOption = -1;
-static uint16_t lastCodeBuffer = 0;
-static bool lastMenuActive = false;
+static int selectedOption = 1; // opción seleccionada (1..10)
 
 // Estado de calibración interactiva
 enum class CalibrationState {
@@ -71,7 +70,9 @@ enum class CalibrationState {
   TOUCH_CALIBRATION,   // 🔒 v2.9.0: Touch screen calibration
   REGEN_ADJUST,        // ✅ v2.7.0: Ajuste interactivo de regen
   MODULES_CONFIG,      // Configuración de módulos ON/OFF
-  CLEAR_ERRORS_CONFIRM // ✅ v2.7.0: Confirmación borrado errores
+  CLEAR_ERRORS_CONFIRM, // ✅ v2.7.0: Confirmación borrado errores
+  PROFILER_VIEW,        // Perfil CPU/pila/heap en vivo
+  ERRORS_VIEW           // Lista de errores persistentes (toque o 5 s)
 };
 static CalibrationState calibState = CalibrationState::NONE;
 static int pedalCalibMin = 0;
@@ -82,36 +83,42 @@ static int regenAdjustValue = 0; // ✅ v2.7.0: Valor temporal para ajuste regen
 
 // Constantes de debounce y timing (touch calibration centralizada en
 // touch_map.h)
-static const uint32_t DEBOUNCE_TIMEOUT_MS = 500; // Timeout para debounce
-static const uint32_t DEBOUNCE_SHORT_MS =
-    200; // ✅ v2.7.0: Debounce corto para ajustes rápidos
+static const uint32_t ERRORS_VIEW_MS = 5000; // Lista de errores visible
 static const uint32_t FEEDBACK_DISPLAY_MS =
     1500; // ✅ v2.7.0: Tiempo de visualización de feedback
 
-// Zonas táctiles del menú (9 opciones)
+// Zonas táctiles del menú (10 opciones)
 static const int MENU_X1 = 60;
 static const int MENU_Y1 = 80;
 static const int MENU_WIDTH = 360;
 static const int MENU_ITEM_HEIGHT = 20;
-static const int NUM_MENU_ITEMS = 9;
+static const int NUM_MENU_ITEMS = 10;
 
 // Opciones del menú (evitar duplicación - DRY)
 static const char *const MENU_ITEMS[NUM_MENU_ITEMS] = {
     "1) Calibrar pedal",    "2) Calibrar encoder",
     "3) Calibrar touch", // 🔒 v2.9.0: Nueva opción
     "4) Ajuste regen (%)",  "5) Modulos/Sensores", "6) Guardar y salir",
-    "7) Restaurar fabrica", "8) Ver errores",      "9) Borrar errores"};
-
-// 🔒 v2.8.8: Helper para debounce con timeout (usando touch integrado TFT_eSPI)
-static void waitTouchRelease(uint32_t maxWaitMs = DEBOUNCE_TIMEOUT_MS) {
-  if (tft == nullptr) return;
-  uint32_t startMs = millis();
-  uint16_t tx, ty;
-  while (tft->getTouch(&tx, &ty) && (millis() - startMs < maxWaitMs)) {
-    yield();
-  }
+    "7) Restaurar fabrica", "8) Ver errores",      "9) Borrar errores",
+    "10) Perfil CPU/memoria"};
+
+// Último TAP entregado por HUDManager (MenuHidden::handleTouch). TouchInput
+// emite el TAP al soltar, así que ya no hay que esperar la liberación: basta
+// con descartar lo acumulado mientras se ejecutaba una acción
+static bool tapPending = false;
+static int tapX = 0, tapY = 0;
+static uint32_t errorsViewStartMs = 0;
+
+static bool takeTap(int &x, int &y) {
+  if (!tapPending) return false;
+  tapPending = false;
+  x = tapX;
+  y = tapY;
+  return true;
 }
 
+static void discardTouch() { tapPending = false; }
+
 // -----------------------
 // Funciones auxiliares de calibración real
 // -----------------------
@@ -455,8 +462,7 @@ static void updateRegenAdjust(int touchX, int touchY, bool touched) {
   }
 
   if (needsRedraw) {
-    waitTouchRelease(
-        DEBOUNCE_SHORT_MS); // Debounce corto para permitir ajuste rápido
+    discardTouch();
     drawRegenAdjustScreen();
   }
 
@@ -679,7 +685,6 @@ static void saveAndExit() {
 
   menuActive = false;
   codeBuffer = 0;
-  lastMenuActive = false;
 }
 
 static void restoreFactory() {
@@ -756,16 +761,10 @@ static void showErrors() {
 
   Logger::infof("Mostrando %d errores persistentes", count);
 
-  // 🔒 v2.8.8: Esperar toque para volver usando touch integrado TFT_eSPI
-  uint32_t waitStart = millis();
-  uint16_t tx, ty;
-  while (millis() - waitStart < 5000) {
-    if (tft != nullptr && tft->getTouch(&tx, &ty)) {
-      waitTouchRelease(); // Debounce antes de salir
-      break;
-    }
-    yield();
-  }
+  // Sin bloquear el frame: update() vuelve al menú con un toque o a los 5 s
+  discardTouch();
+  errorsViewStartMs = millis();
+  calibState = CalibrationState::ERRORS_VIEW;
 }
 
 // ✅ v2.7.0: Iniciar confirmación para borrar errores
@@ -838,7 +837,7 @@ static void updateClearErrorsConfirm(int touchX, int touchY, bool touched) {
   if (touchX >= 80 && touchX <= 200 && touchY >= 180 && touchY <= 230) {
     Logger::info("Borrado de errores cancelado");
     Alerts::play({Audio::AUDIO_MODULO_OK, Audio::Priority::PRIO_NORMAL});
-    waitTouchRelease();
+    discardTouch();
     calibState = CalibrationState::NONE;
     return;
   }
@@ -872,149 +871,332 @@ static void updateClearErrorsConfirm(int touchX, int touchY, bool touched) {
   }
 }
 
+// -----------------------
+// Perfil CPU / pila / heap (RuntimeProfiler)
+// -----------------------
+static const int PROFILER_MAX_TASK_ROWS = 7;
+static uint32_t profilerDrawnSampleMs = 0; // Última muestra dibujada
+
+static void startProfilerView() {
+  calibState = CalibrationState::PROFILER_VIEW;
+  profilerDrawnSampleMs = UINT32_MAX; // Forzar primer dibujo
+  Alerts::play({Audio::AUDIO_MODULO_OK, Audio::Priority::PRIO_NORMAL});
+  Logger::info("Perfil CPU/memoria abierto");
+}
+
+// Botones: SERIE (stream [PROF]), PC (muestreo PC) y SALIR
+static void drawProfilerButton(int x, const char *label, uint16_t bg) {
+  tft->fillRect(x, 230, 100, 40, bg);
+  tft->drawRect(x, 230, 100, 40, TFT_WHITE);
+  tft->setTextColor(TFT_WHITE, bg);
+  tft->drawString(label, x + 50, 250, 2);
+}
+
+static void drawProfilerButtons() {
+  tft->setTextDatum(MC_DATUM);
+  bool stream = RuntimeProfiler::isSerialStream();
+  drawProfilerButton(70, stream ? "SERIE: ON" : "SERIE: OFF",
+                     stream ? TFT_DARKGREEN : TFT_DARKGREY);
+
+  char pcLabel[16];
+  bool sampling = PcSampler::isRunning();
+  if (sampling) {
+    snprintf(pcLabel, sizeof(pcLabel), "PC: %ukHz",
+             PcSampler::getRateHz() / 1000);
+  } else {
+    snprintf(pcLabel, sizeof(pcLabel), "PC: OFF");
+  }
+  drawProfilerButton(190, pcLabel, sampling ? TFT_DARKGREEN : TFT_DARKGREY);
+
+  drawProfilerButton(310, "SALIR", TFT_DARKGREY);
+}
+
+// PC sampler: OFF -> 1 kHz -> 2 kHz -> 5 kHz -> OFF
+static void cyclePcSampler() {
+  if (!PcSampler::isRunning()) {
+    PcSampler::start(1000);
+    return;
+  }
+  uint16_t rate = PcSampler::getRateHz();
+  PcSampler::stop();
+  if (rate < 2000) {
+    PcSampler::start(2000);
+  } else if (rate < 5000) {
+    PcSampler::start(5000);
+  }
+}
+
+static void drawProfilerScreen(const RuntimeProfiler::Snapshot &snap,
+                               bool valid) {
+  using namespace RuntimeProfiler;
+  const Config &pcfg = getConfig();
+
+  tft->fillRect(60, 40, 360, 240, TFT_BLACK);
+  tft->drawRect(60, 40, 360, 240, TFT_CYAN);
+  tft->setTextDatum(TC_DATUM);
+  tft->setTextColor(TFT_CYAN, TFT_BLACK);
+  tft->drawString("PERFIL CPU / MEMORIA", 240, 46, 2);
+
+  if (!valid) {
+    tft->setTextDatum(MC_DATUM);
+    tft->setTextColor(TFT_WHITE, TFT_BLACK);
+    tft->drawString("Esperando primera muestra...", 240, 140, 2);
+    drawProfilerButtons();
+    return;
+  }
+
+  char line[64];
+  tft->setTextDatum(TL_DATUM);
+
+  tft->setTextColor((snap.alarms & ALARM_CPU) ? TFT_RED : TFT_GREEN,
+                    TFT_BLACK);
+  snprintf(line, sizeof(line), "CPU0 %3u%%   CPU1 %3u%%   %u tareas",
+           snap.cpuPct[0], snap.cpuPct[1], snap.taskCount);
+  tft->drawString(line, 70, 66, 2);
+
+  bool heapAlarm = snap.alarms & (ALARM_HEAP | ALARM_FRAGMENTATION);
+  tft->setTextColor(heapAlarm ? TFT_RED : TFT_WHITE, TFT_BLACK);
+  snprintf(line, sizeof(line), "Heap %u KB  min %u  bloque %u", snap.heapFreeKb,
+           snap.heapMinKb, snap.heapLargestKb);
+  tft->drawString(line, 70, 84, 2);
+
+  tft->setTextColor((snap.alarms & ALARM_PSRAM) ? TFT_RED : TFT_WHITE,
+                    TFT_BLACK);
+  snprintf(line, sizeof(line), "PSRAM %u KB  min %u  bloque %u",
+           snap.psramFreeKb, snap.psramMinKb, snap.psramLargestKb);
+  tft->drawString(line, 70, 102, 2);
+
+  // Tabla de tareas (ordenada por CPU); pila libre en rojo bajo el umbral
+  tft->setTextColor(TFT_YELLOW, TFT_BLACK);
+  tft->drawString("Tarea            Core  CPU%   Pila libre", 70, 124, 1);
+  int y = 136;
+  TaskSample t;
+  for (uint8_t i = 0; i < PROFILER_MAX_TASK_ROWS && getTask(i, t); i++) {
+    char core = t.core == NO_CORE ? '*' : (char)('0' + t.core);
+    snprintf(line, sizeof(line), "%-16s  %c  %3u.%u  %6lu B", t.name, core,
+             t.cpuPermille / 10, t.cpuPermille % 10,
+             (unsigned long)t.stackFreeBytes);
+    bool lowStack = t.stackFreeBytes < pcfg.stackAlarmBytes;
+    tft->setTextColor(lowStack ? TFT_RED : TFT_WHITE, TFT_BLACK);
+    tft->drawString(line, 70, y, 1);
+    y += 12;
+  }
+  if (!hasRunTimeStats()) {
+    tft->setTextColor(TFT_ORANGE, TFT_BLACK);
+    tft->drawString("Sin run-time stats: CPU por executive", 70, y + 2, 1);
+  }
+
+  drawProfilerButtons();
+}
+
+static void updateProfilerView(int touchX, int touchY, bool touched) {
+  if (touched) {
+    bool buttonRow = touchY >= 230 && touchY <= 270;
+    // Botón SERIE: alternar stream [PROF] por puerto serie
+    if (buttonRow && touchX >= 70 && touchX <= 170) {
+      RuntimeProfiler::setSerialStream(!RuntimeProfiler::isSerialStream());
+      drawProfilerButtons();
+      return;
+    }
+    // Botón PC: muestreo de PC (stream binario, ver tools/pc_sampler_decode.py)
+    if (buttonRow && touchX >= 190 && touchX <= 290) {
+      cyclePcSampler();
+      drawProfilerButtons();
+      return;
+    }
+    // Cualquier otro toque sale
+    Logger::info("Perfil CPU/memoria cerrado");
+    calibState = CalibrationState::NONE;
+    return;
+  }
+
+  // Redibujar solo cuando el profiler publica una muestra nueva
+  RuntimeProfiler::Snapshot snap;
+  bool valid = RuntimeProfiler::getSnapshot(0, snap);
+  uint32_t sampleMs = valid ? snap.timestampMs : 0;
+  if (sampleMs == profilerDrawnSampleMs) return;
+  profilerDrawnSampleMs = sampleMs;
+  drawProfilerScreen(snap, valid);
+}
+
 // Función anterior mantenida por compatibilidad (ahora deprecated)
 static void clearErrorsMenu() {
   // ✅ v2.7.0: Redirigir a confirmación interactiva
   startClearErrorsConfirm();
 }
 
-// Función para detectar toque en opciones del menú
-static int getTouchedMenuOption(int touchX, int touchY) {
-  // Verificar si está dentro del área del menú
-  if (touchX < MENU_X1 || touchX > MENU_X1 + MENU_WIDTH) return -1;
-  if (touchY < MENU_Y1 || touchY > MENU_Y1 + NUM_MENU_ITEMS * MENU_ITEM_HEIGHT)
-    return -1;
-
-  // Calcular qué opción fue tocada
-  int option = (touchY - MENU_Y1) / MENU_ITEM_HEIGHT + 1;
-  return (option >= 1 && option <= NUM_MENU_ITEMS) ? option : -1;
-}
-
 // -----------------------
 // Numeric Keypad for Code Entry
 // -----------------------
 
-// Forward declarations
-static void drawMenuFull();
-static void updateCodeDisplay();
-
 // Keypad layout constants
-static const int KEYPAD_X = 100;
-static const int KEYPAD_Y = 80;
-static const int KEYPAD_BTN_WIDTH = 60;
-static const int KEYPAD_BTN_HEIGHT = 50;
-static const int KEYPAD_SPACING = 10;
-
-// Keypad button structure
-struct KeypadButton {
-  int x, y;
-  int value; // -1 for backspace, -2 for enter
-  const char *label;
-};
-
-// 3x4 keypad layout: 1-9, back, 0, enter
-static const KeypadButton keypadButtons[12] = {
-    {KEYPAD_X, KEYPAD_Y, 1, "1"},
-    {KEYPAD_X + (KEYPAD_BTN_WIDTH + KEYPAD_SPACING), KEYPAD_Y, 2, "2"},
-    {KEYPAD_X + 2 * (KEYPAD_BTN_WIDTH + KEYPAD_SPACING), KEYPAD_Y, 3, "3"},
-
-    {KEYPAD_X, KEYPAD_Y + (KEYPAD_BTN_HEIGHT + KEYPAD_SPACING), 4, "4"},
-    {KEYPAD_X + (KEYPAD_BTN_WIDTH + KEYPAD_SPACING),
-     KEYPAD_Y + (KEYPAD_BTN_HEIGHT + KEYPAD_SPACING), 5, "5"},
-    {KEYPAD_X + 2 * (KEYPAD_BTN_WIDTH + KEYPAD_SPACING),
-     KEYPAD_Y + (KEYPAD_BTN_HEIGHT + KEYPAD_SPACING), 6, "6"},
-
-    {KEYPAD_X, KEYPAD_Y + 2 * (KEYPAD_BTN_HEIGHT + KEYPAD_SPACING), 7, "7"},
-    {KEYPAD_X + (KEYPAD_BTN_WIDTH + KEYPAD_SPACING),
-     KEYPAD_Y + 2 * (KEYPAD_BTN_HEIGHT + KEYPAD_SPACING), 8, "8"},
-    {KEYPAD_X + 2 * (KEYPAD_BTN_WIDTH + KEYPAD_SPACING),
-     KEYPAD_Y + 2 * (KEYPAD_BTN_HEIGHT + KEYPAD_SPACING), 9, "9"},
-
-    {KEYPAD_X, KEYPAD_Y + 3 * (KEYPAD_BTN_HEIGHT + KEYPAD_SPACING), -1, "<"},
-    {KEYPAD_X + (KEYPAD_BTN_WIDTH + KEYPAD_SPACING),
-     KEYPAD_Y + 3 * (KEYPAD_BTN_HEIGHT + KEYPAD_SPACING), 0, "0"},
-    {KEYPAD_X + 2 * (KEYPAD_BTN_WIDTH + KEYPAD_SPACING),
-     KEYPAD_Y + 3 * (KEYPAD_BTN_HEIGHT + KEYPAD_SPACING), -2, "OK"}};
-
-static void drawNumericKeypad() {
-  if (tft == nullptr) return;
+static const int16_t KEYPAD_X = 100;
+static const int16_t KEYPAD_Y = 80;
+static const int16_t KEYPAD_BTN_WIDTH = 60;
+static const int16_t KEYPAD_BTN_HEIGHT = 50;
+static const int16_t KEYPAD_SPACING = 10;
+
+// 3x4 keypad layout: 1-9, back, 0, enter (-1 backspace, -2 enter)
+static const int KEYPAD_VALUES[12] = {1, 2, 3, 4, 5, 6, 7, 8, 9, -1, 0, -2};
+
+static HudWidgets::Rect keyRect(int col, int row) {
+  return {static_cast<int16_t>(KEYPAD_X +
+                               col * (KEYPAD_BTN_WIDTH + KEYPAD_SPACING)),
+          static_cast<int16_t>(KEYPAD_Y +
+                               row * (KEYPAD_BTN_HEIGHT + KEYPAD_SPACING)),
+          KEYPAD_BTN_WIDTH, KEYPAD_BTN_HEIGHT};
+}
 
-  // Clear screen
-  tft->fillScreen(TFT_BLACK);
+// -----------------------
+// Widgets (hud_widgets.h): menú y teclado se construyen una vez; cambiar la
+// selección redibuja dos filas y cada dígito solo el recuadro del código
+// -----------------------
+using HudWidgets::Button;
+using HudWidgets::Frame;
+using HudWidgets::Label;
+using HudWidgets::List;
+using HudWidgets::Screen;
+using HudWidgets::Style;
+
+static Screen menuScreen(TFT_BLACK);
+static Frame menuFrame({60, 40, 360, 240});
+static Label menuTitle({80, 50, 200, 16}, "MENU OCULTO");
+// Dentro del marco para no pisar su borde al redibujar una fila
+static List menuList({MENU_X1 + 1, MENU_Y1, MENU_WIDTH - 2,
+                      NUM_MENU_ITEMS * MENU_ITEM_HEIGHT},
+                     MENU_ITEM_HEIGHT, MENU_ITEMS, NUM_MENU_ITEMS);
+
+static Screen keypadScreen(TFT_BLACK);
+static Label keypadTitle({0, 6, 480, 30}, "Código de acceso");
+static Label codeLabel({100, 40, 280, 35});
+static Button keypadKeys[12] = {
+    Button(keyRect(0, 0), "1"), Button(keyRect(1, 0), "2"),
+    Button(keyRect(2, 0), "3"), Button(keyRect(0, 1), "4"),
+    Button(keyRect(1, 1), "5"), Button(keyRect(2, 1), "6"),
+    Button(keyRect(0, 2), "7"), Button(keyRect(1, 2), "8"),
+    Button(keyRect(2, 2), "9"), Button(keyRect(0, 3), "<"),
+    Button(keyRect(1, 3), "0"), Button(keyRect(2, 3), "OK")};
+static Label keypadHint({0, 294, 480, 16}, "Toca números para entrar 8989");
+static bool widgetsBuilt = false;
+
+static Style textStyle(uint16_t fg, uint16_t bg, uint8_t font,
+                       HudWidgets::Align align) {
+  Style s;
+  s.fg = fg;
+  s.bg = bg;
+  s.font = font;
+  s.align = align;
+  return s;
+}
 
-  // Title
-  tft->setTextDatum(TC_DATUM);
-  tft->setTextColor(TFT_CYAN, TFT_BLACK);
-  tft->drawString("Código de acceso", 240, 20, 4);
+static void buildWidgets() {
+  if (widgetsBuilt) return;
+  using HudWidgets::Align;
+
+  menuTitle.setStyle(textStyle(TFT_WHITE, TFT_BLACK, 2, Align::LEFT));
+  Style list = textStyle(TFT_WHITE, TFT_BLACK, 2, Align::LEFT);
+  list.accent = TFT_YELLOW; // Opción seleccionada
+  list.padding = 19;        // Texto en x = 80 como antes
+  menuList.setStyle(list);
+  menuScreen.add(menuFrame);
+  menuScreen.add(menuTitle);
+  menuScreen.add(menuList);
+
+  keypadTitle.setStyle(textStyle(TFT_CYAN, TFT_BLACK, 4, Align::CENTER));
+  keypadHint.setStyle(textStyle(TFT_YELLOW, TFT_BLACK, 2, Align::CENTER));
+  Style key = textStyle(TFT_WHITE, TFT_BLACK, 4, Align::CENTER);
+  key.accent = TFT_NAVY;
+  key.radius = 5;
+  keypadScreen.add(keypadTitle);
+  keypadScreen.add(codeLabel);
+  for (int i = 0; i < 12; i++) {
+    keypadKeys[i].setStyle(key);
+    keypadScreen.add(keypadKeys[i]);
+  }
+  keypadScreen.add(keypadHint);
+  widgetsBuilt = true;
+}
 
-  // Code display
-  tft->setTextDatum(MC_DATUM);
-  tft->setTextColor(TFT_WHITE, TFT_BLACK);
+static void updateCodeDisplay() {
+  // Código introducido (o el aviso de código incorrecto) en el mismo recuadro
   char codeStr[8];
   snprintf(codeStr, sizeof(codeStr), "%04d", codeBuffer);
-  tft->drawString(codeStr, 240, 55, 4);
-
-  // Draw keypad buttons
-  for (int i = 0; i < 12; i++) {
-    const KeypadButton &btn = keypadButtons[i];
-
-    // Button background
-    tft->fillRoundRect(btn.x, btn.y, KEYPAD_BTN_WIDTH, KEYPAD_BTN_HEIGHT, 5,
-                       TFT_NAVY);
-    tft->drawRoundRect(btn.x, btn.y, KEYPAD_BTN_WIDTH, KEYPAD_BTN_HEIGHT, 5,
-                       TFT_WHITE);
+  codeLabel.setStyle(
+      textStyle(TFT_WHITE, TFT_BLACK, 4, HudWidgets::Align::CENTER));
+  codeLabel.setText(codeStr);
+  HudWidgets::render(keypadScreen, tft);
+}
 
-    // Button label
-    tft->setTextDatum(MC_DATUM);
-    tft->setTextColor(TFT_WHITE, TFT_NAVY);
-    tft->drawString(btn.label, btn.x + KEYPAD_BTN_WIDTH / 2,
-                    btn.y + KEYPAD_BTN_HEIGHT / 2, 4);
-  }
+static void drawNumericKeypad() {
+  if (tft == nullptr) return;
+  buildWidgets();
+  keypadScreen.invalidateAll();
+  updateCodeDisplay();
+}
 
-  // Instructions
-  tft->setTextDatum(BC_DATUM);
-  tft->setTextColor(TFT_YELLOW, TFT_BLACK);
-  tft->drawString("Toca números para entrar 8989", 240, 310, 2);
+static void showWrongCode() {
+  codeLabel.setStyle(
+      textStyle(TFT_WHITE, TFT_RED, 2, HudWidgets::Align::CENTER));
+  codeLabel.setText("CÓDIGO INCORRECTO");
+  HudWidgets::render(keypadScreen, tft);
 }
 
 static int getTouchedKeypadButton(int x, int y) {
+  HudWidgets::Widget *hit = keypadScreen.hitTest(x, y);
   for (int i = 0; i < 12; i++) {
-    const KeypadButton &btn = keypadButtons[i];
-    if (x >= btn.x && x < btn.x + KEYPAD_BTN_WIDTH && y >= btn.y &&
-        y < btn.y + KEYPAD_BTN_HEIGHT) {
-      return i; // Return button index
-    }
+    if (hit == &keypadKeys[i]) return i;
   }
   return -1; // No button touched
 }
 
+// Función para detectar toque en opciones del menú (1..10, -1 fuera)
+static int getTouchedMenuOption(int touchX, int touchY) {
+  int row = menuList.rowAt(touchX, touchY);
+  return row >= 0 ? row + 1 : -1;
+}
+
+// -----------------------
+// Dibujo del menú
+// -----------------------
+static void drawMenuFull() {
+  if (tft == nullptr) return;
+  buildWidgets();
+  // 🔒 v2.10.0: Full screen clear to prevent gauge ghosting
+  // The speed and RPM gauges at (70,175) and (410,175) with radius ~73px
+  // extend beyond the menu rectangle (60,40,360,240), leaving visible artifacts
+  // when the menu opens. invalidateAll() clears the entire screen first.
+  menuList.setSelected(selectedOption - 1);
+  menuScreen.invalidateAll();
+  HudWidgets::render(menuScreen, tft);
+}
+
+static void updateOptionHighlight() {
+  // Redibujar solo la línea anterior y la nueva
+  menuList.setSelected(selectedOption - 1);
+  HudWidgets::render(menuScreen, tft);
+}
+
 static void handleKeypadInput(int buttonIndex) {
   if (buttonIndex < 0 || buttonIndex >= 12) return;
 
-  const KeypadButton &btn = keypadButtons[buttonIndex];
+  const int value = KEYPAD_VALUES[buttonIndex];
 
-  if (btn.value == -1) {
+  if (value == -1) {
     // Backspace
     codeBuffer = codeBuffer / 10;
     updateCodeDisplay();
-    drawNumericKeypad(); // Redraw to show updated code
     Alerts::play({Audio::AUDIO_MODULO_OK, Audio::Priority::PRIO_NORMAL});
-  } else if (btn.value == -2) {
+  } else if (value == -2) {
     // Enter/OK - check code
     if (codeBuffer == accessCode) {
       menuActive = true;
       numpadActive = false;
       Alerts::play({Audio::AUDIO_MENU_OCULTO, Audio::Priority::PRIO_HIGH});
+      HudWidgets::logStats("Keypad", keypadScreen);
       drawMenuFull();
-      lastMenuActive = true;
-      lastSelectedOption = selectedOption;
-      lastCodeBuffer = codeBuffer;
     } else {
       // Wrong code - show error with non-blocking delay
-      tft->fillRect(100, 40, 280, 35, TFT_RED);
-      tft->setTextDatum(MC_DATUM);
-      tft->setTextColor(TFT_WHITE, TFT_RED);
-      tft->drawString("CÓDIGO INCORRECTO", 240, 55, 2);
+      showWrongCode();
       Alerts::play({Audio::AUDIO_ERROR_GENERAL, Audio::Priority::PRIO_HIGH});
       // Set timestamp for non-blocking error display
       wrongCodeDisplayStart = millis();
@@ -1028,62 +1210,12 @@ static void handleKeypadInput(int buttonIndex) {
       Alerts::play({Audio::AUDIO_ERROR_GENERAL, Audio::Priority::PRIO_NORMAL});
       return;
     }
-    codeBuffer = (codeBuffer * 10) + btn.value;
-    drawNumericKeypad(); // Redraw to show updated code
+    codeBuffer = (codeBuffer * 10) + value;
+    updateCodeDisplay();
     Alerts::play({Audio::AUDIO_MODULO_OK, Audio::Priority::PRIO_NORMAL});
   }
 }
 
-// -----------------------
-// Dibujo del menú
-// -----------------------
-static void drawMenuFull() {
-  // 🔒 v2.10.0: Full screen clear to prevent gauge ghosting
-  // The speed and RPM gauges at (70,175) and (410,175) with radius ~73px
-  // extend beyond the menu rectangle (60,40,360,240), leaving visible artifacts
-  // when the menu opens. Clear the entire screen first.
-  tft->fillScreen(TFT_BLACK);
-
-  // Draw menu rectangle border (background already black from fillScreen)
-  tft->drawRect(60, 40, 360, 240, TFT_WHITE);
-  tft->setTextDatum(TL_DATUM);
-
-  tft->setTextColor(TFT_WHITE, TFT_BLACK);
-  tft->drawString("MENU OCULTO", 80, 50, 2);
-
-  for (int i = 0; i < NUM_MENU_ITEMS; i++) {
-    uint16_t col = (i + 1 == selectedOption) ? TFT_YELLOW : TFT_WHITE;
-    tft->setTextColor(col, TFT_BLACK);
-    tft->drawString(MENU_ITEMS[i], 80, 80 + i * 20, 2);
-  }
-
-  // No need to show code anymore - entered via keypad
-}
-
-static void updateOptionHighlight() {
-  // Redibujar solo la línea anterior y la nueva
-  if (lastSelectedOption != -1 && lastSelectedOption != selectedOption) {
-    tft->setTextColor(TFT_WHITE, TFT_BLACK);
-    tft->drawString(MENU_ITEMS[lastSelectedOption - 1], 80,
-                    80 + (lastSelectedOption - 1) * 20, 2);
-  }
-  tft->setTextColor(TFT_YELLOW, TFT_BLACK);
-  tft->drawString(MENU_ITEMS[selectedOption - 1], 80,
-                  80 + (selectedOption - 1) * 20, 2);
-}
-
-static void updateCodeDisplay() {
-  // Update code display on numeric keypad
-  if (!numpadActive) return;
-
-  tft->fillRect(100, 40, 280, 35, TFT_BLACK);
-  tft->setTextDatum(MC_DATUM);
-  tft->setTextColor(TFT_WHITE, TFT_BLACK);
-  char codeStr[8];
-  snprintf(codeStr, sizeof(codeStr), "%04d", codeBuffer);
-  tft->drawString(codeStr, 240, 55, 4);
-}
-
 // -----------------------
 // API pública
 // -----------------------
@@ -1099,15 +1231,8 @@ void MenuHidden::update(bool batteryIconPressed) {
     bool touched = false;
     int touchX = 0, touchY = 0;
 
-    // 🔒 v2.8.8: Usar touch integrado de TFT_eSPI
-    uint16_t tx, ty;
-    if (tft != nullptr && tft->getTouch(&tx, &ty)) {
-      touchX = (int)tx;
-      touchY = (int)ty;
-      touched = true;
-      // Debounce con timeout (no para regen que necesita detección continua)
-      if (calibState != CalibrationState::REGEN_ADJUST) { waitTouchRelease(); }
-    }
+    // TAP de TouchInput (la calibración táctil lee la posición por su cuenta)
+    touched = takeTap(touchX, touchY);
 
     if (calibState == CalibrationState::PEDAL_MIN ||
         calibState == CalibrationState::PEDAL_MAX ||
@@ -1137,21 +1262,25 @@ void MenuHidden::update(bool batteryIconPressed) {
     // ✅ v2.7.0: Manejar ajuste interactivo de regen
     else if (calibState == CalibrationState::REGEN_ADJUST) {
       updateRegenAdjust(touchX, touchY, touched);
-      if (touched)
-        waitTouchRelease(
-            DEBOUNCE_SHORT_MS); // Debounce corto después de procesar
     }
     // Manejar configuración de módulos ON/OFF
     else if (calibState == CalibrationState::MODULES_CONFIG) {
       updateModulesConfig(touchX, touchY, touched);
-      if (touched)
-        waitTouchRelease(
-            DEBOUNCE_SHORT_MS); // Debounce corto después de procesar
     }
     // ✅ v2.7.0: Manejar confirmación de borrado de errores
     else if (calibState == CalibrationState::CLEAR_ERRORS_CONFIRM) {
       updateClearErrorsConfirm(touchX, touchY, touched);
     }
+    // Perfil CPU/memoria en vivo
+    else if (calibState == CalibrationState::PROFILER_VIEW) {
+      updateProfilerView(touchX, touchY, touched);
+    }
+    // Lista de errores: volver al menú con un toque o tras ERRORS_VIEW_MS
+    else if (calibState == CalibrationState::ERRORS_VIEW) {
+      if (touched || millis() - errorsViewStartMs > ERRORS_VIEW_MS) {
+        calibState = CalibrationState::NONE;
+      }
+    }
 
     // Si terminó la calibración, redibujar menú
     if (calibState == CalibrationState::NONE && menuActive) { drawMenuFull(); }
@@ -1165,40 +1294,35 @@ void MenuHidden::update(bool batteryIconPressed) {
       codeBuffer = 0;
       drawNumericKeypad();
       Alerts::play({Audio::AUDIO_MODULO_OK, Audio::Priority::PRIO_NORMAL});
-      lastCodeBuffer = codeBuffer;
       return;
     }
 
     // Handle keypad interaction when active
     if (numpadActive) {
-      uint16_t tx, ty;
+      int tx, ty;
       uint32_t now = millis();
 
-      // Check for touch with debounce
-      if (tft != nullptr && tft->getTouch(&tx, &ty)) {
-        if (now - lastKeypadTouch > KEYPAD_DEBOUNCE_MS) {
-          int buttonIndex = getTouchedKeypadButton((int)tx, (int)ty);
-          if (buttonIndex >= 0) {
-            handleKeypadInput(buttonIndex);
-            lastKeypadTouch = now;
-            waitTouchRelease(DEBOUNCE_SHORT_MS);
-          }
+      // Cada TAP es una pulsación completa: sin debounce por tiempo
+      if (takeTap(tx, ty)) {
+        int buttonIndex = getTouchedKeypadButton(tx, ty);
+        if (buttonIndex >= 0) {
+          handleKeypadInput(buttonIndex);
+          lastKeypadTouch = now;
         }
       }
 
       // Clear wrong code error message after 1 second (non-blocking)
       if (wrongCodeDisplayStart > 0 && (now - wrongCodeDisplayStart > 1000)) {
         wrongCodeDisplayStart = 0;
-        drawNumericKeypad(); // Redraw keypad to clear error
+        updateCodeDisplay(); // Solo el recuadro del código
       }
 
       // Exit keypad if battery pressed again (cancel)
       if (batteryIconPressed && (now - lastKeypadTouch > KEYPAD_DEBOUNCE_MS)) {
         numpadActive = false;
         codeBuffer = 0;
-        lastCodeBuffer = 0;
         lastKeypadTouch = now;
-        waitTouchRelease(DEBOUNCE_SHORT_MS);
+        discardTouch();
         // Don't clear screen - let normal HUD update redraw
         // This prevents flickering from full screen clear
       }
@@ -1208,25 +1332,18 @@ void MenuHidden::update(bool batteryIconPressed) {
   }
 
   // ====== NAVEGACIÓN TÁCTIL DEL MENÚ ======
-  // 🔒 v2.8.8: Usar touch integrado de TFT_eSPI
-  uint16_t tx, ty;
-  if (tft != nullptr && tft->getTouch(&tx, &ty)) {
-    int touchX = (int)tx;
-    int touchY = (int)ty;
-
+  int touchX, touchY;
+  if (takeTap(touchX, touchY)) {
     // Detectar opción tocada
     int touchedOption = getTouchedMenuOption(touchX, touchY);
 
     if (touchedOption > 0) {
       // Actualizar selección visual
       selectedOption = touchedOption;
-      if (selectedOption != lastSelectedOption) {
-        updateOptionHighlight();
-        lastSelectedOption = selectedOption;
-      }
+      updateOptionHighlight();
 
-      // Debounce con timeout - esperar a que suelte
-      waitTouchRelease();
+      // Descartar toques acumulados antes de ejecutar la acción
+      discardTouch();
 
       // Ejecutar acción (sin sonido extra, cada acción tiene su sonido)
 
@@ -1258,18 +1375,26 @@ void MenuHidden::update(bool batteryIconPressed) {
       case 9:
         startClearErrorsConfirm();
         break; // ✅ v2.7.0: Confirmación
+      case 10:
+        startProfilerView();
+        break; // Perfil CPU/pila/heap en vivo
       }
 
-      // Redibujar menú después de acción (excepto si se cerró)
-      if (menuActive && calibState == CalibrationState::NONE) {
-        drawMenuFull();
-      }
-      lastSelectedOption = selectedOption;
-      lastCodeBuffer = codeBuffer;
+      // Las acciones que siguen en el menú (restaurar fábrica) no dibujan
+      // nada: la selección ya está actualizada. Las pantallas de
+      // calibración redibujan el menú entero al volver
+      if (!menuActive) HudWidgets::logStats("MenuHidden", menuScreen);
     }
   }
 }
 
+void MenuHidden::handleTouch(const TouchInput::Event &event) {
+  if (event.type != TouchInput::EventType::TAP) return;
+  tapPending = true;
+  tapX = event.x;
+  tapY = event.y;
+}
+
 bool MenuHidden::isActive() {
   return menuActive || numpadActive; // Include numpad in active state
 }
@@ -1281,9 +1406,6 @@ void MenuHidden::activateDirectly() {
     codeBuffer = accessCode; // Set code to access code to match state
     Alerts::play({Audio::AUDIO_MENU_OCULTO, Audio::Priority::PRIO_HIGH});
     drawMenuFull();
-    lastMenuActive = true;
-    lastSelectedOption = selectedOption;
-    lastCodeBuffer = codeBuffer;
     Logger::info("Menu oculto activado directamente (modo demo)");
   }
 }
@@ -1303,10 +1425,7 @@ void MenuHidden::startTouchCalibrationDirectly() {
   }
 
   // Close menu if active
-  if (menuActive) {
-    menuActive = false;
-    lastMenuActive = false;
-  }
+  if (menuActive) { menuActive = false; }
 
   Logger::info(
       "Starting direct touch calibration (activated by physical button)");
@@ -5,22 +5,20 @@
 
 #include "menu_led_control.h"
 #include "alerts.h"
-#include "config_storage.h"
-#include "eeprom_persistence.h"
+#include "config_store.h"
+#include "hud_widgets.h"
 #include "led_controller.h"
 #include "logger.h"
 #include <TFT_eSPI.h>
 
+using namespace HudWidgets;
+
 // Forward declaration of TFT instance (shared with HUD)
 extern TFT_eSPI *tft;
 
 // Static member definitions
 bool MenuLEDControl::visible = false;
-bool MenuLEDControl::needsRedraw = true;
 uint8_t MenuLEDControl::selectedPattern = 0;
-bool MenuLEDControl::draggingBrightness = false;
-bool MenuLEDControl::draggingSpeed = false;
-bool MenuLEDControl::pickingColor = false;
 uint8_t MenuLEDControl::colorPickerH = 0;
 uint8_t MenuLEDControl::colorPickerS = 255;
 
@@ -33,17 +31,19 @@ static const uint16_t COLOR_SLIDER_BG = TFT_DARKGREY;
 static const uint16_t COLOR_SLIDER_FG = TFT_BLUE;
 
 // Layout constants
-static const int HEADER_Y = 10;
-static const int PATTERN_Y = 50;
-static const int PATTERN_BTN_W = 55;
-static const int PATTERN_BTN_H = 40;
-static const int BRIGHTNESS_Y = 110;
-static const int SPEED_Y = 160;
-static const int COLOR_Y = 210;
-static const int PREVIEW_Y = 260;
-static const int SLIDER_X = 120;
-static const int SLIDER_W = 300;
-static const int SLIDER_H = 25;
+static const int16_t HEADER_Y = 10;
+static const int16_t PATTERN_Y = 50;
+static const int16_t PATTERN_BTN_W = 55;
+static const int16_t PATTERN_BTN_H = 40;
+static const int16_t BRIGHTNESS_Y = 110;
+static const int16_t SPEED_Y = 160;
+static const int16_t COLOR_Y = 210;
+static const int16_t PREVIEW_Y = 260;
+static const int16_t SLIDER_X = 120;
+static const int16_t SLIDER_W = 300;
+static const int16_t SLIDER_H = 25;
+static const int16_t MARKER_H = 9; // Hue marker below the color bar
+static const uint32_t PREVIEW_PERIOD_MS = 100;
 
 // Pattern names
 static const char *PATTERN_NAMES[] = {"Off",   "Solid",   "Breath", "Rainbow",
@@ -73,210 +73,32 @@ static uint16_t hueToRGB565(uint8_t h) {
   return tft->color565(r, g, b);
 }
 
-void MenuLEDControl::init() {
-  loadSettings();
-  visible = false;
-  needsRedraw = true;
-  Logger::info("MenuLEDControl: initialized");
-}
-
-void MenuLEDControl::update() {
-  if (!visible) return;
-
-  // Periodic redraw of preview
-  static uint32_t lastPreviewUpdate = 0;
-  if (millis() - lastPreviewUpdate > 100) {
-    lastPreviewUpdate = millis();
-    drawPreview();
-  }
-}
-
-void MenuLEDControl::draw() {
-  if (!visible || !needsRedraw) return;
-  needsRedraw = false;
-
-  tft->fillScreen(COLOR_BG);
-
-  // Header
-  tft->setTextDatum(TC_DATUM);
-  tft->setTextColor(COLOR_ACCENT, COLOR_BG);
-  tft->drawString("LED CONTROL", 240, HEADER_Y, 4);
-
-  drawPatternSelector();
-  drawBrightnessSlider();
-  drawSpeedSlider();
-  drawColorPicker();
-  drawPreview();
-  drawControls();
-}
-
-void MenuLEDControl::handleTouch(int16_t x, int16_t y) {
-  if (!visible) return;
-
-  // Reset dragging states on each touch
-  if (y < BRIGHTNESS_Y - 10 || y > SPEED_Y + SLIDER_H + 10) {
-    draggingBrightness = false;
-    draggingSpeed = false;
-  }
-
-  // Check pattern selection
-  handlePatternSelect(x, y);
-
-  // Check brightness slider
-  handleBrightnessSlider(x, y);
-
-  // Check speed slider
-  handleSpeedSlider(x, y);
-
-  // Check color picker
-  handleColorPicker(x, y);
-
-  // Check control buttons
-  // Save button (bottom left)
-  if (x >= 20 && x <= 150 && y >= 280 && y <= 315) {
-    saveSettings();
-    Alerts::play({Audio::AUDIO_MODULO_OK, Audio::Priority::PRIO_HIGH});
-    needsRedraw = true;
-  }
-
-  // Back button (bottom right)
-  if (x >= 330 && x <= 460 && y >= 280 && y <= 315) { hide(); }
-}
-
-void MenuLEDControl::show() {
-  visible = true;
-  needsRedraw = true;
-  loadSettings();
-  draw();
-  Logger::info("MenuLEDControl: shown");
-}
-
-void MenuLEDControl::hide() {
-  visible = false;
-  Logger::info("MenuLEDControl: hidden");
-}
-
-bool MenuLEDControl::isVisible() { return visible; }
-
-void MenuLEDControl::drawPatternSelector() {
-  tft->setTextDatum(TL_DATUM);
-  tft->setTextColor(COLOR_TEXT, COLOR_BG);
-  tft->drawString("Pattern:", 20, PATTERN_Y, 2);
-
-  // Draw pattern buttons in 2 rows
-  for (int i = 0; i < NUM_PATTERNS; i++) {
-    int row = i / 4;
-    int col = i % 4;
-    int btnX = 100 + col * (PATTERN_BTN_W + 10);
-    int btnY = PATTERN_Y + row * (PATTERN_BTN_H + 5);
-
-    uint16_t btnColor = (i == selectedPattern) ? COLOR_SELECTED : TFT_DARKGREY;
-    tft->fillRoundRect(btnX, btnY, PATTERN_BTN_W, PATTERN_BTN_H, 5, btnColor);
-    tft->drawRoundRect(btnX, btnY, PATTERN_BTN_W, PATTERN_BTN_H, 5, COLOR_TEXT);
-
-    tft->setTextDatum(MC_DATUM);
-    tft->setTextColor((i == selectedPattern) ? COLOR_BG : COLOR_TEXT, btnColor);
-    tft->drawString(PATTERN_NAMES[i], btnX + PATTERN_BTN_W / 2,
-                    btnY + PATTERN_BTN_H / 2, 1);
-  }
-}
-
-void MenuLEDControl::drawBrightnessSlider() {
-  auto &cfg = LEDController::getConfig();
-
-  tft->setTextDatum(TL_DATUM);
-  tft->setTextColor(COLOR_TEXT, COLOR_BG);
-  tft->drawString("Brightness:", 20, BRIGHTNESS_Y + 5, 2);
-
-  // Draw slider background
-  tft->fillRoundRect(SLIDER_X, BRIGHTNESS_Y, SLIDER_W, SLIDER_H, 5,
-                     COLOR_SLIDER_BG);
-
-  // Draw filled portion
-  int fillW = (cfg.brightness * SLIDER_W) / 255;
-  tft->fillRoundRect(SLIDER_X, BRIGHTNESS_Y, fillW, SLIDER_H, 5,
-                     COLOR_SLIDER_FG);
-
-  // Draw border
-  tft->drawRoundRect(SLIDER_X, BRIGHTNESS_Y, SLIDER_W, SLIDER_H, 5, COLOR_TEXT);
-
-  // Draw value
-  char valueStr[8];
-  snprintf(valueStr, sizeof(valueStr), "%d%%", (cfg.brightness * 100) / 255);
-  tft->setTextDatum(MC_DATUM);
-  tft->setTextColor(COLOR_TEXT, COLOR_BG);
-  tft->drawString(valueStr, SLIDER_X + SLIDER_W + 30,
-                  BRIGHTNESS_Y + SLIDER_H / 2, 2);
-}
-
-void MenuLEDControl::drawSpeedSlider() {
-  auto &cfg = LEDController::getConfig();
-  uint8_t speed = 128; // Default mid speed
-
-  tft->setTextDatum(TL_DATUM);
-  tft->setTextColor(COLOR_TEXT, COLOR_BG);
-  tft->drawString("Speed:", 20, SPEED_Y + 5, 2);
-
-  // Draw slider background
-  tft->fillRoundRect(SLIDER_X, SPEED_Y, SLIDER_W, SLIDER_H, 5, COLOR_SLIDER_BG);
-
-  // Draw filled portion
-  int fillW = (speed * SLIDER_W) / 255;
-  tft->fillRoundRect(SLIDER_X, SPEED_Y, fillW, SLIDER_H, 5, TFT_GREEN);
-
-  // Draw border
-  tft->drawRoundRect(SLIDER_X, SPEED_Y, SLIDER_W, SLIDER_H, 5, COLOR_TEXT);
-
-  // Draw value
-  char valueStr[8];
-  snprintf(valueStr, sizeof(valueStr), "%d%%", (speed * 100) / 255);
-  tft->setTextDatum(MC_DATUM);
-  tft->setTextColor(COLOR_TEXT, COLOR_BG);
-  tft->drawString(valueStr, SLIDER_X + SLIDER_W + 30, SPEED_Y + SLIDER_H / 2,
-                  2);
-}
-
-void MenuLEDControl::drawColorPicker() {
-  tft->setTextDatum(TL_DATUM);
-  tft->setTextColor(COLOR_TEXT, COLOR_BG);
-  tft->drawString("Color:", 20, COLOR_Y + 5, 2);
-
-  // Draw color spectrum bar (hue 0-255)
-  int barX = SLIDER_X;
-  int barW = SLIDER_W;
-  int barH = SLIDER_H;
+// Hue spectrum with the selection marker; w.value() = hue
+static void drawHueBar(TFT_eSPI &g, const Custom &w, int16_t x, int16_t y) {
+  const Rect &r = w.rect();
+  g.fillRect(x, y, r.w, r.h, COLOR_BG);
 
   // Draw rainbow gradient using helper function
-  for (int i = 0; i < barW; i++) {
-    uint8_t h = (i * 255) / barW;
-    tft->drawFastVLine(barX + i, COLOR_Y, barH, hueToRGB565(h));
+  for (int i = 0; i < SLIDER_W; i++) {
+    uint8_t h = (i * 255) / SLIDER_W;
+    g.drawFastVLine(x + i, y, SLIDER_H, hueToRGB565(h));
   }
-
-  // Draw border
-  tft->drawRect(barX, COLOR_Y, barW, barH, COLOR_TEXT);
+  g.drawRect(x, y, SLIDER_W, SLIDER_H, COLOR_TEXT);
 
   // Draw selection marker
-  int markerX = barX + (colorPickerH * barW) / 255;
-  tft->drawTriangle(markerX - 5, COLOR_Y + barH + 2, markerX + 5,
-                    COLOR_Y + barH + 2, markerX, COLOR_Y + barH + 8,
-                    COLOR_TEXT);
-
-  // Draw current color preview using helper function
-  uint16_t currentColor = hueToRGB565(colorPickerH);
-  tft->fillRect(barX + barW + 10, COLOR_Y, 30, barH, currentColor);
-  tft->drawRect(barX + barW + 10, COLOR_Y, 30, barH, COLOR_TEXT);
+  int markerX = x + (w.value() * SLIDER_W) / 255;
+  g.drawTriangle(markerX - 5, y + SLIDER_H + 2, markerX + 5, y + SLIDER_H + 2,
+                 markerX, y + SLIDER_H + 8, COLOR_TEXT);
 }
 
-void MenuLEDControl::drawPreview() {
-  // Animated preview of current pattern
+// Animated preview of the pattern in w.value(); redrawn every
+// PREVIEW_PERIOD_MS by update()
+static void drawPreview(TFT_eSPI &gfx, const Custom &w, int16_t x, int16_t y) {
   static uint8_t animFrame = 0;
   animFrame++;
 
-  int previewX = 160;
-  int previewW = 160;
-  int previewH = 20;
-
-  tft->fillRect(previewX, PREVIEW_Y, previewW, previewH, COLOR_BG);
+  const Rect &area = w.rect();
+  gfx.fillRect(x, y, area.w, area.h, COLOR_BG);
 
   // Fast sine approximation lookup table (0-255 -> 0-255 sine wave)
   // Pre-computed for performance: sin(x*2*PI/256) * 127 + 128
@@ -302,10 +124,10 @@ void MenuLEDControl::drawPreview() {
 
   // Simple animation based on pattern
   for (int i = 0; i < 16; i++) {
-    int ledX = previewX + i * 10;
+    int ledX = x + i * 10;
     uint16_t ledColor;
 
-    switch (selectedPattern) {
+    switch (w.value()) {
     case 0: // Off
       ledColor = TFT_DARKGREY;
       break;
@@ -317,7 +139,7 @@ void MenuLEDControl::drawPreview() {
       // Use lookup table for fast sine approximation
       uint8_t lutIndex = (animFrame * 4 + i * 8) & 0xFF;
       uint8_t brightness = sinLut[lutIndex];
-      ledColor = tft->color565(brightness, 0, 0);
+      ledColor = gfx.color565(brightness, 0, 0);
     } break;
     case 3: // Rainbow - use helper function
     {
@@ -334,112 +156,251 @@ void MenuLEDControl::drawPreview() {
     {
       uint8_t r = 200 + random(55);
       uint8_t g = random(100);
-      ledColor = tft->color565(r, g, 0);
+      ledColor = gfx.color565(r, g, 0);
     } break;
     case 7: // Wave
     {
       // Use lookup table for fast sine approximation
       uint8_t lutIndex = (animFrame * 6 - i * 12) & 0xFF;
       uint8_t brightness = sinLut[lutIndex];
-      ledColor = tft->color565(0, 0, brightness);
+      ledColor = gfx.color565(0, 0, brightness);
     } break;
     default:
       ledColor = TFT_DARKGREY;
     }
 
-    tft->fillCircle(ledX + 4, PREVIEW_Y + 10, 4, ledColor);
+    gfx.fillCircle(ledX + 4, y + 10, 4, ledColor);
   }
 }
 
-void MenuLEDControl::drawControls() {
-  // Save button
-  tft->fillRoundRect(20, 280, 130, 35, 5, TFT_GREEN);
-  tft->setTextDatum(MC_DATUM);
-  tft->setTextColor(COLOR_BG, TFT_GREEN);
-  tft->drawString("SAVE", 85, 297, 2);
-
-  // Back button
-  tft->fillRoundRect(330, 280, 130, 35, 5, TFT_DARKGREY);
-  tft->setTextColor(COLOR_TEXT, TFT_DARKGREY);
-  tft->drawString("BACK", 395, 297, 2);
+// Widget tree
+static Screen screen(COLOR_BG);
+static Label title({0, HEADER_Y, 480, 26}, "LED CONTROL");
+static Label patternTitle({20, PATTERN_Y, 78, 16}, "Pattern:");
+static Button patternButtons[NUM_PATTERNS] = {
+    Button({100, PATTERN_Y, PATTERN_BTN_W, PATTERN_BTN_H}, PATTERN_NAMES[0]),
+    Button({165, PATTERN_Y, PATTERN_BTN_W, PATTERN_BTN_H}, PATTERN_NAMES[1]),
+    Button({230, PATTERN_Y, PATTERN_BTN_W, PATTERN_BTN_H}, PATTERN_NAMES[2]),
+    Button({295, PATTERN_Y, PATTERN_BTN_W, PATTERN_BTN_H}, PATTERN_NAMES[3]),
+    Button({100, PATTERN_Y + PATTERN_BTN_H + 5, PATTERN_BTN_W, PATTERN_BTN_H},
+           PATTERN_NAMES[4]),
+    Button({165, PATTERN_Y + PATTERN_BTN_H + 5, PATTERN_BTN_W, PATTERN_BTN_H},
+           PATTERN_NAMES[5]),
+    Button({230, PATTERN_Y + PATTERN_BTN_H + 5, PATTERN_BTN_W, PATTERN_BTN_H},
+           PATTERN_NAMES[6]),
+    Button({295, PATTERN_Y + PATTERN_BTN_H + 5, PATTERN_BTN_W, PATTERN_BTN_H},
+           PATTERN_NAMES[7])};
+static Label brightnessTitle({20, BRIGHTNESS_Y, 98, SLIDER_H}, "Brightness:");
+static Slider brightnessSlider({SLIDER_X, BRIGHTNESS_Y, SLIDER_W, SLIDER_H}, 0, 255);
+static ValueField brightnessValue(
+    {SLIDER_X + SLIDER_W, BRIGHTNESS_Y, 60, SLIDER_H}, "%ld%%");
+static Label speedTitle({20, SPEED_Y, 98, SLIDER_H}, "Speed:");
+static Slider speedSlider({SLIDER_X, SPEED_Y, SLIDER_W, SLIDER_H}, 0, 255);
+static ValueField speedValue({SLIDER_X + SLIDER_W, SPEED_Y, 60, SLIDER_H},
+                             "%ld%%");
+static Label colorTitle({20, COLOR_Y, 98, SLIDER_H}, "Color:");
+static Custom hueBar({SLIDER_X, COLOR_Y, SLIDER_W + 6, SLIDER_H + MARKER_H},
+                     drawHueBar, true);
+static Button colorSwatch({SLIDER_X + SLIDER_W + 10, COLOR_Y, 30, SLIDER_H},
+                          "");
+static Custom preview({160, PREVIEW_Y, 160, 20}, drawPreview);
+static Button saveButton({20, 280, 130, 35}, "SAVE");
+static Button backButton({330, 280, 130, 35}, "BACK");
+static bool built = false;
+static uint32_t lastPreviewUpdate = 0;
+
+static Style textStyle(uint16_t fg, uint8_t font, Align align) {
+  Style s;
+  s.fg = fg;
+  s.bg = COLOR_BG;
+  s.font = font;
+  s.align = align;
+  return s;
 }
 
-void MenuLEDControl::handlePatternSelect(int16_t x, int16_t y) {
-  if (y < PATTERN_Y || y > PATTERN_Y + 2 * (PATTERN_BTN_H + 5)) return;
+static Style faceStyle(uint16_t face, uint16_t text, uint8_t font,
+                       bool outlined) {
+  Style s = textStyle(text, font, Align::CENTER);
+  s.accent = face;
+  s.border = COLOR_TEXT;
+  s.radius = 5;
+  s.outlined = outlined;
+  return s;
+}
 
+void MenuLEDControl::buildScreen() {
+  title.setStyle(textStyle(COLOR_ACCENT, 4, Align::CENTER));
+  screen.add(title);
+
+  patternTitle.setStyle(textStyle(COLOR_TEXT, 2, Align::LEFT));
+  screen.add(patternTitle);
+  for (int i = 0; i < NUM_PATTERNS; i++) screen.add(patternButtons[i]);
+
+  Style sliderStyle = faceStyle(COLOR_SLIDER_FG, COLOR_TEXT, 2, true);
+  Style valueStyle = textStyle(COLOR_TEXT, 2, Align::CENTER);
+  brightnessTitle.setStyle(textStyle(COLOR_TEXT, 2, Align::LEFT));
+  brightnessSlider.setStyle(sliderStyle);
+  brightnessSlider.setTrack(COLOR_SLIDER_BG);
+  brightnessValue.setStyle(valueStyle);
+  screen.add(brightnessTitle);
+  screen.add(brightnessSlider);
+  screen.add(brightnessValue);
+
+  // Speed is not stored yet: shown at mid speed, not touchable
+  sliderStyle.accent = TFT_GREEN;
+  speedTitle.setStyle(textStyle(COLOR_TEXT, 2, Align::LEFT));
+  speedSlider.setStyle(sliderStyle);
+  speedSlider.setTrack(COLOR_SLIDER_BG);
+  speedSlider.setValue(128);
+  speedSlider.setEnabled(false);
+  speedValue.setStyle(valueStyle);
+  speedValue.setValue((128 * 100) / 255);
+  screen.add(speedTitle);
+  screen.add(speedSlider);
+  screen.add(speedValue);
+
+  colorTitle.setStyle(textStyle(COLOR_TEXT, 2, Align::LEFT));
+  screen.add(colorTitle);
+  screen.add(hueBar);
+  screen.add(colorSwatch);
+  screen.add(preview);
+
+  saveButton.setStyle(faceStyle(TFT_GREEN, COLOR_BG, 2, false));
+  backButton.setStyle(faceStyle(TFT_DARKGREY, COLOR_TEXT, 2, false));
+  screen.add(saveButton);
+  screen.add(backButton);
+  built = true;
+}
+
+void MenuLEDControl::syncWidgets() {
   for (int i = 0; i < NUM_PATTERNS; i++) {
-    int row = i / 4;
-    int col = i % 4;
-    int btnX = 100 + col * (PATTERN_BTN_W + 10);
-    int btnY = PATTERN_Y + row * (PATTERN_BTN_H + 5);
-
-    if (x >= btnX && x <= btnX + PATTERN_BTN_W && y >= btnY &&
-        y <= btnY + PATTERN_BTN_H) {
-      if (selectedPattern != i) {
-        selectedPattern = i;
-        needsRedraw = true;
-
-        // Apply pattern to LED controller (if mode mapping exists)
-        // LEDController::setFrontMode((LEDController::FrontMode)selectedPattern);
-
-        Logger::infof("LED pattern selected: %s", PATTERN_NAMES[i]);
-      }
-      break;
-    }
+    bool selected = (i == selectedPattern);
+    patternButtons[i].setStyle(faceStyle(selected ? COLOR_SELECTED
+                                                  : TFT_DARKGREY,
+                                         selected ? COLOR_BG : COLOR_TEXT, 1,
+                                         true));
   }
+
+  auto &cfg = LEDController::getConfig();
+  brightnessSlider.setValue(cfg.brightness);
+  brightnessValue.setValue((cfg.brightness * 100) / 255);
+
+  hueBar.setValue(colorPickerH);
+  Style swatch = faceStyle(hueToRGB565(colorPickerH), COLOR_TEXT, 2, true);
+  swatch.radius = 0;
+  colorSwatch.setStyle(swatch);
+  preview.setValue(selectedPattern);
 }
 
-void MenuLEDControl::handleBrightnessSlider(int16_t x, int16_t y) {
-  if (y >= BRIGHTNESS_Y && y <= BRIGHTNESS_Y + SLIDER_H && x >= SLIDER_X &&
-      x <= SLIDER_X + SLIDER_W) {
+void MenuLEDControl::init() {
+  loadSettings();
+  visible = false;
+  Logger::info("MenuLEDControl: initialized");
+}
 
-    int newBrightness = ((uint32_t)(x - SLIDER_X) * 255) / SLIDER_W;
-    newBrightness = constrain(newBrightness, 0, 255);
+void MenuLEDControl::update() {
+  if (!visible) return;
 
-    LEDController::setBrightness(newBrightness);
-    needsRedraw = true;
+  // Periodic redraw of preview
+  if (millis() - lastPreviewUpdate > PREVIEW_PERIOD_MS) {
+    lastPreviewUpdate = millis();
+    preview.invalidate();
+    draw();
   }
 }
 
-void MenuLEDControl::handleSpeedSlider(int16_t x, int16_t y) {
-  if (y >= SPEED_Y && y <= SPEED_Y + SLIDER_H && x >= SLIDER_X &&
-      x <= SLIDER_X + SLIDER_W) {
+void MenuLEDControl::draw() {
+  if (!visible || !built) return;
+  render(screen, tft);
+}
+
+void MenuLEDControl::handleTouch(int16_t x, int16_t y) {
+  if (!visible) return;
+
+  Widget *hit = screen.hitTest(x, y);
+  if (hit == nullptr) return;
+
+  // Check pattern selection
+  for (int i = 0; i < NUM_PATTERNS; i++) {
+    if (hit != &patternButtons[i]) continue;
+    if (selectedPattern != i) {
+      selectedPattern = i;
+      syncWidgets();
+
+      // Apply pattern to LED controller (if mode mapping exists)
+      // LEDController::setFrontMode((LEDController::FrontMode)selectedPattern);
 
-    // Speed would be stored and applied similarly
-    needsRedraw = true;
+      Logger::infof("LED pattern selected: %s", PATTERN_NAMES[i]);
+    }
+    return;
   }
-}
 
-void MenuLEDControl::handleColorPicker(int16_t x, int16_t y) {
-  if (y >= COLOR_Y && y <= COLOR_Y + SLIDER_H && x >= SLIDER_X &&
-      x <= SLIDER_X + SLIDER_W) {
+  // Check brightness slider
+  if (hit == &brightnessSlider) {
+    if (brightnessSlider.touch(x, y)) {
+      LEDController::setBrightness(brightnessSlider.value());
+      syncWidgets();
+    }
+    return;
+  }
 
-    colorPickerH = ((uint32_t)(x - SLIDER_X) * 255) / SLIDER_W;
-    colorPickerH = constrain(colorPickerH, 0, 255);
-    needsRedraw = true;
+  // Check color picker (marker area below the bar included)
+  if (hit == &hueBar) {
+    int16_t offset = x - SLIDER_X;
+    if (offset < 0) offset = 0;
+    if (offset > SLIDER_W) offset = SLIDER_W;
+    colorPickerH = ((uint32_t)offset * 255) / SLIDER_W;
+    syncWidgets();
+    return;
+  }
+
+  // Check control buttons
+  if (hit == &saveButton) {
+    saveSettings();
+    Alerts::play({Audio::AUDIO_MODULO_OK, Audio::Priority::PRIO_HIGH});
+  } else if (hit == &backButton) {
+    hide();
   }
 }
 
+void MenuLEDControl::show() {
+  visible = true;
+  loadSettings();
+  if (!built) buildScreen();
+  syncWidgets();
+  screen.invalidateAll();
+  draw();
+  Logger::info("MenuLEDControl: shown");
+}
+
+void MenuLEDControl::hide() {
+  visible = false;
+  logStats("LEDControl", screen);
+  Logger::info("MenuLEDControl: hidden");
+}
+
+bool MenuLEDControl::isVisible() { return visible; }
+
 void MenuLEDControl::saveSettings() {
-  auto &config = ConfigStorage::getCurrentConfig();
+  auto &config = ConfigStore::leds();
   auto &ledCfg = LEDController::getConfig();
 
-  config.led_pattern = selectedPattern;
-  config.led_brightness = ledCfg.brightness;
-  // config.led_speed = speed;  // Would need to track this
-  config.led_color = (colorPickerH << 16) | (colorPickerS << 8) | 255;
+  config.pattern = selectedPattern;
+  config.brightness = ledCfg.brightness;
+  // config.speed = speed;  // Would need to track this
+  config.color = (colorPickerH << 16) | (colorPickerS << 8) | 255;
 
-  ConfigStorage::save(config);
+  ConfigStore::commit(ConfigStore::SECTION_LEDS);
   Logger::info("LED settings saved");
 }
 
 void MenuLEDControl::loadSettings() {
-  auto &config = ConfigStorage::getCurrentConfig();
+  auto &config = ConfigStore::leds();
 
-  selectedPattern = config.led_pattern;
-  LEDController::setBrightness(config.led_brightness);
-  colorPickerH = (config.led_color >> 16) & 0xFF;
-  colorPickerS = (config.led_color >> 8) & 0xFF;
+  selectedPattern = config.pattern;
+  LEDController::setBrightness(config.brightness);
+  colorPickerH = (config.color >> 16) & 0xFF;
+  colorPickerS = (config.color >> 8) & 0xFF;
 
   Logger::info("LED settings loaded");
 }
@@ -5,16 +5,18 @@
 
 #include "menu_power_config.h"
 #include "alerts.h"
-#include "config_storage.h"
+#include "config_store.h"
+#include "hud_widgets.h"
 #include "logger.h"
 #include "relays.h"
 #include <TFT_eSPI.h>
 
+using namespace HudWidgets;
+
 // Forward declaration of TFT instance (shared with HUD)
 extern TFT_eSPI *tft;
 
 // Static member definitions
-bool MenuPowerConfig::needsRedraw = true;
 uint16_t MenuPowerConfig::powerHoldDelay = 5000;
 uint16_t MenuPowerConfig::aux12VDelay = 100;
 uint16_t MenuPowerConfig::traction24VDelay = 500;
@@ -31,239 +33,267 @@ static const uint16_t COLOR_DANGER = TFT_RED;
 static const uint16_t COLOR_INACTIVE = TFT_DARKGREY;
 
 // Layout constants
-static const uint16_t HEADER_Y = 10;
-static const uint16_t SLIDER_Y_START = 55;
-static const uint16_t SLIDER_SPACING = 55;
-static const uint16_t TEST_BTN_Y = 195;
-static const uint16_t ACTION_BTN_Y = 265;
-
-void MenuPowerConfig::init() {
-  // Load current configuration
-  auto &config = ConfigStorage::getCurrentConfig();
-  powerHoldDelay = config.power_hold_delay;
-  aux12VDelay = config.aux_delay;
-  traction24VDelay = config.traction_delay;
-
-  activeTest = 0;
-  testStartTime = 0;
-  needsRedraw = true;
-
-  Logger::info("MenuPowerConfig: initialized");
+static const int16_t HEADER_Y = 10;
+static const int16_t SLIDER_Y_START = 55;
+static const int16_t SLIDER_SPACING = 55;
+static const int16_t TEST_BTN_Y = 195;
+static const int16_t STATUS_Y = TEST_BTN_Y + 43;
+static const int16_t ACTION_BTN_Y = 265;
+static const int16_t LABEL_X = 10;
+static const int16_t SLIDER_X = 120;
+static const int16_t SLIDER_W = 240;
+static const int16_t SLIDER_H = 20;
+static const int16_t VALUE_X = SLIDER_X + SLIDER_W + 5;
+static const int16_t BUTTON_H = 40;
+
+// Slider ranges (ms) and touch steps
+struct SliderRange {
+  const char *label;
+  int32_t min, max, step;
+};
+static const SliderRange SLIDER_RANGES[3] = {
+    {"Power Hold:", 100, 10000, 100},
+    {"12V Aux:", 10, 2000, 10},
+    {"24V Traction:", 100, 5000, 100},
+};
+
+static const char *const TEST_LABELS[4] = {"PWR", "12V", "24V", "ALL OFF"};
+static const uint16_t TEST_ACTIVE_COLORS[3] = {COLOR_ACTIVE, COLOR_WARNING,
+                                               COLOR_DANGER};
+static const char *const RELAY_LABELS[4] = {"Main", "Steer", "Traction",
+                                            "Lights"};
+
+// Widget tree
+static Screen screen(COLOR_BG);
+static Label title({0, HEADER_Y, 480, 26}, "POWER CONFIGURATION");
+static Frame rule({20, 42, 440, 1});
+static Label sliderLabels[3] = {
+    Label({LABEL_X, SLIDER_Y_START, SLIDER_X - LABEL_X - 2, SLIDER_H},
+          SLIDER_RANGES[0].label),
+    Label({LABEL_X, SLIDER_Y_START + SLIDER_SPACING, SLIDER_X - LABEL_X - 2,
+           SLIDER_H},
+          SLIDER_RANGES[1].label),
+    Label({LABEL_X, SLIDER_Y_START + 2 * SLIDER_SPACING,
+           SLIDER_X - LABEL_X - 2, SLIDER_H},
+          SLIDER_RANGES[2].label)};
+static Slider sliders[3] = {
+    Slider({SLIDER_X, SLIDER_Y_START, SLIDER_W, SLIDER_H},
+           SLIDER_RANGES[0].min, SLIDER_RANGES[0].max, SLIDER_RANGES[0].step),
+    Slider({SLIDER_X, SLIDER_Y_START + SLIDER_SPACING, SLIDER_W, SLIDER_H},
+           SLIDER_RANGES[1].min, SLIDER_RANGES[1].max, SLIDER_RANGES[1].step),
+    Slider({SLIDER_X, SLIDER_Y_START + 2 * SLIDER_SPACING, SLIDER_W, SLIDER_H},
+           SLIDER_RANGES[2].min, SLIDER_RANGES[2].max, SLIDER_RANGES[2].step)};
+static ValueField sliderValues[3] = {
+    ValueField({VALUE_X, SLIDER_Y_START, 105, SLIDER_H}, "%ld ms"),
+    ValueField({VALUE_X, SLIDER_Y_START + SLIDER_SPACING, 105, SLIDER_H},
+               "%ld ms"),
+    ValueField({VALUE_X, SLIDER_Y_START + 2 * SLIDER_SPACING, 105, SLIDER_H},
+               "%ld ms")};
+static Label testTitle({LABEL_X, TEST_BTN_Y, 88, BUTTON_H}, "Test Relays:");
+static Button testButtons[4] = {
+    Button({100, TEST_BTN_Y, 80, BUTTON_H}, TEST_LABELS[0]),
+    Button({190, TEST_BTN_Y, 80, BUTTON_H}, TEST_LABELS[1]),
+    Button({280, TEST_BTN_Y, 80, BUTTON_H}, TEST_LABELS[2]),
+    Button({370, TEST_BTN_Y, 100, BUTTON_H}, TEST_LABELS[3])};
+static Indicator relayDots[4] = {Indicator({103, STATUS_Y, 15, 15}),
+                                 Indicator({173, STATUS_Y, 15, 15}),
+                                 Indicator({243, STATUS_Y, 15, 15}),
+                                 Indicator({323, STATUS_Y, 15, 15})};
+static Label relayLabels[4] = {Label({120, STATUS_Y, 50, 15}, RELAY_LABELS[0]),
+                               Label({190, STATUS_Y, 50, 15}, RELAY_LABELS[1]),
+                               Label({260, STATUS_Y, 60, 15}, RELAY_LABELS[2]),
+                               Label({340, STATUS_Y, 50, 15}, RELAY_LABELS[3])};
+static Label testStatus({395, STATUS_Y, 80, 15});
+static Button saveButton({20, ACTION_BTN_Y, 120, BUTTON_H}, "SAVE");
+static Button resetButton({170, ACTION_BTN_Y, 120, BUTTON_H}, "RESET");
+static Button backButton({340, ACTION_BTN_Y, 120, BUTTON_H}, "BACK");
+static bool built = false;
+
+static Style textStyle(uint16_t fg, uint8_t font, Align align) {
+  Style s;
+  s.fg = fg;
+  s.bg = COLOR_BG;
+  s.font = font;
+  s.align = align;
+  return s;
 }
 
-void MenuPowerConfig::update() {
-  // Check if test should auto-stop after 3 seconds
-  if (activeTest != 0 && (millis() - testStartTime > 3000)) {
-    stopAllTests();
-    needsRedraw = true;
-  }
-}
-
-void MenuPowerConfig::draw() {
-  if (!needsRedraw) return;
-  needsRedraw = false;
-
-  // Note: TFT is a global extern object initialized in HUDManager::init()
-  // By the time this menu is accessed, TFT is guaranteed to be initialized
-  // If called prematurely during boot, the worst case is a visual glitch
-
-  tft->fillScreen(COLOR_BG);
-
-  // Header
-  tft->setTextDatum(TC_DATUM);
-  tft->setTextColor(COLOR_ACCENT, COLOR_BG);
-  tft->drawString("POWER CONFIGURATION", 240, HEADER_Y, 4);
-
-  tft->drawLine(20, 42, 460, 42, TFT_DARKGREY);
-
-  // Draw sliders
-  drawSlider(SLIDER_X, SLIDER_Y_START, "Power Hold:", powerHoldDelay, 100,
-             10000);
-  drawSlider(SLIDER_X, SLIDER_Y_START + SLIDER_SPACING, "12V Aux:", aux12VDelay,
-             10, 2000);
-  drawSlider(SLIDER_X, SLIDER_Y_START + 2 * SLIDER_SPACING,
-             "24V Traction:", traction24VDelay, 100, 5000);
-
-  drawTestButtons();
-  drawActionButtons();
-  drawCurrentValues();
+static Style buttonStyle(uint16_t face, uint16_t text, bool outlined) {
+  Style s = textStyle(text, 2, Align::CENTER);
+  s.accent = face;
+  s.border = COLOR_TEXT;
+  s.radius = 5;
+  s.outlined = outlined;
+  return s;
 }
 
-void MenuPowerConfig::handleTouch(uint16_t x, uint16_t y) {
-  // Check sliders
-  if (handleSliderTouch(x, y, SLIDER_Y_START, powerHoldDelay, 100, 10000)) {
-    needsRedraw = true;
-    return;
-  }
-  if (handleSliderTouch(x, y, SLIDER_Y_START + SLIDER_SPACING, aux12VDelay, 10,
-                        2000)) {
-    needsRedraw = true;
-    return;
-  }
-  if (handleSliderTouch(x, y, SLIDER_Y_START + 2 * SLIDER_SPACING,
-                        traction24VDelay, 100, 5000)) {
-    needsRedraw = true;
-    return;
+void MenuPowerConfig::buildScreen() {
+  title.setStyle(textStyle(COLOR_ACCENT, 4, Align::CENTER));
+  Style ruleStyle;
+  ruleStyle.border = COLOR_INACTIVE;
+  rule.setStyle(ruleStyle);
+  screen.add(title);
+  screen.add(rule);
+
+  Style sliderStyle;
+  sliderStyle.bg = COLOR_BG;
+  sliderStyle.border = COLOR_TEXT;
+  sliderStyle.radius = 5;
+  Style valueStyle = textStyle(COLOR_TEXT, 2, Align::RIGHT);
+  for (uint8_t i = 0; i < 3; i++) {
+    sliderLabels[i].setStyle(textStyle(COLOR_TEXT, 2, Align::LEFT));
+    sliders[i].setStyle(sliderStyle);
+    sliders[i].setTrack(COLOR_INACTIVE);
+    sliderValues[i].setStyle(valueStyle);
+    screen.add(sliderLabels[i]);
+    screen.add(sliders[i]);
+    screen.add(sliderValues[i]);
   }
 
-  // Check test buttons - buttons are drawn at X = 100 + i * 90 (100, 190, 280,
-  // 370)
-  if (y >= TEST_BTN_Y && y <= TEST_BTN_Y + 45) {
-    for (int i = 0; i < 4; i++) {
-      int btnX = 100 + i * 90;
-      int btnW = (i == 3) ? 100 : 80;
-      if (x >= btnX && x <= btnX + btnW) {
-        if (i == 3) {
-          stopAllTests();
-          needsRedraw = true;
-        } else {
-          handleTestButton(i + 1);
-        }
-        break;
-      }
-    }
-  }
+  testTitle.setStyle(textStyle(COLOR_TEXT, 1, Align::LEFT));
+  screen.add(testTitle);
+  for (uint8_t i = 0; i < 4; i++) screen.add(testButtons[i]);
 
-  // Check action buttons
-  if (y >= ACTION_BTN_Y && y <= ACTION_BTN_Y + BUTTON_HEIGHT) {
-    if (x >= 20 && x <= 140) {
-      saveConfiguration();
-    } else if (x >= 170 && x <= 290) {
-      resetToDefaults();
-    } else if (x >= 340 && x <= 460) {
-      // Back - handled by parent menu
-      stopAllTests();
-    }
+  for (uint8_t i = 0; i < 4; i++) {
+    relayLabels[i].setStyle(textStyle(COLOR_TEXT, 1, Align::LEFT));
+    screen.add(relayDots[i]);
+    screen.add(relayLabels[i]);
   }
+  testStatus.setStyle(textStyle(COLOR_ACTIVE, 1, Align::LEFT));
+  screen.add(testStatus);
+
+  saveButton.setStyle(buttonStyle(COLOR_ACTIVE, COLOR_BG, false));
+  resetButton.setStyle(buttonStyle(COLOR_WARNING, COLOR_BG, false));
+  backButton.setStyle(buttonStyle(COLOR_INACTIVE, COLOR_TEXT, false));
+  screen.add(saveButton);
+  screen.add(resetButton);
+  screen.add(backButton);
+  built = true;
 }
 
-void MenuPowerConfig::drawSlider(uint16_t x, uint16_t y, const char *label,
-                                 uint16_t value, uint16_t min, uint16_t max) {
-  // Draw label
-  tft->setTextDatum(TL_DATUM);
-  tft->setTextColor(COLOR_TEXT, COLOR_BG);
-  tft->drawString(label, LABEL_X, y + 5, 2);
-
-  // Draw slider background
-  tft->fillRoundRect(x, y, SLIDER_WIDTH, SLIDER_HEIGHT, 5, COLOR_INACTIVE);
-
-  // Calculate fill width
-  uint16_t fillWidth = ((uint32_t)(value - min) * SLIDER_WIDTH) / (max - min);
-  fillWidth = constrain(fillWidth, 0, SLIDER_WIDTH);
-
-  // Draw filled portion with color based on value
-  uint16_t fillColor = COLOR_ACTIVE;
-  if (value > (max * 2 / 3)) fillColor = COLOR_WARNING;
-  if (value > (max * 9 / 10)) fillColor = COLOR_DANGER;
-
-  tft->fillRoundRect(x, y, fillWidth, SLIDER_HEIGHT, 5, fillColor);
-
-  // Draw border
-  tft->drawRoundRect(x, y, SLIDER_WIDTH, SLIDER_HEIGHT, 5, COLOR_TEXT);
-
-  // Draw value
-  char valueStr[16];
-  snprintf(valueStr, sizeof(valueStr), "%d ms", value);
-  tft->setTextDatum(TR_DATUM);
-  tft->setTextColor(COLOR_TEXT, COLOR_BG);
-  tft->drawString(valueStr, x + SLIDER_WIDTH + 80, y + 5, 2);
+// Slider positions, value fields and fill colours from the delays
+void MenuPowerConfig::syncSliders() {
+  const uint16_t values[3] = {powerHoldDelay, aux12VDelay, traction24VDelay};
+  for (uint8_t i = 0; i < 3; i++) {
+    sliders[i].setValue(values[i]);
+    sliderValues[i].setValue(values[i]);
+
+    // Fill color based on value
+    int32_t max = SLIDER_RANGES[i].max;
+    uint16_t fillColor = COLOR_ACTIVE;
+    if (values[i] > (max * 2 / 3)) fillColor = COLOR_WARNING;
+    if (values[i] > (max * 9 / 10)) fillColor = COLOR_DANGER;
+    sliders[i].setAccent(fillColor);
+  }
 }
 
-void MenuPowerConfig::drawTestButtons() {
-  const char *labels[] = {"PWR", "12V", "24V", "ALL OFF"};
-  uint16_t colors[] = {(activeTest == 1) ? COLOR_ACTIVE : COLOR_INACTIVE,
-                       (activeTest == 2) ? COLOR_WARNING : COLOR_INACTIVE,
-                       (activeTest == 3) ? COLOR_DANGER : COLOR_INACTIVE,
-                       TFT_DARKGREY};
-
-  tft->setTextDatum(TL_DATUM);
-  tft->setTextColor(COLOR_TEXT, COLOR_BG);
-  tft->drawString("Test Relays:", LABEL_X, TEST_BTN_Y + 10, 2);
-
-  for (int i = 0; i < 4; i++) {
-    uint16_t btnX = 100 + i * 90;
-    uint16_t btnW = (i == 3) ? 100 : 80;
-
-    tft->fillRoundRect(btnX, TEST_BTN_Y, btnW, 40, 5, colors[i]);
-    tft->drawRoundRect(btnX, TEST_BTN_Y, btnW, 40, 5, COLOR_TEXT);
-
-    tft->setTextDatum(MC_DATUM);
-    tft->setTextColor((activeTest == i + 1 && i < 3) ? COLOR_BG : COLOR_TEXT,
-                      colors[i]);
-    tft->drawString(labels[i], btnX + btnW / 2, TEST_BTN_Y + 20, 2);
+void MenuPowerConfig::syncTestButtons() {
+  for (uint8_t i = 0; i < 4; i++) {
+    bool active = (i < 3 && activeTest == i + 1);
+    Style s = buttonStyle(active ? TEST_ACTIVE_COLORS[i] : COLOR_INACTIVE,
+                          active ? COLOR_BG : COLOR_TEXT, true);
+    testButtons[i].setStyle(s);
   }
 
   // Test status indicator
   if (activeTest > 0) {
     uint32_t elapsed = (millis() - testStartTime) / 1000;
-    char statusStr[32];
+    char statusStr[24];
     snprintf(statusStr, sizeof(statusStr), "Testing... %lus",
              (unsigned long)elapsed);
-    tft->setTextDatum(TL_DATUM);
-    tft->setTextColor(COLOR_ACTIVE, COLOR_BG);
-    tft->drawString(statusStr, 100, TEST_BTN_Y + 45, 1);
+    testStatus.setText(statusStr);
+  } else {
+    testStatus.setText("");
   }
 }
 
-void MenuPowerConfig::drawActionButtons() {
-  // Save button
-  tft->fillRoundRect(20, ACTION_BTN_Y, 120, BUTTON_HEIGHT, 5, COLOR_ACTIVE);
-  tft->setTextDatum(MC_DATUM);
-  tft->setTextColor(COLOR_BG, COLOR_ACTIVE);
-  tft->drawString("SAVE", 80, ACTION_BTN_Y + BUTTON_HEIGHT / 2, 2);
-
-  // Reset button
-  tft->fillRoundRect(170, ACTION_BTN_Y, 120, BUTTON_HEIGHT, 5, COLOR_WARNING);
-  tft->setTextColor(COLOR_BG, COLOR_WARNING);
-  tft->drawString("RESET", 230, ACTION_BTN_Y + BUTTON_HEIGHT / 2, 2);
-
-  // Back button
-  tft->fillRoundRect(340, ACTION_BTN_Y, 120, BUTTON_HEIGHT, 5, TFT_DARKGREY);
-  tft->setTextColor(COLOR_TEXT, TFT_DARKGREY);
-  tft->drawString("BACK", 400, ACTION_BTN_Y + BUTTON_HEIGHT / 2, 2);
+void MenuPowerConfig::syncRelayStatus() {
+  const auto &relayState = Relays::get();
+  const bool on[4] = {relayState.mainOn, relayState.steeringOn,
+                      relayState.tractionOn, relayState.lightsOn};
+  const uint16_t onColor[4] = {COLOR_ACTIVE, COLOR_ACTIVE, COLOR_ACTIVE,
+                               COLOR_WARNING};
+  const uint16_t offColor[4] = {COLOR_DANGER, COLOR_INACTIVE, COLOR_INACTIVE,
+                                COLOR_INACTIVE};
+  for (uint8_t i = 0; i < 4; i++) {
+    relayDots[i].setAccent(on[i] ? onColor[i] : offColor[i]);
+  }
 }
 
-void MenuPowerConfig::drawCurrentValues() {
-  // Current relay states
-  auto relayState = Relays::get();
-
-  tft->setTextDatum(TL_DATUM);
-  tft->setTextColor(COLOR_TEXT, COLOR_BG);
+void MenuPowerConfig::init() {
+  // Load current configuration
+  const auto &config = ConfigStore::power();
+  powerHoldDelay = config.holdDelayMs;
+  aux12VDelay = config.auxDelayMs;
+  traction24VDelay = config.tractionDelayMs;
 
-  // Draw status indicators
-  int statusY = TEST_BTN_Y + 50;
+  activeTest = 0;
+  testStartTime = 0;
 
-  // Power Hold status
-  tft->fillCircle(110, statusY, 6,
-                  relayState.mainOn ? COLOR_ACTIVE : COLOR_DANGER);
-  tft->drawString("Main", 120, statusY - 6, 1);
+  if (!built) buildScreen();
+  syncSliders();
+  syncTestButtons();
+  syncRelayStatus();
+  screen.invalidateAll();
 
-  // 12V Aux status
-  tft->fillCircle(180, statusY, 6,
-                  relayState.steeringOn ? COLOR_ACTIVE : COLOR_INACTIVE);
-  tft->drawString("Steer", 190, statusY - 6, 1);
+  Logger::info("MenuPowerConfig: initialized");
+}
 
-  // 24V Traction status
-  tft->fillCircle(250, statusY, 6,
-                  relayState.tractionOn ? COLOR_ACTIVE : COLOR_INACTIVE);
-  tft->drawString("Traction", 260, statusY - 6, 1);
+void MenuPowerConfig::update() {
+  // Check if test should auto-stop after 3 seconds
+  if (activeTest != 0 && (millis() - testStartTime > 3000)) {
+    stopAllTests();
+  }
+  // Only the widgets whose state changed are redrawn
+  syncTestButtons();
+  syncRelayStatus();
+}
 
-  // Lights status
-  tft->fillCircle(330, statusY, 6,
-                  relayState.lightsOn ? COLOR_WARNING : COLOR_INACTIVE);
-  tft->drawString("Lights", 340, statusY - 6, 1);
+void MenuPowerConfig::draw() {
+  // Note: TFT is a global extern object initialized in HUDManager::init()
+  // By the time this menu is accessed, TFT is guaranteed to be initialized
+  // If called prematurely during boot, the worst case is a visual glitch
+  if (!built) return;
+  render(screen, tft);
 }
 
-bool MenuPowerConfig::handleSliderTouch(uint16_t x, uint16_t y,
-                                        uint16_t sliderY, uint16_t &value,
-                                        uint16_t min, uint16_t max) {
-  if (y >= sliderY && y <= sliderY + SLIDER_HEIGHT && x >= SLIDER_X &&
-      x <= SLIDER_X + SLIDER_WIDTH) {
+void MenuPowerConfig::handleTouch(uint16_t x, uint16_t y) {
+  Widget *hit = screen.hitTest(x, y);
+  if (hit == nullptr) return;
+
+  // Sliders
+  uint16_t *delays[3] = {&powerHoldDelay, &aux12VDelay, &traction24VDelay};
+  for (uint8_t i = 0; i < 3; i++) {
+    if (hit != &sliders[i]) continue;
+    if (sliders[i].touch(x, y)) {
+      *delays[i] = static_cast<uint16_t>(sliders[i].value());
+      syncSliders();
+    }
+    return;
+  }
 
-    value = mapTouchToValue(x, min, max);
-    return true;
+  // Test buttons
+  for (uint8_t i = 0; i < 4; i++) {
+    if (hit != &testButtons[i]) continue;
+    if (i == 3) {
+      stopAllTests();
+    } else {
+      handleTestButton(i + 1);
+    }
+    syncTestButtons();
+    return;
+  }
+
+  // Action buttons
+  if (hit == &saveButton) {
+    saveConfiguration();
+  } else if (hit == &resetButton) {
+    resetToDefaults();
+  } else if (hit == &backButton) {
+    // Back - handled by parent menu
+    stopAllTests();
+    logStats("PowerConfig", screen);
   }
-  return false;
 }
 
 void MenuPowerConfig::handleTestButton(uint8_t testId) {
@@ -278,7 +308,6 @@ void MenuPowerConfig::handleTestButton(uint8_t testId) {
     testRelay(testId);
     Alerts::play({Audio::AUDIO_MODULO_OK, Audio::Priority::PRIO_NORMAL});
   }
-  needsRedraw = true;
 }
 
 void MenuPowerConfig::stopAllTests() {
@@ -289,29 +318,28 @@ void MenuPowerConfig::stopAllTests() {
 }
 
 void MenuPowerConfig::saveConfiguration() {
-  auto &config = ConfigStorage::getCurrentConfig();
-  config.power_hold_delay = powerHoldDelay;
-  config.aux_delay = aux12VDelay;
-  config.traction_delay = traction24VDelay;
+  auto &config = ConfigStore::power();
+  config.holdDelayMs = powerHoldDelay;
+  config.auxDelayMs = aux12VDelay;
+  config.tractionDelayMs = traction24VDelay;
 
-  ConfigStorage::save(config);
+  ConfigStore::commit(ConfigStore::SECTION_POWER);
 
   Alerts::play({Audio::AUDIO_MODULO_OK, Audio::Priority::PRIO_HIGH});
   Logger::infof("Power config saved: hold=%d, aux=%d, trac=%d", powerHoldDelay,
                 aux12VDelay, traction24VDelay);
-
-  needsRedraw = true;
 }
 
 void MenuPowerConfig::resetToDefaults() {
-  powerHoldDelay = ConfigStorage::DEFAULT_CONFIG.power_hold_delay;
-  aux12VDelay = ConfigStorage::DEFAULT_CONFIG.aux_delay;
-  traction24VDelay = ConfigStorage::DEFAULT_CONFIG.traction_delay;
+  const auto &defaults = ConfigStore::defaults().power;
+  powerHoldDelay = defaults.holdDelayMs;
+  aux12VDelay = defaults.auxDelayMs;
+  traction24VDelay = defaults.tractionDelayMs;
 
   Alerts::play({Audio::AUDIO_MODULO_OK, Audio::Priority::PRIO_NORMAL});
   Logger::info("Power config reset to defaults");
 
-  needsRedraw = true;
+  syncSliders();
 }
 
 void MenuPowerConfig::testRelay(uint8_t relayId) {
@@ -328,29 +356,3 @@ void MenuPowerConfig::testRelay(uint8_t relayId) {
     break;
   }
 }
-
-uint16_t MenuPowerConfig::mapTouchToValue(uint16_t touchX, uint16_t min,
-                                          uint16_t max) {
-  // 🔒 CRITICAL FIX: Validate inputs to prevent division by zero and invalid
-  // ranges
-  if (max <= min) {
-    Logger::errorf("MenuPowerConfig: Invalid range min=%u max=%u", min, max);
-    return min; // Safe fallback
-  }
-
-  if (touchX <= SLIDER_X) return min;
-  if (touchX >= SLIDER_X + SLIDER_WIDTH) return max;
-
-  uint32_t value =
-      ((uint32_t)(touchX - SLIDER_X) * (max - min)) / SLIDER_WIDTH + min;
-
-  // Round to nearest step size based on range for cleaner values
-  // Use 100ms steps for ms values, 10 steps otherwise
-  uint16_t range = max - min;
-  uint16_t stepSize = (range >= 1000) ? 100 : ((range >= 100) ? 10 : 1);
-  uint16_t halfStep =
-      (stepSize + 1) / 2; // Ensure at least 1 for proper rounding
-  value = ((value + halfStep) / stepSize) * stepSize;
-
-  return constrain(value, min, max);
-}
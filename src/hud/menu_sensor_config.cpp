@@ -1,14 +1,12 @@
-/**
- * @file menu_sensor_config.cpp
- * @brief Sensor enable/disable configuration menu for emergency bypass
- */
-
 #include "menu_sensor_config.h"
 #include "alerts.h"
-#include "config_storage.h"
+#include "config_store.h"
+#include "hud_widgets.h"
 #include "logger.h"
 #include <TFT_eSPI.h>
 
+using namespace HudWidgets;
+
 // Forward declaration of TFT instance (shared with HUD)
 extern TFT_eSPI *tft;
 
@@ -18,28 +16,9 @@ bool MenuSensorConfig::sensorFR = true;
 bool MenuSensorConfig::sensorRL = true;
 bool MenuSensorConfig::sensorRR = true;
 bool MenuSensorConfig::sensorINA226 = true;
-bool MenuSensorConfig::needsRedraw = true;
 uint32_t MenuSensorConfig::lastSaveTime = 0;
 uint32_t MenuSensorConfig::lastResetTime = 0;
 
-// Button definitions
-const MenuSensorConfig::Button MenuSensorConfig::btnSensorFL = {340, 60, 100,
-                                                                35, "FL"};
-const MenuSensorConfig::Button MenuSensorConfig::btnSensorFR = {340, 100, 100,
-                                                                35, "FR"};
-const MenuSensorConfig::Button MenuSensorConfig::btnSensorRL = {340, 140, 100,
-                                                                35, "RL"};
-const MenuSensorConfig::Button MenuSensorConfig::btnSensorRR = {340, 180, 100,
-                                                                35, "RR"};
-const MenuSensorConfig::Button MenuSensorConfig::btnINA226 = {340, 220, 100, 35,
-                                                              "INA"};
-const MenuSensorConfig::Button MenuSensorConfig::btnSave = {20, 270, 120, 40,
-                                                            "SAVE"};
-const MenuSensorConfig::Button MenuSensorConfig::btnReset = {170, 270, 120, 40,
-                                                             "RESET"};
-const MenuSensorConfig::Button MenuSensorConfig::btnBack = {340, 270, 120, 40,
-                                                            "BACK"};
-
 // Colors
 static const uint16_t COLOR_BG = TFT_BLACK;
 static const uint16_t COLOR_TEXT = TFT_WHITE;
@@ -49,9 +28,144 @@ static const uint16_t COLOR_DISABLED = TFT_RED;
 static const uint16_t COLOR_WARNING = TFT_YELLOW;
 static const uint16_t COLOR_INACTIVE = TFT_DARKGREY;
 
+// Layout: one row per sensor (dot, name, toggle)
+static const int16_t ROW_H = 32;
+static const int16_t TOGGLE_X = 340;
+static const int16_t TOGGLE_W = 100;
+static const int16_t STATUS_Y = 257;
+static const int16_t ACTION_Y = 278;
+static const int16_t ACTION_H = 38;
+static const int NUM_SENSORS = 5; // FL, FR, RL, RR, INA226
+
+static constexpr int16_t ROW_Y[NUM_SENSORS] = {62, 98, 134, 170, 224};
+static const char *const ROW_LABELS[NUM_SENSORS] = {
+    "Front Left (FL)", "Front Right (FR)", "Rear Left (RL)", "Rear Right (RR)",
+    "INA226 Monitors"};
+static const char *const ROW_LOG_NAMES[NUM_SENSORS] = {
+    "Sensor FL", "Sensor FR", "Sensor RL", "Sensor RR", "INA226 sensors"};
+
+// Widget tree
+static Screen screen(COLOR_BG);
+static Label title({0, 10, 480, 26}, "SENSOR CONFIGURATION");
+static Frame rule({20, 42, 440, 1});
+static Label wheelTitle({20, 45, 200, 16}, "Wheel Sensors:");
+static Label currentTitle({20, 206, 200, 16}, "Current Sensors:");
+static Indicator rowDots[NUM_SENSORS] = {
+    Indicator({16, ROW_Y[0] + 7, 18, 18}),
+    Indicator({16, ROW_Y[1] + 7, 18, 18}),
+    Indicator({16, ROW_Y[2] + 7, 18, 18}),
+    Indicator({16, ROW_Y[3] + 7, 18, 18}),
+    Indicator({16, ROW_Y[4] + 7, 18, 18})};
+static Label rowLabels[NUM_SENSORS] = {
+    Label({40, ROW_Y[0], 280, ROW_H}, ROW_LABELS[0]),
+    Label({40, ROW_Y[1], 280, ROW_H}, ROW_LABELS[1]),
+    Label({40, ROW_Y[2], 280, ROW_H}, ROW_LABELS[2]),
+    Label({40, ROW_Y[3], 280, ROW_H}, ROW_LABELS[3]),
+    Label({40, ROW_Y[4], 280, ROW_H}, ROW_LABELS[4])};
+static Toggle rowToggles[NUM_SENSORS] = {
+    Toggle({TOGGLE_X, ROW_Y[0], TOGGLE_W, ROW_H}, COLOR_DISABLED),
+    Toggle({TOGGLE_X, ROW_Y[1], TOGGLE_W, ROW_H}, COLOR_DISABLED),
+    Toggle({TOGGLE_X, ROW_Y[2], TOGGLE_W, ROW_H}, COLOR_DISABLED),
+    Toggle({TOGGLE_X, ROW_Y[3], TOGGLE_W, ROW_H}, COLOR_DISABLED),
+    Toggle({TOGGLE_X, ROW_Y[4], TOGGLE_W, ROW_H}, COLOR_DISABLED)};
+static Label statusLine({20, STATUS_Y, 255, 16});
+static Label warningLine({280, STATUS_Y, 180, 16});
+static Button saveButton({20, ACTION_Y, 120, ACTION_H}, "SAVE");
+static Button resetButton({170, ACTION_Y, 120, ACTION_H}, "RESET");
+static Button backButton({340, ACTION_Y, 120, ACTION_H}, "BACK");
+static bool built = false;
+
+static Style textStyle(uint16_t fg, uint8_t font, Align align) {
+  Style s;
+  s.fg = fg;
+  s.bg = COLOR_BG;
+  s.font = font;
+  s.align = align;
+  return s;
+}
+
+static Style buttonStyle(uint16_t face, uint16_t text) {
+  Style s = textStyle(text, 2, Align::CENTER);
+  s.accent = face;
+  s.border = COLOR_TEXT;
+  s.radius = 5;
+  return s;
+}
+
+void MenuSensorConfig::buildScreen() {
+  title.setStyle(textStyle(COLOR_ACCENT, 4, Align::CENTER));
+  Style ruleStyle;
+  ruleStyle.border = COLOR_INACTIVE;
+  rule.setStyle(ruleStyle);
+  wheelTitle.setStyle(textStyle(COLOR_TEXT, 2, Align::LEFT));
+  currentTitle.setStyle(textStyle(COLOR_TEXT, 2, Align::LEFT));
+  screen.add(title);
+  screen.add(rule);
+  screen.add(wheelTitle);
+  screen.add(currentTitle);
+
+  Style toggleStyle = buttonStyle(COLOR_ENABLED, COLOR_TEXT);
+  for (int i = 0; i < NUM_SENSORS; i++) {
+    rowToggles[i].setStyle(toggleStyle);
+    screen.add(rowDots[i]);
+    screen.add(rowLabels[i]);
+    screen.add(rowToggles[i]);
+  }
+
+  screen.add(statusLine);
+  warningLine.setStyle(textStyle(COLOR_DISABLED, 2, Align::LEFT));
+  screen.add(warningLine);
+
+  backButton.setStyle(buttonStyle(COLOR_INACTIVE, COLOR_TEXT));
+  screen.add(saveButton);
+  screen.add(resetButton);
+  screen.add(backButton);
+  built = true;
+}
+
+void MenuSensorConfig::syncWidgets() {
+  const bool enabled[NUM_SENSORS] = {sensorFL, sensorFR, sensorRL, sensorRR,
+                                     sensorINA226};
+  for (int i = 0; i < NUM_SENSORS; i++) {
+    Style dot = textStyle(COLOR_TEXT, 2, Align::LEFT);
+    dot.accent = enabled[i] ? COLOR_ENABLED : COLOR_DISABLED;
+    rowDots[i].setStyle(dot);
+    rowLabels[i].setStyle(
+        textStyle(enabled[i] ? COLOR_TEXT : COLOR_INACTIVE, 2, Align::LEFT));
+    rowToggles[i].setOn(enabled[i]);
+  }
+
+  int enabledCount = getEnabledCount();
+  char statusStr[48];
+  snprintf(statusStr, sizeof(statusStr), "Status: %d/%d sensors enabled",
+           enabledCount, NUM_SENSORS);
+
+  // Warning thresholds: green=all, yellow=<4, red=<2
+  uint16_t statusColor = COLOR_ENABLED;
+  if (enabledCount < 4)
+    statusColor = COLOR_WARNING; // Show warning earlier (3 or fewer)
+  if (enabledCount < 2) statusColor = COLOR_DISABLED;
+  statusLine.setStyle(textStyle(statusColor, 2, Align::LEFT));
+  statusLine.setText(statusStr);
+
+  // Warning if too few sensors enabled
+  warningLine.setText(enabledCount < 2 ? "WARNING: Unsafe!" : "");
+
+  // Save/reset confirmation
+  bool saved = lastSaveTime > 0;
+  bool reset = lastResetTime > 0;
+  saveButton.setStyle(buttonStyle(saved ? TFT_BLUE : COLOR_ENABLED, COLOR_BG));
+  saveButton.setLabel(saved ? "SAVED!" : "SAVE");
+  resetButton.setStyle(
+      buttonStyle(reset ? TFT_BLUE : COLOR_WARNING, COLOR_BG));
+  resetButton.setLabel(reset ? "RESET!" : "RESET");
+}
+
 void MenuSensorConfig::init() {
   loadConfig();
-  needsRedraw = true;
+  if (!built) buildScreen();
+  syncWidgets();
+  screen.invalidateAll();
   Logger::info("MenuSensorConfig: initialized");
 }
 
@@ -59,243 +173,91 @@ void MenuSensorConfig::update() {
   // Clear save/reset confirmation after 2 seconds
   if (lastSaveTime > 0 && (millis() - lastSaveTime > 2000)) {
     lastSaveTime = 0;
-    needsRedraw = true;
+    syncWidgets();
   }
   if (lastResetTime > 0 && (millis() - lastResetTime > 2000)) {
     lastResetTime = 0;
-    needsRedraw = true;
+    syncWidgets();
   }
 }
 
 void MenuSensorConfig::draw() {
-  if (!needsRedraw) return;
-  needsRedraw = false;
-
-  tft->fillScreen(COLOR_BG);
-
-  // Header
-  tft->setTextDatum(TC_DATUM);
-  tft->setTextColor(COLOR_ACCENT, COLOR_BG);
-  tft->drawString("SENSOR CONFIGURATION", 240, 10, 4);
-
-  tft->drawLine(20, 42, 460, 42, TFT_DARKGREY);
-
-  // Section: Wheel Sensors
-  tft->setTextDatum(TL_DATUM);
-  tft->setTextColor(COLOR_TEXT, COLOR_BG);
-  tft->drawString("Wheel Sensors:", 20, 55, 2);
-
-  // Draw sensor toggle buttons with labels
-  drawToggleWithLabel(btnSensorFL, "Front Left (FL)", sensorFL);
-  drawToggleWithLabel(btnSensorFR, "Front Right (FR)", sensorFR);
-  drawToggleWithLabel(btnSensorRL, "Rear Left (RL)", sensorRL);
-  drawToggleWithLabel(btnSensorRR, "Rear Right (RR)", sensorRR);
-
-  // Section: Current Sensors
-  tft->setTextDatum(TL_DATUM);
-  tft->setTextColor(COLOR_TEXT, COLOR_BG);
-  tft->drawString("Current Sensors:", 20, 215, 2);
-
-  drawToggleWithLabel(btnINA226, "INA226 Monitors", sensorINA226);
-
-  // Draw status bar
-  drawStatusBar();
-
-  // Draw action buttons
-  drawActionButtons();
+  if (!built) return;
+  render(screen, tft);
 }
 
 void MenuSensorConfig::handleTouch(int16_t x, int16_t y) {
-  // Check sensor toggle buttons
-  if (isTouchInButton(x, y, btnSensorFL)) {
-    sensorFL = !sensorFL;
-    needsRedraw = true;
-    Alerts::play({Audio::AUDIO_MODULO_OK, Audio::Priority::PRIO_NORMAL});
-    Logger::infof("Sensor FL %s", sensorFL ? "enabled" : "disabled");
-    return;
-  }
+  Widget *hit = screen.hitTest(x, y);
+  if (hit == nullptr) return;
 
-  if (isTouchInButton(x, y, btnSensorFR)) {
-    sensorFR = !sensorFR;
-    needsRedraw = true;
-    Alerts::play({Audio::AUDIO_MODULO_OK, Audio::Priority::PRIO_NORMAL});
-    Logger::infof("Sensor FR %s", sensorFR ? "enabled" : "disabled");
-    return;
-  }
-
-  if (isTouchInButton(x, y, btnSensorRL)) {
-    sensorRL = !sensorRL;
-    needsRedraw = true;
-    Alerts::play({Audio::AUDIO_MODULO_OK, Audio::Priority::PRIO_NORMAL});
-    Logger::infof("Sensor RL %s", sensorRL ? "enabled" : "disabled");
-    return;
-  }
-
-  if (isTouchInButton(x, y, btnSensorRR)) {
-    sensorRR = !sensorRR;
-    needsRedraw = true;
-    Alerts::play({Audio::AUDIO_MODULO_OK, Audio::Priority::PRIO_NORMAL});
-    Logger::infof("Sensor RR %s", sensorRR ? "enabled" : "disabled");
-    return;
-  }
-
-  if (isTouchInButton(x, y, btnINA226)) {
-    sensorINA226 = !sensorINA226;
-    needsRedraw = true;
+  // Check sensor toggle buttons
+  bool *states[NUM_SENSORS] = {&sensorFL, &sensorFR, &sensorRL, &sensorRR,
+                               &sensorINA226};
+  for (int i = 0; i < NUM_SENSORS; i++) {
+    if (hit != &rowToggles[i]) continue;
+    *states[i] = !*states[i];
+    syncWidgets();
     Alerts::play({Audio::AUDIO_MODULO_OK, Audio::Priority::PRIO_NORMAL});
-    Logger::infof("INA226 sensors %s", sensorINA226 ? "enabled" : "disabled");
+    Logger::infof("%s %s", ROW_LOG_NAMES[i],
+                  *states[i] ? "enabled" : "disabled");
     return;
   }
 
   // Check action buttons
-  if (isTouchInButton(x, y, btnSave)) {
+  if (hit == &saveButton) {
     saveConfig();
     lastSaveTime = millis();
     Alerts::play({Audio::AUDIO_MODULO_OK, Audio::Priority::PRIO_HIGH});
-    needsRedraw = true;
+    syncWidgets();
     return;
   }
 
-  if (isTouchInButton(x, y, btnReset)) {
+  if (hit == &resetButton) {
     resetToDefaults();
     lastResetTime = millis();
     Alerts::play({Audio::AUDIO_MODULO_OK, Audio::Priority::PRIO_NORMAL});
-    needsRedraw = true;
+    syncWidgets();
     return;
   }
 
   // Back button is handled by parent menu
+  if (hit == &backButton) logStats("SensorConfig", screen);
 }
 
 void MenuSensorConfig::loadConfig() {
-  auto &config = ConfigStorage::getCurrentConfig();
-  sensorFL = config.sensorFL_enabled;
-  sensorFR = config.sensorFR_enabled;
-  sensorRL = config.sensorRL_enabled;
-  sensorRR = config.sensorRR_enabled;
-  sensorINA226 = config.ina226_enabled;
+  const auto &config = ConfigStore::sensors();
+  sensorFL = config.wheel[0];
+  sensorFR = config.wheel[1];
+  sensorRL = config.wheel[2];
+  sensorRR = config.wheel[3];
+  sensorINA226 = config.ina226Enabled;
 
   Logger::info("Sensor config loaded");
 }
 
 void MenuSensorConfig::saveConfig() {
-  auto &config = ConfigStorage::getCurrentConfig();
-  config.sensorFL_enabled = sensorFL;
-  config.sensorFR_enabled = sensorFR;
-  config.sensorRL_enabled = sensorRL;
-  config.sensorRR_enabled = sensorRR;
-  config.ina226_enabled = sensorINA226;
-
-  ConfigStorage::save(config);
+  auto &config = ConfigStore::sensors();
+  config.wheel[0] = sensorFL;
+  config.wheel[1] = sensorFR;
+  config.wheel[2] = sensorRL;
+  config.wheel[3] = sensorRR;
+  config.ina226Enabled = sensorINA226;
+
+  ConfigStore::commit(ConfigStore::SECTION_SENSORS);
   Logger::info("Sensor config saved");
 }
 
 void MenuSensorConfig::resetToDefaults() {
-  sensorFL = ConfigStorage::DEFAULT_CONFIG.sensorFL_enabled;
-  sensorFR = ConfigStorage::DEFAULT_CONFIG.sensorFR_enabled;
-  sensorRL = ConfigStorage::DEFAULT_CONFIG.sensorRL_enabled;
-  sensorRR = ConfigStorage::DEFAULT_CONFIG.sensorRR_enabled;
-  sensorINA226 = ConfigStorage::DEFAULT_CONFIG.ina226_enabled;
+  const auto &defaults = ConfigStore::defaults().sensors;
+  sensorFL = defaults.wheel[0];
+  sensorFR = defaults.wheel[1];
+  sensorRL = defaults.wheel[2];
+  sensorRR = defaults.wheel[3];
+  sensorINA226 = defaults.ina226Enabled;
 
   Logger::info("Sensor config reset to defaults");
 }
 
-void MenuSensorConfig::drawToggleButton(
-    int16_t x, int16_t y, int16_t w, int16_t h,
-    const char * /* label - unused, shows ON/OFF */, bool enabled) {
-  uint16_t bgColor = enabled ? COLOR_ENABLED : COLOR_DISABLED;
-  uint16_t textColor = enabled ? COLOR_BG : COLOR_TEXT;
-
-  tft->fillRoundRect(x, y, w, h, 5, bgColor);
-  tft->drawRoundRect(x, y, w, h, 5, COLOR_TEXT);
-
-  tft->setTextDatum(MC_DATUM);
-  tft->setTextColor(textColor, bgColor);
-  tft->drawString(enabled ? "ON" : "OFF", x + w / 2, y + h / 2, 2);
-}
-
-void MenuSensorConfig::drawToggleWithLabel(const Button &btn,
-                                           const char *fullLabel,
-                                           bool enabled) {
-  // Draw label on the left
-  tft->setTextDatum(TL_DATUM);
-  tft->setTextColor(enabled ? COLOR_TEXT : COLOR_INACTIVE, COLOR_BG);
-  tft->drawString(fullLabel, 40, btn.y + 10, 2);
-
-  // Draw status indicator circle
-  int circleX = 25;
-  int circleY = btn.y + btn.h / 2;
-  tft->fillCircle(circleX, circleY, 8,
-                  enabled ? COLOR_ENABLED : COLOR_DISABLED);
-  tft->drawCircle(circleX, circleY, 8, COLOR_TEXT);
-
-  // Draw toggle button
-  drawToggleButton(btn.x, btn.y, btn.w, btn.h, btn.label, enabled);
-}
-
-void MenuSensorConfig::drawStatusBar() {
-  int enabledCount = getEnabledCount();
-  int totalCount = 5; // FL, FR, RL, RR, INA226
-
-  // Status bar background
-  int barY = 245;
-  tft->fillRect(20, barY, 440, 20, COLOR_BG);
-
-  // Draw status text
-  char statusStr[48];
-  snprintf(statusStr, sizeof(statusStr), "Status: %d/%d sensors enabled",
-           enabledCount, totalCount);
-
-  // Warning thresholds: green=all, yellow=<4, red=<2
-  uint16_t statusColor = COLOR_ENABLED;
-  if (enabledCount < 4)
-    statusColor = COLOR_WARNING; // Show warning earlier (3 or fewer)
-  if (enabledCount < 2) statusColor = COLOR_DISABLED;
-
-  tft->setTextDatum(TL_DATUM);
-  tft->setTextColor(statusColor, COLOR_BG);
-  tft->drawString(statusStr, 20, barY, 2);
-
-  // Warning if too few sensors enabled
-  if (enabledCount < 2) {
-    tft->setTextColor(COLOR_DISABLED, COLOR_BG);
-    tft->drawString("WARNING: Unsafe!", 280, barY, 2);
-  }
-}
-
-void MenuSensorConfig::drawActionButtons() {
-  // Save button
-  uint16_t saveColor = (lastSaveTime > 0) ? TFT_BLUE : COLOR_ENABLED;
-  const char *saveLabel = (lastSaveTime > 0) ? "SAVED!" : "SAVE";
-
-  tft->fillRoundRect(btnSave.x, btnSave.y, btnSave.w, btnSave.h, 5, saveColor);
-  tft->drawRoundRect(btnSave.x, btnSave.y, btnSave.w, btnSave.h, 5, COLOR_TEXT);
-  tft->setTextDatum(MC_DATUM);
-  tft->setTextColor(COLOR_BG, saveColor);
-  tft->drawString(saveLabel, btnSave.x + btnSave.w / 2,
-                  btnSave.y + btnSave.h / 2, 2);
-
-  // Reset button
-  uint16_t resetColor = (lastResetTime > 0) ? TFT_BLUE : COLOR_WARNING;
-  const char *resetLabel = (lastResetTime > 0) ? "RESET!" : "RESET";
-
-  tft->fillRoundRect(btnReset.x, btnReset.y, btnReset.w, btnReset.h, 5,
-                     resetColor);
-  tft->drawRoundRect(btnReset.x, btnReset.y, btnReset.w, btnReset.h, 5,
-                     COLOR_TEXT);
-  tft->setTextColor(COLOR_BG, resetColor);
-  tft->drawString(resetLabel, btnReset.x + btnReset.w / 2,
-                  btnReset.y + btnReset.h / 2, 2);
-
-  // Back button
-  tft->fillRoundRect(btnBack.x, btnBack.y, btnBack.w, btnBack.h, 5,
-                     COLOR_INACTIVE);
-  tft->drawRoundRect(btnBack.x, btnBack.y, btnBack.w, btnBack.h, 5, COLOR_TEXT);
-  tft->setTextColor(COLOR_TEXT, COLOR_INACTIVE);
-  tft->drawString("BACK", btnBack.x + btnBack.w / 2, btnBack.y + btnBack.h / 2,
-                  2);
-}
-
 int MenuSensorConfig::getEnabledCount() {
   int count = 0;
   if (sensorFL) count++;
@@ -305,9 +267,3 @@ int MenuSensorConfig::getEnabledCount() {
   if (sensorINA226) count++;
   return count;
 }
-
-bool MenuSensorConfig::isTouchInButton(int16_t tx, int16_t ty,
-                                       const Button &btn) {
-  return (tx >= btn.x && tx <= btn.x + btn.w && ty >= btn.y &&
-          ty <= btn.y + btn.h);
-}
@@ -1,12 +1,12 @@
 // Obstacle Detection HUD Display
 // v2.12.0: Updated for single TOFSense-M S sensor (front only)
 // v2.20.0: RenderEngine sprite layer integration (STEERING layer)
+// Draws through the caller's RenderContext (compositor layer or TFT)
 #include "obstacle_display.h"
 #include "hud_layer.h"
 #include "logger.h"
 #include "obstacle_config.h"
 #include "obstacle_detection.h"
-#include "render_engine.h"
 #include "safe_draw.h"
 #include <TFT_eSPI.h>
 
@@ -15,16 +15,6 @@ namespace ObstacleDisplay {
 static DisplayConfig config;
 static uint32_t lastUpdateMs = 0;
 
-// Bounding box for obstacle HUD area
-static constexpr int HUD_X = 0;
-static constexpr int HUD_Y = 60;
-static constexpr int HUD_W = 480;
-static constexpr int HUD_H = 260;
-
-static TFT_eSprite *getSprite() {
-  return RenderEngine::getSprite(RenderEngine::STEERING);
-}
-
 void init() {
   Logger::info("ObstacleDisplay: Init (v2.12.0 - Single sensor)");
   config = DisplayConfig();
@@ -32,29 +22,18 @@ void init() {
 
 void setEnabled(bool enable) { config.enabled = enable; }
 
-void update() {
-  if (!config.enabled) return;
+void update(HudLayer::RenderContext &ctx) {
+  if (!config.enabled || !ctx.isValid()) return;
 
   uint32_t now = millis();
   if (now - lastUpdateMs < (1000 / config.updateRate)) return;
   lastUpdateMs = now;
 
-  auto sprite = getSprite();
-  if (!sprite) return;
-
-  if (config.showBars) {
-    drawDistanceBars();
-    RenderEngine::markDirtyRect(HUD_X, HUD_Y, HUD_W, HUD_H);
-  }
+  if (config.showBars) drawDistanceBars(ctx);
 }
 
-void drawProximityIndicators() {
-  auto sprite = getSprite();
-  if (!sprite) return;
-
-  // Create RenderContext for SafeDraw
-  HudLayer::RenderContext ctx(sprite, true, 0, 0, sprite->width(),
-                              sprite->height());
+void drawProximityIndicators(HudLayer::RenderContext &ctx) {
+  if (!ctx.isValid()) return;
 
   auto level =
       ObstacleDetection::getProximityLevel(ObstacleDetection::SENSOR_FRONT);
@@ -81,16 +60,11 @@ void drawProximityIndicators() {
   drawTarget->setTextColor(TFT_WHITE, TFT_BLACK);
   SafeDraw::drawString(ctx, "FRONT", x, y + 25, 2);
 
-  RenderEngine::markDirtyRect(x - 20, y - 20, 40, 60);
+  ctx.markDirty(x - 20, y - 20, 40, 60);
 }
 
-void drawDistanceBars() {
-  auto sprite = getSprite();
-  if (!sprite) return;
-
-  // Create RenderContext for SafeDraw
-  HudLayer::RenderContext ctx(sprite, true, 0, 0, sprite->width(),
-                              sprite->height());
+void drawDistanceBars(HudLayer::RenderContext &ctx) {
+  if (!ctx.isValid()) return;
 
   uint16_t dist =
       ObstacleDetection::getMinDistance(ObstacleDetection::SENSOR_FRONT);
@@ -110,7 +84,7 @@ void drawDistanceBars() {
     drawTarget->setTextDatum(MC_DATUM);
     drawTarget->setTextColor(TFT_RED, TFT_BLACK);
     SafeDraw::drawString(ctx, "SENSOR ERROR", 240, barY + 5, 4);
-    RenderEngine::markDirtyRect(0, barY - 40, 480, 60);
+    ctx.markDirty(0, barY - 40, 480, 60);
     return;
   }
 
@@ -118,7 +92,7 @@ void drawDistanceBars() {
     drawTarget->setTextDatum(MC_DATUM);
     drawTarget->setTextColor(TFT_GREEN, TFT_BLACK);
     SafeDraw::drawString(ctx, "CLEAR", 240, barY + 5, 4);
-    RenderEngine::markDirtyRect(0, barY - 40, 480, 60);
+    ctx.markDirty(0, barY - 40, 480, 60);
     return;
   }
 
@@ -148,7 +122,7 @@ void drawDistanceBars() {
   drawTarget->setTextColor(TFT_WHITE, TFT_BLACK);
   SafeDraw::drawString(ctx, distStr, 240, barY - 20, 4);
 
-  RenderEngine::markDirtyRect(0, barY - 40, 480, 60);
+  ctx.markDirty(0, barY - 40, 480, 60);
 }
 
 const DisplayConfig &getConfig() { return config; }
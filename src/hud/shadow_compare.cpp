@@ -0,0 +1,136 @@
+// shadow_compare.cpp - Shadow-mode validation of the BASE layer by block hash
+#include "shadow_compare.h"
+
+#include <cstring>
+
+namespace ShadowCompare {
+
+// ============================================================================
+// Hash
+// ============================================================================
+
+static constexpr uint32_t LANE_MUL = 0x9E3779B1u; // Odd: bijective multiply
+static constexpr int LANES = 4;
+
+static inline uint32_t step(uint32_t lane, uint32_t word) {
+  return (lane ^ word) * LANE_MUL;
+}
+
+// Final avalanche (MurmurHash3 fmix32)
+static inline uint32_t mix(uint32_t h) {
+  h ^= h >> 16;
+  h *= 0x85EBCA6Bu;
+  h ^= h >> 13;
+  h *= 0xC2B2AE35u;
+  h ^= h >> 16;
+  return h;
+}
+
+// ============================================================================
+// Blocks
+// ============================================================================
+
+uint32_t hashBlock(const uint16_t *buf, int width, int height, int bx,
+                   int by) {
+  int x0 = bx * BLOCK_SIZE;
+  int y0 = by * BLOCK_SIZE;
+  int w = (x0 + BLOCK_SIZE > width) ? width - x0 : BLOCK_SIZE;
+  int h = (y0 + BLOCK_SIZE > height) ? height - y0 : BLOCK_SIZE;
+  if (w <= 0 || h <= 0) return 0;
+
+  // Lanes carry on across rows: row order and position both count
+  uint32_t lane[LANES] = {1, 2, 3, 4};
+  const uint16_t *row = buf + y0 * width + x0;
+
+  if (w == BLOCK_SIZE) {
+    for (int y = 0; y < h; y++, row += width) {
+      uint32_t words[BLOCK_SIZE / 2];
+      memcpy(words, row, sizeof(words)); // Rows are 4-byte aligned
+      for (int i = 0; i < BLOCK_SIZE / 2; i++) {
+        lane[i % LANES] = step(lane[i % LANES], words[i]);
+      }
+    }
+  } else {
+    // Clipped edge block: one pixel per step
+    for (int y = 0; y < h; y++, row += width) {
+      for (int x = 0; x < w; x++) {
+        lane[x % LANES] = step(lane[x % LANES], row[x]);
+      }
+    }
+  }
+
+  uint32_t hash = lane[0];
+  for (int i = 1; i < LANES; i++) hash = step(hash, lane[i]);
+  return mix(hash);
+}
+
+uint16_t markBlocks(const Rect *dirty, int dirtyCount, int width, int height,
+                    uint32_t *rows) {
+  int blocksX = (width + BLOCK_SIZE - 1) / BLOCK_SIZE;
+  int blocksY = (height + BLOCK_SIZE - 1) / BLOCK_SIZE;
+  if (blocksX > MAX_BLOCKS_X) blocksX = MAX_BLOCKS_X;
+  if (blocksY > MAX_BLOCKS_Y) blocksY = MAX_BLOCKS_Y;
+
+  for (int by = 0; by < MAX_BLOCKS_Y; by++) rows[by] = 0;
+
+  for (int r = 0; r < dirtyCount; r++) {
+    const Rect &rect = dirty[r];
+    if (rect.w <= 0 || rect.h <= 0) continue;
+    int x0 = rect.x < 0 ? 0 : rect.x;
+    int y0 = rect.y < 0 ? 0 : rect.y;
+    int x1 = rect.x + rect.w; // Exclusive
+    int y1 = rect.y + rect.h;
+    if (x1 > width) x1 = width;
+    if (y1 > height) y1 = height;
+    if (x0 >= x1 || y0 >= y1) continue;
+
+    int bx0 = x0 / BLOCK_SIZE;
+    int bx1 = (x1 - 1) / BLOCK_SIZE;
+    int by0 = y0 / BLOCK_SIZE;
+    int by1 = (y1 - 1) / BLOCK_SIZE;
+    if (bx1 >= blocksX) bx1 = blocksX - 1;
+    if (by1 >= blocksY) by1 = blocksY - 1;
+
+    // Columns bx0..bx1 set in one mask
+    uint32_t span = (bx1 - bx0 + 1 >= 32) ? 0xFFFFFFFFu
+                                          : ((1u << (bx1 - bx0 + 1)) - 1u);
+    uint32_t mask = span << bx0;
+    for (int by = by0; by <= by1; by++) rows[by] |= mask;
+  }
+
+  uint16_t marked = 0;
+  for (int by = 0; by < blocksY; by++) {
+    marked += __builtin_popcount(rows[by]);
+  }
+  return marked;
+}
+
+Result compare(const uint16_t *a, const uint16_t *b, int width, int height,
+               const Rect *dirty, int dirtyCount) {
+  Result result = {0, 0, -1, -1};
+  if (!a || !b) return result;
+
+  uint32_t rows[MAX_BLOCKS_Y];
+  markBlocks(dirty, dirtyCount, width, height, rows);
+
+  for (int by = 0; by < MAX_BLOCKS_Y; by++) {
+    uint32_t pending = rows[by];
+    while (pending) {
+      int bx = __builtin_ctz(pending);
+      pending &= pending - 1;
+
+      result.blocksCompared++;
+      if (hashBlock(a, width, height, bx, by) !=
+          hashBlock(b, width, height, bx, by)) {
+        if (result.mismatches == 0) {
+          result.firstX = bx;
+          result.firstY = by;
+        }
+        result.mismatches++;
+      }
+    }
+  }
+  return result;
+}
+
+} // namespace ShadowCompare
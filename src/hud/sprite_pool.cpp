@@ -0,0 +1,174 @@
+// sprite_pool.cpp - Slab arena for sprite buffers (pure logic)
+#include "sprite_pool.h"
+
+namespace SpritePool {
+
+Arena::Arena()
+    : base(nullptr), slabs(0), largeSlabs(0), usedSlabs(0), peakSlabs(0),
+      map{}, slots{},
+      acquires(0), releases(0), failures(0), staleReleases(0) {}
+
+bool Arena::init(uint8_t *mem, uint32_t bytes, uint32_t smallBytes) {
+  uint32_t count = bytes / SLAB_BYTES;
+  if (count > MAX_SLABS) count = MAX_SLABS;
+  uint32_t small = (smallBytes + SLAB_BYTES - 1) / SLAB_BYTES;
+  if (!mem || count == 0 || small > count) return false;
+
+  base = mem;
+  slabs = static_cast<uint16_t>(count);
+  largeSlabs = static_cast<uint16_t>(count - small);
+  usedSlabs = 0;
+  peakSlabs = 0;
+  for (uint32_t &w : map) w = 0;
+  for (Slot &s : slots) s = {0, 0, 0, 0, false};
+  return true;
+}
+
+void Arena::markSlabs(uint16_t first, uint16_t count, bool used) {
+  for (uint16_t s = first; s < first + count; s++) {
+    if (used) {
+      map[s >> 5] |= 1u << (s & 31);
+    } else {
+      map[s >> 5] &= ~(1u << (s & 31));
+    }
+  }
+}
+
+int8_t Arena::slotOf(Handle h) const {
+  uint8_t slot = static_cast<uint8_t>(h & 0xFF);
+  if (slot == 0 || slot > MAX_BUFFERS) return -1;
+  const Slot &s = slots[slot - 1];
+  if (!s.used || s.generation != static_cast<uint8_t>(h >> 8)) return -1;
+  return static_cast<int8_t>(slot - 1);
+}
+
+Handle Arena::acquire(uint32_t bytes, uint8_t tag) {
+  if (!base || bytes == 0) return INVALID;
+  uint32_t need32 = (bytes + SLAB_BYTES - 1) / SLAB_BYTES;
+
+  int8_t slot = -1;
+  for (uint8_t i = 0; i < MAX_BUFFERS; i++) {
+    if (!slots[i].used) {
+      slot = static_cast<int8_t>(i);
+      break;
+    }
+  }
+
+  // Best fit inside the buffer's region: large ones in the bottom region,
+  // small ones in the top region (placed at the top end of their run)
+  bool large = bytes >= LARGE_BYTES;
+  uint16_t lo = large ? 0 : largeSlabs;
+  uint16_t hi = large ? largeSlabs : slabs;
+  uint16_t bestFirst = 0;
+  uint16_t bestLen = 0;
+  if (slot >= 0 && need32 <= static_cast<uint32_t>(hi - lo)) {
+    uint16_t need = static_cast<uint16_t>(need32);
+    uint16_t run = 0;
+    for (uint16_t s = lo; s <= hi; s++) {
+      if (s < hi && !slabUsed(s)) {
+        run++;
+        continue;
+      }
+      if (run >= need && (bestLen == 0 || run <= bestLen)) {
+        bestFirst = static_cast<uint16_t>(large ? s - run : s - need);
+        bestLen = run;
+        if (large && run == need) break; // Exact fit
+      }
+      run = 0;
+    }
+  }
+  if (bestLen == 0) {
+    failures++;
+    return INVALID;
+  }
+
+  Slot &s = slots[slot];
+  s.first = bestFirst;
+  s.count = static_cast<uint16_t>(need32);
+  s.generation++;
+  if (s.generation == 0) s.generation = 1; // Handle 0 stays invalid
+  s.tag = tag;
+  s.used = true;
+  markSlabs(s.first, s.count, true);
+
+  usedSlabs += s.count;
+  if (usedSlabs > peakSlabs) peakSlabs = usedSlabs;
+  acquires++;
+  return static_cast<Handle>((s.generation << 8) | (slot + 1));
+}
+
+bool Arena::release(Handle h) {
+  int8_t slot = slotOf(h);
+  if (slot < 0) {
+    staleReleases++;
+    return false;
+  }
+  Slot &s = slots[slot];
+  markSlabs(s.first, s.count, false);
+  usedSlabs -= s.count;
+  s.used = false;
+  releases++;
+  return true;
+}
+
+bool Arena::valid(Handle h) const { return slotOf(h) >= 0; }
+
+void *Arena::pointer(Handle h) const {
+  int8_t slot = slotOf(h);
+  if (slot < 0) return nullptr;
+  return base + static_cast<uint32_t>(slots[slot].first) * SLAB_BYTES;
+}
+
+uint32_t Arena::size(Handle h) const {
+  int8_t slot = slotOf(h);
+  return slot < 0 ? 0 : static_cast<uint32_t>(slots[slot].count) * SLAB_BYTES;
+}
+
+uint32_t Arena::largestFreeBytes() const {
+  uint16_t best = 0;
+  uint16_t run = 0;
+  for (uint16_t s = 0; s < slabs; s++) {
+    if (slabUsed(s)) {
+      run = 0;
+    } else if (++run > best) {
+      best = run;
+    }
+  }
+  return static_cast<uint32_t>(best) * SLAB_BYTES;
+}
+
+Stats Arena::stats() const {
+  Stats st = {};
+  st.totalBytes = static_cast<uint32_t>(slabs) * SLAB_BYTES;
+  st.usedBytes = static_cast<uint32_t>(usedSlabs) * SLAB_BYTES;
+  st.peakUsedBytes = static_cast<uint32_t>(peakSlabs) * SLAB_BYTES;
+  st.largestFreeBytes = largestFreeBytes();
+  uint32_t freeBytes = st.totalBytes - st.usedBytes;
+  st.fragmentationPct =
+      freeBytes ? static_cast<uint8_t>(
+                      (100u * (freeBytes - st.largestFreeBytes)) / freeBytes)
+                : 0;
+  for (const Slot &s : slots) {
+    if (s.used) st.liveBuffers++;
+  }
+  st.acquires = acquires;
+  st.releases = releases;
+  st.failures = failures;
+  st.staleReleases = staleReleases;
+  return st;
+}
+
+void Arena::describe(char *out, uint16_t len) const {
+  if (!out || len == 0) return;
+  uint16_t n = slabs < len - 1 ? slabs : static_cast<uint16_t>(len - 1);
+  for (uint16_t i = 0; i < n; i++) out[i] = '.';
+  for (const Slot &s : slots) {
+    if (!s.used) continue;
+    for (uint16_t i = s.first; i < s.first + s.count && i < n; i++) {
+      out[i] = static_cast<char>('A' + (s.tag % 26));
+    }
+  }
+  out[n] = '\0';
+}
+
+} // namespace SpritePool
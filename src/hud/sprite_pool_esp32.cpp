@@ -0,0 +1,133 @@
+// sprite_pool_esp32.cpp - PSRAM reservation for SpritePool and the
+// TFT_eSprite binding (PooledSprite)
+#include "logger.h"
+#include "pooled_sprite.h"
+#include "sprite_pool.h"
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+
+namespace SpritePool {
+
+static Arena pool;
+
+bool init(uint8_t screenSprites, uint32_t smallBytes) {
+  if (pool.isReady()) return true;
+
+  if (!psramFound()) {
+    Logger::warn("SpritePool: no PSRAM, sprites allocate their own buffers");
+    return false;
+  }
+
+  uint32_t smallSlabBytes =
+      (smallBytes + SLAB_BYTES - 1) / SLAB_BYTES * SLAB_BYTES;
+  uint32_t bytes = screenSprites * SCREEN_SPRITE_BYTES + smallSlabBytes;
+  if (bytes > static_cast<uint32_t>(MAX_SLABS) * SLAB_BYTES) {
+    Logger::errorf("SpritePool: %u KB exceeds the arena limit",
+                   bytes / 1024);
+    return false;
+  }
+
+  // Reserved once at boot and never returned: sprite churn stays inside
+  uint8_t *memory = static_cast<uint8_t *>(
+      heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT));
+  if (!memory || !pool.init(memory, bytes, smallSlabBytes)) {
+    Logger::errorf("SpritePool: cannot reserve %u KB of PSRAM (free %u KB), "
+                   "sprites allocate their own buffers",
+                   bytes / 1024, ESP.getFreePsram() / 1024);
+    if (memory) heap_caps_free(memory);
+    return false;
+  }
+
+  Logger::infof("SpritePool: %u KB arena in PSRAM (%u screen sprites + %u "
+                "KB small), PSRAM left %u KB",
+                bytes / 1024, screenSprites, smallSlabBytes / 1024,
+                ESP.getFreePsram() / 1024);
+  return true;
+}
+
+bool isReady() { return pool.isReady(); }
+
+Arena &arena() { return pool; }
+
+void logStats() {
+  if (!pool.isReady()) return;
+  Stats s = pool.stats();
+  Logger::infof("SpritePool: %lu/%lu KB used (peak %lu KB), %u live, "
+                "largest free %lu KB, fragmentation %u%%, %lu acquires, "
+                "%lu failures, %lu stale releases",
+                (unsigned long)(s.usedBytes / 1024),
+                (unsigned long)(s.totalBytes / 1024),
+                (unsigned long)(s.peakUsedBytes / 1024), s.liveBuffers,
+                (unsigned long)(s.largestFreeBytes / 1024),
+                s.fragmentationPct, (unsigned long)s.acquires,
+                (unsigned long)s.failures, (unsigned long)s.staleReleases);
+}
+
+} // namespace SpritePool
+
+// --- PooledSprite ---
+// Binds the buffer the way TFT_eSprite::createSprite() does for one 16 bpp
+// frame; relies on the protected members of TFT_eSPI 2.5.43 (pinned in
+// platformio.ini). Another version must fail here, not at the first draw.
+
+static constexpr bool sameVersion(const char *a, const char *b) {
+  return *a == *b && (*a == '\0' || sameVersion(a + 1, b + 1));
+}
+static_assert(sameVersion(TFT_ESPI_VERSION, "2.5.43"),
+              "PooledSprite binds TFT_eSprite internals of TFT_eSPI 2.5.43: "
+              "re-check create()/destroy() before changing the version");
+
+PooledSprite::PooledSprite(TFT_eSPI *tft, uint8_t spriteTag)
+    : TFT_eSprite(tft), handle(SpritePool::INVALID), tag(spriteTag) {}
+
+PooledSprite::~PooledSprite() { destroy(); }
+
+void *PooledSprite::create(int16_t width, int16_t height) {
+  if (_created) return _img8_1;
+  if (width < 1 || height < 1) return nullptr;
+
+  if (_bpp == 16 && SpritePool::isReady()) {
+    uint32_t bytes = static_cast<uint32_t>(width) * height * 2;
+    SpritePool::Handle h = SpritePool::arena().acquire(bytes, tag);
+    if (h != SpritePool::INVALID) {
+      handle = h;
+      _iwidth = _dwidth = _bitwidth = width;
+      _iheight = _dheight = height;
+      cursor_x = 0;
+      cursor_y = 0;
+      _sx = 0;
+      _sy = 0;
+      _sw = width;
+      _sh = height;
+      _scolor = TFT_BLACK;
+      _img8 = static_cast<uint8_t *>(SpritePool::arena().pointer(h));
+      _img8_1 = _img8;
+      _img8_2 = _img8;
+      _img4 = _img8;
+      _img = reinterpret_cast<uint16_t *>(_img8);
+      _created = true;
+      rotation = 0;
+      setViewport(0, 0, _dwidth, _dheight);
+      setPivot(_iwidth / 2, _iheight / 2);
+      return _img8_1;
+    }
+    Logger::warnf("SpritePool: no room for sprite %u (%ux%u), own buffer",
+                  tag, width, height);
+  }
+
+  if (psramFound()) setAttribute(PSRAM_ENABLE, 1);
+  return createSprite(width, height);
+}
+
+void PooledSprite::destroy() {
+  if (handle != SpritePool::INVALID) {
+    // Detach first: TFT_eSprite::deleteSprite() would free() the buffer
+    _img = nullptr;
+    _img8 = _img8_1 = _img8_2 = _img4 = nullptr;
+    _created = false;
+    _vpOOB = true;
+    SpritePool::arena().release(handle);
+    handle = SpritePool::INVALID;
+  }
+  TFT_eSprite::deleteSprite(); // Palette, or a fallback buffer
+}
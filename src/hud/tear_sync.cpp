@@ -0,0 +1,219 @@
+// tear_sync.cpp - Panel scan model and tear-aware push order (pure logic)
+#include "tear_sync.h"
+
+namespace TearSync {
+
+// Edges folded late (HUD task between frames) still measure the period
+static constexpr uint32_t MAX_EDGE_GAP = 64;
+
+// Learn the push cost only from pushes long enough to time
+static constexpr uint32_t MIN_LEARN_PIXELS = 1024;
+
+ScanModel::ScanModel(const Geometry &g)
+    : geo(g), period(g.periodUs), refUs(0), refLine(0),
+      total(g.activeLines + g.blankLines), lastTeUs(0), src(Source::NONE) {}
+
+void ScanModel::onTe(uint32_t nowUs) {
+  if (src == Source::TE_PIN) {
+    uint32_t dt = nowUs - lastTeUs;
+    uint32_t edges = (dt + period / 2) / period;
+    if (edges >= 1 && edges <= MAX_EDGE_GAP) {
+      uint32_t measured = dt / edges;
+      uint32_t tolerance = geo.periodUs / 8;
+      // Bounce or a stalled fold: keep the previous period
+      if (measured + tolerance > geo.periodUs &&
+          measured < geo.periodUs + tolerance) {
+        period = (period * 7 + measured) / 8;
+      }
+    }
+  }
+  refUs = nowUs;
+  refLine = geo.activeLines; // TE rises with the first blank line
+  lastTeUs = nowUs;
+  src = Source::TE_PIN;
+}
+
+void ScanModel::anchor(uint32_t nowUs, uint16_t line) {
+  refUs = nowUs;
+  refLine = line % total;
+  if (src != Source::TE_PIN) src = Source::ESTIMATED;
+}
+
+bool ScanModel::locked(uint32_t nowUs) const {
+  return src == Source::TE_PIN && nowUs - lastTeUs < 2 * period;
+}
+
+uint64_t ScanModel::phaseAt(uint32_t nowUs) const {
+  const int64_t span = static_cast<int64_t>(total) * period;
+  int64_t elapsed = static_cast<int32_t>(nowUs - refUs);
+  int64_t phase =
+      (static_cast<int64_t>(refLine) * period + elapsed * total) % span;
+  if (phase < 0) phase += span;
+  return static_cast<uint64_t>(phase);
+}
+
+uint16_t ScanModel::lineAt(uint32_t nowUs) const {
+  return static_cast<uint16_t>(phaseAt(nowUs) / period);
+}
+
+uint32_t ScanModel::usUntil(uint32_t nowUs, uint16_t line) const {
+  const uint64_t span = static_cast<uint64_t>(total) * period;
+  uint64_t phase = phaseAt(nowUs);
+  uint64_t target = static_cast<uint64_t>(line % total) * period;
+  if (phase >= target && phase < target + period) return 0;
+  uint64_t ahead = (target + span - phase) % span;
+  return static_cast<uint32_t>((ahead + total - 1) / total);
+}
+
+void ScanModel::band(const Rect &r, uint16_t &first, uint16_t &last) const {
+  int32_t start = geo.scanAlongX ? r.x : r.y;
+  int32_t end = start + (geo.scanAlongX ? r.w : r.h); // Exclusive
+  if (start < 0) start = 0;
+  if (end > geo.activeLines) end = geo.activeLines;
+  if (end <= start) end = start + 1;
+
+  if (geo.scanReversed) {
+    first = static_cast<uint16_t>(geo.activeLines - end);
+    last = static_cast<uint16_t>(geo.activeLines - 1 - start);
+  } else {
+    first = static_cast<uint16_t>(start);
+    last = static_cast<uint16_t>(end - 1);
+  }
+}
+
+bool ScanModel::crosses(uint16_t first, uint16_t last, uint32_t startUs,
+                        uint32_t endUs) const {
+  uint32_t duration = endUs - startUs;
+  if (duration >= period) return true;
+  uint16_t line = lineAt(startUs);
+  if (line >= first && line <= last) return true;
+  return usUntil(startUs, first) <= duration;
+}
+
+// --- PushOrder ---
+
+PushOrder::PushOrder()
+    : mode(Mode::OFF), count(0), layers(1), pendingMask(0), report{},
+      st{} {
+  st.nsPerPixel = DEFAULT_NS_PER_PIXEL;
+}
+
+void PushOrder::begin(const ScanModel &model, Mode m, const Rect *r,
+                      uint8_t n, uint8_t layerCount) {
+  scan = model;
+  mode = m;
+  count = n > MAX_RECTS ? MAX_RECTS : n;
+  layers = layerCount > 0 ? layerCount : 1;
+  for (uint8_t i = 0; i < count; i++) {
+    rects[i] = r[i];
+    scan.band(rects[i], first[i], last[i]);
+  }
+  pendingMask = static_cast<uint16_t>((1u << count) - 1);
+  report = {};
+}
+
+uint32_t PushOrder::costUs(uint8_t idx) const {
+  uint32_t pixels = static_cast<uint32_t>(rects[idx].w) * rects[idx].h;
+  return layers *
+         (PUSH_OVERHEAD_US +
+          static_cast<uint32_t>(
+              (static_cast<uint64_t>(pixels) * st.nsPerPixel) / 1000));
+}
+
+int8_t PushOrder::next(uint32_t nowUs, uint32_t &waitUs) {
+  waitUs = 0;
+  if (pendingMask == 0) return -1;
+
+  int8_t natural = 0;
+  while (!((pendingMask >> natural) & 1u)) natural++;
+  int8_t pick = natural;
+
+  if (mode == Mode::CHASE && scan.valid()) {
+    uint16_t line = scan.lineAt(nowUs);
+    const uint32_t period = scan.periodUs();
+    const uint16_t total = scan.totalLines();
+
+    // Finishes before the scan arrives: the one it reaches soonest
+    int8_t safe = -1;
+    uint32_t safeEnter = UINT32_MAX;
+    // Otherwise: the band the scan leaves first, if the push then fits
+    int8_t clearing = -1;
+    uint32_t clearUs = UINT32_MAX;
+    // Otherwise: the most headroom before the scan arrives
+    int8_t roomiest = natural;
+    uint32_t roomiestEnter = 0;
+
+    for (uint8_t i = 0; i < count; i++) {
+      if (!((pendingMask >> i) & 1u)) continue;
+      bool inside = line >= first[i] && line <= last[i];
+      uint32_t enter = inside ? 0 : scan.usUntil(nowUs, first[i]);
+      uint32_t cost = costUs(i) + GUARD_US;
+
+      if (!inside && enter >= cost && enter < safeEnter) {
+        safe = static_cast<int8_t>(i);
+        safeEnter = enter;
+      }
+      uint32_t bandUs = static_cast<uint32_t>(
+          (static_cast<uint64_t>(last[i] - first[i] + 1) * period) / total);
+      if (cost + bandUs < period) {
+        uint32_t leave = scan.usUntil(nowUs, (last[i] + 1) % total);
+        if (leave < clearUs) {
+          clearing = static_cast<int8_t>(i);
+          clearUs = leave;
+        }
+      }
+      if (enter > roomiestEnter) {
+        roomiest = static_cast<int8_t>(i);
+        roomiestEnter = enter;
+      }
+    }
+
+    if (safe >= 0) {
+      pick = safe;
+    } else if (clearing >= 0 && clearUs <= MAX_WAIT_US) {
+      pick = clearing;
+      waitUs = clearUs;
+    } else {
+      pick = roomiest;
+    }
+  }
+
+  pendingMask &= static_cast<uint16_t>(~(1u << pick));
+  if (pick != natural) report.reordered = true;
+  report.waitUs += waitUs;
+  return pick;
+}
+
+bool PushOrder::pushed(uint8_t idx, uint32_t startUs, uint32_t endUs) {
+  if (idx >= count) return false;
+  report.rects++;
+
+  uint32_t pixels = static_cast<uint32_t>(rects[idx].w) * rects[idx].h;
+  uint32_t duration = endUs - startUs;
+  uint32_t overhead = layers * PUSH_OVERHEAD_US;
+  if (pixels >= MIN_LEARN_PIXELS && duration > overhead) {
+    uint32_t ns = static_cast<uint32_t>(
+        (static_cast<uint64_t>(duration - overhead) * 1000) /
+        (static_cast<uint64_t>(pixels) * layers));
+    st.nsPerPixel = (st.nsPerPixel * 7 + ns) / 8;
+  }
+
+  if (mode == Mode::OFF || !scan.valid()) return false;
+  bool crossed = scan.crosses(first[idx], last[idx], startUs, endUs);
+  if (crossed) report.riskRects++;
+  return crossed;
+}
+
+const FrameReport &PushOrder::end() {
+  if (mode != Mode::OFF && scan.valid() && report.rects > 0) {
+    st.frames++;
+    if (report.riskRects > 0) st.riskFrames++;
+    st.riskRects += report.riskRects;
+    if (report.reordered) st.reorderedFrames++;
+    st.waitUs += report.waitUs;
+    if (report.waitUs > st.maxFrameWaitUs) st.maxFrameWaitUs = report.waitUs;
+  }
+  return report;
+}
+
+} // namespace TearSync
@@ -0,0 +1,90 @@
+// tear_sync_esp32.cpp - TE interrupt and panel setup for TearSync
+#include "logger.h"
+#include "pins.h"
+#include "tear_sync.h"
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+
+namespace TearSync {
+
+// ST7796S TEON; parameter 0x00 = TE pulses during vertical blanking only
+static constexpr uint8_t CMD_TEON = 0x35;
+static constexpr uint8_t TE_VBLANK_ONLY = 0x00;
+
+static portMUX_TYPE teMux = portMUX_INITIALIZER_UNLOCKED;
+static volatile uint32_t teEdgeUs = 0; // teMux
+static volatile uint32_t teEdges = 0;  // teMux
+
+static ScanModel model; // HUD task; edges folded in snapshot()
+static uint32_t foldedEdges = 0;
+static PushOrder order;
+static Mode mode = Mode::OFF;
+static bool ready = false;
+
+// Only the timestamp here: the model is updated from the HUD task
+static void IRAM_ATTR onTe() {
+  uint32_t now = micros();
+  portENTER_CRITICAL_ISR(&teMux);
+  teEdgeUs = now;
+  teEdges = teEdges + 1;
+  portEXIT_CRITICAL_ISR(&teMux);
+}
+
+void init(TFT_eSPI *tftDisplay) {
+  if (ready) return;
+
+  if (PIN_TFT_TE >= 0 && tftDisplay) {
+    // Called from HUD init before the touch task runs: bus not contended
+    tftDisplay->writecommand(CMD_TEON);
+    tftDisplay->writedata(TE_VBLANK_ONLY);
+    pinMode(PIN_TFT_TE, INPUT);
+    attachInterrupt(digitalPinToInterrupt(PIN_TFT_TE), onTe, RISING);
+    mode = Mode::CHASE;
+    Logger::infof("TearSync: TE on GPIO %d, pushes follow the panel scan",
+                  PIN_TFT_TE);
+  } else {
+    // No TE wire and no MISO for RDSCANLINE: nominal period from here on.
+    // Risks are reported against the estimate; the order is left alone.
+    model.anchor(micros(), 0);
+    mode = Mode::REPORT;
+    Logger::info("TearSync: no TE pin, panel scan estimated (report only)");
+  }
+  ready = true;
+}
+
+void setMode(Mode m) { mode = m; }
+
+Mode getMode() { return mode; }
+
+ScanModel snapshot() {
+  portENTER_CRITICAL(&teMux);
+  uint32_t edges = teEdges;
+  uint32_t edgeUs = teEdgeUs;
+  portEXIT_CRITICAL(&teMux);
+
+  if (edges != foldedEdges) {
+    model.onTe(edgeUs);
+    foldedEdges = edges;
+  }
+  return model;
+}
+
+PushOrder &pushOrder() { return order; }
+
+void logStats() {
+  if (!ready) return;
+  static const char *const MODE_NAMES[] = {"off", "report", "chase"};
+  static const char *const SOURCE_NAMES[] = {"no sync", "estimated", "TE"};
+  const Stats &s = order.stats();
+  Logger::infof("TearSync: %s, %s scan, period %lu us: %lu/%lu frames at "
+                "risk (%lu rects), %lu reordered, wait %lu us (max %lu "
+                "us/frame), push %lu ns/px",
+                MODE_NAMES[static_cast<uint8_t>(mode)],
+                SOURCE_NAMES[static_cast<uint8_t>(model.source())],
+                (unsigned long)model.periodUs(), (unsigned long)s.riskFrames,
+                (unsigned long)s.frames, (unsigned long)s.riskRects,
+                (unsigned long)s.reorderedFrames, (unsigned long)s.waitUs,
+                (unsigned long)s.maxFrameWaitUs, (unsigned long)s.nsPerPixel);
+}
+
+} // namespace TearSync
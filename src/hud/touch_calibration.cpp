@@ -2,6 +2,7 @@
 #include "logger.h"
 #include "pins.h"
 #include "storage.h"
+#include "touch_input.h"
 #include "touch_map.h" // For TouchConstants::SCREEN_WIDTH/HEIGHT
 #include <Arduino.h>
 
@@ -44,7 +45,6 @@ static const uint32_t INSTRUCTION_TIMEOUT = 60000; // 60 seconds (was 30)
 static const uint32_t POINT_TIMEOUT = 60000; // 60 seconds per point (was 30)
 
 // Touch controller constants
-static const uint16_t MAX_TOUCH_VALUE = 4095; // 12-bit ADC maximum
 static const uint32_t TOUCH_RELEASE_WAIT =
     200; // ms to wait for touch release (was 500)
 
@@ -55,6 +55,7 @@ static const uint16_t TOUCH_SAMPLE_MIN = 100;  // Minimum valid sample value
 static const uint16_t TOUCH_SAMPLE_MAX = 4000; // Maximum valid sample value
 
 // Forward declarations
+static bool screenTouched();
 static void drawCalibrationPoint(int x, int y, uint16_t color);
 static void drawInstructions();
 static bool collectTouchSample(uint16_t &avgX, uint16_t &avgY);
@@ -109,8 +110,7 @@ bool update() {
 
   // Non-blocking touch release wait
   if (waitingForRelease) {
-    uint16_t tx, ty;
-    if (!tft->getTouch(&tx, &ty)) {
+    if (!screenTouched()) {
       // Touch released
       waitingForRelease = false;
     } else if (now - releaseWaitStart > TOUCH_RELEASE_WAIT) {
@@ -124,8 +124,7 @@ bool update() {
   switch (state) {
   case CalibrationState::Instructions: {
     // Wait for any touch to proceed
-    uint16_t tx, ty;
-    if (tft->getTouch(&tx, &ty)) {
+    if (screenTouched()) {
       // Touch detected - initiate non-blocking wait for release
       waitingForRelease = true;
       releaseWaitStart = now;
@@ -219,8 +218,7 @@ bool update() {
 
   case CalibrationState::Verification: {
     // Wait for touch to confirm or timeout to auto-complete
-    uint16_t tx, ty;
-    if (tft->getTouch(&tx, &ty) || (now - stateStartTime > 3000)) {
+    if (screenTouched() || (now - stateStartTime > 3000)) {
       state = CalibrationState::Complete;
       Logger::info("TouchCalibration: Calibration complete!");
     }
@@ -260,12 +258,8 @@ bool applyCalibration(const uint16_t calibData[5]) {
     return false;
   }
 
-  // Apply to TFT_eSPI (need non-const pointer)
-  uint16_t tempCalibData[5];
-  for (int i = 0; i < 5; i++) {
-    tempCalibData[i] = calibData[i];
-  }
-  tft->setTouch(tempCalibData);
+  // Apply to the TouchInput task (takes effect on its next sample)
+  TouchInput::setCalibration(calibData);
 
   // Save to storage
   for (int i = 0; i < 5; i++) {
@@ -286,6 +280,12 @@ bool applyCalibration(const uint16_t calibData[5]) {
 // Internal helper functions
 // ========================================================================
 
+// Pen state from the TouchInput task (filtered, latest sample)
+static bool screenTouched() {
+  int16_t x, y;
+  return TouchInput::read(x, y);
+}
+
 static void drawCalibrationPoint(int x, int y, uint16_t color) {
   // Draw crosshair target - direct TFT access (no sprite)
   tft->fillCircle(x, y, CALIB_RADIUS, color);
@@ -328,7 +328,7 @@ static bool collectTouchSample(uint16_t &avgX, uint16_t &avgY) {
   uint16_t tx, ty;
 
   // Get raw touch values (before calibration)
-  if (tft->getTouch(&tx, &ty)) {
+  if (TouchInput::readRaw(tx, ty)) {
     if (now - lastSampleTime >= SAMPLE_INTERVAL) {
       sumX += tx;
       sumY += ty;
@@ -397,58 +397,18 @@ static void calculateCalibration() {
   // Point 1: Top-left (CALIB_MARGIN, CALIB_MARGIN)
   // Point 2: Bottom-right (SCREEN_WIDTH - CALIB_MARGIN, SCREEN_HEIGHT -
   // CALIB_MARGIN)
-
-  uint16_t minX = point1_rawX;
-  uint16_t maxX = point2_rawX;
-  uint16_t minY = point1_rawY;
-  uint16_t maxY = point2_rawY;
-
-  // Ensure proper ordering
-  if (minX > maxX) {
-    uint16_t temp = minX;
-    minX = maxX;
-    maxX = temp;
-  }
-  if (minY > maxY) {
-    uint16_t temp = minY;
-    minY = maxY;
-    maxY = temp;
-  }
-
-  // Apply margin compensation
-  // The screen coordinates we touched were CALIB_MARGIN from edge
-  // So we need to extrapolate to the actual edges (0, 0) and (SCREEN_WIDTH,
-  // SCREEN_HEIGHT)
-  float scaleX = (float)(TouchConstants::SCREEN_WIDTH) /
-                 (float)(TouchConstants::SCREEN_WIDTH - 2 * CALIB_MARGIN);
-  float scaleY = (float)(TouchConstants::SCREEN_HEIGHT) /
-                 (float)(TouchConstants::SCREEN_HEIGHT - 2 * CALIB_MARGIN);
-
-  uint16_t rangeX = maxX - minX;
-  uint16_t rangeY = maxY - minY;
-
-  uint16_t extrapolateX = (uint16_t)(rangeX * (scaleX - 1.0f) / 2.0f);
-  uint16_t extrapolateY = (uint16_t)(rangeY * (scaleY - 1.0f) / 2.0f);
-
-  minX = (minX > extrapolateX) ? (minX - extrapolateX) : 0;
-  maxX = ((uint32_t)maxX + (uint32_t)extrapolateX < MAX_TOUCH_VALUE)
-             ? (maxX + extrapolateX)
-             : MAX_TOUCH_VALUE;
-  minY = ((uint32_t)minY > (uint32_t)extrapolateY) ? (minY - extrapolateY) : 0;
-  maxY = ((uint32_t)maxY + (uint32_t)extrapolateY < MAX_TOUCH_VALUE)
-             ? (maxY + extrapolateY)
-             : MAX_TOUCH_VALUE;
-
-  // Store calibration result
-  result.calibData[0] = minX;
-  result.calibData[1] = maxX;
-  result.calibData[2] = minY;
-  result.calibData[3] = maxY;
-  result.calibData[4] = tft->getRotation(); // Store current display rotation
+  // Extrapolated to the raw values at the screen edges, keeping each axis
+  // direction (an inverted axis stays inverted instead of being sorted)
+  TouchInput::RawSample p1 = {point1_rawX, point1_rawY, 0};
+  TouchInput::RawSample p2 = {point2_rawX, point2_rawY, 0};
+  TouchInput::calibrationFromPoints(
+      p1, p2, CALIB_MARGIN, TouchConstants::SCREEN_WIDTH,
+      TouchConstants::SCREEN_HEIGHT, tft->getRotation(), result.calibData);
   result.success = true;
 
   Logger::infof("TouchCalibration: Calculated calibration [%d, %d, %d, %d, %d]",
-                minX, maxX, minY, maxY, result.calibData[4]);
+                result.calibData[0], result.calibData[1], result.calibData[2],
+                result.calibData[3], result.calibData[4]);
 
   snprintf(result.message, sizeof(result.message), "Calibration successful!");
 }
@@ -469,16 +429,16 @@ static void drawVerification() {
   y += 25;
 
   char buf[64];
-  snprintf(buf, sizeof(buf), "Min X: %d", result.calibData[0]);
+  snprintf(buf, sizeof(buf), "Left X: %d", result.calibData[0]);
   tft->drawString(buf, 60, y, 2);
   y += 20;
-  snprintf(buf, sizeof(buf), "Max X: %d", result.calibData[1]);
+  snprintf(buf, sizeof(buf), "Right X: %d", result.calibData[1]);
   tft->drawString(buf, 60, y, 2);
   y += 20;
-  snprintf(buf, sizeof(buf), "Min Y: %d", result.calibData[2]);
+  snprintf(buf, sizeof(buf), "Top Y: %d", result.calibData[2]);
   tft->drawString(buf, 60, y, 2);
   y += 20;
-  snprintf(buf, sizeof(buf), "Max Y: %d", result.calibData[3]);
+  snprintf(buf, sizeof(buf), "Bottom Y: %d", result.calibData[3]);
   tft->drawString(buf, 60, y, 2);
   y += 25;
 
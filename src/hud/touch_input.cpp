@@ -0,0 +1,181 @@
+// touch_input.cpp - Touch filtering, calibration and gestures (pure)
+#include "touch_input.h"
+
+namespace TouchInput {
+
+// ============================================================================
+// Filter
+// ============================================================================
+
+static uint16_t median(uint16_t *v, uint8_t n) {
+  for (uint8_t i = 1; i < n; i++) { // Insertion sort: n <= MEDIAN_TAPS
+    uint16_t key = v[i];
+    int8_t j = i - 1;
+    while (j >= 0 && v[j] > key) {
+      v[j + 1] = v[j];
+      j--;
+    }
+    v[j + 1] = key;
+  }
+  return v[n / 2];
+}
+
+bool Filter::update(const RawSample *samples, uint8_t n, RawSample &out) {
+  uint16_t xs[MEDIAN_TAPS], ys[MEDIAN_TAPS], zs[MEDIAN_TAPS];
+  uint8_t pressed = 0;
+  for (uint8_t i = 0; i < n && i < MEDIAN_TAPS; i++) {
+    if (samples[i].z < PRESSURE_MIN) continue;
+    xs[pressed] = samples[i].x;
+    ys[pressed] = samples[i].y;
+    zs[pressed] = samples[i].z;
+    pressed++;
+  }
+  // Pen lifting mid-sample: a minority of valid conversions is noise
+  if (pressed == 0 || pressed * 2 <= n) return false;
+
+  int32_t mx = median(xs, pressed);
+  int32_t my = median(ys, pressed);
+  if (!primed_) {
+    xq8_ = mx << 8;
+    yq8_ = my << 8;
+    primed_ = true;
+  } else {
+    xq8_ += (((mx << 8) - xq8_) * IIR_ALPHA_Q8) / 256;
+    yq8_ += (((my << 8) - yq8_) * IIR_ALPHA_Q8) / 256;
+  }
+  out.x = static_cast<uint16_t>((xq8_ + 128) >> 8);
+  out.y = static_cast<uint16_t>((yq8_ + 128) >> 8);
+  out.z = median(zs, pressed);
+  return true;
+}
+
+// ============================================================================
+// Calibration
+// ============================================================================
+
+bool Calibration::set(const uint16_t cal[5], int16_t width, int16_t height) {
+  if (cal == nullptr || width <= 0 || height <= 0) return false;
+  for (uint8_t i = 0; i < 4; i++) {
+    if (cal[i] > RAW_MAX) return false;
+  }
+  if (cal[0] == cal[1] || cal[2] == cal[3]) return false;
+
+  x0_ = cal[0];
+  y0_ = cal[2];
+  kx_ = static_cast<int32_t>((static_cast<int64_t>(width) << 16) /
+                             (static_cast<int32_t>(cal[1]) - cal[0]));
+  ky_ = static_cast<int32_t>((static_cast<int64_t>(height) << 16) /
+                             (static_cast<int32_t>(cal[3]) - cal[2]));
+  w_ = width;
+  h_ = height;
+  valid_ = true;
+  return true;
+}
+
+static int16_t clampAxis(int64_t v, int16_t size) {
+  if (v < 0) return 0;
+  if (v >= size) return size - 1;
+  return static_cast<int16_t>(v);
+}
+
+Point Calibration::map(uint16_t rawX, uint16_t rawY) const {
+  if (!valid_) return {0, 0};
+  int64_t x = (static_cast<int64_t>(rawX - x0_) * kx_) >> 16;
+  int64_t y = (static_cast<int64_t>(rawY - y0_) * ky_) >> 16;
+  return {clampAxis(x, w_), clampAxis(y, h_)};
+}
+
+static uint16_t extrapolate(int32_t raw1, int32_t raw2, int16_t margin,
+                            int16_t size, bool far) {
+  int32_t span = size - 2 * margin;
+  if (span <= 0) span = size;
+  int32_t ext = (raw2 - raw1) * margin / span;
+  int32_t v = far ? raw2 + ext : raw1 - ext;
+  if (v < 0) v = 0;
+  if (v > RAW_MAX) v = RAW_MAX;
+  return static_cast<uint16_t>(v);
+}
+
+void calibrationFromPoints(RawSample p1, RawSample p2, int16_t margin,
+                           int16_t width, int16_t height, uint8_t rotation,
+                           uint16_t cal[5]) {
+  cal[0] = extrapolate(p1.x, p2.x, margin, width, false);
+  cal[1] = extrapolate(p1.x, p2.x, margin, width, true);
+  cal[2] = extrapolate(p1.y, p2.y, margin, height, false);
+  cal[3] = extrapolate(p1.y, p2.y, margin, height, true);
+  cal[4] = rotation;
+}
+
+// ============================================================================
+// GestureTracker
+// ============================================================================
+
+void GestureTracker::reset() {
+  down_ = false;
+  dragging_ = false;
+  longFired_ = false;
+  upCount_ = 0;
+}
+
+Event GestureTracker::make(EventType type, int16_t x, int16_t y,
+                           uint32_t nowMs) const {
+  Event e;
+  e.type = type;
+  e.x = x;
+  e.y = y;
+  e.dx = static_cast<int16_t>(x - startX_);
+  e.dy = static_cast<int16_t>(y - startY_);
+  e.timeMs = nowMs;
+  e.durationMs = nowMs - startMs_;
+  return e;
+}
+
+uint8_t GestureTracker::update(bool pressed, int16_t x, int16_t y,
+                               uint32_t nowMs, Event out[2]) {
+  uint8_t n = 0;
+
+  if (pressed) {
+    upCount_ = 0;
+    if (!down_) {
+      down_ = true;
+      dragging_ = false;
+      longFired_ = false;
+      startX_ = lastX_ = x;
+      startY_ = lastY_ = y;
+      startMs_ = nowMs;
+      out[n++] = make(EventType::DOWN, x, y, nowMs);
+      return n;
+    }
+
+    int32_t dx = x - startX_;
+    int32_t dy = y - startY_;
+    if (!dragging_ && dx * dx + dy * dy > DRAG_SLOP_PX * DRAG_SLOP_PX) {
+      dragging_ = true;
+      out[n++] = make(EventType::DRAG_START, x, y, nowMs);
+    } else if (dragging_ && (x != lastX_ || y != lastY_)) {
+      out[n++] = make(EventType::DRAG, x, y, nowMs);
+    }
+    if (!dragging_ && !longFired_ && nowMs - startMs_ >= LONG_PRESS_MS) {
+      longFired_ = true;
+      out[n++] = make(EventType::LONG_PRESS, x, y, nowMs);
+    }
+    lastX_ = x;
+    lastY_ = y;
+    return n;
+  }
+
+  if (!down_) return 0;
+  if (++upCount_ < RELEASE_SAMPLES) return 0; // Pressure flicker
+
+  down_ = false;
+  upCount_ = 0;
+  if (dragging_) {
+    out[n++] = make(EventType::DRAG_END, lastX_, lastY_, nowMs);
+  } else if (!longFired_) {
+    out[n++] = make(EventType::TAP, lastX_, lastY_, nowMs);
+  }
+  out[n++] = make(EventType::UP, lastX_, lastY_, nowMs);
+  return n;
+}
+
+} // namespace TouchInput
@@ -0,0 +1,242 @@
+// touch_input_xpt2046.cpp - TouchInput sampling task on the XPT2046
+#include "logger.h"
+#include "pins.h"
+#include "rtos_tasks.h"
+#include "spi_bus.h"
+#include "touch_input.h"
+#include "touch_map.h"
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+#include <driver/gpio.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+
+// Shared with the display: conversions go through the TFT_eSPI touch driver
+extern TFT_eSPI *tft;
+
+namespace TouchInput {
+
+// DRAG updates are dropped first so DOWN/TAP/UP always fit in the queue
+constexpr UBaseType_t DRAG_RESERVE = 4;
+
+static QueueHandle_t queue = nullptr;
+static TaskHandle_t task = nullptr;
+static bool irqDriven = false;
+static volatile uint32_t penIrqUs = 0;
+
+static portMUX_TYPE stateMux = portMUX_INITIALIZER_UNLOCKED;
+static Calibration calibration;       // stateMux
+static bool penDown = false;          // stateMux
+static Point lastPoint = {0, 0};      // stateMux
+static RawSample lastRaw = {0, 0, 0}; // stateMux
+static Stats stats = {};
+
+static void IRAM_ATTR onPenIrq() {
+  // PENIRQ toggles during conversions: masked until the pen is released
+  gpio_intr_disable(static_cast<gpio_num_t>(PIN_TOUCH_IRQ));
+  penIrqUs = micros();
+  stats.irqs++;
+  BaseType_t woken = pdFALSE;
+  vTaskNotifyGiveFromISR(task, &woken);
+  if (woken) portYIELD_FROM_ISR();
+}
+
+// Touch grant: queued ahead of display pushes, the frame yields at its next
+// layer or dirty rect
+static bool lockBus() {
+  uint32_t t0 = micros();
+  if (!SpiBus::acquire(SpiBus::Device::TOUCH, BUS_WAIT_MS)) {
+    stats.busTimeouts++;
+    return false;
+  }
+  uint32_t waited = micros() - t0;
+  if (waited > stats.maxBusWaitUs) stats.maxBusWaitUs = waited;
+  return true;
+}
+
+// Pressure-only check for the idle poll: one conversion instead of a sample
+static bool pressureDetected() {
+  if (!lockBus()) return false;
+  uint16_t z = tft->getTouchRawZ();
+  SpiBus::release(SpiBus::Device::TOUCH);
+  return z >= PRESSURE_MIN;
+}
+
+static bool readConversions(RawSample raw[MEDIAN_TAPS]) {
+  if (!lockBus()) return false;
+  for (uint8_t i = 0; i < MEDIAN_TAPS; i++) {
+    tft->getTouchRaw(&raw[i].x, &raw[i].y);
+    raw[i].z = tft->getTouchRawZ();
+  }
+  SpiBus::release(SpiBus::Device::TOUCH);
+  return true;
+}
+
+static void post(const Event &ev, uint32_t detectUs) {
+  if (ev.type == EventType::DRAG &&
+      uxQueueSpacesAvailable(queue) < DRAG_RESERVE) {
+    stats.dropped++;
+    return;
+  }
+  if (xQueueSend(queue, &ev, 0) != pdTRUE) {
+    stats.dropped++;
+    return;
+  }
+  stats.events++;
+  if (ev.type == EventType::DOWN) {
+    uint32_t latency = micros() - detectUs;
+    if (latency > stats.maxPenToEventUs) stats.maxPenToEventUs = latency;
+  }
+}
+
+// Samples one press at SAMPLE_PERIOD_MS until the tracker sees the release
+static void trackPress(uint32_t detectUs) {
+  Filter filter;
+  GestureTracker gestures;
+  TickType_t wake = xTaskGetTickCount();
+
+  for (;;) {
+    RawSample raw[MEDIAN_TAPS];
+    RawSample filtered = {0, 0, 0};
+    bool pressed =
+        readConversions(raw) && filter.update(raw, MEDIAN_TAPS, filtered);
+
+    Point p = {0, 0};
+    portENTER_CRITICAL(&stateMux);
+    if (pressed) {
+      p = calibration.map(filtered.x, filtered.y);
+      lastPoint = p;
+      lastRaw = filtered;
+    }
+    penDown = pressed;
+    portEXIT_CRITICAL(&stateMux);
+    if (pressed) stats.samples++;
+
+    Event ev[2];
+    uint8_t n = gestures.update(pressed, p.x, p.y, millis(), ev);
+    for (uint8_t i = 0; i < n; i++) post(ev[i], detectUs);
+
+    if (!pressed && !gestures.isDown()) return;
+    vTaskDelayUntil(&wake, pdMS_TO_TICKS(SAMPLE_PERIOD_MS));
+  }
+}
+
+static void touchTask(void *) {
+  for (;;) {
+    uint32_t detectUs;
+    if (irqDriven) {
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+      detectUs = penIrqUs;
+    } else {
+      vTaskDelay(pdMS_TO_TICKS(IDLE_POLL_MS));
+      if (!pressureDetected()) continue;
+      detectUs = micros();
+    }
+
+    trackPress(detectUs);
+
+    if (irqDriven) {
+      gpio_intr_enable(static_cast<gpio_num_t>(PIN_TOUCH_IRQ));
+    }
+  }
+}
+
+bool init(const uint16_t cal[5]) {
+  if (task != nullptr) return true;
+  if (tft == nullptr) return false;
+
+  setCalibration(cal);
+  if (!calibration.isValid()) return false;
+
+  queue = xQueueCreate(QUEUE_DEPTH, sizeof(Event));
+  if (queue == nullptr) {
+    Logger::error("Touch: event queue allocation failed");
+    return false;
+  }
+
+  // Same core as the HUD task, one level above it so a press is sampled
+  // as soon as the current frame releases the bus
+  if (xTaskCreatePinnedToCore(touchTask, "TouchInput", TASK_STACK, nullptr,
+                              RTOSTasks::PRIORITY_GENERAL_EXEC + 1, &task,
+                              RTOSTasks::CORE_GENERAL) != pdPASS) {
+    Logger::error("Touch: input task creation failed");
+    vQueueDelete(queue);
+    queue = nullptr;
+    task = nullptr;
+    return false;
+  }
+
+  if (PIN_TOUCH_IRQ >= 0) {
+    pinMode(PIN_TOUCH_IRQ, INPUT_PULLUP);
+    irqDriven = true;
+    attachInterrupt(digitalPinToInterrupt(PIN_TOUCH_IRQ), onPenIrq, FALLING);
+  }
+  return true;
+}
+
+bool isRunning() { return task != nullptr; }
+
+bool isIrqDriven() { return irqDriven; }
+
+void setCalibration(const uint16_t cal[5]) {
+  Calibration next;
+  if (!next.set(cal, TouchConstants::SCREEN_WIDTH,
+                TouchConstants::SCREEN_HEIGHT)) {
+    Logger::warn("Touch: calibration rejected (degenerate axis)");
+    return;
+  }
+  portENTER_CRITICAL(&stateMux);
+  calibration = next;
+  portEXIT_CRITICAL(&stateMux);
+}
+
+bool poll(Event &out) {
+  if (queue == nullptr || xQueueReceive(queue, &out, 0) != pdTRUE) {
+    return false;
+  }
+  uint32_t lag = millis() - out.timeMs;
+  if (lag > stats.maxQueueLagMs) stats.maxQueueLagMs = lag;
+  return true;
+}
+
+bool read(int16_t &x, int16_t &y) {
+  portENTER_CRITICAL(&stateMux);
+  bool down = penDown;
+  x = lastPoint.x;
+  y = lastPoint.y;
+  portEXIT_CRITICAL(&stateMux);
+  return down;
+}
+
+bool readRaw(uint16_t &x, uint16_t &y) {
+  portENTER_CRITICAL(&stateMux);
+  bool down = penDown;
+  x = lastRaw.x;
+  y = lastRaw.y;
+  portEXIT_CRITICAL(&stateMux);
+  return down;
+}
+
+void getStats(Stats &out) { out = stats; }
+
+void logStats() {
+  if (task == nullptr) return;
+  if (irqDriven) {
+    Logger::infof("Touch: %lu samples, %lu events (%lu dropped), %lu PENIRQ",
+                  (unsigned long)stats.samples, (unsigned long)stats.events,
+                  (unsigned long)stats.dropped, (unsigned long)stats.irqs);
+  } else {
+    Logger::infof("Touch: %lu samples, %lu events (%lu dropped), idle poll",
+                  (unsigned long)stats.samples, (unsigned long)stats.events,
+                  (unsigned long)stats.dropped);
+  }
+  Logger::infof("Touch: pen->event max %lu us, queue lag max %lu ms, bus "
+                "wait max %lu us (%lu timeouts)",
+                (unsigned long)stats.maxPenToEventUs,
+                (unsigned long)stats.maxQueueLagMs,
+                (unsigned long)stats.maxBusWaitUs,
+                (unsigned long)stats.busTimeouts);
+}
+
+} // namespace TouchInput
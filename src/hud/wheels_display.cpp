@@ -253,13 +253,17 @@ void WheelsDisplay::init(TFT_eSPI *display) {
   tft = display;
   SafeDraw::init(tft); // 🚨 CRITICAL FIX: Initialize SafeDraw
   initialized = true;
+  invalidate();
+  Logger::info("WheelsDisplay init OK");
+}
+
+void WheelsDisplay::invalidate() {
   // Resetear cache de todas las ruedas
   for (int i = 0; i < 4; i++) {
     wheelCaches[i].lastAngle = -999.0f;
     wheelCaches[i].lastTemp = -999.0f;
     wheelCaches[i].lastEffort = -999.0f;
   }
-  Logger::info("WheelsDisplay init OK");
 }
 
 void WheelsDisplay::drawWheel(int cx, int cy, float angleDeg, float tempC,
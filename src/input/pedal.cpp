@@ -1,4 +1,5 @@
 #include "pedal.h"
+#include "limp_mode.h"
 #include "logger.h"
 #include "pins.h"
 #include "settings.h"
@@ -70,7 +71,7 @@ void Pedal::init() {
   initialized = true;
 }
 
-void Pedal::update() {
+static void readPedal() {
   // ========================================
   // Guard: Verificar inicialización PRIMERO
   // ========================================
@@ -188,6 +189,13 @@ void Pedal::update() {
   s.valid = true;
 }
 
+void Pedal::update() {
+  bool wasValid = s.valid;
+  readPedal();
+  // LimpMode solo re-evalúa las entradas cuando cambia la validez
+  if (s.valid != wasValid) LimpMode::notify(LimpMode::SOURCE_PEDAL);
+}
+
 void Pedal::setCalibration(int minAdc, int maxAdc, uint8_t curve) {
   adcMin = minAdc;
   adcMax = maxAdc;
@@ -1,4 +1,5 @@
 #include "steering.h"
+#include "limp_mode.h"
 #include "logger.h"
 #include "pins.h"
 #include "settings.h"
@@ -129,9 +130,10 @@ void Steering::init() {
 
   Logger::info("Steering init OK");
   initialized = true;
+  LimpMode::notify(LimpMode::SOURCE_STEERING);
 }
 
-void Steering::update() {
+static void readEncoder() {
   if (!cfg.steeringEnabled) {
     // Guard: si está desactivado → estado neutro
     s.ticks = 0;
@@ -258,6 +260,16 @@ void Steering::update() {
   }
 }
 
+void Steering::update() {
+  bool wasValid = s.valid;
+  bool wasCentered = s.centered;
+  readEncoder();
+  // LimpMode solo re-evalúa las entradas cuando cambia valid / centered
+  if (s.valid != wasValid || s.centered != wasCentered) {
+    LimpMode::notify(LimpMode::SOURCE_STEERING);
+  }
+}
+
 void Steering::center() {
   if (s.centered) return;
 
@@ -285,6 +297,7 @@ void Steering::center() {
         "Steering center fallback - Z not detected, using current position");
     System::logError(211); // código: fallo de centrado por Z
   }
+  LimpMode::notify(LimpMode::SOURCE_STEERING);
 }
 
 void Steering::setTicksPerTurn(long tpt) {
@@ -312,6 +325,7 @@ long Steering::getTicksPerTurn() { return ticksPerTurn; }
 void Steering::setZeroOffset(long offset) {
   zeroOffset = offset;
   s.centered = true;
+  LimpMode::notify(LimpMode::SOURCE_STEERING);
   Logger::infof("Steering zeroOffset set: %ld", zeroOffset);
 }
 
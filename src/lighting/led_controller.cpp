@@ -1,19 +1,24 @@
 #include "led_controller.h"
+#include "led_engine.h"
 #include "logger.h"
 #include "pins.h"
-#include "watchdog.h" // 🔒 v2.17.1: Watchdog protection for FastLED
 #include <Arduino.h>
+#include <freertos/FreeRTOS.h>
 
 namespace LEDController {
 
-// LED Arrays
-static CRGB frontLeds[LED_FRONT_COUNT];
-static CRGB rearLeds[LED_REAR_COUNT];
+using LedEngine::Rgb;
 
-// Current state
+// Engine outputs (order = LedEngine::backBuffer() index)
+enum Output : uint8_t { OUT_FRONT, OUT_REAR };
+
+// Current state - written by the setters (HUD/menus/System), read once per
+// frame by the LED task under stateMux
+static portMUX_TYPE stateMux = portMUX_INITIALIZER_UNLOCKED;
 static FrontMode currentFrontMode = FRONT_OFF;
 static RearMode currentRearMode = REAR_OFF;
 static TurnSignal currentTurnSignal = TURN_OFF;
+static bool frontRestart = false; // Mode changed: restart front animation
 
 // Configuration
 static Config config = {
@@ -29,9 +34,8 @@ struct EffectsConfig {
 };
 static EffectsConfig effectsConfig;
 
-// Animation state
-static uint32_t lastUpdateMs = 0;
-static uint16_t animationStep = 0; // 🔒 Se controla overflow en update()
+// Animation state (LED task only)
+static uint16_t animationStep = 0; // 🔒 Se controla overflow en renderFrame()
 static bool blinkState = false;
 static uint32_t lastBlinkMs = 0;
 static bool enabled = true;
@@ -43,10 +47,37 @@ static uint8_t emergencyFlashCount = 0;
 static uint8_t emergencyFlashCurrent = 0;
 static uint32_t emergencyFlashLastToggle = 0;
 static bool emergencyFlashOn = false;
-
-// KITT scanner state
-static int8_t scannerPos = 0;
-static int8_t scannerDirection = 1;
+static uint32_t emergencyFlashStartTime = 0;
+
+// Layer priorities (higher draws over lower)
+constexpr uint8_t PRIO_BASE = 10;      // Front animation, rear center
+constexpr uint8_t PRIO_ALERT = 20;     // ABS/TCS flash
+constexpr uint8_t PRIO_TURN = 30;      // Turn signals
+constexpr uint8_t PRIO_EMERGENCY = 90; // Emergency flash, over everything
+
+// Front strip: one base animation per mode, alert flash above it
+static LedEngine::ScannerLayer frontScanner(PRIO_BASE,
+                                           effectsConfig.kittTailLength,
+                                           FADE_RATE_KITT);
+static LedEngine::ChaseLayer frontChase(PRIO_BASE, FADE_RATE_CHASE);
+static LedEngine::RainbowLayer frontRainbow(PRIO_BASE);
+static LedEngine::FlashLayer frontAlert(PRIO_ALERT);
+static LedEngine::SolidLayer frontEmergency(PRIO_EMERGENCY, 0,
+                                            LED_FRONT_COUNT);
+static LedEngine::Strip frontStrip(LED_FRONT_COUNT);
+
+// Rear strip: center brake/position lights, turn signals on the ends
+static LedEngine::SolidLayer rearCenter(
+    PRIO_BASE, LED_REAR_CENTER_START,
+    LED_REAR_CENTER_END - LED_REAR_CENTER_START + 1);
+static LedEngine::BlinkerLayer
+    rearLeft(PRIO_TURN, LED_REAR_LEFT_START,
+             LED_REAR_LEFT_END - LED_REAR_LEFT_START + 1, LedEngine::AMBER);
+static LedEngine::BlinkerLayer
+    rearRight(PRIO_TURN, LED_REAR_RIGHT_START,
+              LED_REAR_RIGHT_END - LED_REAR_RIGHT_START + 1, LedEngine::AMBER);
+static LedEngine::SolidLayer rearEmergency(PRIO_EMERGENCY, 0, LED_REAR_COUNT);
+static LedEngine::Strip rearStrip(LED_REAR_COUNT);
 
 // 🔒 v2.4.1: Sine lookup table for performance optimization
 // Pre-calculated: sin(x * PI / 50) * 127 for x = 0..49 (half period)
@@ -63,239 +94,207 @@ static inline uint8_t fastSinLUT(uint8_t idx) {
   return SINE_LUT_50[idx % 50];
 }
 
-// Helper: blend two colors
-static CRGB blendColor(CRGB c1, CRGB c2, uint8_t amount) {
-  return CRGB((c1.r * (255 - amount) + c2.r * amount) / 255,
-              (c1.g * (255 - amount) + c2.g * amount) / 255,
-              (c1.b * (255 - amount) + c2.b * amount) / 255);
-}
-
 // Helper: get color from throttle percentage
-static CRGB getThrottleColor(float percent) {
+static Rgb getThrottleColor(float percent) {
+  using namespace LedEngine;
   if (percent < 25.0f) {
     // Red → Orange
-    return blendColor(CRGB::Red, CRGB::Orange, (uint8_t)(percent * 255 / 25));
+    return blend(RED, ORANGE, (uint8_t)(percent * 255 / 25));
   } else if (percent < 50.0f) {
     // Orange → Yellow
-    return blendColor(CRGB::Orange, CRGB::Yellow,
-                      (uint8_t)((percent - 25) * 255 / 25));
+    return blend(ORANGE, YELLOW, (uint8_t)((percent - 25) * 255 / 25));
   } else if (percent < 75.0f) {
     // Yellow → Green
-    return blendColor(CRGB::Yellow, CRGB::Green,
-                      (uint8_t)((percent - 50) * 255 / 25));
+    return blend(YELLOW, GREEN, (uint8_t)((percent - 50) * 255 / 25));
   } else {
     // Green → Blue
-    return blendColor(CRGB::Green, CRGB::Blue,
-                      (uint8_t)((percent - 75) * 255 / 25));
-  }
-}
-
-// KITT scanner effect
-static void updateKITTScanner(CRGB *leds, int count, CRGB color) {
-  // 🔒 Usar configuración para tailLength
-  int tailLength = effectsConfig.kittTailLength;
-
-  // Fade all LEDs
-  for (int i = 0; i < count; i++) {
-    leds[i].fadeToBlackBy(
-        FADE_RATE_KITT); // 🔒 Using constant instead of magic number
-  }
-
-  // Draw bright center LED
-  if (scannerPos >= 0 && scannerPos < count) { leds[scannerPos] = color; }
-
-  // Draw tail
-  for (int i = 1; i <= tailLength; i++) {
-    int pos = scannerPos - (i * scannerDirection);
-    if (pos >= 0 && pos < count) {
-      uint8_t brightness = 255 - (i * 255 / tailLength);
-      leds[pos] = color;
-      leds[pos].fadeToBlackBy(255 - brightness);
-    }
-  }
-
-  // Update scanner position
-  scannerPos += scannerDirection;
-  if (scannerPos >= count || scannerPos < 0) {
-    scannerDirection = -scannerDirection;
-    scannerPos += scannerDirection * 2;
-    // 🔒 Asegurar que scannerPos está dentro de límites
-    scannerPos = constrain(scannerPos, 0, count - 1);
-  }
-}
-
-// Chase effect (LEDs light up in sequence)
-static void updateChase(CRGB *leds, int count, CRGB color, uint8_t speed) {
-  if (count <= 0 || speed == 0) return; // 🔒 Protección división por cero
-
-  int pos = (animationStep / speed) % count;
-
-  // Fade all LEDs
-  for (int i = 0; i < count; i++) {
-    leds[i].fadeToBlackBy(
-        FADE_RATE_CHASE); // 🔒 Using constant instead of magic number
-  }
-
-  // Light up current position and tail
-  for (int i = 0; i < 5 && pos - i >= 0; i++) {
-    leds[pos - i] = color;
-    leds[pos - i].fadeToBlackBy(i * 50);
-  }
-}
-
-// Rainbow effect
-static void updateRainbow(CRGB *leds, int count, uint8_t speed) {
-  // 🔒 CORRECCIÓN 3.4: Protección división por cero
-  if (count <= 0) {
-    Logger::errorf("updateRainbow: count inválido %d", count);
-    return;
+    return blend(GREEN, BLUE, (uint8_t)((percent - 75) * 255 / 25));
   }
-
-  uint8_t hue = (animationStep * speed) & 0xFF;
-  uint8_t deltaHue = (count > 0) ? (256 / count) : 1;
-  fill_rainbow(leds, count, hue, deltaHue);
-}
-
-// Flash effect
-static void updateFlash(CRGB *leds, int count, CRGB color1, CRGB color2) {
-  CRGB color = blinkState ? color1 : color2;
-  fill_solid(leds, count, color);
 }
 
-// Update front LEDs based on current mode
-static void updateFrontLEDs() {
-  switch (currentFrontMode) {
-  case FRONT_OFF:
-    fill_solid(frontLeds, LED_FRONT_COUNT, CRGB::Black);
-    break;
-
-  case FRONT_KITT_IDLE:
-    updateKITTScanner(frontLeds, LED_FRONT_COUNT, CRGB::Red);
-    break;
-
+// Front layers for the current mode
+static void applyFrontMode(FrontMode mode) {
+  using namespace LedEngine;
+  frontScanner.setEnabled(mode == FRONT_KITT_IDLE || mode == FRONT_REVERSE);
+  frontScanner.setColor(mode == FRONT_REVERSE ? WHITE : RED);
+  frontChase.setEnabled(mode == FRONT_ACCEL_LOW || mode == FRONT_ACCEL_MED ||
+                        mode == FRONT_ACCEL_HIGH);
+  frontRainbow.setEnabled(mode == FRONT_ACCEL_MAX);
+  frontRainbow.setSpeed(effectsConfig.rainbowSpeed);
+  frontAlert.setEnabled(mode == FRONT_ABS_ALERT || mode == FRONT_TCS_ALERT);
+
+  switch (mode) {
   case FRONT_ACCEL_LOW:
-    updateChase(frontLeds, LED_FRONT_COUNT, getThrottleColor(12.5f),
-                effectsConfig.chaseSpeedLow);
+    frontChase.set(getThrottleColor(12.5f), effectsConfig.chaseSpeedLow);
     break;
-
   case FRONT_ACCEL_MED:
-    updateChase(frontLeds, LED_FRONT_COUNT, getThrottleColor(37.5f),
-                effectsConfig.chaseSpeedMed);
+    frontChase.set(getThrottleColor(37.5f), effectsConfig.chaseSpeedMed);
     break;
-
   case FRONT_ACCEL_HIGH:
-    updateChase(frontLeds, LED_FRONT_COUNT, getThrottleColor(62.5f),
-                effectsConfig.chaseSpeedHigh);
-    break;
-
-  case FRONT_ACCEL_MAX:
-    updateRainbow(frontLeds, LED_FRONT_COUNT, effectsConfig.rainbowSpeed);
+    frontChase.set(getThrottleColor(62.5f), effectsConfig.chaseSpeedHigh);
     break;
-
-  case FRONT_REVERSE:
-    updateKITTScanner(frontLeds, LED_FRONT_COUNT, CRGB::White);
-    break;
-
   case FRONT_ABS_ALERT:
-    updateFlash(frontLeds, LED_FRONT_COUNT, CRGB::Red, CRGB::White);
+    frontAlert.set(RED, WHITE);
     break;
-
   case FRONT_TCS_ALERT:
-    updateFlash(frontLeds, LED_FRONT_COUNT, CRGB::Orange, CRGB::Black);
+    frontAlert.set(ORANGE, BLACK);
+    break;
+  default:
     break;
   }
 }
 
 // Update rear center LEDs (brake/position/reverse)
-static void updateRearCenter() {
-  CRGB color = CRGB::Black;
+static void applyRearMode(RearMode mode) {
+  using namespace LedEngine;
+  Rgb color = BLACK;
   uint8_t brightness = 255;
 
-  switch (currentRearMode) {
+  switch (mode) {
   case REAR_OFF:
-    color = CRGB::Black;
+    color = BLACK;
     break;
 
   case REAR_POSITION:
-    color = CRGB::Red;
+    color = RED;
     brightness =
         BRIGHTNESS_POSITION_LIGHTS; // 🔒 Using constant: 20% brightness
     break;
 
   case REAR_BRAKE:
-    color = CRGB::Red;
+    color = RED;
     brightness = BRIGHTNESS_FULL; // 🔒 Using constant: 100% brightness
     break;
 
   case REAR_BRAKE_EMERGENCY:
-    color = blinkState ? CRGB::Red : CRGB::Black;
+    color = blinkState ? RED : BLACK;
     brightness = BRIGHTNESS_FULL; // 🔒 Using constant
     break;
 
   case REAR_REVERSE:
-    color = CRGB::White;
+    color = WHITE;
     brightness = BRIGHTNESS_FULL; // 🔒 Using constant
     break;
 
   case REAR_REGEN_ACTIVE:
     // Blue pulse effect - 🔒 v2.4.1: Use LUT instead of sin()
     brightness = 128 + fastSinLUT(animationStep % 100);
-    color = CRGB::Blue;
+    color = BLUE;
     break;
   }
 
-  // Apply to center LEDs (indices 3-12)
-  for (int i = LED_REAR_CENTER_START; i <= LED_REAR_CENTER_END; i++) {
-    rearLeds[i] = color;
-    rearLeds[i].fadeToBlackBy(255 - brightness);
+  rearCenter.setEnabled(true);
+  rearCenter.set(color, brightness);
+}
+
+// Rear turn signals; sequential effect in reverse
+static void applyTurnSignal(TurnSignal signal, RearMode mode) {
+  bool leftActive = (signal == TURN_LEFT || signal == TURN_HAZARD);
+  bool rightActive = (signal == TURN_RIGHT || signal == TURN_HAZARD);
+  bool sequential = (mode == REAR_REVERSE);
+  rearLeft.setEnabled(leftActive);
+  rearLeft.setSequential(sequential);
+  rearRight.setEnabled(rightActive);
+  rearRight.setSequential(sequential);
+}
+
+static void fillAll(Rgb color) {
+  for (uint8_t i = 0; i < LED_FRONT_COUNT; i++) {
+    LedEngine::backBuffer(OUT_FRONT)[i] = color;
+  }
+  for (uint8_t i = 0; i < LED_REAR_COUNT; i++) {
+    LedEngine::backBuffer(OUT_REAR)[i] = color;
   }
 }
 
-// Update rear turn signals
-static void updateTurnSignals() {
-  bool leftActive =
-      (currentTurnSignal == TURN_LEFT || currentTurnSignal == TURN_HAZARD);
-  bool rightActive =
-      (currentTurnSignal == TURN_RIGHT || currentTurnSignal == TURN_HAZARD);
-
-  // Amber color for turn signals
-  CRGB amber = CRGB(255, 100, 0);
-
-  // Left turn signal (indices 0-2)
-  if (leftActive) {
-    // Sequential effect for reverse mode
-    if (currentRearMode == REAR_REVERSE && blinkState) {
-      int pos = (animationStep / 10) % 3;
-      for (int i = 0; i < 3; i++) {
-        rearLeds[LED_REAR_LEFT_START + i] = (i == pos) ? amber : CRGB::Black;
+// Emergency flash (highest priority, non-blocking). Runs under stateMux
+// (startEmergencyFlash() may restart it from another task).
+// @return true if the safety timeout ended it
+static bool stepEmergencyFlash(uint32_t now) {
+  // 🔒 CORRECCIÓN 3.3: Timeout de seguridad para emergency flash
+  const uint32_t EMERGENCY_FLASH_MAX_DURATION_MS = 10000; // 10 segundos máximo
+  bool timedOut = false;
+
+  if (emergencyFlashStartTime == 0) { emergencyFlashStartTime = now; }
+
+  // Timeout de seguridad
+  if (now - emergencyFlashStartTime > EMERGENCY_FLASH_MAX_DURATION_MS) {
+    emergencyFlashActive = false;
+    timedOut = true;
+  } else if (now - emergencyFlashLastToggle >=
+             EMERGENCY_FLASH_INTERVAL_MS) { // 🔒 Using constant
+    // Toggle every 100ms
+    emergencyFlashLastToggle = now;
+    emergencyFlashOn = !emergencyFlashOn;
+    if (!emergencyFlashOn) {
+      emergencyFlashCurrent++;
+      // Check if we've completed all flashes
+      if (emergencyFlashCurrent >= emergencyFlashCount) {
+        emergencyFlashActive = false;
       }
-    } else {
-      fill_solid(&rearLeds[LED_REAR_LEFT_START], 3,
-                 blinkState ? amber : CRGB::Black);
     }
-  } else {
-    fill_solid(&rearLeds[LED_REAR_LEFT_START], 3, CRGB::Black);
   }
 
-  // Right turn signal (indices 13-15)
-  if (rightActive) {
-    // Sequential effect for reverse mode
-    if (currentRearMode == REAR_REVERSE && blinkState) {
-      int pos = (animationStep / 10) % 3;
-      for (int i = 0; i < 3; i++) {
-        rearLeds[LED_REAR_RIGHT_START + i] = (i == pos) ? amber : CRGB::Black;
-      }
-    } else {
-      fill_solid(&rearLeds[LED_REAR_RIGHT_START], 3,
-                 blinkState ? amber : CRGB::Black);
-    }
-  } else {
-    fill_solid(&rearLeds[LED_REAR_RIGHT_START], 3, CRGB::Black);
+  if (!emergencyFlashActive) {
+    emergencyFlashCurrent = 0;
+    emergencyFlashStartTime = 0; // reset timeout
+  }
+  return timedOut;
+}
+
+// LedEngine render callback (LED task): state -> layers -> back buffers
+static void renderFrame(uint32_t now) {
+  portENTER_CRITICAL(&stateMux);
+  FrontMode front = currentFrontMode;
+  RearMode rear = currentRearMode;
+  TurnSignal turn = currentTurnSignal;
+  bool restart = frontRestart;
+  frontRestart = false;
+  bool on = enabled;
+  bool flashTimedOut = emergencyFlashActive && stepEmergencyFlash(now);
+  bool flash = emergencyFlashActive;
+  Rgb flashColor = emergencyFlashOn ? LedEngine::RED : LedEngine::BLACK;
+  portEXIT_CRITICAL(&stateMux);
+
+  if (flashTimedOut) Logger::errorf("Emergency flash timeout - finalizando");
+  LedEngine::setPeriod(config.updateRateMs);
+
+  if (!on) {
+    // All off: one black frame goes out, then the strips are unchanged
+    fillAll(LedEngine::BLACK);
+    return;
+  }
+
+  if (restart) {
+    animationStep = 0;
+    frontScanner.restart();
+    frontChase.restart();
+  }
+
+  // 🔒 CORRECCIÓN 3.2: Prevenir overflow de animationStep
+  animationStep = (animationStep + 1) % 65536;
+
+  // Update blink state (500ms on/off for turn signals)
+  if (now - lastBlinkMs >= TURN_SIGNAL_BLINK_MS) { // 🔒 Using constant
+    blinkState = !blinkState;
+    lastBlinkMs = now;
   }
+
+  applyFrontMode(front);
+  applyRearMode(rear);
+  applyTurnSignal(turn, rear);
+  frontEmergency.setEnabled(flash);
+  rearEmergency.setEnabled(flash);
+  frontEmergency.set(flashColor);
+  rearEmergency.set(flashColor);
+
+  LedEngine::Tick tick = {now, animationStep, blinkState};
+  frontStrip.compose(LedEngine::backBuffer(OUT_FRONT), tick);
+  rearStrip.compose(LedEngine::backBuffer(OUT_REAR), tick);
 }
 
 void init() {
-  // 🔒 CORRECCIÓN 3.1: Validación de pines antes de inicializar FastLED
+  // 🔒 CORRECCIÓN 3.1: Validación de pines antes de inicializar el RMT
   if (LED_FRONT_PIN < 0 || LED_REAR_PIN < 0) {
     Logger::warnf("LEDs deshabilitados por configuración (front=%d, rear=%d)",
                   LED_FRONT_PIN, LED_REAR_PIN);
@@ -323,11 +322,23 @@ void init() {
     return;
   }
 
-#if (LED_FRONT_PIN >= 0) && (LED_REAR_PIN >= 0)
-  // Initialize FastLED solo si los pines son válidos en compilación
-  FastLED.addLeds<WS2812B, LED_FRONT_PIN, GRB>(frontLeds, LED_FRONT_COUNT);
-  FastLED.addLeds<WS2812B, LED_REAR_PIN, GRB>(rearLeds, LED_REAR_COUNT);
-#endif
+  const LedEngine::Output outputs[] = {{LED_FRONT_PIN, LED_FRONT_COUNT},
+                                       {LED_REAR_PIN, LED_REAR_COUNT}};
+  if (!LedEngine::begin(outputs, 2)) {
+    enabled = false;
+    hardwareOK = false;
+    return;
+  }
+
+  frontStrip.add(frontScanner);
+  frontStrip.add(frontChase);
+  frontStrip.add(frontRainbow);
+  frontStrip.add(frontAlert);
+  frontStrip.add(frontEmergency);
+  rearStrip.add(rearCenter);
+  rearStrip.add(rearLeft);
+  rearStrip.add(rearRight);
+  rearStrip.add(rearEmergency);
 
   // 🔒 CORRECCIÓN 3.2: Limitar brillo máximo para seguridad
   const uint8_t MAX_SAFE_BRIGHTNESS = 200;
@@ -338,25 +349,23 @@ void init() {
   }
 
   // Set initial brightness
-  FastLED.setBrightness(config.brightness);
+  LedEngine::setBrightness(config.brightness);
 
   // 🔒 Test de comunicación básico con hardware
-  fill_solid(frontLeds, LED_FRONT_COUNT, CRGB::Blue);
-  fill_solid(rearLeds, LED_REAR_COUNT, CRGB::Blue);
-
-  // 🔒 v2.17.1: Feed watchdog before FastLED.show() (can take >10ms with
-  // interrupts disabled)
-  Watchdog::feed();
-  FastLED.show();
+  // show() espera al fin de la transmisión sin deshabilitar interrupciones
+  fillAll(LedEngine::BLUE);
+  bool txOK = LedEngine::show(20);
   delay(100);
 
   // Apagar LEDs después del test
-  fill_solid(frontLeds, LED_FRONT_COUNT, CRGB::Black);
-  fill_solid(rearLeds, LED_REAR_COUNT, CRGB::Black);
-  Watchdog::feed();
-  FastLED.show();
+  fillAll(LedEngine::BLACK);
+  txOK = LedEngine::show(20) && txOK;
+  if (!txOK) Logger::warn("LED Controller: self-test transmit timed out");
 
-  lastUpdateMs = millis();
+  if (!LedEngine::start(config.updateRateMs, renderFrame)) {
+    hardwareOK = false;
+    return;
+  }
   hardwareOK = true;
 
   Logger::info("LED Controller initialized OK");
@@ -368,95 +377,13 @@ void init() {
 
 bool initOK() { return hardwareOK; }
 
-void update() {
-  if (!enabled || !hardwareOK) return; // 🔒 Verificar hardware OK
-
-  uint32_t now = millis();
-
-  // Handle emergency flash (highest priority, non-blocking)
-  if (emergencyFlashActive) {
-    // 🔒 CORRECCIÓN 3.3: Timeout de seguridad para emergency flash
-    static unsigned long emergencyFlashStartTime = 0;
-    const unsigned long EMERGENCY_FLASH_MAX_DURATION_MS =
-        10000; // 10 segundos máximo
-
-    if (emergencyFlashStartTime == 0) { emergencyFlashStartTime = now; }
-
-    // Timeout de seguridad
-    if (now - emergencyFlashStartTime > EMERGENCY_FLASH_MAX_DURATION_MS) {
-      Logger::errorf("Emergency flash timeout - finalizando");
-      emergencyFlashActive = false;
-      emergencyFlashCurrent = 0;
-      emergencyFlashStartTime = 0;
-      return;
-    }
-
-    // Toggle every 100ms
-    if (now - emergencyFlashLastToggle >=
-        EMERGENCY_FLASH_INTERVAL_MS) { // 🔒 Using constant
-      emergencyFlashLastToggle = now;
-      emergencyFlashOn = !emergencyFlashOn;
-
-      if (emergencyFlashOn) {
-        fill_solid(frontLeds, LED_FRONT_COUNT, CRGB::Red);
-        fill_solid(rearLeds, LED_REAR_COUNT, CRGB::Red);
-      } else {
-        fill_solid(frontLeds, LED_FRONT_COUNT, CRGB::Black);
-        fill_solid(rearLeds, LED_REAR_COUNT, CRGB::Black);
-        emergencyFlashCurrent++;
-
-        // Check if we've completed all flashes
-        if (emergencyFlashCurrent >= emergencyFlashCount) {
-          emergencyFlashActive = false;
-          emergencyFlashCurrent = 0;
-          emergencyFlashStartTime = 0; // reset timeout
-        }
-      }
-
-      // 🔒 v2.17.1: Feed watchdog before FastLED.show()
-      // FastLED.show() disables interrupts and can take >10ms with 44 LEDs
-      Watchdog::feed();
-      FastLED.show();
-    }
-    return; // Skip normal update during emergency flash
-  }
-
-  // Normal animation update
-  if (now - lastUpdateMs >= config.updateRateMs) {
-    // 🔒 CORRECCIÓN 3.2: Prevenir overflow de animationStep
-    animationStep = (animationStep + 1) % 65536;
-    lastUpdateMs = now;
-
-    // Update blink state (500ms on/off for turn signals)
-    if (now - lastBlinkMs >= TURN_SIGNAL_BLINK_MS) { // 🔒 Using constant
-      blinkState = !blinkState;
-      lastBlinkMs = now;
-    }
-
-    // Update LED patterns
-    updateFrontLEDs();
-    updateRearCenter();
-    updateTurnSignals();
-
-    // 🔒 v2.17.1: Feed watchdog before FastLED.show()
-    // FastLED.show() disables interrupts globally and can take >10ms
-    // With 44 LEDs total (28 front + 16 rear) at 800kHz, transmission takes
-    // ~4.4ms Plus RMT setup overhead, this can exceed 10ms and risk watchdog
-    // timeout
-    Watchdog::feed();
-
-    // Show LEDs
-    FastLED.show();
-  }
-}
-
 void setFrontMode(FrontMode mode) {
+  portENTER_CRITICAL(&stateMux);
   if (currentFrontMode != mode) {
     currentFrontMode = mode;
-    animationStep = 0;
-    scannerPos = 0;
-    scannerDirection = 1;
+    frontRestart = true;
   }
+  portEXIT_CRITICAL(&stateMux);
 }
 
 void setFrontFromThrottle(float throttlePercent) {
@@ -473,9 +400,17 @@ void setFrontFromThrottle(float throttlePercent) {
   }
 }
 
-void setRearMode(RearMode mode) { currentRearMode = mode; }
+void setRearMode(RearMode mode) {
+  portENTER_CRITICAL(&stateMux);
+  currentRearMode = mode;
+  portEXIT_CRITICAL(&stateMux);
+}
 
-void setTurnSignal(TurnSignal signal) { currentTurnSignal = signal; }
+void setTurnSignal(TurnSignal signal) {
+  portENTER_CRITICAL(&stateMux);
+  currentTurnSignal = signal;
+  portEXIT_CRITICAL(&stateMux);
+}
 
 void setBrightness(uint8_t brightness) {
   // 🔒 CORRECCIÓN 3.2: Limitar brillo máximo para seguridad (prevenir
@@ -489,28 +424,29 @@ void setBrightness(uint8_t brightness) {
   }
 
   config.brightness = brightness;
-  FastLED.setBrightness(brightness);
+  LedEngine::setBrightness(brightness);
   Logger::infof("LED brightness set: %d", brightness);
 }
 
 void setEnabled(bool en) {
+  // Disabled: the next frame is all black (LedEngine task)
+  portENTER_CRITICAL(&stateMux);
   enabled = en;
-  if (!enabled) {
-    fill_solid(frontLeds, LED_FRONT_COUNT, CRGB::Black);
-    fill_solid(rearLeds, LED_REAR_COUNT, CRGB::Black);
-    FastLED.show();
-  }
+  portEXIT_CRITICAL(&stateMux);
 }
 
 Config &getConfig() { return config; }
 
 void startEmergencyFlash(uint8_t count) {
   // Start non-blocking emergency flash
+  portENTER_CRITICAL(&stateMux);
   emergencyFlashActive = true;
   emergencyFlashCount = count;
   emergencyFlashCurrent = 0;
   emergencyFlashOn = false;
   emergencyFlashLastToggle = millis();
+  emergencyFlashStartTime = 0;
+  portEXIT_CRITICAL(&stateMux);
   Logger::infof("Emergency flash started: %d cycles", count);
 }
 
@@ -0,0 +1,210 @@
+// led_engine.cpp - LED layers, compositing and WS2812 encoding (pure)
+#include "led_engine.h"
+
+namespace LedEngine {
+
+// ============================================================================
+// Colour helpers
+// ============================================================================
+
+static uint8_t scale8(uint8_t v, uint8_t s) {
+  return static_cast<uint8_t>((static_cast<uint16_t>(v) * (s + 1)) >> 8);
+}
+
+Rgb scale(Rgb c, uint8_t s) {
+  return {scale8(c.r, s), scale8(c.g, s), scale8(c.b, s)};
+}
+
+Rgb blend(Rgb a, Rgb b, uint8_t amount) {
+  const uint8_t inv = 255 - amount;
+  return {static_cast<uint8_t>((a.r * inv + b.r * amount) / 255),
+          static_cast<uint8_t>((a.g * inv + b.g * amount) / 255),
+          static_cast<uint8_t>((a.b * inv + b.b * amount) / 255)};
+}
+
+Rgb hue(uint8_t h) {
+  // Six 43-step sectors of the colour wheel
+  const uint8_t sector = h / 43;
+  const uint8_t rise = static_cast<uint8_t>((h - sector * 43) * 6);
+  const uint8_t fall = 255 - rise;
+  switch (sector) {
+  case 0:
+    return {255, rise, 0};
+  case 1:
+    return {fall, 255, 0};
+  case 2:
+    return {0, 255, rise};
+  case 3:
+    return {0, fall, 255};
+  case 4:
+    return {rise, 0, 255};
+  default:
+    return {255, 0, fall};
+  }
+}
+
+// ============================================================================
+// Canvas
+// ============================================================================
+
+void Canvas::reset(uint8_t n) {
+  count = n > MAX_PIXELS ? MAX_PIXELS : n;
+  for (uint8_t i = 0; i < count; i++) {
+    px[i] = BLACK;
+    alpha[i] = 0;
+  }
+}
+
+void Canvas::fill(uint8_t from, uint8_t n, Rgb c, uint8_t a) {
+  for (uint8_t i = from; i < count && i < from + n; i++) set(i, c, a);
+}
+
+// ============================================================================
+// Layers
+// ============================================================================
+
+void SolidLayer::render(Canvas &c, const Tick &) {
+  c.fill(from_, n_, scale(color_, level_));
+}
+
+void ScannerLayer::restart() {
+  pos_ = 0;
+  dir_ = 1;
+  for (Rgb &p : trail_) p = BLACK;
+}
+
+void ScannerLayer::render(Canvas &c, const Tick &) {
+  const int16_t count = c.count;
+  if (count == 0) return;
+
+  for (int16_t i = 0; i < count; i++) trail_[i] = fade(trail_[i], fadeRate_);
+
+  if (pos_ >= 0 && pos_ < count) trail_[pos_] = color_;
+  for (uint8_t i = 1; i <= tail_; i++) {
+    int16_t p = pos_ - i * dir_;
+    if (p >= 0 && p < count) {
+      uint8_t level = static_cast<uint8_t>(255 - (i * 255 / tail_));
+      trail_[p] = scale(color_, level);
+    }
+  }
+
+  // Bounce at the ends
+  pos_ += dir_;
+  if (pos_ >= count || pos_ < 0) {
+    dir_ = -dir_;
+    pos_ += dir_ * 2;
+    if (pos_ < 0) pos_ = 0;
+    if (pos_ > count - 1) pos_ = static_cast<int8_t>(count - 1);
+  }
+
+  for (int16_t i = 0; i < count; i++) c.set(i, trail_[i]);
+}
+
+void ChaseLayer::restart() {
+  for (Rgb &p : trail_) p = BLACK;
+}
+
+void ChaseLayer::render(Canvas &c, const Tick &t) {
+  const int16_t count = c.count;
+  if (count == 0 || speed_ == 0) return;
+
+  int16_t pos = (t.step / speed_) % count;
+  for (int16_t i = 0; i < count; i++) trail_[i] = fade(trail_[i], fadeRate_);
+  for (int16_t i = 0; i < 5 && pos - i >= 0; i++) {
+    trail_[pos - i] = fade(color_, static_cast<uint8_t>(i * 50));
+  }
+
+  for (int16_t i = 0; i < count; i++) c.set(i, trail_[i]);
+}
+
+void RainbowLayer::render(Canvas &c, const Tick &t) {
+  if (c.count == 0) return;
+  const uint8_t start = static_cast<uint8_t>(t.step * speed_);
+  const uint8_t delta = static_cast<uint8_t>(256 / c.count);
+  for (uint8_t i = 0; i < c.count; i++) {
+    c.set(i, hue(static_cast<uint8_t>(start + i * delta)));
+  }
+}
+
+void FlashLayer::render(Canvas &c, const Tick &t) {
+  c.fill(0, c.count, t.blink ? on_ : off_);
+}
+
+void BlinkerLayer::render(Canvas &c, const Tick &t) {
+  if (!t.blink) {
+    c.fill(from_, n_, BLACK);
+    return;
+  }
+  if (!sequential_ || n_ == 0) {
+    c.fill(from_, n_, color_);
+    return;
+  }
+  const uint8_t lit = (t.step / 10) % n_;
+  for (uint8_t i = 0; i < n_; i++) c.set(from_ + i, i == lit ? color_ : BLACK);
+}
+
+// ============================================================================
+// Strip
+// ============================================================================
+
+bool Strip::add(Layer &layer) {
+  if (layerCount_ >= MAX_LAYERS) return false;
+  // Insertion keeps equal priorities in the order they were added
+  uint8_t i = layerCount_;
+  while (i > 0 && layers_[i - 1]->priority() > layer.priority()) {
+    layers_[i] = layers_[i - 1];
+    i--;
+  }
+  layers_[i] = &layer;
+  layerCount_++;
+  return true;
+}
+
+void Strip::compose(Rgb *out, const Tick &t) {
+  for (uint8_t i = 0; i < count_; i++) out[i] = BLACK;
+
+  for (uint8_t l = 0; l < layerCount_; l++) {
+    Layer &layer = *layers_[l];
+    if (!layer.isEnabled() || layer.opacity() == 0) continue;
+    canvas_.reset(count_);
+    layer.render(canvas_, t);
+    for (uint8_t i = 0; i < count_; i++) {
+      uint8_t a = scale8(canvas_.alpha[i], layer.opacity());
+      if (canvas_.alpha[i] == 255 && layer.opacity() == 255) {
+        out[i] = canvas_.px[i];
+      } else if (a > 0) {
+        out[i] = blend(out[i], canvas_.px[i], a);
+      }
+    }
+  }
+}
+
+// ============================================================================
+// WS2812 encoding
+// ============================================================================
+
+// rmt_item32_t: duration0 [0..14], level0 [15], duration1 [16..30], level1
+static constexpr uint32_t item(uint16_t high, uint16_t low) {
+  return static_cast<uint32_t>(high) | (1u << 15) |
+         (static_cast<uint32_t>(low) << 16);
+}
+
+static constexpr uint32_t BIT0 = item(T0H_TICKS, T0L_TICKS);
+static constexpr uint32_t BIT1 = item(T1H_TICKS, T1L_TICKS);
+
+uint16_t encodeWs2812(const Rgb *px, uint8_t n, uint8_t brightness,
+                      uint32_t *items) {
+  uint32_t *out = items;
+  for (uint8_t i = 0; i < n; i++) {
+    const Rgb c = scale(px[i], brightness);
+    const uint8_t bytes[3] = {c.g, c.r, c.b};
+    for (uint8_t byte : bytes) {
+      for (uint8_t mask = 0x80; mask; mask >>= 1) {
+        *out++ = (byte & mask) ? BIT1 : BIT0;
+      }
+    }
+  }
+  return static_cast<uint16_t>(out - items);
+}
+
+} // namespace LedEngine
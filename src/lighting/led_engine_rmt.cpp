@@ -0,0 +1,200 @@
+// led_engine_rmt.cpp - RMT output channels and the LED render task
+#include "led_engine.h"
+#include "logger.h"
+#include "rtos_tasks.h"
+#include <Arduino.h>
+#include <driver/rmt.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+namespace LedEngine {
+
+constexpr uint32_t TASK_STACK = 3072;
+constexpr uint32_t STATS_LOG_FRAMES = 1200; // ~60 s at 50 ms
+
+// TX channels 0 and 2: each takes two 48-word memory blocks (its own and the
+// next channel's), so the driver refills every 48 bits instead of every 24
+static const rmt_channel_t CHANNELS[MAX_OUTPUTS] = {RMT_CHANNEL_0,
+                                                    RMT_CHANNEL_2};
+constexpr uint8_t MEM_BLOCKS = 2;
+
+constexpr uint16_t ITEMS_PER_BUFFER = MAX_PIXELS * BITS_PER_PIXEL;
+
+struct Channel {
+  uint8_t count;
+  Rgb back[MAX_PIXELS]; // Written by the render callback
+  Rgb shown[MAX_PIXELS]; // Last frame handed to the transmitter
+  bool shownValid;
+  // Two item buffers: the driver reads one while the task fills the other
+  uint32_t items[2][ITEMS_PER_BUFFER];
+  uint8_t next; // Buffer the next frame is encoded into
+  volatile bool busy;
+  volatile uint32_t startUs;
+};
+
+static Channel channels[MAX_OUTPUTS];
+static uint8_t outputCount = 0;
+static bool ready = false;
+static volatile uint8_t brightness = 200;
+static volatile uint32_t period = 50;
+static RenderFn renderFn = nullptr;
+static TaskHandle_t task = nullptr;
+static Stats engineStats = {};
+
+// End-of-transmit interrupt (RMT driver ISR): times the frame, frees the
+// buffer. Touches only DRAM state.
+static void IRAM_ATTR onTxEnd(rmt_channel_t channel, void *) {
+  for (uint8_t i = 0; i < outputCount; i++) {
+    if (CHANNELS[i] != channel) continue;
+    Channel &c = channels[i];
+    uint32_t us = micros() - c.startUs;
+    engineStats.lastTxUs = us;
+    engineStats.txUsTotal += us;
+    if (us > engineStats.maxTxUs) engineStats.maxTxUs = us;
+    c.busy = false;
+  }
+}
+
+bool begin(const Output *outputs, uint8_t n) {
+  if (ready) return true;
+  if (outputs == nullptr || n == 0 || n > MAX_OUTPUTS) return false;
+
+  for (uint8_t i = 0; i < n; i++) {
+    rmt_config_t cfg = RMT_DEFAULT_CONFIG_TX(
+        static_cast<gpio_num_t>(outputs[i].pin), CHANNELS[i]);
+    cfg.clk_div = RMT_CLK_DIV;
+    cfg.mem_block_num = MEM_BLOCKS;
+    if (rmt_config(&cfg) != ESP_OK ||
+        rmt_driver_install(CHANNELS[i], 0, 0) != ESP_OK) {
+      Logger::errorf("LedEngine: RMT channel %d on GPIO %d failed",
+                     CHANNELS[i], outputs[i].pin);
+      for (uint8_t j = 0; j < i; j++) rmt_driver_uninstall(CHANNELS[j]);
+      return false;
+    }
+    Channel &c = channels[i];
+    c.count = outputs[i].count > MAX_PIXELS ? MAX_PIXELS : outputs[i].count;
+    c.shownValid = false;
+    c.next = 0;
+    c.busy = false;
+  }
+  outputCount = n;
+  rmt_register_tx_end_callback(onTxEnd, nullptr);
+  ready = true;
+  return true;
+}
+
+bool isReady() { return ready; }
+
+Rgb *backBuffer(uint8_t output) {
+  return output < outputCount ? channels[output].back : nullptr;
+}
+
+// Encodes the back buffer into the free item buffer and starts the transmit
+static void transmit(uint8_t i) {
+  Channel &c = channels[i];
+  uint16_t n = encodeWs2812(c.back, c.count, brightness, c.items[c.next]);
+  for (uint8_t p = 0; p < c.count; p++) c.shown[p] = c.back[p];
+  c.shownValid = true;
+  c.busy = true;
+  c.startUs = micros();
+  // wait_tx_done = false: returns as soon as the first block is loaded
+  rmt_write_items(CHANNELS[i], reinterpret_cast<rmt_item32_t *>(
+                                   c.items[c.next]),
+                  n, false);
+  c.next ^= 1;
+  engineStats.sent++;
+}
+
+static bool unchanged(const Channel &c) {
+  if (!c.shownValid) return false;
+  for (uint8_t p = 0; p < c.count; p++) {
+    if (c.back[p] != c.shown[p]) return false;
+  }
+  return true;
+}
+
+static void ledTask(void *) {
+  TickType_t wake = xTaskGetTickCount();
+  for (;;) {
+    vTaskDelayUntil(&wake, pdMS_TO_TICKS(period));
+
+    uint32_t t0 = micros();
+    renderFn(millis());
+    uint32_t renderUs = micros() - t0;
+    if (renderUs > engineStats.maxRenderUs) engineStats.maxRenderUs = renderUs;
+    engineStats.frames++;
+
+    for (uint8_t i = 0; i < outputCount; i++) {
+      if (unchanged(channels[i])) {
+        engineStats.unchanged++;
+      } else if (channels[i].busy) {
+        // Previous frame still on the wire: drop this one, the next frame
+        // compares against what is actually shown
+        engineStats.busySkipped++;
+      } else {
+        transmit(i);
+      }
+    }
+
+    if (engineStats.frames % STATS_LOG_FRAMES == 0) logStats();
+  }
+}
+
+bool start(uint32_t periodMs, RenderFn render) {
+  if (task != nullptr) return true;
+  if (!ready || render == nullptr) return false;
+  renderFn = render;
+  setPeriod(periodMs);
+
+  // HUD core, above the HUD job: a frame is a few hundred microseconds and
+  // a late frame shows as animation jitter. The RMT interrupt was allocated
+  // by begin() on the core that called it.
+  if (xTaskCreatePinnedToCore(ledTask, "LedEngine", TASK_STACK, nullptr,
+                              RTOSTasks::PRIORITY_GENERAL_EXEC + 1, &task,
+                              RTOSTasks::CORE_GENERAL) != pdPASS) {
+    Logger::error("LedEngine: render task creation failed");
+    task = nullptr;
+    return false;
+  }
+  return true;
+}
+
+void setPeriod(uint32_t periodMs) { period = periodMs > 0 ? periodMs : 1; }
+
+void setBrightness(uint8_t b) {
+  brightness = b;
+  // Re-encode on the next frame even if the pixels did not change
+  for (uint8_t i = 0; i < outputCount; i++) channels[i].shownValid = false;
+}
+
+bool show(uint32_t timeoutMs) {
+  if (!ready) return false;
+  bool ok = true;
+  for (uint8_t i = 0; i < outputCount; i++) {
+    if (rmt_wait_tx_done(CHANNELS[i], pdMS_TO_TICKS(timeoutMs)) != ESP_OK) {
+      ok = false;
+      continue;
+    }
+    transmit(i);
+  }
+  for (uint8_t i = 0; i < outputCount; i++) {
+    if (rmt_wait_tx_done(CHANNELS[i], pdMS_TO_TICKS(timeoutMs)) != ESP_OK) {
+      ok = false;
+    }
+  }
+  return ok;
+}
+
+const Stats &stats() { return engineStats; }
+
+void logStats() {
+  const Stats &s = engineStats;
+  Logger::infof("LedEngine: %lu frames, %lu sent, %lu unchanged, %lu busy "
+                "skips, tx %lu us avg / %lu us max, render max %lu us",
+                (unsigned long)s.frames, (unsigned long)s.sent,
+                (unsigned long)s.unchanged, (unsigned long)s.busySkipped,
+                (unsigned long)(s.sent ? s.txUsTotal / s.sent : 0),
+                (unsigned long)s.maxTxUs, (unsigned long)s.maxRenderUs);
+}
+
+} // namespace LedEngine
@@ -53,7 +53,7 @@ void stopLogging() {
 const LoggerStatus &getStatus() { return status; }
 const LoggerConfig &getConfig() { return config; }
 void setConfig(const LoggerConfig &c) { config = c; }
-bool exportCSV(const String &f) { return true; }
+bool exportCSV(StringView f) { return true; }
 bool clearLogs() { return true; }
-uint8_t getLogFiles(String *files, uint8_t max) { return 0; }
+uint8_t getLogFiles(LogFilename *files, uint8_t max) { return 0; }
 } // namespace ObstacleLogger
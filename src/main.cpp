@@ -3,7 +3,14 @@
 // 🔒 v2.18.0: FreeRTOS multitasking with dual-core operation
 
 #include "SystemConfig.h"
+#include "alerts.h"
+#include "black_box.h"
+#include "boot_graph.h"
+#include "config_store.h"
+#include "dfplayer.h"
+#include "frame_pacer.h"
 #include "hud_manager.h"
+#include "led_controller.h"
 #include "logger.h"
 #include "managers/ControlManager.h"
 #include "managers/ModeManager.h"
@@ -12,13 +19,21 @@
 #include "managers/SensorManager.h"
 #include "managers/TelemetryManager.h"
 #include "pins.h"
+#include "rt_scheduler.h"
 #include "rtos_tasks.h"  // 🔒 v2.18.0: FreeRTOS task management
+#include "pc_sampler.h"
+#include "runtime_profiler.h"
 #include "shared_data.h" // 🔒 v2.18.0: Thread-safe data sharing
+#include "spi_bus.h"
+#include "sprite_pool.h"
+#include "tear_sync.h"
+#include "touch_input.h"
 #include "watchdog.h"
 #include <Arduino.h>
 
 // Include core system components for proper boot sequence
 #include "boot_guard.h" // 🔒 v2.17.1: Boot counter for bootloop detection
+#include "flash_journal.h"
 #include "i2c_recovery.h"
 #include "storage.h"
 #include "system.h"
@@ -42,9 +57,184 @@ constexpr uint32_t LOGO_DISPLAY_DURATION_MS = 1500; // Show logo for 1.5 seconds
 void initializeSystem();
 void handleCriticalError(const char *errorMsg);
 
+// ============================================================================
+// Boot graph - each step declares its dependencies and the buses it drives;
+// BootGraph runs independent chains concurrently on both cores
+// ============================================================================
+enum BootStep : uint8_t {
+  STEP_JOURNAL,
+  STEP_STORAGE,
+  STEP_SYSTEM,
+  STEP_I2C,
+  STEP_TFT_RESET,
+  STEP_HUD,
+  STEP_LOGO,
+  STEP_POWER,
+  STEP_SENSORS,
+  STEP_SAFETY,
+  STEP_CONTROL,
+  STEP_TELEMETRY,
+  STEP_MODE,
+  STEP_SHARED_DATA,
+  STEP_LEDS,
+  STEP_AUDIO,
+  STEP_EXECUTIVES,
+  STEP_COUNT
+};
+
+static uint32_t logoShownMs = 0;
+
+// Keeps the logo up for LOGO_DISPLAY_DURATION_MS; the rest of the boot runs
+// underneath, so this only waits for whatever is left of the window
+static void holdLogo() {
+  if (logoShownMs == 0) return;
+  uint32_t elapsed = millis() - logoShownMs;
+  if (elapsed < BootSequenceConfig::LOGO_DISPLAY_DURATION_MS) {
+    uint32_t remaining = BootSequenceConfig::LOGO_DISPLAY_DURATION_MS - elapsed;
+    Logger::infof("Boot: logo visible %lu ms más", (unsigned long)remaining);
+    vTaskDelay(pdMS_TO_TICKS(remaining));
+  }
+  logoShownMs = 0;
+}
+
+static bool bootJournal() {
+  // Replayed before Telemetry/Storage load; without the partition both fall
+  // back to NVS, so a failure here is not a boot failure
+  FlashJournal::initPartition();
+  // Optional as well: without PSRAM or its partition the recorder stays off
+  BlackBox::initDevice();
+  return true;
+}
+
+static bool bootStorage() {
+  Storage::init(); // ConfigStore montado antes de que System aplique toggles
+  return true;
+}
+
+static bool bootSystem() {
+  System::init();
+  return true;
+}
+
+static bool bootI2C() {
+  I2CRecovery::init();
+  return true;
+}
+
+static bool bootTftReset() {
+  pinMode(PIN_TFT_RST, OUTPUT);
+  digitalWrite(PIN_TFT_RST, LOW);
+  delay(DisplayBootConfig::TFT_RESET_PULSE_MS);
+  digitalWrite(PIN_TFT_RST, HIGH);
+  delay(DisplayBootConfig::TFT_RESET_RECOVERY_MS);
+  delay(DisplayBootConfig::TFT_RESET_STABILIZATION_MS);
+  return true;
+}
+
+static bool bootHud() { return HUDManager::init(); }
+
+static bool bootLogo() {
+  HUDManager::showLogo();
+  logoShownMs = millis();
+  if (logoShownMs == 0) logoShownMs = 1;
+  return true;
+}
+
+static bool bootLeds() {
+  // Non-critical: without LEDs the car still drives
+  if (!ConfigStore::leds().enabled) {
+    Logger::info("LED Controller: disabled in config, RMT not started");
+    return true;
+  }
+  LEDController::init();
+  return true;
+}
+
+static bool bootAudio() {
+  // Non-critical: the queue drops tracks while the DFPlayer is missing
+  Audio::AudioQueue::init();
+  Alerts::init();
+  Audio::DFPlayer::init();
+  return true;
+}
+
+static bool bootExecutives() {
+  holdLogo(); // The HUD job would draw over the logo
+  return RTOSTasks::init();
+}
+
+static const BootGraph::Step BOOT_STEPS[STEP_COUNT] = {
+    // name, fn, buses, deps, core
+    {"Journal", bootJournal, BootGraph::BUS_FLASH, 0, BootGraph::ANY_CORE},
+    {"Storage", bootStorage, BootGraph::BUS_FLASH,
+     BootGraph::dep(STEP_JOURNAL), BootGraph::ANY_CORE},
+    {"System", bootSystem, BootGraph::BUS_NONE, BootGraph::dep(STEP_STORAGE),
+     BootGraph::ANY_CORE},
+    // Interrupts are allocated on the calling core: Wire (I2C), encoder and
+    // wheel-speed ISRs stay on core 1, where setup() always put them
+    {"I2C", bootI2C, BootGraph::BUS_I2C, 0, RTOSTasks::CORE_GENERAL},
+    // Display chain stays on the HUD job's core (SPI DMA interrupt affinity)
+    {"TFT reset", bootTftReset, BootGraph::BUS_SPI, 0,
+     RTOSTasks::CORE_GENERAL},
+    {"HUD", bootHud, BootGraph::BUS_SPI,
+     BootGraph::dep(STEP_TFT_RESET) | BootGraph::dep(STEP_SYSTEM),
+     RTOSTasks::CORE_GENERAL},
+    {"Logo", bootLogo, BootGraph::BUS_SPI, BootGraph::dep(STEP_HUD),
+     RTOSTasks::CORE_GENERAL},
+    {"Power", PowerManager::init, BootGraph::BUS_NONE,
+     BootGraph::dep(STEP_SYSTEM), BootGraph::ANY_CORE},
+    // Steering needs the aux 12V rail; shifter on MCP23017, obstacle on UART
+    {"Sensors", SensorManager::init,
+     BootGraph::BUS_I2C | BootGraph::BUS_UART,
+     BootGraph::dep(STEP_POWER) | BootGraph::dep(STEP_I2C),
+     RTOSTasks::CORE_GENERAL},
+    {"Safety", SafetyManager::init, BootGraph::BUS_NONE,
+     BootGraph::dep(STEP_SENSORS), BootGraph::ANY_CORE},
+    // MCP23017 + PCA9685 on I2C
+    {"Control", ControlManager::init, BootGraph::BUS_I2C,
+     BootGraph::dep(STEP_SAFETY), BootGraph::ANY_CORE},
+    {"Telemetry", TelemetryManager::init, BootGraph::BUS_FLASH,
+     BootGraph::dep(STEP_STORAGE), BootGraph::ANY_CORE},
+    {"Mode", ModeManager::init, BootGraph::BUS_NONE,
+     BootGraph::dep(STEP_SYSTEM), BootGraph::ANY_CORE},
+    {"SharedData", SharedData::init, BootGraph::BUS_NONE, 0,
+     BootGraph::ANY_CORE},
+    // RMT interrupt is allocated on the calling core too: core 1, next to
+    // the wheel-speed and encoder ISRs, as when setup() ran it
+    {"LEDs", bootLeds, BootGraph::BUS_NONE, BootGraph::dep(STEP_SYSTEM),
+     RTOSTasks::CORE_GENERAL},
+    // DFPlayer on UART1; its reset handshake takes up to ~2 s
+    {"Audio", bootAudio, BootGraph::BUS_UART, 0, BootGraph::ANY_CORE},
+    {"Executives", bootExecutives, BootGraph::BUS_NONE,
+     BootGraph::dep(STEP_LOGO) | BootGraph::dep(STEP_CONTROL) |
+         BootGraph::dep(STEP_TELEMETRY) | BootGraph::dep(STEP_MODE) |
+         BootGraph::dep(STEP_SHARED_DATA),
+     BootGraph::ANY_CORE},
+};
+
+// Steps that only exist on the full vehicle build
+constexpr uint32_t VEHICLE_STEPS =
+    BootGraph::dep(STEP_POWER) | BootGraph::dep(STEP_SENSORS) |
+    BootGraph::dep(STEP_SAFETY) | BootGraph::dep(STEP_CONTROL) |
+    BootGraph::dep(STEP_TELEMETRY) | BootGraph::dep(STEP_MODE) |
+    BootGraph::dep(STEP_SHARED_DATA) | BootGraph::dep(STEP_LEDS) |
+    BootGraph::dep(STEP_AUDIO) | BootGraph::dep(STEP_EXECUTIVES);
+
+// Non-critical systems, skipped in safe mode
+constexpr uint32_t NON_ESSENTIAL_STEPS =
+    BootGraph::dep(STEP_TELEMETRY) | BootGraph::dep(STEP_MODE) |
+    BootGraph::dep(STEP_SHARED_DATA) | BootGraph::dep(STEP_LEDS) |
+    BootGraph::dep(STEP_AUDIO) | BootGraph::dep(STEP_EXECUTIVES);
+
+// A failure here goes through handleCriticalError()
+constexpr uint32_t CRITICAL_STEPS = VEHICLE_STEPS | BootGraph::dep(STEP_HUD);
+
 void setup() {
   // 🔒 v2.11.6: BOOTLOOP FIX - Early UART diagnostic output
   // Initialize Serial first for all modes
+  // TX ring buffer (before begin): lets PcSampler/RuntimeProfiler stream
+  // without blocking their job; the UART FIFO alone is only 128 bytes
+  Serial.setTxBufferSize(PcSampler::SERIAL_TX_BUFFER_BYTES);
   Serial.begin(115200);
 
 #ifdef STANDALONE_DISPLAY
@@ -83,14 +273,7 @@ void setup() {
   digitalWrite(PIN_TFT_BL, HIGH);
   // PWM setup in HUDManager::init will override this, but keep the backlight on
   // immediately so boot progress is visible even if init fails.
-
-  Serial.println("[BOOT] Resetting TFT display...");
-  pinMode(PIN_TFT_RST, OUTPUT);
-  digitalWrite(PIN_TFT_RST, LOW);
-  delay(DisplayBootConfig::TFT_RESET_PULSE_MS);
-  digitalWrite(PIN_TFT_RST, HIGH);
-  delay(DisplayBootConfig::TFT_RESET_RECOVERY_MS);
-  delay(DisplayBootConfig::TFT_RESET_STABILIZATION_MS);
+  // The TFT reset pulse is the first step of the display chain in BOOT_STEPS.
 
   // 🔍 DIAGNOSTIC MARKER A: Serial initialized
   Serial.write('A');
@@ -119,22 +302,17 @@ void setup() {
   // 🔒 v2.18.1: yield() to allow other tasks to run
   yield();
 
-  // Critical boot sequence
-  System::init();
-  Storage::init();
+  // Logger before the boot graph: its steps log from both cores
   Watchdog::init();
   Watchdog::feed();
-  I2CRecovery::init();
+  Logger::init();
+  Logger::info("Boot sequence started");
 
-  // 🔍 DIAGNOSTIC MARKER C: Core systems initialized
+  // 🔍 DIAGNOSTIC MARKER C: Logger and watchdog ready
   Serial.write('C');
   // 🔒 v2.18.1: yield() between initialization stages
   yield();
 
-  Logger::init();
-  Logger::info("Boot sequence started");
-  Watchdog::feed();
-
   // 🔍 DIAGNOSTIC MARKER D: Before initializeSystem (includes HUD init)
   Serial.write('D');
   // 🔒 v2.18.1: yield() before system initialization
@@ -175,12 +353,16 @@ void loop() {
     Logger::infof("Memory: Heap=%u KB, PSRAM=%u KB", freeHeap / 1024,
                   freePsram / 1024);
 
-    // Log FreeRTOS task information (correct core reporting)
-    if (RTOSTasks::safetyTaskHandle != nullptr) {
-      Logger::infof(
-          "FreeRTOS: 5 tasks running - Safety(Core0,P5), Control(Core0,P4), "
-          "Power(Core0,P3), HUD(Core1,P2), Telemetry(Core1,P1)");
+    // Log per-job timing and per-core utilization from the executives
+    if (RTScheduler::getDispatcherHandle(RTOSTasks::CORE_CRITICAL) !=
+        nullptr) {
+      RTScheduler::logStats();
+      RuntimeProfiler::logReport();
     }
+    TouchInput::logStats(); // Latencia toque -> evento, cola y bus SPI
+    SpiBus::logStats();     // Ocupación del bus por dispositivo
+    TearSync::logStats();   // Volcados cruzados por el barrido del panel
+    SpritePool::logStats(); // Arena de sprites: ocupación y fragmentación
 
     lastMemoryLog = now;
   }
@@ -200,7 +382,7 @@ void loop() {
   // ===========================
   // In standalone mode, we don't use FreeRTOS tasks
   HUDManager::update();
-  delay(33); // ~30 FPS
+  delay(FramePacer::TICK_MS); // HUDManager paces the frames
 
 #else
   // ===========================
@@ -229,148 +411,49 @@ void initializeSystem() {
     Logger::error("SAFE MODE: Bootloop detected - minimal initialization");
   }
 
-#ifdef STANDALONE_DISPLAY
-  // ===========================
-  // STANDALONE DISPLAY INIT
-  // ===========================
-  Serial.println("🧪 STANDALONE DISPLAY MODE");
-  // 🔒 v2.18.1: Use yield() instead of delay to allow task switching
-  yield();
-
-  Serial.println("[INIT] HUD Manager initialization...");
-  // 🔒 v2.18.1: Allow task switching before HUD init
-  yield();
-
-  if (!HUDManager::init()) {
-    Serial.println("[ERROR] HUD Manager initialization failed");
-    // 🔒 v2.18.1: Use yield() instead of blocking flush
-    yield();
-    handleCriticalError("HUD Manager initialization failed");
-  }
-
-  Logger::info("HUD Manager initialized (standalone)");
-  Watchdog::feed();
-
-  // Show logo briefly after successful initialization
-  Serial.println("[BOOT] Showing logo...");
-  HUDManager::showLogo();
-  unsigned long logoStart = millis();
-  while (millis() - logoStart < BootSequenceConfig::LOGO_DISPLAY_DURATION_MS) {
-    Watchdog::feed();
-    // 🔒 v2.18.1: Use yield() to allow FreeRTOS task switching during logo
-    // display
-    yield();
-  }
-
-  Serial.println("🧪 STANDALONE: Skipping other managers");
-  // 🔒 v2.18.1: yield() before return
-  yield();
-  return; // ¡MUY IMPORTANTE!
+  BootGraph::Options opt;
+  opt.critical = CRITICAL_STEPS;
 
+#ifdef STANDALONE_DISPLAY
+  Serial.println("🧪 STANDALONE DISPLAY MODE - Skipping vehicle managers");
+  opt.skip = VEHICLE_STEPS;
 #else
-  // ===========================
-  // FULL VEHICLE INIT
-  // ===========================
-
-  // CRITICAL SYSTEMS - Always initialize
-  Serial.println("[INIT] Power Manager initialization...");
-  if (!PowerManager::init()) {
-    handleCriticalError("Power Manager initialization failed");
-  }
-  Logger::info("Power Manager initialized");
-  Watchdog::feed();
-
-  Serial.println("[INIT] Sensor Manager initialization...");
-  if (!SensorManager::init()) {
-    handleCriticalError("Sensor Manager initialization failed");
+  if (safeMode) {
+    // HUD - Try to initialize even in safe mode (for error display)
+    opt.skip = NON_ESSENTIAL_STEPS;
+    opt.critical &= ~BootGraph::dep(STEP_HUD);
+    Logger::warn("Safe Mode: Non-critical managers disabled");
   }
-  Logger::info("Sensor Manager initialized");
-  Watchdog::feed();
+#endif
 
-  Serial.println("[INIT] Safety Manager initialization...");
-  if (!SafetyManager::init()) {
-    handleCriticalError("Safety Manager initialization failed");
-  }
-  Logger::info("Safety Manager initialized");
-  Watchdog::feed();
+  int8_t failed = BootGraph::run(BOOT_STEPS, STEP_COUNT, opt);
+  BootGraph::printTimeline();
 
-  // HUD - Try to initialize even in safe mode (for error display)
-  Serial.println("[INIT] HUD Manager initialization...");
-  bool hudInitialized = false;
-  if (!HUDManager::init()) {
-    if (!safeMode) {
-      handleCriticalError("HUD Manager initialization failed");
-    } else {
-      Logger::warn(
-          "Safe Mode: HUD initialization failed - continuing without display");
-    }
-  } else {
-    Logger::info("HUD Manager initialized");
-    hudInitialized = true;
+  if (failed == BootGraph::INVALID_GRAPH) {
+    handleCriticalError("Boot graph invalid");
+  } else if (failed >= 0) {
+    static char msg[48];
+    snprintf(msg, sizeof(msg), "%s initialization failed",
+             BOOT_STEPS[failed].name);
+    handleCriticalError(msg);
   }
-  Watchdog::feed();
 
-  // Show logo briefly after successful HUD initialization
-  if (hudInitialized) {
-    Serial.println("[BOOT] Showing logo...");
-    HUDManager::showLogo();
-    unsigned long logoStart = millis();
-    while (millis() - logoStart <
-           BootSequenceConfig::LOGO_DISPLAY_DURATION_MS) {
-      Watchdog::feed();
-      // 🔒 v2.18.1: Use yield() to allow FreeRTOS task switching
-      yield();
-    }
+  if (BootGraph::lastRun().rec[STEP_HUD].state ==
+      BootGraph::StepState::FAILED) {
+    Logger::warn(
+        "Safe Mode: HUD initialization failed - continuing without display");
   }
 
-  // Control Manager - Critical
-  Serial.println("[INIT] Control Manager initialization...");
-  if (!ControlManager::init()) {
-    handleCriticalError("Control Manager initialization failed");
-  }
-  Logger::info("Control Manager initialized");
+  // Executives skipped (safe mode / standalone): the logo still gets its time
+  holdLogo();
   Watchdog::feed();
 
-  // NON-CRITICAL SYSTEMS - Skip in safe mode
-  if (safeMode) {
-    Serial.println("[SAFE MODE] Skipping Telemetry Manager (non-critical)");
-    Serial.println("[SAFE MODE] Skipping Mode Manager (non-critical)");
-    Serial.println("[SAFE MODE] Skipping FreeRTOS tasks (non-critical)");
-    Logger::warn("Safe Mode: Non-critical managers disabled");
-  } else {
-    Serial.println("[INIT] Telemetry Manager initialization...");
-    if (!TelemetryManager::init()) {
-      handleCriticalError("Telemetry Manager initialization failed");
-    }
-    Logger::info("Telemetry Manager initialized");
-    Watchdog::feed();
-
-    Serial.println("[INIT] Mode Manager initialization...");
-    if (!ModeManager::init()) {
-      handleCriticalError("Mode Manager initialization failed");
-    }
-    Logger::info("Mode Manager initialized");
-    Watchdog::feed();
-
-    // 🔒 v2.18.0: Initialize FreeRTOS multitasking infrastructure
-    Serial.println("[INIT] Initializing shared data structures...");
-    if (!SharedData::init()) {
-      handleCriticalError("SharedData initialization failed");
-    }
-    Logger::info("SharedData initialized");
-    Watchdog::feed();
-
-    Serial.println("[INIT] Creating FreeRTOS tasks...");
-    if (!RTOSTasks::init()) {
-      handleCriticalError("FreeRTOS task creation failed");
-    }
-    Logger::info("FreeRTOS tasks created and started");
+#ifndef STANDALONE_DISPLAY
+  if (!safeMode) {
     Logger::info(
         "Core 0 (critical): SafetyManager, ControlManager, PowerManager");
-    Logger::info("Core 1 (general): HUDManager, TelemetryManager");
-    Watchdog::feed();
+    Logger::info("Core 1 (general): HUDManager, TelemetryManager, Profiler");
   }
-
 #endif
 }
 
@@ -2,6 +2,7 @@
 // Control management - integrates traction, steering, and relays
 #pragma once
 
+#include "../../include/adaptive_cruise.h"
 #include "../../include/logger.h"
 #include "../../include/mcp23017_manager.h"
 #include "../../include/relays.h"
@@ -21,6 +22,7 @@ inline bool init() {
   Traction::init();
   SteeringMotor::init();
   Relays::init();
+  AdaptiveCruise::init();
 
   // Initialize shifter (also uses MCP manager)
   Shifter::init();
@@ -35,6 +37,8 @@ inline bool init() {
 }
 
 inline void update() {
+  // ACC first so Traction applies this cycle's speed factor
+  AdaptiveCruise::update();
   Traction::update();
   SteeringMotor::update();
   Relays::update();
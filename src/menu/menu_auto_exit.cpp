@@ -1,5 +1,5 @@
 #include "menu_auto_exit.h"
-#include "config_storage.h"
+#include "config_store.h"
 // #include "display.h"  // Display module not yet implemented
 
 // Static members
@@ -11,10 +11,10 @@ uint8_t MenuAutoExit::failedAttempts = 0;
 unsigned long MenuAutoExit::lockoutUntil = 0;
 
 void MenuAutoExit::init() {
-  // Load settings from EEPROM
-  auto config = ConfigStorage::getCurrentConfig();
-  timeoutSeconds = 30;  // Default 30 seconds
-  protectionPIN = 8989; // Default PIN
+  // Load settings from ConfigStore (timeoutSeconds is 8-bit)
+  const auto &config = ConfigStore::general();
+  timeoutSeconds = config.menuTimeoutSec > 255 ? 255 : config.menuTimeoutSec;
+  protectionPIN = config.menuPin;
   enabled = true;
 
   lastActivityTime = millis();
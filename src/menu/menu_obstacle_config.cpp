@@ -11,7 +11,8 @@
  */
 
 #include "alerts.h"
-#include "config_storage.h"
+#include "config_store.h"
+#include "hud_widgets.h"
 #include "logger.h"
 #include "obstacle_config.h"
 #include "obstacle_detection.h"
@@ -28,10 +29,9 @@ static const char *SENSOR_NAMES[kNumObstacles] = {"Front"};
 
 // UI State
 static bool visible = false;
-static bool needsRedraw = true;
 static int selectedOption = 0;
 
-// Config (cargados desde ConfigStorage)
+// Config (cargados desde ConfigStore)
 static uint16_t criticalDistance = ObstacleConfig::DISTANCE_CRITICAL;
 static uint16_t warningDistance = ObstacleConfig::DISTANCE_WARNING;
 static uint16_t cautionDistance = ObstacleConfig::DISTANCE_CAUTION;
@@ -50,12 +50,22 @@ static const uint16_t COLOR_CAUTION = TFT_YELLOW;
 static const uint16_t COLOR_ENABLED = TFT_GREEN;
 static const uint16_t COLOR_DISABLED = TFT_DARKGREY;
 
-static const int HEADER_Y = 10;
-static const int OPTION_START_Y = 50;
-static const int OPTION_HEIGHT = 35;
-static const int SLIDER_X = 220;
-static const int SLIDER_W = 180;
-static const int BACK_BTN_Y = 280;
+static const int16_t HEADER_Y = 10;
+static const int16_t OPTION_START_Y = 48;
+static const int16_t OPTION_HEIGHT = 30;
+static const int16_t ROW_H = 25;
+static const int16_t LABEL_X = 40;
+static const int16_t LABEL_W = 170;
+static const int16_t SLIDER_X = 220;
+static const int16_t SLIDER_W = 180;
+static const int16_t TOGGLE_W = 80;
+static const int16_t VALUE_X = SLIDER_X + SLIDER_W + 10;
+static const int16_t BACK_BTN_Y = 280;
+
+// Filas: 3 umbrales, sensor frontal, alerta sonora, alerta visual
+static constexpr int16_t SLIDER_ROW_Y[3] = {70, 100, 130};
+static const int16_t SENSOR_TITLE_Y = 160;
+static constexpr int16_t TOGGLE_ROW_Y[3] = {178, 210, 242};
 
 // Número de opciones en el menú (3 distancias + 1 sensor + 2 toggles + botón
 // Save)
@@ -65,40 +75,165 @@ static const int NUM_OPTIONS = 6;
 void loadConfig();
 void saveConfig();
 void draw();
-void drawSliderOption(int y, int optionIndex, const char *label, uint16_t value,
-                      uint16_t minVal, uint16_t maxVal, uint16_t color);
-void drawToggleOption(int y, int optionIndex, const char *label, bool enabled);
-void drawActionButtons();
+void syncWidgets();
 void handleSliderTouch(int sliderIndex, int16_t x);
 void adjustValue(int direction);
 void handleSelect();
 void resetToDefaults();
 
+// Árbol de widgets (hud_widgets.h): se construye una vez y cada toque
+// redibuja solo las filas que cambian
+using namespace HudWidgets;
+
+static const char *const SLIDER_LABELS[3] = {"Critical:", "Warning:",
+                                             "Caution:"};
+static const uint16_t SLIDER_COLORS[3] = {COLOR_CRITICAL, COLOR_WARNING,
+                                          COLOR_CAUTION};
+static const char *const TOGGLE_LABELS[3] = {SENSOR_NAMES[0], "Audio Alerts",
+                                             "Visual Alerts"};
+
+static Screen screen(COLOR_BG);
+static Label title({0, HEADER_Y, 480, 26}, "Obstacle Detection Config");
+// v2.13.0: TOFSense-M S 8x8 matrix subtitle
+static Label subtitle({0, HEADER_Y + 25, 480, 16},
+                      "TOFSense-M S (8x8 Matrix, 4m Range)");
+static Label thresholdsTitle({20, OPTION_START_Y, 200, 16},
+                             "Distance Thresholds:");
+static Label sliderLabels[3] = {
+    Label({LABEL_X, SLIDER_ROW_Y[0], LABEL_W, ROW_H}, SLIDER_LABELS[0]),
+    Label({LABEL_X, SLIDER_ROW_Y[1], LABEL_W, ROW_H}, SLIDER_LABELS[1]),
+    Label({LABEL_X, SLIDER_ROW_Y[2], LABEL_W, ROW_H}, SLIDER_LABELS[2])};
+static Slider sliders[3] = {
+    Slider({SLIDER_X, SLIDER_ROW_Y[0] + 2, SLIDER_W, 20}, 100, 500),
+    Slider({SLIDER_X, SLIDER_ROW_Y[1] + 2, SLIDER_W, 20}, 200, 1000),
+    Slider({SLIDER_X, SLIDER_ROW_Y[2] + 2, SLIDER_W, 20}, 500, 2000)};
+static ValueField sliderValues[3] = {
+    ValueField({VALUE_X, SLIDER_ROW_Y[0], 70, ROW_H}, "%ldmm"),
+    ValueField({VALUE_X, SLIDER_ROW_Y[1], 70, ROW_H}, "%ldmm"),
+    ValueField({VALUE_X, SLIDER_ROW_Y[2], 70, ROW_H}, "%ldmm")};
+static Label sensorTitle({20, SENSOR_TITLE_Y, 200, 16}, "Sensor:");
+static Label toggleLabels[3] = {
+    Label({LABEL_X, TOGGLE_ROW_Y[0], LABEL_W, ROW_H}, TOGGLE_LABELS[0]),
+    Label({LABEL_X, TOGGLE_ROW_Y[1], LABEL_W, ROW_H}, TOGGLE_LABELS[1]),
+    Label({LABEL_X, TOGGLE_ROW_Y[2], LABEL_W, ROW_H}, TOGGLE_LABELS[2])};
+static Toggle toggles[3] = {
+    Toggle({SLIDER_X, TOGGLE_ROW_Y[0], TOGGLE_W, ROW_H}, COLOR_DISABLED),
+    Toggle({SLIDER_X, TOGGLE_ROW_Y[1], TOGGLE_W, ROW_H}, COLOR_DISABLED),
+    Toggle({SLIDER_X, TOGGLE_ROW_Y[2], TOGGLE_W, ROW_H}, COLOR_DISABLED)};
+static Button saveButton({20, BACK_BTN_Y, 100, 35}, "SAVE");
+static Button resetButton({140, BACK_BTN_Y, 100, 35}, "RESET");
+static Button backButton({360, BACK_BTN_Y, 100, 35}, "BACK");
+static bool built = false;
+
+static Style textStyle(uint16_t fg, uint8_t font, Align align) {
+  Style s;
+  s.fg = fg;
+  s.bg = COLOR_BG;
+  s.font = font;
+  s.align = align;
+  return s;
+}
+
+static Style faceStyle(uint16_t face, uint16_t border, uint8_t radius) {
+  Style s = textStyle(COLOR_TEXT, 2, Align::CENTER);
+  s.accent = face;
+  s.border = border;
+  s.radius = radius;
+  return s;
+}
+
+static void buildScreen() {
+  title.setStyle(textStyle(COLOR_HEADER, 4, Align::CENTER));
+  subtitle.setStyle(textStyle(TFT_DARKGREY, 2, Align::CENTER));
+  thresholdsTitle.setStyle(textStyle(COLOR_TEXT, 2, Align::LEFT));
+  sensorTitle.setStyle(textStyle(COLOR_TEXT, 2, Align::LEFT));
+  screen.add(title);
+  screen.add(subtitle);
+  screen.add(thresholdsTitle);
+
+  for (int i = 0; i < 3; i++) {
+    sliders[i].setTrack(COLOR_DISABLED);
+    sliderValues[i].setStyle(textStyle(COLOR_TEXT, 2, Align::LEFT));
+    screen.add(sliderLabels[i]);
+    screen.add(sliders[i]);
+    screen.add(sliderValues[i]);
+  }
+
+  screen.add(sensorTitle);
+  for (int i = 0; i < 3; i++) {
+    screen.add(toggleLabels[i]);
+    screen.add(toggles[i]);
+  }
+
+  Style buttonText = faceStyle(TFT_ORANGE, COLOR_TEXT, 5);
+  buttonText.fg = COLOR_BG;
+  resetButton.setStyle(buttonText);
+  buttonText.accent = TFT_RED;
+  backButton.setStyle(buttonText);
+  screen.add(saveButton);
+  screen.add(resetButton);
+  screen.add(backButton);
+  built = true;
+}
+
+// Copia el estado (valores + opción seleccionada) a los widgets; solo se
+// marcan sucios los que cambian
+void syncWidgets() {
+  if (!built) return;
+  const uint16_t distances[3] = {criticalDistance, warningDistance,
+                                 cautionDistance};
+  for (int i = 0; i < 3; i++) {
+    bool isSelected = (selectedOption == i);
+    sliderLabels[i].setStyle(textStyle(
+        isSelected ? COLOR_SELECTED : COLOR_TEXT, 2, Align::LEFT));
+    sliders[i].setStyle(faceStyle(SLIDER_COLORS[i],
+                                  isSelected ? COLOR_SELECTED : COLOR_TEXT, 0));
+    sliders[i].setValue(distances[i]);
+    sliderValues[i].setValue(distances[i]);
+  }
+
+  const bool enabled[3] = {sensorEnabled[0], audioAlertsEnabled,
+                           visualAlertsEnabled};
+  for (int i = 0; i < 3; i++) {
+    bool isSelected = (selectedOption == 3 + i);
+    toggleLabels[i].setStyle(textStyle(
+        isSelected ? COLOR_SELECTED : COLOR_TEXT, 2, Align::LEFT));
+    Style t = faceStyle(COLOR_ENABLED, isSelected ? COLOR_SELECTED : COLOR_TEXT,
+                        5);
+    toggles[i].setStyle(t);
+    toggles[i].setOn(enabled[i]);
+  }
+
+  bool saveSelected = (selectedOption == NUM_OPTIONS);
+  Style save = faceStyle(saveSelected ? COLOR_SELECTED : TFT_BLUE, COLOR_TEXT,
+                         5);
+  save.fg = COLOR_BG;
+  saveButton.setStyle(save);
+}
+
 void init() {
   visible = false;
-  needsRedraw = true;
   selectedOption = 0;
   loadConfig();
   Logger::info("ObstacleConfigMenu: initialized (v2.12.0 - Single sensor)");
 }
 
 void loadConfig() {
-  // 🔒 v2.13.1: Load obstacle config from ConfigStorage
+  // 🔒 v2.13.1: Load obstacle config from ConfigStore
   // Note: System has 1 front sensor (TOFSense-M S). Array supports future
   // expansion.
-  ConfigStorage::init();
-  auto &cfg = ConfigStorage::getCurrentConfig();
+  const auto &cfg = ConfigStore::obstacle();
 
-  criticalDistance = cfg.obstacle_critical_distance;
-  warningDistance = cfg.obstacle_warning_distance;
-  cautionDistance = cfg.obstacle_caution_distance;
+  criticalDistance = cfg.criticalMm;
+  warningDistance = cfg.warningMm;
+  cautionDistance = cfg.cautionMm;
 
   // Load front sensor config (index 0)
   // Future: If multiple sensors added, loop through kNumObstacles
-  sensorEnabled[0] = cfg.obstacle_sensor_enabled;
+  sensorEnabled[0] = cfg.sensorEnabled;
 
-  audioAlertsEnabled = cfg.obstacle_audio_alerts;
-  visualAlertsEnabled = cfg.obstacle_visual_alerts;
+  audioAlertsEnabled = cfg.audioAlerts;
+  visualAlertsEnabled = cfg.visualAlerts;
 
   Logger::info(
       "ObstacleConfigMenu: Configuration loaded from persistent storage");
@@ -108,21 +243,20 @@ void saveConfig() {
   // 🔒 v2.13.1: Save obstacle config to persistent storage
   // Note: System has 1 front sensor (TOFSense-M S). Array supports future
   // expansion.
-  ConfigStorage::init();
-  auto &cfg = ConfigStorage::getCurrentConfig();
+  auto &cfg = ConfigStore::obstacle();
 
-  cfg.obstacle_critical_distance = criticalDistance;
-  cfg.obstacle_warning_distance = warningDistance;
-  cfg.obstacle_caution_distance = cautionDistance;
+  cfg.criticalMm = criticalDistance;
+  cfg.warningMm = warningDistance;
+  cfg.cautionMm = cautionDistance;
 
   // Save front sensor config (index 0)
   // Future: If multiple sensors added, loop through kNumObstacles
-  cfg.obstacle_sensor_enabled = sensorEnabled[0];
+  cfg.sensorEnabled = sensorEnabled[0];
 
-  cfg.obstacle_audio_alerts = audioAlertsEnabled;
-  cfg.obstacle_visual_alerts = visualAlertsEnabled;
+  cfg.audioAlerts = audioAlertsEnabled;
+  cfg.visualAlerts = visualAlertsEnabled;
 
-  if (ConfigStorage::save(cfg)) {
+  if (ConfigStore::commit(ConfigStore::SECTION_OBSTACLE)) {
     Logger::info(
         "ObstacleConfigMenu: Configuration saved to persistent storage");
     Alerts::play(Audio::AUDIO_CONFIG_GUARDADA);
@@ -134,180 +268,59 @@ void saveConfig() {
 
 void show() {
   visible = true;
-  needsRedraw = true;
   selectedOption = 0;
   loadConfig();
+  if (!built) buildScreen();
+  syncWidgets();
+  screen.invalidateAll();
 }
 
 void hide() {
   saveConfig(); // Guarda siempre al salir
   visible = false;
+  logStats("ObstacleConfig", screen);
 }
 
 bool isVisible() { return visible; }
 
 void update() {
   if (!visible) return;
-  if (needsRedraw) {
-    draw();
-    needsRedraw = false;
-  }
+  draw();
 }
 
-void draw() {
-  tft->fillScreen(COLOR_BG);
-  tft->setTextDatum(TC_DATUM);
-  tft->setTextColor(COLOR_HEADER, COLOR_BG);
-  tft->drawString("Obstacle Detection Config", 240, HEADER_Y, 4);
-
-  // v2.13.0: TOFSense-M S 8x8 matrix subtitle
-  tft->setTextColor(TFT_DARKGREY, COLOR_BG);
-  tft->drawString("TOFSense-M S (8x8 Matrix, 4m Range)", 240, HEADER_Y + 25, 2);
-
-  int y = OPTION_START_Y;
-
-  // Umbrales de distancia
-  tft->setTextDatum(TL_DATUM);
-  tft->setTextColor(COLOR_TEXT, COLOR_BG);
-  tft->drawString("Distance Thresholds:", 20, y, 2);
-  y += 25;
-
-  drawSliderOption(y, 0, "Critical:", criticalDistance, 100, 500,
-                   COLOR_CRITICAL);
-  y += OPTION_HEIGHT;
-  drawSliderOption(y, 1, "Warning:", warningDistance, 200, 1000, COLOR_WARNING);
-  y += OPTION_HEIGHT;
-  drawSliderOption(y, 2, "Caution:", cautionDistance, 500, 2000, COLOR_CAUTION);
-  y += OPTION_HEIGHT + 10;
-
-  // Sensor (solo Front)
-  tft->setTextColor(COLOR_TEXT, COLOR_BG);
-  tft->drawString("Sensor:", 20, y, 2);
-  y += 25;
-  drawToggleOption(y, 3, SENSOR_NAMES[0], sensorEnabled[0]);
-  y += OPTION_HEIGHT + 10;
-
-  // Alertas
-  drawToggleOption(y, 4, "Audio Alerts", audioAlertsEnabled);
-  y += OPTION_HEIGHT;
-  drawToggleOption(y, 5, "Visual Alerts", visualAlertsEnabled);
-
-  // Action buttons
-  drawActionButtons();
-}
-
-void drawSliderOption(int y, int optionIndex, const char *label, uint16_t value,
-                      uint16_t minVal, uint16_t maxVal, uint16_t color) {
-  bool isSelected = (selectedOption == optionIndex);
-  tft->setTextColor(isSelected ? COLOR_SELECTED : COLOR_TEXT, COLOR_BG);
-  tft->drawString(label, 40, y + 5, 2);
-  tft->fillRect(SLIDER_X, y + 2, SLIDER_W, 20, COLOR_DISABLED);
-  int fillWidth = ((uint32_t)(value - minVal) * SLIDER_W) / (maxVal - minVal);
-  tft->fillRect(SLIDER_X, y + 2, fillWidth, 20, color);
-  tft->drawRect(SLIDER_X, y + 2, SLIDER_W, 20,
-                isSelected ? COLOR_SELECTED : COLOR_TEXT);
-  char valueStr[16];
-  snprintf(valueStr, sizeof(valueStr), "%dmm", value);
-  tft->setTextColor(COLOR_TEXT, COLOR_BG);
-  tft->drawString(valueStr, SLIDER_X + SLIDER_W + 10, y + 5, 2);
-}
-
-void drawToggleOption(int y, int optionIndex, const char *label, bool enabled) {
-  bool isSelected = (selectedOption == optionIndex);
-  tft->setTextColor(isSelected ? COLOR_SELECTED : COLOR_TEXT, COLOR_BG);
-  tft->drawString(label, 40, y + 5, 2);
-  uint16_t btnColor = enabled ? COLOR_ENABLED : COLOR_DISABLED;
-  tft->fillRoundRect(SLIDER_X, y, 80, 25, 5, btnColor);
-  tft->drawRoundRect(SLIDER_X, y, 80, 25, 5,
-                     isSelected ? COLOR_SELECTED : COLOR_TEXT);
-  tft->setTextDatum(MC_DATUM);
-  tft->setTextColor(enabled ? COLOR_BG : COLOR_TEXT, btnColor);
-  tft->drawString(enabled ? "ON" : "OFF", SLIDER_X + 40, y + 12, 2);
-  tft->setTextDatum(TL_DATUM);
-}
-
-void drawActionButtons() {
-  bool saveSelected = (selectedOption == NUM_OPTIONS);
-  tft->fillRoundRect(20, BACK_BTN_Y, 100, 35, 5,
-                     saveSelected ? COLOR_SELECTED : TFT_BLUE);
-  tft->drawRoundRect(20, BACK_BTN_Y, 100, 35, 5, COLOR_TEXT);
-  tft->setTextDatum(MC_DATUM);
-  tft->setTextColor(COLOR_BG, saveSelected ? COLOR_SELECTED : TFT_BLUE);
-  tft->drawString("SAVE", 70, BACK_BTN_Y + 17, 2);
-
-  // Reset button
-  tft->fillRoundRect(140, BACK_BTN_Y, 100, 35, 5, TFT_ORANGE);
-  tft->drawRoundRect(140, BACK_BTN_Y, 100, 35, 5, COLOR_TEXT);
-  tft->setTextColor(COLOR_BG, TFT_ORANGE);
-  tft->drawString("RESET", 190, BACK_BTN_Y + 17, 2);
-
-  // Back button
-  tft->fillRoundRect(360, BACK_BTN_Y, 100, 35, 5, TFT_RED);
-  tft->drawRoundRect(360, BACK_BTN_Y, 100, 35, 5, COLOR_TEXT);
-  tft->setTextColor(COLOR_BG, TFT_RED);
-  tft->drawString("BACK", 410, BACK_BTN_Y + 17, 2);
-
-  tft->setTextDatum(TL_DATUM);
-}
+// Solo redibuja los widgets marcados como sucios
+void draw() { render(screen, tft); }
 
 bool handleTouch(int16_t x, int16_t y) {
   if (!visible) return false;
-  if (y >= BACK_BTN_Y && y <= BACK_BTN_Y + 35) {
-    if (x >= 20 && x <= 120) {
-      saveConfig();
-      needsRedraw = true;
-      return true;
-    }
-    if (x >= 140 && x <= 240) {
-      resetToDefaults();
-      needsRedraw = true;
-      return true;
-    }
-    if (x >= 360 && x <= 460) {
-      hide();
-      return false;
-    }
+  Widget *hit = screen.hitTest(x, y);
+  if (hit == &saveButton) {
+    saveConfig();
+    return true;
   }
-  int optionY = OPTION_START_Y + 25;
-  for (int i = 0; i < 3; i++) {
-    if (y >= optionY && y <= optionY + OPTION_HEIGHT) {
-      if (x >= SLIDER_X && x <= SLIDER_X + SLIDER_W) {
-        handleSliderTouch(i, x);
-        needsRedraw = true;
-        return true;
-      }
-    }
-    optionY += OPTION_HEIGHT;
+  if (hit == &resetButton) {
+    resetToDefaults();
+    syncWidgets();
+    return true;
   }
-  optionY += 35; // sensores
-  for (int i = 0; i < kNumObstacles; i++) {
-    if (y >= optionY && y <= optionY + OPTION_HEIGHT) {
-      if (x >= SLIDER_X && x <= SLIDER_X + 80) {
-        sensorEnabled[i] = !sensorEnabled[i];
-        Alerts::play(Audio::AUDIO_BEEP);
-        needsRedraw = true;
-        return true;
-      }
-    }
-    optionY += OPTION_HEIGHT;
+  if (hit == &backButton) {
+    hide();
+    return false;
   }
-  optionY += 10;
-  // Toggle audio
-  if (y >= optionY && y <= optionY + OPTION_HEIGHT) {
-    if (x >= SLIDER_X && x <= SLIDER_X + 80) {
-      audioAlertsEnabled = !audioAlertsEnabled;
-      Alerts::play(Audio::AUDIO_BEEP);
-      needsRedraw = true;
+  for (int i = 0; i < 3; i++) {
+    if (hit == &sliders[i]) {
+      handleSliderTouch(i, x);
+      syncWidgets();
       return true;
     }
   }
-  optionY += OPTION_HEIGHT;
-  // Toggle visual
-  if (y >= optionY && y <= optionY + OPTION_HEIGHT) {
-    if (x >= SLIDER_X && x <= SLIDER_X + 80) {
-      visualAlertsEnabled = !visualAlertsEnabled;
+  bool *states[3] = {&sensorEnabled[0], &audioAlertsEnabled,
+                     &visualAlertsEnabled};
+  for (int i = 0; i < 3; i++) {
+    if (hit == &toggles[i]) {
+      *states[i] = !*states[i];
       Alerts::play(Audio::AUDIO_BEEP);
-      needsRedraw = true;
+      syncWidgets();
       return true;
     }
   }
@@ -343,27 +356,24 @@ void handleInput(uint8_t button) {
   switch (button) {
   case 0:
     selectedOption = (selectedOption > 0) ? selectedOption - 1 : NUM_OPTIONS;
-    needsRedraw = true;
     break;
   case 1:
     selectedOption = (selectedOption + 1) % (NUM_OPTIONS + 1);
-    needsRedraw = true;
     break;
   case 2:
     adjustValue(-1);
-    needsRedraw = true;
     break;
   case 3:
     adjustValue(1);
-    needsRedraw = true;
     break;
   case 4:
     handleSelect();
     break;
   case 5:
     hide();
-    break;
+    return;
   }
+  syncWidgets();
 }
 
 void adjustValue(int direction) {
@@ -395,15 +405,12 @@ void handleSelect() {
   case 3: // Solo Front sensor
     sensorEnabled[0] = !sensorEnabled[0];
     Alerts::play(Audio::AUDIO_BEEP);
-    needsRedraw = true;
     break;
   case 4:
     audioAlertsEnabled = !audioAlertsEnabled;
-    needsRedraw = true;
     break;
   case 5:
     visualAlertsEnabled = !visualAlertsEnabled;
-    needsRedraw = true;
     break;
   case 6:
     saveConfig();
@@ -1,5 +1,6 @@
 #include "abs_system.h"
 #include "alerts.h"
+#include "black_box.h"
 #include "logger.h"
 #include "wheels.h"
 #include <Arduino.h>
@@ -164,6 +165,7 @@ void update() {
   // Audio feedback on activation/deactivation
   if (state.systemActive && !wasActive) {
     Alerts::play(Audio::AUDIO_ERROR_GENERAL);
+    BlackBox::trigger(BlackBox::TRIGGER_ABS);
   }
 
   lastUpdateMs = now;
@@ -7,6 +7,7 @@
 #include "obstacle_safety.h"
 #include "adaptive_cruise.h"
 #include "alerts.h"
+#include "black_box.h"
 #include "logger.h"
 #include "obstacle_config.h"
 #include "obstacle_detection.h"
@@ -93,7 +94,8 @@ void update() {
   ObstacleDetection::ObstacleStatus obstStatus;
   ObstacleDetection::getStatus(obstStatus);
 
-  // Reset state
+  // Reset state (wasBraking: black box triggers on the rising edge only)
+  bool wasBraking = state.emergencyBrakeApplied;
   state.parkingAssistActive = false;
   state.collisionImminent = false;
   state.blindSpotLeft = false;
@@ -111,6 +113,7 @@ void update() {
       state.emergencyBrakeApplied = true;
       state.collisionImminent = true;
       state.speedReductionFactor = 0.0f; // Full stop
+      if (!wasBraking) BlackBox::trigger(BlackBox::TRIGGER_EMERGENCY_STOP);
 
       // Alert periodically
       static uint32_t lastSensorFailAlertMs = 0;
@@ -194,6 +197,7 @@ void update() {
       state.collisionImminent = true;
       state.emergencyBrakeApplied = true;
       state.speedReductionFactor = 0.0f;
+      if (!wasBraking) BlackBox::trigger(BlackBox::TRIGGER_EMERGENCY_STOP);
       if (now - lastAlertMs[0] > ALERT_INTERVAL_MS) {
         Alerts::play(Audio::AUDIO_EMERGENCIA);
         Logger::warnf("ZONE 5: EMERGENCY STOP! Distance=%dmm", minDist);
@@ -304,6 +308,8 @@ void setConfig(const SafetyConfig &newConfig) {
 
 bool isCollisionImminent() { return state.collisionImminent; }
 
+bool isEmergencyBrakeApplied() { return state.emergencyBrakeApplied; }
+
 bool isParkingAssistActive() { return state.parkingAssistActive; }
 
 bool isBlindSpotActive() { return state.blindSpotLeft || state.blindSpotRight; }
@@ -323,6 +329,9 @@ void enableAdaptiveCruise(bool enable) {
 }
 
 void triggerEmergencyStop() {
+  if (!state.emergencyBrakeApplied) {
+    BlackBox::trigger(BlackBox::TRIGGER_EMERGENCY_STOP);
+  }
   state.emergencyBrakeApplied = true;
   state.collisionImminent = true;
   Alerts::play(Audio::AUDIO_EMERGENCIA);
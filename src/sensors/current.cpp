@@ -17,6 +17,8 @@
 // --- FIN FIX ---
 
 #include "boot_guard.h"
+#include "error_journal.h"
+#include "limp_mode.h"
 #include "i2c_recovery.h" // Sistema de recuperación I²C
 #include "logger.h"
 #include "pins.h" // 🔒 Para PIN_I2C_SDA y PIN_I2C_SCL
@@ -74,16 +76,12 @@ static bool tcaSelect(uint8_t channel) {
   if (i2cMutex != nullptr &&
       xSemaphoreTake(i2cMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
     // Mutex adquirido - acceso I2C protegido
+    // tcaSelectSafe() ya hace el bus recovery si el bus se bloqueó y deja
+    // el bus en pausa: reintentar aquí solo repetiría el timeout
     if (!I2CRecovery::tcaSelectSafe(channel, TCA_ADDR)) {
-      Logger::errorf("TCA select fail ch %d - recovery attempt", channel);
-      I2CRecovery::recoverBus(); // Intentar recuperar bus
-
-      // 🔒 CORRECCIÓN: Retry después de recovery
-      if (!I2CRecovery::tcaSelectSafe(channel, TCA_ADDR)) {
-        Logger::errorf("TCA select fail ch %d después de recovery", channel);
-        xSemaphoreGive(i2cMutex); // Liberar mutex antes de salir
-        return false;
-      }
+      Logger::errorf("TCA select fail ch %d", channel);
+      xSemaphoreGive(i2cMutex); // Liberar mutex antes de salir
+      return false;
     }
     xSemaphoreGive(i2cMutex); // Liberar mutex en éxito
     return true;
@@ -202,6 +200,7 @@ void Sensors::updateCurrent() {
       lastShunt[i] = 0.0f;
       sensorOk[i] = false;
     }
+    LimpMode::notify(LimpMode::SOURCE_BATTERY);
     return;
   }
 
@@ -209,8 +208,9 @@ void Sensors::updateCurrent() {
     // Check device state before reading
     const I2CRecovery::DeviceState &state = I2CRecovery::getDeviceState(i);
 
-    if (!state.online) {
-      // Sensor marcado offline, saltar
+    if (!state.online && millis() < state.nextRetryMs) {
+      // Sensor offline y aún en backoff, saltar. Vencido el backoff pasa por
+      // la recuperación de abajo
       sensorOk[i] = false;
       lastCurrent[i] = 0.0f;
       lastVoltage[i] = 0.0f;
@@ -230,6 +230,8 @@ void Sensors::updateCurrent() {
               ina[i]->begin()) {
             sensorOk[i] = true;
             Logger::infof("INA226 ch %d recovered!", i);
+          } else {
+            I2CRecovery::markDeviceOffline(i); // Siguiente intento en backoff
           }
         } else {
           Logger::errorf("INA226 ch %d: invalid TCA channel for recovery", i);
@@ -255,25 +257,25 @@ void Sensors::updateCurrent() {
     bool hasError = false;
     if (!isfinite(c)) {
       c = 0.0f;
-      System::logError(310 + i);
+      System::logError(310 + i, ErrorJournal::contextOf(c));
       Logger::errorf("INA226 ch %d: corriente inválida", i);
       hasError = true;
     }
     if (!isfinite(v)) {
       v = 0.0f;
-      System::logError(320 + i);
+      System::logError(320 + i, ErrorJournal::contextOf(v));
       Logger::errorf("INA226 ch %d: voltaje inválido", i);
       hasError = true;
     }
     if (!isfinite(p)) {
       p = 0.0f;
-      System::logError(330 + i);
+      System::logError(330 + i, ErrorJournal::contextOf(p));
       Logger::errorf("INA226 ch %d: potencia inválida", i);
       hasError = true;
     }
     if (!isfinite(s)) {
       s = 0.0f;
-      System::logError(340 + i);
+      System::logError(340 + i, ErrorJournal::contextOf(s));
       Logger::errorf("INA226 ch %d: shunt inválido", i);
       hasError = true;
     }
@@ -296,6 +298,9 @@ void Sensors::updateCurrent() {
     lastPower[i] = lastPower[i] + 0.2f * (p - lastPower[i]);
     lastShunt[i] = lastShunt[i] + 0.2f * (s - lastShunt[i]);
   }
+
+  // Nueva muestra de batería para LimpMode
+  LimpMode::notify(LimpMode::SOURCE_BATTERY);
 }
 
 float Sensors::getCurrent(int channel) {
@@ -119,7 +119,8 @@ static bool parseFrame() {
   if (expectedChecksum != receivedChecksum) {
     Logger::warnf("TOFSense: Checksum mismatch (expected 0x%02X, got 0x%02X)",
                   expectedChecksum, receivedChecksum);
-    System::logError(ObstacleConfig::ERROR_CODE_CHECKSUM);
+    System::logError(ObstacleConfig::ERROR_CODE_CHECKSUM,
+                     uint32_t(expectedChecksum) << 8 | receivedChecksum);
     return false;
   }
 
@@ -294,6 +295,10 @@ void init() {
   // Bidirectional UART: Both TX and RX configured for full communication
   // TX (GPIO43) → Sensor RX: Allows configuration commands
   // RX (GPIO44) ← Sensor TX: Receives 8x8 matrix data frames
+  // A 400-byte frame arrives in ~4.3 ms at 921600 baud; the default 256-byte
+  // ring plus the 128-byte FIFO overflow unless update() polls mid-frame.
+  // Two frames of buffer (must be set before begin()).
+  TOFSerial->setRxBufferSize(ObstacleConfig::FRAME_LENGTH * 2);
   TOFSerial->begin(ObstacleConfig::UART_BAUDRATE, SERIAL_8N1, PIN_TOFSENSE_RX,
                    PIN_TOFSENSE_TX);
 
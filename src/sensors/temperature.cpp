@@ -1,4 +1,5 @@
 #include "temperature.h"
+#include "limp_mode.h"
 #include "logger.h"
 #include "pins.h"
 #include "settings.h"
@@ -169,6 +170,7 @@ void Sensors::updateTemperature() {
       lastTemp[i] = 0.0f;
       sensorOk[i] = false;
     }
+    if (requestPending) LimpMode::notify(LimpMode::SOURCE_TEMPERATURE);
     requestPending = false;
     return;
   }
@@ -230,6 +232,9 @@ void Sensors::updateTemperature() {
       Logger::warn("Temperature: mutex timeout en updateTemperature");
     }
   }
+
+  // Conversión nueva: LimpMode re-evalúa avisos de temperatura
+  LimpMode::notify(LimpMode::SOURCE_TEMPERATURE);
 #endif
 }
 
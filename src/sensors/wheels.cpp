@@ -64,7 +64,7 @@ void Sensors::updateWheels() {
     if (dt > SENSOR_TIMEOUT_MS) {
       speed[i] = 0.0f;
       wheelOk[i] = false;
-      System::logError(500 + i); // ej. 500=FL, 501=FR, 502=RL, 503=RR
+      System::logError(500 + i, dt); // 500=FL, 501=FR, 502=RL, 503=RR
       continue;
     }
 
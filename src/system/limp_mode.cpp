@@ -1,4 +1,5 @@
 #include "limp_mode.h"
+#include "black_box.h"
 #include "current.h"
 #include "logger.h"
 #include "pedal.h"
@@ -6,6 +7,7 @@
 #include "system.h"
 #include "temperature.h"
 #include <Arduino.h>
+#include <atomic>
 
 namespace LimpMode {
 
@@ -22,19 +24,6 @@ static bool stateForced = false;
 static uint32_t timeEnteredState = 0;
 static uint32_t lastTransition = 0;
 
-// ==========================================
-// Safety thresholds
-// ==========================================
-namespace Thresholds {
-constexpr float BATTERY_UNDERVOLTAGE = 20.0f; // 24V system, critical at 20V
-constexpr float BATTERY_CRITICAL = 18.0f;     // Below this = CRITICAL
-constexpr float TEMP_WARNING = 80.0f;         // Motor temp warning (°C)
-constexpr float TEMP_CRITICAL = 90.0f;        // Motor temp critical (°C)
-constexpr uint8_t ERROR_COUNT_DEGRADED = 1;   // 1+ errors = DEGRADED
-constexpr uint8_t ERROR_COUNT_LIMP = 3;       // 3+ errors = LIMP
-constexpr uint8_t ERROR_COUNT_CRITICAL = 5;   // 5+ errors = CRITICAL
-} // namespace Thresholds
-
 // ==========================================
 // Power limits per state
 // ==========================================
@@ -64,29 +53,36 @@ constexpr float SPEED_CRITICAL = 0.25f; // 25% max speed
 constexpr uint32_t STATE_HYSTERESIS_MS = 500; // Prevent rapid state changes
 
 // ==========================================
-// Cached sensor readings
+// Change tracking
+// ==========================================
+// Every input is re-read this often even without a notification
+constexpr uint32_t FULL_REFRESH_MS = 1000;
+// Internal pending bit: re-read and re-evaluate everything (init / reset)
+constexpr uint32_t REFRESH_ALL = 1u << 31;
+
+static std::atomic<uint32_t> pendingSources{0};
+static uint32_t lastFullRefreshMs = 0;
+
+// ==========================================
+// Cached rule inputs and per-group results
 // ==========================================
-struct SensorCache {
-  bool pedalValid;
-  bool steeringValid;
-  float pedalPercent;
-  float steeringAngle;
-  uint8_t systemErrorCount;
-  float batteryVoltage;
-  bool temperatureWarning;
-  bool temperatureCritical;
-  bool steeringCentered;
-  uint32_t lastUpdateMs;
-};
-
-static SensorCache cache;
+static RuleInputs cache;
+static RuleSet rules;
+
+// ==========================================
+// Published diagnostics (seqlock, odd = being written)
+// ==========================================
+static Diagnostics published;
+static std::atomic<uint32_t> diagSeq{0};
+constexpr uint8_t DIAG_READ_RETRIES = 4;
 
 // ==========================================
 // Forward declarations
 // ==========================================
 static void transitionToState(LimpState newState);
-static LimpState evaluateConditions();
-static void updateSensorCache();
+static uint8_t refreshInputs(uint32_t sources);
+static Diagnostics buildDiagnostics();
+static void publishDiagnostics();
 static float getPowerLimit(LimpState state);
 static float getSteeringLimit(LimpState state);
 static float getSpeedLimit(LimpState state);
@@ -101,91 +97,50 @@ void init() {
   lastTransition = millis();
 
   memset(&cache, 0, sizeof(cache));
+  rules = RuleSet();
+  lastFullRefreshMs = millis();
+  pendingSources.store(SOURCE_ALL | REFRESH_ALL);
+  publishDiagnostics();
 
   Logger::info("[LimpMode] Initialized in NORMAL state");
 }
 
+void notify(uint8_t sources) {
+  pendingSources.fetch_or(sources, std::memory_order_release);
+}
+
 // ==========================================
 // Main update loop
 // ==========================================
 void update() {
   uint32_t now = millis();
 
-  // Update sensor readings
-  updateSensorCache();
-
-  // If state is forced (for testing), skip evaluation
-  if (stateForced) {
-    currentState = forcedState;
-    return;
+  // Inputs flagged since the last call; everything once per second
+  uint32_t sources = pendingSources.exchange(0, std::memory_order_acquire);
+  if (now - lastFullRefreshMs >= FULL_REFRESH_MS) {
+    sources |= SOURCE_ALL | REFRESH_ALL;
   }
+  if (sources & REFRESH_ALL) lastFullRefreshMs = now;
 
-  // Evaluate conditions to determine required state
-  LimpState requiredState = evaluateConditions();
+  // Re-read flagged inputs, re-evaluate only the groups they feed
+  uint8_t groups = refreshInputs(sources);
+  LimpState requiredState = rules.update(cache, groups);
 
-  // Apply hysteresis to prevent rapid transitions
-  if (requiredState != currentState) {
+  // If state is forced (for testing), skip the transition
+  if (stateForced) {
+    currentState = forcedState;
+  } else if (requiredState != currentState) {
+    // Apply hysteresis to prevent rapid transitions
     uint32_t timeSinceTransition = now - lastTransition;
     if (timeSinceTransition >= STATE_HYSTERESIS_MS) {
       transitionToState(requiredState);
     }
   }
-}
-
-// ==========================================
-// State evaluation logic
-// ==========================================
-static LimpState evaluateConditions() {
-  // Check for CRITICAL conditions first (highest priority)
-
-  // Both pedal AND steering invalid = CRITICAL
-  if (!cache.pedalValid && !cache.steeringValid) { return LimpState::CRITICAL; }
-
-  // Battery critically low = CRITICAL
-  if (cache.batteryVoltage > 0.0f &&
-      cache.batteryVoltage < Thresholds::BATTERY_CRITICAL) {
-    return LimpState::CRITICAL;
-  }
-
-  // Temperature critical = CRITICAL
-  if (cache.temperatureCritical) { return LimpState::CRITICAL; }
-
-  // Too many errors = CRITICAL
-  if (cache.systemErrorCount >= Thresholds::ERROR_COUNT_CRITICAL) {
-    return LimpState::CRITICAL;
-  }
-
-  // Check for LIMP conditions (medium priority)
 
-  // Moderate error count = LIMP
-  if (cache.systemErrorCount >= Thresholds::ERROR_COUNT_LIMP) {
-    return LimpState::LIMP;
+  if (groups != 0 || currentState != published.state ||
+      lastTransition != published.lastTransitionMs) {
+    publishDiagnostics();
   }
-
-  // Battery undervoltage = LIMP
-  if (cache.batteryVoltage > 0.0f &&
-      cache.batteryVoltage < Thresholds::BATTERY_UNDERVOLTAGE) {
-    return LimpState::LIMP;
-  }
-
-  // Steering not centered (encoder not initialized) = LIMP
-  if (!cache.steeringCentered) { return LimpState::LIMP; }
-
-  // Either pedal OR steering invalid = LIMP
-  if (!cache.pedalValid || !cache.steeringValid) { return LimpState::LIMP; }
-
-  // Check for DEGRADED conditions (low priority)
-
-  // Any errors present = DEGRADED
-  if (cache.systemErrorCount >= Thresholds::ERROR_COUNT_DEGRADED) {
-    return LimpState::DEGRADED;
-  }
-
-  // Temperature warning = DEGRADED
-  if (cache.temperatureWarning) { return LimpState::DEGRADED; }
-
-  // All conditions OK = NORMAL
-  return LimpState::NORMAL;
 }
 
 // ==========================================
@@ -199,6 +154,11 @@ static void transitionToState(LimpState newState) {
   Logger::warnf("[LimpMode] State transition: %s -> %s",
                 stateNames[(int)currentState], stateNames[(int)newState]);
 
+  // Black box: freeze the seconds before the car lost drive power
+  if (newState >= LimpState::LIMP && currentState < LimpState::LIMP) {
+    BlackBox::trigger(BlackBox::TRIGGER_LIMP);
+  }
+
   currentState = newState;
   timeEnteredState = millis();
   lastTransition = millis();
@@ -207,37 +167,120 @@ static void transitionToState(LimpState newState) {
 // ==========================================
 // Sensor cache update
 // ==========================================
-static void updateSensorCache() {
-  cache.lastUpdateMs = millis();
-
-  // Pedal state
-  const Pedal::State &pedalState = Pedal::get();
-  cache.pedalValid = pedalState.valid;
-  cache.pedalPercent = pedalState.percent;
-
-  // Steering state
-  const Steering::State &steeringState = Steering::get();
-  cache.steeringValid = steeringState.valid;
-  cache.steeringAngle = steeringState.angleDeg;
-  cache.steeringCentered = steeringState.centered;
-
-  // System error count
-  cache.systemErrorCount = (uint8_t)System::getErrorCount();
+// Re-reads the inputs behind `sources`; returns the rule groups whose
+// inputs changed (all of them on REFRESH_ALL).
+static uint8_t refreshInputs(uint32_t sources) {
+  uint8_t groups = (sources & REFRESH_ALL) ? GROUP_ALL : 0;
+
+  // Pedal and steering state
+  if (sources & (SOURCE_PEDAL | SOURCE_STEERING)) {
+    const Pedal::State &pedalState = Pedal::get();
+    const Steering::State &steeringState = Steering::get();
+    if (pedalState.valid != cache.pedalValid ||
+        steeringState.valid != cache.steeringValid ||
+        steeringState.centered != cache.steeringCentered) {
+      cache.pedalValid = pedalState.valid;
+      cache.steeringValid = steeringState.valid;
+      cache.steeringCentered = steeringState.centered;
+      groups |= GROUP_INPUTS;
+    }
+  }
 
   // Battery voltage (from INA226 channel 4 - battery monitor)
   // Channel 4 is typically the battery monitor channel
-  cache.batteryVoltage = Sensors::getVoltage(4);
+  if (sources & SOURCE_BATTERY) {
+    float voltage = Sensors::getVoltage(4);
+    if (voltage != cache.batteryVoltage) {
+      cache.batteryVoltage = voltage;
+      groups |= GROUP_BATTERY;
+    }
+  }
 
   // Temperature warnings
   // Check all motor temperatures (indices 0-3)
-  cache.temperatureWarning = false;
-  cache.temperatureCritical = false;
+  if (sources & SOURCE_TEMPERATURE) {
+    bool warning = false;
+    bool critical = false;
+    for (int i = 0; i < 4; i++) { // Check 4 motor temps
+      float temp = Sensors::getTemperature(i);
+      if (temp > Thresholds::TEMP_WARNING) { warning = true; }
+      if (temp > Thresholds::TEMP_CRITICAL) { critical = true; }
+    }
+    if (warning != cache.temperatureWarning ||
+        critical != cache.temperatureCritical) {
+      cache.temperatureWarning = warning;
+      cache.temperatureCritical = critical;
+      groups |= GROUP_TEMPERATURE;
+    }
+  }
 
-  for (int i = 0; i < 4; i++) { // Check 4 motor temps
-    float temp = Sensors::getTemperature(i);
-    if (temp > Thresholds::TEMP_WARNING) { cache.temperatureWarning = true; }
-    if (temp > Thresholds::TEMP_CRITICAL) { cache.temperatureCritical = true; }
+  // System error count
+  if (sources & SOURCE_ERRORS) {
+    uint8_t errors = (uint8_t)System::getDistinctErrorCount();
+    if (errors != cache.systemErrorCount) {
+      cache.systemErrorCount = errors;
+      groups |= GROUP_ERRORS;
+    }
   }
+
+  return groups;
+}
+
+// ==========================================
+// Diagnostics snapshot
+// ==========================================
+static Diagnostics buildDiagnostics() {
+  Diagnostics diag;
+  diag.state = currentState;
+
+  // Input validity
+  diag.pedalValid = cache.pedalValid;
+  diag.steeringValid = cache.steeringValid;
+
+  // System health
+  diag.systemErrorCount = cache.systemErrorCount;
+  diag.batteryUndervoltage =
+      (cache.batteryVoltage > 0.0f &&
+       cache.batteryVoltage < Thresholds::BATTERY_UNDERVOLTAGE);
+  diag.temperatureWarning = cache.temperatureWarning;
+  diag.steeringCentered = cache.steeringCentered;
+
+  // Applied limits
+  diag.powerLimit = getPowerLimit(currentState);
+  diag.steeringLimit = getSteeringLimit(currentState);
+  diag.maxSpeedLimit = getSpeedLimit(currentState);
+
+  // Timing (timeInStateMs is filled in by the reader)
+  diag.timeInStateMs = 0;
+  diag.lastTransitionMs = lastTransition;
+
+  return diag;
+}
+
+static bool sameDiagnostics(const Diagnostics &a, const Diagnostics &b) {
+  return a.state == b.state && a.pedalValid == b.pedalValid &&
+         a.steeringValid == b.steeringValid &&
+         a.systemErrorCount == b.systemErrorCount &&
+         a.batteryUndervoltage == b.batteryUndervoltage &&
+         a.temperatureWarning == b.temperatureWarning &&
+         a.steeringCentered == b.steeringCentered &&
+         a.lastTransitionMs == b.lastTransitionMs;
+  // Limits follow from state
+}
+
+// Single writer: init() and update() (control task)
+static void publishDiagnostics() {
+  Diagnostics diag = buildDiagnostics();
+  uint32_t seq = diagSeq.load(std::memory_order_relaxed);
+  if (seq != 0 && sameDiagnostics(diag, published)) return;
+
+  diagSeq.store(seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  published = diag;
+  // Skip 0 on wrap-around: readers pass 0 to force a copy
+  uint32_t next = seq + 2;
+  if (next == 0) next = 2;
+  diagSeq.store(next, std::memory_order_release);
 }
 
 // ==========================================
@@ -295,33 +338,31 @@ static float getSpeedLimit(LimpState state) {
 LimpState getState() { return currentState; }
 
 Diagnostics getDiagnostics() {
-  Diagnostics diag;
-  diag.state = currentState;
-
-  // Input validity
-  diag.pedalValid = cache.pedalValid;
-  diag.steeringValid = cache.steeringValid;
-
-  // System health
-  diag.systemErrorCount = cache.systemErrorCount;
-  diag.batteryUndervoltage =
-      (cache.batteryVoltage > 0.0f &&
-       cache.batteryVoltage < Thresholds::BATTERY_UNDERVOLTAGE);
-  diag.temperatureWarning = cache.temperatureWarning;
-  diag.steeringCentered = cache.steeringCentered;
-
-  // Applied limits
-  diag.powerLimit = getPowerLimit(currentState);
-  diag.steeringLimit = getSteeringLimit(currentState);
-  diag.maxSpeedLimit = getSpeedLimit(currentState);
-
-  // Timing
+  Diagnostics diag = buildDiagnostics();
   diag.timeInStateMs = millis() - timeEnteredState;
-  diag.lastTransitionMs = lastTransition;
-
   return diag;
 }
 
+bool readDiagnostics(uint32_t &seenVersion, Diagnostics &out) {
+  for (uint8_t attempt = 0; attempt < DIAG_READ_RETRIES; attempt++) {
+    uint32_t seq = diagSeq.load(std::memory_order_acquire);
+    if (seq == 0) return false; // Not initialized yet
+    if (seq == seenVersion) return false;
+    if (seq & 1) continue; // Writer active, try again
+
+    Diagnostics copy = published;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (diagSeq.load(std::memory_order_relaxed) != seq) continue;
+
+    // timeEnteredState and lastTransition always move together
+    copy.timeInStateMs = millis() - copy.lastTransitionMs;
+    out = copy;
+    seenVersion = seq;
+    return true;
+  }
+  return false; // Keep the previous copy, retry next frame
+}
+
 float limitPower(float pedalPercent) {
   // Clamp input to valid range
   if (pedalPercent < 0.0f) pedalPercent = 0.0f;
@@ -370,6 +411,8 @@ void reset() {
   currentState = LimpState::NORMAL;
   timeEnteredState = millis();
   lastTransition = millis();
+  // Re-read and re-evaluate everything on the next update()
+  pendingSources.fetch_or(SOURCE_ALL | REFRESH_ALL, std::memory_order_release);
   Logger::info("[LimpMode] Reset to NORMAL state");
 }
 
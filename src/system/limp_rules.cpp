@@ -0,0 +1,128 @@
+// limp_rules.cpp - LimpMode degradation rules, full and incremental
+#include "limp_rules.h"
+
+namespace LimpMode {
+
+// ==========================================
+// Reference evaluator
+// ==========================================
+LimpState evaluateAll(const RuleInputs &in) {
+  // Check for CRITICAL conditions first (highest priority)
+
+  // Both pedal AND steering invalid = CRITICAL
+  if (!in.pedalValid && !in.steeringValid) { return LimpState::CRITICAL; }
+
+  // Battery critically low = CRITICAL
+  if (in.batteryVoltage > 0.0f &&
+      in.batteryVoltage < Thresholds::BATTERY_CRITICAL) {
+    return LimpState::CRITICAL;
+  }
+
+  // Temperature critical = CRITICAL
+  if (in.temperatureCritical) { return LimpState::CRITICAL; }
+
+  // Too many errors = CRITICAL
+  if (in.systemErrorCount >= Thresholds::ERROR_COUNT_CRITICAL) {
+    return LimpState::CRITICAL;
+  }
+
+  // Check for LIMP conditions (medium priority)
+
+  // Moderate error count = LIMP
+  if (in.systemErrorCount >= Thresholds::ERROR_COUNT_LIMP) {
+    return LimpState::LIMP;
+  }
+
+  // Battery undervoltage = LIMP
+  if (in.batteryVoltage > 0.0f &&
+      in.batteryVoltage < Thresholds::BATTERY_UNDERVOLTAGE) {
+    return LimpState::LIMP;
+  }
+
+  // Steering not centered (encoder not initialized) = LIMP
+  if (!in.steeringCentered) { return LimpState::LIMP; }
+
+  // Either pedal OR steering invalid = LIMP
+  if (!in.pedalValid || !in.steeringValid) { return LimpState::LIMP; }
+
+  // Check for DEGRADED conditions (low priority)
+
+  // Any errors present = DEGRADED
+  if (in.systemErrorCount >= Thresholds::ERROR_COUNT_DEGRADED) {
+    return LimpState::DEGRADED;
+  }
+
+  // Temperature warning = DEGRADED
+  if (in.temperatureWarning) { return LimpState::DEGRADED; }
+
+  // All conditions OK = NORMAL
+  return LimpState::NORMAL;
+}
+
+// ==========================================
+// Rule groups (same rules, split by input)
+// ==========================================
+static LimpState evaluateInputs(const RuleInputs &in) {
+  if (!in.pedalValid && !in.steeringValid) return LimpState::CRITICAL;
+  if (!in.steeringCentered) return LimpState::LIMP;
+  if (!in.pedalValid || !in.steeringValid) return LimpState::LIMP;
+  return LimpState::NORMAL;
+}
+
+static LimpState evaluateBattery(const RuleInputs &in) {
+  // No reading (0, negative, NaN) never degrades
+  if (!(in.batteryVoltage > 0.0f)) return LimpState::NORMAL;
+  if (in.batteryVoltage < Thresholds::BATTERY_CRITICAL) {
+    return LimpState::CRITICAL;
+  }
+  if (in.batteryVoltage < Thresholds::BATTERY_UNDERVOLTAGE) {
+    return LimpState::LIMP;
+  }
+  return LimpState::NORMAL;
+}
+
+static LimpState evaluateTemperature(const RuleInputs &in) {
+  if (in.temperatureCritical) return LimpState::CRITICAL;
+  if (in.temperatureWarning) return LimpState::DEGRADED;
+  return LimpState::NORMAL;
+}
+
+static LimpState evaluateErrors(const RuleInputs &in) {
+  if (in.systemErrorCount >= Thresholds::ERROR_COUNT_CRITICAL) {
+    return LimpState::CRITICAL;
+  }
+  if (in.systemErrorCount >= Thresholds::ERROR_COUNT_LIMP) {
+    return LimpState::LIMP;
+  }
+  if (in.systemErrorCount >= Thresholds::ERROR_COUNT_DEGRADED) {
+    return LimpState::DEGRADED;
+  }
+  return LimpState::NORMAL;
+}
+
+static LimpState (*const GROUP_EVALUATORS[])(const RuleInputs &) = {
+    evaluateInputs, evaluateBattery, evaluateTemperature, evaluateErrors};
+
+RuleSet::RuleSet() : required_(LimpState::NORMAL), evaluations_(0) {
+  for (LimpState &g : group_) g = LimpState::NORMAL;
+}
+
+LimpState RuleSet::update(const RuleInputs &in, uint8_t changed) {
+  changed &= GROUP_ALL;
+  if (changed == 0) return required_;
+
+  for (uint8_t g = 0; g < GROUP_COUNT; g++) {
+    if (changed & (1 << g)) {
+      group_[g] = GROUP_EVALUATORS[g](in);
+      evaluations_++;
+    }
+  }
+
+  required_ = LimpState::NORMAL;
+  for (LimpState g : group_) {
+    if (g > required_) required_ = g;
+  }
+  return required_;
+}
+
+} // namespace LimpMode
@@ -0,0 +1,258 @@
+// ============================================================================
+// acc_scenario_tests.cpp - Adaptive cruise following-scenario simulation
+// ============================================================================
+
+#include "acc_scenario_tests.h"
+#include "acc_predictive.h"
+#include "logger.h"
+#include "test_utils.h"
+
+namespace AccScenarioTests {
+
+// ============================================================================
+// Private State
+// ============================================================================
+
+static TestUtils::TestCounters counters;
+
+// Simulation parameters (person-following defaults from AdaptiveCruise::init)
+static const float SIM_DT_S = AccPredictive::CONTROL_DT_S; // 100 Hz
+static const uint32_t SIM_STEPS = 3000;                    // 30 s
+static const uint32_t SENSOR_PERIOD_MS = 66;               // ~15 Hz
+static const float TARGET_GAP_MM = 500.0f;
+static const float EMERGENCY_GAP_MM = 300.0f;
+static const float MIN_FACTOR = 0.5f; // maxSpeedReduction = 50 %
+static const float REFERENCE_SPEED_MM_S = 2000.0f;
+static const float SETTLE_TIME_S = 5.0f;
+static const float REVERSAL_DEADBAND = 0.002f; // factor change per cycle
+
+enum class LeadProfile : uint8_t { STEADY, BRAKING, STOP_AND_GO };
+
+struct ScenarioResult {
+  uint32_t reversals;   // Speed factor direction changes
+  float gapRmsMm;       // RMS gap error after settling
+  float minGapMm;       // Closest approach
+  float maxJerk;        // Peak |d2 factor / dt2| outside brake events
+  uint32_t computeUsMax; // Worst predictive cycle
+  uint32_t computeUsSum; // Sum over all predictive cycles
+  uint32_t overruns;     // Cycles above COMPUTE_BUDGET_US
+};
+
+// ============================================================================
+// Helper Functions
+// ============================================================================
+
+static float leadSpeedMmS(LeadProfile profile, float tS) {
+  switch (profile) {
+  case LeadProfile::BRAKING:
+    if (tS < 5.0f) return 1000.0f;
+    return max(0.0f, 1000.0f - 800.0f * (tS - 5.0f));
+  case LeadProfile::STOP_AND_GO:
+    return 800.0f + 300.0f * sinf(tS * 0.8f);
+  case LeadProfile::STEADY:
+  default:
+    return 1000.0f;
+  }
+}
+
+// Deterministic +/-15 mm sensor noise (LCG, identical on every run)
+static float sensorNoise(uint32_t &seed) {
+  seed = seed * 1664525UL + 1013904223UL;
+  return (float)((seed >> 8) % 31) - 15.0f;
+}
+
+static ScenarioResult simulate(LeadProfile profile, bool predictive) {
+  ScenarioResult r = {0, 0.0f, 1e9f, 0.0f, 0, 0, 0};
+
+  float gapMm = 1500.0f;
+  float egoMmS = 1000.0f;
+  float factor = MIN_FACTOR;
+  float measuredMm = gapMm;
+  uint32_t sampleMs = 0;
+  uint32_t seed = 1;
+
+  // Legacy PID state (mirrors AdaptiveCruise ACC_MODE_PID)
+  float pidIntegral = 0.0f;
+  float pidLastError = 0.0f;
+
+  AccPredictive::EstimatorState est;
+  AccPredictive::ControllerState ctl;
+  AccPredictive::resetController(ctl, factor);
+  AccPredictive::Limits lim;
+  lim.minFactor = MIN_FACTOR;
+  lim.referenceSpeedMmS = REFERENCE_SPEED_MM_S;
+
+  float lastFactor = factor;
+  float lastRate = 0.0f;
+  bool lastBraked = false;
+  int8_t lastDir = 0;
+  double errSq = 0.0;
+  uint32_t errCount = 0;
+
+  for (uint32_t k = 0; k < SIM_STEPS; k++) {
+    float tS = k * SIM_DT_S;
+    uint32_t nowMs = k * 10;
+
+    // TOFSense frame (quantized to 1 mm)
+    if (k > 0 && (nowMs % SENSOR_PERIOD_MS) < 10) {
+      measuredMm = (float)(int32_t)(gapMm + sensorNoise(seed));
+      sampleMs = nowMs;
+    }
+
+    bool emergency = measuredMm < EMERGENCY_GAP_MM;
+    if (emergency) {
+      factor = 0.0f;
+      pidIntegral = 0.0f;
+      pidLastError = 0.0f;
+      AccPredictive::resetEstimator(est);
+      AccPredictive::engageBrake(ctl, MIN_FACTOR);
+    } else if (predictive) {
+      uint32_t t0 = micros();
+      AccPredictive::fuseSample(est, measuredMm, sampleMs);
+      float predGap, predVel;
+      AccPredictive::predict(est, nowMs, predGap, predVel);
+      factor = AccPredictive::step(ctl, predGap, predVel, est.relAccelMmS2,
+                                   TARGET_GAP_MM, EMERGENCY_GAP_MM, lim,
+                                   SIM_DT_S);
+      uint32_t us = micros() - t0;
+      r.computeUsSum += us;
+      if (us > r.computeUsMax) r.computeUsMax = us;
+      if (us > AccPredictive::COMPUTE_BUDGET_US) r.overruns++;
+    } else if (k % 10 == 0) {
+      float error = measuredMm - TARGET_GAP_MM;
+      pidIntegral = constrain(pidIntegral + error * 0.1f, -500.0f, 500.0f);
+      float derivative = (error - pidLastError) / 0.1f;
+      pidLastError = error;
+      float out = 0.3f * error + 0.05f * pidIntegral + 0.15f * derivative;
+      factor = constrain(1.0f + out / 1000.0f, MIN_FACTOR, 1.0f);
+    }
+
+    // Plant: first-order motor response, lead moves independently
+    float commandMmS = factor * REFERENCE_SPEED_MM_S;
+    egoMmS += (commandMmS - egoMmS) * (SIM_DT_S / AccPredictive::MOTOR_LAG_S);
+    gapMm += (leadSpeedMmS(profile, tS) - egoMmS) * SIM_DT_S;
+
+    // Metrics
+    if (gapMm < r.minGapMm) r.minGapMm = gapMm;
+    float delta = factor - lastFactor;
+    int8_t dir = 0;
+    if (delta > REVERSAL_DEADBAND) dir = 1;
+    if (delta < -REVERSAL_DEADBAND) dir = -1;
+    if (dir != 0 && lastDir != 0 && dir != lastDir) r.reversals++;
+    if (dir != 0) lastDir = dir;
+    float rate = delta / SIM_DT_S;
+    float jerk = fabsf(rate - lastRate) / SIM_DT_S;
+    bool braked = factor == 0.0f || lastFactor == 0.0f;
+    if (!braked && !lastBraked && k > 0 && jerk > r.maxJerk) r.maxJerk = jerk;
+    lastBraked = braked;
+    lastRate = rate;
+    lastFactor = factor;
+    if (tS >= SETTLE_TIME_S) {
+      float e = gapMm - TARGET_GAP_MM;
+      errSq += (double)e * e;
+      errCount++;
+    }
+  }
+
+  r.gapRmsMm = errCount > 0 ? (float)sqrt(errSq / errCount) : 0.0f;
+  return r;
+}
+
+static void logResult(const char *name, const ScenarioResult &pid,
+                      const ScenarioResult &mpc) {
+  Logger::infof("%s PID : reversals=%lu rms=%.0fmm min=%.0fmm jerk=%.0f",
+                name, pid.reversals, pid.gapRmsMm, pid.minGapMm, pid.maxJerk);
+  Logger::infof("%s MPC : reversals=%lu rms=%.0fmm min=%.0fmm jerk=%.0f", name,
+                mpc.reversals, mpc.gapRmsMm, mpc.minGapMm, mpc.maxJerk);
+}
+
+// ============================================================================
+// Public API Implementation
+// ============================================================================
+
+void init() {
+  counters.initialize();
+  Logger::info("AccScenarioTests: Initialized");
+}
+
+bool runAllTests() {
+  if (!counters.initialized) { init(); }
+
+  Logger::info("\n========================================");
+  Logger::info("Starting ACC Following Scenario Tests");
+  Logger::info("========================================");
+
+  counters.reset();
+
+  bool allPassed = true;
+
+  allPassed &= testSteadyFollowing();
+  allPassed &= testLeadBraking();
+  allPassed &= testStopAndGo();
+  allPassed &= testComputeBudget();
+
+  printSummary();
+
+  return allPassed;
+}
+
+bool testSteadyFollowing() {
+  Logger::info("\n--- Scenario: steady lead ---");
+  ScenarioResult pid = simulate(LeadProfile::STEADY, false);
+  ScenarioResult mpc = simulate(LeadProfile::STEADY, true);
+  logResult("Steady", pid, mpc);
+
+  bool passed = mpc.reversals < pid.reversals &&
+                mpc.gapRmsMm < pid.gapRmsMm && mpc.maxJerk < pid.maxJerk;
+  recordTest(counters, "Steady following oscillation", passed, "ACC TEST");
+  return passed;
+}
+
+bool testLeadBraking() {
+  Logger::info("\n--- Scenario: lead brakes to a stop ---");
+  ScenarioResult pid = simulate(LeadProfile::BRAKING, false);
+  ScenarioResult mpc = simulate(LeadProfile::BRAKING, true);
+  logResult("Braking", pid, mpc);
+
+  bool passed = mpc.minGapMm >= pid.minGapMm;
+  recordTest(counters, "Lead braking minimum gap", passed, "ACC TEST");
+  return passed;
+}
+
+bool testStopAndGo() {
+  Logger::info("\n--- Scenario: stop-and-go lead ---");
+  ScenarioResult pid = simulate(LeadProfile::STOP_AND_GO, false);
+  ScenarioResult mpc = simulate(LeadProfile::STOP_AND_GO, true);
+  logResult("StopGo", pid, mpc);
+
+  bool passed = mpc.reversals <= pid.reversals && mpc.minGapMm >= pid.minGapMm;
+  recordTest(counters, "Stop-and-go following", passed, "ACC TEST");
+  return passed;
+}
+
+bool testComputeBudget() {
+  Logger::info("\n--- Predictive compute budget ---");
+  ScenarioResult mpc = simulate(LeadProfile::STOP_AND_GO, true);
+  float avgUs = (float)mpc.computeUsSum / SIM_STEPS;
+  Logger::infof("Predictive cycle: avg=%.2fus max=%luus budget=%luus "
+                "overruns=%lu/%lu",
+                avgUs, mpc.computeUsMax,
+                (unsigned long)AccPredictive::COMPUTE_BUDGET_US, mpc.overruns,
+                SIM_STEPS);
+
+  // Allow isolated ISR-induced spikes, never a systematic overrun
+  bool passed = avgUs <= AccPredictive::COMPUTE_BUDGET_US &&
+                mpc.overruns <= SIM_STEPS / 1000;
+  recordTest(counters, "Predictive compute budget", passed, "ACC TEST");
+  return passed;
+}
+
+void printSummary() {
+  TestUtils::printSummary(counters, "ACC Scenario Test");
+}
+
+uint32_t getPassedCount() { return counters.passedCount; }
+
+uint32_t getFailedCount() { return counters.failedCount; }
+
+} // namespace AccScenarioTests
@@ -26,6 +26,10 @@
 #include "audio_validation_tests.h"
 #endif
 
+#ifdef ENABLE_ACC_SCENARIO_TESTS
+#include "acc_scenario_tests.h"
+#endif
+
 namespace TestRunner {
 
 // ============================================================================
@@ -187,6 +191,30 @@ bool runPreDeploymentTests() {
   Logger::info("\n⏭️  WATCHDOG TESTS: Skipped (not enabled)");
 #endif
 
+  // ========================================================================
+  // 5. ACC FOLLOWING SCENARIO SIMULATION
+  // ========================================================================
+#ifdef ENABLE_ACC_SCENARIO_TESTS
+  Logger::info(
+      "\n┌────────────────────────────────────────────────────────────┐");
+  Logger::info(
+      "│ 5/5: ACC FOLLOWING SCENARIO SIMULATION                     │");
+  Logger::info(
+      "└────────────────────────────────────────────────────────────┘");
+
+  AccScenarioTests::init();
+  bool accOk = AccScenarioTests::runAllTests();
+
+  totalPassed += AccScenarioTests::getPassedCount();
+  totalFailed += AccScenarioTests::getFailedCount();
+  totalTests +=
+      AccScenarioTests::getPassedCount() + AccScenarioTests::getFailedCount();
+
+  allPassed &= accOk;
+#else
+  Logger::info("\n⏭️  ACC SCENARIO TESTS: Skipped (not enabled)");
+#endif
+
   // ========================================================================
   // OVERALL SUMMARY
   // ========================================================================
@@ -198,7 +226,8 @@ bool runPreDeploymentTests() {
 bool isTestModeEnabled() {
 #if defined(ENABLE_FUNCTIONAL_TESTS) || defined(ENABLE_MEMORY_STRESS_TESTS) || \
     defined(ENABLE_HARDWARE_FAILURE_TESTS) ||                                  \
-    defined(ENABLE_WATCHDOG_TESTS) || defined(ENABLE_AUDIO_VALIDATION_TESTS)
+    defined(ENABLE_WATCHDOG_TESTS) || defined(ENABLE_AUDIO_VALIDATION_TESTS) || \
+    defined(ENABLE_ACC_SCENARIO_TESTS)
   return true;
 #else
   return false;
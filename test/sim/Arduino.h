@@ -0,0 +1,82 @@
+#pragma once
+
+// ============================================================================
+// Arduino.h - Host shim over the Sim world (env:native_sim only)
+// ============================================================================
+// Just enough of the Arduino-ESP32 core for the drivers under test; time,
+// pins and interrupts go to sim_harness.h instead of the hardware.
+// ============================================================================
+
+#include "sim_harness.h"
+#include <algorithm>
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+using std::max;
+using std::min;
+
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define INPUT_PULLDOWN 0x09
+#define LOW 0x0
+#define HIGH 0x1
+#define RISING Sim::EDGE_RISING
+#define FALLING Sim::EDGE_FALLING
+#define CHANGE Sim::EDGE_CHANGE
+
+#define IRAM_ATTR
+
+#define constrain(amt, low, high)                                              \
+  ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+inline unsigned long millis() { return Sim::clock().millis(); }
+inline unsigned long micros() { return Sim::clock().micros(); }
+inline void delay(uint32_t ms) { Sim::advanceMs(ms); }
+inline void delayMicroseconds(uint32_t us) { Sim::advanceUs(us); }
+inline void yield() {}
+
+inline void pinMode(uint8_t pin, uint8_t mode) { Sim::gpio().setMode(pin, mode); }
+inline int digitalRead(uint8_t pin) { return Sim::gpio().read(pin); }
+inline void digitalWrite(uint8_t pin, uint8_t val) {
+  Sim::gpio().write(pin, val != LOW);
+}
+inline uint16_t analogRead(uint8_t pin) { return Sim::adc().read(pin); }
+
+inline uint8_t digitalPinToInterrupt(uint8_t pin) { return pin; }
+inline void attachInterrupt(uint8_t pin, void (*isr)(), int mode) {
+  Sim::gpio().attach(pin, isr, static_cast<uint8_t>(mode));
+}
+inline void detachInterrupt(uint8_t pin) { Sim::gpio().detach(pin); }
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+// Console: silent unless a test opts in
+class HostSerial {
+public:
+  bool echo = false;
+
+  void begin(unsigned long) {}
+  void flush() { fflush(stdout); }
+  explicit operator bool() const { return true; }
+  size_t print(const char *s) { return echo ? ::printf("%s", s) : 0; }
+  size_t print(unsigned long v) { return echo ? ::printf("%lu", v) : 0; }
+  size_t println(const char *s) { return echo ? ::printf("%s\n", s) : 0; }
+  size_t printf(const char *fmt, ...) {
+    if (!echo) return 0;
+    va_list args;
+    va_start(args, fmt);
+    int n = vprintf(fmt, args);
+    va_end(args);
+    return n > 0 ? size_t(n) : 0;
+  }
+};
+
+inline HostSerial Serial;
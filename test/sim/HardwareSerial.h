@@ -0,0 +1,37 @@
+#pragma once
+
+// ============================================================================
+// HardwareSerial.h - Host shim: UART ports backed by Sim::uart()
+// ============================================================================
+
+#include "Arduino.h"
+
+#define SERIAL_8N1 0x800001c
+
+class HardwareSerial {
+public:
+  explicit HardwareSerial(int uartNum)
+      : port_(Sim::uart(static_cast<uint8_t>(uartNum))) {}
+
+  void begin(unsigned long baud, uint32_t = SERIAL_8N1, int8_t = -1,
+             int8_t = -1) {
+    port_.begin(baud);
+  }
+  void end() { port_.end(); }
+  size_t setRxBufferSize(size_t size) {
+    port_.setRxBufferSize(size);
+    return size;
+  }
+  int available() { return port_.available(); }
+  int read() { return port_.read(); }
+  int peek() { return port_.peek(); }
+  size_t write(uint8_t b) { return port_.write(b); }
+  size_t write(const uint8_t *data, size_t len) {
+    for (size_t i = 0; i < len; i++) port_.write(data[i]);
+    return len;
+  }
+  void flush() {}
+
+private:
+  Sim::Uart &port_;
+};
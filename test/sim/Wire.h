@@ -0,0 +1,62 @@
+#pragma once
+
+// ============================================================================
+// Wire.h - Host shim: TwoWire on top of Sim::i2c()
+// ============================================================================
+
+#include "Arduino.h"
+
+class TwoWire {
+public:
+  static constexpr uint8_t BUFFER_LENGTH = 128;
+
+  bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0) {
+    if (sda >= 0 && scl >= 0) Sim::i2c().setPins(sda, scl);
+    if (frequency) Sim::i2c().setClock(frequency);
+    return true;
+  }
+  bool end() { return true; }
+  bool setClock(uint32_t frequency) {
+    Sim::i2c().setClock(frequency);
+    return true;
+  }
+  void setTimeOut(uint16_t ms) { Sim::i2c().setTimeoutMs(ms); }
+  uint16_t getTimeOut() const { return Sim::i2c().timeoutMs(); }
+
+  void beginTransmission(uint8_t addr) {
+    txAddr_ = addr;
+    txLen_ = 0;
+  }
+  size_t write(uint8_t b) {
+    if (txLen_ >= BUFFER_LENGTH) return 0;
+    tx_[txLen_++] = b;
+    return 1;
+  }
+  size_t write(const uint8_t *data, size_t len) {
+    size_t n = 0;
+    while (n < len && write(data[n])) n++;
+    return n;
+  }
+  uint8_t endTransmission(bool = true) {
+    return Sim::i2c().write(txAddr_, tx_, txLen_);
+  }
+
+  uint8_t requestFrom(uint8_t addr, uint8_t len, bool = true) {
+    if (len > BUFFER_LENGTH) len = BUFFER_LENGTH;
+    rxLen_ = Sim::i2c().read(addr, rx_, len);
+    rxPos_ = 0;
+    return rxLen_;
+  }
+  int available() const { return rxLen_ - rxPos_; }
+  int read() { return rxPos_ < rxLen_ ? rx_[rxPos_++] : -1; }
+
+private:
+  uint8_t tx_[BUFFER_LENGTH] = {};
+  uint8_t rx_[BUFFER_LENGTH] = {};
+  uint8_t txAddr_ = 0;
+  uint8_t txLen_ = 0;
+  uint8_t rxLen_ = 0;
+  uint8_t rxPos_ = 0;
+};
+
+inline TwoWire Wire;
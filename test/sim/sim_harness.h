@@ -0,0 +1,667 @@
+#pragma once
+
+// ============================================================================
+// sim_harness.h - Deterministic virtual time and peripheral fakes
+// ============================================================================
+// Host-side world for the scenario tests (env:native_sim). Production
+// drivers compile unchanged against the Arduino shim in this folder:
+// - millis()/micros()/delay() read and advance Sim::clock()
+// - analogRead() is served by Sim::adc()
+// - attachInterrupt() edges come from Sim::gpio() square waves
+// - HardwareSerial ports are Sim::uart() byte streams paced by baud rate
+// - Wire talks to the devices attached to Sim::i2c(), which can inject
+//   NACKs, a stuck SDA line, clock stretching, corrupted reads and a
+//   multiplexer that ignores channel selects
+//
+// Nothing sleeps: time only moves when a test advances it (or the code
+// under test calls delay()), so an hour of driving runs in milliseconds and
+// every run is identical. Sim::Loop runs periodic jobs on the virtual
+// clock the way RTScheduler does on the car.
+// ============================================================================
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <vector>
+
+namespace Sim {
+
+void advanceUs(uint64_t us);
+inline void advanceMs(uint32_t ms) { advanceUs(uint64_t(ms) * 1000u); }
+
+// ============================================================================
+// Clock
+// ============================================================================
+
+class Clock {
+public:
+  uint64_t nowUs() const { return nowUs_; }
+  uint32_t micros() const { return static_cast<uint32_t>(nowUs_); }
+  uint32_t millis() const { return static_cast<uint32_t>(nowUs_ / 1000u); }
+
+private:
+  friend void advanceUs(uint64_t us);
+  uint64_t nowUs_ = 0;
+};
+
+inline Clock &clock() {
+  static Clock c;
+  return c;
+}
+
+// ============================================================================
+// ADC
+// ============================================================================
+
+// 12-bit readings per pin, with optional deterministic noise (a real
+// channel never returns the same code 50 times in a row; Pedal treats that
+// as a disconnected sensor)
+class Adc {
+public:
+  static constexpr uint8_t PIN_COUNT = 64;
+
+  void reset() { *this = Adc(); }
+  void set(uint8_t pin, uint16_t raw) { value_[pin] = raw; }
+  void setNoise(uint8_t pin, uint16_t amplitude) { noise_[pin] = amplitude; }
+
+  uint16_t read(uint8_t pin) {
+    reads_[pin]++;
+    int32_t v = value_[pin];
+    if (noise_[pin] > 0) {
+      seed_ = seed_ * 1664525u + 1013904223u;
+      v += int32_t((seed_ >> 8) % (2u * noise_[pin] + 1u)) - noise_[pin];
+    }
+    if (v < 0) v = 0;
+    if (v > 4095) v = 4095;
+    return static_cast<uint16_t>(v);
+  }
+
+  uint32_t reads(uint8_t pin) const { return reads_[pin]; }
+
+private:
+  uint16_t value_[PIN_COUNT] = {};
+  uint16_t noise_[PIN_COUNT] = {};
+  uint32_t reads_[PIN_COUNT] = {};
+  uint32_t seed_ = 1;
+};
+
+inline Adc &adc() {
+  static Adc a;
+  return a;
+}
+
+// ============================================================================
+// GPIO and interrupts
+// ============================================================================
+
+enum Edge : uint8_t {
+  EDGE_RISING = 0x01, // Same values as the Arduino-ESP32 modes
+  EDGE_FALLING = 0x02,
+  EDGE_CHANGE = 0x03,
+};
+
+class Gpio {
+public:
+  static constexpr uint8_t PIN_COUNT = 64;
+  using Isr = void (*)();
+
+  void reset() { *this = Gpio(); }
+
+  void setMode(uint8_t pin, uint8_t mode) { mode_[pin] = mode; }
+  uint8_t mode(uint8_t pin) const { return mode_[pin]; }
+
+  void attach(uint8_t pin, Isr isr, uint8_t edges) {
+    isr_[pin] = isr;
+    edges_[pin] = edges;
+  }
+  void detach(uint8_t pin) { isr_[pin] = nullptr; }
+  bool attached(uint8_t pin) const { return isr_[pin] != nullptr; }
+
+  // Open-drain line pulled low by a peripheral: reads LOW whatever the
+  // firmware drives (wired-AND), as a slave holding SDA mid-byte does
+  void holdLow(uint8_t pin, bool held) { heldLow_[pin] = held; }
+
+  // Drives the pin from outside; runs the ISR on a matching edge
+  void write(uint8_t pin, bool level) {
+    if (level == level_[pin]) return;
+    level_[pin] = level;
+    uint8_t edge = level ? EDGE_RISING : EDGE_FALLING;
+    if (isr_[pin] && (edges_[pin] & edge)) {
+      isrCalls_[pin]++;
+      isr_[pin]();
+    }
+  }
+  bool read(uint8_t pin) const { return level_[pin] && !heldLow_[pin]; }
+
+  // Square wave at `hz` (0 stops it); edges fire as the clock advances
+  void setFrequency(uint8_t pin, float hz) {
+    if (hz <= 0.0f) {
+      if (halfPeriodUs_[pin] == 0) return;
+      halfPeriodUs_[pin] = 0;
+      for (uint8_t i = 0; i < generatorCount_; i++) {
+        if (generators_[i] == pin) generators_[i] = generators_[--generatorCount_];
+      }
+      return;
+    }
+    uint64_t half = static_cast<uint64_t>(500000.0f / hz);
+    if (halfPeriodUs_[pin] == 0) generators_[generatorCount_++] = pin;
+    halfPeriodUs_[pin] = half > 0 ? half : 1;
+    nextToggleUs_[pin] = clock().nowUs() + halfPeriodUs_[pin];
+  }
+
+  void advanceTo(uint64_t nowUs) {
+    for (uint8_t i = 0; i < generatorCount_; i++) {
+      uint8_t pin = generators_[i];
+      while (halfPeriodUs_[pin] > 0 && nextToggleUs_[pin] <= nowUs) {
+        write(pin, !level_[pin]);
+        nextToggleUs_[pin] += halfPeriodUs_[pin];
+      }
+    }
+  }
+
+  uint32_t isrCalls(uint8_t pin) const { return isrCalls_[pin]; }
+
+private:
+  uint8_t mode_[PIN_COUNT] = {};
+  bool level_[PIN_COUNT] = {};
+  bool heldLow_[PIN_COUNT] = {};
+  Isr isr_[PIN_COUNT] = {};
+  uint8_t edges_[PIN_COUNT] = {};
+  uint64_t halfPeriodUs_[PIN_COUNT] = {};
+  uint64_t nextToggleUs_[PIN_COUNT] = {};
+  uint32_t isrCalls_[PIN_COUNT] = {};
+  uint8_t generators_[PIN_COUNT] = {}; // Pins with a running square wave
+  uint8_t generatorCount_ = 0;
+};
+
+inline Gpio &gpio() {
+  static Gpio g;
+  return g;
+}
+
+// ============================================================================
+// UART
+// ============================================================================
+
+// One port seen from the firmware. Bytes the peripheral sends go "on the
+// wire" and reach the RX buffer at the configured baud rate (10 bits per
+// byte). The buffer is the driver ring plus the 128-byte hardware FIFO; when
+// both are full the ESP32 driver drops bytes, and so does this.
+class Uart {
+public:
+  static constexpr size_t DEFAULT_RX_BUFFER = 256; // Arduino-ESP32 default
+  static constexpr size_t HW_FIFO = 128;
+
+  void reset() { *this = Uart(); }
+
+  // Firmware side (HardwareSerial shim)
+  void begin(uint32_t baud) {
+    baud_ = baud;
+    begun_ = true;
+    lastDeliveryUs_ = clock().nowUs();
+  }
+  void end() { begun_ = false; }
+  void setRxBufferSize(size_t size) { rxCapacity_ = size; }
+  int available() const { return static_cast<int>(rx_.size()); }
+  int read() {
+    if (rx_.empty()) return -1;
+    uint8_t b = rx_.front();
+    rx_.pop_front();
+    return b;
+  }
+  int peek() const { return rx_.empty() ? -1 : rx_.front(); }
+  size_t write(uint8_t b) {
+    tx_.push_back(b);
+    return 1;
+  }
+
+  // Peripheral side
+  void send(const uint8_t *data, size_t len) {
+    wire_.insert(wire_.end(), data, data + len);
+    if (baud_ == 0) deliver(wire_.size());
+  }
+  const std::vector<uint8_t> &transmitted() const { return tx_; }
+  void clearTransmitted() { tx_.clear(); }
+
+  bool begun() const { return begun_; }
+  uint32_t baud() const { return baud_; }
+  size_t inFlight() const { return wire_.size(); }
+  uint32_t overruns() const { return overruns_; }
+
+  void advanceTo(uint64_t nowUs) {
+    if (baud_ == 0 || wire_.empty()) {
+      lastDeliveryUs_ = nowUs;
+      return;
+    }
+    uint64_t bytes = (nowUs - lastDeliveryUs_) * baud_ / 10u / 1000000u;
+    if (bytes == 0) return;
+    deliver(static_cast<size_t>(bytes));
+    lastDeliveryUs_ = wire_.empty()
+                          ? nowUs
+                          : lastDeliveryUs_ + bytes * 10u * 1000000u / baud_;
+  }
+
+private:
+  void deliver(size_t count) {
+    while (count-- > 0 && !wire_.empty()) {
+      if (rx_.size() < rxCapacity_ + HW_FIFO) {
+        rx_.push_back(wire_.front());
+      } else {
+        overruns_++;
+      }
+      wire_.pop_front();
+    }
+  }
+
+  std::deque<uint8_t> wire_;
+  std::deque<uint8_t> rx_;
+  std::vector<uint8_t> tx_;
+  size_t rxCapacity_ = DEFAULT_RX_BUFFER;
+  uint32_t baud_ = 0;
+  bool begun_ = false;
+  uint64_t lastDeliveryUs_ = 0;
+  uint32_t overruns_ = 0;
+};
+
+constexpr uint8_t UART_COUNT = 3;
+
+inline Uart &uart(uint8_t num) {
+  static Uart ports[UART_COUNT];
+  return ports[num < UART_COUNT ? num : 0];
+}
+
+// ============================================================================
+// I2C
+// ============================================================================
+
+// A target on the bus. Return false / 0 to NACK.
+class I2cDevice {
+public:
+  virtual ~I2cDevice() = default;
+  // Master write: register pointer followed by any payload
+  virtual bool onWrite(const uint8_t *data, uint8_t len) = 0;
+  // Master read of up to len bytes; returns the bytes supplied
+  virtual uint8_t onRead(uint8_t *out, uint8_t len) = 0;
+  // Multiplexers: the target behind an enabled channel, if any
+  virtual I2cDevice *downstream(uint8_t) { return nullptr; }
+};
+
+// 8-bit pointer register selecting big-endian 16-bit registers: the INA226
+// register model
+class RegisterDevice16 : public I2cDevice {
+public:
+  void set(uint8_t reg, uint16_t value) { regs_[reg] = value; }
+  uint16_t get(uint8_t reg) const { return regs_[reg]; }
+  uint8_t pointer() const { return pointer_; }
+
+  bool onWrite(const uint8_t *data, uint8_t len) override {
+    if (len == 0) return true; // Address probe
+    pointer_ = data[0];
+    if (len >= 3) regs_[pointer_] = uint16_t(data[1] << 8 | data[2]);
+    return true;
+  }
+
+  uint8_t onRead(uint8_t *out, uint8_t len) override {
+    uint16_t v = regs_[pointer_];
+    uint8_t bytes[2] = {uint8_t(v >> 8), uint8_t(v & 0xFF)};
+    uint8_t n = len < 2 ? len : 2;
+    memcpy(out, bytes, n);
+    return n;
+  }
+
+private:
+  uint16_t regs_[256] = {};
+  uint8_t pointer_ = 0;
+};
+
+// TCA9548A: one control byte, bit n connects downstream channel n. Reading
+// returns the control byte. The six INA226 all sit at 0x40 behind it.
+class Tca9548a : public I2cDevice {
+public:
+  static constexpr uint8_t CHANNELS = 8;
+
+  void attach(uint8_t channel, uint8_t addr, I2cDevice *dev) {
+    devices_[channel][addr & 0x7F] = dev;
+  }
+  uint8_t control() const { return control_; }
+
+  bool onWrite(const uint8_t *data, uint8_t len) override {
+    if (len > 0) control_ = data[len - 1];
+    return true;
+  }
+  uint8_t onRead(uint8_t *out, uint8_t len) override {
+    if (len == 0) return 0;
+    out[0] = control_;
+    return 1;
+  }
+  // Lowest enabled channel wins when several answer at the same address
+  I2cDevice *downstream(uint8_t addr) override {
+    for (uint8_t ch = 0; ch < CHANNELS; ch++) {
+      if ((control_ & (1u << ch)) && devices_[ch][addr & 0x7F]) {
+        return devices_[ch][addr & 0x7F];
+      }
+    }
+    return nullptr;
+  }
+
+private:
+  I2cDevice *devices_[CHANNELS][128] = {};
+  uint8_t control_ = 0;
+};
+
+// Faults the bus can inject, one at a time
+enum class I2cFault : uint8_t {
+  NONE,
+  NACK,          // Target does not acknowledge its address
+  STUCK_SDA,     // A slave holds SDA low; released after N SCL pulses
+  CLOCK_STRETCH, // Target holds SCL low for stretchUs per transaction
+  CORRUPT_READ,  // Read data bits flipped, every other read truncated
+  DROP_WRITE,    // Write ACKed but never latched (mux failing to switch)
+};
+
+struct I2cFaultPlan {
+  I2cFault type = I2cFault::NONE;
+  uint8_t addr = 0xFF;        // Target address, 0xFF = any (STUCK_SDA: bus)
+  uint32_t durationMs = 0;    // 0 = until cleared (STUCK_SDA: by pulses)
+  uint32_t stretchUs = 0;     // CLOCK_STRETCH
+  uint8_t releasePulses = 9;  // STUCK_SDA: SCL pulses to release, 0 = never
+};
+
+class I2cBus;
+inline I2cBus &i2c();
+
+// Wire-level bus: 7-bit addresses, transfers cost virtual time at the bus
+// clock (9 bits per byte plus the address byte). A transaction the driver
+// cannot finish (SDA held low, clock stretched past the limit) costs the
+// whole driver timeout, as i2cWrite()/i2cRead() do on the ESP32.
+class I2cBus {
+public:
+  // Same codes as TwoWire::endTransmission()
+  enum Result : uint8_t {
+    OK = 0,
+    NACK_ADDRESS = 2,
+    NACK_DATA = 3,
+    TIMEOUT = 5,
+  };
+
+  void reset() { *this = I2cBus(); }
+
+  void attach(uint8_t addr, I2cDevice *dev) { devices_[addr & 0x7F] = dev; }
+  void detach(uint8_t addr) { devices_[addr & 0x7F] = nullptr; }
+  void setClock(uint32_t hz) { clockHz_ = hz > 0 ? hz : 100000; }
+  void setTimeoutMs(uint16_t ms) { timeoutMs_ = ms; }
+  uint16_t timeoutMs() const { return timeoutMs_; }
+
+  // Wire.begin(sda, scl): idle lines float HIGH on the pull-ups, and SCL
+  // pulses are counted to release a stuck slave
+  void setPins(uint8_t sda, uint8_t scl) {
+    sda_ = sda;
+    scl_ = scl;
+    gpio().write(sda, true);
+    gpio().write(scl, true);
+    gpio().attach(scl, &I2cBus::onSclRising, EDGE_RISING);
+    if (fault_.type == I2cFault::STUCK_SDA) holdSda(true);
+  }
+
+  void inject(const I2cFaultPlan &plan) {
+    clearFault();
+    fault_ = plan;
+    faultEndUs_ = plan.durationMs > 0
+                      ? clock().nowUs() + uint64_t(plan.durationMs) * 1000u
+                      : UINT64_MAX;
+    pulses_ = 0;
+    if (plan.type == I2cFault::STUCK_SDA) holdSda(true);
+  }
+  void clearFault() {
+    if (fault_.type == I2cFault::STUCK_SDA) holdSda(false);
+    fault_ = I2cFaultPlan();
+  }
+  bool faultActive() {
+    if (fault_.type != I2cFault::NONE && clock().nowUs() >= faultEndUs_) {
+      clearFault();
+    }
+    return fault_.type != I2cFault::NONE;
+  }
+
+  uint8_t write(uint8_t addr, const uint8_t *data, uint8_t len) {
+    transactions_++;
+    uint8_t failed;
+    if (blocked(addr, &failed)) return failed;
+    spend(1u + len);
+    I2cDevice *dev = route(addr);
+    if (!dev || hits(I2cFault::NACK, addr)) return NACK_ADDRESS;
+    if (hits(I2cFault::DROP_WRITE, addr)) return OK;
+    return dev->onWrite(data, len) ? OK : NACK_DATA;
+  }
+
+  uint8_t read(uint8_t addr, uint8_t *out, uint8_t len) {
+    transactions_++;
+    uint8_t failed;
+    if (blocked(addr, &failed)) return 0;
+    I2cDevice *dev = route(addr);
+    if (!dev || hits(I2cFault::NACK, addr)) {
+      spend(1);
+      return 0;
+    }
+    uint8_t n = dev->onRead(out, len);
+    if (hits(I2cFault::CORRUPT_READ, addr)) {
+      for (uint8_t i = 0; i < n; i++) out[i] ^= 0xA5;
+      if ((corruptReads_++ & 1u) && n > 0) n--;
+    }
+    spend(1u + n);
+    return n;
+  }
+
+  uint32_t transactions() const { return transactions_; }
+  uint32_t timeouts() const { return timeouts_; }
+  uint32_t sclPulses() const { return pulses_; }
+
+private:
+  static void onSclRising() { i2c().sclPulse(); }
+
+  void sclPulse() {
+    pulses_++;
+    if (fault_.type == I2cFault::STUCK_SDA && fault_.releasePulses > 0 &&
+        pulses_ >= fault_.releasePulses) {
+      clearFault();
+    }
+  }
+
+  void holdSda(bool held) {
+    if (sda_ != NO_PIN) gpio().holdLow(sda_, held);
+  }
+
+  I2cDevice *route(uint8_t addr) {
+    if (devices_[addr & 0x7F]) return devices_[addr & 0x7F];
+    for (I2cDevice *dev : devices_) {
+      I2cDevice *behind = dev ? dev->downstream(addr) : nullptr;
+      if (behind) return behind;
+    }
+    return nullptr;
+  }
+
+  bool hits(I2cFault type, uint8_t addr) {
+    return faultActive() && fault_.type == type &&
+           (fault_.addr == 0xFF || fault_.addr == (addr & 0x7F));
+  }
+
+  // SDA held low or SCL stretched past the driver timeout: the transaction
+  // never completes and the caller waits out the timeout
+  bool blocked(uint8_t addr, uint8_t *result) {
+    bool stalled = (faultActive() && fault_.type == I2cFault::STUCK_SDA) ||
+                   (sda_ != NO_PIN && !gpio().read(sda_));
+    if (!stalled && hits(I2cFault::CLOCK_STRETCH, addr)) {
+      if (fault_.stretchUs <= uint32_t(timeoutMs_) * 1000u) {
+        advanceUs(fault_.stretchUs);
+        return false;
+      }
+      stalled = true;
+    }
+    if (!stalled) return false;
+    timeouts_++;
+    advanceUs(uint64_t(timeoutMs_) * 1000u);
+    *result = TIMEOUT;
+    return true;
+  }
+
+  void spend(uint32_t bytes) {
+    advanceUs(uint64_t(bytes) * 9u * 1000000u / clockHz_);
+  }
+
+  static constexpr uint8_t NO_PIN = 0xFF;
+
+  I2cDevice *devices_[128] = {};
+  uint32_t clockHz_ = 400000;
+  uint16_t timeoutMs_ = 50; // Arduino-ESP32 default
+  uint8_t sda_ = NO_PIN;
+  uint8_t scl_ = NO_PIN;
+  I2cFaultPlan fault_;
+  uint64_t faultEndUs_ = UINT64_MAX;
+  uint32_t pulses_ = 0;
+  uint32_t corruptReads_ = 0;
+  uint32_t transactions_ = 0;
+  uint32_t timeouts_ = 0;
+};
+
+inline I2cBus &i2c() {
+  static I2cBus bus;
+  return bus;
+}
+
+// ============================================================================
+// Time
+// ============================================================================
+
+// Moves virtual time forward and lets the peripherals catch up
+inline void advanceUs(uint64_t us) {
+  Clock &c = clock();
+  c.nowUs_ += us;
+  gpio().advanceTo(c.nowUs_);
+  for (uint8_t i = 0; i < UART_COUNT; i++) uart(i).advanceTo(c.nowUs_);
+}
+
+// Peripherals back to power-on state. The clock keeps running, like the
+// real millis(): module state from a previous scenario may hold timestamps.
+inline void resetPeripherals() {
+  adc().reset();
+  gpio().reset();
+  for (uint8_t i = 0; i < UART_COUNT; i++) uart(i).reset();
+  i2c().reset();
+}
+
+// ============================================================================
+// Periodic jobs
+// ============================================================================
+
+// Jobs run on a 1 ms virtual tick at their period and phase, in the order
+// they were added (the order RTScheduler's job table gives them on a core)
+class Loop {
+public:
+  using Job = std::function<void()>;
+
+  void add(const char *name, uint32_t periodMs, Job job,
+           uint32_t phaseMs = 0) {
+    jobs_.push_back({name, periodMs, phaseMs, std::move(job), 0});
+  }
+
+  void runFor(uint32_t ms) {
+    for (uint32_t i = 0; i < ms; i++) step();
+  }
+
+  // Runs until done() holds (checked each tick) or maxMs elapse
+  bool runUntil(const std::function<bool()> &done, uint32_t maxMs) {
+    for (uint32_t i = 0; i < maxMs; i++) {
+      step();
+      if (done()) return true;
+    }
+    return false;
+  }
+
+  uint32_t elapsedMs() const { return tick_; }
+  uint32_t runs(size_t job) const { return jobs_[job].runs; }
+
+private:
+  struct Entry {
+    const char *name;
+    uint32_t periodMs;
+    uint32_t phaseMs;
+    Job job;
+    uint32_t runs;
+  };
+
+  void step() {
+    for (Entry &e : jobs_) {
+      if (tick_ >= e.phaseMs && (tick_ - e.phaseMs) % e.periodMs == 0) {
+        e.job();
+        e.runs++;
+      }
+    }
+    tick_++;
+    advanceMs(1);
+  }
+
+  std::vector<Entry> jobs_;
+  uint32_t tick_ = 0;
+};
+
+// ============================================================================
+// Per-test timing report
+// ============================================================================
+
+class Report {
+public:
+  // Call from setUp()/tearDown(): tearDown also runs after a failed assert
+  void begin(const char *name) {
+    name_ = name;
+    simStartUs_ = clock().nowUs();
+    wallStart_ = std::chrono::steady_clock::now();
+  }
+
+  void end() {
+    auto wall = std::chrono::steady_clock::now() - wallStart_;
+    uint64_t wallUs =
+        std::chrono::duration_cast<std::chrono::microseconds>(wall).count();
+    rows_.push_back({name_, clock().nowUs() - simStartUs_, wallUs});
+  }
+
+  void print(FILE *out = stdout) const {
+    uint64_t simTotal = 0, wallTotal = 0;
+    fprintf(out, "\n%-44s %10s %10s %10s\n", "scenario", "sim s", "wall ms",
+            "x realtime");
+    for (const Row &r : rows_) {
+      printRow(out, r.name, r.simUs, r.wallUs);
+      simTotal += r.simUs;
+      wallTotal += r.wallUs;
+    }
+    printRow(out, "TOTAL", simTotal, wallTotal);
+  }
+
+private:
+  struct Row {
+    const char *name;
+    uint64_t simUs;
+    uint64_t wallUs;
+  };
+
+  static void printRow(FILE *out, const char *name, uint64_t simUs,
+                       uint64_t wallUs) {
+    double speedup = wallUs > 0 ? double(simUs) / double(wallUs) : 0.0;
+    fprintf(out, "%-44s %10.1f %10.2f %10.0f\n", name, simUs / 1e6,
+            wallUs / 1e3, speedup);
+  }
+
+  std::vector<Row> rows_;
+  const char *name_ = "";
+  uint64_t simStartUs_ = 0;
+  std::chrono::steady_clock::time_point wallStart_;
+};
+
+inline Report &report() {
+  static Report r;
+  return r;
+}
+
+} // namespace Sim
@@ -0,0 +1,230 @@
+// ============================================================================
+// test_main.cpp - Predictive ACC core against the legacy PID law
+// Run: pio test -e native -f test_acc_predictive
+//
+// The on-car AccScenarioTests suite, on the host: a lead that holds its
+// speed, brakes to a stop, or goes stop-and-go, followed at 100 Hz with a
+// ~15 Hz noisy TOFSense gap and a first-order motor. The predictive law
+// must reverse the speed factor less often than the PID law, never get
+// closer, and fit AccPredictive::COMPUTE_BUDGET_US per control cycle.
+// ============================================================================
+
+#include "acc_predictive.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <unity.h>
+
+// Same parameters as src/test/acc_scenario_tests.cpp (AdaptiveCruise
+// person-following defaults)
+static const float SIM_DT_S = AccPredictive::CONTROL_DT_S; // 100 Hz
+static const uint32_t SIM_STEPS = 3000;                    // 30 s
+static const uint32_t SENSOR_PERIOD_MS = 66;               // ~15 Hz
+static const float TARGET_GAP_MM = 500.0f;
+static const float EMERGENCY_GAP_MM = 300.0f;
+static const float MIN_FACTOR = 0.5f; // maxSpeedReduction = 50 %
+static const float REFERENCE_SPEED_MM_S = 2000.0f;
+static const float SETTLE_TIME_S = 5.0f;
+static const float REVERSAL_DEADBAND = 0.002f; // factor change per cycle
+
+enum class LeadProfile : uint8_t { STEADY, BRAKING, STOP_AND_GO };
+
+struct ScenarioResult {
+  uint32_t reversals;   // Speed factor direction changes
+  float gapRmsMm;       // RMS gap error after settling
+  float minGapMm;       // Closest approach
+  float maxJerk;        // Peak |d2 factor / dt2| outside brake events
+  uint32_t computeNsMax; // Worst predictive cycle
+  uint64_t computeNsSum; // Sum over all predictive cycles
+  uint32_t cycles;       // Predictive cycles run
+  uint32_t overruns;     // Cycles above COMPUTE_BUDGET_US
+};
+
+void setUp() {}
+void tearDown() {}
+
+static float leadSpeedMmS(LeadProfile profile, float tS) {
+  switch (profile) {
+  case LeadProfile::BRAKING:
+    if (tS < 5.0f) return 1000.0f;
+    return std::max(0.0f, 1000.0f - 800.0f * (tS - 5.0f));
+  case LeadProfile::STOP_AND_GO:
+    return 800.0f + 300.0f * sinf(tS * 0.8f);
+  case LeadProfile::STEADY:
+  default:
+    return 1000.0f;
+  }
+}
+
+// Deterministic +/-15 mm sensor noise (LCG, identical on every run)
+static float sensorNoise(uint32_t &seed) {
+  seed = seed * 1664525UL + 1013904223UL;
+  return (float)((seed >> 8) % 31) - 15.0f;
+}
+
+static ScenarioResult simulate(LeadProfile profile, bool predictive) {
+  using Clock = std::chrono::steady_clock;
+  ScenarioResult r = {0, 0.0f, 1e9f, 0.0f, 0, 0, 0, 0};
+
+  float gapMm = 1500.0f;
+  float egoMmS = 1000.0f;
+  float factor = MIN_FACTOR;
+  float measuredMm = gapMm;
+  uint32_t sampleMs = 0;
+  uint32_t seed = 1;
+
+  // Legacy PID state (mirrors AdaptiveCruise ACC_MODE_PID)
+  float pidIntegral = 0.0f;
+  float pidLastError = 0.0f;
+
+  AccPredictive::EstimatorState est;
+  AccPredictive::ControllerState ctl;
+  AccPredictive::resetController(ctl, factor);
+  AccPredictive::Limits lim;
+  lim.minFactor = MIN_FACTOR;
+  lim.referenceSpeedMmS = REFERENCE_SPEED_MM_S;
+
+  float lastFactor = factor;
+  float lastRate = 0.0f;
+  bool lastBraked = false;
+  int8_t lastDir = 0;
+  double errSq = 0.0;
+  uint32_t errCount = 0;
+
+  for (uint32_t k = 0; k < SIM_STEPS; k++) {
+    float tS = k * SIM_DT_S;
+    uint32_t nowMs = k * 10;
+
+    // TOFSense frame (quantized to 1 mm)
+    if (k > 0 && (nowMs % SENSOR_PERIOD_MS) < 10) {
+      measuredMm = (float)(int32_t)(gapMm + sensorNoise(seed));
+      sampleMs = nowMs;
+    }
+
+    bool emergency = measuredMm < EMERGENCY_GAP_MM;
+    if (emergency) {
+      factor = 0.0f;
+      pidIntegral = 0.0f;
+      pidLastError = 0.0f;
+      AccPredictive::resetEstimator(est);
+      AccPredictive::engageBrake(ctl, MIN_FACTOR);
+    } else if (predictive) {
+      auto t0 = Clock::now();
+      AccPredictive::fuseSample(est, measuredMm, sampleMs);
+      float predGap, predVel;
+      AccPredictive::predict(est, nowMs, predGap, predVel);
+      factor = AccPredictive::step(ctl, predGap, predVel, est.relAccelMmS2,
+                                   TARGET_GAP_MM, EMERGENCY_GAP_MM, lim,
+                                   SIM_DT_S);
+      uint32_t ns = uint32_t(std::chrono::duration_cast<
+                                 std::chrono::nanoseconds>(Clock::now() - t0)
+                                 .count());
+      r.computeNsSum += ns;
+      r.computeNsMax = std::max(r.computeNsMax, ns);
+      r.cycles++;
+      if (ns > AccPredictive::COMPUTE_BUDGET_US * 1000) r.overruns++;
+    } else if (k % 10 == 0) {
+      float error = measuredMm - TARGET_GAP_MM;
+      pidIntegral = std::min(500.0f, std::max(-500.0f, pidIntegral +
+                                                           error * 0.1f));
+      float derivative = (error - pidLastError) / 0.1f;
+      pidLastError = error;
+      float out = 0.3f * error + 0.05f * pidIntegral + 0.15f * derivative;
+      factor = std::min(1.0f, std::max(MIN_FACTOR, 1.0f + out / 1000.0f));
+    }
+
+    // Plant: first-order motor response, lead moves independently
+    float commandMmS = factor * REFERENCE_SPEED_MM_S;
+    egoMmS += (commandMmS - egoMmS) * (SIM_DT_S / AccPredictive::MOTOR_LAG_S);
+    gapMm += (leadSpeedMmS(profile, tS) - egoMmS) * SIM_DT_S;
+
+    // Metrics
+    if (gapMm < r.minGapMm) r.minGapMm = gapMm;
+    float delta = factor - lastFactor;
+    int8_t dir = 0;
+    if (delta > REVERSAL_DEADBAND) dir = 1;
+    if (delta < -REVERSAL_DEADBAND) dir = -1;
+    if (dir != 0 && lastDir != 0 && dir != lastDir) r.reversals++;
+    if (dir != 0) lastDir = dir;
+    float rate = delta / SIM_DT_S;
+    float jerk = fabsf(rate - lastRate) / SIM_DT_S;
+    bool braked = factor == 0.0f || lastFactor == 0.0f;
+    if (!braked && !lastBraked && k > 0 && jerk > r.maxJerk) r.maxJerk = jerk;
+    lastBraked = braked;
+    lastRate = rate;
+    lastFactor = factor;
+    if (tS >= SETTLE_TIME_S) {
+      float e = gapMm - TARGET_GAP_MM;
+      errSq += (double)e * e;
+      errCount++;
+    }
+  }
+
+  r.gapRmsMm = errCount > 0 ? (float)sqrt(errSq / errCount) : 0.0f;
+  return r;
+}
+
+static void printResult(const char *name, const ScenarioResult &pid,
+                        const ScenarioResult &mpc) {
+  printf("  %-8s PID: reversals %4u rms %4.0f mm min %4.0f mm jerk %5.0f\n",
+         name, (unsigned)pid.reversals, pid.gapRmsMm, pid.minGapMm,
+         pid.maxJerk);
+  printf("  %-8s MPC: reversals %4u rms %4.0f mm min %4.0f mm jerk %5.0f\n",
+         name, (unsigned)mpc.reversals, mpc.gapRmsMm, mpc.minGapMm,
+         mpc.maxJerk);
+}
+
+void test_steady_following_oscillates_less() {
+  ScenarioResult pid = simulate(LeadProfile::STEADY, false);
+  ScenarioResult mpc = simulate(LeadProfile::STEADY, true);
+  printf("\n");
+  printResult("steady", pid, mpc);
+
+  TEST_ASSERT_TRUE(mpc.reversals < pid.reversals);
+  TEST_ASSERT_TRUE(mpc.gapRmsMm < pid.gapRmsMm);
+  TEST_ASSERT_TRUE(mpc.maxJerk < pid.maxJerk);
+}
+
+void test_lead_braking_keeps_a_larger_gap() {
+  ScenarioResult pid = simulate(LeadProfile::BRAKING, false);
+  ScenarioResult mpc = simulate(LeadProfile::BRAKING, true);
+  printResult("braking", pid, mpc);
+
+  TEST_ASSERT_TRUE(mpc.reversals < pid.reversals);
+  TEST_ASSERT_TRUE(mpc.minGapMm >= pid.minGapMm);
+}
+
+void test_stop_and_go_follows_smoother() {
+  ScenarioResult pid = simulate(LeadProfile::STOP_AND_GO, false);
+  ScenarioResult mpc = simulate(LeadProfile::STOP_AND_GO, true);
+  printResult("stop-go", pid, mpc);
+
+  TEST_ASSERT_TRUE(mpc.reversals < pid.reversals);
+  TEST_ASSERT_TRUE(mpc.minGapMm >= pid.minGapMm);
+}
+
+void test_predictive_cycle_within_budget() {
+  ScenarioResult mpc = simulate(LeadProfile::STOP_AND_GO, true);
+  double avgNs = (double)mpc.computeNsSum / mpc.cycles;
+  printf("  predictive cycle: avg %.0f ns, max %u ns, budget %u us, "
+         "overruns %u/%u\n",
+         avgNs, (unsigned)mpc.computeNsMax,
+         (unsigned)AccPredictive::COMPUTE_BUDGET_US, (unsigned)mpc.overruns,
+         (unsigned)mpc.cycles);
+
+  // Same rule as on the car: isolated preemption spikes are allowed, never
+  // a systematic overrun
+  TEST_ASSERT_TRUE(mpc.cycles > SIM_STEPS / 2);
+  TEST_ASSERT_TRUE(avgNs < AccPredictive::COMPUTE_BUDGET_US * 1000.0);
+  TEST_ASSERT_TRUE(mpc.overruns <= SIM_STEPS / 1000);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_steady_following_oscillates_less);
+  RUN_TEST(test_lead_braking_keeps_a_larger_gap);
+  RUN_TEST(test_stop_and_go_follows_smoother);
+  RUN_TEST(test_predictive_cycle_within_budget);
+  return UNITY_END();
+}
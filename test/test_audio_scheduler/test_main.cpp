@@ -0,0 +1,209 @@
+// ============================================================================
+// test_main.cpp - Audio::Scheduler ordering, preemption and metrics
+// Run: pio test -e native -f test_audio_scheduler
+//
+// The scheduler runs on a virtual millisecond clock; "the player" is the
+// test calling onFinished() when a track would have ended.
+// ============================================================================
+
+#include "audio_scheduler.h"
+#include <unity.h>
+
+using namespace Audio;
+
+static Scheduler sched;
+
+static bool dispatchAt(uint32_t now, Dispatch &d) {
+  return sched.poll(now, d);
+}
+
+void test_plays_highest_priority_first() {
+  sched.push(10, PRIO_LOW, 0);
+  sched.push(11, PRIO_NORMAL, 0);
+  sched.push(12, PRIO_HIGH, 0);
+  sched.push(13, PRIO_NORMAL, 0);
+
+  const uint16_t expected[] = {12, 11, 13, 10};
+  uint32_t now = 0;
+  for (uint16_t track : expected) {
+    Dispatch d;
+    TEST_ASSERT_TRUE(dispatchAt(now, d));
+    TEST_ASSERT_EQUAL_UINT16(track, d.track);
+    TEST_ASSERT_FALSE(d.preempt);
+    sched.onFinished(track);
+    now += COMMAND_GAP_MS;
+  }
+  TEST_ASSERT_EQUAL_UINT8(0, sched.pendingCount());
+}
+
+void test_waits_for_player_to_finish() {
+  Dispatch d;
+  sched.push(1, PRIO_NORMAL, 0);
+  sched.push(2, PRIO_HIGH, 0);
+  TEST_ASSERT_TRUE(dispatchAt(0, d));
+  TEST_ASSERT_EQUAL_UINT16(2, d.track);
+
+  // HIGH does not cut HIGH/NORMAL: nothing until the finished report
+  TEST_ASSERT_FALSE(dispatchAt(1000, d));
+  sched.onFinished(99); // Stale report for another track: ignored
+  TEST_ASSERT_FALSE(dispatchAt(1100, d));
+  sched.onFinished(2);
+  TEST_ASSERT_TRUE(dispatchAt(1200, d));
+  TEST_ASSERT_EQUAL_UINT16(1, d.track);
+  TEST_ASSERT_EQUAL_UINT32(1200, d.latencyMs);
+}
+
+void test_critical_preempts_lower_playback() {
+  Dispatch d;
+  sched.push(20, PRIO_NORMAL, 0);
+  TEST_ASSERT_TRUE(dispatchAt(0, d));
+
+  sched.push(54, PRIO_CRITICAL, 500);
+  TEST_ASSERT_TRUE(dispatchAt(510, d));
+  TEST_ASSERT_EQUAL_UINT16(54, d.track);
+  TEST_ASSERT_TRUE(d.preempt);
+  TEST_ASSERT_EQUAL_UINT32(10, d.latencyMs);
+  TEST_ASSERT_EQUAL_UINT32(1, sched.stats(PRIO_NORMAL).preempted);
+
+  // Critical does not cut critical
+  sched.push(31, PRIO_CRITICAL, 600);
+  TEST_ASSERT_FALSE(dispatchAt(700, d));
+  sched.onFinished(54);
+  TEST_ASSERT_TRUE(dispatchAt(800, d));
+  TEST_ASSERT_EQUAL_UINT16(31, d.track);
+  TEST_ASSERT_FALSE(d.preempt);
+}
+
+void test_command_gap_between_plays() {
+  Dispatch d;
+  sched.push(20, PRIO_NORMAL, 0);
+  TEST_ASSERT_TRUE(dispatchAt(0, d));
+  sched.push(54, PRIO_CRITICAL, 10);
+  TEST_ASSERT_FALSE(dispatchAt(COMMAND_GAP_MS - 1, d));
+  TEST_ASSERT_TRUE(dispatchAt(COMMAND_GAP_MS, d));
+}
+
+void test_duplicates_coalesce_and_raise_priority() {
+  TEST_ASSERT_EQUAL(PushResult::QUEUED, sched.push(5, PRIO_LOW, 0));
+  TEST_ASSERT_EQUAL(PushResult::QUEUED, sched.push(6, PRIO_NORMAL, 10));
+  TEST_ASSERT_EQUAL(PushResult::COALESCED, sched.push(5, PRIO_HIGH, 20));
+  TEST_ASSERT_EQUAL_UINT8(2, sched.pendingCount());
+
+  Dispatch d;
+  TEST_ASSERT_TRUE(dispatchAt(30, d));
+  TEST_ASSERT_EQUAL_UINT16(5, d.track); // Raised to HIGH
+  TEST_ASSERT_EQUAL_UINT32(30, d.latencyMs); // From the first push
+
+  // Pushing the track that is playing right now adds nothing
+  TEST_ASSERT_EQUAL(PushResult::COALESCED, sched.push(5, PRIO_NORMAL, 40));
+  TEST_ASSERT_EQUAL_UINT8(1, sched.pendingCount());
+}
+
+void test_repeats_are_rate_limited_except_critical() {
+  Dispatch d;
+  sched.push(36, PRIO_NORMAL, 0);
+  dispatchAt(0, d);
+  sched.onFinished(36);
+
+  TEST_ASSERT_EQUAL(PushResult::RATE_LIMITED,
+                    sched.push(36, PRIO_HIGH, REPEAT_MIN_MS - 1));
+  TEST_ASSERT_EQUAL(PushResult::QUEUED, sched.push(36, PRIO_NORMAL,
+                                                   REPEAT_MIN_MS));
+  TEST_ASSERT_EQUAL_UINT32(1, sched.stats(PRIO_HIGH).rateLimited);
+
+  sched.reset();
+  sched.push(31, PRIO_CRITICAL, 0);
+  dispatchAt(0, d);
+  sched.onFinished(31);
+  TEST_ASSERT_EQUAL(PushResult::QUEUED, sched.push(31, PRIO_CRITICAL, 100));
+}
+
+void test_full_queue_evicts_lower_priority() {
+  for (uint16_t t = 1; t <= SCHED_CAPACITY; t++) {
+    TEST_ASSERT_EQUAL(PushResult::QUEUED,
+                      sched.push(t, t == 3 ? PRIO_LOW : PRIO_NORMAL, t));
+  }
+  // Evicts LOW track 3
+  TEST_ASSERT_EQUAL(PushResult::REPLACED, sched.push(20, PRIO_NORMAL, 20));
+  // Only equal or lower priority left: rejected, like the old FIFO
+  TEST_ASSERT_EQUAL(PushResult::DROPPED, sched.push(21, PRIO_NORMAL, 21));
+  TEST_ASSERT_EQUAL(PushResult::DROPPED, sched.push(22, PRIO_LOW, 22));
+
+  // A critical track always gets in (oldest NORMAL goes)
+  TEST_ASSERT_EQUAL(PushResult::REPLACED, sched.push(54, PRIO_CRITICAL, 30));
+  TEST_ASSERT_EQUAL_UINT32(1, sched.stats(PRIO_LOW).evicted);
+  TEST_ASSERT_EQUAL_UINT32(1, sched.stats(PRIO_NORMAL).evicted);
+  TEST_ASSERT_EQUAL_UINT32(1, sched.stats(PRIO_NORMAL).dropped);
+  TEST_ASSERT_EQUAL_UINT32(1, sched.stats(PRIO_LOW).dropped);
+
+  Dispatch d;
+  TEST_ASSERT_TRUE(dispatchAt(40, d));
+  TEST_ASSERT_EQUAL_UINT16(54, d.track);
+  bool oldestGone = true;
+  for (uint8_t i = 0; i < sched.pendingCount(); i++) {
+    if (sched.pending(i).track == 1) oldestGone = false;
+  }
+  TEST_ASSERT_TRUE(oldestGone);
+}
+
+void test_timeout_frees_silent_player() {
+  Dispatch d;
+  sched.push(1, PRIO_NORMAL, 0);
+  sched.push(2, PRIO_NORMAL, 0);
+  dispatchAt(0, d);
+  TEST_ASSERT_FALSE(dispatchAt(MAX_PLAY_MS - 1, d));
+  TEST_ASSERT_TRUE(dispatchAt(MAX_PLAY_MS, d));
+  TEST_ASSERT_EQUAL_UINT16(2, d.track);
+  TEST_ASSERT_EQUAL_UINT32(1, sched.timeouts());
+}
+
+void test_invalid_tracks_rejected() {
+  TEST_ASSERT_EQUAL(PushResult::INVALID, sched.push(0, PRIO_NORMAL, 0));
+  TEST_ASSERT_EQUAL(PushResult::INVALID, sched.push(69, PRIO_NORMAL, 0));
+  TEST_ASSERT_EQUAL_UINT8(0, sched.pendingCount());
+}
+
+void test_latency_metrics_per_priority() {
+  Dispatch d;
+  sched.push(1, PRIO_NORMAL, 0);
+  sched.push(2, PRIO_NORMAL, 0);
+  dispatchAt(100, d);
+  sched.onFinished(d.track);
+  dispatchAt(400, d);
+
+  const PriorityStats &s = sched.stats(PRIO_NORMAL);
+  TEST_ASSERT_EQUAL_UINT32(2, s.pushed);
+  TEST_ASSERT_EQUAL_UINT32(2, s.played);
+  TEST_ASSERT_EQUAL_UINT32(500, s.latencySumMs);
+  TEST_ASSERT_EQUAL_UINT32(400, s.latencyMaxMs);
+  TEST_ASSERT_EQUAL_UINT32(0, sched.stats(PRIO_CRITICAL).played);
+}
+
+void test_pop_takes_highest_without_playing() {
+  sched.push(1, PRIO_LOW, 0);
+  sched.push(2, PRIO_HIGH, 0);
+  Pending p;
+  TEST_ASSERT_TRUE(sched.pop(p));
+  TEST_ASSERT_EQUAL_UINT16(2, p.track);
+  TEST_ASSERT_FALSE(sched.isPlaying());
+  TEST_ASSERT_EQUAL_UINT8(1, sched.pendingCount());
+}
+
+void setUp() { sched.reset(); }
+void tearDown() {}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_plays_highest_priority_first);
+  RUN_TEST(test_waits_for_player_to_finish);
+  RUN_TEST(test_critical_preempts_lower_playback);
+  RUN_TEST(test_command_gap_between_plays);
+  RUN_TEST(test_duplicates_coalesce_and_raise_priority);
+  RUN_TEST(test_repeats_are_rate_limited_except_critical);
+  RUN_TEST(test_full_queue_evicts_lower_priority);
+  RUN_TEST(test_timeout_frees_silent_player);
+  RUN_TEST(test_invalid_tracks_rejected);
+  RUN_TEST(test_latency_metrics_per_priority);
+  RUN_TEST(test_pop_takes_highest_without_playing);
+  return UNITY_END();
+}
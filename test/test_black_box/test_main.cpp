@@ -0,0 +1,336 @@
+// ============================================================================
+// test_main.cpp - BlackBox pre/post-trigger window on simulated flash
+// Run: pio test -e native -f test_black_box
+//
+// The control job is modelled by record() at 100 Hz (tickMs += 10) and the
+// journal job by service() once every 100 ticks. SimFlash has NOR
+// semantics and can cut power mid-dump; remounting on the same contents
+// stands for a reboot.
+// ============================================================================
+
+#include "black_box.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <unity.h>
+#include <vector>
+
+using namespace BlackBox;
+
+class SimFlash : public FlashJournal::FlashDevice {
+public:
+  explicit SimFlash(uint32_t sectors)
+      : mem(sectors * FlashJournal::SECTOR_SIZE, 0x00), sectors_(sectors) {}
+
+  uint32_t sectorCount() const override { return sectors_; }
+
+  bool read(uint32_t addr, void *dst, uint32_t len) override {
+    if (addr + len > mem.size()) return false;
+    memcpy(dst, &mem[addr], len);
+    return true;
+  }
+
+  bool write(uint32_t addr, const void *src, uint32_t len) override {
+    if (dead || addr + len > mem.size()) return false;
+    const uint8_t *p = static_cast<const uint8_t *>(src);
+    for (uint32_t i = 0; i < len; i++) {
+      if (!spend()) return false;
+      mem[addr + i] &= p[i];
+    }
+    return true;
+  }
+
+  bool eraseSector(uint32_t sector) override {
+    if (dead || sector >= sectors_) return false;
+    if (!spend()) return false;
+    memset(&mem[sector * FlashJournal::SECTOR_SIZE], 0xFF,
+           FlashJournal::SECTOR_SIZE);
+    erases++;
+    return true;
+  }
+
+  // Power fails after `units` more programmed bytes / erased sectors
+  void cutPowerAfter(long units) { budget = units; }
+  void powerOn() {
+    dead = false;
+    budget = -1;
+  }
+
+  std::vector<uint8_t> mem;
+  uint32_t erases = 0;
+  bool dead = false;
+
+private:
+  bool spend() {
+    if (budget < 0) return true;
+    if (budget == 0) {
+      dead = true;
+      return false;
+    }
+    budget--;
+    return true;
+  }
+
+  long budget = -1;
+  uint32_t sectors_;
+};
+
+// 64 sectors like the "blackbox" partition: 4 slots
+static SimFlash *flash = nullptr;
+static Sample ringBuf[RING_SAMPLES];
+static Sample stageBuf[WINDOW_SAMPLES];
+static uint32_t tick = 0; // Samples recorded since the test started
+
+static Sample makeSample(uint32_t n) {
+  Sample s;
+  memset(&s, 0, sizeof(s));
+  s.tickMs = n * 10;
+  s.pedalPermille = uint16_t(n % 1001);
+  s.steeringDeciDeg = int16_t(int32_t(n % 900) - 450);
+  for (uint8_t w = 0; w < 4; w++) {
+    s.wheelCentiKmh[w] = uint16_t(n + w);
+    s.motorDeciA[w] = int16_t(w * 10);
+    s.motorPwm[w] = uint8_t(n + w);
+  }
+  s.limpState = uint8_t(n % 4);
+  return s;
+}
+
+// One control tick; the journal job runs every 100th tick
+static void step() {
+  record(makeSample(tick));
+  tick++;
+  if (tick % 100 == 0) service();
+}
+
+static void run(uint32_t ticks) {
+  for (uint32_t i = 0; i < ticks; i++) step();
+}
+
+// Run until the window is on flash (or given up)
+static bool runUntilDumped(uint32_t maxTicks = 10000) {
+  for (uint32_t i = 0; i < maxTicks; i++) {
+    step();
+    if (getState() == State::RECORDING) return true;
+  }
+  return false;
+}
+
+void setUp() {
+  flash = new SimFlash(64);
+  tick = 0;
+  TEST_ASSERT_TRUE(begin(*flash, ringBuf, stageBuf));
+}
+
+void tearDown() {
+  end();
+  delete flash;
+  flash = nullptr;
+}
+
+static void remount() {
+  end();
+  TEST_ASSERT_TRUE(begin(*flash, ringBuf, stageBuf));
+}
+
+void test_window_holds_pre_and_post_samples() {
+  run(2500);
+  trigger(TRIGGER_LIMP);
+  uint32_t triggerTick = tick;
+  TEST_ASSERT_TRUE(runUntilDumped());
+
+  DumpInfo d[4];
+  TEST_ASSERT_EQUAL(1, listDumps(d, 4));
+  TEST_ASSERT_EQUAL_UINT32(1, d[0].seq);
+  TEST_ASSERT_EQUAL(TRIGGER_LIMP, d[0].trigger);
+  TEST_ASSERT_EQUAL(PRE_SAMPLES, d[0].preSamples);
+  TEST_ASSERT_EQUAL(WINDOW_SAMPLES, d[0].sampleCount);
+  TEST_ASSERT_EQUAL_UINT32(triggerTick * 10, d[0].triggerMs);
+
+  // Contiguous ticks, trigger marked on its own sample only
+  for (uint16_t i = 0; i < d[0].sampleCount; i++) {
+    Sample s;
+    TEST_ASSERT_TRUE(readSample(d[0], i, s));
+    uint32_t n = triggerTick - PRE_SAMPLES + i;
+    Sample expect = makeSample(n);
+    TEST_ASSERT_EQUAL_UINT32(n * 10, s.tickMs);
+    TEST_ASSERT_EQUAL_UINT16(expect.wheelCentiKmh[3], s.wheelCentiKmh[3]);
+    TEST_ASSERT_EQUAL_INT16(expect.steeringDeciDeg, s.steeringDeciDeg);
+    TEST_ASSERT_EQUAL(i == PRE_SAMPLES ? TRIGGER_LIMP : TRIGGER_NONE,
+                      s.event);
+  }
+
+  // Header CRC covers the samples as written
+  DumpHeader h;
+  memcpy(&h, &flash->mem[d[0].slot * SLOT_SECTORS * FlashJournal::SECTOR_SIZE],
+         sizeof(h));
+  TEST_ASSERT_EQUAL_HEX32(
+      h.dataCrc,
+      FlashJournal::crc32(0, &flash->mem[d[0].slot * SLOT_SECTORS *
+                                             FlashJournal::SECTOR_SIZE +
+                                         sizeof(DumpHeader)],
+                          h.sampleCount * sizeof(Sample)));
+}
+
+void test_trigger_right_after_boot_keeps_what_exists() {
+  run(300);
+  trigger(TRIGGER_ABS);
+  TEST_ASSERT_TRUE(runUntilDumped());
+
+  DumpInfo d;
+  TEST_ASSERT_EQUAL(1, listDumps(&d, 1));
+  TEST_ASSERT_EQUAL(300, d.preSamples);
+  TEST_ASSERT_EQUAL(300 + POST_SAMPLES, d.sampleCount);
+  Sample first;
+  readSample(d, 0, first);
+  TEST_ASSERT_EQUAL_UINT32(0, first.tickMs);
+}
+
+void test_triggers_while_capturing_are_coalesced_and_marked() {
+  run(1200);
+  trigger(TRIGGER_ABS);
+  trigger(TRIGGER_LIMP); // Same tick: coalesced into the ABS request
+  step();
+  run(100);
+  trigger(TRIGGER_EMERGENCY_STOP); // Window already open
+  uint32_t markTick = tick;
+  TEST_ASSERT_TRUE(runUntilDumped());
+
+  Stats st;
+  getStats(st);
+  TEST_ASSERT_EQUAL_UINT32(1, st.triggers);
+  TEST_ASSERT_EQUAL_UINT32(2, st.coalesced);
+  TEST_ASSERT_EQUAL_UINT32(1, st.dumps);
+
+  DumpInfo d;
+  listDumps(&d, 1);
+  TEST_ASSERT_EQUAL(TRIGGER_ABS, d.trigger);
+  Sample s;
+  readSample(d, uint16_t(markTick - (1200 - PRE_SAMPLES)), s);
+  TEST_ASSERT_EQUAL_UINT32(markTick * 10, s.tickMs);
+  TEST_ASSERT_EQUAL(TRIGGER_EMERGENCY_STOP, s.event);
+}
+
+void test_slots_rotate_and_survive_remount() {
+  for (int i = 0; i < 6; i++) {
+    run(1100);
+    trigger(TRIGGER_MANUAL);
+    TEST_ASSERT_TRUE(runUntilDumped());
+  }
+  run(2000);
+
+  // The slot after the newest is erased ahead: slots - 1 dumps kept
+  DumpInfo d[4];
+  TEST_ASSERT_EQUAL(3, listDumps(d, 4));
+  TEST_ASSERT_EQUAL_UINT32(6, d[0].seq);
+  TEST_ASSERT_EQUAL_UINT32(5, d[1].seq);
+  TEST_ASSERT_EQUAL_UINT32(4, d[2].seq);
+
+  remount();
+  TEST_ASSERT_EQUAL(3, listDumps(d, 4));
+  uint32_t erasesBefore = flash->erases;
+  run(1100);
+  trigger(TRIGGER_MANUAL);
+  TEST_ASSERT_TRUE(runUntilDumped());
+  // Already-blank sectors of the next slot were not erased again
+  TEST_ASSERT_EQUAL_UINT32(erasesBefore, flash->erases);
+
+  TEST_ASSERT_EQUAL(2, listDumps(d, 2));
+  TEST_ASSERT_EQUAL_UINT32(7, d[0].seq);
+  TEST_ASSERT_EQUAL_UINT32(6, d[1].seq);
+}
+
+void test_window_overwritten_before_service_is_dropped() {
+  run(1100);
+  trigger(TRIGGER_LIMP);
+  // Journal job starved: no service() for longer than the ring
+  for (uint32_t i = 0; i < POST_SAMPLES + RING_SAMPLES; i++) {
+    record(makeSample(tick++));
+  }
+  TEST_ASSERT_EQUAL(State::FROZEN, getState());
+  service();
+
+  Stats st;
+  getStats(st);
+  TEST_ASSERT_EQUAL_UINT32(1, st.overruns);
+  TEST_ASSERT_EQUAL(State::RECORDING, getState());
+  DumpInfo d;
+  TEST_ASSERT_EQUAL(0, listDumps(&d, 1));
+
+  // Next trigger works normally
+  trigger(TRIGGER_LIMP);
+  TEST_ASSERT_TRUE(runUntilDumped());
+  TEST_ASSERT_EQUAL(1, listDumps(&d, 1));
+}
+
+void test_power_cut_mid_dump_leaves_previous_dumps() {
+  run(1100);
+  trigger(TRIGGER_ABS);
+  TEST_ASSERT_TRUE(runUntilDumped());
+
+  // Cut power while the second window's samples are being written
+  run(1100);
+  trigger(TRIGGER_LIMP);
+  while (getState() != State::WRITING) step();
+  flash->cutPowerAfter(10000);
+  run(2000);
+  flash->powerOn();
+
+  remount();
+  DumpInfo d[4];
+  TEST_ASSERT_EQUAL(1, listDumps(d, 4));
+  TEST_ASSERT_EQUAL_UINT32(1, d[0].seq);
+  TEST_ASSERT_EQUAL(TRIGGER_ABS, d[0].trigger);
+
+  // The torn slot is erased again and reused
+  run(1100);
+  trigger(TRIGGER_LIMP);
+  TEST_ASSERT_TRUE(runUntilDumped());
+  TEST_ASSERT_EQUAL(2, listDumps(d, 4));
+  TEST_ASSERT_EQUAL_UINT32(2, d[0].seq);
+  TEST_ASSERT_EQUAL(TRIGGER_LIMP, d[0].trigger);
+}
+
+// record() is what the control job pays every tick, including the tick
+// that opens a window and the one that freezes it
+void test_benchmark_record_cost() {
+  using Clock = std::chrono::steady_clock;
+  constexpr uint32_t TICKS = 200000;
+  std::vector<uint32_t> ns;
+  ns.reserve(TICKS);
+  Sample s = makeSample(0);
+  for (uint32_t i = 0; i < TICKS; i++) {
+    if (i % 5000 == 1000) trigger(TRIGGER_MANUAL);
+    s.tickMs = i * 10;
+    auto t0 = Clock::now();
+    record(s);
+    auto t1 = Clock::now();
+    ns.push_back(uint32_t(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0)
+            .count()));
+    if (i % 100 == 99) service();
+  }
+  std::sort(ns.begin(), ns.end());
+  uint32_t p50 = ns[ns.size() / 2];
+  uint32_t p99 = ns[ns.size() * 99 / 100];
+  printf("  record(): p50 %u ns, p99 %u ns, max %u ns over %u ticks\n", p50,
+         p99, ns.back(), (unsigned)TICKS);
+
+  Stats st;
+  getStats(st);
+  TEST_ASSERT_TRUE(st.dumps > 30);
+  TEST_ASSERT_LESS_THAN(2000, p50);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_window_holds_pre_and_post_samples);
+  RUN_TEST(test_trigger_right_after_boot_keeps_what_exists);
+  RUN_TEST(test_triggers_while_capturing_are_coalesced_and_marked);
+  RUN_TEST(test_slots_rotate_and_survive_remount);
+  RUN_TEST(test_window_overwritten_before_service_is_dropped);
+  RUN_TEST(test_power_cut_mid_dump_leaves_previous_dumps);
+  RUN_TEST(test_benchmark_record_cost);
+  return UNITY_END();
+}
@@ -0,0 +1,257 @@
+// ============================================================================
+// test_main.cpp - BootGraph planner on a virtual clock (native host test)
+// Run: pio test -e native -f test_boot_graph
+//
+// simulate() plays the FreeRTOS runner with two workers (core 0 and core 1)
+// and per-step durations instead of real init code, then checks the
+// timeline: dependencies finished before dependents started, no two steps
+// held a bus at the same time, pinned steps ran on their core.
+// ============================================================================
+
+#include "boot_graph.h"
+#include <unity.h>
+
+using namespace BootGraph;
+
+static bool stepFn() { return true; }
+
+struct Sim {
+  const uint32_t *durUs;
+  uint32_t failMask;
+  uint8_t workers; // 1 = single ANY_CORE worker (no helper task)
+};
+
+static Plan plan;
+
+static void simulate(const Step *steps, uint8_t count, const Sim &sim,
+                     const Options &opt = Options()) {
+  reset(plan, steps, count, opt);
+  int8_t running[2] = {-1, -1};
+  uint32_t freeAt[2] = {0, 0};
+  uint32_t now = 0;
+
+  for (;;) {
+    for (uint8_t w = 0; w < sim.workers; w++) {
+      if (running[w] >= 0) continue;
+      uint8_t core = sim.workers == 1 ? ANY_CORE : w;
+      running[w] = next(plan, core, now);
+      if (running[w] >= 0) freeAt[w] = now + sim.durUs[running[w]];
+    }
+
+    int8_t first = -1;
+    for (uint8_t w = 0; w < sim.workers; w++) {
+      if (running[w] >= 0 && (first < 0 || freeAt[w] < freeAt[first])) {
+        first = w;
+      }
+    }
+    if (first < 0) break;
+
+    now = freeAt[first];
+    uint8_t idx = running[first];
+    complete(plan, idx, !(sim.failMask & dep(idx)), now);
+    running[first] = -1;
+  }
+  TEST_ASSERT_TRUE(finished(plan));
+}
+
+static bool ran(uint8_t i) {
+  return plan.rec[i].state == StepState::DONE ||
+         plan.rec[i].state == StepState::FAILED;
+}
+
+static void assertTimelineValid(const Step *steps, uint8_t count) {
+  for (uint8_t i = 0; i < count; i++) {
+    if (!ran(i)) continue;
+    const StepRecord &r = plan.rec[i];
+    if (steps[i].core != ANY_CORE && r.core != ANY_CORE) {
+      TEST_ASSERT_EQUAL_UINT8(steps[i].core, r.core);
+    }
+    for (uint8_t d = 0; d < count; d++) {
+      if (!(steps[i].deps & dep(d))) continue;
+      TEST_ASSERT_TRUE(plan.rec[d].state == StepState::DONE);
+      TEST_ASSERT_GREATER_OR_EQUAL_UINT32(plan.rec[d].endUs, r.startUs);
+    }
+    for (uint8_t j = i + 1; j < count; j++) {
+      if (!ran(j) || !(steps[i].buses & steps[j].buses)) continue;
+      const StepRecord &o = plan.rec[j];
+      bool disjoint = r.endUs <= o.startUs || o.endUs <= r.startUs;
+      TEST_ASSERT_TRUE_MESSAGE(disjoint, "bus held by two steps at once");
+    }
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Model of the vehicle boot graph in main.cpp, with measured-order durations
+// ---------------------------------------------------------------------------
+enum : uint8_t {
+  JOURNAL,
+  STORAGE,
+  SYSTEM,
+  I2C,
+  TFT_RESET,
+  HUD,
+  LOGO,
+  POWER,
+  SENSORS,
+  SAFETY,
+  CONTROL,
+  TELEMETRY,
+  MODE,
+  SHARED,
+  EXECUTIVES,
+  BOOT_COUNT
+};
+
+static const Step BOOT[BOOT_COUNT] = {
+    {"Journal", stepFn, BUS_FLASH, 0, ANY_CORE},
+    {"Storage", stepFn, BUS_FLASH, dep(JOURNAL), ANY_CORE},
+    {"System", stepFn, BUS_NONE, dep(STORAGE), ANY_CORE},
+    {"I2C", stepFn, BUS_I2C, 0, ANY_CORE},
+    {"TFT reset", stepFn, BUS_SPI, 0, 1},
+    {"HUD", stepFn, BUS_SPI, dep(TFT_RESET) | dep(SYSTEM), 1},
+    {"Logo", stepFn, BUS_SPI, dep(HUD), 1},
+    {"Power", stepFn, BUS_NONE, dep(SYSTEM), ANY_CORE},
+    {"Sensors", stepFn, BUS_I2C | BUS_UART, dep(POWER) | dep(I2C), ANY_CORE},
+    {"Safety", stepFn, BUS_NONE, dep(SENSORS), ANY_CORE},
+    {"Control", stepFn, BUS_I2C, dep(SAFETY), ANY_CORE},
+    {"Telemetry", stepFn, BUS_FLASH, dep(STORAGE), ANY_CORE},
+    {"Mode", stepFn, BUS_NONE, dep(SYSTEM), ANY_CORE},
+    {"SharedData", stepFn, BUS_NONE, 0, ANY_CORE},
+    {"Executives", stepFn, BUS_NONE,
+     dep(LOGO) | dep(CONTROL) | dep(TELEMETRY) | dep(MODE) | dep(SHARED),
+     ANY_CORE},
+};
+
+static const uint32_t BOOT_US[BOOT_COUNT] = {
+    30000,  40000, 5000,   20000, 260000, 350000, 80000, 2000,
+    400000, 1000,  300000, 30000, 100,    1000,   20000,
+};
+
+static const uint32_t VEHICLE_CRITICAL =
+    dep(POWER) | dep(SENSORS) | dep(SAFETY) | dep(HUD) | dep(CONTROL) |
+    dep(TELEMETRY) | dep(MODE) | dep(SHARED) | dep(EXECUTIVES);
+
+void setUp() {}
+void tearDown() {}
+
+void test_validate_rejects_bad_graphs() {
+  TEST_ASSERT_TRUE(validate(BOOT, BOOT_COUNT));
+
+  const Step unknown[] = {{"a", stepFn, BUS_NONE, dep(5), ANY_CORE}};
+  TEST_ASSERT_FALSE(validate(unknown, 1));
+
+  const Step self[] = {{"a", stepFn, BUS_NONE, dep(0), ANY_CORE}};
+  TEST_ASSERT_FALSE(validate(self, 1));
+
+  const Step cycle[] = {
+      {"a", stepFn, BUS_NONE, dep(2), ANY_CORE},
+      {"b", stepFn, BUS_NONE, dep(0), ANY_CORE},
+      {"c", stepFn, BUS_NONE, dep(1), ANY_CORE},
+  };
+  TEST_ASSERT_FALSE(validate(cycle, 3));
+
+  const Step noFn[] = {{"a", nullptr, BUS_NONE, 0, ANY_CORE}};
+  TEST_ASSERT_FALSE(validate(noFn, 1));
+  TEST_ASSERT_FALSE(validate(BOOT, 0));
+}
+
+void test_boot_graph_overlaps_display_and_vehicle_chains() {
+  Options opt;
+  opt.critical = VEHICLE_CRITICAL;
+  simulate(BOOT, BOOT_COUNT, {BOOT_US, 0, 2}, opt);
+  assertTimelineValid(BOOT, BOOT_COUNT);
+
+  for (uint8_t i = 0; i < BOOT_COUNT; i++) {
+    TEST_ASSERT_TRUE(plan.rec[i].state == StepState::DONE);
+  }
+  TEST_ASSERT_EQUAL_INT8(NO_FAILURE, failedCritical(plan));
+
+  // Longest chain: Journal, Storage, System, Power, Sensors, Safety, Control,
+  // Executives. The display chain (690 ms) hides underneath it.
+  uint32_t criticalPath = 30000 + 40000 + 5000 + 2000 + 400000 + 1000 +
+                          300000 + 20000;
+  uint32_t serial = 0;
+  for (uint32_t d : BOOT_US) serial += d;
+  TEST_ASSERT_EQUAL_UINT32(serial, serialUs(plan));
+  TEST_ASSERT_EQUAL_UINT32(criticalPath, makespanUs(plan));
+}
+
+void test_single_worker_runs_everything_in_table_order() {
+  simulate(BOOT, BOOT_COUNT, {BOOT_US, 0, 1});
+  assertTimelineValid(BOOT, BOOT_COUNT);
+  TEST_ASSERT_EQUAL_UINT32(serialUs(plan), makespanUs(plan));
+  for (uint8_t i = 0; i < BOOT_COUNT; i++) {
+    TEST_ASSERT_TRUE(plan.rec[i].state == StepState::DONE);
+  }
+}
+
+void test_shared_bus_serializes_independent_steps() {
+  const Step steps[] = {
+      {"ina226", stepFn, BUS_I2C, 0, ANY_CORE},
+      {"mcp23017", stepFn, BUS_I2C, 0, ANY_CORE},
+      {"ds18b20", stepFn, BUS_ONEWIRE, 0, ANY_CORE},
+  };
+  const uint32_t dur[] = {100, 200, 250};
+  simulate(steps, 3, {dur, 0, 2});
+  assertTimelineValid(steps, 3);
+  // Both I2C probes queue on one bus; OneWire discovery runs beside them
+  TEST_ASSERT_EQUAL_UINT32(300, makespanUs(plan));
+  TEST_ASSERT_EQUAL_UINT32(550, serialUs(plan));
+}
+
+void test_failed_step_skips_dependents_only() {
+  Options opt; // Nothing critical: the rest of the graph keeps going
+  simulate(BOOT, BOOT_COUNT, {BOOT_US, dep(HUD), 2}, opt);
+  assertTimelineValid(BOOT, BOOT_COUNT);
+
+  TEST_ASSERT_TRUE(plan.rec[HUD].state == StepState::FAILED);
+  TEST_ASSERT_TRUE(plan.rec[LOGO].state == StepState::SKIPPED);
+  TEST_ASSERT_TRUE(plan.rec[EXECUTIVES].state == StepState::SKIPPED);
+  TEST_ASSERT_TRUE(plan.rec[CONTROL].state == StepState::DONE);
+  TEST_ASSERT_TRUE(plan.rec[TELEMETRY].state == StepState::DONE);
+  TEST_ASSERT_EQUAL_INT8(NO_FAILURE, failedCritical(plan));
+}
+
+void test_critical_failure_stops_scheduling() {
+  Options opt;
+  opt.critical = VEHICLE_CRITICAL;
+  simulate(BOOT, BOOT_COUNT, {BOOT_US, dep(POWER), 2}, opt);
+
+  TEST_ASSERT_EQUAL_INT8(POWER, failedCritical(plan));
+  TEST_ASSERT_TRUE(plan.aborted);
+  uint32_t failedAt = plan.rec[POWER].endUs;
+  for (uint8_t i = 0; i < BOOT_COUNT; i++) {
+    if (!ran(i)) continue;
+    // Steps already running may finish, nothing new starts
+    TEST_ASSERT_LESS_THAN_UINT32(failedAt + 1, plan.rec[i].startUs);
+  }
+  TEST_ASSERT_TRUE(plan.rec[SENSORS].state == StepState::SKIPPED);
+  TEST_ASSERT_TRUE(plan.rec[CONTROL].state == StepState::SKIPPED);
+}
+
+void test_safe_mode_skip_mask() {
+  Options opt;
+  opt.skip = dep(TELEMETRY) | dep(MODE) | dep(SHARED) | dep(EXECUTIVES);
+  opt.critical = VEHICLE_CRITICAL & ~dep(HUD);
+  simulate(BOOT, BOOT_COUNT, {BOOT_US, dep(HUD), 2}, opt);
+  assertTimelineValid(BOOT, BOOT_COUNT);
+
+  // HUD failure is tolerated in safe mode, the vehicle chain completes
+  TEST_ASSERT_EQUAL_INT8(NO_FAILURE, failedCritical(plan));
+  TEST_ASSERT_TRUE(plan.rec[CONTROL].state == StepState::DONE);
+  TEST_ASSERT_TRUE(plan.rec[TELEMETRY].state == StepState::SKIPPED);
+  TEST_ASSERT_TRUE(plan.rec[EXECUTIVES].state == StepState::SKIPPED);
+  TEST_ASSERT_EQUAL_UINT32(0, plan.rec[TELEMETRY].startUs);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_validate_rejects_bad_graphs);
+  RUN_TEST(test_boot_graph_overlaps_display_and_vehicle_chains);
+  RUN_TEST(test_single_worker_runs_everything_in_table_order);
+  RUN_TEST(test_shared_bus_serializes_independent_steps);
+  RUN_TEST(test_failed_step_skips_dependents_only);
+  RUN_TEST(test_critical_failure_stops_scheduling);
+  RUN_TEST(test_safe_mode_skip_mask);
+  return UNITY_END();
+}
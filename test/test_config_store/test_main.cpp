@@ -0,0 +1,564 @@
+// ============================================================================
+// test_main.cpp - ConfigStore schema, lazy loading and migrations (native)
+// Run: pio test -e native -f test_config_store
+//
+// FakeNvs keeps typed entries per namespace like NVS does (a read with the
+// wrong type or blob size fails) and counts scans/reads/writes so the tests
+// can check what a boot or a commit actually touched. Each legacy layout is
+// written with the key names and types the removed implementations used.
+// ============================================================================
+
+#include "config_store.h"
+#include "config_store_legacy.h"
+#include <cstring>
+#include <map>
+#include <string>
+#include <unity.h>
+#include <vector>
+
+using namespace ConfigStore;
+
+class FakeNvs : public Backend {
+public:
+  struct Entry {
+    ValueType type;
+    std::vector<uint8_t> data;
+  };
+  typedef std::map<std::string, Entry> Namespace;
+
+  bool scan(const char *ns, ScanFn fn, void *ctx) override {
+    scans++;
+    auto it = spaces.find(ns);
+    if (it == spaces.end()) return false;
+    for (auto &kv : it->second) fn(kv.first.c_str(), kv.second.type, ctx);
+    return true;
+  }
+
+  bool read(const char *ns, const char *key, ValueType type, void *out,
+            size_t len) override {
+    if (std::string(ns) == NAMESPACE) reads++;
+    const Entry *e = find(ns, key);
+    if (e == nullptr || e->type != type || e->data.size() != len) return false;
+    memcpy(out, e->data.data(), len);
+    return true;
+  }
+
+  bool write(const char *ns, const char *key, ValueType type, const void *in,
+             size_t len) override {
+    if (failAfter == 0) return false; // Power lost
+    if (failAfter > 0) failAfter--;
+    writes++;
+    writtenKeys.push_back(key);
+    const uint8_t *p = static_cast<const uint8_t *>(in);
+    spaces[ns][key] = Entry{type, std::vector<uint8_t>(p, p + len)};
+    return true;
+  }
+
+  bool eraseNamespace(const char *ns) override {
+    spaces.erase(ns);
+    return true;
+  }
+
+  bool sync(const char *) override { return failAfter != 0; }
+
+  // Helpers to seed legacy layouts
+  template <typename T> void put(const char *ns, const char *key, T v) {
+    spaces[ns][key] = Entry{typeOf(v), bytes(&v, sizeof(v))};
+  }
+  void putBool(const char *ns, const char *key, bool v) {
+    put<uint8_t>(ns, key, v ? 1 : 0);
+  }
+  void putBlob(const char *ns, const char *key, const void *p, size_t len) {
+    spaces[ns][key] = Entry{ValueType::BLOB, bytes(p, len)};
+  }
+
+  void resetCounters() {
+    scans = reads = writes = 0;
+    writtenKeys.clear();
+  }
+
+  std::map<std::string, Namespace> spaces;
+  std::vector<std::string> writtenKeys;
+  int scans = 0;
+  int reads = 0; // Reads of the "cfg" namespace only
+  int writes = 0;
+  long failAfter = -1; // Writes allowed before failing (-1: never)
+
+private:
+  const Entry *find(const char *ns, const char *key) const {
+    auto it = spaces.find(ns);
+    if (it == spaces.end()) return nullptr;
+    auto e = it->second.find(key);
+    return e == it->second.end() ? nullptr : &e->second;
+  }
+  static std::vector<uint8_t> bytes(const void *p, size_t len) {
+    const uint8_t *b = static_cast<const uint8_t *>(p);
+    return std::vector<uint8_t>(b, b + len);
+  }
+  static ValueType typeOf(uint8_t) { return ValueType::U8; }
+  static ValueType typeOf(uint16_t) { return ValueType::U16; }
+  static ValueType typeOf(int16_t) { return ValueType::I16; }
+  static ValueType typeOf(uint32_t) { return ValueType::U32; }
+  static ValueType typeOf(int32_t) { return ValueType::I32; }
+};
+
+// ----------------------------------------------------------------------------
+// Legacy layouts
+// ----------------------------------------------------------------------------
+
+static void seedConfigManager(FakeNvs &nvs) {
+  const char *ns = Legacy::COCHE_NS;
+  nvs.put<uint16_t>(ns, "pwr_hold", 4000);
+  nvs.put<uint16_t>(ns, "shutdown", 2500);
+  nvs.put<uint8_t>(ns, "regen_lvl", 45);
+  nvs.put<uint8_t>(ns, "led_brght", 77);
+  nvs.put<uint8_t>(ns, "led_ptrn", 3);
+  nvs.put<uint8_t>(ns, "led_spd", 5);
+  nvs.put<uint8_t>(ns, "led_r", 0x12);
+  nvs.put<uint8_t>(ns, "led_g", 0x34);
+  nvs.put<uint8_t>(ns, "led_b", 0x56);
+  nvs.put<int16_t>(ns, "enc_cntr", 610);
+  nvs.put<int16_t>(ns, "enc_min", 10);
+  nvs.put<int16_t>(ns, "enc_max", 1190);
+  nvs.putBool(ns, "sns_whls", true);
+  nvs.putBool(ns, "sns_curr", true);
+  nvs.putBool(ns, "sns_enc", false);
+  nvs.put<uint16_t>(ns, "mnu_tout", 45000);
+  nvs.put<uint16_t>(ns, "mnu_pin", 1234);
+  nvs.put<uint8_t>(ns, "abs_thrs", 12);
+  nvs.put<uint8_t>(ns, "tcs_thrs", 18);
+  nvs.put<uint32_t>(ns, "crc", 0xCAFEF00D);
+}
+
+static void seedEepromPersistence(FakeNvs &nvs) {
+  nvs.put<int16_t>(Legacy::EEPROM_ENCODER_NS, "center", 620);
+  nvs.put<int16_t>(Legacy::EEPROM_ENCODER_NS, "left", 20);
+  nvs.put<int16_t>(Legacy::EEPROM_ENCODER_NS, "right", 1180);
+  nvs.putBool(Legacy::EEPROM_ENCODER_NS, "calibrated", true);
+  nvs.putBool(Legacy::EEPROM_SENSORS_NS, "wRL", false);
+  nvs.putBool(Legacy::EEPROM_SENSORS_NS, "inaStr", false);
+  nvs.put<uint16_t>(Legacy::EEPROM_POWER_NS, "motor", 750);
+  nvs.putBool(Legacy::EEPROM_POWER_NS, "auto", false);
+  nvs.put<uint8_t>(Legacy::EEPROM_LEDS_NS, "pattern", 4);
+  nvs.putBool(Legacy::EEPROM_LEDS_NS, "enabled", false);
+  nvs.put<uint16_t>(Legacy::EEPROM_GENERAL_NS, "timeout", 90);
+  nvs.put<uint8_t>(Legacy::EEPROM_GENERAL_NS, "volume", 22);
+  nvs.putBool(Legacy::EEPROM_GENERAL_NS, "tcs", false);
+  nvs.put<uint8_t>(Legacy::EEPROM_GENERAL_NS, "drive", 2);
+}
+
+static void seedConfigStorage(FakeNvs &nvs) {
+  const char *ns = Legacy::CAR_CONFIG_NS;
+  nvs.putBool(ns, "sFL", true);
+  nvs.putBool(ns, "sFR", false);
+  nvs.putBool(ns, "sRL", true);
+  nvs.putBool(ns, "sRR", true);
+  nvs.putBool(ns, "sINA", false);
+  nvs.put<int16_t>(ns, "enc_c", 630);
+  nvs.put<int16_t>(ns, "enc_l", 30);
+  nvs.put<int16_t>(ns, "enc_r", 1170);
+  nvs.put<uint8_t>(ns, "led_pat", 6);
+  nvs.put<uint8_t>(ns, "led_bri", 200);
+  nvs.put<uint8_t>(ns, "led_spd", 90);
+  nvs.put<uint32_t>(ns, "led_col", 0x00FF00);
+  nvs.put<uint16_t>(ns, "pwr_hold", 6000);
+  nvs.put<uint16_t>(ns, "pwr_aux", 150);
+  nvs.put<uint16_t>(ns, "pwr_trac", 800);
+  nvs.putBool(ns, "abs", false);
+  nvs.putBool(ns, "tcs", true);
+  nvs.putBool(ns, "regen", false);
+  nvs.putBool(ns, "wifi", false);
+  nvs.put<uint16_t>(ns, "obs_crit", 150);
+  nvs.put<uint16_t>(ns, "obs_warn", 450);
+  nvs.put<uint16_t>(ns, "obs_caut", 900);
+  nvs.putBool(ns, "obs_sen", false);
+  nvs.putBool(ns, "obs_aud", true);
+  nvs.putBool(ns, "obs_vis", false);
+  nvs.put<uint32_t>(ns, "checksum", 0x1234);
+}
+
+static Legacy::VehicleV8 makeVehicleBlob() {
+  Legacy::VehicleV8 v;
+  memset(&v, 0, sizeof(v));
+  v.pedalMin = 150;
+  v.pedalMax = 3700;
+  v.pedalCurve = 2;
+  v.regenPercent = 55;
+  for (int i = 0; i < 6; i++) v.shuntCoeff[i] = 0.001f * (i + 1);
+  v.steerZeroOffset = -12;
+  v.showTemps = false;
+  v.showEffort = true;
+  v.displayBrightness = 180;
+  v.maxBatteryCurrentA = 90.0f;
+  v.maxMotorCurrentA = 40.0f;
+  v.audioEnabled = false;
+  v.tractionEnabled = true;
+  v.wheelSensorsEnabled = true;
+  v.tempSensorsEnabled = true;
+  v.currentSensorsEnabled = false;
+  v.steeringEnabled = true;
+  v.touchEnabled = false; // Storage::load() forced this back on
+  uint16_t cal[5] = {310, 3800, 290, 3750, 1};
+  memcpy(v.touchCalibration, cal, sizeof(cal));
+  v.touchCalibrated = true;
+  v.shadowHudEnabled = true;
+  v.odometer = {1234.5f, 12.5f, 1000.0f, 77, 3600};
+  v.maintenanceIntervalKm = 400;
+  v.maintenanceIntervalDays = 90;
+  v.errors[0] = {970, 1000};
+  v.errors[1] = {981, 2000};
+  v.errorCount = 2;
+  v.version = Legacy::VEHICLE_VERSION;
+  v.checksum = Legacy::vehicleChecksum(v);
+  return v;
+}
+
+static void seedVehicleBlob(FakeNvs &nvs, const Legacy::VehicleV8 &v) {
+  nvs.put<uint32_t>(Legacy::VEHICLE_NS, Legacy::VEHICLE_KEY_MAGIC,
+                    Legacy::VEHICLE_MAGIC);
+  nvs.putBlob(Legacy::VEHICLE_NS, Legacy::VEHICLE_KEY_BLOB, &v, sizeof(v));
+}
+
+static size_t legacyEntryCount(const FakeNvs &nvs) {
+  size_t n = 0;
+  for (auto &kv : nvs.spaces) {
+    if (kv.first != NAMESPACE) n += kv.second.size();
+  }
+  return n;
+}
+
+void setUp() {}
+void tearDown() { end(); }
+
+// ----------------------------------------------------------------------------
+// Tests
+// ----------------------------------------------------------------------------
+
+void test_fresh_boot_persists_defaults() {
+  FakeNvs nvs;
+  TEST_ASSERT_TRUE(begin(nvs));
+  Stats st;
+  getStats(st);
+  TEST_ASSERT_EQUAL_UINT16(0, st.version);
+  TEST_ASSERT_EQUAL_UINT8(1, st.migrationsRun);
+  TEST_ASSERT_EQUAL_UINT8(0, st.legacyLayouts);
+
+  const Settings &d = defaults();
+  TEST_ASSERT_EQUAL_MEMORY(&d.power, &power(), sizeof(Power));
+  TEST_ASSERT_EQUAL_MEMORY(&d.general, &general(), sizeof(General));
+  // A car with no saved GeneralSettings booted with these off
+  TEST_ASSERT_FALSE(general().absEnabled);
+  TEST_ASSERT_FALSE(general().tcsEnabled);
+  TEST_ASSERT_FALSE(general().regenEnabled);
+  // ...and with dark LED strips
+  TEST_ASSERT_FALSE(leds().enabled);
+
+  // Every schema key plus the version was written once
+  TEST_ASSERT_EQUAL_INT((int)st.fieldWrites + 1, nvs.writes);
+  uint16_t version = 0;
+  TEST_ASSERT_TRUE(
+      nvs.read(NAMESPACE, "version", ValueType::U16, &version, 2));
+  TEST_ASSERT_EQUAL_UINT16(SCHEMA_VERSION, version);
+}
+
+void test_second_boot_scans_once_and_writes_nothing() {
+  FakeNvs nvs;
+  TEST_ASSERT_TRUE(begin(nvs));
+  end();
+
+  nvs.resetCounters();
+  TEST_ASSERT_TRUE(begin(nvs));
+  Stats st;
+  getStats(st);
+  TEST_ASSERT_EQUAL_INT(1, nvs.scans);
+  TEST_ASSERT_EQUAL_INT(1, nvs.reads); // Just the version key
+  TEST_ASSERT_EQUAL_INT(0, nvs.writes);
+  TEST_ASSERT_EQUAL_UINT8(0, st.migrationsRun);
+  TEST_ASSERT_EQUAL_UINT8(0, st.sectionsLoaded);
+  TEST_ASSERT_TRUE(commit());
+  TEST_ASSERT_EQUAL_INT(0, nvs.writes);
+}
+
+void test_sections_load_lazily() {
+  FakeNvs nvs;
+  TEST_ASSERT_TRUE(begin(nvs));
+  leds().brightness = 42;
+  TEST_ASSERT_TRUE(commit(SECTION_LEDS));
+  end();
+
+  nvs.resetCounters();
+  TEST_ASSERT_TRUE(begin(nvs));
+  TEST_ASSERT_FALSE(isLoaded(SECTION_LEDS));
+  TEST_ASSERT_EQUAL_UINT8(42, leds().brightness);
+  TEST_ASSERT_TRUE(isLoaded(SECTION_LEDS));
+  TEST_ASSERT_FALSE(isLoaded(SECTION_VEHICLE));
+  TEST_ASSERT_EQUAL_INT(1 + 5, nvs.reads); // version + the 5 LED keys
+}
+
+void test_commit_writes_only_changed_keys() {
+  FakeNvs nvs;
+  TEST_ASSERT_TRUE(begin(nvs));
+  nvs.resetCounters();
+
+  leds().color = 0x0000FF;
+  general(); // Loaded but unchanged
+  TEST_ASSERT_TRUE(commit());
+  TEST_ASSERT_EQUAL_INT(1, nvs.writes);
+  TEST_ASSERT_EQUAL_STRING("led_color", nvs.writtenKeys[0].c_str());
+
+  nvs.resetCounters();
+  TEST_ASSERT_TRUE(commit(SECTION_LEDS)); // Nothing changed since
+  TEST_ASSERT_EQUAL_INT(0, nvs.writes);
+}
+
+void test_out_of_range_value_resets_to_default() {
+  FakeNvs nvs;
+  TEST_ASSERT_TRUE(begin(nvs));
+  end();
+  nvs.put<uint16_t>(NAMESPACE, "pwr_hold", 50000); // > 10000
+  nvs.put<uint32_t>(NAMESPACE, "volume", 7);       // Wrong type
+
+  TEST_ASSERT_TRUE(begin(nvs));
+  TEST_ASSERT_EQUAL_UINT16(defaults().power.holdDelayMs, power().holdDelayMs);
+  TEST_ASSERT_EQUAL_UINT8(defaults().general.volume, general().volume);
+  Stats st;
+  getStats(st);
+  TEST_ASSERT_EQUAL_UINT32(2, st.rangeResets);
+
+  // The rejected keys are rewritten on the next commit
+  nvs.resetCounters();
+  TEST_ASSERT_TRUE(commit());
+  TEST_ASSERT_EQUAL_INT(2, nvs.writes);
+}
+
+void test_migrates_config_manager() {
+  FakeNvs nvs;
+  seedConfigManager(nvs);
+  TEST_ASSERT_TRUE(begin(nvs));
+  Stats st;
+  getStats(st);
+  TEST_ASSERT_EQUAL_UINT8(1, st.legacyLayouts);
+
+  TEST_ASSERT_EQUAL_UINT16(4000, power().holdDelayMs);
+  TEST_ASSERT_EQUAL_UINT16(2500, power().shutdownDelayMs);
+  TEST_ASSERT_EQUAL_UINT8(45, vehicle().regenPercent);
+  TEST_ASSERT_EQUAL_UINT8(77, leds().brightness);
+  TEST_ASSERT_EQUAL_UINT8(3, leds().pattern);
+  TEST_ASSERT_EQUAL_UINT8(127, leds().speed); // 5 of 1-10
+  TEST_ASSERT_EQUAL_HEX32(0x123456, leds().color);
+  TEST_ASSERT_EQUAL_INT16(610, encoder().center);
+  TEST_ASSERT_EQUAL_INT16(10, encoder().leftLimit);
+  TEST_ASSERT_EQUAL_INT16(1190, encoder().rightLimit);
+  TEST_ASSERT_TRUE(sensors().wheelSensorsEnabled);
+  TEST_ASSERT_TRUE(sensors().currentSensorsEnabled);
+  TEST_ASSERT_FALSE(sensors().encoderEnabled);
+  TEST_ASSERT_EQUAL_UINT16(45, general().menuTimeoutSec); // ms -> s
+  TEST_ASSERT_EQUAL_UINT16(1234, general().menuPin);
+  TEST_ASSERT_EQUAL_UINT8(12, general().absSlipThreshold);
+  TEST_ASSERT_EQUAL_UINT8(18, general().tcsSlipThreshold);
+}
+
+void test_config_manager_without_crc_is_ignored() {
+  FakeNvs nvs;
+  nvs.put<uint16_t>(Legacy::COCHE_NS, "pwr_hold", 4000);
+  TEST_ASSERT_TRUE(begin(nvs));
+  Stats st;
+  getStats(st);
+  TEST_ASSERT_EQUAL_UINT8(0, st.legacyLayouts);
+  TEST_ASSERT_EQUAL_UINT16(defaults().power.holdDelayMs, power().holdDelayMs);
+}
+
+void test_migrates_eeprom_persistence() {
+  FakeNvs nvs;
+  seedEepromPersistence(nvs);
+  TEST_ASSERT_TRUE(begin(nvs));
+  Stats st;
+  getStats(st);
+  TEST_ASSERT_EQUAL_UINT8(1, st.legacyLayouts);
+
+  TEST_ASSERT_EQUAL_INT16(620, encoder().center);
+  TEST_ASSERT_EQUAL_INT16(20, encoder().leftLimit);
+  TEST_ASSERT_EQUAL_INT16(1180, encoder().rightLimit);
+  TEST_ASSERT_TRUE(encoder().calibrated);
+  TEST_ASSERT_TRUE(sensors().wheel[0]);
+  TEST_ASSERT_FALSE(sensors().wheel[2]);
+  TEST_ASSERT_FALSE(sensors().ina226Channel[5]);
+  TEST_ASSERT_EQUAL_UINT16(750, power().tractionDelayMs);
+  TEST_ASSERT_FALSE(power().autoShutdown);
+  TEST_ASSERT_EQUAL_UINT8(4, leds().pattern);
+  TEST_ASSERT_FALSE(leds().enabled);
+  TEST_ASSERT_EQUAL_UINT16(90, general().menuTimeoutSec);
+  TEST_ASSERT_EQUAL_UINT8(22, general().volume);
+  TEST_ASSERT_FALSE(general().tcsEnabled);
+  TEST_ASSERT_FALSE(general().absEnabled); // Key absent: default (off) kept
+  TEST_ASSERT_EQUAL_UINT8(2, general().driveMode);
+}
+
+void test_migrates_config_storage() {
+  FakeNvs nvs;
+  seedConfigStorage(nvs);
+  TEST_ASSERT_TRUE(begin(nvs));
+  Stats st;
+  getStats(st);
+  TEST_ASSERT_EQUAL_UINT8(1, st.legacyLayouts);
+
+  TEST_ASSERT_TRUE(sensors().wheel[0]);
+  TEST_ASSERT_FALSE(sensors().wheel[1]);
+  TEST_ASSERT_FALSE(sensors().ina226Enabled);
+  TEST_ASSERT_EQUAL_INT16(630, encoder().center);
+  TEST_ASSERT_EQUAL_UINT8(6, leds().pattern);
+  TEST_ASSERT_EQUAL_UINT8(200, leds().brightness);
+  TEST_ASSERT_EQUAL_UINT8(90, leds().speed);
+  TEST_ASSERT_EQUAL_HEX32(0x00FF00, leds().color);
+  TEST_ASSERT_EQUAL_UINT16(6000, power().holdDelayMs);
+  TEST_ASSERT_EQUAL_UINT16(150, power().auxDelayMs);
+  TEST_ASSERT_EQUAL_UINT16(800, power().tractionDelayMs);
+  TEST_ASSERT_FALSE(general().wifiEnabled);
+  // Its safety toggles never reached the control systems at boot
+  TEST_ASSERT_FALSE(general().tcsEnabled);
+  TEST_ASSERT_EQUAL_UINT16(150, obstacle().criticalMm);
+  TEST_ASSERT_EQUAL_UINT16(450, obstacle().warningMm);
+  TEST_ASSERT_EQUAL_UINT16(900, obstacle().cautionMm);
+  TEST_ASSERT_FALSE(obstacle().sensorEnabled);
+  TEST_ASSERT_TRUE(obstacle().audioAlerts);
+  TEST_ASSERT_FALSE(obstacle().visualAlerts);
+}
+
+void test_migrates_vehicle_blob() {
+  FakeNvs nvs;
+  Legacy::VehicleV8 v = makeVehicleBlob();
+  seedVehicleBlob(nvs, v);
+  TEST_ASSERT_TRUE(begin(nvs));
+  Stats st;
+  getStats(st);
+  TEST_ASSERT_EQUAL_UINT8(1, st.legacyLayouts);
+
+  TEST_ASSERT_EQUAL_INT32(150, vehicle().pedalMin);
+  TEST_ASSERT_EQUAL_INT32(3700, vehicle().pedalMax);
+  TEST_ASSERT_EQUAL_UINT8(2, vehicle().pedalCurve);
+  TEST_ASSERT_EQUAL_UINT8(55, vehicle().regenPercent);
+  TEST_ASSERT_EQUAL_MEMORY(v.shuntCoeff, vehicle().shuntCoeff,
+                           sizeof(v.shuntCoeff));
+  TEST_ASSERT_EQUAL_INT32(-12, vehicle().steerZeroOffset);
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 90.0f, vehicle().maxBatteryCurrentA);
+  TEST_ASSERT_TRUE(vehicle().steeringEnabled);
+  TEST_ASSERT_FALSE(hud().showTemps);
+  TEST_ASSERT_EQUAL_UINT8(180, hud().displayBrightness);
+  TEST_ASSERT_TRUE(hud().touchEnabled);
+  TEST_ASSERT_EQUAL_MEMORY(v.touchCalibration, hud().touchCalibration,
+                           sizeof(v.touchCalibration));
+  TEST_ASSERT_TRUE(hud().touchCalibrated);
+  TEST_ASSERT_TRUE(hud().shadowHudEnabled);
+  TEST_ASSERT_TRUE(sensors().tempSensorsEnabled);
+  TEST_ASSERT_FALSE(general().audioEnabled);
+  TEST_ASSERT_EQUAL_MEMORY(&v.odometer, &maintenance().odometer,
+                           sizeof(v.odometer));
+  TEST_ASSERT_EQUAL_UINT16(400, maintenance().intervalKm);
+  TEST_ASSERT_EQUAL_INT32(2, errors().count);
+  TEST_ASSERT_EQUAL_UINT16(981, errors().entries[1].code);
+}
+
+void test_corrupt_vehicle_blob_is_ignored() {
+  FakeNvs nvs;
+  Legacy::VehicleV8 v = makeVehicleBlob();
+  v.pedalMin = 999; // Checksum no longer matches
+  seedVehicleBlob(nvs, v);
+  TEST_ASSERT_TRUE(begin(nvs));
+  Stats st;
+  getStats(st);
+  TEST_ASSERT_EQUAL_UINT8(0, st.legacyLayouts);
+  TEST_ASSERT_EQUAL_INT32(defaults().vehicle.pedalMin, vehicle().pedalMin);
+}
+
+void test_all_layouts_follow_precedence() {
+  FakeNvs nvs;
+  seedConfigManager(nvs);
+  seedEepromPersistence(nvs);
+  seedConfigStorage(nvs);
+  seedVehicleBlob(nvs, makeVehicleBlob());
+  size_t legacyBefore = legacyEntryCount(nvs);
+
+  TEST_ASSERT_TRUE(begin(nvs));
+  Stats st;
+  getStats(st);
+  TEST_ASSERT_EQUAL_UINT8(4, st.legacyLayouts);
+
+  // ConfigStorage > EEPROMPersistence > ConfigManager
+  TEST_ASSERT_EQUAL_INT16(630, encoder().center);
+  TEST_ASSERT_EQUAL_UINT16(6000, power().holdDelayMs);
+  TEST_ASSERT_EQUAL_UINT8(6, leds().pattern);
+  TEST_ASSERT_EQUAL_UINT16(800, power().tractionDelayMs);
+  // Keys only the older layouts had survive
+  TEST_ASSERT_TRUE(encoder().calibrated);               // EEPROMPersistence
+  TEST_ASSERT_EQUAL_UINT16(2500, power().shutdownDelayMs); // ConfigManager
+  TEST_ASSERT_EQUAL_UINT16(1234, general().menuPin);       // ConfigManager
+  TEST_ASSERT_EQUAL_UINT16(90, general().menuTimeoutSec);  // EEPROM > Manager
+  // Storage blob wins for the fields it owned
+  TEST_ASSERT_EQUAL_UINT8(55, vehicle().regenPercent);
+
+  // Legacy namespaces are left untouched (rollback to older firmware)
+  TEST_ASSERT_EQUAL_UINT32(legacyBefore, legacyEntryCount(nvs));
+
+  // And the migration does not run again
+  end();
+  nvs.resetCounters();
+  TEST_ASSERT_TRUE(begin(nvs));
+  getStats(st);
+  TEST_ASSERT_EQUAL_UINT8(0, st.migrationsRun);
+  TEST_ASSERT_EQUAL_INT(0, nvs.writes);
+  TEST_ASSERT_EQUAL_INT16(630, encoder().center);
+}
+
+void test_interrupted_migration_runs_again() {
+  FakeNvs nvs;
+  seedConfigStorage(nvs);
+  nvs.failAfter = 10; // Power lost part way through the rewrite
+  TEST_ASSERT_FALSE(begin(nvs));
+  end();
+
+  nvs.failAfter = -1;
+  nvs.resetCounters();
+  TEST_ASSERT_TRUE(begin(nvs));
+  Stats st;
+  getStats(st);
+  TEST_ASSERT_EQUAL_UINT16(0, st.version); // No version key was written
+  TEST_ASSERT_EQUAL_UINT8(1, st.migrationsRun);
+  TEST_ASSERT_EQUAL_UINT16(450, obstacle().warningMm);
+  TEST_ASSERT_EQUAL_HEX32(0x00FF00, leds().color);
+}
+
+void test_reset_to_defaults() {
+  FakeNvs nvs;
+  TEST_ASSERT_TRUE(begin(nvs));
+  leds().pattern = 9;
+  encoder().center = 700;
+  TEST_ASSERT_TRUE(commit());
+  TEST_ASSERT_TRUE(resetToDefaults());
+  TEST_ASSERT_EQUAL_UINT8(defaults().leds.pattern, leds().pattern);
+  end();
+
+  TEST_ASSERT_TRUE(begin(nvs));
+  TEST_ASSERT_EQUAL_INT16(defaults().encoder.center, encoder().center);
+  Stats st;
+  getStats(st);
+  TEST_ASSERT_EQUAL_UINT8(0, st.migrationsRun);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_fresh_boot_persists_defaults);
+  RUN_TEST(test_second_boot_scans_once_and_writes_nothing);
+  RUN_TEST(test_sections_load_lazily);
+  RUN_TEST(test_commit_writes_only_changed_keys);
+  RUN_TEST(test_out_of_range_value_resets_to_default);
+  RUN_TEST(test_migrates_config_manager);
+  RUN_TEST(test_config_manager_without_crc_is_ignored);
+  RUN_TEST(test_migrates_eeprom_persistence);
+  RUN_TEST(test_migrates_config_storage);
+  RUN_TEST(test_migrates_vehicle_blob);
+  RUN_TEST(test_corrupt_vehicle_blob_is_ignored);
+  RUN_TEST(test_all_layouts_follow_precedence);
+  RUN_TEST(test_interrupted_migration_runs_again);
+  RUN_TEST(test_reset_to_defaults);
+  return UNITY_END();
+}
@@ -0,0 +1,286 @@
+// ============================================================================
+// test_main.cpp - ErrorJournal recording, flush batching and concurrency
+// Run: pio test -e native -f test_error_journal
+//
+// Per-code counts and timestamps, the new-code hand-off that replaces the
+// per-call Storage::save(), exact counts with several producer threads
+// racing a flushing consumer, and a record() latency benchmark taken from
+// a 100 Hz "control" thread while other tasks flood the journal.
+// ============================================================================
+
+#include "error_journal.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+#include <thread>
+#include <unity.h>
+#include <vector>
+
+using namespace ErrorJournal;
+
+static std::vector<Entry> flushed;
+static void collect(const Entry &e) { flushed.push_back(e); }
+
+void setUp() {
+  clear();
+  flushed.clear();
+}
+void tearDown() {}
+
+void test_record_keeps_count_timestamps_and_context() {
+  TEST_ASSERT_TRUE(record(810, 1000, 0x11));
+  TEST_ASSERT_TRUE(record(810, 1500, 0x22));
+  TEST_ASSERT_TRUE(record(810, 2500, 0x33));
+
+  Entry e;
+  TEST_ASSERT_TRUE(get(810, e));
+  TEST_ASSERT_EQUAL_UINT16(810, e.code);
+  TEST_ASSERT_EQUAL_UINT32(3, e.count);
+  TEST_ASSERT_EQUAL_UINT32(1000, e.firstMs);
+  TEST_ASSERT_EQUAL_UINT32(2500, e.lastMs);
+  TEST_ASSERT_EQUAL_HEX32(0x33, e.context);
+  TEST_ASSERT_FALSE(get(811, e));
+}
+
+void test_code_zero_is_ignored() {
+  TEST_ASSERT_FALSE(record(0, 10));
+  Stats st;
+  getStats(st);
+  TEST_ASSERT_EQUAL_UINT32(0, st.recorded);
+  TEST_ASSERT_FALSE(pending());
+}
+
+void test_float_context_keeps_nan_bits() {
+  float nan = std::numeric_limits<float>::quiet_NaN();
+  record(310, 5, contextOf(nan));
+  Entry e;
+  get(310, e);
+  TEST_ASSERT_EQUAL_HEX32(0x7FC00000, e.context);
+  TEST_ASSERT_EQUAL_HEX32(0x42280000, contextOf(42.0f));
+}
+
+void test_flush_hands_new_codes_once_oldest_first() {
+  record(502, 300);
+  record(810, 100);
+  record(697, 200);
+  record(810, 400);
+  TEST_ASSERT_TRUE(pending());
+
+  TEST_ASSERT_EQUAL(3, flush(collect));
+  TEST_ASSERT_EQUAL(3, (int)flushed.size());
+  TEST_ASSERT_EQUAL_UINT16(810, flushed[0].code);
+  TEST_ASSERT_EQUAL_UINT16(697, flushed[1].code);
+  TEST_ASSERT_EQUAL_UINT16(502, flushed[2].code);
+  TEST_ASSERT_EQUAL_UINT32(2, flushed[0].count);
+  TEST_ASSERT_FALSE(pending());
+
+  // Repeats only: acknowledged, nothing new for the persistent log
+  record(810, 500);
+  record(502, 600);
+  TEST_ASSERT_TRUE(pending());
+  TEST_ASSERT_EQUAL(0, flush(collect));
+  TEST_ASSERT_FALSE(pending());
+  TEST_ASSERT_EQUAL(3, (int)flushed.size());
+
+  // Nothing at all: no work
+  TEST_ASSERT_EQUAL(0, flush(collect));
+  Stats st;
+  getStats(st);
+  TEST_ASSERT_EQUAL_UINT32(2, st.flushes);
+  TEST_ASSERT_EQUAL_UINT32(3, st.newCodes);
+}
+
+// What System::logError and LimpMode use between two flushes
+void test_new_code_is_flagged_and_unlogged_until_flushed() {
+  bool isNew = false;
+  TEST_ASSERT_TRUE(record(810, 100, 0, &isNew));
+  TEST_ASSERT_TRUE(isNew);
+  TEST_ASSERT_TRUE(record(810, 200, 0, &isNew));
+  TEST_ASSERT_FALSE(isNew);
+  record(697, 300, 0, &isNew);
+  TEST_ASSERT_TRUE(isNew);
+
+  uint16_t codes[CAPACITY];
+  TEST_ASSERT_EQUAL(2, unlogged(codes, CAPACITY));
+  TEST_ASSERT_EQUAL(1, unlogged(codes, 1));
+
+  flush(collect);
+  TEST_ASSERT_EQUAL(0, unlogged(codes, CAPACITY));
+  record(502, 400, 0, &isNew);
+  TEST_ASSERT_TRUE(isNew);
+  TEST_ASSERT_EQUAL(1, unlogged(codes, CAPACITY));
+  TEST_ASSERT_EQUAL_UINT16(502, codes[0]);
+
+  clear();
+  record(810, 500, 0, &isNew);
+  TEST_ASSERT_TRUE(isNew); // New again after clear()
+  TEST_ASSERT_EQUAL(1, unlogged(codes, CAPACITY));
+}
+
+// System::getDistinctErrorCount() over cfg.errors
+struct LogEntry {
+  uint16_t code;
+  uint32_t timestamp;
+};
+
+void test_distinct_count_adds_unlogged_codes_not_in_the_log() {
+  LogEntry log[4] = {{810, 1}, {697, 2}};
+  TEST_ASSERT_EQUAL_INT(2, distinctCount(log, 2, 4));
+
+  record(810, 100); // Persisted on an earlier boot: not counted twice
+  record(502, 200);
+  TEST_ASSERT_EQUAL_INT(3, distinctCount(log, 2, 4));
+  record(503, 300);
+  record(504, 400);
+  TEST_ASSERT_EQUAL_INT(4, distinctCount(log, 2, 4)); // Capped like the log
+
+  // Once flushed the log holds them: same count, none unlogged
+  flush(collect);
+  log[2] = {502, 200};
+  log[3] = {503, 300};
+  TEST_ASSERT_EQUAL_INT(4, distinctCount(log, 4, 4));
+  TEST_ASSERT_EQUAL_INT(0, distinctCount(log, 0, 4));
+}
+
+void test_full_table_drops_new_codes_but_counts_known_ones() {
+  for (uint16_t c = 1; c <= CAPACITY; c++) TEST_ASSERT_TRUE(record(c, c));
+  TEST_ASSERT_FALSE(record(CAPACITY + 1, 99));
+  TEST_ASSERT_TRUE(record(7, 100));
+
+  Stats st;
+  getStats(st);
+  TEST_ASSERT_EQUAL(CAPACITY, st.codes);
+  TEST_ASSERT_EQUAL_UINT32(1, st.dropped);
+
+  // Every code still resolves through its probe chain
+  for (uint16_t c = 1; c <= CAPACITY; c++) {
+    Entry e;
+    TEST_ASSERT_TRUE(get(c, e));
+    TEST_ASSERT_EQUAL_UINT32(c == 7 ? 2 : 1, e.count);
+  }
+}
+
+void test_snapshot_and_clear() {
+  record(100, 1);
+  record(200, 2);
+  Entry out[4];
+  TEST_ASSERT_EQUAL(2, snapshot(out, 4));
+  TEST_ASSERT_EQUAL(1, snapshot(out, 1));
+  clear();
+  TEST_ASSERT_EQUAL(0, snapshot(out, 4));
+  TEST_ASSERT_FALSE(pending());
+}
+
+// Three producers (control, sensors, TOFSense parser) on overlapping codes
+// while the consumer flushes: counts are exact and every code reaches the
+// persistent log exactly once
+void test_concurrent_producers_keep_exact_counts() {
+  constexpr int PRODUCERS = 3;
+  constexpr uint32_t PER_THREAD = 200000;
+  constexpr uint16_t CODES = 24;
+  std::atomic<bool> stop{false};
+
+  std::thread consumer([&] {
+    while (!stop.load()) flush(collect);
+  });
+  std::vector<std::thread> producers;
+  for (int t = 0; t < PRODUCERS; t++) {
+    producers.emplace_back([t] {
+      for (uint32_t i = 0; i < PER_THREAD; i++) {
+        record(uint16_t(800 + (i + t * 7) % CODES), i, uint32_t(t));
+      }
+    });
+  }
+  for (auto &p : producers) p.join();
+  stop.store(true);
+  consumer.join();
+  flush(collect);
+
+  uint64_t total = 0;
+  for (uint16_t c = 0; c < CODES; c++) {
+    Entry e;
+    TEST_ASSERT_TRUE(get(800 + c, e));
+    total += e.count;
+  }
+  TEST_ASSERT_EQUAL_UINT32(PRODUCERS * PER_THREAD, (uint32_t)total);
+  TEST_ASSERT_EQUAL(CODES, (int)flushed.size());
+  std::vector<uint16_t> codes;
+  for (const Entry &e : flushed) codes.push_back(e.code);
+  std::sort(codes.begin(), codes.end());
+  TEST_ASSERT_TRUE(std::unique(codes.begin(), codes.end()) == codes.end());
+}
+
+// Benchmark: logError() latency seen by the 100 Hz control job. Each control
+// cycle logs the four traction codes (the worst case of Traction::update()
+// with every sensor bad) while two other tasks flood new and repeated codes
+// and the journal job flushes. The old path could add a full NVS blob write
+// (milliseconds) to any of these calls; here none touches flash.
+void test_benchmark_record_latency_from_control_thread() {
+  using Clock = std::chrono::steady_clock;
+  constexpr uint32_t CYCLES = 20000;
+  std::atomic<bool> stop{false};
+
+  std::thread consumer([&] {
+    while (!stop.load()) flush(nullptr);
+  });
+  std::vector<std::thread> noise;
+  for (int t = 0; t < 2; t++) {
+    noise.emplace_back([&, t] {
+      uint32_t i = 0;
+      while (!stop.load()) {
+        record(uint16_t(300 + (i * 13 + t) % 48), i);
+        i++;
+      }
+    });
+  }
+
+  std::vector<uint32_t> ns;
+  ns.reserve(CYCLES * 4);
+  for (uint32_t cycle = 0; cycle < CYCLES; cycle++) {
+    for (uint16_t w = 0; w < 4; w++) {
+      auto t0 = Clock::now();
+      record(810 + w, cycle * 10, contextOf(75.0f + w));
+      auto t1 = Clock::now();
+      ns.push_back(uint32_t(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0)
+              .count()));
+    }
+  }
+  stop.store(true);
+  for (auto &t : noise) t.join();
+  consumer.join();
+
+  std::sort(ns.begin(), ns.end());
+  uint32_t p50 = ns[ns.size() / 2];
+  uint32_t p99 = ns[ns.size() * 99 / 100];
+  uint32_t p999 = ns[ns.size() * 999 / 1000];
+  uint32_t worst = ns.back();
+  printf("  record() from control thread, %u calls under contention:\n",
+         (unsigned)ns.size());
+  printf("  p50 %u ns, p99 %u ns, p99.9 %u ns, max %u ns\n", p50, p99, p999,
+         worst);
+
+  Entry e;
+  TEST_ASSERT_TRUE(get(813, e));
+  TEST_ASSERT_EQUAL_UINT32(CYCLES, e.count);
+  // Host numbers include OS preemption in the tail; the median is the
+  // lock-free fast path (find slot + three stores + two fetch_add)
+  TEST_ASSERT_LESS_THAN(5000, p50);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_record_keeps_count_timestamps_and_context);
+  RUN_TEST(test_code_zero_is_ignored);
+  RUN_TEST(test_float_context_keeps_nan_bits);
+  RUN_TEST(test_flush_hands_new_codes_once_oldest_first);
+  RUN_TEST(test_new_code_is_flagged_and_unlogged_until_flushed);
+  RUN_TEST(test_distinct_count_adds_unlogged_codes_not_in_the_log);
+  RUN_TEST(test_full_table_drops_new_codes_but_counts_known_ones);
+  RUN_TEST(test_snapshot_and_clear);
+  RUN_TEST(test_concurrent_producers_keep_exact_counts);
+  RUN_TEST(test_benchmark_record_latency_from_control_thread);
+  return UNITY_END();
+}
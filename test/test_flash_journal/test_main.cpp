@@ -0,0 +1,277 @@
+// ============================================================================
+// test_main.cpp - FlashJournal on simulated NOR flash (native host test)
+// Run: pio test -e native -f test_flash_journal
+//
+// SimFlash models NOR semantics (erase sets 0xFF, program only clears bits)
+// and can cut power after a byte budget: the interrupted write/erase is left
+// half done, every later operation fails, and the journal is remounted on
+// the same flash contents as after a reboot.
+// ============================================================================
+
+#include "flash_journal.h"
+#include <cstring>
+#include <unity.h>
+#include <vector>
+
+using namespace FlashJournal;
+
+class SimFlash : public FlashDevice {
+public:
+  explicit SimFlash(uint32_t sectors)
+      : mem(sectors * SECTOR_SIZE, 0x00), eraseCount(sectors, 0),
+        sectors_(sectors) {} // Factory content is not erased
+
+  uint32_t sectorCount() const override { return sectors_; }
+
+  bool read(uint32_t addr, void *dst, uint32_t len) override {
+    if (addr + len > mem.size()) return false;
+    memcpy(dst, &mem[addr], len);
+    return true;
+  }
+
+  bool write(uint32_t addr, const void *src, uint32_t len) override {
+    if (dead || addr + len > mem.size()) return false;
+    const uint8_t *p = static_cast<const uint8_t *>(src);
+    for (uint32_t i = 0; i < len; i++) {
+      if (!spend()) return false;
+      mem[addr + i] &= p[i];
+    }
+    return true;
+  }
+
+  bool eraseSector(uint32_t sector) override {
+    if (dead || sector >= sectors_) return false;
+    uint32_t base = sector * SECTOR_SIZE;
+    // Erase is modelled in 256-byte pages charged one budget unit each
+    for (uint32_t off = 0; off < SECTOR_SIZE; off += 256) {
+      if (!spend()) return false;
+      memset(&mem[base + off], 0xFF, 256);
+    }
+    eraseCount[sector]++;
+    return true;
+  }
+
+  // Power fails after `bytes` more programmed bytes / erased pages
+  void cutPowerAfter(long bytes) { budget = bytes; }
+  void powerOn() {
+    dead = false;
+    budget = -1;
+  }
+
+  std::vector<uint8_t> mem;
+  std::vector<uint32_t> eraseCount;
+  unsigned long units = 0; // Programmed bytes + erased pages so far
+  bool dead = false;
+
+private:
+  bool spend() {
+    units++;
+    if (budget < 0) return true;
+    if (budget == 0) {
+      dead = true;
+      return false;
+    }
+    budget--;
+    return true;
+  }
+
+  long budget = -1;
+  uint32_t sectors_;
+};
+
+struct Odometer {
+  uint32_t totalMeters;
+  uint32_t tripMeters;
+};
+
+static const uint8_t KEY_CONFIG = 7;
+static const uint8_t CONFIG_VALUE[24] = {1, 2,  3,  4,  5,  6,  7,  8,
+                                         9, 10, 11, 12, 13, 14, 15, 16,
+                                         17, 18, 19, 20, 21, 22, 23, 24};
+
+static bool appendOdometer(uint32_t meters) {
+  Odometer odo = {meters, meters % 1000};
+  return append(KEY_ODOMETER, &odo, sizeof(odo));
+}
+
+static uint32_t readOdometer() {
+  Odometer odo;
+  if (!read(KEY_ODOMETER, &odo, sizeof(odo))) return 0;
+  return odo.totalMeters;
+}
+
+void setUp() {}
+void tearDown() { end(); }
+
+// ----------------------------------------------------------------------------
+// Tests
+// ----------------------------------------------------------------------------
+
+void test_crc32_reference() {
+  TEST_ASSERT_EQUAL_HEX32(0xCBF43926, crc32(0, "123456789", 9));
+}
+
+void test_fresh_mount_and_replay() {
+  SimFlash flash(4);
+  TEST_ASSERT_TRUE(begin(flash));
+  TEST_ASSERT_FALSE(has(KEY_ODOMETER));
+
+  TEST_ASSERT_TRUE(appendOdometer(1500));
+  TEST_ASSERT_TRUE(append(KEY_CONFIG, CONFIG_VALUE, sizeof(CONFIG_VALUE)));
+  TEST_ASSERT_TRUE(appendOdometer(1510));
+
+  TEST_ASSERT_TRUE(begin(flash)); // Reboot
+  TEST_ASSERT_EQUAL_UINT32(1510, readOdometer());
+  uint8_t cfg[sizeof(CONFIG_VALUE)];
+  TEST_ASSERT_TRUE(read(KEY_CONFIG, cfg, sizeof(cfg)));
+  TEST_ASSERT_EQUAL_MEMORY(CONFIG_VALUE, cfg, sizeof(cfg));
+
+  Stats st;
+  getStats(st);
+  TEST_ASSERT_EQUAL_UINT32(3, st.replayedRecords);
+  TEST_ASSERT_EQUAL_UINT32(0, st.corruptRecords);
+  TEST_ASSERT_EQUAL_UINT8(2, st.liveKeys);
+}
+
+void test_identical_append_is_skipped() {
+  SimFlash flash(3);
+  TEST_ASSERT_TRUE(begin(flash));
+  TEST_ASSERT_TRUE(appendOdometer(42));
+  TEST_ASSERT_TRUE(appendOdometer(42));
+  Stats st;
+  getStats(st);
+  TEST_ASSERT_EQUAL_UINT32(1, st.appends);
+  TEST_ASSERT_EQUAL_UINT32(1, st.skippedAppends);
+}
+
+void test_wraparound_spreads_wear() {
+  const uint32_t SECTORS = 8;
+  SimFlash flash(SECTORS);
+  TEST_ASSERT_TRUE(begin(flash));
+  TEST_ASSERT_TRUE(append(KEY_CONFIG, CONFIG_VALUE, sizeof(CONFIG_VALUE)));
+
+  const uint32_t WRITES = 20000;
+  for (uint32_t i = 1; i <= WRITES; i++) {
+    TEST_ASSERT_TRUE(appendOdometer(i));
+    if (i % 16 == 0) service(); // Background job cadence
+  }
+  TEST_ASSERT_EQUAL_UINT32(WRITES, readOdometer());
+
+  Stats st;
+  getStats(st);
+  TEST_ASSERT_EQUAL_UINT32(0, st.writeErrors);
+  TEST_ASSERT_EQUAL_UINT32(0, st.inlineCompactions);
+  TEST_ASSERT_GREATER_OR_EQUAL(RESERVE_SECTORS, st.erasedAhead);
+
+  uint32_t minErase = UINT32_MAX, maxErase = 0;
+  for (uint32_t s = 0; s < SECTORS; s++) {
+    if (flash.eraseCount[s] < minErase) minErase = flash.eraseCount[s];
+    if (flash.eraseCount[s] > maxErase) maxErase = flash.eraseCount[s];
+  }
+  // Ring order: every sector is erased within one lap of the others
+  TEST_ASSERT_GREATER_THAN(10, minErase);
+  TEST_ASSERT_LESS_OR_EQUAL(minErase + 2, maxErase);
+
+  // The config key written once survived every compaction
+  TEST_ASSERT_TRUE(begin(flash));
+  uint8_t cfg[sizeof(CONFIG_VALUE)];
+  TEST_ASSERT_TRUE(read(KEY_CONFIG, cfg, sizeof(cfg)));
+  TEST_ASSERT_EQUAL_MEMORY(CONFIG_VALUE, cfg, sizeof(cfg));
+  TEST_ASSERT_EQUAL_UINT32(WRITES, readOdometer());
+}
+
+void test_append_without_service_compacts_inline() {
+  SimFlash flash(3);
+  TEST_ASSERT_TRUE(begin(flash));
+  TEST_ASSERT_TRUE(append(KEY_CONFIG, CONFIG_VALUE, sizeof(CONFIG_VALUE)));
+  for (uint32_t i = 1; i <= 2000; i++) TEST_ASSERT_TRUE(appendOdometer(i));
+
+  Stats st;
+  getStats(st);
+  TEST_ASSERT_GREATER_THAN(0, st.inlineCompactions);
+  TEST_ASSERT_EQUAL_UINT32(0, st.writeErrors);
+  TEST_ASSERT_TRUE(begin(flash));
+  TEST_ASSERT_EQUAL_UINT32(2000, readOdometer());
+  TEST_ASSERT_TRUE(has(KEY_CONFIG));
+}
+
+void test_garbage_sector_is_reclaimed() {
+  SimFlash flash(4);
+  // Unformatted partition (all zero) mounts and starts fresh
+  TEST_ASSERT_TRUE(begin(flash));
+  TEST_ASSERT_TRUE(appendOdometer(7));
+  while (service()) {
+  }
+  Stats st;
+  getStats(st);
+  TEST_ASSERT_GREATER_OR_EQUAL(RESERVE_SECTORS, st.erasedAhead);
+
+  TEST_ASSERT_TRUE(begin(flash));
+  TEST_ASSERT_EQUAL_UINT32(7, readOdometer());
+}
+
+// Cut power at every point of a write/compaction sequence and check that
+// after reboot: the odometer is never older than the last acknowledged
+// append, never newer than the one in flight, and the config key survives.
+static void runSequence(SimFlash &flash, uint32_t from, uint32_t steps,
+                        uint32_t &lastAcked) {
+  for (uint32_t i = 0; i < steps && !flash.dead; i++) {
+    if (appendOdometer(from + i)) lastAcked = from + i;
+    if (i % 8 == 7) service();
+  }
+}
+
+void test_power_cut_sweep() {
+  const uint32_t SECTORS = 3;
+  const uint32_t PRELOAD = 150; // Head close to the end of the ring
+  const uint32_t STEPS = 400;   // Covers several rolls and compactions
+
+  SimFlash probe(SECTORS);
+  TEST_ASSERT_TRUE(begin(probe));
+  append(KEY_CONFIG, CONFIG_VALUE, sizeof(CONFIG_VALUE));
+  uint32_t acked = 0;
+  runSequence(probe, 1, PRELOAD, acked);
+  unsigned long before = probe.units;
+  runSequence(probe, PRELOAD + 1, STEPS, acked);
+  long total = (long)(probe.units - before);
+  TEST_ASSERT_GREATER_THAN(SECTOR_SIZE, total);
+
+  uint32_t cuts = 0;
+  for (long cut = 0; cut <= total; cut++) {
+    SimFlash flash(SECTORS);
+    TEST_ASSERT_TRUE(begin(flash));
+    append(KEY_CONFIG, CONFIG_VALUE, sizeof(CONFIG_VALUE));
+    uint32_t lastAcked = 0;
+    runSequence(flash, 1, PRELOAD, lastAcked);
+
+    flash.cutPowerAfter(cut);
+    runSequence(flash, PRELOAD + 1, STEPS, lastAcked);
+    flash.powerOn();
+
+    TEST_ASSERT_TRUE(begin(flash)); // Reboot
+    uint32_t odo = readOdometer();
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(lastAcked, odo);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(lastAcked + 1, odo);
+    uint8_t cfg[sizeof(CONFIG_VALUE)];
+    TEST_ASSERT_TRUE(read(KEY_CONFIG, cfg, sizeof(cfg)));
+    TEST_ASSERT_EQUAL_MEMORY(CONFIG_VALUE, cfg, sizeof(cfg));
+
+    // The journal keeps working after the reboot
+    TEST_ASSERT_TRUE(appendOdometer(odo + 1));
+    TEST_ASSERT_EQUAL_UINT32(odo + 1, readOdometer());
+    cuts++;
+  }
+  TEST_ASSERT_GREATER_THAN(100, cuts);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_crc32_reference);
+  RUN_TEST(test_fresh_mount_and_replay);
+  RUN_TEST(test_identical_append_is_skipped);
+  RUN_TEST(test_wraparound_spreads_wear);
+  RUN_TEST(test_append_without_service_compacts_inline);
+  RUN_TEST(test_garbage_sector_is_reclaimed);
+  RUN_TEST(test_power_cut_sweep);
+  return UNITY_END();
+}
@@ -0,0 +1,224 @@
+// ============================================================================
+// test_main.cpp - Adaptive HUD frame pacing
+// Run: pio test -e native -f test_frame_pacer
+//
+// Simulated HUD job ticks (the RTScheduler grid, optional jitter, a long
+// render pushing the next tick out): idle minimum refresh on a static
+// screen, immediate forced frames, bursts during motion with headroom,
+// stepping down under core or render load and back up, and no frames lost
+// to tick jitter. Prints frames per second per scenario against the fixed
+// 30 FPS of the old double 33 ms gate.
+// ============================================================================
+
+#include "frame_pacer.h"
+#include <cstdio>
+#include <unity.h>
+
+using namespace FramePacer;
+
+struct Profile {
+  float loadPct;     // Core 1 utilization reported by RTScheduler
+  uint32_t renderUs; // Cost of each frame
+  bool changing;     // Dashboard inputs move every tick (needle sweep)
+  const int8_t *jitter; // Release jitter per tick (ms), cycled; may be null
+  int jitterLen;
+};
+
+struct Sim {
+  Pacer pacer;
+  uint32_t grid = 1000; // Next release on the scheduler grid
+  uint32_t now = 1000;
+  uint32_t ticks = 0;
+  uint32_t rendered = 0;
+
+  // Runs the job for durationMs; returns frames rendered
+  uint32_t run(uint32_t durationMs, const Profile &p) {
+    uint32_t end = now + durationMs;
+    uint32_t frames = 0;
+    while (static_cast<int32_t>(now - end) < 0) {
+      if (p.changing) pacer.notifyChange(now);
+      uint32_t busyUntil = now;
+      if (pacer.shouldRender(now, p.loadPct)) {
+        pacer.frameDone(now, p.renderUs, p.changing);
+        busyUntil = now + p.renderUs / 1000;
+        frames++;
+      }
+      // Next release: next grid slot after the job returned (missed
+      // releases are dropped, as RTScheduler does)
+      do {
+        grid += TICK_MS;
+      } while (static_cast<int32_t>(grid - busyUntil) <= 0);
+      int jit = p.jitter ? p.jitter[ticks % p.jitterLen] : 0;
+      now = grid + jit;
+      ticks++;
+    }
+    rendered += frames;
+    return frames;
+  }
+};
+
+static const Profile STATIC_SCREEN = {30.0f, 4000, false, nullptr, 0};
+static const Profile MOTION = {40.0f, 5000, true, nullptr, 0};
+static const Profile MOTION_BUSY_CORE = {95.0f, 5000, true, nullptr, 0};
+static const Profile MOTION_SLOW_RENDER = {50.0f, 30000, true, nullptr, 0};
+
+void setUp() {}
+void tearDown() {}
+
+void test_static_screen_idles_at_minimum_refresh() {
+  Sim sim;
+  sim.run(1000, STATIC_SCREEN); // Settle after the first frame
+  uint32_t frames = sim.run(10000, STATIC_SCREEN);
+
+  printf("  static screen: %u frames in 10 s (old gate: 300)\n",
+         (unsigned)frames);
+  // ~5 FPS: one frame per IDLE_INTERVAL_MS
+  TEST_ASSERT_UINT32_WITHIN(2, 10000 / IDLE_INTERVAL_MS, frames);
+  TEST_ASSERT_TRUE(sim.pacer.mode(sim.now) == Mode::IDLE);
+  TEST_ASSERT_EQUAL_UINT32(0, sim.pacer.stats(sim.now).skippedFrames);
+}
+
+void test_first_tick_and_forced_frames_render_at_once() {
+  Pacer p;
+  TEST_ASSERT_TRUE(p.shouldRender(1000, 10.0f)); // First frame
+  p.frameDone(1000, 3000, true);
+
+  // Between slots: a forced frame does not wait for the next one
+  TEST_ASSERT_FALSE(p.shouldRender(1016, 10.0f));
+  p.requestFrame();
+  TEST_ASSERT_TRUE(p.shouldRender(1032, 10.0f));
+  p.frameDone(1032, 3000, false);
+  TEST_ASSERT_FALSE(p.shouldRender(1048, 10.0f)); // Consumed
+}
+
+void test_input_change_renders_within_one_active_interval() {
+  Sim sim;
+  sim.run(3000, STATIC_SCREEN);
+  TEST_ASSERT_TRUE(sim.pacer.mode(sim.now) == Mode::IDLE);
+
+  // Dashboard probe finds a change: frame within ACTIVE_INTERVAL_MS
+  uint32_t changedAt = sim.now;
+  sim.pacer.notifyChange(changedAt);
+  uint32_t waited = 0;
+  while (!sim.pacer.shouldRender(changedAt + waited, 30.0f)) {
+    waited += TICK_MS;
+    TEST_ASSERT_TRUE(waited <= ACTIVE_INTERVAL_MS);
+  }
+  TEST_ASSERT_TRUE(sim.pacer.mode(changedAt) == Mode::ACTIVE);
+}
+
+void test_motion_bursts_to_tick_rate_with_headroom() {
+  Sim sim;
+  // 30 FPS until headroom is proven (RECOVER_MS), then one frame per tick
+  uint32_t first = sim.run(1000, MOTION);
+  uint32_t burst = sim.run(2000, MOTION) / 2;
+  Stats s = sim.pacer.stats(sim.now);
+
+  printf("  needle sweep: %u fps first second, %u fps after (target %u)\n",
+         (unsigned)first, (unsigned)burst, (unsigned)s.targetFps);
+  TEST_ASSERT_TRUE(s.mode == Mode::BURST);
+  TEST_ASSERT_EQUAL_UINT8(0, s.loadLevel);
+  TEST_ASSERT_EQUAL_UINT32(1000 / TICK_MS, s.targetFps);
+  TEST_ASSERT_UINT32_WITHIN(2, 1000 / TICK_MS, burst);
+  TEST_ASSERT_UINT32_WITHIN(2, 1000 / TICK_MS, s.actualFps);
+  TEST_ASSERT_EQUAL_UINT32(0, s.skippedFrames);
+
+  // Motion stops: back to ACTIVE, then IDLE
+  sim.run(BURST_HOLD_MS + TICK_MS, STATIC_SCREEN);
+  TEST_ASSERT_TRUE(sim.pacer.mode(sim.now) == Mode::ACTIVE);
+  sim.run(ACTIVE_HOLD_MS, STATIC_SCREEN);
+  TEST_ASSERT_TRUE(sim.pacer.mode(sim.now) == Mode::IDLE);
+}
+
+void test_busy_core_degrades_and_recovers() {
+  Sim sim;
+  sim.run(3000, MOTION);
+  TEST_ASSERT_EQUAL_UINT8(0, sim.pacer.stats(sim.now).loadLevel);
+
+  // Core 1 saturated: one step per STEP_MS down to the slowest level
+  sim.run(STEP_MS * LADDER_LEVELS, MOTION_BUSY_CORE);
+  uint32_t loaded = sim.run(1000, MOTION_BUSY_CORE);
+  Stats s = sim.pacer.stats(sim.now);
+  printf("  busy core: %u fps (target %u)\n", (unsigned)loaded,
+         (unsigned)s.targetFps);
+  TEST_ASSERT_EQUAL_UINT8(LADDER_LEVELS - 1, s.loadLevel);
+  TEST_ASSERT_UINT32_WITHIN(1, 1000 / LADDER_MS[LADDER_LEVELS - 1], loaded);
+
+  // Load gone: one step up per RECOVER_MS back to bursts
+  sim.run(RECOVER_MS * LADDER_LEVELS + 500, MOTION);
+  s = sim.pacer.stats(sim.now);
+  TEST_ASSERT_EQUAL_UINT8(0, s.loadLevel);
+  TEST_ASSERT_EQUAL_UINT32(1000 / TICK_MS, s.targetFps);
+}
+
+void test_slow_render_settles_where_it_fits() {
+  Sim sim;
+  sim.run(3000, MOTION_SLOW_RENDER);
+  Stats s = sim.pacer.stats(sim.now);
+  uint32_t interval = LADDER_MS[s.loadLevel];
+
+  printf("  30 ms render: level %u, %u fps\n", (unsigned)s.loadLevel,
+         (unsigned)s.actualFps);
+  // Lowest level whose interval leaves a quarter free, and it stays there
+  TEST_ASSERT_TRUE(s.avgRenderUs * 4 <= interval * 1000 * 3);
+  TEST_ASSERT_TRUE(s.avgRenderUs * 4 > LADDER_MS[s.loadLevel - 1] * 1000 * 3);
+  uint8_t settled = s.loadLevel;
+  sim.run(5000, MOTION_SLOW_RENDER);
+  TEST_ASSERT_EQUAL_UINT8(settled, sim.pacer.stats(sim.now).loadLevel);
+  TEST_ASSERT_UINT32_WITHIN(1, 1000 / interval,
+                            sim.pacer.stats(sim.now).actualFps);
+}
+
+void test_tick_jitter_does_not_drop_frames() {
+  // Releases up to 5 ms early or late; core busy enough to hold 30 FPS
+  static const int8_t JITTER[] = {0, -3, 4, -5, 5, 1, -2, 3};
+  const Profile jittery = {70.0f, 4000, true, JITTER, 8};
+  Sim sim;
+  sim.run(1000, jittery);
+  uint32_t frames = sim.run(5000, jittery);
+  Stats s = sim.pacer.stats(sim.now);
+
+  printf("  jittered ticks: %u frames in 5 s, %u skipped\n", (unsigned)frames,
+         (unsigned)s.skippedFrames);
+  TEST_ASSERT_EQUAL_UINT8(START_LEVEL, s.loadLevel);
+  TEST_ASSERT_EQUAL_UINT32(0, s.skippedFrames);
+  TEST_ASSERT_UINT32_WITHIN(1, 5000 / ACTIVE_INTERVAL_MS, frames);
+}
+
+void test_overrun_counts_skipped_frames_once() {
+  const Profile active = {70.0f, 4000, true, nullptr, 0};
+  Sim sim;
+  sim.run(1000, active);
+  TEST_ASSERT_EQUAL_UINT32(0, sim.pacer.stats(sim.now).skippedFrames);
+
+  // One 100 ms frame (flash write on the bus, say): the next release is
+  // the grid tick after it, +112 ms. Slots +32 and +64 are lost, +96 is
+  // drawn late on that tick.
+  while (!sim.pacer.shouldRender(sim.now, active.loadPct)) {
+    sim.now += TICK_MS;
+  }
+  sim.pacer.frameDone(sim.now, 100000, true);
+  sim.now += 7 * TICK_MS;
+  sim.grid = sim.now;
+  TEST_ASSERT_TRUE(sim.pacer.shouldRender(sim.now, active.loadPct));
+  sim.pacer.frameDone(sim.now, active.renderUs, true);
+  uint32_t skipped = sim.pacer.stats(sim.now).skippedFrames;
+  TEST_ASSERT_EQUAL_UINT32(2, skipped);
+
+  // Re-phased: no further skips
+  sim.run(2000, active);
+  TEST_ASSERT_EQUAL_UINT32(skipped, sim.pacer.stats(sim.now).skippedFrames);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_static_screen_idles_at_minimum_refresh);
+  RUN_TEST(test_first_tick_and_forced_frames_render_at_once);
+  RUN_TEST(test_input_change_renders_within_one_active_interval);
+  RUN_TEST(test_motion_bursts_to_tick_rate_with_headroom);
+  RUN_TEST(test_busy_core_degrades_and_recovers);
+  RUN_TEST(test_slow_render_settles_where_it_fits);
+  RUN_TEST(test_tick_jitter_does_not_drop_frames);
+  RUN_TEST(test_overrun_counts_skipped_frames_once);
+  return UNITY_END();
+}
@@ -0,0 +1,293 @@
+// ============================================================================
+// test_main.cpp - GlyphAtlas baking, blitting and text-run diffing
+// Run: pio test -e native -f test_glyph_atlas
+//
+// A synthetic font stands in for TFT_eSPI font 4 (26 px high, 14 px digits).
+// The last test replays a speed/RPM trace and reports text rendering time per
+// frame on the host: drawString-style (clear box + rasterize every glyph
+// every frame) against atlas blits of the changed cells only.
+// ============================================================================
+
+#include "glyph_atlas.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <unity.h>
+
+using namespace GlyphAtlas;
+
+static const uint8_t FONT = 4;
+static const uint8_t FONT_H = 26;
+
+// Deterministic pattern per character; width like font 4
+class FakeFont : public Rasterizer {
+public:
+  uint32_t renders = 0;
+
+  uint8_t height(uint8_t) override { return FONT_H; }
+  uint8_t width(uint8_t, char ch) override { return ch == '-' ? 9 : 14; }
+  void render(uint8_t, char ch) override {
+    current_ = ch;
+    renders++;
+  }
+  bool pixel(int16_t x, int16_t y) override {
+    return ((x * 7 + y * 3 + current_) % 5) == 0;
+  }
+
+private:
+  char current_ = 0;
+};
+
+void test_bake_stores_masks_and_metrics() {
+  FakeFont font;
+  Atlas atlas;
+  TEST_ASSERT_TRUE(atlas.bake(font, FONT, "0123456789-"));
+  TEST_ASSERT_EQUAL_UINT8(11, atlas.glyphCount());
+  TEST_ASSERT_EQUAL_UINT16(11 * 2 * FONT_H, atlas.bytesUsed());
+  TEST_ASSERT_EQUAL_UINT8(FONT_H, atlas.height(FONT));
+
+  const Glyph *seven = atlas.find(FONT, '7');
+  TEST_ASSERT_NOT_NULL(seven);
+  font.render(FONT, '7');
+  for (uint8_t y = 0; y < seven->h; y++) {
+    for (uint8_t x = 0; x < seven->w; x++) {
+      TEST_ASSERT_EQUAL(font.pixel(x, y), atlas.bit(*seven, x, y));
+    }
+  }
+
+  TEST_ASSERT_TRUE(atlas.covers(FONT, "-120"));
+  TEST_ASSERT_FALSE(atlas.covers(FONT, "12.5"));
+  TEST_ASSERT_FALSE(atlas.covers(2, "1")); // Other font not baked
+  TEST_ASSERT_EQUAL_INT16(14 * 3 + 9, atlas.textWidth(FONT, "-120"));
+
+  // Baking again adds nothing
+  uint32_t renders = font.renders;
+  TEST_ASSERT_TRUE(atlas.bake(font, FONT, "0123"));
+  TEST_ASSERT_EQUAL_UINT32(renders, font.renders);
+  TEST_ASSERT_EQUAL_UINT8(11, atlas.glyphCount());
+}
+
+void test_bake_reports_full_atlas() {
+  FakeFont font;
+  Atlas atlas;
+  char charset[MAX_GLYPHS + 2];
+  for (uint8_t i = 0; i < MAX_GLYPHS + 1; i++) charset[i] = (char)('!' + i);
+  charset[MAX_GLYPHS + 1] = '\0';
+  // 49 glyphs x 52 bytes: storage runs out first
+  TEST_ASSERT_FALSE(atlas.bake(font, FONT, charset));
+  TEST_ASSERT_TRUE(atlas.glyphCount() > 0);
+  TEST_ASSERT_TRUE(atlas.bytesUsed() <= ATLAS_BYTES);
+  TEST_ASSERT_NOT_NULL(atlas.find(FONT, '!')); // Earlier glyphs stay usable
+}
+
+void test_blit_expands_colours_with_stride() {
+  FakeFont font;
+  Atlas atlas;
+  atlas.bake(font, FONT, "8");
+  const Glyph &g = *atlas.find(FONT, '8');
+
+  static uint16_t fb[20 * FONT_H];
+  for (uint16_t &px : fb) px = 0xAAAA;
+  atlas.blit(g, 0x07E0, 0x2124, fb, 20);
+  font.render(FONT, '8');
+  for (uint8_t y = 0; y < g.h; y++) {
+    for (uint8_t x = 0; x < g.w; x++) {
+      uint16_t expect = font.pixel(x, y) ? 0x07E0 : 0x2124;
+      TEST_ASSERT_EQUAL_UINT16(expect, fb[y * 20 + x]);
+    }
+    TEST_ASSERT_EQUAL_UINT16(0xAAAA, fb[y * 20 + 14]); // Past the cell
+  }
+
+  // Big-endian for pushImage() without swapped bytes
+  atlas.blit(g, 0x07E0, 0x2124, fb, g.w, true);
+  TEST_ASSERT_TRUE(fb[0] == 0xE007 || fb[0] == 0x2421);
+}
+
+void test_run_skips_unchanged_and_redraws_changed_cells() {
+  FakeFont font;
+  Atlas atlas;
+  atlas.bake(font, FONT, "0123456789-");
+  TextRun run(FONT, Align::CENTER, 75, 180);
+
+  // First draw: every cell, nothing to erase (caller cleared the box)
+  Plan p = run.plan(atlas, "12", 0x07E0, 0x2124);
+  TEST_ASSERT_FALSE(p.skip);
+  TEST_ASSERT_EQUAL_UINT8(2, p.cellCount);
+  TEST_ASSERT_EQUAL_UINT8(0, p.eraseCount);
+  TEST_ASSERT_EQUAL_INT16(75 - 14, p.cells[0].x);
+  TEST_ASSERT_EQUAL_INT16(180 - FONT_H / 2, p.cells[0].y);
+  run.commit("12", p);
+
+  p = run.plan(atlas, "12", 0x07E0, 0x2124);
+  TEST_ASSERT_TRUE(p.skip);
+  TEST_ASSERT_EQUAL_UINT32(0, p.pixels);
+
+  // 12 -> 13: only the last digit
+  p = run.plan(atlas, "13", 0x07E0, 0x2124);
+  TEST_ASSERT_EQUAL_UINT8(1, p.cellCount);
+  TEST_ASSERT_EQUAL_INT16(75, p.cells[0].x);
+  TEST_ASSERT_EQUAL_UINT32(14u * FONT_H, p.pixels);
+  run.commit("13", p);
+
+  // Colour change (speed zone): every cell again, same extent
+  p = run.plan(atlas, "13", 0xFFE0, 0x2124);
+  TEST_ASSERT_EQUAL_UINT8(2, p.cellCount);
+  TEST_ASSERT_EQUAL_UINT8(0, p.eraseCount);
+  run.commit("13", p);
+
+  // Something drew over the run
+  run.invalidate();
+  p = run.plan(atlas, "13", 0xFFE0, 0x2124);
+  TEST_ASSERT_FALSE(p.skip);
+  TEST_ASSERT_EQUAL_UINT8(2, p.cellCount);
+}
+
+void test_run_erases_what_shorter_text_leaves() {
+  FakeFont font;
+  Atlas atlas;
+  atlas.bake(font, FONT, "0123456789-");
+  TextRun run(FONT, Align::CENTER, 100, 50);
+
+  Plan p = run.plan(atlas, "100", 1, 0);
+  run.commit("100", p); // x 79..121
+
+  // "99" is centred at 86..114: both digits move, 7 px strips on each side
+  p = run.plan(atlas, "99", 1, 0);
+  TEST_ASSERT_EQUAL_UINT8(2, p.cellCount);
+  TEST_ASSERT_EQUAL_UINT8(2, p.eraseCount);
+  TEST_ASSERT_EQUAL_INT16(79, p.erase[0].x);
+  TEST_ASSERT_EQUAL_INT16(7, p.erase[0].w);
+  TEST_ASSERT_EQUAL_INT16(114, p.erase[1].x);
+  TEST_ASSERT_EQUAL_INT16(7, p.erase[1].w);
+  TEST_ASSERT_EQUAL_UINT32((2u * 14 + 2u * 7) * FONT_H, p.pixels);
+  run.commit("99", p);
+
+  // Left aligned: "99" -> "9" keeps the first digit, erases the second
+  TextRun left(FONT, Align::LEFT, 10, 50);
+  p = left.plan(atlas, "99", 1, 0);
+  left.commit("99", p);
+  p = left.plan(atlas, "9", 1, 0);
+  TEST_ASSERT_EQUAL_UINT8(0, p.cellCount);
+  TEST_ASSERT_EQUAL_UINT8(1, p.eraseCount);
+  TEST_ASSERT_EQUAL_INT16(24, p.erase[0].x);
+  TEST_ASSERT_EQUAL_INT16(14, p.erase[0].w);
+}
+
+void test_run_moving_anchor_redraws() {
+  FakeFont font;
+  Atlas atlas;
+  atlas.bake(font, FONT, "0123456789");
+  TextRun run(FONT, Align::CENTER, 70, 180);
+  Plan p = run.plan(atlas, "5", 1, 0);
+  run.commit("5", p);
+  run.moveTo(70, 180); // Same spot: still valid
+  TEST_ASSERT_TRUE(run.plan(atlas, "5", 1, 0).skip);
+  run.moveTo(410, 180);
+  TEST_ASSERT_FALSE(run.plan(atlas, "5", 1, 0).skip);
+}
+
+// Speed ramps 0..35 km/h and back, RPM follows; 30 FPS for 20 s
+static int traceValue(uint32_t frame, int max) {
+  uint32_t phase = frame % 600;
+  float t = phase < 300 ? phase / 300.0f : (600 - phase) / 300.0f;
+  return (int)(t * max);
+}
+
+void test_text_render_time_per_frame() {
+  FakeFont font;
+  Atlas atlas;
+  atlas.bake(font, FONT, "0123456789-");
+
+  const uint16_t W = 480;
+  static uint16_t fb[W * 320];
+  const uint32_t FRAMES = 600;
+  char buf[8];
+
+  // drawString path: clear the 50x22 box, walk the font, push every glyph
+  uint64_t basePixels = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  for (uint32_t f = 0; f < FRAMES; f++) {
+    for (int gauge = 0; gauge < 2; gauge++) {
+      int cx = gauge ? 410 : 70;
+      snprintf(buf, sizeof(buf), "%d", traceValue(f, gauge ? 400 : 35));
+      for (int y = 0; y < 22; y++) {
+        for (int x = 0; x < 50; x++) fb[(175 + y) * W + cx - 25 + x] = 0x2124;
+      }
+      basePixels += 50 * 22;
+      int x = cx - atlas.textWidth(FONT, buf) / 2;
+      for (const char *c = buf; *c; c++) {
+        uint8_t w = font.width(FONT, *c);
+        font.render(FONT, *c);
+        for (uint8_t gy = 0; gy < FONT_H; gy++) {
+          for (uint8_t gx = 0; gx < w; gx++) {
+            fb[(172 + gy) * W + x + gx] = font.pixel(gx, gy) ? 0x07E0 : 0x2124;
+          }
+        }
+        basePixels += (uint32_t)w * FONT_H;
+        x += w;
+      }
+    }
+  }
+  auto t1 = std::chrono::steady_clock::now();
+
+  // Atlas path: skip unchanged runs, blit changed cells only
+  TextRun runs[2] = {TextRun(FONT, Align::CENTER, 70, 185),
+                     TextRun(FONT, Align::CENTER, 410, 185)};
+  uint64_t runPixels = 0;
+  uint32_t skipped = 0;
+  for (uint32_t f = 0; f < FRAMES; f++) {
+    for (int gauge = 0; gauge < 2; gauge++) {
+      snprintf(buf, sizeof(buf), "%d", traceValue(f, gauge ? 400 : 35));
+      Plan p = runs[gauge].plan(atlas, buf, 0x07E0, 0x2124);
+      if (p.skip) {
+        skipped++;
+        continue;
+      }
+      for (uint8_t i = 0; i < p.eraseCount; i++) {
+        const Span &e = p.erase[i];
+        for (int y = 0; y < e.h; y++) {
+          for (int x = 0; x < e.w; x++) fb[(e.y + y) * W + e.x + x] = 0x2124;
+        }
+      }
+      for (uint8_t i = 0; i < p.cellCount; i++) {
+        const Cell &c = p.cells[i];
+        atlas.blit(*c.glyph, 0x07E0, 0x2124, &fb[c.y * W + c.x], W);
+      }
+      runPixels += p.pixels;
+      runs[gauge].commit(buf, p);
+    }
+  }
+  auto t2 = std::chrono::steady_clock::now();
+
+  double baseUs =
+      std::chrono::duration<double, std::micro>(t1 - t0).count() / FRAMES;
+  double runUs =
+      std::chrono::duration<double, std::micro>(t2 - t1).count() / FRAMES;
+  char msg[160];
+  snprintf(msg, sizeof(msg),
+           "text per frame (2 gauges): drawString-style %.2f us / %lu px, "
+           "atlas runs %.2f us / %lu px, %lu of %lu runs skipped",
+           baseUs, (unsigned long)(basePixels / FRAMES), runUs,
+           (unsigned long)(runPixels / FRAMES), (unsigned long)skipped,
+           (unsigned long)(FRAMES * 2));
+  TEST_MESSAGE(msg);
+
+  // Speed repeats most frames; RPM changes often but mostly in the last digit
+  TEST_ASSERT_TRUE(skipped > FRAMES / 3);
+  TEST_ASSERT_TRUE(runPixels * 4 < basePixels);
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_bake_stores_masks_and_metrics);
+  RUN_TEST(test_bake_reports_full_atlas);
+  RUN_TEST(test_blit_expands_colours_with_stride);
+  RUN_TEST(test_run_skips_unchanged_and_redraws_changed_cells);
+  RUN_TEST(test_run_erases_what_shorter_text_leaves);
+  RUN_TEST(test_run_moving_anchor_redraws);
+  RUN_TEST(test_text_render_time_per_frame);
+  return UNITY_END();
+}
@@ -0,0 +1,315 @@
+// ============================================================================
+// test_main.cpp - BASE layer per-widget change model
+// Run: pio test -e native -f test_hud_base_model
+//
+// Quantization to display resolution with hysteresis, exact keys for
+// discrete inputs, NaN readings and widgets under cleared rects. Then
+// cruise traces with sensor noise: dirty pixels per frame (what
+// RenderStats::dirtyPixels reports on the car) against redrawing every
+// widget whose raw input moved.
+// ============================================================================
+
+#include "hud_base_model.h"
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <unity.h>
+
+using namespace HudBaseModel;
+
+// Same layout as BASE_WIDGET_BOUNDS in hud.cpp
+static const Rect LAYOUT[WIDGET_COUNT] = {
+    {-3, 102, 146, 146}, // SPEED
+    {337, 102, 146, 146}, // RPM
+    {165, 75, 60, 80},    // WHEEL_FL
+    {255, 75, 60, 80},    // WHEEL_FR
+    {165, 195, 60, 80},   // WHEEL_RL
+    {255, 195, 60, 80},   // WHEEL_RR
+    {210, 145, 60, 80},   // STEERING
+    {200, 0, 80, 50},     // SYSTEM_STATE
+    {190, 45, 100, 60},   // GEAR
+    {5, 250, 70, 45},     // FEATURES
+    {420, 0, 50, 40},     // BATTERY
+    {420, 42, 55, 20},    // AMBIENT_TEMP
+    {200, 0, 80, 40},     // ERRORS
+    {290, 0, 120, 40},    // SENSOR_STATUS
+    {320, 260, 70, 25},   // TEMP_WARNING
+    {180, 290, 120, 20},  // MODE
+    {0, 300, 480, 18},    // PEDAL
+};
+
+static constexpr uint32_t SCREEN_PIXELS = 480 * 320;
+
+static uint32_t rng = 1;
+static uint32_t next() {
+  rng ^= rng << 13;
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return rng;
+}
+// Uniform noise in [-amplitude, amplitude]
+static float noise(float amplitude) {
+  return amplitude * ((next() % 20001) / 10000.0f - 1.0f);
+}
+
+static Inputs cruise() {
+  Inputs in = {};
+  in.speedKmh = 20.0f;
+  in.rpm = 230.0f;
+  in.pedalPercent = 35.0f;
+  in.wheelTemp[0] = in.wheelTemp[1] = 42.0f;
+  in.wheelTemp[2] = in.wheelTemp[3] = 40.0f;
+  for (float &e : in.wheelEffort) e = 30.0f;
+  in.batteryVolts = 24.5f;
+  in.ambientTemp = 22.0f;
+  in.maxTemp = 42.0f;
+  in.systemState = 2;
+  in.gear = 3;
+  in.sensorCurrentOK = 6;
+  in.sensorTempOK = 5;
+  in.sensorWheelOK = 4;
+  in.mode4x4 = true;
+  return in;
+}
+
+void setUp() { rng = 1; }
+void tearDown() {}
+
+void test_first_update_redraws_every_widget() {
+  Model model(LAYOUT);
+  Inputs in = cruise();
+  TEST_ASSERT_EQUAL_HEX32(ALL_WIDGETS, model.update(in));
+  TEST_ASSERT_EQUAL_HEX32(0, model.update(in));
+  TEST_ASSERT_EQUAL_UINT32(WIDGET_COUNT, model.redraws());
+}
+
+void test_speed_quantized_with_hysteresis() {
+  Model model(LAYOUT);
+  Inputs in = cruise();
+  model.update(in);
+
+  // Below display resolution, then past the rounding boundary but less
+  // than a step from the drawn value
+  in.speedKmh = 20.04f;
+  TEST_ASSERT_EQUAL_HEX32(0, model.update(in));
+  in.speedKmh = 20.09f;
+  TEST_ASSERT_EQUAL_HEX32(0, model.update(in));
+  in.speedKmh = 20.11f;
+  TEST_ASSERT_EQUAL_HEX32(bit(SPEED), model.update(in));
+  TEST_ASSERT_EQUAL_HEX32(bit(SPEED), model.changedKeys());
+
+  // Dithering around 20.05 stays on the 20.1 key
+  for (int i = 0; i < 100; i++) {
+    in.speedKmh = 20.05f + noise(0.04f);
+    TEST_ASSERT_EQUAL_HEX32(0, model.update(in));
+  }
+
+  // Slow drift still gets drawn, one step at a time
+  uint32_t steps = 0;
+  for (int i = 0; i <= 100; i++) {
+    in.speedKmh = 20.105f + i * 0.01f;
+    if (model.update(in) & bit(SPEED)) steps++;
+  }
+  TEST_ASSERT_EQUAL_UINT32(10, steps);
+}
+
+void test_each_widget_at_its_display_resolution() {
+  Model model(LAYOUT);
+  Inputs in = cruise();
+  model.update(in);
+
+  in.wheelTemp[0] = 42.9f; // 1 °C
+  TEST_ASSERT_EQUAL_HEX32(0, model.update(in));
+  in.wheelTemp[0] = 43.05f;
+  TEST_ASSERT_EQUAL_HEX32(bit(WHEEL_FL), model.update(in));
+
+  in.batteryVolts = 24.58f; // 0.1 V
+  TEST_ASSERT_EQUAL_HEX32(0, model.update(in));
+  in.batteryVolts = 24.61f;
+  TEST_ASSERT_EQUAL_HEX32(bit(BATTERY), model.update(in));
+
+  in.steerAngle = 0.45f; // 0.5°
+  TEST_ASSERT_EQUAL_HEX32(0, model.update(in));
+  in.steerAngle = 0.55f;
+  TEST_ASSERT_EQUAL_HEX32(bit(STEERING), model.update(in));
+
+  in.wheelEffort[3] = 31.1f; // 1 %
+  in.maxTemp = 43.1f;
+  TEST_ASSERT_EQUAL_HEX32(bit(WHEEL_RR) | bit(TEMP_WARNING),
+                          model.update(in));
+}
+
+void test_discrete_inputs_are_exact() {
+  Model model(LAYOUT);
+  Inputs in = cruise();
+  model.update(in);
+
+  in.errorCount = 1;
+  uint32_t redraw = model.update(in);
+  TEST_ASSERT_EQUAL_HEX32(bit(ERRORS), model.changedKeys());
+  TEST_ASSERT_TRUE(redraw & bit(ERRORS));
+
+  in.eco = true;
+  model.update(in);
+  TEST_ASSERT_EQUAL_HEX32(bit(FEATURES), model.changedKeys());
+
+  in.sensorTempOK = 4;
+  model.update(in);
+  TEST_ASSERT_EQUAL_HEX32(bit(SENSOR_STATUS), model.changedKeys());
+  TEST_ASSERT_EQUAL_HEX32(0, model.update(in));
+}
+
+// A sensor without a reading is drawn once as such, not every frame
+void test_nan_reading_does_not_flap() {
+  Model model(LAYOUT);
+  Inputs in = cruise();
+  model.update(in);
+
+  in.ambientTemp = std::numeric_limits<float>::quiet_NaN();
+  TEST_ASSERT_EQUAL_HEX32(bit(AMBIENT_TEMP), model.update(in));
+  TEST_ASSERT_EQUAL_HEX32(0, model.update(in));
+  in.ambientTemp = 22.0f;
+  TEST_ASSERT_EQUAL_HEX32(bit(AMBIENT_TEMP), model.update(in));
+
+  in.wheelTemp[2] = -999.0f; // Temperature sensors disabled
+  TEST_ASSERT_EQUAL_HEX32(bit(WHEEL_RL), model.update(in));
+  TEST_ASSERT_EQUAL_HEX32(0, model.update(in));
+}
+
+void test_cleared_rects_redraw_widgets_under_them() {
+  Model model(LAYOUT);
+  Inputs in = cruise();
+  model.update(in);
+
+  Rect battery = {430, 10, 5, 5};
+  TEST_ASSERT_EQUAL_HEX32(bit(BATTERY), model.invalidateUnder(&battery, 1));
+  TEST_ASSERT_EQUAL_HEX32(bit(BATTERY), model.update(in));
+  TEST_ASSERT_EQUAL_HEX32(0, model.changedKeys());
+
+  // A non-BASE layer went dirty: the compositor cleared the whole screen
+  Rect full = {0, 0, 480, 320};
+  model.invalidateUnder(&full, 1);
+  TEST_ASSERT_EQUAL_HEX32(ALL_WIDGETS, model.update(in));
+
+  // Car body redrawn: everything drawn on top of it goes again
+  Rect carBody = {175, 100, 130, 150};
+  TEST_ASSERT_EQUAL_HEX32(WHEEL_WIDGETS | bit(STEERING) | bit(GEAR),
+                          model.invalidateUnder(&carBody, 1));
+  model.update(in);
+
+  Rect empty = {100, 100, 0, 40};
+  TEST_ASSERT_EQUAL_HEX32(0, model.invalidateUnder(&empty, 1));
+}
+
+void test_pending_peeks_without_consuming() {
+  Model model(LAYOUT);
+  Inputs in = cruise();
+  TEST_ASSERT_EQUAL_HEX32(ALL_WIDGETS, model.pending(in));
+  model.update(in);
+  TEST_ASSERT_EQUAL_HEX32(0, model.pending(in));
+
+  // The frame pacer probes every tick; only update() takes keys as drawn
+  in.speedKmh += 1.0f;
+  model.invalidate(bit(MODE));
+  TEST_ASSERT_EQUAL_HEX32(bit(SPEED) | bit(MODE), model.pending(in));
+  TEST_ASSERT_EQUAL_HEX32(bit(SPEED) | bit(MODE), model.pending(in));
+  TEST_ASSERT_EQUAL_HEX32(bit(SPEED) | bit(MODE), model.update(in));
+  TEST_ASSERT_EQUAL_HEX32(0, model.pending(in));
+}
+
+// ---------------------------------------------------------------------------
+// Cruise traces: dirty pixels per frame
+// ---------------------------------------------------------------------------
+
+struct Trace {
+  const char *name;
+  float speed;      // Mean, km/h
+  float speedNoise; // ± km/h
+  float temp;       // Wheel temperature mean, °C
+  float battery;    // V
+};
+
+// Every widget whose raw input moved at all, as if each were redrawn on
+// any change
+static uint32_t rawChanges(const Inputs &a, const Inputs &b) {
+  uint32_t w = 0;
+  if (a.speedKmh != b.speedKmh) w |= bit(SPEED);
+  if (a.rpm != b.rpm) w |= bit(RPM);
+  for (int i = 0; i < 4; i++) {
+    if (a.wheelTemp[i] != b.wheelTemp[i] ||
+        a.wheelEffort[i] != b.wheelEffort[i]) {
+      w |= bit(static_cast<Widget>(WHEEL_FL + i));
+    }
+  }
+  if (a.steerFL != b.steerFL) w |= bit(WHEEL_FL);
+  if (a.steerFR != b.steerFR) w |= bit(WHEEL_FR);
+  if (a.batteryVolts != b.batteryVolts) w |= bit(BATTERY);
+  if (a.ambientTemp != b.ambientTemp) w |= bit(AMBIENT_TEMP);
+  if (a.maxTemp != b.maxTemp) w |= bit(TEMP_WARNING);
+  if (a.pedalPercent != b.pedalPercent) w |= bit(PEDAL);
+  return w;
+}
+
+void test_cruise_pushes_near_zero_pixels() {
+  // Means on a display step and right on a rounding boundary (worst case)
+  static const Trace traces[] = {
+      {"cruise", 20.0f, 0.05f, 42.0f, 24.5f},
+      {"cruise on boundary", 20.05f, 0.05f, 42.5f, 24.55f},
+  };
+  static constexpr int FRAMES = 30 * 60; // One minute at 30 FPS
+
+  printf("\n  %-20s %8s %12s %12s %10s\n", "trace", "redraws",
+         "model px/fr", "raw px/fr", "of screen");
+  for (const Trace &t : traces) {
+    Model model(LAYOUT);
+    Inputs in = cruise();
+    model.update(in);
+    Inputs prev = in;
+    uint64_t modelPixels = 0, rawPixels = 0;
+    uint32_t redraws = model.redraws();
+
+    for (int frame = 0; frame < FRAMES; frame++) {
+      in.speedKmh = t.speed + noise(t.speedNoise);
+      in.rpm = in.speedKmh * 11.5f;
+      in.pedalPercent = 35.0f + noise(0.3f);
+      in.steerFL = noise(0.2f);
+      in.steerFR = noise(0.2f);
+      in.steerAngle = (in.steerFL + in.steerFR) / 2.0f;
+      for (int i = 0; i < 4; i++) {
+        in.wheelTemp[i] = t.temp + noise(0.2f);
+        in.wheelEffort[i] = 30.0f + noise(0.4f);
+      }
+      in.batteryVolts = t.battery + noise(0.02f);
+      in.ambientTemp = 22.0f + noise(0.1f);
+      in.maxTemp = in.wheelTemp[0];
+      for (float temp : in.wheelTemp) in.maxTemp = fmaxf(in.maxTemp, temp);
+
+      modelPixels += model.dirtyPixels(model.update(in));
+      rawPixels += model.dirtyPixels(rawChanges(prev, in));
+      prev = in;
+    }
+    redraws = model.redraws() - redraws;
+
+    double modelAvg = (double)modelPixels / FRAMES;
+    double rawAvg = (double)rawPixels / FRAMES;
+    printf("  %-20s %8u %12.0f %12.0f %9.2f%%\n", t.name, (unsigned)redraws,
+           modelAvg, rawAvg, 100.0 * modelAvg / SCREEN_PIXELS);
+
+    // Under 1% of the screen per frame, against most of it redrawn raw
+    TEST_ASSERT_TRUE(modelAvg < SCREEN_PIXELS / 100);
+    TEST_ASSERT_TRUE(modelAvg * 20 < rawAvg);
+  }
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_first_update_redraws_every_widget);
+  RUN_TEST(test_speed_quantized_with_hysteresis);
+  RUN_TEST(test_each_widget_at_its_display_resolution);
+  RUN_TEST(test_discrete_inputs_are_exact);
+  RUN_TEST(test_nan_reading_does_not_flap);
+  RUN_TEST(test_cleared_rects_redraw_widgets_under_them);
+  RUN_TEST(test_pending_peeks_without_consuming);
+  RUN_TEST(test_cruise_pushes_near_zero_pixels);
+  return UNITY_END();
+}
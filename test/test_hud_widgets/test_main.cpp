@@ -0,0 +1,225 @@
+// ============================================================================
+// test_main.cpp - HudWidgets invalidation, hit-testing and pixel accounting
+// Run: pio test -e native -f test_hud_widgets
+//
+// Uses the real menu geometry to check what one interaction pushes: before
+// the widget tree every touch in these menus was a fillScreen (480x320 =
+// 153600 px) followed by a full redraw.
+// ============================================================================
+
+#include "hud_widgets.h"
+#include <unity.h>
+
+using namespace HudWidgets;
+
+static const int16_t W = 480;
+static const int16_t H = 320;
+static const uint32_t FULL_SCREEN = 480u * 320u;
+
+static const char *const ITEMS[10] = {"1", "2", "3", "4", "5",
+                                      "6", "7", "8", "9", "10"};
+
+// Stands in for render(): everything on screen, nothing dirty
+static void settle(Screen &s) {
+  s.markCleared();
+  for (uint8_t i = 0; i < s.count(); i++) s.at(i).clean();
+}
+
+void test_setters_only_dirty_on_change() {
+  Label label({20, 55, 200, 20}, "Wheel Sensors:");
+  ValueField value({300, 60, 80, 20}, "%ld ms");
+  label.clean();
+  value.clean();
+
+  TEST_ASSERT_FALSE(label.setText("Wheel Sensors:"));
+  TEST_ASSERT_FALSE(label.isDirty());
+  TEST_ASSERT_TRUE(label.setText("Status: 4/5"));
+  TEST_ASSERT_TRUE(label.isDirty());
+
+  TEST_ASSERT_TRUE(value.setValue(500));
+  value.clean();
+  TEST_ASSERT_FALSE(value.setValue(500));
+  TEST_ASSERT_FALSE(value.isDirty());
+
+  char buf[16];
+  value.format(buf, sizeof(buf));
+  TEST_ASSERT_EQUAL_STRING("500 ms", buf);
+
+  // Same colour again is not a change
+  value.setFg(0xFFFF);
+  TEST_ASSERT_FALSE(value.isDirty());
+  value.setFg(0xFFE0);
+  TEST_ASSERT_TRUE(value.isDirty());
+}
+
+void test_long_text_is_not_dirty_every_call() {
+  Label label({0, 0, 100, 20});
+  const char *tooLong = "0123456789012345678901234567890123456789ABCDEF";
+  label.setText(tooLong);
+  label.clean();
+  TEST_ASSERT_FALSE(label.setText(tooLong));
+}
+
+void test_slider_maps_touch_and_clamps() {
+  Slider s({40, 55, 240, 20}, 100, 10000, 100);
+  s.clean();
+
+  TEST_ASSERT_EQUAL_INT32(100, s.valueAt(0)); // Left of the bar
+  TEST_ASSERT_EQUAL_INT32(10000, s.valueAt(400));
+  TEST_ASSERT_EQUAL_INT32(5000, s.valueAt(40 + 119)); // Rounded to step
+
+  TEST_ASSERT_TRUE(s.touch(160, 60));
+  TEST_ASSERT_EQUAL_INT32(5100, s.value());
+  TEST_ASSERT_TRUE(s.isDirty());
+  s.clean();
+  TEST_ASSERT_FALSE(s.touch(160, 60)); // Same spot: no redraw
+  TEST_ASSERT_FALSE(s.touch(160, 90)); // Below the bar: miss
+  TEST_ASSERT_FALSE(s.isDirty());
+
+  TEST_ASSERT_TRUE(s.setValue(20000));
+  TEST_ASSERT_EQUAL_INT32(10000, s.value());
+  TEST_ASSERT_EQUAL_INT16(240, s.fillWidth());
+}
+
+void test_toggle_and_button_state() {
+  Toggle t({340, 60, 100, 35}, 0xF800);
+  Style st;
+  st.accent = 0x07E0;
+  t.setStyle(st);
+  t.clean();
+
+  TEST_ASSERT_TRUE(t.toggle());
+  TEST_ASSERT_TRUE(t.isOn());
+  TEST_ASSERT_EQUAL_UINT16(0x07E0, t.faceColor());
+  TEST_ASSERT_EQUAL_STRING("ON", t.text());
+  TEST_ASSERT_FALSE(t.setOn(true));
+
+  Button b({20, 270, 120, 40}, "SAVE");
+  b.clean();
+  TEST_ASSERT_FALSE(b.setLabel("SAVE"));
+  TEST_ASSERT_TRUE(b.setLabel("SAVED!"));
+  TEST_ASSERT_EQUAL_STRING("SAVED!", b.label());
+}
+
+void test_list_selection_dirties_two_rows() {
+  List list({60, 80, 360, 200}, 20, ITEMS, 10);
+  list.setSelected(0);
+  list.clean();
+
+  TEST_ASSERT_EQUAL_INT8(3, list.rowAt(100, 80 + 3 * 20 + 5));
+  TEST_ASSERT_EQUAL_INT8(-1, list.rowAt(30, 100)); // Left of the list
+  TEST_ASSERT_EQUAL_INT8(-1, list.rowAt(100, 290)); // Below it
+
+  TEST_ASSERT_TRUE(list.setSelected(3));
+  TEST_ASSERT_TRUE(list.isRowDirty(0));
+  TEST_ASSERT_TRUE(list.isRowDirty(3));
+  TEST_ASSERT_FALSE(list.isRowDirty(1));
+  TEST_ASSERT_EQUAL_UINT32(2u * 360u * 20u, list.dirtyPixels());
+
+  list.clean();
+  TEST_ASSERT_FALSE(list.setSelected(3));
+  TEST_ASSERT_EQUAL_UINT32(0, list.dirtyPixels());
+
+  list.invalidate(); // Whole list after another screen drew over it
+  TEST_ASSERT_EQUAL_UINT32(360u * 200u, list.dirtyPixels());
+}
+
+void test_hit_test_prefers_top_and_skips_passive() {
+  Screen s;
+  Label title({0, 0, 480, 40}, "TITLE");
+  Button under({100, 100, 100, 50}, "A");
+  Button over({150, 120, 100, 50}, "B");
+  s.add(title);
+  s.add(under);
+  s.add(over);
+
+  TEST_ASSERT_NULL(s.hitTest(10, 10)); // Labels are not touchable
+  TEST_ASSERT_EQUAL_PTR(&under, s.hitTest(110, 110));
+  TEST_ASSERT_EQUAL_PTR(&over, s.hitTest(160, 130)); // Later = on top
+  over.setEnabled(false);
+  TEST_ASSERT_EQUAL_PTR(&under, s.hitTest(160, 130));
+  TEST_ASSERT_NULL(s.hitTest(479, 319));
+}
+
+void test_screen_pixels_per_interaction() {
+  // Power menu: touching a slider redraws the bar and its value only
+  Screen power;
+  Label title({0, 0, 480, 40}, "POWER CONFIGURATION");
+  Slider hold({40, 55, 240, 20}, 100, 10000, 100);
+  ValueField holdValue({290, 55, 110, 20}, "%ld ms");
+  Button save({20, 265, 120, 40}, "SAVE");
+  power.add(title);
+  power.add(hold);
+  power.add(holdValue);
+  power.add(save);
+
+  // First show: clear + every widget
+  TEST_ASSERT_TRUE(power.needsClear());
+  TEST_ASSERT_TRUE(power.dirtyPixels(W, H) > FULL_SCREEN);
+  settle(power);
+  TEST_ASSERT_FALSE(power.isDirty());
+  TEST_ASSERT_EQUAL_UINT32(0, power.dirtyPixels(W, H));
+
+  hold.touch(160, 60);
+  holdValue.setValue(hold.value());
+  uint32_t px = power.dirtyPixels(W, H);
+  TEST_ASSERT_EQUAL_UINT32(240u * 20u + 110u * 20u, px);
+  TEST_ASSERT_LESS_THAN_UINT32(FULL_SCREEN / 20, px);
+  settle(power);
+
+  // Returning from another screen clears everything again
+  power.invalidateAll();
+  TEST_ASSERT_TRUE(power.needsClear());
+  TEST_ASSERT_TRUE(power.dirtyPixels(W, H) > FULL_SCREEN);
+}
+
+void test_frame_counts_outline_only() {
+  Frame box({60, 40, 360, 240});
+  TEST_ASSERT_EQUAL_UINT32(2u * 360u + 2u * 238u, box.dirtyPixels());
+  Frame rule({20, 42, 440, 1});
+  TEST_ASSERT_EQUAL_UINT32(440u, rule.dirtyPixels());
+  box.clean();
+  TEST_ASSERT_EQUAL_UINT32(0, box.dirtyPixels());
+}
+
+void test_stats_record_non_empty_renders() {
+  Screen s;
+  s.record(0, 0); // Nothing dirty: not a render
+  s.record(FULL_SCREEN, 12);
+  s.record(14400, 2);
+  const Screen::Stats &st = s.stats();
+  TEST_ASSERT_EQUAL_UINT32(2, st.renders);
+  TEST_ASSERT_EQUAL_UINT32(14, st.widgetsDrawn);
+  TEST_ASSERT_EQUAL_UINT32(FULL_SCREEN + 14400, st.pixelsPushed);
+  TEST_ASSERT_EQUAL_UINT32(14400, st.lastPixels);
+  TEST_ASSERT_EQUAL_UINT32(FULL_SCREEN, st.maxPixels);
+}
+
+void test_screen_capacity() {
+  Label label({0, 0, 10, 10});
+  Screen s;
+  for (uint8_t i = 0; i < MAX_WIDGETS; i++) {
+    TEST_ASSERT_TRUE(s.add(label)); // Only pointers are stored
+  }
+  TEST_ASSERT_FALSE(s.add(label));
+  s.clear();
+  TEST_ASSERT_EQUAL_UINT8(0, s.count());
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_setters_only_dirty_on_change);
+  RUN_TEST(test_long_text_is_not_dirty_every_call);
+  RUN_TEST(test_slider_maps_touch_and_clamps);
+  RUN_TEST(test_toggle_and_button_state);
+  RUN_TEST(test_list_selection_dirties_two_rows);
+  RUN_TEST(test_hit_test_prefers_top_and_skips_passive);
+  RUN_TEST(test_screen_pixels_per_interaction);
+  RUN_TEST(test_frame_counts_outline_only);
+  RUN_TEST(test_stats_record_non_empty_renders);
+  RUN_TEST(test_screen_capacity);
+  return UNITY_END();
+}
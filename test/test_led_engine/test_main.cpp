@@ -0,0 +1,175 @@
+// ============================================================================
+// test_main.cpp - LedEngine layers, compositing and WS2812 encoding
+// Run: pio test -e native -f test_led_engine
+//
+// Layer order and blending, the animations that keep state between frames
+// (scanner bounce, chase trail) and the RMT item stream the transmitter
+// clocks out.
+// ============================================================================
+
+#include "led_engine.h"
+#include <unity.h>
+
+using namespace LedEngine;
+
+static Tick tick(uint16_t step, bool blink = true) {
+  return {step * 50u, step, blink};
+}
+
+static void assertRgb(Rgb expected, Rgb actual) {
+  TEST_ASSERT_EQUAL_UINT8(expected.r, actual.r);
+  TEST_ASSERT_EQUAL_UINT8(expected.g, actual.g);
+  TEST_ASSERT_EQUAL_UINT8(expected.b, actual.b);
+}
+
+void test_colour_helpers_match_fastled() {
+  assertRgb(BLACK, fade(RED, 255));
+  assertRgb(RED, scale(RED, 255));
+  assertRgb({50, 0, 0}, scale(RED, 50)); // 255 * 51 / 256
+  assertRgb(RED, blend(RED, BLUE, 0));
+  assertRgb(BLUE, blend(RED, BLUE, 255));
+  assertRgb(RED, hue(0));
+  assertRgb({0, 255, 0}, hue(86));
+  assertRgb({0, 0, 255}, hue(172));
+}
+
+void test_empty_strip_is_black() {
+  Strip strip(10);
+  SolidLayer off(10, 0, 10); // Never enabled
+  strip.add(off);
+  off.set(RED);
+  Rgb out[10];
+  strip.compose(out, tick(1));
+  for (Rgb px : out) assertRgb(BLACK, px);
+}
+
+void test_higher_priority_draws_over_lower() {
+  Strip strip(16);
+  SolidLayer center(10, 3, 10);
+  BlinkerLayer left(30, 0, 3, AMBER);
+  SolidLayer emergency(90, 0, 16);
+  // Added out of order: the strip sorts by priority
+  strip.add(emergency);
+  strip.add(left);
+  strip.add(center);
+  TEST_ASSERT_EQUAL_UINT8(3, strip.layerCount());
+
+  center.setEnabled(true);
+  center.set(RED, 51);
+  left.setEnabled(true);
+  Rgb out[16];
+  strip.compose(out, tick(1, true));
+  assertRgb(AMBER, out[0]);
+  assertRgb(scale(RED, 51), out[3]);
+  assertRgb(BLACK, out[13]); // Nothing draws there
+
+  strip.compose(out, tick(2, false));
+  assertRgb(BLACK, out[0]); // Blinker off phase is opaque black
+
+  emergency.setEnabled(true);
+  emergency.set(WHITE);
+  strip.compose(out, tick(3, true));
+  for (Rgb px : out) assertRgb(WHITE, px);
+}
+
+void test_opacity_blends_with_layers_below() {
+  Strip strip(4);
+  SolidLayer base(10, 0, 4);
+  SolidLayer overlay(20, 0, 2);
+  strip.add(base);
+  strip.add(overlay);
+  base.setEnabled(true);
+  base.set(RED);
+  overlay.setEnabled(true);
+  overlay.set(BLUE);
+  overlay.setOpacity(127);
+
+  Rgb out[4];
+  strip.compose(out, tick(1));
+  TEST_ASSERT_TRUE(out[0].r > 100 && out[0].r < 150);
+  TEST_ASSERT_TRUE(out[0].b > 100 && out[0].b < 150);
+  assertRgb(RED, out[2]); // Outside the overlay range
+}
+
+void test_scanner_bounces_inside_strip() {
+  Strip strip(28);
+  ScannerLayer kitt(10, 4, 60);
+  strip.add(kitt);
+  kitt.setEnabled(true);
+  Rgb out[28];
+
+  int8_t maxPos = 0;
+  for (uint16_t s = 0; s < 120; s++) {
+    int8_t head = kitt.position();
+    strip.compose(out, tick(s));
+    assertRgb(RED, out[head]);
+    TEST_ASSERT_TRUE(kitt.position() >= 0 && kitt.position() < 28);
+    if (kitt.position() > maxPos) maxPos = kitt.position();
+  }
+  TEST_ASSERT_EQUAL_INT8(27, maxPos);
+
+  kitt.restart();
+  TEST_ASSERT_EQUAL_INT8(0, kitt.position());
+}
+
+void test_chase_keeps_fading_trail() {
+  Strip strip(28);
+  ChaseLayer chase(10, 30);
+  strip.add(chase);
+  chase.setEnabled(true);
+  chase.set(ORANGE, 1);
+  Rgb out[28];
+  for (uint16_t s = 0; s <= 10; s++) strip.compose(out, tick(s));
+  assertRgb(ORANGE, out[10]);          // Head
+  assertRgb(fade(ORANGE, 50), out[9]); // Comet tail
+  TEST_ASSERT_TRUE(out[3].r > 0);      // Older trail fading out
+  TEST_ASSERT_TRUE(out[3].r < fade(ORANGE, 200).r + 60);
+  assertRgb(BLACK, out[11]);
+}
+
+void test_sequential_blinker_walks() {
+  Strip strip(3);
+  BlinkerLayer turn(30, 0, 3, AMBER);
+  strip.add(turn);
+  turn.setEnabled(true);
+  turn.setSequential(true);
+  Rgb out[3];
+  strip.compose(out, tick(25, true)); // (25 / 10) % 3 = 2
+  assertRgb(BLACK, out[0]);
+  assertRgb(AMBER, out[2]);
+}
+
+void test_encode_grb_msb_first_with_brightness() {
+  uint32_t items[BITS_PER_PIXEL * 2];
+  Rgb px[2] = {{0x00, 0x80, 0x01}, WHITE};
+  TEST_ASSERT_EQUAL_UINT16(48, encodeWs2812(px, 2, 255, items));
+
+  const uint32_t one = T1H_TICKS | (1u << 15) | (T1L_TICKS << 16);
+  const uint32_t zero = T0H_TICKS | (1u << 15) | (T0L_TICKS << 16);
+  // Green 0x80 first: one then seven zeros
+  TEST_ASSERT_EQUAL_HEX32(one, items[0]);
+  for (int i = 1; i < 8; i++) TEST_ASSERT_EQUAL_HEX32(zero, items[i]);
+  for (int i = 8; i < 16; i++) TEST_ASSERT_EQUAL_HEX32(zero, items[i]); // R
+  TEST_ASSERT_EQUAL_HEX32(one, items[23]); // B = 0x01, last bit
+
+  // Half brightness: 255 -> 127 = 0b01111111
+  encodeWs2812(&px[1], 1, 127, items);
+  TEST_ASSERT_EQUAL_HEX32(zero, items[0]);
+  TEST_ASSERT_EQUAL_HEX32(one, items[1]);
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_colour_helpers_match_fastled);
+  RUN_TEST(test_empty_strip_is_black);
+  RUN_TEST(test_higher_priority_draws_over_lower);
+  RUN_TEST(test_opacity_blends_with_layers_below);
+  RUN_TEST(test_scanner_bounces_inside_strip);
+  RUN_TEST(test_chase_keeps_fading_trail);
+  RUN_TEST(test_sequential_blinker_walks);
+  RUN_TEST(test_encode_grb_msb_first_with_brightness);
+  return UNITY_END();
+}
@@ -0,0 +1,240 @@
+// ============================================================================
+// test_main.cpp - LimpMode rules: incremental groups against the full chain
+// Run: pio test -e native -f test_limp_rules
+//
+// RuleSet (per-group results, re-evaluated only for flagged groups) must
+// give the same state as evaluateAll(), the CRITICAL -> LIMP -> DEGRADED
+// chain LimpMode used to run every tick. Checked exhaustively over the
+// input space at the thresholds, then as a property over random input
+// sequences with the change flags LimpMode derives, spurious flags included.
+// ============================================================================
+
+#include "limp_rules.h"
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <unity.h>
+
+using namespace LimpMode;
+
+static const char *const STATE_NAMES[] = {"NORMAL", "DEGRADED", "LIMP",
+                                          "CRITICAL"};
+
+// Battery readings at and around every threshold, plus "no reading"
+static const float BATTERY_VALUES[] = {
+    std::numeric_limits<float>::quiet_NaN(),
+    -1.0f,
+    0.0f,
+    0.001f,
+    17.99f,
+    Thresholds::BATTERY_CRITICAL,
+    18.01f,
+    19.99f,
+    Thresholds::BATTERY_UNDERVOLTAGE,
+    20.01f,
+    24.5f,
+    std::numeric_limits<float>::infinity()};
+static constexpr int BATTERY_COUNT =
+    sizeof(BATTERY_VALUES) / sizeof(BATTERY_VALUES[0]);
+
+static uint32_t rng = 1;
+static uint32_t next() {
+  rng ^= rng << 13;
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return rng;
+}
+static bool chance(uint32_t percent) { return next() % 100 < percent; }
+
+static RuleInputs healthy() {
+  RuleInputs in = {};
+  in.pedalValid = true;
+  in.steeringValid = true;
+  in.steeringCentered = true;
+  in.batteryVoltage = 24.5f;
+  return in;
+}
+
+// The groups whose inputs differ, as LimpMode::update() flags them
+static uint8_t changedGroups(const RuleInputs &a, const RuleInputs &b) {
+  uint8_t g = 0;
+  if (a.pedalValid != b.pedalValid || a.steeringValid != b.steeringValid ||
+      a.steeringCentered != b.steeringCentered) {
+    g |= GROUP_INPUTS;
+  }
+  // NaN != NaN: a missing reading re-flags every sample, as on the car
+  if (a.batteryVoltage != b.batteryVoltage) g |= GROUP_BATTERY;
+  if (a.temperatureWarning != b.temperatureWarning ||
+      a.temperatureCritical != b.temperatureCritical) {
+    g |= GROUP_TEMPERATURE;
+  }
+  if (a.systemErrorCount != b.systemErrorCount) g |= GROUP_ERRORS;
+  return g;
+}
+
+static void assertSame(const RuleInputs &in, LimpState got, uint32_t seed,
+                       uint32_t step) {
+  LimpState want = evaluateAll(in);
+  if (got == want) return;
+  char msg[200];
+  snprintf(msg, sizeof(msg),
+           "seed %u step %u: pedal=%d steer=%d centered=%d batt=%g warn=%d "
+           "crit=%d errors=%u -> %s, reference %s",
+           (unsigned)seed, (unsigned)step, in.pedalValid, in.steeringValid,
+           in.steeringCentered, (double)in.batteryVoltage,
+           in.temperatureWarning, in.temperatureCritical,
+           (unsigned)in.systemErrorCount, STATE_NAMES[(int)got],
+           STATE_NAMES[(int)want]);
+  TEST_FAIL_MESSAGE(msg);
+}
+
+void setUp() { rng = 1; }
+void tearDown() {}
+
+void test_reference_examples() {
+  RuleInputs in = healthy();
+  TEST_ASSERT_EQUAL(LimpState::NORMAL, evaluateAll(in));
+
+  in.pedalValid = false;
+  TEST_ASSERT_EQUAL(LimpState::LIMP, evaluateAll(in));
+  in.steeringValid = false;
+  TEST_ASSERT_EQUAL(LimpState::CRITICAL, evaluateAll(in));
+
+  in = healthy();
+  in.batteryVoltage = 19.0f;
+  TEST_ASSERT_EQUAL(LimpState::LIMP, evaluateAll(in));
+  in.batteryVoltage = 0.0f; // INA226 offline: ignored
+  TEST_ASSERT_EQUAL(LimpState::NORMAL, evaluateAll(in));
+
+  in = healthy();
+  in.systemErrorCount = 1;
+  TEST_ASSERT_EQUAL(LimpState::DEGRADED, evaluateAll(in));
+  in.systemErrorCount = 5;
+  TEST_ASSERT_EQUAL(LimpState::CRITICAL, evaluateAll(in));
+}
+
+// Every combination: 5 flags x battery values x error counts 0..6
+void test_groups_match_reference_exhaustively() {
+  uint32_t cases = 0;
+  for (uint8_t flags = 0; flags < 32; flags++) {
+    for (int b = 0; b < BATTERY_COUNT; b++) {
+      for (uint8_t errors = 0; errors <= 6; errors++) {
+        RuleInputs in = {};
+        in.pedalValid = flags & 1;
+        in.steeringValid = flags & 2;
+        in.steeringCentered = flags & 4;
+        in.temperatureWarning = flags & 8;
+        in.temperatureCritical = flags & 16;
+        in.batteryVoltage = BATTERY_VALUES[b];
+        in.systemErrorCount = errors;
+
+        RuleSet rules;
+        assertSame(in, rules.update(in, GROUP_ALL), 0, cases);
+        cases++;
+      }
+    }
+  }
+  TEST_ASSERT_EQUAL_UINT32(32 * BATTERY_COUNT * 7, cases);
+}
+
+// Random drives: a few inputs change per tick, only their groups (plus
+// some spurious flags) are re-evaluated, the state must always agree
+void test_incremental_matches_reference_over_random_sequences() {
+  static constexpr uint32_t SEQUENCES = 400;
+  static constexpr uint32_t STEPS = 2000;
+  uint64_t evaluations = 0;
+
+  for (uint32_t seed = 1; seed <= SEQUENCES; seed++) {
+    rng = seed * 2654435761u;
+    RuleInputs in = healthy();
+    RuleSet rules;
+    rules.update(in, GROUP_ALL);
+
+    for (uint32_t step = 0; step < STEPS; step++) {
+      RuleInputs prev = in;
+      if (chance(3)) in.pedalValid = !in.pedalValid;
+      if (chance(3)) in.steeringValid = !in.steeringValid;
+      if (chance(2)) in.steeringCentered = !in.steeringCentered;
+      if (chance(20)) {
+        in.batteryVoltage = chance(60)
+                                ? BATTERY_VALUES[next() % BATTERY_COUNT]
+                                : 15.0f + (next() % 1200) / 100.0f;
+      }
+      if (chance(4)) in.temperatureWarning = !in.temperatureWarning;
+      if (chance(4)) in.temperatureCritical = !in.temperatureCritical;
+      if (chance(5)) in.systemErrorCount = next() % 8;
+
+      uint8_t changed = changedGroups(prev, in);
+      if (chance(10)) changed |= 1 << (next() % 4); // Spurious notification
+      assertSame(in, rules.update(in, changed), seed, step);
+      TEST_ASSERT_EQUAL(rules.update(in, 0), rules.required());
+    }
+    evaluations += rules.evaluations();
+  }
+
+  printf("  %u sequences x %u steps: %llu group evaluations, %.2f per tick "
+         "(full re-evaluation: 4)\n",
+         (unsigned)SEQUENCES, (unsigned)STEPS,
+         (unsigned long long)evaluations,
+         (double)evaluations / (SEQUENCES * STEPS));
+}
+
+void test_only_flagged_groups_are_evaluated() {
+  RuleInputs in = healthy();
+  RuleSet rules;
+  rules.update(in, GROUP_ALL);
+  TEST_ASSERT_EQUAL_UINT32(4, rules.evaluations());
+
+  rules.update(in, 0);
+  TEST_ASSERT_EQUAL_UINT32(4, rules.evaluations());
+
+  in.batteryVoltage = 19.0f;
+  TEST_ASSERT_EQUAL(LimpState::LIMP, rules.update(in, GROUP_BATTERY));
+  TEST_ASSERT_EQUAL_UINT32(5, rules.evaluations());
+
+  in.temperatureCritical = true;
+  TEST_ASSERT_EQUAL(LimpState::CRITICAL,
+                    rules.update(in, GROUP_TEMPERATURE | GROUP_ERRORS));
+  TEST_ASSERT_EQUAL_UINT32(7, rules.evaluations());
+
+  // Worst group recovering leaves the next worst in charge
+  in.temperatureCritical = false;
+  TEST_ASSERT_EQUAL(LimpState::LIMP, rules.update(in, GROUP_TEMPERATURE));
+  in.batteryVoltage = 24.0f;
+  TEST_ASSERT_EQUAL(LimpState::NORMAL, rules.update(in, GROUP_BATTERY));
+}
+
+// A change nobody flagged stays invisible until the periodic full refresh
+void test_missed_notification_is_caught_by_full_refresh() {
+  RuleInputs in = healthy();
+  RuleSet rules;
+  rules.update(in, GROUP_ALL);
+
+  in.systemErrorCount = 3;
+  TEST_ASSERT_EQUAL(LimpState::NORMAL, rules.update(in, GROUP_BATTERY));
+  TEST_ASSERT_EQUAL(LimpState::LIMP, rules.update(in, GROUP_ALL));
+  TEST_ASSERT_EQUAL(evaluateAll(in), rules.required());
+}
+
+void test_nan_battery_never_degrades() {
+  RuleInputs in = healthy();
+  RuleSet rules;
+  in.batteryVoltage = std::numeric_limits<float>::quiet_NaN();
+  TEST_ASSERT_EQUAL(LimpState::NORMAL, rules.update(in, GROUP_ALL));
+  TEST_ASSERT_EQUAL(LimpState::NORMAL, evaluateAll(in));
+  in.batteryVoltage = 17.0f;
+  TEST_ASSERT_EQUAL(LimpState::CRITICAL, rules.update(in, GROUP_BATTERY));
+  in.batteryVoltage = std::numeric_limits<float>::quiet_NaN();
+  TEST_ASSERT_EQUAL(LimpState::NORMAL, rules.update(in, GROUP_BATTERY));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_reference_examples);
+  RUN_TEST(test_groups_match_reference_exhaustively);
+  RUN_TEST(test_incremental_matches_reference_over_random_sequences);
+  RUN_TEST(test_only_flagged_groups_are_evaluated);
+  RUN_TEST(test_missed_notification_is_caught_by_full_refresh);
+  RUN_TEST(test_nan_battery_never_degrades);
+  return UNITY_END();
+}
@@ -0,0 +1,277 @@
+// ============================================================================
+// test_main.cpp - One render backend: frame cost against the two engines
+// Run: pio test -e native -f test_render_backend
+//
+// The HUD used to draw the car body and the steering wheel into two
+// full-screen RenderEngine sprites, each pushing the bounding box of its
+// dirty marks on its own, next to the compositor's layers. Now both are
+// BASE widgets and every pixel goes through the compositor's dirty rects.
+// A drive trace (speed ramp, steering sweeps, noisy temperatures) runs
+// through the real BASE model and both frame shapes are replayed on host
+// surfaces: pixels pushed, modelled SPI time (TearSync::PushOrder costs),
+// host time per frame and the PSRAM budget.
+// ============================================================================
+
+#include "hud_base_model.h"
+#include "sprite_pool.h"
+#include "tear_sync.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <unity.h>
+#include <vector>
+
+using namespace HudBaseModel;
+
+static constexpr int W = 480;
+static constexpr int H = 320;
+
+// Same layout as BASE_WIDGET_BOUNDS in hud.cpp
+static const Rect LAYOUT[WIDGET_COUNT] = {
+    {-3, 102, 146, 146},  // SPEED
+    {337, 102, 146, 146}, // RPM
+    {165, 75, 60, 80},    // WHEEL_FL
+    {255, 75, 60, 80},    // WHEEL_FR
+    {165, 195, 60, 80},   // WHEEL_RL
+    {255, 195, 60, 80},   // WHEEL_RR
+    {210, 145, 60, 80},   // STEERING
+    {200, 0, 80, 50},     // SYSTEM_STATE
+    {190, 45, 100, 60},   // GEAR
+    {5, 250, 70, 45},     // FEATURES
+    {420, 0, 50, 40},     // BATTERY
+    {420, 42, 55, 20},    // AMBIENT_TEMP
+    {200, 0, 80, 40},     // ERRORS
+    {290, 0, 120, 40},    // SENSOR_STATUS
+    {320, 260, 70, 25},   // TEMP_WARNING
+    {180, 290, 120, 20},  // MODE
+    {0, 300, 480, 18},    // PEDAL
+};
+static const Rect CAR_BODY = {175, 100, 130, 150};
+
+// Compositor layers + shadow, before and after (HudCompositor::SPRITE_BUDGET)
+static constexpr uint8_t TWO_ENGINE_SPRITES = 5 + 1 + 2; // + CAR_BODY, STEERING
+static constexpr uint8_t MERGED_SPRITES = 5 + 1;
+
+static uint32_t rng = 1;
+static uint32_t next() {
+  rng ^= rng << 13;
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return rng;
+}
+static float noise(float amplitude) {
+  return amplitude * ((next() % 20001) / 10000.0f - 1.0f);
+}
+
+void setUp() { rng = 1; }
+void tearDown() {}
+
+// ---------------------------------------------------------------------------
+// Host surfaces: a push copies a screen rect from a sprite to the panel
+// ---------------------------------------------------------------------------
+
+static std::vector<uint16_t> panel(W *H);
+static std::vector<uint16_t> baseLayer(W *H);
+static std::vector<uint16_t> carSprite(W *H);
+static std::vector<uint16_t> steerSprite(W *H);
+
+static Rect clip(Rect r) {
+  if (r.x < 0) { r.w += r.x; r.x = 0; }
+  if (r.y < 0) { r.h += r.y; r.y = 0; }
+  if (r.x + r.w > W) r.w = W - r.x;
+  if (r.y + r.h > H) r.h = H - r.y;
+  if (r.w < 0) r.w = 0;
+  if (r.h < 0) r.h = 0;
+  return r;
+}
+
+static Rect unite(const Rect &a, const Rect &b) {
+  if (a.w <= 0 || a.h <= 0) return b;
+  int x0 = a.x < b.x ? a.x : b.x;
+  int y0 = a.y < b.y ? a.y : b.y;
+  int x1 = a.x + a.w > b.x + b.w ? a.x + a.w : b.x + b.w;
+  int y1 = a.y + a.h > b.y + b.h ? a.y + a.h : b.y + b.h;
+  return {static_cast<int16_t>(x0), static_cast<int16_t>(y0),
+          static_cast<int16_t>(x1 - x0), static_cast<int16_t>(y1 - y0)};
+}
+
+struct Cost {
+  uint64_t pixels = 0;
+  uint64_t pushes = 0;
+  uint64_t bytesTouched = 0; // Sprite bytes drawn (cleared) for the pushes
+  double hostUs = 0;
+
+  void push(const std::vector<uint16_t> &src, Rect r) {
+    r = clip(r);
+    if (r.w <= 0 || r.h <= 0) return;
+    for (int y = r.y; y < r.y + r.h; y++) {
+      memcpy(&panel[y * W + r.x], &src[y * W + r.x], r.w * sizeof(uint16_t));
+    }
+    pixels += static_cast<uint32_t>(r.w) * r.h;
+    pushes++;
+  }
+
+  void draw(std::vector<uint16_t> &dst, Rect r, uint16_t color) {
+    r = clip(r);
+    for (int y = r.y; y < r.y + r.h; y++) {
+      for (int x = r.x; x < r.x + r.w; x++) dst[y * W + x] = color;
+    }
+    bytesTouched += static_cast<uint32_t>(r.w) * r.h * 2;
+  }
+
+  // SPI time on the panel at the default rate, one window setup per push
+  double spiUs() const {
+    return pushes * TearSync::PushOrder::PUSH_OVERHEAD_US +
+           pixels * TearSync::PushOrder::DEFAULT_NS_PER_PIXEL / 1000.0;
+  }
+};
+
+static Inputs cruise() {
+  Inputs in = {};
+  in.speedKmh = 0.0f;
+  in.pedalPercent = 35.0f;
+  for (float &t : in.wheelTemp) t = 40.0f;
+  for (float &e : in.wheelEffort) e = 30.0f;
+  in.batteryVolts = 24.5f;
+  in.ambientTemp = 22.0f;
+  in.maxTemp = 40.0f;
+  in.systemState = 2;
+  in.gear = 3;
+  in.sensorCurrentOK = 6;
+  in.sensorTempOK = 5;
+  in.sensorWheelOK = 4;
+  return in;
+}
+
+// Speed ramp, then steering sweeps (±30°, 4 s) at speed, temperatures with
+// sensor noise throughout
+static void traceFrame(Inputs &in, int frame) {
+  float t = frame / 30.0f;
+  in.speedKmh = t < 10.0f ? t * 3.0f : 30.0f + noise(0.05f);
+  in.rpm = in.speedKmh * 11.5f;
+  in.pedalPercent = 35.0f + noise(0.3f);
+  float steer = t < 10.0f ? 0.0f : 30.0f * sinf(t * 2.0f * 3.14159265f / 4.0f);
+  in.steerFL = steer + noise(0.2f);
+  in.steerFR = steer + noise(0.2f);
+  in.steerAngle = (in.steerFL + in.steerFR) / 2.0f;
+  in.maxTemp = 0.0f;
+  for (int i = 0; i < 4; i++) {
+    in.wheelTemp[i] = 40.0f + t / 20.0f + noise(0.2f);
+    in.wheelEffort[i] = 30.0f + noise(0.4f);
+    in.maxTemp = fmaxf(in.maxTemp, in.wheelTemp[i]);
+  }
+  in.batteryVolts = 24.5f + noise(0.02f);
+  in.ambientTemp = 22.0f + noise(0.1f);
+}
+
+// Two engines: BASE widgets through the compositor, the steering wheel
+// (and the car body, first frame) into the RenderEngine sprites, whose
+// render() pushed the shared dirty box from both of them
+static void twoEngineFrame(Cost &c, uint32_t redraw, bool carBody) {
+  for (int i = 0; i < WIDGET_COUNT; i++) {
+    if (i == STEERING || !(redraw & (1u << i))) continue;
+    c.draw(baseLayer, LAYOUT[i], static_cast<uint16_t>(i));
+    c.push(baseLayer, LAYOUT[i]);
+  }
+  Rect box = {0, 0, 0, 0};
+  if (carBody) {
+    c.draw(carSprite, CAR_BODY, 0x2945);
+    box = unite(box, CAR_BODY);
+  }
+  if (redraw & bit(STEERING)) {
+    c.draw(steerSprite, LAYOUT[STEERING], 0x8410);
+    box = unite(box, LAYOUT[STEERING]);
+  }
+  c.push(carSprite, box);
+  c.push(steerSprite, box);
+}
+
+// One backend: the car body and the steering wheel are BASE rects too
+static void mergedFrame(Cost &c, uint32_t redraw, bool carBody) {
+  if (carBody) {
+    c.draw(baseLayer, CAR_BODY, 0x2945);
+    c.push(baseLayer, CAR_BODY);
+  }
+  for (int i = 0; i < WIDGET_COUNT; i++) {
+    if (!(redraw & (1u << i))) continue;
+    c.draw(baseLayer, LAYOUT[i], static_cast<uint16_t>(i));
+    c.push(baseLayer, LAYOUT[i]);
+  }
+}
+
+void test_merged_backend_pushes_less_per_frame() {
+  static constexpr int FRAMES = 30 * 60; // One minute at 30 FPS
+  using Clock = std::chrono::steady_clock;
+
+  Cost two, merged;
+  uint32_t steeringFrames = 0;
+  for (int pass = 0; pass < 2; pass++) {
+    rng = 1;
+    Model model(LAYOUT);
+    Inputs in = cruise();
+    Cost &c = pass == 0 ? two : merged;
+    auto t0 = Clock::now();
+    for (int frame = 0; frame < FRAMES; frame++) {
+      traceFrame(in, frame);
+      uint32_t redraw = model.update(in);
+      bool carBody = frame == 0; // Boot: everything invalidated
+      if (pass == 0) {
+        twoEngineFrame(c, redraw, carBody);
+        if (redraw & bit(STEERING)) steeringFrames++;
+      } else {
+        mergedFrame(c, redraw, carBody);
+      }
+    }
+    c.hostUs =
+        std::chrono::duration<double, std::micro>(Clock::now() - t0).count();
+  }
+
+  printf("\n  %-12s %10s %10s %12s %12s %10s\n", "backend", "px/frame",
+         "pushes/fr", "SPI us/fr", "host us/fr", "KB drawn");
+  const Cost *costs[] = {&two, &merged};
+  const char *names[] = {"two engines", "merged"};
+  for (int i = 0; i < 2; i++) {
+    const Cost &c = *costs[i];
+    printf("  %-12s %10.0f %10.2f %12.1f %12.2f %10.0f\n", names[i],
+           (double)c.pixels / FRAMES, (double)c.pushes / FRAMES,
+           c.spiUs() / FRAMES, c.hostUs / FRAMES, c.bytesTouched / 1024.0);
+  }
+  printf("  steering redrawn in %u of %d frames\n", (unsigned)steeringFrames,
+         FRAMES);
+
+  // Same content drawn, one push instead of two for every steering change
+  TEST_ASSERT_TRUE(steeringFrames > FRAMES / 4);
+  TEST_ASSERT_TRUE(merged.pixels < two.pixels);
+  TEST_ASSERT_TRUE(merged.pushes < two.pushes);
+  TEST_ASSERT_TRUE(merged.spiUs() < two.spiUs());
+  TEST_ASSERT_TRUE(merged.bytesTouched == two.bytesTouched);
+}
+
+void test_sprite_budget_two_surfaces_smaller() {
+  static uint8_t memory[TWO_ENGINE_SPRITES * SpritePool::SCREEN_SPRITE_BYTES];
+  SpritePool::Arena a;
+  TEST_ASSERT_TRUE(
+      a.init(memory, MERGED_SPRITES * SpritePool::SCREEN_SPRITE_BYTES));
+  for (uint8_t i = 0; i < MERGED_SPRITES; i++) {
+    TEST_ASSERT_TRUE(a.acquire(SpritePool::SCREEN_SPRITE_BYTES, i) !=
+                     SpritePool::INVALID);
+  }
+  // The RenderEngine sprites no longer need room
+  TEST_ASSERT_EQUAL_UINT16(SpritePool::INVALID,
+                           a.acquire(SpritePool::SCREEN_SPRITE_BYTES, 6));
+
+  printf("  PSRAM for sprites: %u KB (%u surfaces) -> %u KB (%u)\n",
+         (unsigned)(TWO_ENGINE_SPRITES * SpritePool::SCREEN_SPRITE_BYTES /
+                    1024),
+         TWO_ENGINE_SPRITES,
+         (unsigned)(MERGED_SPRITES * SpritePool::SCREEN_SPRITE_BYTES / 1024),
+         MERGED_SPRITES);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_merged_backend_pushes_less_per_frame);
+  RUN_TEST(test_sprite_budget_two_surfaces_smaller);
+  return UNITY_END();
+}
@@ -0,0 +1,275 @@
+// ============================================================================
+// i2c_faults.cpp - I2CRecovery under injected bus faults (benchmark)
+// ============================================================================
+// The power job's INA226 sweep (TCA9548A select + register read per
+// channel, RTScheduler slot: every 100 ms, 5 ms after the control job) runs
+// on the Sim bus while one fault at a time is injected at a spread of
+// phases. Per fault type the report gives:
+// - time to recover: fault onset until a sweep returns all six channels
+//   with the right values again (min / p50 / p95 / max over the trials)
+// - worst sweep: longest single power-job run, i.e. the longest the
+//   critical core is kept from the 100 Hz control job
+// - control time lost: power-job time beyond its budget, summed per trial
+// - wrong samples: values from the wrong channel or with flipped bits that
+//   the sweep accepted as good
+// ============================================================================
+
+#include "i2c_recovery.h"
+#include "pins.h"
+#include "sim_harness.h"
+#include <Arduino.h>
+#include <Wire.h>
+#include <algorithm>
+#include <unity.h>
+#include <vector>
+
+namespace {
+
+// Mirrors rtos_tasks.h (not host-buildable: FreeRTOS types)
+constexpr uint32_t PERIOD_CONTROL_MS = 10;
+constexpr uint32_t PERIOD_POWER_MS = 100;
+constexpr uint32_t PHASE_POWER_MS = 5;
+constexpr uint32_t BUDGET_POWER_US = 4000;
+
+constexpr uint8_t TCA_ADDR = I2C_ADDR_TCA9548A;
+constexpr uint8_t INA_ADDR = 0x40;
+constexpr uint8_t INA_COUNT = 6;
+constexpr uint8_t REG_BUS_VOLTAGE = 0x02;
+
+constexpr uint8_t TRIALS = 16;
+constexpr uint32_t INJECT_AFTER_SWEEPS = 3;
+constexpr uint32_t MAX_SWEEPS = 1200; // 2 min of power-job runs per trial
+
+Sim::Tca9548a mux;
+Sim::RegisterDevice16 ina[INA_COUNT];
+
+uint16_t expected(uint8_t ch) { return uint16_t(0x2400 + ch * 0x11); }
+
+struct Sweep {
+  uint32_t us;
+  uint8_t good;
+  uint8_t wrong;
+};
+
+// Sensors::updateCurrent() access pattern: skip channels still in backoff,
+// select (a failed select marks the channel offline), read
+Sweep powerSweep() {
+  Sweep s = {0, 0, 0};
+  uint64_t start = Sim::clock().nowUs();
+  for (uint8_t ch = 0; ch < INA_COUNT; ch++) {
+    if (millis() < I2CRecovery::getDeviceState(ch).nextRetryMs) continue;
+    if (!I2CRecovery::tcaSelectSafe(ch, TCA_ADDR)) {
+      I2CRecovery::markDeviceOffline(ch);
+      continue;
+    }
+    uint8_t b[2];
+    if (!I2CRecovery::readBytesWithRetry(INA_ADDR, REG_BUS_VOLTAGE, b, 2,
+                                         ch)) {
+      continue;
+    }
+    if (uint16_t(b[0] << 8 | b[1]) == expected(ch)) {
+      s.good++;
+    } else {
+      s.wrong++;
+    }
+  }
+  s.us = static_cast<uint32_t>(Sim::clock().nowUs() - start);
+  return s;
+}
+
+void bootBus() {
+  Sim::resetPeripherals();
+  mux = Sim::Tca9548a();
+  for (uint8_t ch = 0; ch < INA_COUNT; ch++) {
+    ina[ch] = Sim::RegisterDevice16();
+    ina[ch].set(REG_BUS_VOLTAGE, expected(ch));
+    mux.attach(ch, INA_ADDR, &ina[ch]);
+  }
+  Sim::i2c().attach(TCA_ADDR, &mux);
+  I2CRecovery::init();
+}
+
+struct Trial {
+  bool recovered;
+  uint32_t ttrMs;
+  uint32_t worstUs;
+  uint32_t lostUs;
+  uint32_t wrong;
+};
+
+// Sweeps on the power-job grid; the fault lands `leadMs` before sweep
+// number INJECT_AFTER_SWEEPS
+Trial runTrial(const Sim::I2cFaultPlan &plan, uint32_t leadMs) {
+  bootBus();
+  Trial t = {false, 0, 0, 0, 0};
+  uint64_t grid = Sim::clock().nowUs() + PHASE_POWER_MS * 1000u;
+  uint64_t injectUs =
+      grid + (INJECT_AFTER_SWEEPS * PERIOD_POWER_MS - leadMs) * 1000u;
+  bool injected = false;
+
+  for (uint32_t k = 0; k < MAX_SWEEPS; k++) {
+    uint64_t release = grid + uint64_t(k) * PERIOD_POWER_MS * 1000u;
+    if (!injected && release > injectUs) {
+      if (Sim::clock().nowUs() < injectUs) {
+        Sim::advanceUs(injectUs - Sim::clock().nowUs());
+      }
+      Sim::i2c().inject(plan);
+      injected = true;
+    }
+    // An overrunning sweep pushes the next one back, as on the executive
+    if (Sim::clock().nowUs() < release) {
+      Sim::advanceUs(release - Sim::clock().nowUs());
+    }
+
+    Sweep s = powerSweep();
+    if (!injected) continue;
+    t.worstUs = std::max(t.worstUs, s.us);
+    if (s.us > BUDGET_POWER_US) t.lostUs += s.us - BUDGET_POWER_US;
+    t.wrong += s.wrong;
+    if (s.good == INA_COUNT && !Sim::i2c().faultActive()) {
+      t.recovered = true;
+      t.ttrMs = static_cast<uint32_t>((Sim::clock().nowUs() - injectUs) /
+                                      1000u);
+      break;
+    }
+  }
+  Sim::i2c().clearFault();
+  return t;
+}
+
+struct Summary {
+  uint8_t recovered;
+  uint32_t ttrMin, ttrP50, ttrP95, ttrMax;
+  uint32_t worstUs;
+  uint32_t lostUsMax;
+  uint32_t wrong;
+};
+
+Summary bench(const char *name, const Sim::I2cFaultPlan &plan) {
+  std::vector<uint32_t> ttr;
+  Summary sum = {};
+  for (uint8_t i = 0; i < TRIALS; i++) {
+    // Onsets spread over the whole power period, mid-sweep included
+    Trial t = runTrial(plan, 1 + (i * PERIOD_POWER_MS) / TRIALS);
+    if (t.recovered) {
+      sum.recovered++;
+      ttr.push_back(t.ttrMs);
+    }
+    sum.worstUs = std::max(sum.worstUs, t.worstUs);
+    sum.lostUsMax = std::max(sum.lostUsMax, t.lostUs);
+    sum.wrong += t.wrong;
+  }
+  std::sort(ttr.begin(), ttr.end());
+  if (!ttr.empty()) {
+    sum.ttrMin = ttr.front();
+    sum.ttrP50 = ttr[ttr.size() / 2];
+    sum.ttrP95 = ttr[(ttr.size() * 95) / 100];
+    sum.ttrMax = ttr.back();
+  }
+  printf("  %-22s %3u/%-3u %7lu %7lu %7lu %7lu %9.2f %9.2f %6lu\n", name,
+         sum.recovered, TRIALS, (unsigned long)sum.ttrMin,
+         (unsigned long)sum.ttrP50, (unsigned long)sum.ttrP95,
+         (unsigned long)sum.ttrMax, sum.worstUs / 1000.0,
+         sum.lostUsMax / 1000.0, (unsigned long)sum.wrong);
+  return sum;
+}
+
+void printHeader() {
+  printf("\n  %-22s %7s %7s %7s %7s %7s %9s %9s %6s\n", "fault", "recov",
+         "ttr min", "p50", "p95", "max ms", "worst ms", "lost ms", "wrong");
+}
+
+Sim::I2cFaultPlan plan(Sim::I2cFault type, uint8_t addr, uint32_t durationMs) {
+  Sim::I2cFaultPlan p;
+  p.type = type;
+  p.addr = addr;
+  p.durationMs = durationMs;
+  return p;
+}
+
+} // namespace
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+void test_i2c_fault_sweep_is_clean_without_faults() {
+  bootBus();
+  Sweep s = powerSweep();
+  TEST_ASSERT_EQUAL(INA_COUNT, s.good);
+  TEST_ASSERT_EQUAL(0, s.wrong);
+  // Six selects + six register reads at 400 kHz, readback included
+  TEST_ASSERT_LESS_THAN(BUDGET_POWER_US, s.us);
+}
+
+void test_i2c_recovery_benchmark_per_fault_type() {
+  printHeader();
+
+  // INA226 rail brown-out: every sensor NACKs for 250 ms / 5 s
+  Summary nackShort =
+      bench("nack 250 ms", plan(Sim::I2cFault::NACK, INA_ADDR, 250));
+  Summary nackLong =
+      bench("nack 5 s", plan(Sim::I2cFault::NACK, INA_ADDR, 5000));
+
+  // Slave reset mid-byte: SDA low until the 9-clock recovery
+  Sim::I2cFaultPlan stuck = plan(Sim::I2cFault::STUCK_SDA, 0xFF, 0);
+  stuck.releasePulses = 9;
+  Summary sda = bench("stuck sda (9 clocks)", stuck);
+
+  // Stretch past the driver timeout for 1 s
+  Sim::I2cFaultPlan stretch =
+      plan(Sim::I2cFault::CLOCK_STRETCH, INA_ADDR, 1000);
+  stretch.stretchUs = 150000;
+  Summary clk = bench("clock stretch 150 ms", stretch);
+
+  Summary corrupt = bench("corrupt reads 500 ms",
+                          plan(Sim::I2cFault::CORRUPT_READ, INA_ADDR, 500));
+
+  Summary muxStuck = bench("mux stuck 500 ms",
+                      plan(Sim::I2cFault::DROP_WRITE, TCA_ADDR, 500));
+
+  const Summary all[] = {nackShort, nackLong, sda, clk, corrupt, muxStuck};
+  for (const Summary &s : all) {
+    TEST_ASSERT_EQUAL(TRIALS, s.recovered);
+    // One sweep never holds the critical core for a full control period
+    TEST_ASSERT_LESS_THAN(PERIOD_CONTROL_MS * 1000u, s.worstUs);
+  }
+  // A mux that ignores the select is caught by the control-byte readback
+  TEST_ASSERT_EQUAL(0, muxStuck.wrong);
+  // Doubling backoff: a short outage is over within twice its length plus
+  // a sweep; a stuck SDA line is freed by the first recovery
+  TEST_ASSERT_LESS_OR_EQUAL(2 * 250 + PERIOD_POWER_MS, nackShort.ttrMax);
+  TEST_ASSERT_LESS_OR_EQUAL(2 * PERIOD_POWER_MS, sda.ttrMax);
+  // Long outages: probing backoff caps the wait after the fault clears
+  TEST_ASSERT_LESS_OR_EQUAL(5000 + I2CRecovery::MAX_BACKOFF_MS +
+                                PERIOD_POWER_MS,
+                            nackLong.ttrMax);
+}
+
+void test_i2c_unrecoverable_stuck_bus_stays_bounded() {
+  Sim::I2cFaultPlan dead = plan(Sim::I2cFault::STUCK_SDA, 0xFF, 0);
+  dead.releasePulses = 0; // Shorted line: clocking never frees it
+  bootBus();
+  Sim::i2c().inject(dead);
+
+  uint32_t worstUs = 0;
+  uint64_t busyUs = 0;
+  uint64_t startUs = Sim::clock().nowUs();
+  for (uint32_t k = 0; k < 600; k++) { // One minute
+    Sweep s = powerSweep();
+    TEST_ASSERT_EQUAL(0, s.good);
+    worstUs = std::max(worstUs, s.us);
+    busyUs += s.us;
+    if (s.us < PERIOD_POWER_MS * 1000u) {
+      Sim::advanceUs(PERIOD_POWER_MS * 1000u - s.us);
+    }
+  }
+  double duty = double(busyUs) / double(Sim::clock().nowUs() - startUs);
+  printf("  dead bus: worst sweep %.2f ms, power-job duty %.2f %%\n",
+         worstUs / 1000.0, duty * 100.0);
+
+  TEST_ASSERT_LESS_THAN(PERIOD_CONTROL_MS * 1000u, worstUs);
+  TEST_ASSERT_TRUE(duty < 0.02);
+  TEST_ASSERT_FALSE(I2CRecovery::isDeviceOnline(0));
+  Sim::i2c().clearFault();
+}
@@ -0,0 +1,71 @@
+// ============================================================================
+// stand_ins.cpp - Collaborators the scenarios do not run for real
+// ============================================================================
+
+#include "stand_ins.h"
+#include "current.h"
+#include "error_journal.h"
+#include "limp_mode.h"
+#include "system.h"
+#include "temperature.h"
+#include "watchdog.h"
+#include <Arduino.h>
+
+Storage::Config cfg;
+
+namespace StandIn {
+
+static World w;
+
+World &world() { return w; }
+
+void reset() {
+  w = {};
+  w.steering.centered = true;
+  w.steering.valid = true;
+  w.batteryVoltage = 24.5f;
+  for (float &t : w.motorTempC) t = 35.0f;
+
+  cfg = {};
+  cfg.pedalMin = 200;
+  cfg.pedalMax = 3800;
+  cfg.wheelSensorsEnabled = true;
+  cfg.tempSensorsEnabled = true;
+  cfg.currentSensorsEnabled = true;
+  ErrorJournal::clear();
+}
+
+} // namespace StandIn
+
+// The real journal, as System uses it: a new code notifies LimpMode at
+// once; the 1 s Journal flush to cfg.errors (and NVS) is not run
+void System::logError(uint16_t code, uint32_t context) {
+  bool isNew = false;
+  ErrorJournal::record(code, millis(), context, &isNew);
+  if (isNew) LimpMode::notify(LimpMode::SOURCE_ERRORS);
+}
+
+int System::getErrorCount() { return cfg.errorCount; }
+
+int System::getDistinctErrorCount() {
+  return ErrorJournal::distinctCount(cfg.errors, cfg.errorCount,
+                                     Storage::Config::MAX_ERRORS);
+}
+
+const Steering::State &Steering::get() { return StandIn::world().steering; }
+
+float Sensors::getVoltage(int channel) {
+  return channel == 4 ? StandIn::world().batteryVoltage : 0.0f;
+}
+
+float Sensors::getTemperature(int index) {
+  return (index >= 0 && index < 4) ? StandIn::world().motorTempC[index]
+                                   : 0.0f;
+}
+
+void Alerts::play(Audio::Track t) {
+  StandIn::world().alertsPlayed++;
+  StandIn::world().lastAlert = t;
+}
+
+void Watchdog::feed() { StandIn::world().watchdogFeeds++; }
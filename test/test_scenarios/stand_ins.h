@@ -0,0 +1,33 @@
+#pragma once
+
+// ============================================================================
+// stand_ins.h - Collaborators the scenarios do not run for real
+// ============================================================================
+// The drivers under test (pedal, wheels, TCS, LimpMode, TOFSense) link
+// against these instead of System, Storage, Steering, the INA226/DS18B20
+// readers, Alerts and the watchdog. Each one is a plain value a scenario
+// sets, or a counter it checks. A scenario that changes a value LimpMode
+// reads calls LimpMode::notify(), as the real reader would.
+// ============================================================================
+
+#include "alerts.h"
+#include "steering.h"
+#include "storage.h"
+
+namespace StandIn {
+
+struct World {
+  Steering::State steering;
+  float batteryVoltage;  // INA226 battery channel (4)
+  float motorTempC[4];   // DS18B20 motor probes
+  uint32_t alertsPlayed;
+  Audio::Track lastAlert;
+  uint32_t watchdogFeeds;
+};
+
+World &world();
+
+// Healthy car: centered valid steering, 24.5 V, 35 °C motors, no errors
+void reset();
+
+} // namespace StandIn
@@ -0,0 +1,428 @@
+// ============================================================================
+// test_main.cpp - Traction, limp-mode and obstacle scenarios in virtual time
+// Run: pio test -e native_sim
+//
+// The real Pedal, wheel, TCS, LimpMode and TOFSense drivers run against the
+// Sim fakes (test/sim): ADC codes, wheel-sensor square waves, a 921600 baud
+// UART stream and a virtual clock. Jobs run at their RTScheduler periods, so
+// each scenario covers seconds to an hour of driving; the timing report at
+// the end shows simulated time against wall time per test. i2c_faults.cpp
+// adds the I2CRecovery fault-injection benchmark on the same bus fakes.
+// ============================================================================
+
+#include "error_journal.h"
+#include "limp_mode.h"
+#include "obstacle_config.h"
+#include "obstacle_detection.h"
+#include "pedal.h"
+#include "pins.h"
+#include "sim_harness.h"
+#include "stand_ins.h"
+#include "system.h"
+#include "tcs_system.h"
+#include "wheels.h"
+#include <Arduino.h>
+#include <HardwareSerial.h>
+#include <Wire.h>
+#include <unity.h>
+
+using LimpMode::LimpState;
+
+static constexpr uint32_t CONTROL_PERIOD_MS = 10; // Safety/control tasks
+static constexpr uint8_t WHEEL_PINS[4] = {PIN_WHEEL_FL, PIN_WHEEL_FR,
+                                          PIN_WHEEL_RL, PIN_WHEEL_RR};
+
+// 6 pulses per turn of a 1.1 m wheel: 10 Hz is one pulse per 100 ms wheel
+// window (20.7 km/h), 20 Hz two (41.5 km/h, the geared top speed)
+static constexpr float CRUISE_PULSE_HZ = 10.0f;
+static constexpr float SPIN_PULSE_HZ = 20.0f;
+
+static void pedalAt(uint16_t raw) {
+  Sim::adc().set(PIN_PEDAL, raw);
+  Sim::adc().setNoise(PIN_PEDAL, 3);
+}
+
+static void driveWheels(float hz) {
+  for (uint8_t pin : WHEEL_PINS) Sim::gpio().setFrequency(pin, hz);
+}
+
+// Control-core jobs in RTScheduler order
+static void addControlJobs(Sim::Loop &loop) {
+  loop.add("Pedal", CONTROL_PERIOD_MS, [] { Pedal::update(); });
+  loop.add("Wheels", CONTROL_PERIOD_MS, [] { Sensors::updateWheels(); });
+  loop.add("TCS", CONTROL_PERIOD_MS, [] { TCSSystem::update(); });
+  loop.add("Limp", CONTROL_PERIOD_MS, [] { LimpMode::update(); });
+}
+
+static void bootControl() {
+  Pedal::init();
+  Sensors::initWheels();
+  TCSSystem::init();
+  LimpMode::init();
+}
+
+// TOFSense-M S 8x8 frame: background at 3.5 m, a 2x2 object in the middle
+static void sendTofFrame(uint16_t objectMm, bool corrupt = false) {
+  uint8_t f[ObstacleConfig::FRAME_LENGTH] = {};
+  memcpy(f, ObstacleConfig::FRAME_HEADER, ObstacleConfig::HEADER_LENGTH);
+  f[ObstacleConfig::POS_ID] = 0x01;
+  f[ObstacleConfig::POS_LENGTH] = ObstacleConfig::FRAME_LENGTH & 0xFF;
+  f[ObstacleConfig::POS_LENGTH + 1] = ObstacleConfig::FRAME_LENGTH >> 8;
+  for (uint8_t px = 0; px < ObstacleConfig::ZONES_PER_SENSOR; px++) {
+    bool object = px == 27 || px == 28 || px == 35 || px == 36;
+    int32_t raw = int32_t(object ? objectMm : 3500) * 256;
+    uint8_t *p = &f[ObstacleConfig::POS_MATRIX_DATA +
+                    px * ObstacleConfig::BYTES_PER_PIXEL];
+    p[0] = raw & 0xFF;
+    p[1] = (raw >> 8) & 0xFF;
+    p[2] = (raw >> 16) & 0xFF;
+    p[3] = 80; // Signal strength
+  }
+  uint8_t sum = 0;
+  for (uint16_t i = 0; i < ObstacleConfig::POS_CHECKSUM; i++) sum += f[i];
+  f[ObstacleConfig::POS_CHECKSUM] = corrupt ? uint8_t(sum + 1) : sum;
+  Sim::uart(ObstacleConfig::UART_NUM).send(f, sizeof(f));
+}
+
+// The sensor streams from power-on, so init() finds it on the first try
+static void bootTofSense(uint16_t objectMm) {
+  Sim::uart(ObstacleConfig::UART_NUM).begin(ObstacleConfig::UART_BAUDRATE);
+  sendTofFrame(objectMm);
+  ObstacleDetection::init();
+}
+
+void setUp() {
+  Sim::resetPeripherals();
+  StandIn::reset();
+  Sim::report().begin(Unity.CurrentTestName);
+}
+
+void tearDown() { Sim::report().end(); }
+
+// ============================================================================
+// Harness
+// ============================================================================
+
+void test_uart_paces_bytes_at_baud_rate() {
+  Sim::Uart &port = Sim::uart(1);
+  port.setRxBufferSize(2048);
+  port.begin(115200); // 11520 bytes/s
+  uint8_t block[1152] = {};
+  port.send(block, sizeof(block));
+  Sim::advanceMs(50);
+  TEST_ASSERT_EQUAL_INT(576, port.available());
+  Sim::advanceMs(50);
+  TEST_ASSERT_EQUAL_INT(1152, port.available());
+  TEST_ASSERT_EQUAL_UINT32(0, port.overruns());
+
+  // Default buffer: the ring plus the hardware FIFO, then bytes are lost
+  port.reset();
+  port.begin(115200);
+  port.send(block, sizeof(block));
+  Sim::advanceMs(100);
+  TEST_ASSERT_EQUAL_INT(Sim::Uart::DEFAULT_RX_BUFFER + Sim::Uart::HW_FIFO,
+                        port.available());
+  TEST_ASSERT_EQUAL_UINT32(1152 - 384, port.overruns());
+}
+
+void test_i2c_register_device_over_wire() {
+  Sim::RegisterDevice16 ina;
+  ina.set(0x02, 0x2580); // Bus voltage register
+  Sim::i2c().attach(0x40, &ina);
+  Wire.begin(PIN_I2C_SDA, PIN_I2C_SCL, 400000);
+
+  uint64_t t0 = Sim::clock().nowUs();
+  Wire.beginTransmission(0x40);
+  Wire.write(0x02);
+  TEST_ASSERT_EQUAL_UINT8(0, Wire.endTransmission(false));
+  TEST_ASSERT_EQUAL_UINT8(2, Wire.requestFrom(0x40, 2));
+  TEST_ASSERT_EQUAL_INT(0x25, Wire.read());
+  TEST_ASSERT_EQUAL_INT(0x80, Wire.read());
+  // 2 + 3 bytes of 9 bits at 400 kHz
+  TEST_ASSERT_EQUAL_UINT32(45 + 67, Sim::clock().nowUs() - t0);
+
+  Wire.beginTransmission(0x41); // Nothing there
+  TEST_ASSERT_EQUAL_UINT8(Sim::I2cBus::NACK_ADDRESS, Wire.endTransmission());
+}
+
+// ============================================================================
+// Traction
+// ============================================================================
+
+void test_pedal_follows_adc_with_spike_clamp() {
+  pedalAt(200);
+  Pedal::init();
+  Sim::Loop loop;
+  loop.add("Pedal", CONTROL_PERIOD_MS, [] { Pedal::update(); });
+  loop.runFor(500);
+  TEST_ASSERT_TRUE(Pedal::get().valid);
+  TEST_ASSERT_TRUE(Pedal::get().percent < 1.0f);
+
+  // Floored in one step: 20 % per update at most, then the EMA catches up
+  pedalAt(3800);
+  loop.runFor(CONTROL_PERIOD_MS);
+  TEST_ASSERT_TRUE(Pedal::get().percent <= 20.0f + 0.01f);
+  loop.runFor(1000);
+  TEST_ASSERT_TRUE(Pedal::get().valid);
+  TEST_ASSERT_TRUE(Pedal::get().percent > 99.0f);
+}
+
+void test_tcs_cuts_spinning_wheel_and_recovers() {
+  pedalAt(2000);
+  driveWheels(CRUISE_PULSE_HZ);
+  bootControl();
+  Sim::Loop loop;
+  addControlJobs(loop);
+  loop.runFor(5000);
+  TEST_ASSERT_FALSE(TCSSystem::isActive());
+  TEST_ASSERT_TRUE(TCSSystem::getState().vehicleSpeed > 20.0f);
+
+  // Front left loses grip for two seconds
+  Sim::gpio().setFrequency(PIN_WHEEL_FL, SPIN_PULSE_HZ);
+  uint32_t t0 = loop.elapsedMs();
+  TEST_ASSERT_TRUE(
+      loop.runUntil([] { return TCSSystem::getState().wheels[0].active; },
+                    1000));
+  TEST_ASSERT_TRUE(loop.elapsedMs() - t0 <= 200); // Two wheel windows
+  loop.runFor(1800);
+  TEST_ASSERT_TRUE(TCSSystem::modulatePower(0, 100.0f) <= 60.0f);
+  for (int w = 1; w < 4; w++) {
+    TEST_ASSERT_FALSE(TCSSystem::getState().wheels[w].active);
+    TEST_ASSERT_EQUAL_INT(100, (int)TCSSystem::modulatePower(w, 100.0f));
+  }
+
+  // Grip back: 25 %/s recovery from the 80 % cap
+  Sim::gpio().setFrequency(PIN_WHEEL_FL, CRUISE_PULSE_HZ);
+  t0 = loop.elapsedMs();
+  TEST_ASSERT_TRUE(
+      loop.runUntil([] { return !TCSSystem::getState().wheels[0].active; },
+                    6000));
+  uint32_t recoveryMs = loop.elapsedMs() - t0;
+  TEST_ASSERT_TRUE(recoveryMs >= 2500 && recoveryMs <= 4000);
+  TEST_ASSERT_EQUAL_UINT32(1, TCSSystem::getState().totalActivations);
+  TEST_ASSERT_EQUAL_UINT32(1, StandIn::world().alertsPlayed);
+}
+
+// ============================================================================
+// Limp mode
+// ============================================================================
+
+void test_unplugged_pedal_limps_then_recovers() {
+  pedalAt(1200);
+  driveWheels(CRUISE_PULSE_HZ);
+  bootControl();
+  Sim::Loop loop;
+  addControlJobs(loop);
+  loop.runFor(2000);
+  TEST_ASSERT_EQUAL(LimpState::NORMAL, LimpMode::getState());
+
+  // Wiper open: ADC at the rail; 20 extreme reads mark the pedal invalid
+  Sim::adc().set(PIN_PEDAL, 0);
+  Sim::adc().setNoise(PIN_PEDAL, 0);
+  uint32_t t0 = loop.elapsedMs();
+  TEST_ASSERT_TRUE(loop.runUntil(
+      [] { return LimpMode::getState() == LimpState::LIMP; }, 2000));
+  TEST_ASSERT_TRUE(loop.elapsedMs() - t0 <= 20 * CONTROL_PERIOD_MS + 20);
+  TEST_ASSERT_EQUAL_INT(40, (int)LimpMode::limitPower(100.0f));
+
+  // Plugged back: valid at once, NORMAL after the 500 ms hysteresis
+  pedalAt(1200);
+  t0 = loop.elapsedMs();
+  TEST_ASSERT_TRUE(loop.runUntil(
+      [] { return LimpMode::getState() == LimpState::NORMAL; }, 2000));
+  uint32_t backMs = loop.elapsedMs() - t0;
+  TEST_ASSERT_TRUE(backMs >= 480 && backMs <= 520);
+}
+
+// Errors reach LimpMode when logged, not at the 1 s Journal flush: new
+// codes are counted, and move the state, on the next Limp tick
+void test_new_error_codes_limp_on_the_same_tick() {
+  pedalAt(1200);
+  driveWheels(CRUISE_PULSE_HZ);
+  bootControl();
+  Sim::Loop loop;
+  addControlJobs(loop);
+  loop.runFor(2000);
+  TEST_ASSERT_EQUAL(LimpState::NORMAL, LimpMode::getState());
+
+  System::logError(601);
+  System::logError(602);
+  System::logError(603);
+  loop.runFor(CONTROL_PERIOD_MS);
+  TEST_ASSERT_EQUAL(LimpState::LIMP, LimpMode::getState());
+  TEST_ASSERT_EQUAL_UINT8(3, LimpMode::getDiagnostics().systemErrorCount);
+  TEST_ASSERT_EQUAL_INT(0, cfg.errorCount); // Nothing flushed yet
+
+  // A repeat is not a new code
+  System::logError(601);
+  loop.runFor(CONTROL_PERIOD_MS);
+  TEST_ASSERT_EQUAL_UINT8(3, LimpMode::getDiagnostics().systemErrorCount);
+
+  // Counted at once; CRITICAL once the 500 ms hysteresis has run out
+  System::logError(700);
+  System::logError(701);
+  loop.runFor(CONTROL_PERIOD_MS);
+  TEST_ASSERT_EQUAL_UINT8(5, LimpMode::getDiagnostics().systemErrorCount);
+  uint32_t t0 = loop.elapsedMs();
+  TEST_ASSERT_TRUE(loop.runUntil(
+      [] { return LimpMode::getState() == LimpState::CRITICAL; }, 1000));
+  TEST_ASSERT_TRUE(loop.elapsedMs() - t0 <= 500);
+}
+
+struct Transition {
+  uint32_t atS;
+  LimpState to;
+};
+
+// One hour at cruise: the battery sags from 25.2 V to 19.2 V and motor 2
+// overheats between minutes 30 and 50. Ends in LIMP on undervoltage.
+void test_hour_soak_battery_sag_and_overheat() {
+  static constexpr uint32_t HOUR_S = 3600;
+  pedalAt(1500);
+  driveWheels(CRUISE_PULSE_HZ);
+  bootControl();
+
+  static Transition seen[16];
+  static uint8_t seenCount;
+  static LimpState last;
+  seenCount = 0;
+  last = LimpMode::getState();
+
+  Sim::Loop loop;
+  addControlJobs(loop);
+  loop.add("Plant", 100, [&loop] {
+    float t = loop.elapsedMs() / 1000.0f;
+    StandIn::World &w = StandIn::world();
+    w.batteryVoltage = 25.2f - 6.0f * t / HOUR_S;
+    float hot;
+    if (t < 1800.0f) {
+      hot = 35.0f;
+    } else if (t < 2400.0f) {
+      hot = 35.0f + 60.0f * (t - 1800.0f) / 600.0f;
+    } else if (t < 2700.0f) {
+      hot = 95.0f;
+    } else {
+      hot = std::max(60.0f, 95.0f - 35.0f * (t - 2700.0f) / 300.0f);
+    }
+    w.motorTempC[2] = hot;
+    // What the INA226 / DS18B20 readers do on a new sample
+    LimpMode::notify(LimpMode::SOURCE_BATTERY | LimpMode::SOURCE_TEMPERATURE);
+  });
+  loop.add("Watch", CONTROL_PERIOD_MS, [&loop] {
+    LimpState s = LimpMode::getState();
+    if (s != last && seenCount < 16) {
+      seen[seenCount++] = {loop.elapsedMs() / 1000, s};
+    }
+    last = s;
+  });
+  loop.runFor(HOUR_S * 1000);
+
+  // >80 °C at 2250 s, >90 °C at 2350 s, back under 90/80 °C at ~2743 and
+  // ~2829 s, 20 V at 3120 s
+  const Transition expected[] = {{2250, LimpState::DEGRADED},
+                                 {2350, LimpState::CRITICAL},
+                                 {2743, LimpState::DEGRADED},
+                                 {2828, LimpState::NORMAL},
+                                 {3120, LimpState::LIMP}};
+  TEST_ASSERT_EQUAL_UINT8(5, seenCount);
+  for (uint8_t i = 0; i < 5; i++) {
+    TEST_ASSERT_EQUAL(expected[i].to, seen[i].to);
+    TEST_ASSERT_UINT16_WITHIN(2, expected[i].atS, seen[i].atS);
+  }
+  // Steady cruise on four matched wheels never trips traction control
+  TEST_ASSERT_EQUAL_UINT32(0, TCSSystem::getState().totalActivations);
+  TEST_ASSERT_TRUE(Pedal::get().valid);
+}
+
+// ============================================================================
+// Obstacle
+// ============================================================================
+
+// An object closes from 2.5 m at 0.5 m/s; the sensor reports at 15 Hz
+void test_tofsense_tracks_approaching_object() {
+  static constexpr uint32_t FRAME_MS = ObstacleConfig::UPDATE_INTERVAL_MS;
+  static uint32_t startMs;
+  bootTofSense(2500);
+  TEST_ASSERT_TRUE(ObstacleDetection::isHardwarePresent());
+  Sim::Uart &port = Sim::uart(ObstacleConfig::UART_NUM);
+  uint32_t overrunsAtBoot = port.overruns();
+
+  Sim::Loop loop;
+  startMs = millis();
+  loop.add("TOFSense", FRAME_MS, [] {
+    float t = (millis() - startMs) / 1000.0f;
+    sendTofFrame(uint16_t(std::max(50.0f, 2500.0f - 500.0f * t)));
+  });
+  loop.add("Sensors", CONTROL_PERIOD_MS, [] { ObstacleDetection::update(); });
+
+  // Crossings at 3.0 s (1 m), 4.0 s (0.5 m) and 4.6 s (0.2 m); the level
+  // may trail by one frame period plus transfer and poll time
+  const struct {
+    ObstacleDetection::ObstacleLevel level;
+    uint32_t crossMs;
+  } steps[] = {{ObstacleDetection::LEVEL_CAUTION, 3000},
+               {ObstacleDetection::LEVEL_WARNING, 4000},
+               {ObstacleDetection::LEVEL_CRITICAL, 4600}};
+  for (const auto &step : steps) {
+    ObstacleDetection::ObstacleLevel level = step.level;
+    TEST_ASSERT_TRUE(loop.runUntil(
+        [level] { return ObstacleDetection::getProximityLevel(0) == level; },
+        6000));
+    uint32_t lagMs = loop.elapsedMs() - step.crossMs;
+    TEST_ASSERT_TRUE(loop.elapsedMs() >= step.crossMs);
+    TEST_ASSERT_TRUE(lagMs <= FRAME_MS + 5 + CONTROL_PERIOD_MS);
+  }
+  TEST_ASSERT_TRUE(ObstacleDetection::isHealthy(0));
+  TEST_ASSERT_EQUAL_UINT32(overrunsAtBoot, port.overruns());
+}
+
+void test_tofsense_corrupt_frames_then_silence() {
+  bootTofSense(1500);
+  Sim::Loop loop;
+  loop.add("Sensors", CONTROL_PERIOD_MS, [] { ObstacleDetection::update(); });
+  loop.runFor(100);
+  TEST_ASSERT_TRUE(ObstacleDetection::isHealthy(0));
+
+  // Eleven bad checksums in a row mark the sensor unhealthy
+  for (uint8_t i = 0; i <= ObstacleConfig::MAX_CONSECUTIVE_ERRORS; i++) {
+    sendTofFrame(1500, true);
+    loop.runFor(ObstacleConfig::UPDATE_INTERVAL_MS);
+  }
+  TEST_ASSERT_FALSE(ObstacleDetection::isHealthy(0));
+  sendTofFrame(800);
+  loop.runFor(ObstacleConfig::UPDATE_INTERVAL_MS);
+  TEST_ASSERT_TRUE(ObstacleDetection::isHealthy(0));
+  TEST_ASSERT_EQUAL_UINT16(800, ObstacleDetection::getMinDistance(0));
+
+  // Cable pulled: invalid after the 200 ms read timeout, error 820 logged
+  loop.runFor(ObstacleConfig::UART_READ_TIMEOUT_MS + 2 * CONTROL_PERIOD_MS);
+  TEST_ASSERT_FALSE(ObstacleDetection::isHealthy(0));
+  TEST_ASSERT_EQUAL_UINT16(ObstacleConfig::DISTANCE_INVALID,
+                           ObstacleDetection::getMinDistance(0));
+  ErrorJournal::Entry timeout;
+  TEST_ASSERT_TRUE(ErrorJournal::get(ObstacleConfig::ERROR_CODE_TIMEOUT,
+                                     timeout));
+}
+
+// I2C fault injection and recovery benchmark (i2c_faults.cpp)
+void test_i2c_fault_sweep_is_clean_without_faults();
+void test_i2c_recovery_benchmark_per_fault_type();
+void test_i2c_unrecoverable_stuck_bus_stays_bounded();
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_uart_paces_bytes_at_baud_rate);
+  RUN_TEST(test_i2c_register_device_over_wire);
+  RUN_TEST(test_pedal_follows_adc_with_spike_clamp);
+  RUN_TEST(test_tcs_cuts_spinning_wheel_and_recovers);
+  RUN_TEST(test_unplugged_pedal_limps_then_recovers);
+  RUN_TEST(test_new_error_codes_limp_on_the_same_tick);
+  RUN_TEST(test_hour_soak_battery_sag_and_overheat);
+  RUN_TEST(test_tofsense_tracks_approaching_object);
+  RUN_TEST(test_tofsense_corrupt_frames_then_silence);
+  RUN_TEST(test_i2c_fault_sweep_is_clean_without_faults);
+  RUN_TEST(test_i2c_recovery_benchmark_per_fault_type);
+  RUN_TEST(test_i2c_unrecoverable_stuck_bus_stays_bounded);
+  Sim::report().print();
+  return UNITY_END();
+}
@@ -0,0 +1,258 @@
+// ============================================================================
+// test_main.cpp - Shadow-mode block hashing over the dirty set
+// Run: pio test -e native -f test_shadow_compare
+//
+// Every single-bit change of a block changes its hash, dirty rects to block
+// bitmap (clipping, overlaps counted once), mismatch detection including
+// two swapped pixels the old XOR checksum missed, and a benchmark of µs per
+// compared frame: the old readPixel()/XOR loop (every block tested against
+// every rect) against word hashing of the marked blocks.
+// ============================================================================
+
+#include "shadow_compare.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <unity.h>
+#include <vector>
+
+using namespace ShadowCompare;
+
+static constexpr int W = 480;
+static constexpr int H = 320;
+
+static std::vector<uint16_t> mainBuf(W *H);
+static std::vector<uint16_t> shadowBuf(W *H);
+
+static uint32_t rng = 1;
+static uint32_t next() {
+  rng ^= rng << 13;
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return rng;
+}
+
+static void fillRandom() {
+  for (uint16_t &px : mainBuf) px = next() & 0xFFFF;
+  shadowBuf = mainBuf;
+}
+
+// ---------------------------------------------------------------------------
+// The previous implementation, kept here as the benchmark baseline
+// ---------------------------------------------------------------------------
+
+// TFT_eSprite::readPixel() for a 16-bit sprite: bounds check, byte swap
+__attribute__((noinline)) static uint16_t readPixel(const uint16_t *img,
+                                                    int32_t x, int32_t y) {
+  if (x < 0 || y < 0 || x >= W || y >= H) return 0xFFFF;
+  uint16_t c = img[x + y * W];
+  return (c >> 8) | (c << 8);
+}
+
+static uint16_t oldChecksum(const uint16_t *img, int bx, int by) {
+  uint16_t checksum = 0;
+  for (int y = by * 16; y < by * 16 + 16 && y < H; y++) {
+    for (int x = bx * 16; x < bx * 16 + 16 && x < W; x++) {
+      checksum ^= readPixel(img, x, y);
+      checksum ^= static_cast<uint16_t>((x + y) & 0xFFFF);
+    }
+  }
+  return checksum;
+}
+
+static uint32_t oldCompare(const uint16_t *a, const uint16_t *b,
+                           const Rect *rects, int count) {
+  uint32_t mismatches = 0;
+  for (int by = 0; by < H / 16; by++) {
+    for (int bx = 0; bx < W / 16; bx++) {
+      int px = bx * 16, py = by * 16;
+      bool dirty = false;
+      for (int r = 0; r < count; r++) {
+        const Rect &rect = rects[r];
+        if (!(px >= rect.x + rect.w || px + 16 <= rect.x ||
+              py >= rect.y + rect.h || py + 16 <= rect.y)) {
+          dirty = true;
+          break;
+        }
+      }
+      if (!dirty) continue;
+      if (oldChecksum(a, bx, by) != oldChecksum(b, bx, by)) mismatches++;
+    }
+  }
+  return mismatches;
+}
+
+void setUp() {
+  rng = 1;
+  fillRandom();
+}
+void tearDown() {}
+
+void test_every_single_bit_flip_changes_the_hash() {
+  uint32_t ref = hashBlock(mainBuf.data(), W, H, 3, 2);
+  for (int y = 32; y < 48; y++) {
+    for (int x = 48; x < 64; x++) {
+      for (int bit = 0; bit < 16; bit++) {
+        shadowBuf[y * W + x] ^= 1u << bit;
+        TEST_ASSERT_TRUE(hashBlock(shadowBuf.data(), W, H, 3, 2) != ref);
+        shadowBuf[y * W + x] ^= 1u << bit;
+      }
+    }
+  }
+  TEST_ASSERT_EQUAL_HEX32(ref, hashBlock(shadowBuf.data(), W, H, 3, 2));
+}
+
+void test_mark_blocks_covers_each_block_once() {
+  uint32_t rows[MAX_BLOCKS_Y];
+
+  // 1 px into four blocks around (16,16)
+  Rect corner = {15, 15, 2, 2};
+  TEST_ASSERT_EQUAL_UINT16(4, markBlocks(&corner, 1, W, H, rows));
+  TEST_ASSERT_EQUAL_HEX32(0x3, rows[0]);
+  TEST_ASSERT_EQUAL_HEX32(0x3, rows[1]);
+  TEST_ASSERT_EQUAL_HEX32(0x0, rows[2]);
+
+  // Overlapping rects: shared blocks once
+  Rect two[] = {{0, 0, 48, 16}, {32, 0, 32, 16}};
+  TEST_ASSERT_EQUAL_UINT16(4, markBlocks(two, 2, W, H, rows));
+
+  // Clipped to the screen, empty and off-screen rects ignored
+  Rect odd[] = {{-20, -20, 40, 40}, {470, 310, 100, 100}, {10, 10, 0, 5},
+                {600, 0, 10, 10}};
+  TEST_ASSERT_EQUAL_UINT16(4 + 1, markBlocks(odd, 4, W, H, rows));
+  TEST_ASSERT_EQUAL_HEX32(0x3 | (1u << 29), rows[0] | rows[19]);
+
+  Rect full = {0, 0, W, H};
+  TEST_ASSERT_EQUAL_UINT16(600, markBlocks(&full, 1, W, H, rows));
+}
+
+void test_identical_buffers_match() {
+  Rect full = {0, 0, W, H};
+  Result r = compare(mainBuf.data(), shadowBuf.data(), W, H, &full, 1);
+  TEST_ASSERT_EQUAL_UINT16(600, r.blocksCompared);
+  TEST_ASSERT_EQUAL_UINT16(0, r.mismatches);
+  TEST_ASSERT_EQUAL_INT16(-1, r.firstX);
+}
+
+void test_single_pixel_difference_is_located() {
+  shadowBuf[200 * W + 100] ^= 0x0001; // Block (6, 12)
+  shadowBuf[300 * W + 479] ^= 0x8000; // Block (29, 18)
+  Rect full = {0, 0, W, H};
+  Result r = compare(mainBuf.data(), shadowBuf.data(), W, H, &full, 1);
+  TEST_ASSERT_EQUAL_UINT16(2, r.mismatches);
+  TEST_ASSERT_EQUAL_INT16(6, r.firstX);
+  TEST_ASSERT_EQUAL_INT16(12, r.firstY);
+}
+
+// Two pixels trading places on a diagonal: XOR of pixel ^ (x + y) is
+// unchanged, the block hash is not
+void test_swapped_pixels_detected() {
+  int a = 5 * W + 6, b = 6 * W + 5; // Same x + y, same block
+  std::swap(shadowBuf[a], shadowBuf[b]);
+  TEST_ASSERT_EQUAL_HEX16(oldChecksum(mainBuf.data(), 0, 0),
+                          oldChecksum(shadowBuf.data(), 0, 0));
+
+  Rect r0 = {0, 0, 16, 16};
+  Result r = compare(mainBuf.data(), shadowBuf.data(), W, H, &r0, 1);
+  TEST_ASSERT_EQUAL_UINT16(1, r.mismatches);
+}
+
+// Only the dirty set is validated: a difference elsewhere is not looked at
+void test_only_dirty_blocks_compared() {
+  shadowBuf[300 * W + 400] ^= 0xFFFF;
+  Rect gauge = {0, 0, 100, 60};
+  Result r = compare(mainBuf.data(), shadowBuf.data(), W, H, &gauge, 1);
+  TEST_ASSERT_EQUAL_UINT16(7 * 4, r.blocksCompared);
+  TEST_ASSERT_EQUAL_UINT16(0, r.mismatches);
+}
+
+void test_partial_edge_blocks() {
+  static constexpr int EW = 100, EH = 50; // 7 x 4 blocks, last ones partial
+  std::vector<uint16_t> a(EW * EH, 0x1234), b(EW * EH, 0x1234);
+  Rect full = {0, 0, EW, EH};
+  TEST_ASSERT_EQUAL_UINT16(0, compare(a.data(), b.data(), EW, EH, &full, 1)
+                                  .mismatches);
+  b[EW * EH - 1] = 0;
+  Result r = compare(a.data(), b.data(), EW, EH, &full, 1);
+  TEST_ASSERT_EQUAL_UINT16(28, r.blocksCompared);
+  TEST_ASSERT_EQUAL_UINT16(1, r.mismatches);
+  TEST_ASSERT_EQUAL_INT16(6, r.firstX);
+  TEST_ASSERT_EQUAL_INT16(3, r.firstY);
+}
+
+// ---------------------------------------------------------------------------
+// Benchmark: µs per compared frame (host)
+// ---------------------------------------------------------------------------
+
+struct Scene {
+  const char *name;
+  Rect rects[16];
+  int count;
+};
+
+template <typename F> static double usPerFrame(F &&frame, int frames) {
+  using Clock = std::chrono::steady_clock;
+  auto t0 = Clock::now();
+  for (int i = 0; i < frames; i++) frame();
+  auto t1 = Clock::now();
+  return std::chrono::duration<double, std::micro>(t1 - t0).count() / frames;
+}
+
+void test_benchmark_us_per_compared_frame() {
+  // Typical HUD frames: speed/RPM digits and a gauge arc; a menu closing
+  // (half screen); the first frame (full screen); the 16-rect worst case
+  static const Scene scenes[] = {
+      {"gauges (3 rects)",
+       {{40, 90, 120, 60}, {320, 90, 120, 60}, {200, 250, 80, 30}},
+       3},
+      {"half screen", {{0, 0, W, H / 2}}, 1},
+      {"full screen", {{0, 0, W, H}}, 1},
+      {"16 small rects", {}, 16},
+  };
+  Scene worst = scenes[3];
+  for (int i = 0; i < 16; i++) {
+    worst.rects[i] = {int16_t((i % 4) * 120 + 7), int16_t((i / 4) * 80 + 9),
+                      40, 30};
+  }
+
+  printf("\n  %-18s %7s %12s %12s %8s\n", "dirty set", "blocks",
+         "readPixel us", "hash us", "speedup");
+  for (int s = 0; s < 4; s++) {
+    const Scene &sc = (s == 3) ? worst : scenes[s];
+    uint32_t rows[MAX_BLOCKS_Y];
+    uint16_t blocks = markBlocks(sc.rects, sc.count, W, H, rows);
+    int frames = blocks > 300 ? 20 : 200;
+
+    volatile uint32_t sink = 0;
+    double oldUs = usPerFrame(
+        [&] {
+          sink += oldCompare(mainBuf.data(), shadowBuf.data(), sc.rects,
+                             sc.count);
+        },
+        frames);
+    double newUs = usPerFrame(
+        [&] {
+          sink += compare(mainBuf.data(), shadowBuf.data(), W, H, sc.rects,
+                          sc.count)
+                      .mismatches;
+        },
+        frames);
+    printf("  %-18s %7u %12.1f %12.1f %7.1fx\n", sc.name, blocks, oldUs,
+           newUs, oldUs / newUs);
+    TEST_ASSERT_EQUAL_UINT32(0, sink);
+    TEST_ASSERT_TRUE(newUs < oldUs);
+  }
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_every_single_bit_flip_changes_the_hash);
+  RUN_TEST(test_mark_blocks_covers_each_block_once);
+  RUN_TEST(test_identical_buffers_match);
+  RUN_TEST(test_single_pixel_difference_is_located);
+  RUN_TEST(test_swapped_pixels_detected);
+  RUN_TEST(test_only_dirty_blocks_compared);
+  RUN_TEST(test_partial_edge_blocks);
+  RUN_TEST(test_benchmark_us_per_compared_frame);
+  return UNITY_END();
+}
@@ -0,0 +1,231 @@
+// ============================================================================
+// test_main.cpp - Shared SPI bus arbiter
+// Run: pio test -e native -f test_spi_bus
+//
+// Grant order by priority (FIFO within one), withdrawn requests, device
+// switch counting and per-device utilization on a virtual clock. Then a
+// frame (layer composition and dirty-rect pushes) against 100 Hz touch
+// sampling: the longest touch wait with the old frame-long hold against
+// the yield points, and the longest frame wait for a touch sample.
+// ============================================================================
+
+#include "spi_bus.h"
+#include <cstdio>
+#include <unity.h>
+
+using namespace SpiBus;
+
+static const uint8_t D = static_cast<uint8_t>(Device::DISPLAY);
+static const uint8_t T = static_cast<uint8_t>(Device::TOUCH);
+static const uint8_t SD = 2; // A future device at the display's priority
+
+static void setupDevices(Arbiter &a) {
+  a.configure(D, {"display", PRIORITY_DISPLAY, 40000000, 15, nullptr,
+                  nullptr});
+  a.configure(T, {"touch", PRIORITY_TOUCH, 2500000, 21, nullptr, nullptr});
+  a.configure(SD, {"sd", PRIORITY_DISPLAY, 20000000, 5, nullptr, nullptr});
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_free_bus_is_granted_at_once() {
+  Arbiter a;
+  setupDevices(a);
+  TEST_ASSERT_EQUAL_UINT8(NONE, a.owner());
+  TEST_ASSERT_TRUE(a.request(D, 100));
+  TEST_ASSERT_EQUAL_UINT8(D, a.owner());
+  TEST_ASSERT_FALSE(a.contended());
+  TEST_ASSERT_FALSE(a.request(D, 150)); // No re-entrant grants
+  TEST_ASSERT_EQUAL_UINT8(NONE, a.release(D, 200));
+  TEST_ASSERT_EQUAL_UINT8(NONE, a.owner());
+  TEST_ASSERT_EQUAL_UINT8(NONE, a.release(T, 300)); // Not the owner
+}
+
+void test_priority_then_fifo() {
+  Arbiter a;
+  setupDevices(a);
+  TEST_ASSERT_TRUE(a.request(D, 0));
+  TEST_ASSERT_FALSE(a.request(SD, 10)); // Same priority as the display
+  TEST_ASSERT_FALSE(a.request(T, 20));  // Later, but higher priority
+  TEST_ASSERT_TRUE(a.contended());
+
+  TEST_ASSERT_EQUAL_UINT8(T, a.release(D, 100));
+  TEST_ASSERT_FALSE(a.request(D, 110)); // Back in the queue behind SD
+  TEST_ASSERT_EQUAL_UINT8(SD, a.release(T, 400));
+  TEST_ASSERT_EQUAL_UINT8(D, a.release(SD, 900));
+  TEST_ASSERT_EQUAL_UINT8(NONE, a.release(D, 1000));
+
+  TEST_ASSERT_EQUAL_UINT32(80, a.stats(T).maxWaitUs);
+  TEST_ASSERT_EQUAL_UINT32(390, a.stats(SD).maxWaitUs);
+  TEST_ASSERT_EQUAL_UINT32(790, a.stats(D).maxWaitUs);
+}
+
+void test_cancelled_request_is_not_granted() {
+  Arbiter a;
+  setupDevices(a);
+  a.request(D, 0);
+  a.request(T, 10);
+  TEST_ASSERT_TRUE(a.cancel(T, 50000)); // BUS_WAIT_MS ran out
+  TEST_ASSERT_FALSE(a.contended());
+  TEST_ASSERT_EQUAL_UINT8(NONE, a.release(D, 60000));
+  TEST_ASSERT_EQUAL_UINT32(1, a.stats(T).timeouts);
+  TEST_ASSERT_EQUAL_UINT32(0, a.stats(T).transactions);
+
+  // Granted before the waiter could cancel: it owns the bus
+  a.request(D, 70000);
+  a.request(T, 70010);
+  a.release(D, 70100);
+  TEST_ASSERT_FALSE(a.cancel(T, 70200));
+  TEST_ASSERT_EQUAL_UINT8(T, a.owner());
+}
+
+void test_switches_counted_only_between_devices() {
+  Arbiter a;
+  setupDevices(a);
+  for (uint32_t i = 0; i < 10; i++) {
+    a.request(D, i * 1000);
+    a.release(D, i * 1000 + 500);
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, a.reconfigurations());
+  a.request(T, 20000);
+  a.release(T, 20300);
+  a.request(D, 21000);
+  a.release(D, 22000);
+  TEST_ASSERT_EQUAL_UINT32(2, a.reconfigurations());
+}
+
+void test_utilization_per_window() {
+  Arbiter a;
+  setupDevices(a);
+  // One second: display 6 ms of every 16, touch 0.3 ms of every 10
+  for (uint32_t t = 0; t < WINDOW_US; t += 16000) {
+    a.request(D, t);
+    a.release(D, t + 6000);
+  }
+  for (uint32_t t = 0; t <= WINDOW_US + 10000; t += 10000) {
+    a.request(T, t + 8000);
+    a.release(T, t + 8300);
+  }
+  a.request(D, WINDOW_US + 20000);
+  a.release(D, WINDOW_US + 20001);
+
+  printf("  display %u permille, touch %u permille\n",
+         (unsigned)a.stats(D).utilizationPermille,
+         (unsigned)a.stats(T).utilizationPermille);
+  TEST_ASSERT_UINT16_WITHIN(10, 375, a.stats(D).utilizationPermille);
+  TEST_ASSERT_UINT16_WITHIN(3, 30, a.stats(T).utilizationPermille);
+}
+
+// --- Frame against touch sampling ---
+
+struct Segment {
+  uint32_t us;
+  bool safePoint; // No transfer open afterwards (compositor yield point)
+};
+
+// BASE, STATUS, DIAGNOSTICS, OVERLAY composition, then 10 dirty rects
+static const Segment FRAME[] = {
+    {4000, true}, {500, true}, {500, true}, {500, true}, {600, true},
+    {600, true},  {600, true}, {600, true}, {600, true}, {600, true},
+    {600, true},  {600, true}, {600, true}, {600, true},
+};
+static const uint32_t FRAME_PERIOD_US = 16000;
+static const uint32_t TOUCH_PERIOD_US = 10000; // SAMPLE_PERIOD_MS
+static const uint32_t TOUCH_US = 300;          // MEDIAN_TAPS conversions
+static const int FRAMES = 200;
+
+struct SimResult {
+  uint32_t maxTouchWaitUs;
+  uint32_t maxFrameWaitUs;
+  uint32_t touchSamples;
+  uint32_t yields;
+  uint32_t badGrants; // Grants not in the expected order
+};
+
+static SimResult simulate(bool yieldPoints) {
+  Arbiter a;
+  setupDevices(a);
+  uint32_t now = 0;
+  uint32_t nextTouch = 1700;
+  uint32_t samples = 0;
+  uint32_t badGrants = 0;
+
+  auto runTouch = [&]() {
+    now += TOUCH_US;
+    samples++;
+    uint8_t next = a.release(T, now);
+    while (nextTouch <= now) nextTouch += TOUCH_PERIOD_US;
+    return next;
+  };
+
+  for (int f = 0; f < FRAMES; f++) {
+    uint32_t frameStart = f * FRAME_PERIOD_US;
+    // Samples before the frame find the bus idle
+    while (nextTouch < frameStart) {
+      if (now < nextTouch) now = nextTouch;
+      if (!a.request(T, now)) badGrants++;
+      runTouch();
+    }
+    if (now < frameStart) now = frameStart;
+    if (!a.request(D, now)) badGrants++;
+
+    for (const Segment &seg : FRAME) {
+      now += seg.us;
+      // The touch task wakes during the segment and queues
+      if (nextTouch <= now && !a.isWaiting(T)) a.request(T, nextTouch);
+      if (yieldPoints && seg.safePoint && a.contended()) {
+        a.noteYield(D);
+        if (a.release(D, now) != T) badGrants++;
+        a.request(D, now); // yieldIfContended() reacquires at once
+        if (runTouch() != D) badGrants++;
+      }
+    }
+    if (a.release(D, now) == T) runTouch();
+  }
+
+  SimResult r;
+  r.maxTouchWaitUs = a.stats(T).maxWaitUs;
+  r.maxFrameWaitUs = a.stats(D).maxWaitUs;
+  r.touchSamples = samples;
+  r.yields = a.stats(D).yields;
+  r.badGrants = badGrants;
+  return r;
+}
+
+void test_touch_never_waits_a_whole_frame() {
+  SimResult held = simulate(false);
+  SimResult paced = simulate(true);
+
+  printf("  touch wait max: %u us frame-long hold, %u us with yields "
+         "(%u yields)\n",
+         (unsigned)held.maxTouchWaitUs, (unsigned)paced.maxTouchWaitUs,
+         (unsigned)paced.yields);
+  printf("  frame wait max for a touch sample: %u us; samples %u held, "
+         "%u with yields\n",
+         (unsigned)paced.maxFrameWaitUs, (unsigned)held.touchSamples,
+         (unsigned)paced.touchSamples);
+
+  TEST_ASSERT_EQUAL_UINT32(0, held.badGrants);
+  TEST_ASSERT_EQUAL_UINT32(0, paced.badGrants);
+  // Held: up to the whole frame. Yields: at most the longest segment.
+  TEST_ASSERT_TRUE(held.maxTouchWaitUs > 9000);
+  TEST_ASSERT_TRUE(paced.maxTouchWaitUs <= FRAME[0].us);
+  // A frame (or its remainder) waits at most one touch sample
+  TEST_ASSERT_TRUE(paced.maxFrameWaitUs <= TOUCH_US);
+  // Every 10 ms sample taken with yields; the frame-long hold drops some
+  TEST_ASSERT_UINT32_WITHIN(2, FRAMES * FRAME_PERIOD_US / TOUCH_PERIOD_US,
+                            paced.touchSamples);
+  TEST_ASSERT_TRUE(held.touchSamples <= paced.touchSamples);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_free_bus_is_granted_at_once);
+  RUN_TEST(test_priority_then_fifo);
+  RUN_TEST(test_cancelled_request_is_not_granted);
+  RUN_TEST(test_switches_counted_only_between_devices);
+  RUN_TEST(test_utilization_per_window);
+  RUN_TEST(test_touch_never_waits_a_whole_frame);
+  return UNITY_END();
+}
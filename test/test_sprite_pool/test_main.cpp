@@ -0,0 +1,355 @@
+// ============================================================================
+// test_main.cpp - Sprite buffer slab arena
+// Run: pio test -e native -f test_sprite_pool
+//
+// Handles (rounding, stale and double releases, generations), placement
+// (large and small regions, best fit, small from the top), largest free run
+// and fragmentation. Then churn: the boot sprites stay while shadow mode
+// toggles, layers are rebuilt and menu panels come and go, with every step
+// checked against a slab recount; no sprite is ever refused. The same
+// churn on one shared first-fit heap, interleaved with the rest of the
+// firmware's PSRAM allocations, is printed for comparison.
+// ============================================================================
+
+#include "sprite_pool.h"
+#include <cstdio>
+#include <cstring>
+#include <unity.h>
+#include <vector>
+
+using namespace SpritePool;
+
+static const uint32_t SCREEN_SLABS = SCREEN_SPRITE_BYTES / SLAB_BYTES;
+static uint8_t memory[MAX_SLABS * SLAB_BYTES];
+
+void setUp() {}
+void tearDown() {}
+
+void test_handles_resolve_and_go_stale() {
+  Arena a;
+  TEST_ASSERT_FALSE(a.isReady());
+  TEST_ASSERT_EQUAL_UINT16(INVALID, a.acquire(100, 0));
+  TEST_ASSERT_TRUE(a.init(memory, 10 * SLAB_BYTES + 100, 10 * SLAB_BYTES)); // Rounded down
+  TEST_ASSERT_EQUAL_UINT32(10 * SLAB_BYTES, a.stats().totalBytes);
+
+  Handle h = a.acquire(SLAB_BYTES + 1, 1);
+  TEST_ASSERT_TRUE(h != INVALID);
+  TEST_ASSERT_EQUAL_UINT32(2 * SLAB_BYTES, a.size(h));
+  uint8_t *p = static_cast<uint8_t *>(a.pointer(h));
+  TEST_ASSERT_TRUE(p >= memory && p + a.size(h) <= memory + 10 * SLAB_BYTES);
+  TEST_ASSERT_EQUAL_UINT32(0, (p - memory) % SLAB_BYTES);
+
+  TEST_ASSERT_TRUE(a.release(h));
+  TEST_ASSERT_FALSE(a.valid(h));
+  TEST_ASSERT_NULL(a.pointer(h));
+  TEST_ASSERT_FALSE(a.release(h)); // Double release
+  TEST_ASSERT_FALSE(a.release(0x0107)); // Never issued
+  TEST_ASSERT_EQUAL_UINT32(2, a.stats().staleReleases);
+
+  // Same slot again, new generation: the old handle stays dead
+  Handle h2 = a.acquire(SLAB_BYTES, 2);
+  TEST_ASSERT_TRUE(h2 != h);
+  TEST_ASSERT_FALSE(a.valid(h));
+  TEST_ASSERT_TRUE(a.valid(h2));
+
+  // Too big, or out of handles
+  TEST_ASSERT_EQUAL_UINT16(INVALID, a.acquire(11 * SLAB_BYTES, 3));
+  Arena b;
+  b.init(memory, 40 * SLAB_BYTES, 40 * SLAB_BYTES);
+  for (uint8_t i = 0; i < MAX_BUFFERS; i++) b.acquire(SLAB_BYTES, i);
+  TEST_ASSERT_EQUAL_UINT16(INVALID, b.acquire(SLAB_BYTES, 0));
+  TEST_ASSERT_EQUAL_UINT32(1, b.stats().failures);
+}
+
+void test_regions_best_fit_small_at_top() {
+  // Large region 0..259, small region 260..299
+  Arena a;
+  a.init(memory, 300 * SLAB_BYTES, 40 * SLAB_BYTES);
+  Handle s1 = a.acquire(SCREEN_SPRITE_BYTES, 0); // 0..74
+  Handle s2 = a.acquire(SCREEN_SPRITE_BYTES, 1); // 75..149
+  Handle s3 = a.acquire(SCREEN_SPRITE_BYTES, 2); // 150..224
+  TEST_ASSERT_EQUAL_PTR(memory + 150 * SLAB_BYTES, a.pointer(s3));
+  TEST_ASSERT_EQUAL_UINT16(INVALID, a.acquire(SCREEN_SPRITE_BYTES, 9));
+
+  // Small buffers stack down from the top of their region
+  Handle m1 = a.acquire(76800, 3); // 19 slabs: 281..299
+  Handle m2 = a.acquire(25600, 4); // 7 slabs: 274..280
+  TEST_ASSERT_EQUAL_PTR(memory + 281 * SLAB_BYTES, a.pointer(m1));
+  TEST_ASSERT_EQUAL_PTR(memory + 274 * SLAB_BYTES, a.pointer(m2));
+
+  // A screen hole in the large region is never taken by a small buffer
+  a.release(s2);
+  Handle m3 = a.acquire(25600, 5);
+  TEST_ASSERT_EQUAL_PTR(memory + 267 * SLAB_BYTES, a.pointer(m3));
+  TEST_ASSERT_EQUAL_UINT16(INVALID, a.acquire(76800, 8)); // Budget spent
+  Handle s4 = a.acquire(SCREEN_SPRITE_BYTES, 6);
+  TEST_ASSERT_EQUAL_PTR(memory + 75 * SLAB_BYTES, a.pointer(s4));
+
+  // Best fit among large runs: the 35-slab tail, not the screen hole
+  a.release(s1);
+  Handle big = a.acquire(33 * SLAB_BYTES, 7);
+  TEST_ASSERT_EQUAL_PTR(memory + 225 * SLAB_BYTES, a.pointer(big));
+  TEST_ASSERT_EQUAL_UINT32(2, a.stats().failures);
+
+  char dump[301];
+  a.describe(dump, sizeof(dump));
+  TEST_ASSERT_EQUAL_CHAR('.', dump[0]);
+  TEST_ASSERT_EQUAL_CHAR('G', dump[75]);
+  TEST_ASSERT_EQUAL_CHAR('H', dump[225]);
+  TEST_ASSERT_EQUAL_CHAR('.', dump[260]);
+  TEST_ASSERT_EQUAL_CHAR('F', dump[267]);
+  TEST_ASSERT_EQUAL_CHAR('D', dump[299]);
+}
+
+void test_largest_free_and_fragmentation() {
+  Arena a;
+  a.init(memory, 100 * SLAB_BYTES, 100 * SLAB_BYTES); // Small only
+  Stats s = a.stats();
+  TEST_ASSERT_EQUAL_UINT32(100 * SLAB_BYTES, s.largestFreeBytes);
+  TEST_ASSERT_EQUAL_UINT8(0, s.fragmentationPct);
+
+  Handle h[5];
+  for (int i = 0; i < 5; i++) h[i] = a.acquire(20 * SLAB_BYTES, i);
+  a.release(h[1]); // Holes of 20 and 20 slabs
+  a.release(h[3]);
+  s = a.stats();
+  TEST_ASSERT_EQUAL_UINT32(20 * SLAB_BYTES, s.largestFreeBytes);
+  TEST_ASSERT_EQUAL_UINT8(50, s.fragmentationPct);
+  TEST_ASSERT_EQUAL_UINT32(60 * SLAB_BYTES, s.usedBytes);
+  TEST_ASSERT_EQUAL_UINT32(100 * SLAB_BYTES, s.peakUsedBytes);
+  TEST_ASSERT_EQUAL_UINT8(3, s.liveBuffers);
+
+  a.release(h[2]); // Holes merge
+  s = a.stats();
+  TEST_ASSERT_EQUAL_UINT32(60 * SLAB_BYTES, s.largestFreeBytes);
+  TEST_ASSERT_EQUAL_UINT8(0, s.fragmentationPct);
+}
+
+// --- Churn ---
+
+static uint32_t rng = 1;
+static uint32_t nextRand(uint32_t n) {
+  rng = rng * 1103515245u + 12345u;
+  return (rng >> 16) % n;
+}
+
+// Recount from the handles: no overlap, and the stats agree
+static bool consistent(const Arena &a, const std::vector<Handle> &live) {
+  std::vector<int> owner(a.stats().totalBytes / SLAB_BYTES, -1);
+  uint32_t used = 0;
+  for (size_t i = 0; i < live.size(); i++) {
+    uint8_t *p = static_cast<uint8_t *>(a.pointer(live[i]));
+    if (!p) return false;
+    uint32_t first = (p - memory) / SLAB_BYTES;
+    uint32_t n = a.size(live[i]) / SLAB_BYTES;
+    for (uint32_t s = first; s < first + n; s++) {
+      if (s >= owner.size() || owner[s] >= 0) return false;
+      owner[s] = static_cast<int>(i);
+    }
+    used += n * SLAB_BYTES;
+  }
+  uint32_t best = 0, run = 0;
+  for (int o : owner) {
+    run = o < 0 ? run + 1 : 0;
+    if (run > best) best = run;
+  }
+  Stats s = a.stats();
+  return s.usedBytes == used && s.largestFreeBytes == best * SLAB_BYTES &&
+         s.liveBuffers == live.size();
+}
+
+static const uint32_t MENU_PANELS[] = {
+    240 * 160 * 2, // Menu panel
+    320 * 120 * 2, // Keypad
+    160 * 80 * 2,  // Popup
+};
+
+void test_churn_never_fails_a_sprite() {
+  // Seven sprites at boot plus a toggled shadow (more than the firmware's
+  // SPRITE_BUDGET), and a small region for three menu panels
+  Arena a;
+  const uint32_t menuBytes = 3 * 19 * SLAB_BYTES;
+  a.init(memory, 8 * SCREEN_SPRITE_BYTES + menuBytes, menuBytes);
+  std::vector<Handle> boot;
+  for (uint8_t i = 0; i < 7; i++) {
+    boot.push_back(a.acquire(SCREEN_SPRITE_BYTES, i));
+  }
+
+  rng = 7;
+  Handle shadow = INVALID;
+  std::vector<Handle> menus;
+  uint32_t inconsistent = 0, worstFrag = 0, minLargest = UINT32_MAX;
+  uint32_t menuFailures = 0;
+  const int STEPS = 20000;
+  for (int step = 0; step < STEPS; step++) {
+    switch (nextRand(4)) {
+    case 0: // Shadow mode toggled
+      if (shadow != INVALID) {
+        a.release(shadow);
+        shadow = INVALID;
+      } else {
+        shadow = a.acquire(SCREEN_SPRITE_BYTES, 7);
+      }
+      break;
+    case 1: { // Layer sprite rebuilt
+      uint32_t l = nextRand(boot.size());
+      a.release(boot[l]);
+      boot[l] = a.acquire(SCREEN_SPRITE_BYTES, static_cast<uint8_t>(l));
+      if (boot[l] == INVALID) {
+        boot.erase(boot.begin() + l); // Counted in failures
+      }
+      break;
+    }
+    case 2: // Menu opened (three at most)
+      if (menus.size() < 3) {
+        Handle m = a.acquire(MENU_PANELS[nextRand(3)], 10);
+        if (m != INVALID) menus.push_back(m);
+        else menuFailures++;
+      }
+      break;
+    default: // Menu closed
+      if (!menus.empty()) {
+        uint32_t m = nextRand(menus.size());
+        a.release(menus[m]);
+        menus.erase(menus.begin() + m);
+      }
+      break;
+    }
+
+    std::vector<Handle> live(boot);
+    if (shadow != INVALID) live.push_back(shadow);
+    live.insert(live.end(), menus.begin(), menus.end());
+    if (!consistent(a, live)) inconsistent++;
+    Stats s = a.stats();
+    if (s.fragmentationPct > worstFrag) worstFrag = s.fragmentationPct;
+    if (s.largestFreeBytes < minLargest) minLargest = s.largestFreeBytes;
+  }
+
+  Stats s = a.stats();
+  char dump[80];
+  a.describe(dump, sizeof(dump));
+  printf("  %d steps: %u acquires, %u menu panels refused, worst "
+         "fragmentation %u%%, peak %u KB of %u KB\n  map: %s...\n",
+         STEPS, (unsigned)s.acquires, (unsigned)menuFailures,
+         (unsigned)worstFrag, (unsigned)(s.peakUsedBytes / 1024),
+         (unsigned)(s.totalBytes / 1024), dump);
+  TEST_ASSERT_EQUAL_UINT32(0, inconsistent);
+  // Menu panels can fragment their own region; sprites are never refused
+  TEST_ASSERT_EQUAL_UINT32(menuFailures, s.failures);
+  TEST_ASSERT_EQUAL_UINT32(7, boot.size());
+  TEST_ASSERT_EQUAL_UINT32(0, s.staleReleases);
+}
+
+void test_screen_only_churn_stays_unfragmented() {
+  Arena a;
+  a.init(memory, 9 * SCREEN_SPRITE_BYTES);
+  Handle h[9];
+  for (uint8_t i = 0; i < 8; i++) h[i] = a.acquire(SCREEN_SPRITE_BYTES, i);
+  h[8] = INVALID;
+  rng = 3;
+  for (int step = 0; step < 5000; step++) {
+    uint32_t i = nextRand(9);
+    if (h[i] != INVALID) {
+      a.release(h[i]);
+      h[i] = INVALID;
+    } else {
+      h[i] = a.acquire(SCREEN_SPRITE_BYTES, static_cast<uint8_t>(i));
+      TEST_ASSERT_TRUE(h[i] != INVALID);
+    }
+  }
+  // Whole screens in whole-screen slots: any free screen can be reused
+  Stats s = a.stats();
+  TEST_ASSERT_EQUAL_UINT32(0, s.failures);
+  TEST_ASSERT_EQUAL_UINT32(0, s.largestFreeBytes % SCREEN_SPRITE_BYTES);
+}
+
+// Old layout: sprites and everything else in one first-fit PSRAM heap
+struct SharedHeap {
+  static const uint32_t UNIT = 1024;
+  std::vector<bool> used;
+  explicit SharedHeap(uint32_t bytes) : used(bytes / UNIT, false) {}
+  int32_t alloc(uint32_t bytes) {
+    uint32_t need = (bytes + UNIT - 1) / UNIT, run = 0;
+    for (uint32_t i = 0; i < used.size(); i++) {
+      run = used[i] ? 0 : run + 1;
+      if (run == need) {
+        uint32_t first = i + 1 - need;
+        for (uint32_t k = first; k <= i; k++) used[k] = true;
+        return static_cast<int32_t>(first);
+      }
+    }
+    return -1;
+  }
+  void release(int32_t first, uint32_t bytes) {
+    if (first < 0) return;
+    uint32_t need = (bytes + UNIT - 1) / UNIT;
+    for (uint32_t k = first; k < first + need; k++) used[k] = false;
+  }
+  uint32_t largestFree() const {
+    uint32_t best = 0, run = 0;
+    for (bool u : used) {
+      run = u ? 0 : run + 1;
+      if (run > best) best = run;
+    }
+    return best * UNIT;
+  }
+};
+
+void test_shared_heap_comparison() {
+  // 4 MB: sprites plus logs, black box, audio and JSON buffers
+  SharedHeap heap(4u * 1024 * 1024);
+  std::vector<int32_t> sprites;
+  for (int i = 0; i < 7; i++) sprites.push_back(heap.alloc(SCREEN_SPRITE_BYTES));
+
+  struct Small {
+    int32_t at;
+    uint32_t bytes;
+  };
+  std::vector<Small> others;
+  rng = 11;
+  int32_t shadow = -1;
+  uint32_t spriteFailures = 0, minLargest = UINT32_MAX;
+  for (int step = 0; step < 20000; step++) {
+    uint32_t op = nextRand(6);
+    if (op == 0) {
+      if (shadow >= 0) {
+        heap.release(shadow, SCREEN_SPRITE_BYTES);
+        shadow = -1;
+      } else {
+        shadow = heap.alloc(SCREEN_SPRITE_BYTES);
+        if (shadow < 0) spriteFailures++;
+      }
+    } else if (op == 1) {
+      uint32_t l = nextRand(sprites.size());
+      heap.release(sprites[l], SCREEN_SPRITE_BYTES);
+      sprites[l] = heap.alloc(SCREEN_SPRITE_BYTES);
+      if (sprites[l] < 0) spriteFailures++;
+    } else if (op < 4 && others.size() < 120) {
+      uint32_t bytes = 1024 + nextRand(64) * 1024;
+      others.push_back({heap.alloc(bytes), bytes});
+    } else if (!others.empty()) {
+      uint32_t k = nextRand(others.size());
+      heap.release(others[k].at, others[k].bytes);
+      others.erase(others.begin() + k);
+    }
+    uint32_t largest = heap.largestFree();
+    if (largest < minLargest) minLargest = largest;
+  }
+  printf("  shared first-fit heap, same churn: %u sprite allocations failed, "
+         "largest free block down to %u KB\n",
+         (unsigned)spriteFailures, (unsigned)(minLargest / 1024));
+  // The failure mode the arena removes: a sprite refused with enough free
+  // memory in total
+  TEST_ASSERT_TRUE(spriteFailures > 0);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_handles_resolve_and_go_stale);
+  RUN_TEST(test_regions_best_fit_small_at_top);
+  RUN_TEST(test_largest_free_and_fragmentation);
+  RUN_TEST(test_churn_never_fails_a_sprite);
+  RUN_TEST(test_screen_only_churn_stays_unfragmented);
+  RUN_TEST(test_shared_heap_comparison);
+  return UNITY_END();
+}
@@ -0,0 +1,302 @@
+// ============================================================================
+// test_main.cpp - Tear-aware push ordering against the panel scan
+// Run: pio test -e native -f test_tear_sync
+//
+// Scan model: rotation 3 band mapping, TE phase and period (late folds,
+// bounces), scan/push overlap. Push order: a rect the scan is about to cross
+// is deferred, waits stay bounded, REPORT/OFF keep the natural order. Then a
+// panel with its own refresh clock driving frames of gauge-needle rects:
+// torn pushes in natural order against chasing the scan.
+// ============================================================================
+
+#include "tear_sync.h"
+#include <cstdio>
+#include <unity.h>
+
+using namespace TearSync;
+
+static const Geometry G = ST7796_ROTATION3;
+static const uint16_t TOTAL = G.activeLines + G.blankLines;
+
+void setUp() {}
+void tearDown() {}
+
+void test_band_follows_rotation3_scan_axis() {
+  ScanModel m;
+  uint16_t first, last;
+  // Scan starts at the right edge of the landscape screen
+  m.band({0, 100, 10, 50}, first, last);
+  TEST_ASSERT_EQUAL_UINT16(470, first);
+  TEST_ASSERT_EQUAL_UINT16(479, last);
+  m.band({470, 0, 10, 320}, first, last);
+  TEST_ASSERT_EQUAL_UINT16(0, first);
+  TEST_ASSERT_EQUAL_UINT16(9, last);
+  m.band({-20, 0, 500, 320}, first, last); // Clipped to the panel
+  TEST_ASSERT_EQUAL_UINT16(0, first);
+  TEST_ASSERT_EQUAL_UINT16(479, last);
+}
+
+void test_te_edges_set_phase_and_period() {
+  ScanModel m;
+  TEST_ASSERT_FALSE(m.valid());
+  const uint32_t P = 16000; // Panel refreshing faster than nominal
+
+  uint32_t t = 5000;
+  for (int i = 0; i < 40; i++) {
+    m.onTe(t);
+    // Folded late now and then: two periods between folds
+    t += (i % 5 == 4) ? 2 * P : P;
+  }
+  m.onTe(t);
+  m.onTe(t + 3000); // Bounce: re-phases, period untouched
+  m.onTe(t + P);
+
+  TEST_ASSERT_TRUE(m.source() == Source::TE_PIN);
+  TEST_ASSERT_TRUE(m.locked(t + P + 100));
+  TEST_ASSERT_FALSE(m.locked(t + 4 * P));
+  TEST_ASSERT_UINT32_WITHIN(60, P, m.periodUs());
+
+  uint32_t edge = t + P;
+  TEST_ASSERT_EQUAL_UINT16(G.activeLines, m.lineAt(edge));
+  // Blank lines, then line 0 and the active area
+  TEST_ASSERT_EQUAL_UINT16(0, m.lineAt(edge + G.blankLines * P / TOTAL + 5));
+  TEST_ASSERT_UINT32_WITHIN(2, 240,
+                            m.lineAt(edge + (G.blankLines + 240) * P / TOTAL));
+  TEST_ASSERT_EQUAL_UINT32(0, m.usUntil(edge, G.activeLines));
+  TEST_ASSERT_UINT32_WITHIN(2, (G.blankLines + 100) * P / TOTAL,
+                            m.usUntil(edge, 100));
+}
+
+void test_crossing_detected_only_on_overlap() {
+  ScanModel m;
+  m.anchor(0, 0);
+  TEST_ASSERT_TRUE(m.source() == Source::ESTIMATED);
+  TEST_ASSERT_FALSE(m.locked(0));
+  uint32_t lineUs = G.periodUs / TOTAL; // ~34 us
+
+  // Band 200..259 reached after ~6.8 ms
+  TEST_ASSERT_FALSE(m.crosses(200, 259, 0, 150 * lineUs));
+  TEST_ASSERT_TRUE(m.crosses(200, 259, 0, 210 * lineUs));
+  // Started inside the band
+  TEST_ASSERT_TRUE(m.crosses(200, 259, 230 * lineUs, 231 * lineUs));
+  // Started just past it: safe until the next refresh
+  TEST_ASSERT_FALSE(m.crosses(200, 259, 262 * lineUs, 400 * lineUs));
+  // Longer than a refresh always crosses
+  TEST_ASSERT_TRUE(m.crosses(0, 0, 1, 1 + G.periodUs));
+}
+
+void test_chase_defers_band_about_to_be_scanned() {
+  ScanModel m;
+  m.onTe(0); // Scan at the first blank line
+  // Rect A (x 400..479 -> lines 0..79) is next in the scan; B is far away
+  const Rect rects[] = {{400, 100, 80, 60}, {40, 100, 80, 60}};
+
+  PushOrder natural;
+  natural.begin(m, Mode::REPORT, rects, 2, 2);
+  uint32_t now = 0, wait;
+  int8_t i;
+  while ((i = natural.next(now, wait)) >= 0) {
+    uint32_t end = now + wait + natural.costUs(i);
+    natural.pushed(i, now + wait, end);
+    now = end;
+  }
+  const FrameReport &nr = natural.end();
+  TEST_ASSERT_FALSE(nr.reordered);
+  TEST_ASSERT_EQUAL_UINT8(1, nr.riskRects);
+
+  PushOrder chase;
+  chase.begin(m, Mode::CHASE, rects, 2, 2);
+  now = 0;
+  TEST_ASSERT_EQUAL_INT8(1, chase.next(now, wait)); // B while A is scanned
+  TEST_ASSERT_EQUAL_UINT32(0, wait);
+  uint32_t end = now + chase.costUs(1);
+  TEST_ASSERT_FALSE(chase.pushed(1, now, end));
+  now = end;
+  TEST_ASSERT_EQUAL_INT8(0, chase.next(now, wait));
+  end = now + wait + chase.costUs(0);
+  TEST_ASSERT_FALSE(chase.pushed(0, now + wait, end));
+  const FrameReport &cr = chase.end();
+  TEST_ASSERT_TRUE(cr.reordered);
+  TEST_ASSERT_EQUAL_UINT8(0, cr.riskRects);
+  TEST_ASSERT_TRUE(cr.waitUs <= PushOrder::MAX_WAIT_US);
+}
+
+void test_waits_bounded_and_unfit_rects_pushed_at_once() {
+  ScanModel m;
+  m.onTe(0);
+  uint32_t lineUs = G.periodUs / TOTAL;
+  uint32_t wait;
+
+  // Scan entering a needle band (lines 0..39): wait for it to pass
+  PushOrder o;
+  const Rect needle = {440, 40, 40, 40};
+  uint32_t now = (G.blankLines + 2) * lineUs;
+  o.begin(m, Mode::CHASE, &needle, 1, 2);
+  TEST_ASSERT_EQUAL_INT8(0, o.next(now, wait));
+  TEST_ASSERT_TRUE(wait > 0 && wait <= PushOrder::MAX_WAIT_US);
+  TEST_ASSERT_FALSE(o.pushed(0, now + wait, now + wait + o.costUs(0)));
+  o.end();
+
+  // Band too wide to clear within MAX_WAIT_US: no wait
+  const Rect wide = {200, 40, 240, 40};
+  o.begin(m, Mode::CHASE, &wide, 1, 2);
+  TEST_ASSERT_EQUAL_INT8(0, o.next(now, wait));
+  TEST_ASSERT_EQUAL_UINT32(0, wait);
+  o.pushed(0, now, now + o.costUs(0));
+  o.end();
+
+  // Full screen: longer than a refresh, never waited for, always at risk
+  const Rect full = {0, 0, 480, 320};
+  o.begin(m, Mode::CHASE, &full, 1, 1);
+  TEST_ASSERT_EQUAL_INT8(0, o.next(now, wait));
+  TEST_ASSERT_EQUAL_UINT32(0, wait);
+  TEST_ASSERT_TRUE(o.pushed(0, now, now + o.costUs(0)));
+  o.end();
+  TEST_ASSERT_EQUAL_UINT32(3, o.stats().frames);
+  TEST_ASSERT_EQUAL_UINT32(2, o.stats().riskFrames);
+}
+
+void test_off_and_unanchored_keep_order_without_reports() {
+  ScanModel none;
+  ScanModel m;
+  m.onTe(0);
+  const Rect rects[] = {{400, 0, 80, 60}, {40, 0, 80, 60}, {200, 0, 40, 40}};
+  uint32_t wait;
+
+  PushOrder o;
+  o.begin(none, Mode::CHASE, rects, 3, 2); // TE wired, no edge yet
+  for (int8_t k = 0; k < 3; k++) {
+    TEST_ASSERT_EQUAL_INT8(k, o.next(0, wait));
+    TEST_ASSERT_FALSE(o.pushed(k, 0, G.periodUs)); // Not judged
+  }
+  TEST_ASSERT_EQUAL_INT8(-1, o.next(0, wait));
+  o.end();
+
+  o.begin(m, Mode::OFF, rects, 3, 2);
+  for (int8_t k = 0; k < 3; k++) {
+    TEST_ASSERT_EQUAL_INT8(k, o.next(0, wait));
+    o.pushed(k, 0, G.periodUs);
+  }
+  o.end();
+  TEST_ASSERT_EQUAL_UINT32(0, o.stats().frames);
+  TEST_ASSERT_EQUAL_UINT32(0, o.stats().riskRects);
+}
+
+// --- Needle frames against a free-running panel ---
+
+static uint32_t rng = 12345;
+static uint32_t nextRand(uint32_t n) {
+  rng = rng * 1103515245u + 12345u;
+  return (rng >> 16) % n;
+}
+
+struct SimResult {
+  uint32_t frames;
+  uint32_t tornRects; // Judged against the real panel
+  uint32_t reportedRisk;
+  uint32_t rects;
+  uint32_t maxFrameWaitUs;
+  uint32_t nsPerPixel;
+};
+
+static const uint32_t PANEL_PERIOD_US = 16500; // Real panel, not nominal
+static const uint32_t TRUE_NS_PER_PIXEL = 420;  // 40 MHz plus gaps
+static const uint8_t LAYERS = 2;                // BASE + STATUS
+
+static SimResult simulate(Mode mode, int frames) {
+  rng = 12345;
+  ScanModel panel;  // Ground truth, every edge
+  ScanModel folded; // Firmware view, edges folded at frame start
+  PushOrder order;
+  uint32_t nextEdge = 3000;
+  uint32_t now = 0;
+  uint32_t lastFoldedEdge = 0;
+  SimResult r = {};
+
+  auto advanceEdges = [&](uint32_t until) {
+    while (static_cast<int32_t>(nextEdge - until) <= 0) {
+      panel.onTe(nextEdge);
+      lastFoldedEdge = nextEdge;
+      nextEdge += PANEL_PERIOD_US;
+    }
+  };
+
+  for (int f = 0; f < frames; f++) {
+    now = 20000 + f * 32000 + nextRand(3000); // ACTIVE pacing plus jitter
+    advanceEdges(now);
+    if (lastFoldedEdge) folded.onTe(lastFoldedEdge);
+
+    // Two gauge needles and a status digit box
+    Rect rects[3];
+    rects[0] = {static_cast<int16_t>(40 + nextRand(80)), 90,
+                static_cast<int16_t>(40 + nextRand(40)), 60};
+    rects[1] = {static_cast<int16_t>(280 + nextRand(80)), 90,
+                static_cast<int16_t>(40 + nextRand(40)), 60};
+    rects[2] = {static_cast<int16_t>(nextRand(440)), 10, 40, 20};
+
+    order.begin(folded, mode, rects, 3, LAYERS);
+    uint32_t wait;
+    int8_t i;
+    while ((i = order.next(now, wait)) >= 0) {
+      uint32_t start = now + wait;
+      uint32_t px = static_cast<uint32_t>(rects[i].w) * rects[i].h;
+      uint32_t end = start + LAYERS * (PushOrder::PUSH_OVERHEAD_US +
+                                       px * TRUE_NS_PER_PIXEL / 1000);
+      advanceEdges(start);
+      uint16_t first, last;
+      panel.band(rects[i], first, last);
+      if (panel.crosses(first, last, start, end)) r.tornRects++;
+      order.pushed(i, start, end);
+      now = end;
+    }
+    const FrameReport &fr = order.end();
+    r.reportedRisk += fr.riskRects;
+    r.rects += fr.rects;
+    if (fr.waitUs > r.maxFrameWaitUs) r.maxFrameWaitUs = fr.waitUs;
+    r.frames++;
+  }
+  r.nsPerPixel = order.stats().nsPerPixel;
+  return r;
+}
+
+void test_needle_frames_tear_less_when_chasing() {
+  const int FRAMES = 2000;
+  SimResult natural = simulate(Mode::REPORT, FRAMES);
+  SimResult chase = simulate(Mode::CHASE, FRAMES);
+
+  printf("  torn rects: %u/%u natural order, %u/%u chasing the scan "
+         "(max wait %u us/frame)\n",
+         (unsigned)natural.tornRects, (unsigned)natural.rects,
+         (unsigned)chase.tornRects, (unsigned)chase.rects,
+         (unsigned)chase.maxFrameWaitUs);
+
+  // The report matches the real panel (TE phase, measured period)
+  TEST_ASSERT_UINT32_WITHIN(natural.tornRects / 20 + 2, natural.tornRects,
+                            natural.reportedRisk);
+  TEST_ASSERT_UINT32_WITHIN(chase.tornRects / 20 + 2, chase.tornRects,
+                            chase.reportedRisk);
+  // Chasing removes nearly all of them within the wait budget
+  TEST_ASSERT_TRUE(natural.tornRects > natural.rects / 5);
+  TEST_ASSERT_TRUE(chase.tornRects * 10 < natural.tornRects);
+  TEST_ASSERT_TRUE(chase.maxFrameWaitUs <= 3 * PushOrder::MAX_WAIT_US);
+}
+
+void test_push_cost_is_learned() {
+  SimResult r = simulate(Mode::CHASE, 200);
+  printf("  learned push cost: %u ns/px (true %u)\n", (unsigned)r.nsPerPixel,
+         (unsigned)TRUE_NS_PER_PIXEL);
+  TEST_ASSERT_UINT32_WITHIN(10, TRUE_NS_PER_PIXEL, r.nsPerPixel);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_band_follows_rotation3_scan_axis);
+  RUN_TEST(test_te_edges_set_phase_and_period);
+  RUN_TEST(test_crossing_detected_only_on_overlap);
+  RUN_TEST(test_chase_defers_band_about_to_be_scanned);
+  RUN_TEST(test_waits_bounded_and_unfit_rects_pushed_at_once);
+  RUN_TEST(test_off_and_unanchored_keep_order_without_reports);
+  RUN_TEST(test_needle_frames_tear_less_when_chasing);
+  RUN_TEST(test_push_cost_is_learned);
+  return UNITY_END();
+}
@@ -0,0 +1,234 @@
+// ============================================================================
+// test_main.cpp - TouchInput filter, calibration and gestures (native test)
+// Run: pio test -e native -f test_touch_input
+//
+// Feeds synthetic XPT2046 conversions and pen traces on a virtual clock;
+// the sampling task only adds SPI reads and the event queue around these.
+// ============================================================================
+
+#include "touch_input.h"
+#include <unity.h>
+
+using namespace TouchInput;
+
+static const int16_t W = 480;
+static const int16_t H = 320;
+
+// Default calibration in hud.cpp: X inverted, Y normal
+static const uint16_t DEFAULT_CAL[5] = {3900, 200, 200, 3900, 3};
+
+static RawSample at(uint16_t x, uint16_t y, uint16_t z = 1200) {
+  RawSample s = {x, y, z};
+  return s;
+}
+
+void test_filter_median_rejects_spikes() {
+  Filter f;
+  RawSample out;
+  RawSample conv[MEDIAN_TAPS] = {at(2000, 1000), at(4000, 1002),
+                                 at(2004, 998),  at(2002, 30),
+                                 at(1998, 1001)};
+  TEST_ASSERT_TRUE(f.update(conv, MEDIAN_TAPS, out));
+  TEST_ASSERT_EQUAL_UINT16(2002, out.x);
+  TEST_ASSERT_EQUAL_UINT16(1000, out.y);
+}
+
+void test_filter_needs_pressure_majority() {
+  Filter f;
+  RawSample out;
+  // Pen lifting: only 2 of 5 conversions above PRESSURE_MIN
+  RawSample lifting[MEDIAN_TAPS] = {at(2000, 1000), at(2000, 1000, 100),
+                                    at(2000, 1000, 0), at(2000, 1000),
+                                    at(2000, 1000, 200)};
+  TEST_ASSERT_FALSE(f.update(lifting, MEDIAN_TAPS, out));
+
+  // Low-pressure conversions are excluded from the median
+  RawSample mostly[MEDIAN_TAPS] = {at(1000, 500), at(3000, 3000, 100),
+                                   at(1002, 502), at(1004, 504),
+                                   at(1006, 506)};
+  TEST_ASSERT_TRUE(f.update(mostly, MEDIAN_TAPS, out));
+  TEST_ASSERT_UINT16_WITHIN(4, 1003, out.x);
+  TEST_ASSERT_UINT16_WITHIN(4, 503, out.y);
+}
+
+void test_filter_iir_smooths_and_restarts_on_reset() {
+  Filter f;
+  RawSample out;
+  RawSample a[MEDIAN_TAPS] = {at(1000, 1000), at(1000, 1000), at(1000, 1000),
+                              at(1000, 1000), at(1000, 1000)};
+  RawSample b[MEDIAN_TAPS] = {at(2000, 3000), at(2000, 3000), at(2000, 3000),
+                              at(2000, 3000), at(2000, 3000)};
+
+  TEST_ASSERT_TRUE(f.update(a, MEDIAN_TAPS, out));
+  TEST_ASSERT_EQUAL_UINT16(1000, out.x); // First sample seeds the IIR
+
+  TEST_ASSERT_TRUE(f.update(b, MEDIAN_TAPS, out));
+  TEST_ASSERT_EQUAL_UINT16(1500, out.x); // alpha = 0.5
+  TEST_ASSERT_EQUAL_UINT16(2000, out.y);
+
+  for (int i = 0; i < 12; i++) f.update(b, MEDIAN_TAPS, out);
+  TEST_ASSERT_UINT16_WITHIN(1, 2000, out.x);
+  TEST_ASSERT_UINT16_WITHIN(1, 3000, out.y);
+
+  // New press: no smear from the previous position
+  f.reset();
+  TEST_ASSERT_TRUE(f.update(a, MEDIAN_TAPS, out));
+  TEST_ASSERT_EQUAL_UINT16(1000, out.x);
+}
+
+void test_calibration_maps_edges_and_inverted_axis() {
+  Calibration c;
+  TEST_ASSERT_TRUE(c.set(DEFAULT_CAL, W, H));
+
+  Point p = c.map(3900, 200); // X inverted: raw 3900 is the left edge
+  TEST_ASSERT_EQUAL_INT16(0, p.x);
+  TEST_ASSERT_EQUAL_INT16(0, p.y);
+
+  p = c.map(2050, 2050); // Centre
+  TEST_ASSERT_INT16_WITHIN(1, W / 2, p.x);
+  TEST_ASSERT_INT16_WITHIN(1, H / 2, p.y);
+
+  p = c.map(0, 4095); // Beyond the edges: clamped on screen
+  TEST_ASSERT_EQUAL_INT16(W - 1, p.x);
+  TEST_ASSERT_EQUAL_INT16(H - 1, p.y);
+}
+
+void test_calibration_rejects_degenerate_data() {
+  Calibration c;
+  const uint16_t flatX[5] = {2000, 2000, 200, 3900, 3};
+  const uint16_t outOfRange[5] = {200, 5000, 200, 3900, 3};
+  TEST_ASSERT_FALSE(c.set(flatX, W, H));
+  TEST_ASSERT_FALSE(c.set(outOfRange, W, H));
+  TEST_ASSERT_FALSE(c.isValid());
+
+  // A rejected update keeps the previous mapping
+  TEST_ASSERT_TRUE(c.set(DEFAULT_CAL, W, H));
+  TEST_ASSERT_FALSE(c.set(flatX, W, H));
+  TEST_ASSERT_EQUAL_INT16(0, c.map(3900, 200).x);
+}
+
+void test_calibration_from_points_round_trip() {
+  const int16_t margin = 30;
+  // Raw readings at (30, 30) and (450, 290) on a panel with X inverted
+  RawSample p1 = at(3700, 400);
+  RawSample p2 = at(300, 3600);
+  uint16_t cal[5];
+  calibrationFromPoints(p1, p2, margin, W, H, 3, cal);
+
+  TEST_ASSERT_TRUE(cal[0] > cal[1]); // Direction kept, not sorted
+  TEST_ASSERT_TRUE(cal[2] < cal[3]);
+  TEST_ASSERT_EQUAL_UINT16(3, cal[4]);
+
+  Calibration c;
+  TEST_ASSERT_TRUE(c.set(cal, W, H));
+  Point a = c.map(p1.x, p1.y);
+  Point b = c.map(p2.x, p2.y);
+  TEST_ASSERT_INT16_WITHIN(1, margin, a.x);
+  TEST_ASSERT_INT16_WITHIN(1, margin, a.y);
+  TEST_ASSERT_INT16_WITHIN(1, W - margin, b.x);
+  TEST_ASSERT_INT16_WITHIN(1, H - margin, b.y);
+}
+
+// Collects the events of one trace; trace[i].pressed = pen state at t = 10*i
+struct PenStep {
+  bool pressed;
+  int16_t x, y;
+};
+
+static Event events[64];
+static uint8_t eventCount;
+
+static void play(const PenStep *trace, uint8_t n, uint32_t periodMs = 10) {
+  GestureTracker g;
+  eventCount = 0;
+  for (uint8_t i = 0; i < n; i++) {
+    Event out[2];
+    uint8_t k = g.update(trace[i].pressed, trace[i].x, trace[i].y,
+                         i * periodMs, out);
+    for (uint8_t j = 0; j < k && eventCount < 64; j++) {
+      events[eventCount++] = out[j];
+    }
+  }
+}
+
+static void assertTypes(const EventType *expected, uint8_t n) {
+  TEST_ASSERT_EQUAL_UINT8(n, eventCount);
+  for (uint8_t i = 0; i < n; i++) {
+    TEST_ASSERT_EQUAL_UINT8((uint8_t)expected[i], (uint8_t)events[i].type);
+  }
+}
+
+void test_gesture_tap_survives_pressure_flicker() {
+  // One pen-up sample mid-press is a flicker, not a release
+  const PenStep trace[] = {{true, 100, 50}, {true, 102, 51}, {false, 0, 0},
+                           {true, 101, 50}, {false, 0, 0},   {false, 0, 0}};
+  play(trace, 6);
+  const EventType expected[] = {EventType::DOWN, EventType::TAP,
+                                EventType::UP};
+  assertTypes(expected, 3);
+  TEST_ASSERT_EQUAL_INT16(101, events[1].x);
+  TEST_ASSERT_EQUAL_UINT32(50, events[1].timeMs);
+  TEST_ASSERT_EQUAL_UINT32(50, events[1].durationMs);
+}
+
+void test_gesture_long_press_fires_once_without_tap() {
+  PenStep trace[100];
+  for (uint8_t i = 0; i < 98; i++) trace[i] = {true, 200, 100};
+  trace[98] = {false, 0, 0};
+  trace[99] = {false, 0, 0};
+  play(trace, 100);
+
+  const EventType expected[] = {EventType::DOWN, EventType::LONG_PRESS,
+                                EventType::UP};
+  assertTypes(expected, 3);
+  TEST_ASSERT_EQUAL_UINT32(LONG_PRESS_MS, events[1].timeMs);
+}
+
+void test_gesture_drag_reports_offsets() {
+  const PenStep trace[] = {{true, 100, 100}, {true, 105, 100},
+                           {true, 120, 100}, {true, 140, 104},
+                           {true, 140, 104}, {false, 0, 0},
+                           {false, 0, 0}};
+  play(trace, 7);
+
+  // Inside the slop: no drag; repeated position: no DRAG update
+  const EventType expected[] = {EventType::DOWN, EventType::DRAG_START,
+                                EventType::DRAG, EventType::DRAG_END,
+                                EventType::UP};
+  assertTypes(expected, 5);
+  TEST_ASSERT_EQUAL_INT16(20, events[1].dx);
+  TEST_ASSERT_EQUAL_INT16(40, events[2].dx);
+  TEST_ASSERT_EQUAL_INT16(4, events[2].dy);
+  TEST_ASSERT_EQUAL_INT16(140, events[3].x);
+}
+
+void test_gesture_drag_suppresses_long_press() {
+  PenStep trace[100];
+  trace[0] = {true, 100, 100};
+  for (uint8_t i = 1; i < 98; i++) trace[i] = {true, 150, 100};
+  trace[98] = {false, 0, 0};
+  trace[99] = {false, 0, 0};
+  play(trace, 100);
+
+  const EventType expected[] = {EventType::DOWN, EventType::DRAG_START,
+                                EventType::DRAG_END, EventType::UP};
+  assertTypes(expected, 4);
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_filter_median_rejects_spikes);
+  RUN_TEST(test_filter_needs_pressure_majority);
+  RUN_TEST(test_filter_iir_smooths_and_restarts_on_reset);
+  RUN_TEST(test_calibration_maps_edges_and_inverted_axis);
+  RUN_TEST(test_calibration_rejects_degenerate_data);
+  RUN_TEST(test_calibration_from_points_round_trip);
+  RUN_TEST(test_gesture_tap_survives_pressure_flicker);
+  RUN_TEST(test_gesture_long_press_fires_once_without_tap);
+  RUN_TEST(test_gesture_drag_reports_offsets);
+  RUN_TEST(test_gesture_drag_suppresses_long_press);
+  return UNITY_END();
+}
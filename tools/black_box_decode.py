@@ -0,0 +1,155 @@
+#!/usr/bin/env python3
+"""
+Black Box Decoder
+
+Decodes the "blackbox" flash partition written by BlackBox (include/black_box.h)
+into one CSV per dump, for replay in a spreadsheet or plotting tool.
+
+Each dump is the window around one trigger (LimpMode entering LIMP, ABS
+activation, emergency stop): PRE samples before the trigger sample and POST
+samples from it on, at 100 Hz. Columns are converted back to engineering
+units; t_rel_ms is relative to the trigger sample. NaN readings (stored as
+the fixed-point minimum) are left empty.
+
+Usage:
+    # Read the partition (offset/size from partitions/partitions.csv)
+    esptool.py --chip esp32s3 read_flash 0xF80000 0x40000 blackbox.bin
+
+    # One CSV per dump in the current directory (blackbox_<seq>.csv)
+    python tools/black_box_decode.py blackbox.bin
+
+    # Only the newest dump, to a chosen file
+    python tools/black_box_decode.py blackbox.bin --latest -o crash.csv
+
+Dumps with a bad header CRC (power cut while writing) are skipped; a bad
+data CRC is reported but the dump is still decoded.
+"""
+
+import argparse
+import binascii
+import csv
+import os
+import struct
+import sys
+
+SECTOR_SIZE = 4096
+SLOT_SECTORS = 15
+DUMP_MAGIC = 0x31584242  # "BBX1"
+FORMAT_VERSION = 1
+
+# DumpHeader: magic, version, sampleSize, seq, triggerMs, trigger, 3 pad,
+# preSamples, sampleCount, dataCrc, crc
+HEADER = struct.Struct("<IHHIIB3xHHII")
+# Sample: tickMs, pedal, steering, 4 wheel speeds, 4 motor currents,
+# battery current, steering current, 4 PWM, steering PWM, limp, wheel
+# mask, flags, event, reserved
+SAMPLE = struct.Struct("<IHh4H4hhh4BhBBBBH")
+
+TRIGGERS = {0: "", 1: "LIMP", 2: "ABS", 3: "EMERGENCY_STOP", 4: "MANUAL"}
+LIMP_STATES = {0: "NORMAL", 1: "DEGRADED", 2: "LIMP", 3: "CRITICAL"}
+FLAGS = ["pedal_valid", "steering_valid", "abs_active", "tcs_active",
+         "emergency_brake", "mode_4x4", "reverse"]
+WHEELS = ["fl", "fr", "rl", "rr"]
+
+I16_NAN = -32768
+U16_NAN = 0xFFFF
+
+
+def fixed(value, scale, nan):
+    return "" if value == nan else f"{value / scale:g}"
+
+
+def read_dumps(image):
+    """Yields (header dict, raw sample bytes, data_crc_ok) per valid slot."""
+    slot_size = SLOT_SECTORS * SECTOR_SIZE
+    for slot in range(len(image) // slot_size):
+        base = slot * slot_size
+        raw = image[base:base + HEADER.size]
+        (magic, version, sample_size, seq, trigger_ms, trigger, pre, count,
+         data_crc, crc) = HEADER.unpack(raw)
+        if magic != DUMP_MAGIC or version != FORMAT_VERSION:
+            continue
+        if binascii.crc32(raw[:HEADER.size - 4]) != crc:
+            print(f"⚠️  slot {slot}: bad header CRC, skipped", file=sys.stderr)
+            continue
+        if sample_size != SAMPLE.size or pre >= count:
+            print(f"⚠️  slot {slot}: unsupported layout, skipped",
+                  file=sys.stderr)
+            continue
+        start = base + HEADER.size
+        data = image[start:start + count * SAMPLE.size]
+        header = {"slot": slot, "seq": seq, "trigger_ms": trigger_ms,
+                  "trigger": TRIGGERS.get(trigger, str(trigger)),
+                  "pre": pre, "count": count}
+        yield header, data, binascii.crc32(data) == data_crc
+
+
+def header_row():
+    row = ["t_rel_ms", "tick_ms", "pedal_pct", "steering_deg"]
+    row += [f"speed_{w}_kmh" for w in WHEELS]
+    row += [f"current_{w}_a" for w in WHEELS]
+    row += ["battery_a", "steering_a"]
+    row += [f"pwm_{w}" for w in WHEELS]
+    row += ["steering_pwm", "limp_state"]
+    row += [f"abs_{w}" for w in WHEELS] + [f"tcs_{w}" for w in WHEELS]
+    row += FLAGS + ["event"]
+    return row
+
+
+def sample_row(fields, trigger_ms):
+    (tick, pedal, steer, s0, s1, s2, s3, c0, c1, c2, c3, batt, steer_a,
+     p0, p1, p2, p3, steer_pwm, limp, mask, flags, event, _) = fields
+    row = [tick - trigger_ms, tick, fixed(pedal, 10, U16_NAN),
+           fixed(steer, 10, I16_NAN)]
+    row += [fixed(s, 100, U16_NAN) for s in (s0, s1, s2, s3)]
+    row += [fixed(c, 10, I16_NAN) for c in (c0, c1, c2, c3)]
+    row += [fixed(batt, 10, I16_NAN), fixed(steer_a, 10, I16_NAN)]
+    row += [p0, p1, p2, p3, fixed(steer_pwm, 1, I16_NAN)]
+    row += [LIMP_STATES.get(limp, str(limp))]
+    row += [(mask >> i) & 1 for i in range(8)]
+    row += [(flags >> i) & 1 for i in range(len(FLAGS))]
+    row += [TRIGGERS.get(event, str(event))]
+    return row
+
+
+def write_csv(path, header, data):
+    with open(path, "w", newline="") as f:
+        out = csv.writer(f)
+        out.writerow(header_row())
+        for fields in SAMPLE.iter_unpack(data):
+            out.writerow(sample_row(fields, header["trigger_ms"]))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    parser.add_argument("image", help="Raw dump of the blackbox partition")
+    parser.add_argument("--latest", action="store_true",
+                        help="Decode only the newest dump")
+    parser.add_argument("-o", "--output",
+                        help="CSV file (with --latest) or directory")
+    args = parser.parse_args()
+
+    with open(args.image, "rb") as f:
+        image = f.read()
+
+    dumps = sorted(read_dumps(image), key=lambda d: d[0]["seq"], reverse=True)
+    if not dumps:
+        sys.exit("❌ No dumps found (empty partition or wrong offset?)")
+    if args.latest:
+        dumps = dumps[:1]
+
+    for header, data, crc_ok in dumps:
+        if args.latest and args.output:
+            path = args.output
+        else:
+            path = os.path.join(args.output or ".",
+                                f"blackbox_{header['seq']}.csv")
+        write_csv(path, header, data)
+        warn = "" if crc_ok else "  ⚠️  data CRC mismatch"
+        print(f"✅ #{header['seq']} {header['trigger'] or '?'} at "
+              f"{header['trigger_ms']} ms: {header['count']} samples "
+              f"({header['pre']} before) -> {path}{warn}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,204 @@
+#!/usr/bin/env python3
+"""
+PC Sampler Decoder
+
+Decodes the binary PC-sample stream produced by PcSampler (include/pc_sampler.h)
+and symbolizes it against the firmware ELF with addr2line.
+
+Output is flame-graph "collapsed stacks" (one line per unique stack):
+    core1;HUDTask;HudCompositor::render;TFT_eSPI::pushImage 123
+usable with flamegraph.pl, speedscope or inferno. Each sample has two frames
+(caller and interrupted function), which is enough to tell text rendering,
+arc drawing and blocked I2C calls apart.
+
+Usage:
+    # Capture from the serial port (Ctrl+C to stop), then symbolize
+    python tools/pc_sampler_decode.py --port /dev/ttyUSB0 \\
+        --elf .pio/build/esp32-s3-devkitc1-n16r8/firmware.elf -o hud.folded
+
+    # Decode a raw capture (e.g. pio device monitor --raw > capture.bin)
+    python tools/pc_sampler_decode.py --input capture.bin --elf firmware.elf
+
+Text log lines interleaved with the binary frames are skipped; frames with
+a bad checksum are counted and ignored.
+"""
+
+import argparse
+import os
+import shutil
+import struct
+import subprocess
+import sys
+from collections import Counter
+
+SYNC = b"\xa5\x5a"
+FRAME_INFO = ord("I")
+FRAME_TASK = ord("T")
+FRAME_SAMPLES = ord("S")
+SAMPLE_BYTES = 9
+DEFAULT_ADDR2LINE = "xtensa-esp32s3-elf-addr2line"
+
+
+class StreamDecoder:
+    """Incremental frame parser (resynchronizes on SYNC)."""
+
+    def __init__(self):
+        self.buf = bytearray()
+        self.tasks = {}
+        self.stacks = Counter()
+        self.samples = 0
+        self.dropped = 0
+        self.bad_frames = 0
+        self.rate_hz = None
+        self.core_mask = None
+
+    def feed(self, data):
+        self.buf.extend(data)
+        while True:
+            start = self.buf.find(SYNC)
+            if start < 0:
+                # Keep a trailing 0xA5 in case SYNC is split across reads
+                del self.buf[:-1]
+                return
+            if start > 0:
+                del self.buf[:start]
+            if len(self.buf) < 4:
+                return
+            ftype, length = self.buf[2], self.buf[3]
+            total = 4 + length + 1
+            if len(self.buf) < total:
+                return
+            payload = bytes(self.buf[4:4 + length])
+            checksum = self.buf[4 + length]
+            if (ftype + length + sum(payload)) & 0xFF != checksum:
+                self.bad_frames += 1
+                del self.buf[:2]  # Skip this SYNC, look for the next one
+                continue
+            del self.buf[:total]
+            self._frame(ftype, payload)
+
+    def _frame(self, ftype, payload):
+        if ftype == FRAME_INFO and len(payload) >= 3:
+            self.rate_hz, self.core_mask = struct.unpack_from("<HB", payload)
+        elif ftype == FRAME_TASK and len(payload) >= 1:
+            name = payload[1:].decode("ascii", errors="replace") or "?"
+            self.tasks[payload[0]] = name
+        elif ftype == FRAME_SAMPLES and len(payload) >= 3:
+            core, dropped = struct.unpack_from("<BH", payload)
+            self.dropped += dropped
+            count = (len(payload) - 3) // SAMPLE_BYTES
+            for i in range(count):
+                pc, caller, task_id = struct.unpack_from(
+                    "<IIB", payload, 3 + i * SAMPLE_BYTES)
+                self.stacks[(core, task_id, caller, pc)] += 1
+                self.samples += 1
+
+
+def symbolize(addresses, elf, addr2line):
+    """Map addresses to function names with one addr2line call."""
+    names = {}
+    if not addresses:
+        return names
+    if elf is None or shutil.which(addr2line) is None:
+        if elf is not None:
+            print(f"⚠️  {addr2line} not found, emitting raw addresses",
+                  file=sys.stderr)
+        return {a: f"0x{a:08x}" for a in addresses}
+
+    ordered = sorted(addresses)
+    cmd = [addr2line, "-f", "-C", "-e", elf] + [f"0x{a:08x}" for a in ordered]
+    out = subprocess.run(cmd, capture_output=True, text=True, check=False)
+    lines = out.stdout.splitlines()
+    # addr2line prints two lines per address: function, file:line
+    for i, addr in enumerate(ordered):
+        func = lines[2 * i].strip() if 2 * i < len(lines) else "??"
+        names[addr] = func if func and func != "??" else f"0x{addr:08x}"
+    return names
+
+
+def collapse(decoder, names):
+    folded = Counter()
+    for (core, task_id, caller, pc), count in decoder.stacks.items():
+        task = decoder.tasks.get(task_id, f"task{task_id}")
+        # ';' separates frames in the collapsed format
+        frames = [f"core{core}", task, names[caller], names[pc]]
+        folded[";".join(f.replace(";", ":") for f in frames)] += count
+    return folded
+
+
+def read_serial(port, baud, decoder, duration):
+    try:
+        import serial  # pyserial
+    except ImportError:
+        sys.exit("❌ pyserial not installed (pip install pyserial)")
+    import time
+
+    end = time.time() + duration if duration else None
+    with serial.Serial(port, baud, timeout=0.2) as ser:
+        print(f"📡 Capturing from {port} @ {baud} (Ctrl+C to stop)",
+              file=sys.stderr)
+        try:
+            while end is None or time.time() < end:
+                decoder.feed(ser.read(4096))
+        except KeyboardInterrupt:
+            pass
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    src = parser.add_mutually_exclusive_group(required=True)
+    src.add_argument("--port", help="Serial port to capture from")
+    src.add_argument("--input", help="Raw capture file")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--duration", type=float, default=0,
+                        help="Capture seconds (0 = until Ctrl+C)")
+    parser.add_argument("--elf", help="firmware.elf for symbolization")
+    parser.add_argument("--addr2line", default=DEFAULT_ADDR2LINE)
+    parser.add_argument("-o", "--output", help="Collapsed stacks file "
+                        "(default: stdout)")
+    parser.add_argument("--top", type=int, default=15,
+                        help="Functions listed in the summary")
+    args = parser.parse_args()
+
+    decoder = StreamDecoder()
+    if args.port:
+        read_serial(args.port, args.baud, decoder, args.duration)
+    else:
+        with open(args.input, "rb") as f:
+            decoder.feed(f.read())
+
+    if decoder.samples == 0:
+        sys.exit("❌ No PC samples found (sampler off or wrong baud rate?)")
+
+    addresses = set()
+    for (_, _, caller, pc) in decoder.stacks:
+        addresses.update((caller, pc))
+    if args.elf and not os.path.isfile(args.elf):
+        sys.exit(f"❌ ELF not found: {args.elf}")
+    names = symbolize(addresses, args.elf, args.addr2line)
+    folded = collapse(decoder, names)
+
+    lines = [f"{stack} {count}" for stack, count in folded.most_common()]
+    if args.output:
+        with open(args.output, "w") as f:
+            f.write("\n".join(lines) + "\n")
+    else:
+        print("\n".join(lines))
+
+    # Summary on stderr so stdout stays a clean collapsed file
+    total = decoder.samples + decoder.dropped
+    rate = f"{decoder.rate_hz} Hz" if decoder.rate_hz else "unknown rate"
+    print(f"\n✅ {decoder.samples} samples ({rate}), {decoder.dropped} dropped "
+          f"({100.0 * decoder.dropped / max(total, 1):.1f}%), "
+          f"{decoder.bad_frames} bad frames", file=sys.stderr)
+    self_time = Counter()
+    for (core, task_id, _, pc), count in decoder.stacks.items():
+        self_time[names[pc]] += count
+    print(f"Top {args.top} functions (self):", file=sys.stderr)
+    for func, count in self_time.most_common(args.top):
+        print(f"  {100.0 * count / decoder.samples:5.1f}%  {func}",
+              file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()